@@ -8,6 +8,21 @@
 #include "legato.h"
 #include "interfaces.h"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client session of the current message
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_SessionRef_t ClientSessionRef = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close session handler of the AT client, and its context
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_SessionEventHandler_t CloseHandlerFunc = NULL;
+static void* CloseHandlerContextPtr = NULL;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the server service refrence stub
@@ -33,7 +48,37 @@ le_msg_SessionRef_t le_atClient_GetClientSessionRef
     void
 )
 {
-    return NULL;
+    return ClientSessionRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the client session reference returned by le_atClient_GetClientSessionRef()
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void SetClientSessionRef
+(
+    le_msg_SessionRef_t sessionRef
+)
+{
+    ClientSessionRef = sessionRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the closing of a client session
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void CloseClientSession
+(
+    le_msg_SessionRef_t sessionRef
+)
+{
+    LE_ASSERT(CloseHandlerFunc != NULL);
+
+    CloseHandlerFunc(sessionRef, CloseHandlerContextPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -65,5 +110,8 @@ le_msg_SessionEventHandlerRef_t AddServiceCloseHandler
     void *contextPtr
 )
 {
+    CloseHandlerFunc = handlerFunc;
+    CloseHandlerContextPtr = contextPtr;
+
     return NULL;
 }
@@ -20,6 +20,26 @@ le_msg_SessionRef_t le_atClient_GetClientSessionRef
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the client session reference returned by le_atClient_GetClientSessionRef() (test stub)
+ */
+//--------------------------------------------------------------------------------------------------
+void SetClientSessionRef
+(
+    le_msg_SessionRef_t sessionRef
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the closing of a client session (test stub)
+ */
+//--------------------------------------------------------------------------------------------------
+void CloseClientSession
+(
+    le_msg_SessionRef_t sessionRef
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the server service reference
@@ -7,6 +7,428 @@
 #include "legato.h"
 #include "interfaces.h"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default buffer size
+ */
+//--------------------------------------------------------------------------------------------------
+#define DSIZE           1024
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * AT command and unsolicited timeout (in ms)
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_TIMEOUT    5000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of test unsolicited subscriptions
+ */
+//--------------------------------------------------------------------------------------------------
+#define NB_UNSOL        6
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of unsolicited responses received by a subscription
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_RECEIVED    4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unsolicited subscription of the test
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* pattern;                                        ///< pattern to match
+    uint32_t    lineCount;                                      ///< unsolicited lines number
+    le_atClient_UnsolicitedResponseHandlerRef_t ref;            ///< handler reference
+    char        received[MAX_RECEIVED][LE_ATDEFS_UNSOLICITED_MAX_BYTES]; ///< received responses
+    uint32_t    count;                                          ///< received responses count
+}
+Unsol_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test subscriptions.  Some patterns are prefixes of others, and one is subscribed twice.
+ */
+//--------------------------------------------------------------------------------------------------
+static Unsol_t Unsols[NB_UNSOL] =
+{
+    { "+CREG:", 1 },
+    { "+C",     1 },
+    { "+CMT:",  2 },
+    { "+CREG:", 1 },
+    { "RING",   1 },
+    { "+CMTI:", 1 },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Host side of the AT device
+ */
+//--------------------------------------------------------------------------------------------------
+static int HostFd = -1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex protecting the received responses, filled in by the AT client device thread
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mutex_Ref_t Mutex;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Semaphore posted for each received unsolicited response
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sem_Ref_t UnsolSem;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Host thread: answer OK to the AT commands, until the device side is closed.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void* AtHost
+(
+    void* contextPtr
+)
+{
+    int fd = (int)(intptr_t)contextPtr;
+    char buf[DSIZE];
+    ssize_t size;
+
+    while ((size = read(fd, buf, sizeof(buf) - 1)) > 0)
+    {
+        buf[size] = '\0';
+
+        if (strstr(buf, "\r") != NULL)
+        {
+            LE_ASSERT(write(fd, "\r\nOK\r\n", 6) == 6);
+        }
+    }
+
+    close(fd);
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connect a new AT device to a host thread, and start the AT client on it.
+ *
+ * @return reference of the device, and host side of the device in hostFdPtr if not NULL
+ */
+//--------------------------------------------------------------------------------------------------
+static le_atClient_DeviceRef_t StartDevice
+(
+    int* hostFdPtr
+)
+{
+    int fds[2];
+
+    LE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    le_thread_Start(le_thread_Create("AtHost", AtHost, (void*)(intptr_t)fds[1]));
+
+    le_atClient_DeviceRef_t devRef = le_atClient_Start(fds[0]);
+    LE_ASSERT(devRef != NULL);
+
+    if (hostFdPtr != NULL)
+    {
+        *hostFdPtr = fds[1];
+    }
+
+    return devRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of objects in use in one of the AT client pools.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetNumInUse
+(
+    const char* poolNamePtr
+)
+{
+    le_mem_PoolRef_t poolRef = _le_mem_FindPool("atClientComp", poolNamePtr);
+    le_mem_PoolStats_t stats;
+
+    LE_ASSERT(poolRef != NULL);
+    le_mem_GetStats(poolRef, &stats);
+
+    return stats.numBlocksInUse;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unsolicited handler
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnsolHandler
+(
+    const char* unsolicitedRsp,
+    void* contextPtr
+)
+{
+    Unsol_t* unsolPtr = contextPtr;
+
+    LE_DEBUG("'%s' received '%s'", unsolPtr->pattern, unsolicitedRsp);
+
+    le_mutex_Lock(Mutex);
+
+    LE_ASSERT(unsolPtr->count < MAX_RECEIVED);
+    LE_ASSERT(le_utf8_Copy(unsolPtr->received[unsolPtr->count++],
+                           unsolicitedRsp,
+                           LE_ATDEFS_UNSOLICITED_MAX_BYTES,
+                           NULL) == LE_OK);
+
+    le_mutex_Unlock(Mutex);
+
+    le_sem_Post(UnsolSem);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send an AT command and wait for its final response.  The AT client handles the subscriptions
+ * changes in its device thread, in order with the commands: they are all done when this function
+ * returns.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Sync
+(
+    le_atClient_DeviceRef_t devRef
+)
+{
+    le_atClient_CmdRef_t cmdRef;
+
+    LE_ASSERT(le_atClient_SetCommandAndSend(&cmdRef, devRef, "AT", "", "OK", TEST_TIMEOUT)
+              == LE_OK);
+    LE_ASSERT(le_atClient_Delete(cmdRef) == LE_OK);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write unsolicited responses on the host side, and wait for the expected number of handler
+ * calls.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendUnsolicited
+(
+    const char* dataPtr,
+    uint32_t    expectedCount
+)
+{
+    size_t len = strlen(dataPtr);
+    uint32_t i;
+
+    LE_ASSERT(write(HostFd, dataPtr, len) == len);
+
+    for (i = 0; i < expectedCount; i++)
+    {
+        LE_ASSERT(le_sem_WaitWithTimeOut(UnsolSem, (le_clk_Time_t){TEST_TIMEOUT / 1000, 0})
+                  == LE_OK);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the responses received by a subscription, and reset them.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckReceived
+(
+    Unsol_t*    unsolPtr,
+    uint32_t    count,
+    const char* firstPtr,
+    const char* secondPtr
+)
+{
+    le_mutex_Lock(Mutex);
+
+    LE_INFO("'%s' received %u response(s)", unsolPtr->pattern, unsolPtr->count);
+    LE_ASSERT(unsolPtr->count == count);
+
+    if (count > 0)
+    {
+        LE_ASSERT(strcmp(unsolPtr->received[0], firstPtr) == 0);
+    }
+
+    if (count > 1)
+    {
+        LE_ASSERT(strcmp(unsolPtr->received[1], secondPtr) == 0);
+    }
+
+    unsolPtr->count = 0;
+
+    le_mutex_Unlock(Mutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: unsolicited responses are dispatched to every subscription whose pattern is a prefix of
+ * the received line.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestUnsolicitedMatching
+(
+    le_atClient_DeviceRef_t devRef
+)
+{
+    int i;
+
+    for (i = 0; i < NB_UNSOL; i++)
+    {
+        Unsols[i].ref = le_atClient_AddUnsolicitedResponseHandler(Unsols[i].pattern,
+                                                                  devRef,
+                                                                  UnsolHandler,
+                                                                  &Unsols[i],
+                                                                  Unsols[i].lineCount);
+        LE_ASSERT(Unsols[i].ref != NULL);
+    }
+
+    Sync(devRef);
+
+    SendUnsolicited("\r\n+CREG: 1\r\n", 3);
+    CheckReceived(&Unsols[0], 1, "+CREG: 1", NULL);
+    CheckReceived(&Unsols[1], 1, "+CREG: 1", NULL);
+    CheckReceived(&Unsols[3], 1, "+CREG: 1", NULL);
+
+    // Only the "+C" pattern is a prefix of these lines.
+    SendUnsolicited("\r\n+CGREG: 0\r\n\r\n+CRE\r\n", 2);
+    CheckReceived(&Unsols[0], 0, NULL, NULL);
+    CheckReceived(&Unsols[1], 2, "+CGREG: 0", "+CRE");
+    CheckReceived(&Unsols[3], 0, NULL, NULL);
+
+    // Multi-line unsolicited response.
+    SendUnsolicited("\r\n+CMT: \"+33123456789\",,\"17/10/26\"\r\nHello\r\n", 2);
+    CheckReceived(&Unsols[1], 1, "+CMT: \"+33123456789\",,\"17/10/26\"", NULL);
+    CheckReceived(&Unsols[2], 1, "+CMT: \"+33123456789\",,\"17/10/26\"\r\nHello", NULL);
+    CheckReceived(&Unsols[5], 0, NULL, NULL);
+
+    // The second line of a multi-line response matching its own pattern is not a new response.
+    SendUnsolicited("\r\n+CMT: 1\r\n+CMT: 2\r\n", 3);
+    CheckReceived(&Unsols[1], 2, "+CMT: 1", "+CMT: 2");
+    CheckReceived(&Unsols[2], 1, "+CMT: 1\r\n+CMT: 2", NULL);
+
+    SendUnsolicited("\r\nRING\r\n\r\n+CMTI: \"SM\",1\r\n", 3);
+    CheckReceived(&Unsols[4], 1, "RING", NULL);
+    CheckReceived(&Unsols[1], 1, "+CMTI: \"SM\",1", NULL);
+    CheckReceived(&Unsols[5], 1, "+CMTI: \"SM\",1", NULL);
+
+    // Remove the shortest pattern and one of the two identical ones.
+    le_atClient_RemoveUnsolicitedResponseHandler(Unsols[1].ref);
+    le_atClient_RemoveUnsolicitedResponseHandler(Unsols[3].ref);
+    Sync(devRef);
+
+    SendUnsolicited("\r\n+CREG: 5\r\n\r\nRING\r\n", 2);
+    CheckReceived(&Unsols[0], 1, "+CREG: 5", NULL);
+    CheckReceived(&Unsols[1], 0, NULL, NULL);
+    CheckReceived(&Unsols[3], 0, NULL, NULL);
+    CheckReceived(&Unsols[4], 1, "RING", NULL);
+
+    // Subscribe again to a removed pattern.
+    Unsols[1].ref = le_atClient_AddUnsolicitedResponseHandler(Unsols[1].pattern,
+                                                              devRef,
+                                                              UnsolHandler,
+                                                              &Unsols[1],
+                                                              Unsols[1].lineCount);
+    Sync(devRef);
+
+    SendUnsolicited("\r\n+CREG: 2\r\n", 2);
+    CheckReceived(&Unsols[0], 1, "+CREG: 2", NULL);
+    CheckReceived(&Unsols[1], 1, "+CREG: 2", NULL);
+
+    for (i = 0; i < NB_UNSOL; i++)
+    {
+        if (i != 3)
+        {
+            le_atClient_RemoveUnsolicitedResponseHandler(Unsols[i].ref);
+        }
+    }
+    Sync(devRef);
+
+    // Nothing is subscribed anymore.
+    SendUnsolicited("\r\n+CREG: 3\r\n\r\nRING\r\n", 0);
+    Sync(devRef);
+
+    for (i = 0; i < NB_UNSOL; i++)
+    {
+        CheckReceived(&Unsols[i], 0, NULL, NULL);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: closing a client session releases its devices, along with the unsolicited subscriptions
+ * and patterns trie nodes of the devices, including subscriptions still being added or removed.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestCloseSession
+(
+    void
+)
+{
+    static Unsol_t unsols[] =
+    {
+        { "+CREG:", 1 },
+        { "+CGREG:", 1 },
+        { "RING", 1 },
+        { "+CMTI:", 1 },
+    };
+    le_msg_SessionRef_t sessionRef = (le_msg_SessionRef_t)&unsols;
+    size_t numDevices = GetNumInUse("AtClientDevicesPool");
+    size_t numUnsols = GetNumInUse("AtUnsolicitedPool");
+    size_t numNodes = GetNumInUse("AtUnsolNodePool");
+    size_t i;
+
+    SetClientSessionRef(sessionRef);
+
+    le_atClient_DeviceRef_t devRef = StartDevice(NULL);
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(unsols); i++)
+    {
+        unsols[i].ref = le_atClient_AddUnsolicitedResponseHandler(unsols[i].pattern,
+                                                                  devRef,
+                                                                  UnsolHandler,
+                                                                  &unsols[i],
+                                                                  unsols[i].lineCount);
+        LE_ASSERT(unsols[i].ref != NULL);
+
+        // Leave the last subscription being added.
+        if (i == NUM_ARRAY_MEMBERS(unsols) - 2)
+        {
+            Sync(devRef);
+        }
+    }
+
+    LE_ASSERT(GetNumInUse("AtClientDevicesPool") == numDevices + 1);
+    LE_ASSERT(GetNumInUse("AtUnsolicitedPool") == numUnsols + NUM_ARRAY_MEMBERS(unsols));
+    LE_ASSERT(GetNumInUse("AtUnsolNodePool") > numNodes);
+
+    // And one being removed.
+    le_atClient_RemoveUnsolicitedResponseHandler(unsols[0].ref);
+
+    SetClientSessionRef(NULL);
+    CloseClientSession(sessionRef);
+
+    LE_ASSERT(GetNumInUse("AtClientDevicesPool") == numDevices);
+    LE_ASSERT(GetNumInUse("AtUnsolicitedPool") == numUnsols);
+    LE_ASSERT(GetNumInUse("AtUnsolNodePool") == numNodes);
+    LE_ASSERT(le_atClient_Stop(devRef) == LE_FAULT);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * main of the test
@@ -20,6 +442,17 @@ COMPONENT_INIT
 
     LE_INFO("======== START UnitTest of AT CLIENT API ========");
 
+    Mutex = le_mutex_CreateNonRecursive("AtClientUnitTest");
+    UnsolSem = le_sem_Create("AtClientUnsolSem", 0);
+
+    le_atClient_DeviceRef_t devRef = StartDevice(&HostFd);
+
+    LE_INFO("======== Test unsolicited responses matching ========");
+    TestUnsolicitedMatching(devRef);
+
+    LE_INFO("======== Test closing a client session ========");
+    TestCloseSession();
+
     LE_INFO("======== UnitTest of AT CLIENT API FINISHED ========");
     exit(EXIT_SUCCESS);
 }
@@ -0,0 +1,211 @@
+/**
+ * Benchmark of the AT client unsolicited responses matching.
+ *
+ * Subscribes hundreds of unsolicited patterns on a device, then replays a stream of unsolicited
+ * responses captured from a modem under load through the device, and measures how long the AT
+ * client takes to classify and dispatch them.
+ *
+ * Usage: atClientUrcPerf [-p NUM_PATTERNS] [-n NUM_REPLAYS]
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+#include "legato.h"
+#include "interfaces.h"
+
+#define DEFAULT_NUM_PATTERNS    300
+#define DEFAULT_NUM_REPLAYS     2000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unsolicited responses of the captured stream.  A sentinel marks the end of each replay.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* const Stream[] =
+{
+    "+CREG: 1,\"2B0C\",\"01A2F3C1\",7",
+    "+CGREG: 1,\"2B0C\",\"01A2F3C1\",7,\"01\"",
+    "+CEREG: 1,\"2B0C\",\"01A2F3C1\",7",
+    "+CSQ: 21,99",
+    "+CIEV: \"SIGNAL\",4",
+    "+CGEV: NW MODIFY 1,0",
+    "+CGEV: ME PDN ACT 1",
+    "+CMTI: \"SM\",3",
+    "+CDSI: \"SR\",2",
+    "RING",
+    "+CLIP: \"+33612345678\",145,,,,0",
+    "+CRING: VOICE",
+    "NO CARRIER",
+    "+CUSD: 0,\"Balance: 10.00\",15",
+    "+WIND: 4",
+    "+CTZV: 17/10/26,12:34:56,+08",
+    "+CMT: \"+33612345678\",,\"17/10/26,12:34:56+08\"",
+    "Hello, this is the text of the message",
+    "+CREG: 5,\"2B0C\",\"01A2F3C2\",7",
+    "+CSQ: 18,99",
+    "+CGEV: NW DETACH",
+    "+CGREG: 0",
+    "+CEREG: 2",
+    "+CREG: 1,\"2B0C\",\"01A2F3C1\",7",
+    "+PERFEND",
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unsolicited patterns expected from a modem, subscribed besides the generated ones.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* const Patterns[] =
+{
+    "+CREG:", "+CGREG:", "+CEREG:", "+CSQ:", "+CIEV:", "+CGEV:", "+CMTI:", "+CDSI:", "RING",
+    "+CLIP:", "+CRING:", "NO CARRIER", "+CUSD:", "+WIND:", "+CTZV:", "+CMT:", "+CDS:", "+CBM:",
+    "+CCWA:", "+CSSI:", "+CSSU:", "+CMTI: \"ME\"", "+CREG: 1", "+CEREG: 1",
+};
+
+static int HostFd = -1;
+static le_sem_Ref_t EndSem;
+static uint32_t DispatchCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counts the dispatched unsolicited responses.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountingHandler
+(
+    const char* unsolicitedRsp,
+    void* contextPtr
+)
+{
+    DispatchCount++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signals the end of a replay.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndHandler
+(
+    const char* unsolicitedRsp,
+    void* contextPtr
+)
+{
+    le_sem_Post(EndSem);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Answers OK to the AT commands.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* AtHost
+(
+    void* contextPtr
+)
+{
+    char buf[256];
+
+    while (read(HostFd, buf, sizeof(buf)) > 0)
+    {
+        LE_ASSERT(write(HostFd, "\r\nOK\r\n", 6) == 6);
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Subscribes the patterns.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Subscribe
+(
+    le_atClient_DeviceRef_t devRef,
+    int numPatterns
+)
+{
+    char pattern[LE_ATDEFS_UNSOLICITED_MAX_BYTES];
+    int i;
+
+    for (i = 0; i < numPatterns; i++)
+    {
+        if (i < NUM_ARRAY_MEMBERS(Patterns))
+        {
+            LE_ASSERT(le_utf8_Copy(pattern, Patterns[i], sizeof(pattern), NULL) == LE_OK);
+        }
+        else
+        {
+            // Vendor specific patterns, which share their first characters with standard ones.
+            snprintf(pattern, sizeof(pattern), "+C%c%cV%d:",
+                     'A' + (i % 26), 'A' + (i / 26 % 26), i);
+        }
+
+        LE_ASSERT(le_atClient_AddUnsolicitedResponseHandler(pattern, devRef,
+                                                            CountingHandler, NULL, 1) != NULL);
+    }
+
+    LE_ASSERT(le_atClient_AddUnsolicitedResponseHandler("+PERFEND", devRef,
+                                                        EndHandler, NULL, 1) != NULL);
+
+    // The subscriptions are done by the device thread before it sends this command.
+    le_atClient_CmdRef_t cmdRef;
+    LE_ASSERT(le_atClient_SetCommandAndSend(&cmdRef, devRef, "AT", "", "OK", 5000) == LE_OK);
+    LE_ASSERT(le_atClient_Delete(cmdRef) == LE_OK);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs the benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    int numPatterns = DEFAULT_NUM_PATTERNS;
+    int numReplays = DEFAULT_NUM_REPLAYS;
+    int fds[2];
+    int i;
+
+    le_arg_SetIntVar(&numPatterns, "p", "patterns");
+    le_arg_SetIntVar(&numReplays, "n", "replays");
+    le_arg_Scan();
+
+    // Build one replay of the stream.
+    char replay[4096];
+    size_t replaySize = 0;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Stream); i++)
+    {
+        replaySize += snprintf(replay + replaySize, sizeof(replay) - replaySize,
+                               "\r\n%s\r\n", Stream[i]);
+        LE_ASSERT(replaySize < sizeof(replay));
+    }
+
+    EndSem = le_sem_Create("UrcPerfEnd", 0);
+
+    LE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    HostFd = fds[1];
+    le_thread_Start(le_thread_Create("AtHost", AtHost, NULL));
+
+    le_atClient_DeviceRef_t devRef = le_atClient_Start(fds[0]);
+    LE_ASSERT(devRef != NULL);
+
+    Subscribe(devRef, numPatterns);
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < numReplays; i++)
+    {
+        LE_ASSERT(write(HostFd, replay, replaySize) == replaySize);
+        LE_ASSERT(le_sem_WaitWithTimeOut(EndSem, (le_clk_Time_t){5, 0}) == LE_OK);
+    }
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+    double usec = elapsed.sec * 1e6 + elapsed.usec;
+    uint32_t numLines = numReplays * NUM_ARRAY_MEMBERS(Stream);
+
+    printf("%d patterns: %u lines (%u dispatched) in %.1f ms, %.2f us/line\n",
+           numPatterns + 1, numLines, DispatchCount, usec / 1000, usec / numLines);
+
+    exit(EXIT_SUCCESS);
+}
@@ -976,6 +976,100 @@ void Testle_audio_RecordFile
     LE_ASSERT(le_sem_GetValue(ThreadSemaphore) == 0);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test the play of an interrupted WAV recording.
+ * A (fake) WAV file is built with a header which doesn't describe its data, as left by a recording
+ * interrupted before the header update. The file is played, and the test checks that all the data
+ * is played.
+ *
+ * API tested:
+ * - le_audio_PlayFile
+ * - le_audio_AddMediaHandler
+ *
+ * Exit if failed
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void Testle_audio_PlayInterruptedWavFile
+(
+    void
+)
+{
+    unlink("test.wav");
+
+    le_audio_StreamRef_t playbackStreamRef = NULL;
+    WavHeader_t hdr;
+
+    // Create a WAV file with an outdated header
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(&hdr.riffId, "RIFF", sizeof(hdr.riffId));
+    memcpy(&hdr.riffFmt, "WAVE", sizeof(hdr.riffFmt));
+    memcpy(&hdr.fmtId, "fmt ", sizeof(hdr.fmtId));
+    memcpy(&hdr.dataId, "data", sizeof(hdr.dataId));
+    hdr.fmtSize = 16;
+    hdr.audioFormat = 1;
+    hdr.channelsCount = 1;
+    hdr.sampleRate = 8000;
+    hdr.bitsPerSample = 8;
+    hdr.byteRate = 8000;
+    hdr.blockAlign = 1;
+    hdr.dataSize = BUFFER_LEN / 2;
+    hdr.riffSize = hdr.dataSize + sizeof(WavHeader_t) - 8;
+
+    int fd = open("./test.wav", O_CREAT | O_WRONLY, S_IRUSR | S_IWUSR );
+
+    LE_ASSERT(write(fd, &hdr, sizeof(hdr)) == sizeof(hdr));
+    LE_ASSERT(write(fd, Buffer, BUFFER_LEN) == BUFFER_LEN);
+
+    close(fd);
+
+    // Play the file
+    FileFd = open("./test.wav", O_RDONLY);
+    LE_ASSERT(FileFd != -1);
+
+    // Init the pcm buffer in pa_pcm_simu side.
+    pa_pcmSimu_InitData(BUFFER_LEN);
+
+    // Open the player stream
+    playbackStreamRef = le_audio_OpenPlayer();
+    LE_ASSERT(playbackStreamRef != NULL);
+
+    // Set the test case
+    TestCase = TEST_PLAY_FILES;
+
+    // Create the test thread which will execute le_audio_PlayFile and le_audio_AddMediaHandler
+    CreateTestThread(playbackStreamRef);
+
+    // Wait the event LE_AUDIO_MEDIA_ENDED
+    le_sem_Wait(ThreadSemaphore);
+
+    // Close the fd
+    close(FileFd);
+
+    // Get the buffer address of the received data in the pa_pcm_simu
+    uint8_t* sentPcmPtr = pa_pcmSimu_GetDataPtr();
+
+    // Check data
+    LE_ASSERT(memcmp(Buffer, sentPcmPtr, BUFFER_LEN) == 0);
+
+    // Release buffer in pa_pcm_simu
+    pa_pcmSimu_ReleaseData();
+
+    // Stop the test thread
+    le_thread_Cancel(TestThreadRef);
+    le_thread_Join(TestThreadRef,NULL);
+
+    // Close the player stream
+    le_audio_Close(playbackStreamRef);
+
+    // Delete the created file
+    unlink("test.wav");
+
+    // Check that no more call of the semaphore
+    LE_ASSERT(le_sem_GetValue(ThreadSemaphore) == 0);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Test the dtmf decoding functionality.
@@ -1232,6 +1326,9 @@ COMPONENT_INIT
     LE_INFO("======== Test capture file ========");
     Testle_audio_RecordFile();
 
+    LE_INFO("======== Test play interrupted wav file ========");
+    Testle_audio_PlayInterruptedWavFile();
+
     LE_INFO("======== Test decoding dtmf ========");
     Testle_audio_DecodingDtmf();
 
@@ -0,0 +1,189 @@
+/**
+ * Benchmark of the asset data time series.
+ *
+ * Records sensor-like integer and float samples in time series, the way le_avdata_RecordInt() and
+ * le_avdata_RecordFloat() do in the AirVantage daemon, and measures the time taken per sample and
+ * the number of bytes per sample of the pushed history, before and after compression.  A time
+ * series is pushed when it is full, like apps do when recording returns LE_NO_MEMORY, and the time
+ * taken to finish it counts in the time per sample.
+ *
+ * Usage: assetDataTimeSeriesPerf [-n NUM_SAMPLES] [-m MAX_BYTES] [-r MAX_RAM_BYTES]
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+#include "legato.h"
+#include "timeSeries.h"
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+#include "zlib.h"
+
+#define DEFAULT_NUM_SAMPLES     100000
+#define DEFAULT_MAX_BYTES       65536
+#define DEFAULT_MAX_RAM_BYTES   8192
+#define SPILL_DIR               "/tmp/assetDataTimeSeriesPerf"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kinds of recorded samples.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    SAMPLE_INT,             ///< Integer, e.g. a temperature in hundredths of degrees.
+    SAMPLE_FLOAT,           ///< Float, encoded as a double.
+    SAMPLE_FLOAT_FACTOR     ///< Float with a factor of 100, encoded as an integer.
+}
+SampleKind_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Results of a run.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t numPushes;         ///< Number of pushed time series.
+    uint64_t numCborBytes;      ///< Number of bytes of the pushed time series before compression.
+    uint64_t numPushedBytes;    ///< Number of bytes of the pushed time series.
+    double elapsedUsec;         ///< Time taken to record the samples and finish the time series.
+}
+Results_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish a time series, check its history and count its bytes.  Checking the history doesn't count
+ * in the elapsed time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Push
+(
+    timeSeries_Ref_t seriesRef,
+    Results_t* resultsPtr
+)
+{
+    static uint8_t cbor[4 * 1024 * 1024];
+    uint8_t* bufferPtr;
+    size_t numBytes;
+    uLongf cborNumBytes = sizeof(cbor);
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    LE_ASSERT(timeSeries_Finish(seriesRef, &bufferPtr, &numBytes) == LE_OK);
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+    resultsPtr->elapsedUsec += elapsed.sec * 1e6 + elapsed.usec;
+
+    // The history is a 3 entries CBOR map, whose last entry is an indefinite length array.
+    LE_ASSERT(uncompress(cbor, &cborNumBytes, bufferPtr, numBytes) == Z_OK);
+    LE_ASSERT(cbor[0] == 0xa3);
+    LE_ASSERT(cbor[cborNumBytes - 1] == 0xff);
+
+    resultsPtr->numPushes++;
+    resultsPtr->numCborBytes += cborNumBytes;
+    resultsPtr->numPushedBytes += numBytes;
+
+    free(bufferPtr);
+    timeSeries_Delete(seriesRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record samples of a slowly varying and noisy signal, sampled about every second.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Run
+(
+    const char* namePtr,
+    SampleKind_t kind,
+    int numSamples
+)
+{
+    double factor = (kind == SAMPLE_FLOAT_FACTOR) ? 100 : 1;
+    uint64_t timeStamp = 1500000000000;
+    Results_t results = { 0 };
+    timeSeries_Ref_t seriesRef;
+    le_result_t result;
+    int i;
+
+    srand(1);
+
+    seriesRef = timeSeries_Create("/0/1", factor, 1);
+    LE_ASSERT(seriesRef != NULL);
+
+    for (i = 0; i < numSamples; i++)
+    {
+        double value = 20 + 5 * sin(i / 600.0) + (rand() % 7 - 3) / 100.0;
+
+        timeStamp += 1000 + rand() % 5;
+
+        le_clk_Time_t start = le_clk_GetRelativeTime();
+
+        if (kind == SAMPLE_INT)
+        {
+            result = timeSeries_AddInt(seriesRef, timeStamp, (int)(value * 100));
+        }
+        else
+        {
+            result = timeSeries_AddFloat(seriesRef, timeStamp, value);
+        }
+
+        le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+        results.elapsedUsec += elapsed.sec * 1e6 + elapsed.usec;
+
+        LE_ASSERT((result == LE_OK) || (result == LE_NO_MEMORY));
+
+        if (result == LE_NO_MEMORY)
+        {
+            Push(seriesRef, &results);
+            seriesRef = timeSeries_Create("/0/1", factor, 1);
+            LE_ASSERT(seriesRef != NULL);
+        }
+    }
+
+    Push(seriesRef, &results);
+
+    printf("%-12s %d samples in %u pushes: %.3f us/sample, %.2f CBOR bytes/sample, "
+           "%.2f pushed bytes/sample\n",
+           namePtr,
+           numSamples,
+           results.numPushes,
+           results.elapsedUsec / numSamples,
+           (double)results.numCborBytes / numSamples,
+           (double)results.numPushedBytes / numSamples);
+}
+
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs the benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+    int numSamples = DEFAULT_NUM_SAMPLES;
+    int maxBytes = DEFAULT_MAX_BYTES;
+    int maxRamBytes = DEFAULT_MAX_RAM_BYTES;
+
+    le_arg_SetIntVar(&numSamples, "n", "samples");
+    le_arg_SetIntVar(&maxBytes, "m", "max-bytes");
+    le_arg_SetIntVar(&maxRamBytes, "r", "max-ram-bytes");
+    le_arg_Scan();
+
+    timeSeries_Init(maxRamBytes, maxBytes, SPILL_DIR);
+
+    Run("RecordInt", SAMPLE_INT, numSamples);
+    Run("RecordFloat", SAMPLE_FLOAT, numSamples);
+    Run("RecordFloat*", SAMPLE_FLOAT_FACTOR, numSamples);
+
+    exit(EXIT_SUCCESS);
+
+#else
+    fprintf(stderr, "Time series not supported.\n");
+    exit(EXIT_FAILURE);
+#endif
+}
@@ -0,0 +1,356 @@
+/**
+ * Unit test of the asset data time series limits.
+ *
+ * Records samples that don't compress well in time series limited to a few kilobytes, most of
+ * which can't stay in RAM, and checks that:
+ *  - a time series takes samples until it reports it is full, and then refuses them,
+ *  - its pushed history is within the limit,
+ *  - the history moved to the spill file comes back intact and in order, with the spill file
+ *    already unlinked,
+ *  - the history is kept in RAM, still intact, if the spill file can't be created.
+ *
+ * Without time series support, only checks that time series can't be created.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+#include "legato.h"
+#include "timeSeries.h"
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+#include "zlib.h"
+
+#define MAX_BYTES           8192
+#define MAX_RAM_BYTES       2048
+#define MAX_SAMPLES         4096
+#define FIRST_TIME_STAMP    1500000000000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory holding the spill directory.
+ */
+//--------------------------------------------------------------------------------------------------
+static char TempDir[] = "/tmp/timeSeriesTestXXXXXX";
+static char SpillDir[PATH_MAX];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Recorded samples.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t TimeStamps[MAX_SAMPLES];
+static int Values[MAX_SAMPLES];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the argument of a CBOR item header, and move past it.
+ *
+ * @return The major type of the item.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t ReadHeader
+(
+    const uint8_t** ptrPtr,
+    uint64_t* argPtr
+)
+{
+    const uint8_t* ptr = *ptrPtr;
+    uint8_t info = *ptr & 0x1f;
+    uint8_t majorType = *ptr++ >> 5;
+    int numBytes = 0;
+
+    *argPtr = info;
+
+    if (info >= 24)
+    {
+        LE_ASSERT(info <= 27);
+        numBytes = 1 << (info - 24);
+        *argPtr = 0;
+    }
+
+    for (; numBytes > 0; numBytes--)
+    {
+        *argPtr = (*argPtr << 8) | *ptr++;
+    }
+
+    *ptrPtr = ptr;
+
+    return majorType;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an integer CBOR item, and move past it.
+ */
+//--------------------------------------------------------------------------------------------------
+static int64_t ReadInt
+(
+    const uint8_t** ptrPtr
+)
+{
+    uint64_t arg;
+    uint8_t majorType = ReadHeader(ptrPtr, &arg);
+
+    LE_ASSERT((majorType == 0) || (majorType == 1));
+
+    return (majorType == 0) ? (int64_t)arg : -1 - (int64_t)arg;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Skip a text string CBOR item.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SkipText
+(
+    const uint8_t** ptrPtr
+)
+{
+    uint64_t length;
+
+    LE_ASSERT(ReadHeader(ptrPtr, &length) == 3);
+    *ptrPtr += length;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish a time series, and check that its history holds the recorded integer samples.
+ *
+ * @return The number of bytes of the pushed history.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t CheckHistory
+(
+    timeSeries_Ref_t seriesRef,
+    int numSamples
+)
+{
+    static uint8_t cbor[MAX_SAMPLES * 32];
+    uLongf cborNumBytes = sizeof(cbor);
+    uint8_t* bufferPtr;
+    size_t numBytes;
+    uint64_t arg;
+    uint64_t timeStamp = 0;
+    int64_t value = 0;
+    int i;
+
+    LE_ASSERT(timeSeries_GetNumSamples(seriesRef) == (uint32_t)numSamples);
+    LE_ASSERT_OK(timeSeries_Finish(seriesRef, &bufferPtr, &numBytes));
+    LE_ASSERT(numBytes <= MAX_BYTES);
+
+    LE_ASSERT(uncompress(cbor, &cborNumBytes, bufferPtr, numBytes) == Z_OK);
+
+    // { "h" : [ "/0/1" ], "f" : [ 1.0, 1.0 ], "s" : [ time stamp, value, ... ] }
+    const uint8_t* ptr = cbor;
+
+    LE_ASSERT((ReadHeader(&ptr, &arg) == 5) && (arg == 3));
+    SkipText(&ptr);
+    LE_ASSERT((ReadHeader(&ptr, &arg) == 4) && (arg == 1));
+    SkipText(&ptr);
+    SkipText(&ptr);
+    LE_ASSERT((ReadHeader(&ptr, &arg) == 4) && (arg == 2));
+    LE_ASSERT((ptr[0] == 0xfb) && (ptr[9] == 0xfb));
+    ptr += 18;
+    SkipText(&ptr);
+    LE_ASSERT(*ptr++ == 0x9f);
+
+    // Samples are delta encoded.
+    for (i = 0; i < numSamples; i++)
+    {
+        timeStamp += ReadInt(&ptr);
+        value += ReadInt(&ptr);
+
+        LE_ASSERT(timeStamp == TimeStamps[i]);
+        LE_ASSERT(value == Values[i]);
+    }
+
+    LE_ASSERT(*ptr++ == 0xff);
+    LE_ASSERT(ptr == cbor + cborNumBytes);
+
+    free(bufferPtr);
+    timeSeries_Delete(seriesRef);
+
+    return numBytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record random samples in a time series until it is full.
+ *
+ * @return The number of samples recorded.
+ */
+//--------------------------------------------------------------------------------------------------
+static int Fill
+(
+    timeSeries_Ref_t seriesRef
+)
+{
+    uint64_t timeStamp = FIRST_TIME_STAMP;
+    le_result_t result = LE_OK;
+    int i;
+
+    for (i = 0; (i < MAX_SAMPLES) && (result == LE_OK); i++)
+    {
+        timeStamp += rand() % 100000;
+        TimeStamps[i] = timeStamp;
+        Values[i] = rand() % 1000000;
+
+        result = timeSeries_AddInt(seriesRef, TimeStamps[i], Values[i]);
+        LE_ASSERT((result == LE_OK) || (result == LE_NO_MEMORY));
+    }
+
+    LE_ASSERT(result == LE_NO_MEMORY);
+
+    // A full time series refuses the next samples.
+    LE_ASSERT(timeSeries_AddInt(seriesRef, timeStamp + 1000, 0) == LE_OVERFLOW);
+    LE_ASSERT(timeSeries_AddString(seriesRef, timeStamp + 1000, "x") == LE_OVERFLOW);
+
+    return i;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a directory is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckEmptyDir
+(
+    const char* pathPtr
+)
+{
+    DIR* dirPtr = opendir(pathPtr);
+    struct dirent* entryPtr;
+
+    LE_ASSERT(dirPtr != NULL);
+
+    while ((entryPtr = readdir(dirPtr)) != NULL)
+    {
+        LE_ASSERT((strcmp(entryPtr->d_name, ".") == 0) || (strcmp(entryPtr->d_name, "..") == 0));
+    }
+
+    closedir(dirPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test a short time series, that is compressed in one go when it is finished.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestShort
+(
+    void
+)
+{
+    timeSeries_Ref_t seriesRef = timeSeries_Create("/0/1", 1, 1);
+    int i;
+
+    LE_INFO("======== Short time series ========");
+
+    LE_ASSERT(seriesRef != NULL);
+
+    for (i = 0; i < 10; i++)
+    {
+        TimeStamps[i] = FIRST_TIME_STAMP + i * 1000;
+        Values[i] = i - 5;
+        LE_ASSERT_OK(timeSeries_AddInt(seriesRef, TimeStamps[i], Values[i]));
+    }
+
+    CheckHistory(seriesRef, 10);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test a time series that fills up, with its oldest history spilled to a file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestSpill
+(
+    void
+)
+{
+    timeSeries_Ref_t seriesRef = timeSeries_Create("/0/1", 1, 1);
+
+    LE_INFO("======== Spilled time series ========");
+
+    LE_ASSERT(seriesRef != NULL);
+
+    int numSamples = Fill(seriesRef);
+
+    // The spill file is unlinked as soon as it is created.
+    CheckEmptyDir(SpillDir);
+
+    size_t numBytes = CheckHistory(seriesRef, numSamples);
+
+    LE_INFO("%d samples, %zu bytes", numSamples, numBytes);
+
+    // The history is close to the limit, and more than could stay in RAM.
+    LE_ASSERT(numBytes > MAX_BYTES / 2);
+    LE_ASSERT(numBytes > MAX_RAM_BYTES * 2);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test a time series that fills up while its spill file can't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestSpillFailure
+(
+    void
+)
+{
+    timeSeries_Ref_t seriesRef = timeSeries_Create("/0/1", 1, 1);
+
+    LE_INFO("======== Time series without spill file ========");
+
+    LE_ASSERT(seriesRef != NULL);
+
+    // A file in the way of the spill directory.
+    LE_ASSERT_OK(le_dir_RemoveRecursive(SpillDir));
+    int fd = open(SpillDir, O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    LE_ASSERT(fd != -1);
+    close(fd);
+
+    int numSamples = Fill(seriesRef);
+    size_t numBytes = CheckHistory(seriesRef, numSamples);
+
+    LE_INFO("%d samples, %zu bytes", numSamples, numBytes);
+    LE_ASSERT(numBytes > MAX_RAM_BYTES * 2);
+
+    LE_ASSERT(unlink(SpillDir) == 0);
+}
+
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs the test.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+    LE_ASSERT(mkdtemp(TempDir) != NULL);
+    LE_ASSERT(snprintf(SpillDir, sizeof(SpillDir), "%s/spill", TempDir) < (int)sizeof(SpillDir));
+
+    srand(1);
+
+    timeSeries_Init(MAX_RAM_BYTES, MAX_BYTES, SpillDir);
+
+    TestShort();
+    TestSpill();
+    TestSpillFailure();
+
+    LE_ASSERT_OK(le_dir_RemoveRecursive(TempDir));
+
+#else
+
+    LE_ASSERT(timeSeries_Create("/0/1", 1, 1) == NULL);
+
+#endif
+
+    LE_INFO("======== Time series test ends with SUCCESS ========");
+
+    exit(EXIT_SUCCESS);
+}
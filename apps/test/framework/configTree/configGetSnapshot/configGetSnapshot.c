@@ -0,0 +1,410 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Tests reading config subtrees in one go with le_cfg_GetSnapshot(), as the supervisor does when it
+ *  creates and starts apps.
+ *
+ *  A tree is built that takes several GetSnapshot() windows, then read back through the
+ *  supervisor's snapshot reader and compared, node by node and with the same defaults, to the same
+ *  reads made on the live tree.  The reader must also reject every truncation of the snapshot, and
+ *  survive any damaged byte.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "cfgSnapshot.h"
+
+
+
+
+/// Root of the nodes created by the test.  Snapshots are read from the default tree, as the
+/// supervisor does.
+#define TEST_ROOT "/configGetSnapshot/"
+
+
+/// Number of list entries created, enough for the snapshot to take several windows.
+#define LIST_COUNT 30
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Create the test's nodes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteTree
+(
+    void
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+    char value[LE_CFG_STR_LEN_BYTES];
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(TEST_ROOT);
+
+    le_cfg_DeleteNode(iterRef, "");
+
+    le_cfg_SetString(iterRef, "app/version", "1.0");
+    le_cfg_SetString(iterRef, "app/number", "42");
+    le_cfg_SetInt(iterRef, "app/int", -7);
+    le_cfg_SetBool(iterRef, "app/true", true);
+    le_cfg_SetBool(iterRef, "app/false", false);
+    le_cfg_SetFloat(iterRef, "app/float", 2.5);
+    le_cfg_SetString(iterRef, "app/emptyString", "");
+    le_cfg_SetEmpty(iterRef, "app/empty");
+    le_cfg_SetString(iterRef, "app/procs/main/args/0", "/bin/main");
+    le_cfg_SetString(iterRef, "app/procs/main/envVars/PATH", "/usr/bin:/bin");
+
+    // The longest value, and a node with the longest name.
+    memset(value, 'v', LE_CFG_STR_LEN);
+    value[LE_CFG_STR_LEN] = '\0';
+    le_cfg_SetString(iterRef, "app/long", value);
+
+    char name[LE_CFG_NAME_LEN_BYTES];
+    memset(name, 'n', LE_CFG_NAME_LEN);
+    name[LE_CFG_NAME_LEN] = '\0';
+    LE_ASSERT(snprintf(path, sizeof(path), "app/%s", name) < (int)sizeof(path));
+    le_cfg_SetInt(iterRef, path, 1);
+
+    // A sibling of the snapshot's node, which must not be part of the snapshot.
+    le_cfg_SetString(iterRef, "sibling", "outside");
+
+    for (int i = 0; i < LIST_COUNT; i++)
+    {
+        LE_ASSERT(snprintf(path, sizeof(path), "app/list/%d/value", i) < (int)sizeof(path));
+        le_cfg_SetString(iterRef, path, value + i);
+
+        LE_ASSERT(snprintf(path, sizeof(path), "app/list/%d/index", i) < (int)sizeof(path));
+        le_cfg_SetInt(iterRef, path, i);
+    }
+
+    le_cfg_CommitTxn(iterRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Compare the reads of a node, and of paths relative to it, between the live tree and a snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompareReads
+(
+    le_cfg_IteratorRef_t cfgIterRef,
+    cfgSnapshot_IteratorRef_t snapIterRef,
+    const char* pathPtr
+)
+{
+    char cfgBuffer[LE_CFG_STR_LEN_BYTES];
+    char snapBuffer[LE_CFG_STR_LEN_BYTES];
+
+    LE_ASSERT(le_cfg_GetNodeType(cfgIterRef, pathPtr)
+              == cfgSnapshot_GetNodeType(snapIterRef, pathPtr));
+    LE_ASSERT(le_cfg_NodeExists(cfgIterRef, pathPtr)
+              == cfgSnapshot_NodeExists(snapIterRef, pathPtr));
+    LE_ASSERT(le_cfg_IsEmpty(cfgIterRef, pathPtr) == cfgSnapshot_IsEmpty(snapIterRef, pathPtr));
+
+    LE_ASSERT(le_cfg_GetInt(cfgIterRef, pathPtr, 1234)
+              == cfgSnapshot_GetInt(snapIterRef, pathPtr, 1234));
+    LE_ASSERT(le_cfg_GetBool(cfgIterRef, pathPtr, true)
+              == cfgSnapshot_GetBool(snapIterRef, pathPtr, true));
+    LE_ASSERT(le_cfg_GetBool(cfgIterRef, pathPtr, false)
+              == cfgSnapshot_GetBool(snapIterRef, pathPtr, false));
+
+    LE_ASSERT(le_cfg_GetString(cfgIterRef, pathPtr, cfgBuffer, sizeof(cfgBuffer), "default")
+              == cfgSnapshot_GetString(snapIterRef, pathPtr, snapBuffer, sizeof(snapBuffer),
+                                       "default"));
+    LE_ASSERT(strcmp(cfgBuffer, snapBuffer) == 0);
+
+    // A buffer too small for the value.
+    LE_ASSERT(le_cfg_GetString(cfgIterRef, pathPtr, cfgBuffer, 3, "default")
+              == cfgSnapshot_GetString(snapIterRef, pathPtr, snapBuffer, 3, "default"));
+    LE_ASSERT(strcmp(cfgBuffer, snapBuffer) == 0);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Walk the live tree and a snapshot side by side, from the iterators' current nodes and their
+ *  siblings down, comparing every node.  The siblings of the snapshot's node are not part of it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompareNodes
+(
+    le_cfg_IteratorRef_t cfgIterRef,
+    cfgSnapshot_IteratorRef_t snapIterRef,
+    bool isSnapshotRoot         ///< The iterators are on the snapshot's node, which has no parent
+                                ///  in the snapshot.
+)
+{
+    char cfgName[LE_CFG_NAME_LEN_BYTES];
+    char snapName[LE_CFG_NAME_LEN_BYTES];
+    le_result_t result;
+
+    do
+    {
+        LE_ASSERT_OK(le_cfg_GetNodeName(cfgIterRef, "", cfgName, sizeof(cfgName)));
+        LE_ASSERT_OK(cfgSnapshot_GetNodeName(snapIterRef, "", snapName, sizeof(snapName)));
+        LE_ASSERT(strcmp(cfgName, snapName) == 0);
+
+        CompareReads(cfgIterRef, snapIterRef, "");
+
+        // The same node, read by name from its parent.
+        if (!isSnapshotRoot)
+        {
+            char path[LE_CFG_STR_LEN_BYTES];
+            LE_ASSERT(snprintf(path, sizeof(path), "../%s", cfgName) < (int)sizeof(path));
+            CompareReads(cfgIterRef, snapIterRef, path);
+        }
+
+        result = le_cfg_GoToFirstChild(cfgIterRef);
+        LE_ASSERT(cfgSnapshot_GoToFirstChild(snapIterRef) == result);
+
+        if (result == LE_OK)
+        {
+            CompareNodes(cfgIterRef, snapIterRef, false);
+
+            LE_ASSERT_OK(le_cfg_GoToParent(cfgIterRef));
+            LE_ASSERT_OK(cfgSnapshot_GoToParent(snapIterRef));
+        }
+
+        if (isSnapshotRoot)
+        {
+            LE_ASSERT(cfgSnapshot_GoToNextSibling(snapIterRef) == LE_NOT_FOUND);
+            break;
+        }
+
+        result = le_cfg_GoToNextSibling(cfgIterRef);
+        LE_ASSERT(cfgSnapshot_GoToNextSibling(snapIterRef) == result);
+    }
+    while (result == LE_OK);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read the test's tree through a snapshot and compare it to the live tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckSnapshot
+(
+    void
+)
+{
+    le_cfg_IteratorRef_t cfgIterRef = le_cfg_CreateReadTxn(TEST_ROOT "app");
+    cfgSnapshot_Ref_t snapshotRef = cfgSnapshot_Read(TEST_ROOT "app");
+    cfgSnapshot_IteratorRef_t snapIterRef = cfgSnapshot_CreateIterator(snapshotRef, "");
+
+    CompareNodes(cfgIterRef, snapIterRef, true);
+
+    // Paths that don't exist, and reads that fall back to the defaults.
+    static const char* paths[] =
+    {
+        "version", "number", "int", "true", "false", "float", "emptyString", "empty",
+        "procs", "procs/main/args/0", "procs/main/args/1", "doesNotExist", "list/3/index",
+        "list/..", "list/../true", "./int", TEST_ROOT "app/list/4/value", TEST_ROOT "app/int/child",
+        TEST_ROOT "app",
+    };
+
+    le_cfg_GoToNode(cfgIterRef, TEST_ROOT "app");
+    cfgSnapshot_GoToNode(snapIterRef, TEST_ROOT "app");
+
+    for (size_t i = 0; i < NUM_ARRAY_MEMBERS(paths); i++)
+    {
+        LE_INFO("Checking '%s'.", paths[i]);
+        CompareReads(cfgIterRef, snapIterRef, paths[i]);
+    }
+
+    cfgSnapshot_DeleteIterator(snapIterRef);
+    cfgSnapshot_Release(snapshotRef);
+    le_cfg_CancelTxn(cfgIterRef);
+
+    // A node that doesn't exist reads as an empty snapshot.
+    snapshotRef = cfgSnapshot_Read(TEST_ROOT "doesNotExist");
+    snapIterRef = cfgSnapshot_CreateIterator(snapshotRef, "");
+    cfgIterRef = le_cfg_CreateReadTxn(TEST_ROOT "doesNotExist");
+
+    CompareReads(cfgIterRef, snapIterRef, "");
+    CompareReads(cfgIterRef, snapIterRef, "child");
+
+    cfgSnapshot_DeleteIterator(snapIterRef);
+    cfgSnapshot_Release(snapshotRef);
+    le_cfg_CancelTxn(cfgIterRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read the test's tree straight from le_cfg_GetSnapshot(), one window at a time.
+ *
+ *  @return The snapshot's bytes, to be freed by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* ReadWindows
+(
+    size_t* numBytesPtr         ///< [OUT] Number of bytes read.
+)
+{
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(TEST_ROOT);
+    uint8_t window[LE_CFG_SNAPSHOT_LEN];
+    size_t windowSize = sizeof(window);
+    uint32_t totalSize = 0;
+    int windowCount = 1;
+
+    LE_ASSERT_OK(le_cfg_GetSnapshot(iterRef, "app", 0, window, &windowSize, &totalSize));
+    LE_ASSERT(windowSize == sizeof(window));
+    LE_ASSERT(totalSize > 2 * LE_CFG_SNAPSHOT_LEN);
+    LE_ASSERT(window[0] == LE_CFG_SNAPSHOT_VERSION);
+
+    uint8_t* bytesPtr = malloc(totalSize);
+    LE_ASSERT(bytesPtr != NULL);
+    memcpy(bytesPtr, window, windowSize);
+
+    size_t numBytes = windowSize;
+
+    while (numBytes < totalSize)
+    {
+        uint32_t windowTotalSize = 0;
+
+        windowSize = sizeof(window);
+        LE_ASSERT_OK(le_cfg_GetSnapshot(iterRef, "app", numBytes, window, &windowSize,
+                                        &windowTotalSize));
+        LE_ASSERT(windowTotalSize == totalSize);
+        LE_ASSERT((windowSize > 0) && (numBytes + windowSize <= totalSize));
+
+        memcpy(bytesPtr + numBytes, window, windowSize);
+        numBytes += windowSize;
+        windowCount++;
+    }
+
+    LE_INFO("Read %zu snapshot bytes in %d windows.", numBytes, windowCount);
+
+    windowSize = sizeof(window);
+    LE_ASSERT(le_cfg_GetSnapshot(iterRef, "app", numBytes, window, &windowSize, &totalSize)
+              == LE_OUT_OF_RANGE);
+
+    windowSize = sizeof(window);
+    LE_ASSERT(le_cfg_GetSnapshot(iterRef, "doesNotExist", 0, window, &windowSize, &totalSize)
+              == LE_NOT_FOUND);
+
+    le_cfg_CancelTxn(iterRef);
+
+    *numBytesPtr = numBytes;
+
+    return bytesPtr;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read every node of a snapshot that was accepted, damaged or not.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadAllNodes
+(
+    cfgSnapshot_IteratorRef_t iterRef
+)
+{
+    char buffer[LE_CFG_STR_LEN_BYTES];
+
+    do
+    {
+        cfgSnapshot_GetNodeName(iterRef, "", buffer, sizeof(buffer));
+        cfgSnapshot_GetString(iterRef, "", buffer, sizeof(buffer), "");
+        cfgSnapshot_GetInt(iterRef, "", 0);
+        cfgSnapshot_GetBool(iterRef, "", false);
+
+        if (cfgSnapshot_GoToFirstChild(iterRef) == LE_OK)
+        {
+            ReadAllNodes(iterRef);
+            LE_ASSERT_OK(cfgSnapshot_GoToParent(iterRef));
+        }
+    }
+    while (cfgSnapshot_GoToNextSibling(iterRef) == LE_OK);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Check that the snapshot reader rejects truncated snapshots, and doesn't read out of bounds when
+ *  given damaged ones.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckDamagedSnapshots
+(
+    const uint8_t* bytesPtr,
+    size_t numBytes
+)
+{
+    cfgSnapshot_Ref_t snapshotRef = cfgSnapshot_Create(TEST_ROOT "app", bytesPtr, numBytes);
+    LE_ASSERT(snapshotRef != NULL);
+    cfgSnapshot_Release(snapshotRef);
+
+    for (size_t size = 1; size < numBytes; size++)
+    {
+        LE_ASSERT(cfgSnapshot_Create(TEST_ROOT "app", bytesPtr, size) == NULL);
+    }
+
+    uint8_t* damagedPtr = malloc(numBytes);
+    LE_ASSERT(damagedPtr != NULL);
+
+    for (size_t i = 0; i < numBytes; i++)
+    {
+        memcpy(damagedPtr, bytesPtr, numBytes);
+        damagedPtr[i] ^= 0xFF;
+
+        snapshotRef = cfgSnapshot_Create(TEST_ROOT "app", damagedPtr, numBytes);
+
+        if (snapshotRef != NULL)
+        {
+            cfgSnapshot_IteratorRef_t iterRef = cfgSnapshot_CreateIterator(snapshotRef, "");
+            ReadAllNodes(iterRef);
+            cfgSnapshot_DeleteIterator(iterRef);
+            cfgSnapshot_Release(snapshotRef);
+        }
+    }
+
+    free(damagedPtr);
+}
+
+
+
+
+COMPONENT_INIT
+{
+    cfgSnapshot_Init();
+
+    LE_INFO("----  Writing the test tree.  ------------------------------");
+    WriteTree();
+
+    LE_INFO("----  Comparing a snapshot to the live tree.  --------------");
+    CheckSnapshot();
+
+    LE_INFO("----  Reading the snapshot window by window.  --------------");
+    size_t numBytes;
+    uint8_t* bytesPtr = ReadWindows(&numBytes);
+
+    LE_INFO("----  Checking damaged snapshots.  -------------------------");
+    CheckDamagedSnapshots(bytesPtr, numBytes);
+    free(bytesPtr);
+
+    le_cfg_QuickDeleteNode(TEST_ROOT);
+
+    LE_INFO("----  Done.  ------------------------------");
+
+    exit(EXIT_SUCCESS);
+}
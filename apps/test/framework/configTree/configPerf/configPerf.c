@@ -0,0 +1,140 @@
+ /**
+  * Micro-benchmark for config tree reads.
+  *
+  * Fills stems with 10, 1000 and 10000 integer children in a scratch tree, and then measures the
+  * time taken to read children back through a read transaction, both at random and always the
+  * last child added to the stem.  This shows how node lookup scales with the number of siblings.
+  *
+  * Needs the Config Tree to be running.  The scratch tree is deleted at the end of the test.
+  *
+  * Usage: configPerfExe [-n READS]
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#include "legato.h"
+#include "interfaces.h"
+
+#define DEFAULT_NUM_READS 10000
+
+#define TREE_NAME "configPerf"
+
+static int NumReads = DEFAULT_NUM_READS;
+
+static const int SiblingCounts[] = { 10, 1000, 10000 };
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the elapsed time since a given start time, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double ElapsedSecs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return elapsed.sec + (elapsed.usec / 1000000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a stem with a given number of children, each holding its own index as its value.
+ *
+ * @return The time taken to create the children and commit them, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double FillStem
+(
+    const char* stemPath,
+    int numSiblings
+)
+{
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(stemPath);
+    char name[LE_CFG_NAME_LEN_BYTES];
+    int i;
+
+    for (i = 0; i < numSiblings; i++)
+    {
+        snprintf(name, sizeof(name), "child%d", i);
+        le_cfg_SetInt(iterRef, name, i);
+    }
+
+    le_cfg_CommitTxn(iterRef);
+
+    return ElapsedSecs(startTime);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read children of a stem, either at random or always the last one.
+ *
+ * @return The average time taken by each read, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double ReadStem
+(
+    const char* stemPath,
+    int numSiblings,
+    bool readLast
+)
+{
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(stemPath);
+    char name[LE_CFG_NAME_LEN_BYTES];
+    le_clk_Time_t startTime;
+    int i;
+
+    startTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i < NumReads; i++)
+    {
+        int child = readLast ? (numSiblings - 1) : (rand() % numSiblings);
+
+        snprintf(name, sizeof(name), "child%d", child);
+        LE_ASSERT(le_cfg_GetInt(iterRef, name, -1) == child);
+    }
+
+    double elapsedSecs = ElapsedSecs(startTime);
+
+    le_cfg_CancelTxn(iterRef);
+
+    return (elapsedSecs * 1000000.0) / NumReads;
+}
+
+
+COMPONENT_INIT
+{
+    size_t i;
+
+    le_arg_SetIntVar(&NumReads, "n", "reads");
+    le_arg_Scan();
+
+    LE_ASSERT(NumReads > 0);
+
+    printf("*** Performance test for config tree reads. ***\n");
+    printf("%10s %12s %16s %16s\n", "siblings", "fill ms", "random read us", "last read us");
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(SiblingCounts); i++)
+    {
+        char stemPath[LE_CFG_STR_LEN_BYTES];
+
+        snprintf(stemPath, sizeof(stemPath), TREE_NAME ":/siblings%d", SiblingCounts[i]);
+
+        double fillSecs = FillStem(stemPath, SiblingCounts[i]);
+
+        printf("%10d %12.1f %16.2f %16.2f\n",
+               SiblingCounts[i],
+               fillSecs * 1000.0,
+               ReadStem(stemPath, SiblingCounts[i], false),
+               ReadStem(stemPath, SiblingCounts[i], true));
+    }
+
+    le_cfgAdmin_DeleteTree(TREE_NAME);
+
+    exit(EXIT_SUCCESS);
+}
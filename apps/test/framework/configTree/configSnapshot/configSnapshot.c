@@ -0,0 +1,312 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Tests the loading of config tree snapshots straight through the tree DB.
+ *
+ *  Run first with the argument "write" to build two trees and write their snapshots, damaging the
+ *  second one so that a value runs past the maximum value length, but with a good CRC.  Then run
+ *  again with "check" to load the trees back from the files.  The first tree must come back
+ *  intact, the second must be rejected and come back empty.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "sysPaths.h"
+#include "dynamicString.h"
+#include "treeDb.h"
+#include "treeUser.h"
+#include "nodeIterator.h"
+
+
+
+
+/// Name of the tree whose snapshot is left intact.
+#define GOOD_TREE "configSnapshotGood"
+
+
+/// Name of the tree whose snapshot is damaged.
+#define BAD_TREE "configSnapshotBad"
+
+
+/// Character used to fill the longest names and values.
+#define FILL_CHAR 'v'
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Header found at the start of a tree snapshot, as written by the tree DB.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t nodeCount;
+    uint32_t crc;
+}
+SnapshotHeader_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  The tree DB only calls out to the node iterator to check for pending writes, and there are no
+ *  iterators in this test.
+ */
+//--------------------------------------------------------------------------------------------------
+bool ni_IsWriteable
+(
+    ni_ConstIteratorRef_t iteratorRef
+)
+{
+    return false;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Look up a node by path, creating it if asked to.
+ */
+//--------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t GetNode
+(
+    tdb_NodeRef_t rootRef,
+    const char* pathPtr,
+    bool create
+)
+{
+    le_pathIter_Ref_t pathRef = le_pathIter_CreateForUnix(pathPtr);
+    tdb_NodeRef_t nodeRef = create ? tdb_CreateNodePath(rootRef, pathRef)
+                                   : tdb_GetNode(rootRef, pathRef);
+
+    le_pathIter_Delete(pathRef);
+
+    return nodeRef;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Build the longest allowed name and value.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetLongStrings
+(
+    char* namePtr,   ///< [OUT] LE_CFG_NAME_LEN_BYTES buffer.
+    char* valuePtr   ///< [OUT] LE_CFG_STR_LEN_BYTES buffer.
+)
+{
+    memset(namePtr, FILL_CHAR, LE_CFG_NAME_LEN);
+    namePtr[LE_CFG_NAME_LEN] = '\0';
+    namePtr[0] = '/';
+
+    memset(valuePtr, FILL_CHAR, LE_CFG_STR_LEN);
+    valuePtr[LE_CFG_STR_LEN] = '\0';
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Create a tree and merge it, which writes out its first snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteTree
+(
+    const char* treeNamePtr
+)
+{
+    char name[LE_CFG_NAME_LEN_BYTES];
+    char value[LE_CFG_STR_LEN_BYTES];
+
+    GetLongStrings(name, value);
+
+    tdb_TreeRef_t shadowRef = tdb_ShadowTree(tdb_GetTree(treeNamePtr));
+    tdb_NodeRef_t rootRef = tdb_GetRootNode(shadowRef);
+
+    tdb_SetValueAsString(GetNode(rootRef, "/stem/string", true), "hello");
+    tdb_SetValueAsInt(GetNode(rootRef, "/stem/int", true), 42);
+    tdb_SetValueAsBool(GetNode(rootRef, "/stem/bool", true), true);
+    tdb_SetValueAsFloat(GetNode(rootRef, "/stem/float", true), 1.5);
+    tdb_SetValueAsString(GetNode(rootRef, "/long", true), value);
+    tdb_SetValueAsString(GetNode(rootRef, name, true), "longName");
+
+    tdb_MergeTree(shadowRef);
+    tdb_ReleaseTree(shadowRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Stretch the long value in a tree's snapshot past the maximum value length by overwriting its
+ *  terminator, then fix up the snapshot's CRC so that only the length check can catch it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DamageSnapshot
+(
+    const char* treeNamePtr
+)
+{
+    static const char* revNames[] = { "paper", "rock", "scissors" };
+    char path[PATH_MAX];
+    int fd = -1;
+
+    for (size_t i = 0; (i < NUM_ARRAY_MEMBERS(revNames)) && (fd == -1); i++)
+    {
+        LE_ASSERT(snprintf(path, sizeof(path), "%s/%s.%s", CFG_TREE_PATH, treeNamePtr, revNames[i])
+                  < (int)sizeof(path));
+        fd = open(path, O_RDWR);
+    }
+
+    LE_ASSERT(fd != -1);
+
+    struct stat fileStat;
+    LE_ASSERT(fstat(fd, &fileStat) == 0);
+
+    size_t size = fileStat.st_size;
+    uint8_t* bufferPtr = malloc(size);
+    LE_ASSERT(bufferPtr != NULL);
+    LE_ASSERT(pread(fd, bufferPtr, size, 0) == (ssize_t)size);
+
+    SnapshotHeader_t* headerPtr = (SnapshotHeader_t*)bufferPtr;
+    LE_ASSERT(headerPtr->size == size);
+
+    char name[LE_CFG_NAME_LEN_BYTES];
+    char value[LE_CFG_STR_LEN_BYTES];
+
+    GetLongStrings(name, value);
+
+    // The value must be followed by another string, or the snapshot would be rejected for not
+    // ending with a terminator instead.
+    uint8_t* valuePtr = memmem(bufferPtr, size, value, sizeof(value));
+    LE_ASSERT(valuePtr != NULL);
+    LE_ASSERT(valuePtr + sizeof(value) < bufferPtr + size);
+    valuePtr[LE_CFG_STR_LEN] = FILL_CHAR;
+
+    headerPtr->crc = le_crc_Crc32(bufferPtr + sizeof(SnapshotHeader_t),
+                                  size - sizeof(SnapshotHeader_t),
+                                  LE_CRC_START_CRC32);
+
+    LE_ASSERT(pwrite(fd, bufferPtr, size, 0) == (ssize_t)size);
+    LE_ASSERT(close(fd) == 0);
+    free(bufferPtr);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Check that a tree was loaded back intact.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckGoodTree
+(
+    void
+)
+{
+    char name[LE_CFG_NAME_LEN_BYTES];
+    char value[LE_CFG_STR_LEN_BYTES];
+    char buffer[LE_CFG_STR_LEN_BYTES];
+
+    GetLongStrings(name, value);
+
+    tdb_NodeRef_t rootRef = tdb_GetRootNode(tdb_GetTree(GOOD_TREE));
+
+    LE_ASSERT_OK(tdb_GetValueAsString(GetNode(rootRef, "/stem/string", false),
+                                      buffer,
+                                      sizeof(buffer),
+                                      ""));
+    LE_ASSERT(strcmp(buffer, "hello") == 0);
+
+    LE_ASSERT(tdb_GetValueAsInt(GetNode(rootRef, "/stem/int", false), 0) == 42);
+    LE_ASSERT(tdb_GetValueAsBool(GetNode(rootRef, "/stem/bool", false), false) == true);
+    LE_ASSERT(tdb_GetValueAsFloat(GetNode(rootRef, "/stem/float", false), 0.0) == 1.5);
+
+    LE_ASSERT_OK(tdb_GetValueAsString(GetNode(rootRef, "/long", false),
+                                      buffer,
+                                      sizeof(buffer),
+                                      ""));
+    LE_ASSERT(strcmp(buffer, value) == 0);
+
+    LE_ASSERT_OK(tdb_GetValueAsString(GetNode(rootRef, name, false),
+                                      buffer,
+                                      sizeof(buffer),
+                                      ""));
+    LE_ASSERT(strcmp(buffer, "longName") == 0);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Check that a damaged tree was rejected, leaving it empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckBadTree
+(
+    void
+)
+{
+    tdb_NodeRef_t rootRef = tdb_GetRootNode(tdb_GetTree(BAD_TREE));
+
+    LE_ASSERT(tdb_GetFirstActiveChildNode(rootRef) == NULL);
+    LE_ASSERT(GetNode(rootRef, "/stem/string", false) == NULL);
+}
+
+
+
+
+COMPONENT_INIT
+{
+    const char* modePtr = le_arg_GetArg(0);
+
+    LE_ASSERT(modePtr != NULL);
+
+    dstr_Init();
+    tdb_Init();
+
+    if (strcmp(modePtr, "write") == 0)
+    {
+        LE_INFO("----  Writing tree snapshots.  ------------------------------");
+
+        tdb_DeleteTree(tdb_GetTree(GOOD_TREE));
+        tdb_DeleteTree(tdb_GetTree(BAD_TREE));
+
+        WriteTree(GOOD_TREE);
+        WriteTree(BAD_TREE);
+        DamageSnapshot(BAD_TREE);
+    }
+    else if (strcmp(modePtr, "check") == 0)
+    {
+        LE_INFO("----  Loading tree snapshots.  ------------------------------");
+
+        CheckGoodTree();
+        CheckBadTree();
+
+        tdb_DeleteTree(tdb_GetTree(GOOD_TREE));
+        tdb_DeleteTree(tdb_GetTree(BAD_TREE));
+    }
+    else
+    {
+        LE_FATAL("Unknown mode '%s'.", modePtr);
+    }
+
+    LE_INFO("----  Done.  ------------------------------");
+
+    exit(EXIT_SUCCESS);
+}
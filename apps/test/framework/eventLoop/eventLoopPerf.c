@@ -0,0 +1,178 @@
+ /**
+  * Micro-benchmark for cross-thread delivery of event reports.
+  *
+  * Measures the number of event reports per second delivered between two threads, first as a
+  * ping-pong (each report is only sent once the previous one has been handled), then as a
+  * stream of back-to-back reports from one thread to the other.
+  *
+  * Usage: testFwEventLoopPerf [-n REPORTS]
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#include "legato.h"
+
+#define DEFAULT_NUM_REPORTS 100000
+
+static int NumReports = DEFAULT_NUM_REPORTS;
+
+static le_thread_Ref_t MainThread;
+static le_event_Id_t PingId;
+static le_event_Id_t PongId;
+static le_event_Id_t StreamId;
+
+static le_clk_Time_t StartTime;
+static int NumStreamReports;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the elapsed time since the start of the current test, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double ElapsedSecs
+(
+    void
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), StartTime);
+
+    return elapsed.sec + (elapsed.usec / 1000000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs in the main thread once the other thread has received all of the streamed reports.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StreamDone
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    printf("%-12s %15.0f\n", "stream", NumReports / ElapsedSecs());
+
+    exit(EXIT_SUCCESS);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs in the other thread for each streamed report.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StreamHandler
+(
+    void* reportPtr
+)
+{
+    if (++NumStreamReports == NumReports)
+    {
+        le_event_QueueFunctionToThread(MainThread, StreamDone, NULL, NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs in the other thread for each ping, and sends a pong back.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PingHandler
+(
+    void* reportPtr
+)
+{
+    le_event_Report(PongId, reportPtr, sizeof(uint32_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs in the main thread for each pong.  Sends the next ping, or starts the stream test once
+ * all the pings have been sent.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PongHandler
+(
+    void* reportPtr
+)
+{
+    uint32_t count = *(uint32_t*)reportPtr + 1;
+    int i;
+
+    if (count < (uint32_t)NumReports)
+    {
+        le_event_Report(PingId, &count, sizeof(count));
+        return;
+    }
+
+    // Each round trip is two reports.
+    printf("%-12s %15.0f\n", "ping-pong", (2.0 * NumReports) / ElapsedSecs());
+
+    StartTime = le_clk_GetRelativeTime();
+    for (i = 0; i < NumReports; i++)
+    {
+        le_event_Report(StreamId, &count, sizeof(count));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs in the main thread once the other thread is ready, and sends the first ping.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartPingPong
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    uint32_t count = 0;
+
+    printf("%-12s %15s\n", "test", "reports/s");
+
+    StartTime = le_clk_GetRelativeTime();
+    le_event_Report(PingId, &count, sizeof(count));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The other thread.  Handles pings and streamed reports.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* OtherThread
+(
+    void* contextPtr
+)
+{
+    le_event_AddHandler("Ping", PingId, PingHandler);
+    le_event_AddHandler("Stream", StreamId, StreamHandler);
+
+    le_event_QueueFunctionToThread(MainThread, StartPingPong, NULL, NULL);
+
+    le_event_RunLoop();
+}
+
+
+COMPONENT_INIT
+{
+    le_arg_SetIntVar(&NumReports, "n", "reports");
+    le_arg_Scan();
+
+    printf("*** Performance test for event report delivery between threads. ***\n");
+
+    MainThread = le_thread_GetCurrent();
+
+    PingId = le_event_CreateId("Ping", sizeof(uint32_t));
+    PongId = le_event_CreateId("Pong", sizeof(uint32_t));
+    StreamId = le_event_CreateId("Stream", sizeof(uint32_t));
+
+    le_event_AddHandler("Pong", PongId, PongHandler);
+
+    le_thread_Start(le_thread_Create("Other", OtherThread, NULL));
+}
@@ -0,0 +1,139 @@
+ /**
+  * Micro-benchmark for the le_hashmap module.
+  *
+  * Measures the time taken by le_hashmap_Put(), le_hashmap_Get() and le_hashmap_Remove() on maps
+  * of 10 to N uint32_t keys, for:
+  *
+  *  - a chained map whose capacity is given up front (the only case the map handled well before
+  *    it could grow),
+  *  - a chained map created with a small capacity, that has to grow as the keys are added,
+  *  - an open-addressed map created with a small capacity.
+  *
+  * Usage: testFwHashmapPerf [-n MAX_ENTRIES] [-c SMALL_CAPACITY]
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#include "legato.h"
+
+#define DEFAULT_MAX_ENTRIES     1000000
+#define DEFAULT_SMALL_CAPACITY  31
+#define MAX_DECADES             10
+#define NAME_BYTES              16
+
+static uint32_t* Keys;
+static int SmallCapacity = DEFAULT_SMALL_CAPACITY;
+
+// Maps can't be deleted and keep a pointer to their name, so each size gets maps with names of
+// their own.  The names are kept short, as they are also used to name the maps' memory pools.
+static char Names[MAX_DECADES][3][NAME_BYTES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a start time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double NsSince
+(
+    le_clk_Time_t start
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return (elapsed.sec * 1000000000.0) + (elapsed.usec * 1000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Puts, gets and removes a number of keys in a map, and prints the time taken per operation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunMap
+(
+    const char* kindStr,
+    le_hashmap_Ref_t map,
+    int numEntries
+)
+{
+    int i;
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    for (i = 0; i < numEntries; i++)
+    {
+        le_hashmap_Put(map, &Keys[i], &Keys[i]);
+    }
+    double putNs = NsSince(start);
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < numEntries; i++)
+    {
+        LE_ASSERT(le_hashmap_Get(map, &Keys[i]) == &Keys[i]);
+    }
+    double getNs = NsSince(start);
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < numEntries; i++)
+    {
+        le_hashmap_Remove(map, &Keys[i]);
+    }
+    double removeNs = NsSince(start);
+
+    LE_ASSERT(le_hashmap_isEmpty(map));
+
+    printf("%10d %-16s %12.1f %12.1f %12.1f\n", numEntries, kindStr,
+           putNs / numEntries, getNs / numEntries, removeNs / numEntries);
+}
+
+
+COMPONENT_INIT
+{
+    int maxEntries = DEFAULT_MAX_ENTRIES;
+    int numEntries;
+    int decade = 0;
+    int i;
+
+    le_arg_SetIntVar(&maxEntries, "n", "entries");
+    le_arg_SetIntVar(&SmallCapacity, "c", "capacity");
+    le_arg_Scan();
+
+    // Spread the keys out, so that they don't all land in neighbouring buckets.
+    Keys = malloc(maxEntries * sizeof(uint32_t));
+    LE_ASSERT(Keys != NULL);
+    for (i = 0; i < maxEntries; i++)
+    {
+        Keys[i] = (uint32_t)i * 2654435761u;
+    }
+
+    printf("*** Performance test for le_hashmap module. ***\n");
+    printf("%10s %-16s %12s %12s %12s\n", "entries", "map", "put ns/op", "get ns/op",
+           "remove ns/op");
+
+    for (numEntries = 10;
+         (numEntries <= maxEntries) && (decade < MAX_DECADES);
+         numEntries *= 10, decade++)
+    {
+        char (*namePtr)[NAME_BYTES] = Names[decade];
+        le_hashmap_Ref_t map;
+
+        snprintf(namePtr[0], NAME_BYTES, "Sized%d", decade);
+        map = le_hashmap_Create(namePtr[0], numEntries,
+                                le_hashmap_HashUInt32, le_hashmap_EqualsUInt32);
+        RunMap("chained, sized", map, numEntries);
+
+        snprintf(namePtr[1], NAME_BYTES, "Chained%d", decade);
+        map = le_hashmap_Create(namePtr[1], SmallCapacity,
+                                le_hashmap_HashUInt32, le_hashmap_EqualsUInt32);
+        RunMap("chained, grown", map, numEntries);
+
+        snprintf(namePtr[2], NAME_BYTES, "Open%d", decade);
+        map = le_hashmap_CreateOpenAddressed(namePtr[2], SmallCapacity,
+                                             le_hashmap_HashUInt32, le_hashmap_EqualsUInt32);
+        RunMap("open, grown", map, numEntries);
+    }
+
+    free(Keys);
+
+    exit(EXIT_SUCCESS);
+}
@@ -21,6 +21,8 @@ size_t le_hashmap_HashCustom(const void* keyPtr);
 bool le_hashmap_EqualsCustom(const void* firstPtr, const void* secondPtr);
 bool itHandler(const void* keyPtr, const void* valuePtr, void* contextPtr);
 void TestIterRemove(le_hashmap_Ref_t map);
+void TestGrowWhileIterating(le_hashmap_Ref_t map);
+void TestAbandonedIterator(le_hashmap_Ref_t map);
 
 typedef struct Key Key_t;
 struct Key {
@@ -55,7 +57,20 @@ COMPONENT_INIT
     LE_INFO("Creating long int/long int map");
     le_hashmap_Ref_t map6 = le_hashmap_Create("Map6", 200, &le_hashmap_HashUInt64, &le_hashmap_EqualsUInt64);
 
+    LE_INFO("Creating open-addressed int/int and string/string maps");
+    le_hashmap_Ref_t map7 = le_hashmap_CreateOpenAddressed("Map7", 8, &le_hashmap_HashUInt32,
+                                                           &le_hashmap_EqualsUInt32);
+    le_hashmap_Ref_t map8 = le_hashmap_CreateOpenAddressed("Map8", 8, &le_hashmap_HashString,
+                                                           &le_hashmap_EqualsString);
+
+    LE_INFO("Creating small maps to grow while iterating");
+    le_hashmap_Ref_t map9 = le_hashmap_Create("Map9", 8, &le_hashmap_HashUInt32,
+                                              &le_hashmap_EqualsUInt32);
+    le_hashmap_Ref_t map10 = le_hashmap_CreateOpenAddressed("Map10", 8, &le_hashmap_HashUInt32,
+                                                            &le_hashmap_EqualsUInt32);
+
     LE_TEST(map1 && map2 && map3 && map4 && map5 && map6);
+    LE_TEST(map7 && map8 && map9 && map10);
 
     TestHashFns();
     TestIntHashMap(map1);
@@ -66,6 +81,13 @@ COMPONENT_INIT
     TestLongIntHashMap(map6);
     TestNewIter();
     TestIterRemove(map1);
+    TestIntHashMap(map7);
+    TestStringHashMap(map8);
+    TestIterRemove(map7);
+    TestGrowWhileIterating(map9);
+    TestGrowWhileIterating(map10);
+    TestAbandonedIterator(map9);
+    TestAbandonedIterator(map10);
 
     LE_INFO("==== Hashmap Tests PASSED ====\n");
 
@@ -135,7 +157,7 @@ void TestIntHashMap(le_hashmap_Ref_t map)
         le_hashmap_GetValue(mapIt);
     }
     LE_INFO("Iterator count = %d", itercnt);
-    LE_TEST(itercnt == -1);
+    LE_TEST(itercnt == 0);
 
     // Cleanup the map again to allow it to be reused
     le_hashmap_RemoveAll(map);
@@ -453,6 +475,82 @@ void TestIterRemove(le_hashmap_Ref_t map)
     LE_TEST(le_hashmap_Size(map) == 500);
 }
 
+void TestGrowWhileIterating(le_hashmap_Ref_t map)
+{
+    uint32_t iKeys[200];
+    uint32_t iVals[200];
+    int seen[100] = { 0 };
+    int j = 0;
+
+    LE_INFO("*** Running grow while iterating tests ***");
+
+    for (j=0; j<100; j++) {
+        iKeys[j] = j;
+        iVals[j] = j * 2;
+        le_hashmap_Put(map, &iKeys[j], &iVals[j]);
+    }
+    LE_TEST(le_hashmap_Size(map) == 100);
+
+    // Add a new key for each of the original keys visited, which makes the map grow.  None of the
+    // original keys may be skipped or visited twice.
+    int added = 100;
+    le_hashmap_It_Ref_t mapIt = le_hashmap_GetIterator(map);
+    while (le_hashmap_NextNode(mapIt) == LE_OK)
+    {
+        const uint32_t* keyPtr = le_hashmap_GetKey(mapIt);
+        const uint32_t* valuePtr = le_hashmap_GetValue(mapIt);
+
+        LE_ASSERT(*valuePtr == (*keyPtr * 2));
+
+        if (*keyPtr < 100)
+        {
+            seen[*keyPtr]++;
+
+            iKeys[added] = 1000 + added;
+            iVals[added] = iKeys[added] * 2;
+            le_hashmap_Put(map, &iKeys[added], &iVals[added]);
+            added++;
+        }
+    }
+    LE_TEST(added == 200);
+    LE_TEST(le_hashmap_Size(map) == 200);
+
+    bool seenOnce = true;
+    for (j=0; j<100; j++) {
+        seenOnce = seenOnce && (seen[j] == 1);
+    }
+    LE_TEST(seenOnce);
+
+    // Keep putting entries now that the iteration is over, so the map finishes growing.
+    for (j=0; j<200; j++) {
+        le_hashmap_Put(map, &iKeys[j], &iVals[j]);
+    }
+
+    bool allFound = true;
+    for (j=0; j<200; j++) {
+        const uint32_t* valuePtr = le_hashmap_Get(map, &iKeys[j]);
+        allFound = allFound && (valuePtr == &iVals[j]);
+    }
+    LE_TEST(allFound);
+
+    // Walk both ways over the grown map.
+    int itercnt = 0;
+    mapIt = le_hashmap_GetIterator(map);
+    while (le_hashmap_NextNode(mapIt) == LE_OK)
+    {
+        itercnt++;
+    }
+    LE_TEST(itercnt == 200);
+    while (le_hashmap_PrevNode(mapIt) == LE_OK)
+    {
+        itercnt--;
+    }
+    LE_TEST(itercnt == 0);
+
+    le_hashmap_RemoveAll(map);
+    LE_TEST(le_hashmap_isEmpty(map));
+}
+
 void TestLongIntHashMap(le_hashmap_Ref_t map)
 {
     uint64_t ikey1 = 1412320402000;
@@ -526,3 +624,50 @@ void TestLongIntHashMap(le_hashmap_Ref_t map)
     mapIt = le_hashmap_GetIterator(map);
     LE_TEST(le_hashmap_NextNode(mapIt) == LE_NOT_FOUND);
 }
+
+void TestAbandonedIterator(le_hashmap_Ref_t map)
+{
+    static uint32_t iKeys[2000];
+    static uint32_t iVals[2000];
+    int j = 0;
+
+    LE_INFO("*** Running abandoned iterator tests ***");
+
+    for (j=0; j<100; j++) {
+        iKeys[j] = j;
+        iVals[j] = j * 2;
+        le_hashmap_Put(map, &iKeys[j], &iVals[j]);
+    }
+
+    // Leave the iterator on an entry, which holds up growing the map, and keep putting entries.
+    // The map must still grow once it has outgrown its table, invalidating the iterator.
+    le_hashmap_It_Ref_t mapIt = le_hashmap_GetIterator(map);
+    LE_TEST(le_hashmap_NextNode(mapIt) == LE_OK);
+
+    for (j=100; j<2000; j++) {
+        iKeys[j] = j;
+        iVals[j] = j * 2;
+        le_hashmap_Put(map, &iKeys[j], &iVals[j]);
+    }
+    LE_TEST(le_hashmap_Size(map) == 2000);
+    LE_TEST(le_hashmap_NextNode(mapIt) == LE_NOT_FOUND);
+    LE_TEST(le_hashmap_CountCollisions(map) < le_hashmap_Size(map) / 2);
+
+    bool allFound = true;
+    for (j=0; j<2000; j++) {
+        const uint32_t* valuePtr = le_hashmap_Get(map, &iKeys[j]);
+        allFound = allFound && (valuePtr == &iVals[j]);
+    }
+    LE_TEST(allFound);
+
+    int itercnt = 0;
+    mapIt = le_hashmap_GetIterator(map);
+    while (le_hashmap_NextNode(mapIt) == LE_OK)
+    {
+        itercnt++;
+    }
+    LE_TEST(itercnt == 2000);
+
+    le_hashmap_RemoveAll(map);
+    LE_TEST(le_hashmap_isEmpty(map));
+}
@@ -0,0 +1,211 @@
+ /**
+  * Micro-benchmark for the le_json module.
+  *
+  * Builds a JSON document of a few megabytes and measures how long it takes to parse it from
+  * memory (le_json_ParseBuffer()), from a file, and from a pipe that is fed by another thread
+  * (le_json_Parse()).
+  *
+  * Usage: testFwJsonPerf [-k DOC_SIZE_KIB]
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#include "legato.h"
+#include "fileDescriptor.h"
+
+#define DEFAULT_DOC_KIB     4096
+
+static char* DocPtr;
+static size_t DocSize;
+static size_t EventCount;
+static int PipeWriteFd;
+static le_clk_Time_t StartTime;
+static int TestIndex;
+
+static void StartTest(void);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Builds a document of objects with string, number and literal members, like an update pack
+ * header or a config tree export, until it is at least a given size.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildDoc
+(
+    size_t minSize
+)
+{
+    size_t maxSize = minSize + 1024;
+    int i = 0;
+
+    DocPtr = malloc(maxSize);
+    LE_ASSERT(DocPtr != NULL);
+
+    DocSize = snprintf(DocPtr, maxSize, "[\n");
+    while (DocSize < minSize)
+    {
+        DocSize += snprintf(DocPtr + DocSize, maxSize - DocSize,
+                            "  {\n    \"name\": \"/legato/systems/current/apps/app%d/read-only\",\n"
+                            "    \"md5\": \"0123456789abcdef0123456789abcdef\",\n"
+                            "    \"size\": %d,\n    \"enabled\": %s,\n    \"extra\": null\n  },\n",
+                            i, i * 37, (i % 2) ? "true" : "false");
+        i++;
+    }
+    DocSize += snprintf(DocPtr + DocSize, maxSize - DocSize, "  {}\n]");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counts the parsing events.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountingHandler
+(
+    le_json_Event_t event
+)
+{
+    EventCount++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reports parsing errors, which shouldn't happen.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ErrorHandler
+(
+    le_json_Error_t error,
+    const char* msg
+)
+{
+    LE_FATAL("JSON parsing error %d: %s", error, msg);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the time taken since StartTime to parse the document.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintResult
+(
+    const char* sourceStr
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), StartTime);
+    double secs = elapsed.sec + (elapsed.usec / 1000000.0);
+
+    printf("%-8s %12zu %10.1f %10.1f\n", sourceStr, EventCount, secs * 1000.0,
+           (DocSize / (1024.0 * 1024.0)) / secs);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread that feeds the document into a pipe.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* PipeWriterThread
+(
+    void* contextPtr
+)
+{
+    LE_ASSERT(fd_WriteSize(PipeWriteFd, DocPtr, DocSize) == (ssize_t)DocSize);
+    fd_Close(PipeWriteFd);
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles the parsing events from a file descriptor, and starts the next test at the end of the
+ * document.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FdHandler
+(
+    le_json_Event_t event
+)
+{
+    EventCount++;
+
+    if (event == LE_JSON_DOC_END)
+    {
+        PrintResult((TestIndex == 0) ? "file" : "pipe");
+
+        le_json_Cleanup(le_json_GetSession());
+
+        TestIndex++;
+        StartTest();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts parsing the document from the next source, or exits if all have been done.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartTest
+(
+    void
+)
+{
+    int fd;
+
+    if (TestIndex == 0)
+    {
+        char path[] = "/tmp/jsonPerfXXXXXX";
+        fd = mkstemp(path);
+        LE_ASSERT(fd >= 0);
+        unlink(path);
+        LE_ASSERT(fd_WriteSize(fd, DocPtr, DocSize) == (ssize_t)DocSize);
+        LE_ASSERT(lseek(fd, 0, SEEK_SET) == 0);
+    }
+    else if (TestIndex == 1)
+    {
+        int fds[2];
+        LE_ASSERT(pipe(fds) == 0);
+        fd = fds[0];
+        PipeWriteFd = fds[1];
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        le_thread_Start(le_thread_Create("jsonPerfWriter", PipeWriterThread, NULL));
+    }
+    else
+    {
+        free(DocPtr);
+        exit(EXIT_SUCCESS);
+    }
+
+    EventCount = 0;
+    StartTime = le_clk_GetRelativeTime();
+    le_json_Parse(fd, FdHandler, ErrorHandler, NULL);
+}
+
+
+COMPONENT_INIT
+{
+    int docKib = DEFAULT_DOC_KIB;
+
+    le_arg_SetIntVar(&docKib, "k", "kib");
+    le_arg_Scan();
+
+    BuildDoc((size_t)docKib * 1024);
+
+    printf("*** Performance test for le_json module. ***\n");
+    printf("Document size: %zu bytes\n", DocSize);
+    printf("%-8s %12s %10s %10s\n", "source", "events", "ms", "MiB/s");
+
+    EventCount = 0;
+    StartTime = le_clk_GetRelativeTime();
+    LE_ASSERT_OK(le_json_ParseBuffer(DocPtr, DocSize, CountingHandler, ErrorHandler, NULL));
+    PrintResult("memory");
+
+    // The fd tests run from the event loop.
+    TestIndex = 0;
+    StartTest();
+}
@@ -0,0 +1,363 @@
+ /**
+  * This module is for unit testing the le_json module in the legato runtime library.
+  *
+  * The same document is parsed from memory, a pipe, a socket and a file.  Every parse must report
+  * the same events, and must leave whatever follows the document in the file descriptor.
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#include "legato.h"
+#include "fileDescriptor.h"
+#include <sys/socket.h>
+
+/// Number of items in the test document.  Enough to span several of the parser's read blocks.
+#define NUM_ITEMS 2000
+
+/// What follows the document in the file descriptor.
+static const char Payload[] = "PAYLOAD";
+
+static char* DocPtr;
+static size_t DocSize;
+
+/// Digest of the events reported while parsing the document from memory.
+static uint32_t ExpectedDigest;
+
+/// Digest of the events reported so far by the current parse.
+static uint32_t Digest;
+
+/// Number of item names seen so far by the current parse.
+static int NameCount;
+
+/// Set when the current parse has reported the end of the document.
+static bool IsDocEnded;
+static size_t DocEndBytesRead;
+
+/// File descriptor that the current parse reads from, and the other end of it (or -1).
+static int ReadFd;
+static int WriteFd;
+
+/// Names of the file descriptor tests, in the order they are run.
+static const char* FdTestNames[] = { "pipe", "socket", "file" };
+static int FdTestIndex;
+
+static void StartFdTest(void);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mixes some bytes into the event digest.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddToDigest
+(
+    const void* bytesPtr,
+    size_t numBytes
+)
+{
+    const uint8_t* bytePtr = bytesPtr;
+    size_t i;
+
+    for (i = 0; i < numBytes; i++)
+    {
+        Digest = (Digest ^ bytePtr[i]) * 16777619u;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Builds the test document.  Item names contain escaped characters, so that escape sequences
+ * straddle the parser's read blocks somewhere.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildDoc
+(
+    void
+)
+{
+    size_t maxSize = NUM_ITEMS * 128;
+    int i;
+
+    DocPtr = malloc(maxSize);
+    LE_ASSERT(DocPtr != NULL);
+
+    DocSize = snprintf(DocPtr, maxSize, "{\n  \"items\" : [\n");
+    for (i = 0; i < NUM_ITEMS; i++)
+    {
+        DocSize += snprintf(DocPtr + DocSize, maxSize - DocSize,
+                            "    { \"name\": \"item\\\"%d\\\\\", \"value\": %d.5, \"ok\": %s,"
+                            " \"none\": null }%s\n",
+                            i, -i, (i % 2) ? "true" : "false", (i < NUM_ITEMS - 1) ? "," : "");
+    }
+    DocSize += snprintf(DocPtr + DocSize, maxSize - DocSize, "  ]\n}");
+    LE_ASSERT(DocSize < maxSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler for all parses of the test document.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EventHandler
+(
+    le_json_Event_t event
+)
+{
+    AddToDigest(&event, sizeof(event));
+
+    switch (event)
+    {
+        case LE_JSON_OBJECT_MEMBER:
+        case LE_JSON_STRING:
+        {
+            const char* str = le_json_GetString();
+            AddToDigest(str, strlen(str));
+
+            if ((event == LE_JSON_STRING) && (strncmp(str, "item", 4) == 0))
+            {
+                // Escape sequences are passed on as they are.
+                char expected[32];
+                snprintf(expected, sizeof(expected), "item\\\"%d\\\\", NameCount);
+                LE_ASSERT(strcmp(str, expected) == 0);
+                NameCount++;
+            }
+            break;
+        }
+
+        case LE_JSON_NUMBER:
+        {
+            double number = le_json_GetNumber();
+            AddToDigest(&number, sizeof(number));
+            break;
+        }
+
+        case LE_JSON_DOC_END:
+
+            IsDocEnded = true;
+            DocEndBytesRead = le_json_GetBytesRead(le_json_GetSession());
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler that stops parsing at the first object member.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StoppingEventHandler
+(
+    le_json_Event_t event
+)
+{
+    if (event == LE_JSON_OBJECT_MEMBER)
+    {
+        NameCount++;
+        le_json_Cleanup(le_json_GetSession());
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Error handler for parses that are expected to succeed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ErrorHandler
+(
+    le_json_Error_t error,
+    const char* msg
+)
+{
+    LE_FATAL("Unexpected JSON parsing error %d: %s", error, msg);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Error handler for parses that are expected to fail.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ExpectedErrorHandler
+(
+    le_json_Error_t error,
+    const char* msg
+)
+{
+    LE_INFO("Got expected error %d: %s", error, msg);
+    *(le_json_Error_t*)le_json_GetOpaquePtr() = error;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the document and the payload to a file descriptor, then closes it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteAll
+(
+    int fd
+)
+{
+    LE_ASSERT(fd_WriteSize(fd, DocPtr, DocSize) == (ssize_t)DocSize);
+    LE_ASSERT(fd_WriteSize(fd, (void*)Payload, sizeof(Payload)) == sizeof(Payload));
+    fd_Close(fd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread that feeds a pipe or socket, which wouldn't hold the whole document at once.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WriterThread
+(
+    void* contextPtr
+)
+{
+    WriteAll(WriteFd);
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler that is used for parses from a file descriptor.  Checks what the parser reported
+ * and what it left behind in the file descriptor, then starts the next test.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FdEventHandler
+(
+    le_json_Event_t event
+)
+{
+    EventHandler(event);
+
+    if (event != LE_JSON_DOC_END)
+    {
+        return;
+    }
+
+    LE_INFO("Parsed document from a %s.", FdTestNames[FdTestIndex]);
+
+    LE_ASSERT(Digest == ExpectedDigest);
+    LE_ASSERT(NameCount == NUM_ITEMS);
+    LE_ASSERT(le_json_GetBytesRead(le_json_GetSession()) == DocSize);
+
+    le_json_Cleanup(le_json_GetSession());
+
+    // Whatever followed the document must still be there.
+    char buffer[sizeof(Payload) + 1];
+    int flags = fcntl(ReadFd, F_GETFL);
+    LE_ASSERT(fcntl(ReadFd, F_SETFL, flags & ~O_NONBLOCK) == 0);
+    LE_ASSERT(fd_ReadSize(ReadFd, buffer, sizeof(buffer)) == sizeof(Payload));
+    LE_ASSERT(memcmp(buffer, Payload, sizeof(Payload)) == 0);
+    fd_Close(ReadFd);
+
+    FdTestIndex++;
+    StartFdTest();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts parsing the document from the next type of file descriptor, or ends the test if they
+ * have all been done.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartFdTest
+(
+    void
+)
+{
+    int fds[2];
+
+    if (FdTestIndex >= (int)NUM_ARRAY_MEMBERS(FdTestNames))
+    {
+        LE_INFO("======== JSON TEST COMPLETE (PASSED) ========");
+        exit(EXIT_SUCCESS);
+    }
+
+    if (strcmp(FdTestNames[FdTestIndex], "file") == 0)
+    {
+        char path[] = "/tmp/jsonTestXXXXXX";
+        ReadFd = mkstemp(path);
+        LE_ASSERT(ReadFd >= 0);
+        unlink(path);
+        WriteAll(dup(ReadFd));
+        LE_ASSERT(lseek(ReadFd, 0, SEEK_SET) == 0);
+    }
+    else
+    {
+        if (strcmp(FdTestNames[FdTestIndex], "pipe") == 0)
+        {
+            LE_ASSERT(pipe(fds) == 0);
+        }
+        else
+        {
+            LE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        }
+        ReadFd = fds[0];
+        WriteFd = fds[1];
+        fcntl(ReadFd, F_SETFL, fcntl(ReadFd, F_GETFL) | O_NONBLOCK);
+
+        le_thread_Start(le_thread_Create("jsonWriter", WriterThread, NULL));
+    }
+
+    Digest = 2166136261u;
+    NameCount = 0;
+    le_json_Parse(ReadFd, FdEventHandler, ErrorHandler, NULL);
+}
+
+
+COMPONENT_INIT
+{
+    LE_INFO("======== BEGIN JSON TEST ========");
+
+    BuildDoc();
+
+    LE_INFO("Parsing document from memory.");
+
+    Digest = 2166136261u;
+    NameCount = 0;
+    LE_ASSERT_OK(le_json_ParseBuffer(DocPtr, DocSize, EventHandler, ErrorHandler, NULL));
+    LE_ASSERT(IsDocEnded);
+    LE_ASSERT(NameCount == NUM_ITEMS);
+    LE_ASSERT(DocEndBytesRead == DocSize);
+    ExpectedDigest = Digest;
+
+    LE_INFO("Parsing truncated document from memory.");
+
+    le_json_Error_t error = -1;
+    IsDocEnded = false;
+    NameCount = 0;
+    LE_ASSERT(le_json_ParseBuffer(DocPtr, DocSize - 1, EventHandler, ExpectedErrorHandler, &error)
+              == LE_FAULT);
+    LE_ASSERT(error == LE_JSON_READ_ERROR);
+    LE_ASSERT(!IsDocEnded);
+
+    LE_INFO("Parsing document with an unterminated string from memory.");
+
+    static const char badDoc[] = "{ \"a\": \"b\\\" }";
+    error = -1;
+    LE_ASSERT(le_json_ParseBuffer(badDoc, sizeof(badDoc) - 1, EventHandler, ExpectedErrorHandler,
+                                  &error) == LE_FAULT);
+    LE_ASSERT(error == LE_JSON_READ_ERROR);
+
+    LE_INFO("Stopping the parsing of a document from memory early.");
+
+    NameCount = 0;
+    LE_ASSERT(le_json_ParseBuffer(DocPtr, DocSize, StoppingEventHandler, ErrorHandler, NULL)
+              == LE_FAULT);
+    LE_ASSERT(NameCount == 1);
+
+    // The rest of the tests run from the event loop.
+    FdTestIndex = 0;
+    StartFdTest();
+}
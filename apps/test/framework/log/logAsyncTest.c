@@ -0,0 +1,162 @@
+ /**
+  * Test of asynchronous logging with strings that don't outlive the log call.
+  *
+  * Logs messages whose file name, function name, format and string argument are all in heap
+  * buffers that are overwritten and freed as soon as the call returns, like the Java binding does,
+  * then checks that the messages are written out intact once the ring is flushed.  Also checks
+  * that file and function names that are too long for a record are truncated.
+  *
+  * On a PC, the log output goes to standard error, which is redirected to a temporary file.
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#include "legato.h"
+#include "log.h"
+
+#define NUM_MESSAGES    100
+#define LONG_NAME_LEN   200
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a string into a new heap buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static char* HeapString
+(
+    const char* strPtr
+)
+{
+    char* copyPtr = strdup(strPtr);
+
+    LE_ASSERT(copyPtr != NULL);
+
+    return copyPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Overwrite and free a heap string, so that reading it later can't go unnoticed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FreeString
+(
+    char* strPtr
+)
+{
+    memset(strPtr, 'x', strlen(strPtr));
+    free(strPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log a message through heap strings that are freed as soon as it is queued.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogThroughHeap
+(
+    const char* fileNamePtr,
+    const char* functionNamePtr,
+    int i
+)
+{
+    char text[64];
+
+    snprintf(text, sizeof(text), "message %d", i);
+
+    char* filePtr = HeapString(fileNamePtr);
+    char* functionPtr = HeapString(functionNamePtr);
+    char* formatPtr = HeapString("Heap format: %s, %d.");
+    char* textPtr = HeapString(text);
+
+    _le_log_Send(LE_LOG_INFO, NULL, LE_LOG_SESSION, filePtr, functionPtr, i, formatPtr, textPtr,
+                 i * 2);
+
+    FreeString(filePtr);
+    FreeString(functionPtr);
+    FreeString(formatPtr);
+    FreeString(textPtr);
+}
+
+
+COMPONENT_INIT
+{
+#ifdef LEGATO_EMBEDDED
+
+    LE_INFO("The log output can only be checked on a PC.");
+
+#else
+
+    char path[] = "/tmp/logAsyncTestXXXXXX";
+    char fileName[64];
+    char functionName[64];
+    char longName[LONG_NAME_LEN + 1];
+    char expected[512];
+    int i;
+
+    // Make sure the messages aren't filtered out.
+    le_log_SetFilterLevel(LE_LOG_INFO);
+
+    int fd = mkstemp(path);
+    LE_ASSERT(fd != -1);
+    LE_ASSERT(unlink(path) == 0);
+
+    int stderrFd = dup(STDERR_FILENO);
+    LE_ASSERT(stderrFd != -1);
+    LE_ASSERT(dup2(fd, STDERR_FILENO) == STDERR_FILENO);
+
+    log_SetAsync(true);
+
+    for (i = 0; i < NUM_MESSAGES; i++)
+    {
+        snprintf(fileName, sizeof(fileName), "some/dir/heapFile%d.c", i);
+        snprintf(functionName, sizeof(functionName), "HeapFunction%d", i);
+        LogThroughHeap(fileName, functionName, i);
+    }
+
+    memset(longName, 'f', LONG_NAME_LEN);
+    longName[LONG_NAME_LEN] = '\0';
+    LogThroughHeap(longName, longName, NUM_MESSAGES);
+
+    // Flush the ring, then put standard error back.
+    log_SetAsync(false);
+
+    LE_ASSERT(dup2(stderrFd, STDERR_FILENO) == STDERR_FILENO);
+    close(stderrFd);
+
+    // Read back what was logged.
+    off_t size = lseek(fd, 0, SEEK_END);
+    LE_ASSERT(size > 0);
+
+    char* logPtr = malloc(size + 1);
+    LE_ASSERT(logPtr != NULL);
+    LE_ASSERT(pread(fd, logPtr, size, 0) == size);
+    logPtr[size] = '\0';
+    close(fd);
+
+    LE_ASSERT(log_GetDroppedCount() == 0);
+
+    for (i = 0; i < NUM_MESSAGES; i++)
+    {
+        snprintf(expected, sizeof(expected), "heapFile%d.c HeapFunction%d() %d | "
+                 "Heap format: message %d, %d.\n", i, i, i, i, i * 2);
+        LE_FATAL_IF(strstr(logPtr, expected) == NULL, "'%s' not logged", expected);
+    }
+
+    // The names are cut short at a character boundary, but the message is intact.
+    longName[63] = '\0';
+    snprintf(expected, sizeof(expected), "| %s %s() %d | Heap format: message %d, %d.\n",
+             longName, longName, NUM_MESSAGES, NUM_MESSAGES, NUM_MESSAGES * 2);
+    LE_FATAL_IF(strstr(logPtr, expected) == NULL, "'%s' not logged", expected);
+
+    free(logPtr);
+
+#endif
+
+    LE_INFO("==== Asynchronous logging test PASSED ====");
+
+    exit(EXIT_SUCCESS);
+}
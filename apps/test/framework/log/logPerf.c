@@ -0,0 +1,135 @@
+ /**
+  * Micro-benchmark for the cost of logging to the calling thread.
+  *
+  * Logs a burst of messages, first synchronously and then asynchronously (see LE_LOG_ASYNC), and
+  * reports the number of log calls per second, the median, 99th percentile and worst-case time
+  * spent in each call, and the number of messages dropped by asynchronous logging.
+  *
+  * On a PC, the log output goes to standard error, which is redirected to /dev/null so that the
+  * terminal doesn't dominate the results.
+  *
+  * Usage: testFwLogPerf [-n MESSAGES] [-d DELAY_US]
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#include "legato.h"
+#include "log.h"
+
+#define DEFAULT_NUM_MESSAGES 100000
+
+static int NumMessages = DEFAULT_NUM_MESSAGES;
+static int DelayUs = 0;
+
+static uint32_t* LatenciesNs;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the monotonic clock, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t NowNs
+(
+    void
+)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare two latencies, for qsort().
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareLatencies
+(
+    const void* aPtr,
+    const void* bPtr
+)
+{
+    uint32_t a = *(const uint32_t*)aPtr;
+    uint32_t b = *(const uint32_t*)bPtr;
+
+    return (a > b) - (a < b);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log a burst of messages in the current logging mode and print the results.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunTest
+(
+    const char* name,
+    bool isAsync
+)
+{
+    uint32_t droppedBefore = log_GetDroppedCount();
+    uint64_t startNs;
+    uint64_t totalNs = 0;
+    int i;
+
+    log_SetAsync(isAsync);
+
+    for (i = 0; i < NumMessages; i++)
+    {
+        startNs = NowNs();
+        LE_INFO("Message %d of %d from %s, value %.2f.", i, NumMessages, name, i * 0.5);
+        LatenciesNs[i] = NowNs() - startNs;
+        totalNs += LatenciesNs[i];
+
+        if (DelayUs > 0)
+        {
+            usleep(DelayUs);
+        }
+    }
+
+    // Flush whatever is still waiting to be written out before the next test.
+    log_SetAsync(false);
+
+    qsort(LatenciesNs, NumMessages, sizeof(LatenciesNs[0]), CompareLatencies);
+
+    printf("%-8s %12.0f %10" PRIu32 " %10" PRIu32 " %10" PRIu32 " %10" PRIu32 "\n",
+           name,
+           NumMessages / (totalNs / 1000000000.0),
+           LatenciesNs[NumMessages / 2],
+           LatenciesNs[(NumMessages * 99) / 100],
+           LatenciesNs[NumMessages - 1],
+           log_GetDroppedCount() - droppedBefore);
+}
+
+
+COMPONENT_INIT
+{
+    le_arg_SetIntVar(&NumMessages, "n", "messages");
+    le_arg_SetIntVar(&DelayUs, "d", "delay");
+    le_arg_Scan();
+
+    LE_ASSERT(NumMessages > 0);
+
+    LatenciesNs = calloc(NumMessages, sizeof(LatenciesNs[0]));
+    LE_ASSERT(LatenciesNs != NULL);
+
+    // Make sure the messages aren't filtered out.
+    le_log_SetFilterLevel(LE_LOG_INFO);
+
+#ifndef LEGATO_EMBEDDED
+    LE_ASSERT(freopen("/dev/null", "w", stderr) != NULL);
+#endif
+
+    printf("*** Performance test for logging. ***\n");
+    printf("%-8s %12s %10s %10s %10s %10s\n", "mode", "calls/s", "p50 ns", "p99 ns", "max ns",
+           "dropped");
+
+    RunTest("sync", false);
+    RunTest("async", true);
+
+    exit(EXIT_SUCCESS);
+}
@@ -511,6 +511,31 @@ COMPONENT_INIT
 
     printf("Successfully recreated sub-pool.\n");
 
+    //
+    // Enable checks on a pool and make sure its objects are still usable.
+    //
+    {
+        le_mem_PoolRef_t checkedPool = le_mem_CreatePool("Checked Pool", sizeof(idObj_t));
+        le_mem_EnableChecks(checkedPool);
+        le_mem_ExpandPool(checkedPool, 2);
+
+        idObj_t* objPtr = le_mem_ForceAlloc(checkedPool);
+        objPtr->id = 42;
+        le_mem_AddRef(objPtr);
+        le_mem_Release(objPtr);
+
+        if ( (objPtr->id != 42) ||
+             (le_mem_GetObjectFullSize(checkedPool) < le_mem_GetObjectFullSize(idPool)) )
+        {
+            printf("Error in checked pool: %d", __LINE__);
+            exit(EXIT_FAILURE);
+        }
+
+        le_mem_Release(objPtr);
+    }
+
+    printf("Checked pool works correctly.\n");
+
     // FIXME: Find pool by name is currently suffering from issues
     // Failure is tracked by ticket LE-5909
 #if 0
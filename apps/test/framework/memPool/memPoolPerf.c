@@ -0,0 +1,154 @@
+ /**
+  * Micro-benchmark for the le_mem module.
+  *
+  * Measures the throughput of le_mem_ForceAlloc()/le_mem_Release() pairs on a single shared pool
+  * while the number of threads hammering it is increased from 1 to N, and the throughput of
+  * le_mem_AddRef()/le_mem_Release() pairs on a single shared object.
+  *
+  * Usage: testFwMemPoolPerf [-t MAX_THREADS] [-n ITERATIONS_PER_THREAD]
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#include "legato.h"
+
+#define DEFAULT_MAX_THREADS     4
+#define DEFAULT_ITERATIONS      1000000
+#define BLOCKS_PER_ITERATION    8
+#define OBJECT_SIZE             64
+
+static le_mem_PoolRef_t Pool;
+static void* SharedObjPtr;
+static int Iterations = DEFAULT_ITERATIONS;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread that allocates and releases a small burst of blocks over and over.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* AllocReleaseThread
+(
+    void* contextPtr
+)
+{
+    void* blockPtr[BLOCKS_PER_ITERATION];
+    int i, j;
+
+    for (i = 0; i < Iterations; i++)
+    {
+        for (j = 0; j < BLOCKS_PER_ITERATION; j++)
+        {
+            blockPtr[j] = le_mem_ForceAlloc(Pool);
+        }
+
+        for (j = 0; j < BLOCKS_PER_ITERATION; j++)
+        {
+            le_mem_Release(blockPtr[j]);
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread that adds and releases references to a shared object over and over.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* RefCountThread
+(
+    void* contextPtr
+)
+{
+    int i;
+
+    for (i = 0; i < Iterations * BLOCKS_PER_ITERATION; i++)
+    {
+        le_mem_AddRef(SharedObjPtr);
+        le_mem_Release(SharedObjPtr);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs a thread function on a number of threads at once and returns the elapsed time in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double RunThreads
+(
+    le_thread_MainFunc_t mainFunc,
+    int numThreads
+)
+{
+    le_thread_Ref_t threads[numThreads];
+    char name[32];
+    int i;
+
+    for (i = 0; i < numThreads; i++)
+    {
+        snprintf(name, sizeof(name), "perf%d", i);
+        threads[i] = le_thread_Create(name, mainFunc, NULL);
+        le_thread_SetJoinable(threads[i]);
+    }
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < numThreads; i++)
+    {
+        le_thread_Start(threads[i]);
+    }
+
+    for (i = 0; i < numThreads; i++)
+    {
+        LE_ASSERT(le_thread_Join(threads[i], NULL) == LE_OK);
+    }
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return elapsed.sec + (elapsed.usec / 1000000.0);
+}
+
+
+COMPONENT_INIT
+{
+    int maxThreads = DEFAULT_MAX_THREADS;
+    int numThreads;
+
+    le_arg_SetIntVar(&maxThreads, "t", "threads");
+    le_arg_SetIntVar(&Iterations, "n", "iterations");
+    le_arg_Scan();
+
+    Pool = le_mem_CreatePool("PerfPool", OBJECT_SIZE);
+    le_mem_ExpandPool(Pool, maxThreads * BLOCKS_PER_ITERATION);
+    le_mem_SetNumObjsToForce(Pool, BLOCKS_PER_ITERATION);
+
+    SharedObjPtr = le_mem_ForceAlloc(Pool);
+
+    printf("*** Performance test for le_mem module. ***\n");
+    printf("%8s %20s %20s\n", "threads", "alloc+release/s", "addref+release/s");
+
+    for (numThreads = 1; numThreads <= maxThreads; numThreads++)
+    {
+        double totalOps = (double)numThreads * Iterations * BLOCKS_PER_ITERATION;
+
+        double allocSecs = RunThreads(AllocReleaseThread, numThreads);
+        double refSecs = RunThreads(RefCountThread, numThreads);
+
+        printf("%8d %20.0f %20.0f\n", numThreads, totalOps / allocSecs, totalOps / refSecs);
+    }
+
+    le_mem_Release(SharedObjPtr);
+
+    le_mem_PoolStats_t stats;
+    le_mem_GetStats(Pool, &stats);
+    LE_ASSERT(stats.numBlocksInUse == 0);
+
+    printf("Pool grew to %zu blocks.\n", le_mem_GetObjectCount(Pool));
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,259 @@
+ /**
+  * Micro-benchmark for the Low-Level Messaging APIs.
+  *
+  * Runs a server thread and a client thread in the same process, and measures the round trip
+  * latency of synchronous request-response transactions and the throughput of a stream of
+  * one-way messages.  Each test is done with small and with maximum-size messages, first
+  * through the session's socket and then through the shared memory transport.
+  *
+  * Needs the bindings set up by testFwMessaging-Setup.
+  *
+  * Usage: testFwMessagingPerf [-n MESSAGES] [-s MAX_SIZE]
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#include "legato.h"
+
+#define DEFAULT_NUM_MESSAGES 100000
+#define DEFAULT_MAX_SIZE 4096
+
+#define SMALL_SIZE 16
+
+static int NumMessages = DEFAULT_NUM_MESSAGES;
+static int MaxSize = DEFAULT_MAX_SIZE;
+
+static le_sem_Ref_t ServerReadySem;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * One combination of transport and message size.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* name;           ///< Name of the service instance (and of the test).
+    bool        isSmall;        ///< true = SMALL_SIZE messages, false = MaxSize messages.
+    bool        useSharedMem;   ///< true = shared memory transport, false = socket only.
+    bool        isSized;        ///< true = SMALL_SIZE messages on the MaxSize protocol.
+}
+PerfTest_t;
+
+static const PerfTest_t Tests[] =
+{
+    { "MessagingPerfSocketSmall",   true,   false,  false },
+    { "MessagingPerfSocketMax",     false,  false,  false },
+    { "MessagingPerfSocketSized",   false,  false,  true  },
+    { "MessagingPerfShmSmall",      true,   true,   false },
+    { "MessagingPerfShmMax",        false,  true,   false },
+    { "MessagingPerfShmSized",      false,  true,   true  },
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the protocol used by a given test.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_ProtocolRef_t GetProtocol
+(
+    const PerfTest_t* testPtr
+)
+{
+    if (testPtr->isSmall)
+    {
+        return le_msg_GetProtocolRef("MessagingPerfSmall", SMALL_SIZE);
+    }
+
+    return le_msg_GetProtocolRef("MessagingPerfMax", MaxSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a message for a given test.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_MessageRef_t CreateMsg
+(
+    const PerfTest_t*   testPtr,
+    le_msg_SessionRef_t sessionRef
+)
+{
+    if (testPtr->isSized)
+    {
+        return le_msg_CreateSizedMsg(sessionRef, SMALL_SIZE);
+    }
+
+    return le_msg_CreateMsg(sessionRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the elapsed time since a given start time, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double ElapsedSecs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return elapsed.sec + (elapsed.usec / 1000000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server-side receive handler.  Sends requests straight back as their own responses.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ServerRecvHandler
+(
+    le_msg_MessageRef_t msgRef,
+    void*               contextPtr
+)
+{
+    if (le_msg_NeedsResponse(msgRef))
+    {
+        le_msg_Respond(msgRef);
+    }
+    else
+    {
+        le_msg_ReleaseMsg(msgRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The server thread.  Advertises one service per test.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ServerThread
+(
+    void* contextPtr
+)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Tests); i++)
+    {
+        le_msg_ServiceRef_t serviceRef = le_msg_CreateService(GetProtocol(&Tests[i]),
+                                                              Tests[i].name);
+        le_msg_SetServiceRecvHandler(serviceRef, ServerRecvHandler, NULL);
+        if (Tests[i].useSharedMem)
+        {
+            le_msg_EnableServiceSharedMem(serviceRef);
+        }
+        le_msg_AdvertiseService(serviceRef);
+    }
+
+    le_sem_Post(ServerReadySem);
+
+    le_event_RunLoop();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Does one synchronous request-response transaction.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RoundTrip
+(
+    const PerfTest_t*   testPtr,
+    le_msg_SessionRef_t sessionRef
+)
+{
+    le_msg_MessageRef_t msgRef = CreateMsg(testPtr, sessionRef);
+
+    msgRef = le_msg_RequestSyncResponse(msgRef);
+    LE_ASSERT(msgRef != NULL);
+    le_msg_ReleaseMsg(msgRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs the latency and throughput tests for one combination of transport and message size.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunTest
+(
+    const PerfTest_t* testPtr
+)
+{
+    le_msg_ProtocolRef_t protocolRef = GetProtocol(testPtr);
+    le_msg_SessionRef_t sessionRef = le_msg_CreateSession(protocolRef, testPtr->name);
+    size_t size = testPtr->isSized ? SMALL_SIZE : le_msg_GetProtocolMaxMsgSize(protocolRef);
+    le_clk_Time_t startTime;
+    double latencySecs;
+    double streamSecs;
+    int i;
+
+    le_msg_OpenSessionSync(sessionRef);
+
+    // Latency: back-to-back synchronous round trips.
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < NumMessages; i++)
+    {
+        RoundTrip(testPtr, sessionRef);
+    }
+    latencySecs = ElapsedSecs(startTime);
+
+    // Throughput: a stream of one-way messages, followed by one round trip, which can only
+    // complete once the server has received everything that was sent before it.
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < NumMessages; i++)
+    {
+        le_msg_MessageRef_t msgRef = CreateMsg(testPtr, sessionRef);
+
+        memset(le_msg_GetPayloadPtr(msgRef), i, size);
+        le_msg_Send(msgRef);
+    }
+    RoundTrip(testPtr, sessionRef);
+    streamSecs = ElapsedSecs(startTime);
+
+    printf("%-26s %8zu %14.2f %14.0f %12.1f\n",
+           testPtr->name,
+           size,
+           (latencySecs * 1000000.0) / NumMessages,
+           NumMessages / streamSecs,
+           (((double)NumMessages * size) / streamSecs) / (1024 * 1024));
+
+    le_msg_CloseSession(sessionRef);
+    le_msg_DeleteSession(sessionRef);
+}
+
+
+COMPONENT_INIT
+{
+    size_t i;
+
+    le_arg_SetIntVar(&NumMessages, "n", "messages");
+    le_arg_SetIntVar(&MaxSize, "s", "max-size");
+    le_arg_Scan();
+
+    LE_ASSERT(NumMessages > 0);
+    LE_ASSERT(MaxSize >= SMALL_SIZE);
+
+    printf("*** Performance test for low-level messaging. ***\n");
+
+    ServerReadySem = le_sem_Create("ServerReady", 0);
+    le_thread_Start(le_thread_Create("MessagingPerfServer", ServerThread, NULL));
+    le_sem_Wait(ServerReadySem);
+
+    printf("%-26s %8s %14s %14s %12s\n", "test", "bytes", "round trip us", "stream msg/s",
+           "stream MB/s");
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Tests); i++)
+    {
+        RunTest(&Tests[i]);
+    }
+
+    exit(EXIT_SUCCESS);
+}
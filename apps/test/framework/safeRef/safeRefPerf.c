@@ -0,0 +1,193 @@
+ /**
+  * Micro-benchmark for the le_ref module.
+  *
+  * Measures the time taken by le_ref_CreateRef(), le_ref_Lookup() and le_ref_DeleteRef() on maps
+  * holding 10 to N Safe References, next to the same operations done the way Safe References used
+  * to be kept: an le_hashmap from an odd counter value to the pointer.
+  *
+  * Usage: testFwSafeRefPerf [-n MAX_REFS] [-l LOOKUPS_PER_REF]
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#include "legato.h"
+
+#define DEFAULT_MAX_REFS        1000000
+#define DEFAULT_LOOKUPS         10
+#define MAX_DECADES             10
+#define NAME_BYTES              16
+
+static void** Refs;
+static int Lookups = DEFAULT_LOOKUPS;
+
+// Maps can't be deleted and hash maps keep a pointer to their name, so each size gets maps with
+// names of their own.
+static char Names[MAX_DECADES][2][NAME_BYTES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a start time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double NsSince
+(
+    le_clk_Time_t start
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return (elapsed.sec * 1000000000.0) + (elapsed.usec * 1000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash function for the hash map, the same one Safe Reference maps used to use.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashRef
+(
+    const void* refPtr
+)
+{
+    return (size_t)refPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality function for the hash map.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EqualsRef
+(
+    const void* firstRefPtr,
+    const void* secondRefPtr
+)
+{
+    return firstRefPtr == secondRefPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates, looks up and deletes a number of Safe References, and prints the time taken per
+ * operation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunRefMap
+(
+    le_ref_MapRef_t mapRef,
+    int numRefs
+)
+{
+    int i, j;
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    for (i = 0; i < numRefs; i++)
+    {
+        Refs[i] = le_ref_CreateRef(mapRef, &Refs[i]);
+    }
+    double createNs = NsSince(start);
+
+    start = le_clk_GetRelativeTime();
+    for (j = 0; j < Lookups; j++)
+    {
+        for (i = 0; i < numRefs; i++)
+        {
+            LE_ASSERT(le_ref_Lookup(mapRef, Refs[i]) == &Refs[i]);
+        }
+    }
+    double lookupNs = NsSince(start);
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < numRefs; i++)
+    {
+        le_ref_DeleteRef(mapRef, Refs[i]);
+    }
+    double deleteNs = NsSince(start);
+
+    printf("%10d %-10s %12.1f %12.1f %12.1f\n", numRefs, "le_ref",
+           createNs / numRefs, lookupNs / ((double)numRefs * Lookups), deleteNs / numRefs);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Does the same as RunRefMap() with a hash map keyed by an odd counter.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunHashmap
+(
+    le_hashmap_Ref_t map,
+    int numRefs
+)
+{
+    uint32_t nextRefNum = 0x10000001;
+    int i, j;
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    for (i = 0; i < numRefs; i++)
+    {
+        Refs[i] = (void*)(uintptr_t)nextRefNum;
+        le_hashmap_Put(map, Refs[i], &Refs[i]);
+        nextRefNum += 2;
+    }
+    double createNs = NsSince(start);
+
+    start = le_clk_GetRelativeTime();
+    for (j = 0; j < Lookups; j++)
+    {
+        for (i = 0; i < numRefs; i++)
+        {
+            LE_ASSERT(le_hashmap_Get(map, Refs[i]) == &Refs[i]);
+        }
+    }
+    double lookupNs = NsSince(start);
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < numRefs; i++)
+    {
+        le_hashmap_Remove(map, Refs[i]);
+    }
+    double deleteNs = NsSince(start);
+
+    printf("%10d %-10s %12.1f %12.1f %12.1f\n", numRefs, "hashmap",
+           createNs / numRefs, lookupNs / ((double)numRefs * Lookups), deleteNs / numRefs);
+}
+
+
+COMPONENT_INIT
+{
+    int maxRefs = DEFAULT_MAX_REFS;
+    int numRefs;
+    int decade = 0;
+
+    le_arg_SetIntVar(&maxRefs, "n", "refs");
+    le_arg_SetIntVar(&Lookups, "l", "lookups");
+    le_arg_Scan();
+
+    Refs = malloc(maxRefs * sizeof(void*));
+    LE_ASSERT(Refs != NULL);
+
+    printf("*** Performance test for le_ref module. ***\n");
+    printf("%10s %-10s %12s %12s %12s\n", "refs", "map", "create ns", "lookup ns", "delete ns");
+
+    for (numRefs = 10;
+         (numRefs <= maxRefs) && (decade < MAX_DECADES);
+         numRefs *= 10, decade++)
+    {
+        char (*namePtr)[NAME_BYTES] = Names[decade];
+
+        snprintf(namePtr[0], NAME_BYTES, "Ref%d", decade);
+        RunRefMap(le_ref_CreateMap(namePtr[0], numRefs), numRefs);
+
+        snprintf(namePtr[1], NAME_BYTES, "Hash%d", decade);
+        RunHashmap(le_hashmap_Create(namePtr[1], numRefs, HashRef, EqualsRef), numRefs);
+    }
+
+    free(Refs);
+
+    exit(EXIT_SUCCESS);
+}
@@ -64,6 +64,112 @@ COMPONENT_INIT
     LE_ASSERT(le_ref_Lookup(mapRef1, &mapRef1) == NULL);
     LE_INFO("Looking up a pointer value failed, as expected");
 
+    LE_INFO("Checking that a deleted reference stays invalid after its slot is reused...");
+
+    le_ref_DeleteRef(mapRef1, safeRef1);
+    void* staleRef = safeRef1;
+    int i;
+    for (i = 0; i < 100; i++)
+    {
+        safeRef1 = le_ref_CreateRef(mapRef1, (void*)0x2001);
+        LE_ASSERT(safeRef1 != staleRef);
+        LE_ASSERT(le_ref_Lookup(mapRef1, staleRef) == NULL);
+        LE_ASSERT(le_ref_Lookup(mapRef1, safeRef1) == (void*)0x2001);
+        le_ref_DeleteRef(mapRef1, safeRef1);
+        staleRef = safeRef1;
+    }
+    LE_INFO("Deleting a stale reference (expect ERROR)");
+    le_ref_DeleteRef(mapRef1, staleRef);
+    safeRef1 = le_ref_CreateRef(mapRef1, (void*)0x1001);
+
+    LE_INFO("Checking that a reference from another map is rejected...");
+
+    le_ref_MapRef_t mapRef2 = le_ref_CreateMap("Map 2", 4);
+    void* otherRef = le_ref_CreateRef(mapRef2, (void*)0x3001);
+    LE_ASSERT(le_ref_Lookup(mapRef1, otherRef) == NULL);
+    LE_ASSERT(le_ref_Lookup(mapRef2, safeRef1) == NULL);
+
+    LE_INFO("Growing map %p beyond its expected size...", mapRef2);
+
+    void* manyRefs[1000];
+    for (i = 0; i < 1000; i++)
+    {
+        manyRefs[i] = le_ref_CreateRef(mapRef2, (void*)(uintptr_t)(0x10000 + i * 2));
+
+        // References are passed through IPC as 32-bit values.
+        LE_ASSERT((uintptr_t)manyRefs[i] <= UINT32_MAX);
+    }
+    for (i = 0; i < 1000; i++)
+    {
+        LE_ASSERT(le_ref_Lookup(mapRef2, manyRefs[i]) == (void*)(uintptr_t)(0x10000 + i * 2));
+    }
+    LE_ASSERT(le_ref_Lookup(mapRef2, otherRef) == (void*)0x3001);
+
+    LE_INFO("Iterating over map %p while deleting every other reference...", mapRef2);
+
+    int count = 0;
+    le_ref_IterRef_t iterRef = le_ref_GetIterator(mapRef2);
+    LE_ASSERT(le_ref_GetSafeRef(iterRef) == NULL);
+    while (le_ref_NextNode(iterRef) == LE_OK)
+    {
+        void* ref = (void*)le_ref_GetSafeRef(iterRef);
+        LE_ASSERT(le_ref_Lookup(mapRef2, ref) == le_ref_GetValue(iterRef));
+        if ((count % 2) == 0)
+        {
+            le_ref_DeleteRef(mapRef2, ref);
+            LE_ASSERT(le_ref_GetSafeRef(iterRef) == NULL);
+            LE_ASSERT(le_ref_GetValue(iterRef) == NULL);
+        }
+        count++;
+    }
+    LE_ASSERT(count == 1001);
+    LE_ASSERT(le_ref_NextNode(iterRef) == LE_NOT_FOUND);
+
+    count = 0;
+    iterRef = le_ref_GetIterator(mapRef2);
+    while (le_ref_NextNode(iterRef) == LE_OK)
+    {
+        count++;
+    }
+    LE_ASSERT(count == 500);
+
+    LE_INFO("Growing map %p to more than a million references...", mapRef2);
+
+    // The map's references take more index bits as it grows, so check that references made
+    // before then still work.
+    size_t numBigRefs = 1200000;
+    void** bigRefs = malloc(numBigRefs * sizeof(void*));
+    LE_ASSERT(bigRefs != NULL);
+    size_t j;
+    for (j = 0; j < numBigRefs; j++)
+    {
+        bigRefs[j] = le_ref_CreateRef(mapRef2, (void*)(uintptr_t)(2 * j + 1));
+        LE_ASSERT((uintptr_t)bigRefs[j] <= UINT32_MAX);
+    }
+    for (j = 0; j < numBigRefs; j++)
+    {
+        LE_ASSERT(le_ref_Lookup(mapRef2, bigRefs[j]) == (void*)(uintptr_t)(2 * j + 1));
+    }
+    LE_ASSERT(le_ref_Lookup(mapRef2, manyRefs[0]) == (void*)0x10000);
+    LE_ASSERT(le_ref_Lookup(mapRef2, manyRefs[1]) == NULL);
+
+    count = 0;
+    iterRef = le_ref_GetIterator(mapRef2);
+    while (le_ref_NextNode(iterRef) == LE_OK)
+    {
+        void* ref = (void*)le_ref_GetSafeRef(iterRef);
+        LE_ASSERT(le_ref_Lookup(mapRef2, ref) == le_ref_GetValue(iterRef));
+        count++;
+    }
+    LE_ASSERT(count == 500 + (int)numBigRefs);
+
+    for (j = 0; j < numBigRefs; j++)
+    {
+        le_ref_DeleteRef(mapRef2, bigRefs[j]);
+        LE_ASSERT(le_ref_Lookup(mapRef2, bigRefs[j]) == NULL);
+    }
+    free(bigRefs);
+
 
     LE_INFO("======== SAFE REFERENCES TEST COMPLETE (PASSED) ========");
     exit(EXIT_SUCCESS);
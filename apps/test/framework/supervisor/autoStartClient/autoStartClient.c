@@ -0,0 +1,18 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client side of the auto-start ordering test.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+COMPONENT_INIT
+{
+    LE_INFO("======== AutoStartClientApp started ========");
+
+    autoStart_Ping();
+}
@@ -0,0 +1,25 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server side of the auto-start ordering test.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+void autoStart_Ping
+(
+    void
+)
+{
+    LE_INFO("======== AutoStartServerApp pinged ========");
+}
+
+
+COMPONENT_INIT
+{
+    LE_INFO("======== AutoStartServerApp started ========");
+}
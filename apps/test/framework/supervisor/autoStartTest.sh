@@ -0,0 +1,70 @@
+#!/bin/bash
+
+LoadTestLib
+
+targetAddr=$1
+targetType=${2:-ar7}
+
+OnFail() {
+    echo "Auto-start Test Failed!"
+}
+
+OnExit() {
+    ssh root@$targetAddr "$BIN_PATH/app remove AutoStartClientApp; $BIN_PATH/app remove AutoStartServerApp"
+}
+
+if [ "$LEGATO_ROOT" == "" ]
+then
+    if [ "$WORKSPACE" == "" ]
+    then
+        echo "Neither LEGATO_ROOT nor WORKSPACE are defined." >&2
+        exit 1
+    else
+        LEGATO_ROOT="$WORKSPACE"
+    fi
+fi
+
+#---------------------------------------------------------------------------------------------------
+# Print the line number of the last log message that matches logStr, or 0 if there is none.
+#---------------------------------------------------------------------------------------------------
+LogLine () {
+    local logStr=$1
+
+    ssh root@$targetAddr "/sbin/logread | grep -n \"$logStr\" | tail -n 1 | cut -d: -f1" |
+        grep . || echo 0
+}
+
+echo "******** Auto-start Test Starting ***********"
+
+echo "Install the apps, the client first so that it comes first in the config."
+appDir="$LEGATO_ROOT/build/$targetType/tests/apps"
+cd "$appDir"
+CheckRet
+InstallApp AutoStartClientApp
+InstallApp AutoStartServerApp
+
+ClearLogs
+
+# The start program only returns once the Supervisor closes its stdin, which must not happen
+# before the last auto-start app has been launched.
+echo "Restart Legato."
+ssh root@$targetAddr "$BIN_PATH/legato restart"
+CheckRet
+
+serverLine=$(LogLine "Boot timeline: app 'AutoStartServerApp' launched")
+clientLine=$(LogLine "Boot timeline: app 'AutoStartClientApp' launched")
+doneLine=$(LogLine "Boot timeline: auto-start done")
+
+echo "Server launched at line $serverLine, client at line $clientLine, done at line $doneLine."
+
+DoTheTest "server launch" $serverLine ">" 0
+DoTheTest "client launch" $clientLine ">" $serverLine
+DoTheTest "auto-start done" $doneLine ">" $clientLine
+
+# Wait for the client to call the server.
+sleep 3
+
+CheckLogStr "==" 1 "======== AutoStartServerApp pinged ========"
+
+echo "Auto-start Test Passed!"
+exit 0
@@ -0,0 +1,149 @@
+ /**
+  * Micro-benchmark for the le_timer module.
+  *
+  * For each of a number of timer counts, measures the average cost of le_timer_Start() and
+  * le_timer_Stop() while that many timers are active on the thread, and the average cost of
+  * arming that many timers to expire at about the same time and handling their expiries.
+  *
+  * Usage: testFwTimerPerf [-s SLACK_MS]
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#include "legato.h"
+
+static const size_t TimerCounts[] = { 10, 1000, 100000 };
+
+static le_timer_Ref_t* Timers;
+static size_t TestIndex;
+static size_t NumExpired;
+static le_clk_Time_t ExpiryStart;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the elapsed time since a given time, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double ElapsedUsec
+(
+    le_clk_Time_t start
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return (elapsed.sec * 1000000.0) + elapsed.usec;
+}
+
+
+static void RunTest(void);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer expiry handler.  Reports the expiry cost once all the timers have expired, then moves on
+ * to the next timer count.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ExpiryHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    size_t numTimers = TimerCounts[TestIndex];
+    size_t i;
+
+    if (++NumExpired < numTimers)
+    {
+        return;
+    }
+
+    printf("%20.3f\n", ElapsedUsec(ExpiryStart) / numTimers);
+
+    for (i = 0; i < numTimers; i++)
+    {
+        le_timer_Delete(Timers[i]);
+    }
+    free(Timers);
+
+    TestIndex++;
+    RunTest();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the test for the current timer count.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunTest
+(
+    void
+)
+{
+    if (TestIndex >= NUM_ARRAY_MEMBERS(TimerCounts))
+    {
+        exit(EXIT_SUCCESS);
+    }
+
+    size_t numTimers = TimerCounts[TestIndex];
+    le_clk_Time_t start;
+    double startUsec;
+    double stopUsec;
+    size_t i;
+
+    Timers = malloc(numTimers * sizeof(le_timer_Ref_t));
+    LE_ASSERT(Timers != NULL);
+
+    for (i = 0; i < numTimers; i++)
+    {
+        Timers[i] = le_timer_Create("perf");
+        le_timer_SetHandler(Timers[i], ExpiryHandler);
+        // Spread the timers out over an hour so that none of them expire during the test.
+        le_timer_SetMsInterval(Timers[i], 3600000 - ((i * 7919) % 3600000));
+    }
+
+    // Start and stop all the timers.
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < numTimers; i++)
+    {
+        LE_ASSERT_OK(le_timer_Start(Timers[i]));
+    }
+    startUsec = ElapsedUsec(start);
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < numTimers; i++)
+    {
+        LE_ASSERT_OK(le_timer_Stop(Timers[i]));
+    }
+    stopUsec = ElapsedUsec(start);
+
+    printf("%10zu %20.3f %20.3f", numTimers, startUsec / numTimers, stopUsec / numTimers);
+
+    // Have all the timers expire at about the same time.  The expiry cost includes arming them.
+    NumExpired = 0;
+    ExpiryStart = le_clk_GetRelativeTime();
+    for (i = 0; i < numTimers; i++)
+    {
+        le_timer_SetMsInterval(Timers[i], 1);
+        LE_ASSERT_OK(le_timer_Start(Timers[i]));
+    }
+}
+
+
+COMPONENT_INIT
+{
+    int slackMs = 0;
+
+    le_arg_SetIntVar(&slackMs, "s", "slack");
+    le_arg_Scan();
+
+    le_clk_Time_t slack = { slackMs / 1000, (slackMs % 1000) * 1000 };
+    le_timer_SetWakeupSlack(slack);
+
+    printf("*** Performance test for le_timer module. ***\n");
+    printf("%10s %20s %20s %20s\n", "timers", "start (us)", "stop (us)", "expiry (us)");
+
+    TestIndex = 0;
+    RunTest();
+}
@@ -0,0 +1,559 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Tests the Update Daemon's in-process tarball extraction.
+ *
+ *  Tarballs are built in memory, compressed with bzip2 or not, and fed to the extraction a few
+ *  bytes, a block, or all at once.  A good tarball must come out intact (with the setuid and
+ *  setgid bits cleared), and tarballs that try to escape the extraction directory, or are
+ *  truncated or corrupt, must be rejected as badly formatted.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "untar.h"
+
+#include <bzlib.h>
+
+
+
+
+/// Size of a tar block.
+#define TAR_BLOCK_SIZE 512
+
+
+/// Largest tarball built by the test, compressed or not.
+#define MAX_ARCHIVE_BYTES 65536
+
+
+/// Size of the file that needs padding to a whole block.
+#define PADDED_FILE_BYTES 1000
+
+
+/// Number of bytes to feed the extraction at a time, the last one meaning all at once.
+static const size_t ChunkSizes[] = { 1, 7, TAR_BLOCK_SIZE, 4096, MAX_ARCHIVE_BYTES };
+
+
+/// Temporary directory holding the extraction directory and the directory outside of it.
+static char TempDir[] = "/tmp/untarTestXXXXXX";
+static char ExtractDir[PATH_MAX];
+static char OutsideDir[PATH_MAX];
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  A tarball being built.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t bytes[MAX_ARCHIVE_BYTES];
+    size_t size;
+}
+Archive_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add an entry to a tarball, with its data.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddEntry
+(
+    Archive_t* archivePtr,
+    const char* namePtr,
+    char type,
+    mode_t mode,
+    const char* linkPtr,
+    const void* dataPtr,
+    size_t dataSize
+)
+{
+    uint8_t* blockPtr = archivePtr->bytes + archivePtr->size;
+    size_t paddedSize = (dataSize + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+    unsigned int sum = 0;
+
+    LE_ASSERT(archivePtr->size + TAR_BLOCK_SIZE + paddedSize <= sizeof(archivePtr->bytes));
+    LE_ASSERT(strlen(namePtr) < 100);
+    LE_ASSERT(strlen(linkPtr) < 100);
+
+    memset(blockPtr, 0, TAR_BLOCK_SIZE + paddedSize);
+
+    memcpy(blockPtr, namePtr, strlen(namePtr));
+    snprintf((char*)blockPtr + 100, 8, "%07o", (unsigned int)mode);
+    snprintf((char*)blockPtr + 108, 8, "%07o", 0);
+    snprintf((char*)blockPtr + 116, 8, "%07o", 0);
+    snprintf((char*)blockPtr + 124, 12, "%011o", (unsigned int)dataSize);
+    snprintf((char*)blockPtr + 136, 12, "%011o", 0);
+    blockPtr[156] = type;
+    memcpy(blockPtr + 157, linkPtr, strlen(linkPtr));
+    memcpy(blockPtr + 257, "ustar\0" "00", 8);
+
+    memset(blockPtr + 148, ' ', 8);
+    for (size_t i = 0; i < TAR_BLOCK_SIZE; i++)
+    {
+        sum += blockPtr[i];
+    }
+    snprintf((char*)blockPtr + 148, 8, "%06o", sum);
+
+    if (dataSize > 0)
+    {
+        memcpy(blockPtr + TAR_BLOCK_SIZE, dataPtr, dataSize);
+    }
+
+    archivePtr->size += TAR_BLOCK_SIZE + paddedSize;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add a file entry to a tarball.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddFile
+(
+    Archive_t* archivePtr,
+    const char* namePtr,
+    mode_t mode,
+    const void* dataPtr,
+    size_t dataSize
+)
+{
+    AddEntry(archivePtr, namePtr, '0', mode, "", dataPtr, dataSize);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  End a tarball with its two zero blocks.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndArchive
+(
+    Archive_t* archivePtr
+)
+{
+    LE_ASSERT(archivePtr->size + 2 * TAR_BLOCK_SIZE <= sizeof(archivePtr->bytes));
+
+    memset(archivePtr->bytes + archivePtr->size, 0, 2 * TAR_BLOCK_SIZE);
+    archivePtr->size += 2 * TAR_BLOCK_SIZE;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Compress a tarball with bzip2.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Compress
+(
+    const Archive_t* archivePtr,
+    Archive_t* compressedPtr
+)
+{
+    unsigned int size = sizeof(compressedPtr->bytes);
+
+    LE_ASSERT(BZ2_bzBuffToBuffCompress((char*)compressedPtr->bytes,
+                                       &size,
+                                       (char*)archivePtr->bytes,
+                                       archivePtr->size,
+                                       9,
+                                       0,
+                                       0) == BZ_OK);
+    compressedPtr->size = size;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the path of an entry in the extraction directory or the directory outside of it.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* GetPath
+(
+    const char* dirPtr,
+    const char* namePtr
+)
+{
+    static char path[PATH_MAX];
+
+    LE_ASSERT(snprintf(path, sizeof(path), "%s/%s", dirPtr, namePtr) < (int)sizeof(path));
+
+    return path;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Empty the extraction directory and the directory outside of it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetDirs
+(
+    void
+)
+{
+    // Directories extracted read-only must be made writable again to be removed.
+    chmod(GetPath(ExtractDir, "d"), S_IRWXU);
+
+    LE_ASSERT_OK(le_dir_RemoveRecursive(ExtractDir));
+    LE_ASSERT_OK(le_dir_RemoveRecursive(OutsideDir));
+    LE_ASSERT(mkdir(ExtractDir, S_IRWXU) == 0);
+    LE_ASSERT(mkdir(OutsideDir, S_IRWXU) == 0);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Extract a tarball into the (empty) extraction directory, a chunk at a time.
+ *
+ *  @return The first error returned by the extraction, or LE_OK if there is none.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Extract
+(
+    const Archive_t* archivePtr,
+    size_t size,
+    size_t chunkSize
+)
+{
+    untar_Ref_t ref;
+    le_result_t result = LE_OK;
+    size_t offset = 0;
+
+    ResetDirs();
+
+    ref = untar_Create(ExtractDir);
+
+    while ((offset < size) && (result == LE_OK))
+    {
+        size_t count = (size - offset < chunkSize) ? (size - offset) : chunkSize;
+
+        result = untar_Write(ref, archivePtr->bytes + offset, count);
+        offset += count;
+    }
+
+    if (result == LE_OK)
+    {
+        result = untar_Finish(ref);
+    }
+
+    untar_Delete(ref);
+
+    return result;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Check that the extraction of a tarball fails as badly formatted, at every chunk size and
+ *  whether or not it is compressed, without anything landing outside of the extraction directory.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckRejected
+(
+    const Archive_t* archivePtr
+)
+{
+    static Archive_t compressed;
+    struct stat st;
+
+    Compress(archivePtr, &compressed);
+
+    for (size_t i = 0; i < NUM_ARRAY_MEMBERS(ChunkSizes); i++)
+    {
+        LE_ASSERT(Extract(archivePtr, archivePtr->size, ChunkSizes[i]) == LE_FORMAT_ERROR);
+        LE_ASSERT(lstat(GetPath(OutsideDir, "evil"), &st) == -1);
+        LE_ASSERT(lstat(GetPath(TempDir, "evil"), &st) == -1);
+
+        LE_ASSERT(Extract(&compressed, compressed.size, ChunkSizes[i]) == LE_FORMAT_ERROR);
+        LE_ASSERT(lstat(GetPath(OutsideDir, "evil"), &st) == -1);
+        LE_ASSERT(lstat(GetPath(TempDir, "evil"), &st) == -1);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Check a file that was extracted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckFile
+(
+    const char* namePtr,
+    mode_t mode,
+    const void* dataPtr,
+    size_t dataSize
+)
+{
+    struct stat st;
+    char buffer[PADDED_FILE_BYTES + 1];
+
+    LE_ASSERT(lstat(GetPath(ExtractDir, namePtr), &st) == 0);
+    LE_ASSERT(S_ISREG(st.st_mode));
+    LE_ASSERT((st.st_mode & 07777) == mode);
+    LE_ASSERT((size_t)st.st_size == dataSize);
+
+    int fd = open(GetPath(ExtractDir, namePtr), O_RDONLY);
+    LE_ASSERT(fd != -1);
+    LE_ASSERT(read(fd, buffer, sizeof(buffer)) == (ssize_t)dataSize);
+    LE_ASSERT((dataSize == 0) || (memcmp(buffer, dataPtr, dataSize) == 0));
+    LE_ASSERT(close(fd) == 0);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Test the extraction of a good tarball, with every type of entry supported.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestGoodArchive
+(
+    void
+)
+{
+    static Archive_t archive;
+    static Archive_t compressed;
+    char paddedData[PADDED_FILE_BYTES];
+    char longName[PATH_MAX];
+    char paxRecord[PATH_MAX];
+    char linkTarget[PATH_MAX];
+    struct stat st;
+    struct stat linkSt;
+
+    LE_INFO("----  Good tarball.  ------------------------------");
+
+    for (size_t i = 0; i < sizeof(paddedData); i++)
+    {
+        paddedData[i] = 'a' + (i % 26);
+    }
+
+    // A name too long for a header, given by a GNU long name entry.
+    memset(longName, 'n', 150);
+    memcpy(longName, "d/", 2);
+    longName[150] = '\0';
+
+    // A name given by a pax header, whose records start with their own length.
+    static const char paxPath[] = "d/pax";
+    size_t paxLen = strlen(" path=") + strlen(paxPath) + strlen("\n");
+    paxLen += snprintf(NULL, 0, "%zu", paxLen + 2);
+    LE_ASSERT(snprintf(paxRecord, sizeof(paxRecord), "%zu path=%s\n", paxLen, paxPath)
+              == (int)paxLen);
+
+    archive.size = 0;
+    AddEntry(&archive, "d/", '5', 0555, "", NULL, 0);
+    AddFile(&archive, "d/f", 04755, "hello\n", 6);
+    AddFile(&archive, "d/padded", 02640, paddedData, sizeof(paddedData));
+    AddEntry(&archive, "d/s", '2', 0777, "f", NULL, 0);
+    AddEntry(&archive, "d/h", '1', 0755, "d/f", NULL, 0);
+    AddEntry(&archive, "././@LongLink", 'L', 0644, "", longName, strlen(longName) + 1);
+    AddFile(&archive, "placeholder", 0644, "long", 4);
+    AddEntry(&archive, "paxHeader", 'x', 0644, "", paxRecord, paxLen);
+    AddFile(&archive, "placeholder", 0600, "pax", 3);
+    AddFile(&archive, "/empty", 0600, NULL, 0);
+    EndArchive(&archive);
+
+    Compress(&archive, &compressed);
+
+    for (size_t i = 0; i < NUM_ARRAY_MEMBERS(ChunkSizes) * 2; i++)
+    {
+        const Archive_t* archivePtr = (i % 2) ? &compressed : &archive;
+
+        LE_ASSERT_OK(Extract(archivePtr, archivePtr->size, ChunkSizes[i / 2]));
+
+        LE_ASSERT(lstat(GetPath(ExtractDir, "d"), &st) == 0);
+        LE_ASSERT(S_ISDIR(st.st_mode));
+        LE_ASSERT((st.st_mode & 07777) == 0555);
+
+        CheckFile("d/f", 0755, "hello\n", 6);
+        CheckFile("d/padded", 0640, paddedData, sizeof(paddedData));
+        CheckFile(longName, 0644, "long", 4);
+        CheckFile(paxPath, 0600, "pax", 3);
+        CheckFile("empty", 0600, NULL, 0);
+        LE_ASSERT(lstat(GetPath(ExtractDir, "placeholder"), &st) == -1);
+
+        LE_ASSERT(lstat(GetPath(ExtractDir, "d/s"), &linkSt) == 0);
+        LE_ASSERT(S_ISLNK(linkSt.st_mode));
+        LE_ASSERT(readlink(GetPath(ExtractDir, "d/s"), linkTarget, sizeof(linkTarget)) == 1);
+        LE_ASSERT(linkTarget[0] == 'f');
+
+        LE_ASSERT(lstat(GetPath(ExtractDir, "d/f"), &st) == 0);
+        LE_ASSERT(lstat(GetPath(ExtractDir, "d/h"), &linkSt) == 0);
+        LE_ASSERT(linkSt.st_ino == st.st_ino);
+        LE_ASSERT(st.st_nlink == 2);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Test tarballs with entries that would be created outside of the extraction directory.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestEscapes
+(
+    void
+)
+{
+    static Archive_t archive;
+
+    LE_INFO("----  Path traversal.  ------------------------------");
+
+    archive.size = 0;
+    AddFile(&archive, "../evil", 0644, "evil", 4);
+    EndArchive(&archive);
+    CheckRejected(&archive);
+
+    archive.size = 0;
+    AddFile(&archive, "a/../../evil", 0644, "evil", 4);
+    EndArchive(&archive);
+    CheckRejected(&archive);
+
+    LE_INFO("----  Entry under a symlink.  ------------------------------");
+
+    archive.size = 0;
+    AddEntry(&archive, "s", '2', 0777, OutsideDir, NULL, 0);
+    AddFile(&archive, "s/evil", 0644, "evil", 4);
+    EndArchive(&archive);
+    CheckRejected(&archive);
+
+    LE_INFO("----  Hard link outside.  ------------------------------");
+
+    LE_ASSERT(close(open(GetPath(TempDir, "target"), O_WRONLY | O_CREAT, S_IRUSR)) == 0);
+
+    archive.size = 0;
+    AddEntry(&archive, "evil", '1', 0644, "../target", NULL, 0);
+    EndArchive(&archive);
+    CheckRejected(&archive);
+
+    archive.size = 0;
+    AddEntry(&archive, "s", '2', 0777, TempDir, NULL, 0);
+    AddEntry(&archive, "evil", '1', 0644, "s/target", NULL, 0);
+    EndArchive(&archive);
+    CheckRejected(&archive);
+
+    LE_ASSERT(unlink(GetPath(TempDir, "target")) == 0);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Test tarballs that end early or are corrupt.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestBadArchives
+(
+    void
+)
+{
+    static Archive_t archive;
+    static Archive_t compressed;
+    static Archive_t corrupt;
+    char data[PADDED_FILE_BYTES] = "";
+
+    archive.size = 0;
+    AddFile(&archive, "f", 0644, data, sizeof(data));
+    AddFile(&archive, "g", 0644, data, sizeof(data));
+    EndArchive(&archive);
+    Compress(&archive, &compressed);
+
+    LE_INFO("----  Truncated tarball.  ------------------------------");
+
+    // Cut in the middle of headers, data and padding, but not at the end of an entry, which is
+    // where a tarball without its zero blocks would end.
+    for (size_t size = 0; size < archive.size - 2 * TAR_BLOCK_SIZE; size += TAR_BLOCK_SIZE / 2 + 1)
+    {
+        for (size_t i = 0; i < NUM_ARRAY_MEMBERS(ChunkSizes); i++)
+        {
+            LE_ASSERT(Extract(&archive, size, ChunkSizes[i]) == LE_FORMAT_ERROR);
+        }
+    }
+
+    // The end of the tarball is decompressed before the last few bytes of the bzip2 stream, so
+    // only cut well before them.
+    for (size_t size = 0; size < compressed.size * 4 / 5; size += compressed.size / 5 + 1)
+    {
+        for (size_t i = 0; i < NUM_ARRAY_MEMBERS(ChunkSizes); i++)
+        {
+            LE_ASSERT(Extract(&compressed, size, ChunkSizes[i]) == LE_FORMAT_ERROR);
+        }
+    }
+
+    LE_INFO("----  Corrupt tarball.  ------------------------------");
+
+    // Bad checksum in the second header.
+    corrupt = archive;
+    corrupt.bytes[TAR_BLOCK_SIZE + 2 * TAR_BLOCK_SIZE] ^= 0x01;
+    CheckRejected(&corrupt);
+
+    // Not a number where the size should be.
+    corrupt = archive;
+    corrupt.bytes[124] = 'x';
+    CheckRejected(&corrupt);
+
+    // Damaged compressed data.
+    corrupt = compressed;
+    corrupt.bytes[compressed.size / 2] ^= 0x55;
+    for (size_t i = 0; i < NUM_ARRAY_MEMBERS(ChunkSizes); i++)
+    {
+        LE_ASSERT(Extract(&corrupt, corrupt.size, ChunkSizes[i]) == LE_FORMAT_ERROR);
+    }
+
+    // bzip2 magic followed by garbage.
+    memcpy(corrupt.bytes, "BZhgarbage", 10);
+    for (size_t i = 0; i < NUM_ARRAY_MEMBERS(ChunkSizes); i++)
+    {
+        LE_ASSERT(Extract(&corrupt, 10, ChunkSizes[i]) == LE_FORMAT_ERROR);
+    }
+}
+
+
+
+
+COMPONENT_INIT
+{
+    LE_ASSERT(mkdtemp(TempDir) != NULL);
+    LE_ASSERT(le_utf8_Copy(ExtractDir, GetPath(TempDir, "x"), sizeof(ExtractDir), NULL) == LE_OK);
+    LE_ASSERT(le_utf8_Copy(OutsideDir, GetPath(TempDir, "outside"), sizeof(OutsideDir), NULL)
+              == LE_OK);
+
+    untar_Init();
+
+    TestGoodArchive();
+    TestEscapes();
+    TestBadArchives();
+
+    ResetDirs();
+    LE_ASSERT_OK(le_dir_RemoveRecursive(TempDir));
+
+    LE_INFO("----  Done.  ------------------------------");
+
+    exit(EXIT_SUCCESS);
+}
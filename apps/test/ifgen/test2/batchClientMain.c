@@ -0,0 +1,135 @@
+/**
+ * Client for testing batched calls.  Uses the client-side code generated with --batch, and the
+ * regular (synchronous) example server.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "batch_interface.h"
+#include "le_print.h"
+
+// Enough calls to need several batch messages.
+#define NUM_CALLS 100
+
+#define OUTPUT_LEN 5
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Results of one queued call to allParameters().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t value;
+    uint32_t output[OUTPUT_LEN];
+    size_t length;
+    char response[21];
+    char more[21];
+}
+CallResult_t;
+
+static CallResult_t Results[NUM_CALLS];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a call to allParameters(), storing its outputs in a given result record.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueCall
+(
+    CallResult_t* resultPtr
+)
+{
+    uint32_t data[] = {1, 2, 3, 4};
+
+    resultPtr->value = 0;
+    resultPtr->length = OUTPUT_LEN;
+    memset(resultPtr->output, 0, sizeof(resultPtr->output));
+    resultPtr->response[0] = '\0';
+    resultPtr->more[0] = '\0';
+
+    batch_QueueallParameters(COMMON_TWO,
+                             &resultPtr->value,
+                             data,
+                             NUM_ARRAY_MEMBERS(data),
+                             resultPtr->output,
+                             &resultPtr->length,
+                             "batched call",
+                             resultPtr->response,
+                             sizeof(resultPtr->response),
+                             resultPtr->more,
+                             sizeof(resultPtr->more));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the outputs stored by a call to allParameters().
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckResult
+(
+    const CallResult_t* resultPtr
+)
+{
+    int i;
+
+    LE_ASSERT(resultPtr->value == COMMON_TWO);
+    LE_ASSERT(resultPtr->length == OUTPUT_LEN);
+    for (i = 0; i < OUTPUT_LEN; i++)
+    {
+        LE_ASSERT(resultPtr->output[i] == i * COMMON_TWO);
+    }
+    LE_ASSERT(strcmp(resultPtr->response, "response string") == 0);
+    LE_ASSERT(strcmp(resultPtr->more, "more info") == 0);
+}
+
+
+COMPONENT_INIT
+{
+    int i;
+
+    batch_ConnectService();
+
+    LE_INFO("Test queueing calls in several batch messages");
+    batch_StartBatch();
+    for (i = 0; i < NUM_CALLS; i++)
+    {
+        QueueCall(&Results[i]);
+    }
+    batch_EndBatch();
+
+    for (i = 0; i < NUM_CALLS; i++)
+    {
+        CheckResult(&Results[i]);
+    }
+
+    LE_INFO("Test calling a function in the middle of a batch");
+    batch_StartBatch();
+    QueueCall(&Results[0]);
+    batch_TriggerTestA();
+
+    // The queued call must have been sent before TriggerTestA().
+    CheckResult(&Results[0]);
+
+    QueueCall(&Results[1]);
+    batch_EndBatch();
+    CheckResult(&Results[1]);
+
+    LE_INFO("Test an empty batch");
+    batch_StartBatch();
+    batch_EndBatch();
+
+    LE_INFO("Test ending a batch by disconnecting");
+    batch_StartBatch();
+    QueueCall(&Results[2]);
+    batch_DisconnectService();
+    CheckResult(&Results[2]);
+
+    LE_INFO("Batch tests passed");
+
+    exit(EXIT_SUCCESS);
+}
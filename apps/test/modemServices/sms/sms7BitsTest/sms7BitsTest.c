@@ -0,0 +1,569 @@
+/**
+ * Fuzzing and benchmark of the SMS 7 bits codec.
+ *
+ * The packing and unpacking functions are checked against the character at a time implementation
+ * they replace in smsPdu.c, over random septets of random lengths. The GSM 03.38 to ISO-8859-1 and
+ * UCS-2 tables are checked against each other, and the transcoding against a character at a time
+ * conversion.
+ *
+ * With -b, the throughput of both implementations is then measured on 160 septets messages.
+ *
+ * Usage: sms7BitsTest [-n NUM_FUZZ] [-s SEED] [-b NUM_BENCH]
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+#include "legato.h"
+#include "sms7Bits.h"
+
+#define DEFAULT_NUM_FUZZ        20000
+#define MAX_SEPTETS             255
+#define BENCH_SEPTETS           160
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference implementation: read the septet at a bit position, LSB first.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline unsigned int RefRead7Bits
+(
+    const uint8_t* bufferPtr,
+    uint32_t       pos
+)
+{
+    int a = bufferPtr[pos/8] >> (pos&7);
+    int b = 0;
+    if ((pos&7) > 1) {
+        b = bufferPtr[(pos/8)+1] << (8-(pos&7));
+    }
+
+    return (a|b) & 0x7F;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference implementation: write a septet at a bit position, LSB first.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void RefWrite7Bits
+(
+    uint8_t* bufferPtr,
+    uint8_t  val,
+    uint32_t pos
+)
+{
+    val &= 0x7F;
+    uint8_t idx = pos/8;
+
+
+    if (!(pos&7)) {
+        bufferPtr[idx] = val;
+    }
+    else if ((pos&7) == 1) {
+        bufferPtr[idx] = bufferPtr[idx] | (val<<1);
+    }
+    else {
+        bufferPtr[idx] = bufferPtr[idx] | (val<<(pos&7));
+        bufferPtr[idx+1] = (val>>(8-(pos&7)));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference implementation: read the septet at a bit position, MSB first.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline unsigned int RefReadCdma7Bits
+(
+    const uint8_t* bufferPtr,
+    uint32_t       pos
+)
+{
+    uint8_t idx = pos/8;
+
+    return (((bufferPtr[idx]<<(pos&7))&0xFF)|(bufferPtr[idx+1]>>(8-(pos&7))))>>1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference implementation: write a septet at a bit position, MSB first.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void RefWriteCdma7Bits
+(
+    uint8_t* bufferPtr,
+    uint8_t  val,
+    uint32_t pos
+)
+{
+    val &= 0x7F;
+    uint8_t idx = pos/8;
+
+    if (!(pos&7)) {
+        bufferPtr[idx] = val << 1;
+    }
+    else if ((pos&7) == 1) {
+        bufferPtr[idx] = bufferPtr[idx] | val;
+    }
+    else {
+        bufferPtr[idx] = bufferPtr[idx] | (val>>((pos&7)-1));
+        bufferPtr[idx+1] = ((val<<(8-((pos&7)-1)))&0xff);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference implementation of the packing, as done by smsPdu.c.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RefPack
+(
+    const uint8_t* septetsPtr,
+    size_t         numSeptets,
+    uint8_t*       bytesPtr,
+    bool           isCdma
+)
+{
+    size_t i;
+
+    for (i = 0; i < numSeptets; i++)
+    {
+        if (isCdma)
+        {
+            RefWriteCdma7Bits(bytesPtr, septetsPtr[i], i*7);
+        }
+        else
+        {
+            RefWrite7Bits(bytesPtr, septetsPtr[i], i*7);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference implementation of the unpacking, as done by smsPdu.c.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RefUnpack
+(
+    const uint8_t* bytesPtr,
+    size_t         numSeptets,
+    uint8_t*       septetsPtr,
+    bool           isCdma
+)
+{
+    size_t i;
+
+    for (i = 0; i < numSeptets; i++)
+    {
+        septetsPtr[i] = isCdma ? RefReadCdma7Bits(bytesPtr, i*7) : RefRead7Bits(bytesPtr, i*7);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill a buffer with random bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RandomFill
+(
+    uint8_t* bufPtr,
+    size_t   size
+)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        bufPtr[i] = rand();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the packing and unpacking of random septets against the reference implementation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FuzzPacking
+(
+    bool isCdma
+)
+{
+    uint8_t septets[MAX_SEPTETS];
+    uint8_t refSeptets[MAX_SEPTETS];
+    uint8_t newSeptets[MAX_SEPTETS];
+    // The reference implementation reads and writes one byte past the packed septets.
+    uint8_t refBytes[SMS7BITS_PACKED_SIZE(MAX_SEPTETS) + 1];
+    uint8_t newBytes[SMS7BITS_PACKED_SIZE(MAX_SEPTETS) + 1];
+    size_t numSeptets = rand() % (MAX_SEPTETS + 1);
+    size_t numBytes = SMS7BITS_PACKED_SIZE(numSeptets);
+    size_t i;
+
+    // The 8th bit must be ignored.
+    RandomFill(septets, numSeptets);
+
+    memset(refBytes, 0, sizeof(refBytes));
+    RefPack(septets, numSeptets, refBytes, isCdma);
+
+    // The new implementation must write exactly numBytes bytes.
+    memset(newBytes, 0xA5, sizeof(newBytes));
+    LE_ASSERT((isCdma ? sms7Bits_PackCdma(septets, numSeptets, newBytes)
+                      : sms7Bits_Pack(septets, numSeptets, newBytes)) == numBytes);
+    LE_ASSERT(memcmp(refBytes, newBytes, numBytes) == 0);
+    LE_ASSERT(newBytes[numBytes] == 0xA5);
+
+    // Unpack random bytes, the padding bits being random too.
+    RandomFill(refBytes, numBytes);
+    refBytes[numBytes] = 0;
+    memcpy(newBytes, refBytes, numBytes);
+
+    RefUnpack(refBytes, numSeptets, refSeptets, isCdma);
+    if (isCdma)
+    {
+        sms7Bits_UnpackCdma(newBytes, numSeptets, newSeptets);
+    }
+    else
+    {
+        sms7Bits_Unpack(newBytes, numSeptets, newSeptets);
+    }
+    LE_ASSERT(memcmp(refSeptets, newSeptets, numSeptets) == 0);
+
+    // Round trip
+    if (isCdma)
+    {
+        sms7Bits_PackCdma(septets, numSeptets, newBytes);
+        sms7Bits_UnpackCdma(newBytes, numSeptets, newSeptets);
+    }
+    else
+    {
+        sms7Bits_Pack(septets, numSeptets, newBytes);
+        sms7Bits_Unpack(newBytes, numSeptets, newSeptets);
+    }
+    for (i = 0; i < numSeptets; i++)
+    {
+        LE_ASSERT(newSeptets[i] == (septets[i] & 0x7F));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the ISO-8859-1 and UCS-2 tables agree on every septet, and that the UCS-2 tables
+ * are a bijection.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckTables
+(
+    void
+)
+{
+    uint8_t septets[2];
+    uint8_t latin1;
+    uint16_t ucs2;
+    uint8_t backSeptets[2];
+    int septet;
+    int ext;
+    int numMapped = 0;
+
+    for (septet = 0; septet < 128; septet++)
+    {
+        if (27 == septet)
+        {
+            continue;
+        }
+
+        septets[0] = septet;
+        LE_ASSERT(sms7Bits_ToLatin1(septets, 1, &latin1, 1) == 1);
+        LE_ASSERT(sms7Bits_ToUcs2(septets, 1, &ucs2, 1) == 1);
+        LE_ASSERT(latin1 == ((ucs2 < 0x100) ? ucs2 : '?'));
+
+        LE_ASSERT(sms7Bits_FromUcs2(&ucs2, 1, backSeptets, 2) == 1);
+        LE_ASSERT(backSeptets[0] == septet);
+
+        // ISO-8859-1 characters are converted back to the same septet.
+        if (ucs2 < 0x100)
+        {
+            LE_ASSERT(sms7Bits_FromLatin1(&latin1, 1, backSeptets, 2) == 1);
+            LE_ASSERT(backSeptets[0] == septet);
+        }
+    }
+
+    for (ext = 0; ext < 128; ext++)
+    {
+        septets[0] = 27;
+        septets[1] = ext;
+        LE_ASSERT(sms7Bits_ToLatin1(septets, 2, &latin1, 1) == 1);
+        LE_ASSERT(sms7Bits_ToUcs2(septets, 2, &ucs2, 1) == 1);
+
+        if ('?' == ucs2)
+        {
+            LE_ASSERT('?' == latin1);
+            continue;
+        }
+
+        numMapped++;
+        LE_ASSERT(latin1 == ((ucs2 < 0x100) ? ucs2 : '?'));
+
+        LE_ASSERT(sms7Bits_FromUcs2(&ucs2, 1, backSeptets, 2) == 2);
+        LE_ASSERT(backSeptets[0] == 27 && backSeptets[1] == ext);
+    }
+
+    // FORM FEED ^ { } \ [ ~ ] | and the euro sign
+    LE_ASSERT(10 == numMapped);
+
+    // A trailing escape is replaced by a question mark.
+    septets[0] = 27;
+    LE_ASSERT(sms7Bits_ToLatin1(septets, 1, &latin1, 1) == 1);
+    LE_ASSERT('?' == latin1);
+    LE_ASSERT(sms7Bits_ToUcs2(septets, 1, &ucs2, 1) == 1);
+    LE_ASSERT('?' == ucs2);
+
+    // Characters without equivalent
+    ucs2 = 0x4E2D;
+    LE_ASSERT(sms7Bits_FromUcs2(&ucs2, 1, backSeptets, 2) == 1);
+    LE_ASSERT(63 == backSeptets[0]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the transcoding of random text against a character at a time transcoding, and the
+ * overflow detection.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FuzzTranscoding
+(
+    void
+)
+{
+    uint8_t text[MAX_SEPTETS];
+    uint8_t septets[2 * MAX_SEPTETS];
+    uint8_t backSeptets[2 * MAX_SEPTETS];
+    uint8_t charSeptets[2];
+    uint8_t latin1[MAX_SEPTETS];
+    uint8_t backLatin1[MAX_SEPTETS];
+    uint16_t ucs2[MAX_SEPTETS];
+    size_t length = rand() % (MAX_SEPTETS + 1);
+    int32_t numSeptets;
+    int32_t numBackSeptets;
+    int32_t numChars;
+    int32_t pos = 0;
+    size_t i;
+
+    RandomFill(text, length);
+
+    numSeptets = sms7Bits_FromLatin1(text, length, septets, sizeof(septets));
+    LE_ASSERT(numSeptets >= length);
+
+    for (i = 0; i < length; i++)
+    {
+        int32_t charLen = sms7Bits_FromLatin1(&text[i], 1, charSeptets, sizeof(charSeptets));
+
+        LE_ASSERT(memcmp(&septets[pos], charSeptets, charLen) == 0);
+        pos += charLen;
+    }
+    LE_ASSERT(pos == numSeptets);
+
+    // The septets buffer is one septet too small.
+    if (numSeptets)
+    {
+        LE_ASSERT(sms7Bits_FromLatin1(text, length, septets, numSeptets - 1) == LE_OVERFLOW);
+    }
+
+    numChars = sms7Bits_ToLatin1(septets, numSeptets, latin1, sizeof(latin1));
+    LE_ASSERT(numChars == length);
+    LE_ASSERT(sms7Bits_ToUcs2(septets, numSeptets, ucs2, NUM_ARRAY_MEMBERS(ucs2)) == length);
+
+    for (i = 0; i < length; i++)
+    {
+        LE_ASSERT(latin1[i] == ((ucs2[i] < 0x100) ? ucs2[i] : '?'));
+    }
+
+    // Characters without GSM equivalent are replaced by a look-alike or a question mark, which
+    // both round trip.
+    numBackSeptets = sms7Bits_FromLatin1(latin1, length, backSeptets, sizeof(backSeptets));
+    LE_ASSERT(sms7Bits_ToLatin1(backSeptets, numBackSeptets, backLatin1, sizeof(backLatin1)) == length);
+    LE_ASSERT(memcmp(latin1, backLatin1, length) == 0);
+
+    if (length)
+    {
+        LE_ASSERT(sms7Bits_ToLatin1(septets, numSeptets, latin1, length - 1) == LE_OVERFLOW);
+        LE_ASSERT(sms7Bits_ToUcs2(septets, numSeptets, ucs2, length - 1) == LE_OVERFLOW);
+    }
+
+    // UCS-2 text goes through the same septets.
+    LE_ASSERT(sms7Bits_FromUcs2(ucs2, length, septets, sizeof(septets)) >= length);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a start time, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetElapsedUsec
+(
+    le_clk_Time_t start
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return elapsed.sec * 1e6 + elapsed.usec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the time taken per message and the throughput in septets.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintResult
+(
+    const char* namePtr,
+    int numMsgs,
+    double elapsedUsec
+)
+{
+    printf("%-24s %d messages: %.3f us/message, %.1f Mseptets/s\n", namePtr, numMsgs,
+           elapsedUsec / numMsgs, (double)numMsgs * BENCH_SEPTETS / elapsedUsec);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the packing and unpacking of 160 septets messages with both implementations.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Benchmark
+(
+    int numMsgs
+)
+{
+    uint8_t septets[BENCH_SEPTETS];
+    uint8_t bytes[SMS7BITS_PACKED_SIZE(BENCH_SEPTETS) + 1];
+    uint8_t text[BENCH_SEPTETS];
+    uint8_t check = 0;
+    le_clk_Time_t start;
+    int i;
+    int cdma;
+
+    // Characters of the default alphabet, one septet each
+    static const char Alphabet[] =
+        " abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789.,:;!?'\"()+-*/=<>";
+
+    for (i = 0; i < BENCH_SEPTETS; i++)
+    {
+        text[i] = Alphabet[rand() % (sizeof(Alphabet) - 1)];
+    }
+    LE_ASSERT(sms7Bits_FromLatin1(text, sizeof(text), septets, sizeof(septets)) == BENCH_SEPTETS);
+
+    for (cdma = 0; cdma <= 1; cdma++)
+    {
+        printf("%s:\n", cdma ? "CDMA" : "GSM");
+
+        start = le_clk_GetRelativeTime();
+        for (i = 0; i < numMsgs; i++)
+        {
+            memset(bytes, 0, sizeof(bytes));
+            RefPack(septets, BENCH_SEPTETS, bytes, cdma);
+            check ^= bytes[i % sizeof(bytes)];
+        }
+        PrintResult("Reference pack", numMsgs, GetElapsedUsec(start));
+
+        start = le_clk_GetRelativeTime();
+        for (i = 0; i < numMsgs; i++)
+        {
+            memset(bytes, 0, sizeof(bytes));
+            if (cdma)
+            {
+                sms7Bits_PackCdma(septets, BENCH_SEPTETS, bytes);
+            }
+            else
+            {
+                sms7Bits_Pack(septets, BENCH_SEPTETS, bytes);
+            }
+            check ^= bytes[i % sizeof(bytes)];
+        }
+        PrintResult("Word at a time pack", numMsgs, GetElapsedUsec(start));
+
+        start = le_clk_GetRelativeTime();
+        for (i = 0; i < numMsgs; i++)
+        {
+            RefUnpack(bytes, BENCH_SEPTETS, septets, cdma);
+            check ^= septets[i % sizeof(septets)];
+        }
+        PrintResult("Reference unpack", numMsgs, GetElapsedUsec(start));
+
+        start = le_clk_GetRelativeTime();
+        for (i = 0; i < numMsgs; i++)
+        {
+            if (cdma)
+            {
+                sms7Bits_UnpackCdma(bytes, BENCH_SEPTETS, septets);
+            }
+            else
+            {
+                sms7Bits_Unpack(bytes, BENCH_SEPTETS, septets);
+            }
+            check ^= septets[i % sizeof(septets)];
+        }
+        PrintResult("Word at a time unpack", numMsgs, GetElapsedUsec(start));
+    }
+
+    printf("Transcoding:\n");
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < numMsgs; i++)
+    {
+        int32_t numSeptets = sms7Bits_FromLatin1(text, sizeof(text), septets, sizeof(septets));
+        sms7Bits_Pack(septets, numSeptets, bytes);
+        check ^= bytes[i % sizeof(bytes)];
+    }
+    PrintResult("ISO-8859-1 to PDU", numMsgs, GetElapsedUsec(start));
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < numMsgs; i++)
+    {
+        sms7Bits_Unpack(bytes, BENCH_SEPTETS, septets);
+        sms7Bits_ToLatin1(septets, BENCH_SEPTETS, text, sizeof(text));
+        check ^= text[i % sizeof(text)];
+    }
+    PrintResult("PDU to ISO-8859-1", numMsgs, GetElapsedUsec(start));
+
+    // Keep the results alive.
+    LE_DEBUG("check %u", check);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs the fuzzing, then the benchmark if requested.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    int numFuzz = DEFAULT_NUM_FUZZ;
+    int seed = time(NULL);
+    int numBench = 0;
+    int i;
+
+    le_arg_SetIntVar(&numFuzz, "n", "fuzz");
+    le_arg_SetIntVar(&seed, "s", "seed");
+    le_arg_SetIntVar(&numBench, "b", "bench");
+    le_arg_Scan();
+
+    LE_INFO("Fuzzing %d times with seed %d", numFuzz, seed);
+    srand(seed);
+
+    CheckTables();
+
+    for (i = 0; i < numFuzz; i++)
+    {
+        FuzzPacking(false);
+        FuzzPacking(true);
+        FuzzTranscoding();
+    }
+
+    LE_INFO("======== SMS 7 bits fuzzing ends with SUCCESS ========");
+
+    if (numBench > 0)
+    {
+        Benchmark(numBench);
+    }
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,771 @@
+/**
+ * Fuzzing and benchmark of the reassembly of concatenated SMS messages.
+ *
+ * Streams of concatenated messages from several senders, with 8 and 16 bits references, are
+ * interleaved and their parts shuffled before being added to the reassembly table. Each message
+ * must be delivered once, with its parts in order. Duplicated parts, messages too long or with too
+ * many parts, a full table and the eviction timeout are checked as well, together with the
+ * release of all the pending parts.
+ *
+ * With -b, the throughput of the reassembly is then measured on interleaved 4 parts messages,
+ * together with the memory taken by the reassembly table.
+ *
+ * Usage: smsConcatTest [-n NUM_FUZZ] [-s SEED] [-b NUM_BENCH]
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+#include "legato.h"
+#include "smsConcat.h"
+
+#define DEFAULT_NUM_FUZZ        2000
+#define TIMEOUT                 1       // Eviction timeout, in seconds
+#define MAX_SENDERS             4
+#define MAX_DELIVERED           (SMSCONCAT_MAX_PENDING_PARTS + LE_SMS_CONCAT_MAX_PARTS)
+#define BENCH_PARTS             4
+#define BENCH_INTERLEAVED_MSGS  8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message to send as parts.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int                 sender;                                 ///< Index of the sender
+    uint16_t            ref;                                    ///< Reference number
+    bool                ref16Bits;                              ///< 16 bits reference number
+    uint8_t             maxNum;                                 ///< Number of parts
+    le_sms_Format_t     format;                                 ///< User data format
+    pa_sms_SmsDeliver_t part[LE_SMS_CONCAT_MAX_PARTS];          ///< Decoded parts
+    uint32_t            dataLen;                                ///< Expected user data length
+    uint8_t             data[LE_SMS_CONCAT_TEXT_MAX_BYTES];     ///< Expected user data
+    int                 numDelivered;                           ///< Number of deliveries
+}
+TestMsg_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Part of a message, in the order of the stream.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    TestMsg_t* msgPtr;  ///< Message of the part
+    int        seqNum;  ///< Sequence number of the part
+}
+StreamPart_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delivered messages, not released yet.
+ */
+//--------------------------------------------------------------------------------------------------
+static smsConcat_Msg_t* Delivered[MAX_DELIVERED];
+static int NumDelivered;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the delivered messages instead of keeping them (benchmark).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReleaseDelivered;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Storage index of the next part.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t NextStorageIdx;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message waiting for the eviction timeout, and the time its last part was added.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WaitTimeout;
+static TestMsg_t TimeoutMsg;
+static le_clk_Time_t TimeoutStart;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Senders.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* Senders[MAX_SENDERS] =
+{
+    "+33612345678", "+33687654321", "+4915112345678", "Orange"
+};
+
+static void TimeoutMsgHandler(smsConcat_Msg_t* msgPtr);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the delivered messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MsgHandler
+(
+    smsConcat_Msg_t* msgPtr
+)
+{
+    if (WaitTimeout)
+    {
+        TimeoutMsgHandler(msgPtr);
+        return;
+    }
+
+    if (ReleaseDelivered)
+    {
+        NumDelivered++;
+        le_mem_Release(msgPtr);
+        return;
+    }
+
+    LE_ASSERT(NumDelivered < MAX_DELIVERED);
+    Delivered[NumDelivered++] = msgPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the delivered messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseAllDelivered
+(
+    void
+)
+{
+    int i;
+
+    for (i = 0; i < NumDelivered; i++)
+    {
+        le_mem_Release(Delivered[i]);
+    }
+    NumDelivered = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the number of objects in use in a pool of the reassembly table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckPoolInUse
+(
+    const char* poolNamePtr,
+    size_t      numInUse
+)
+{
+    le_mem_PoolRef_t pool = le_mem_FindPool(poolNamePtr);
+    le_mem_PoolStats_t stats;
+
+    LE_ASSERT(pool);
+    le_mem_GetStats(pool, &stats);
+    LE_ASSERT(stats.numBlocksInUse == numInUse);
+    LE_ASSERT(stats.numOverflows == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the reassembly table is empty, and all the messages released.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckEmpty
+(
+    void
+)
+{
+    CheckPoolInUse("SmsConcatPendingPool", 0);
+    CheckPoolInUse("SmsConcatPartPool", 0);
+
+    le_mem_PoolStats_t stats;
+    le_mem_GetStats(le_mem_FindPool("SmsConcatMsgPool"), &stats);
+    LE_ASSERT(stats.numBlocksInUse == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build a message and its parts, with random user data of the given length per part.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildMsg
+(
+    TestMsg_t*      msgPtr,
+    int             sender,
+    uint16_t        ref,
+    bool            ref16Bits,
+    uint8_t         maxNum,
+    le_sms_Format_t format,
+    uint32_t        partLen     ///< 0 for a random length
+)
+{
+    int i;
+
+    memset(msgPtr, 0, sizeof(TestMsg_t));
+    msgPtr->sender = sender;
+    msgPtr->ref = ref;
+    msgPtr->ref16Bits = ref16Bits;
+    msgPtr->maxNum = maxNum;
+    msgPtr->format = format;
+
+    for (i = 0; i < maxNum; i++)
+    {
+        pa_sms_SmsDeliver_t* partPtr = &msgPtr->part[i];
+        uint32_t maxLen = (LE_SMS_FORMAT_TEXT == format) ? 153 : 134;
+        uint32_t len = partLen ? partLen : 1 + rand() % maxLen;
+        uint32_t j;
+
+        if (LE_SMS_FORMAT_UCS2 == format)
+        {
+            len &= ~1;
+            len = len ? len : 2;
+        }
+
+        partPtr->option = PA_SMS_OPTIONMASK_OA | PA_SMS_OPTIONMASK_SCTS | PA_SMS_OPTIONMASK_CONCAT;
+        partPtr->status = LE_SMS_RX_UNREAD;
+        le_utf8_Copy(partPtr->oa, Senders[sender], sizeof(partPtr->oa), NULL);
+        snprintf(partPtr->scts, sizeof(partPtr->scts), "17/10/26,10:%02u:%02u+08",
+                 (unsigned int)(i % 60), (unsigned int)(sender % 60));
+        partPtr->format = format;
+        partPtr->dataLen = len;
+        for (j = 0; j < len; j++)
+        {
+            partPtr->data[j] = (LE_SMS_FORMAT_TEXT == format) ? 'A' + rand() % 26 : rand();
+        }
+        partPtr->concat.ref = ref;
+        partPtr->concat.ref16Bits = ref16Bits;
+        partPtr->concat.maxNum = maxNum;
+        partPtr->concat.seqNum = i + 1;
+
+        if (msgPtr->dataLen + len < sizeof(msgPtr->data))
+        {
+            memcpy(msgPtr->data + msgPtr->dataLen, partPtr->data, len);
+        }
+        msgPtr->dataLen += len;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a part of a message to the reassembly table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddPart
+(
+    TestMsg_t* msgPtr,
+    int        seqNum
+)
+{
+    smsConcat_AddPart(&msgPtr->part[seqNum - 1], PA_SMS_STORAGE_SIM, NextStorageIdx++);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a delivered message is the given reassembled message.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckReassembled
+(
+    const smsConcat_Msg_t* deliveredPtr,
+    const TestMsg_t*       msgPtr
+)
+{
+    LE_ASSERT(0 == strcmp(deliveredPtr->oa, Senders[msgPtr->sender]));
+    LE_ASSERT(0 == strcmp(deliveredPtr->scts, msgPtr->part[0].scts));
+    LE_ASSERT(deliveredPtr->format == msgPtr->format);
+    LE_ASSERT(deliveredPtr->numParts == msgPtr->maxNum);
+    LE_ASSERT(deliveredPtr->dataLen == msgPtr->dataLen);
+    LE_ASSERT(0 == memcmp(deliveredPtr->data, msgPtr->data, msgPtr->dataLen));
+    LE_ASSERT('\0' == deliveredPtr->data[deliveredPtr->dataLen]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a delivered message is the given part of a message.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckSinglePart
+(
+    const smsConcat_Msg_t* deliveredPtr,
+    const TestMsg_t*       msgPtr,
+    int                    seqNum
+)
+{
+    const pa_sms_SmsDeliver_t* partPtr = &msgPtr->part[seqNum - 1];
+
+    LE_ASSERT(0 == strcmp(deliveredPtr->oa, Senders[msgPtr->sender]));
+    LE_ASSERT(0 == strcmp(deliveredPtr->scts, partPtr->scts));
+    LE_ASSERT(deliveredPtr->format == msgPtr->format);
+    LE_ASSERT(1 == deliveredPtr->numParts);
+    LE_ASSERT(deliveredPtr->dataLen == partPtr->dataLen);
+    LE_ASSERT(0 == memcmp(deliveredPtr->data, partPtr->data, partPtr->dataLen));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Shuffle the parts of a stream.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Shuffle
+(
+    StreamPart_t* streamPtr,
+    int           numParts
+)
+{
+    int i;
+
+    for (i = numParts - 1; i > 0; i--)
+    {
+        int j = rand() % (i + 1);
+        StreamPart_t tmp = streamPtr[i];
+        streamPtr[i] = streamPtr[j];
+        streamPtr[j] = tmp;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Interleave messages of random senders, references, formats and number of parts, which fit in
+ * the reassembly table, and shuffle their parts. Each message must be reassembled once.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FuzzInterleaved
+(
+    void
+)
+{
+    static TestMsg_t msgs[SMSCONCAT_MAX_PENDING_MSGS];
+    static const le_sms_Format_t formats[] =
+    {
+        LE_SMS_FORMAT_TEXT, LE_SMS_FORMAT_BINARY, LE_SMS_FORMAT_UCS2
+    };
+    StreamPart_t stream[SMSCONCAT_MAX_PENDING_PARTS];
+    int numMsgs = 1 + rand() % SMSCONCAT_MAX_PENDING_MSGS;
+    int numParts = 0;
+    int i, j;
+
+    for (i = 0; i < numMsgs; i++)
+    {
+        uint8_t maxNum = 2 + rand() % (LE_SMS_CONCAT_MAX_PARTS - 1);
+        bool ref16Bits = rand() % 2;
+
+        if (numParts + maxNum > SMSCONCAT_MAX_PENDING_PARTS)
+        {
+            numMsgs = i;
+            break;
+        }
+
+        // Messages differing only by their reference size, sender or format are different
+        // messages: use a small reference range to get such collisions. Identical keys are avoided
+        // as they are the same message.
+        for (;;)
+        {
+            uint16_t ref = rand() % 4;
+            int sender = rand() % MAX_SENDERS;
+            le_sms_Format_t format = formats[rand() % NUM_ARRAY_MEMBERS(formats)];
+
+            for (j = 0; j < i; j++)
+            {
+                if ((msgs[j].ref == ref) && (msgs[j].ref16Bits == ref16Bits) &&
+                    (msgs[j].sender == sender) && (msgs[j].format == format) &&
+                    (msgs[j].maxNum == maxNum))
+                {
+                    break;
+                }
+            }
+            if (j == i)
+            {
+                BuildMsg(&msgs[i], sender, ref, ref16Bits, maxNum, format, 0);
+                break;
+            }
+        }
+
+        for (j = 1; j <= maxNum; j++)
+        {
+            stream[numParts].msgPtr = &msgs[i];
+            stream[numParts].seqNum = j;
+            numParts++;
+        }
+    }
+
+    Shuffle(stream, numParts);
+
+    for (i = 0; i < numParts; i++)
+    {
+        AddPart(stream[i].msgPtr, stream[i].seqNum);
+    }
+
+    LE_ASSERT(NumDelivered == numMsgs);
+    for (i = 0; i < NumDelivered; i++)
+    {
+        // Find the message from its sender, reference, and length
+        for (j = 0; j < numMsgs; j++)
+        {
+            if ((0 == strcmp(Delivered[i]->oa, Senders[msgs[j].sender])) &&
+                (Delivered[i]->format == msgs[j].format) &&
+                (Delivered[i]->numParts == msgs[j].maxNum) &&
+                (Delivered[i]->dataLen == msgs[j].dataLen) &&
+                (0 == memcmp(Delivered[i]->data, msgs[j].data, msgs[j].dataLen)))
+            {
+                break;
+            }
+        }
+        LE_ASSERT(j < numMsgs);
+        CheckReassembled(Delivered[i], &msgs[j]);
+        msgs[j].numDelivered++;
+    }
+    for (j = 0; j < numMsgs; j++)
+    {
+        LE_ASSERT(1 == msgs[j].numDelivered);
+    }
+
+    ReleaseAllDelivered();
+    CheckEmpty();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the storage of the parts of a reassembled message, and the delivery of the parts of
+ * messages which can't be reassembled.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestBounds
+(
+    void
+)
+{
+    static TestMsg_t msg;
+    int i;
+
+    // Storage of the parts, in order
+    BuildMsg(&msg, 0, 0x1234, true, 3, LE_SMS_FORMAT_TEXT, 0);
+    NextStorageIdx = 10;
+    AddPart(&msg, 3);
+    AddPart(&msg, 1);
+    AddPart(&msg, 2);
+    LE_ASSERT(1 == NumDelivered);
+    CheckReassembled(Delivered[0], &msg);
+    LE_ASSERT(11 == Delivered[0]->part[0].storageIdx);
+    LE_ASSERT(12 == Delivered[0]->part[1].storageIdx);
+    LE_ASSERT(10 == Delivered[0]->part[2].storageIdx);
+    LE_ASSERT(PA_SMS_STORAGE_SIM == Delivered[0]->part[0].storage);
+    ReleaseAllDelivered();
+    CheckEmpty();
+
+    // A single part message
+    BuildMsg(&msg, 1, 7, false, 1, LE_SMS_FORMAT_BINARY, 0);
+    AddPart(&msg, 1);
+    LE_ASSERT(1 == NumDelivered);
+    CheckReassembled(Delivered[0], &msg);
+    ReleaseAllDelivered();
+    CheckEmpty();
+
+    // Too many parts: delivered at once
+    msg.part[0].concat.maxNum = LE_SMS_CONCAT_MAX_PARTS + 1;
+    AddPart(&msg, 1);
+    LE_ASSERT(1 == NumDelivered);
+    CheckSinglePart(Delivered[0], &msg, 1);
+    ReleaseAllDelivered();
+    CheckEmpty();
+
+    // Invalid sequence number: delivered at once
+    BuildMsg(&msg, 1, 8, false, 2, LE_SMS_FORMAT_BINARY, 0);
+    msg.part[1].concat.seqNum = 3;
+    AddPart(&msg, 2);
+    LE_ASSERT(1 == NumDelivered);
+    CheckSinglePart(Delivered[0], &msg, 2);
+    ReleaseAllDelivered();
+    CheckEmpty();
+
+    // Too long once reassembled: the parts are delivered one by one
+    BuildMsg(&msg, 2, 9, false, LE_SMS_CONCAT_MAX_PARTS, LE_SMS_FORMAT_TEXT, 160);
+    for (i = 1; i <= LE_SMS_CONCAT_MAX_PARTS; i++)
+    {
+        AddPart(&msg, i);
+    }
+    LE_ASSERT(LE_SMS_CONCAT_MAX_PARTS == NumDelivered);
+    for (i = 0; i < NumDelivered; i++)
+    {
+        CheckSinglePart(Delivered[i], &msg, i + 1);
+    }
+    ReleaseAllDelivered();
+    CheckEmpty();
+
+    // Duplicated part: the pending part is delivered, and a new message started
+    BuildMsg(&msg, 3, 10, false, 2, LE_SMS_FORMAT_TEXT, 0);
+    AddPart(&msg, 1);
+    AddPart(&msg, 1);
+    LE_ASSERT(1 == NumDelivered);
+    CheckSinglePart(Delivered[0], &msg, 1);
+    AddPart(&msg, 2);
+    LE_ASSERT(2 == NumDelivered);
+    CheckReassembled(Delivered[1], &msg);
+    ReleaseAllDelivered();
+    CheckEmpty();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill the reassembly table: the least recently updated messages are evicted first.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestTableFull
+(
+    void
+)
+{
+    static TestMsg_t msgs[SMSCONCAT_MAX_PENDING_MSGS + 2];
+    int i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(msgs); i++)
+    {
+        BuildMsg(&msgs[i], i % MAX_SENDERS, i, false, 3, LE_SMS_FORMAT_TEXT, 0);
+        AddPart(&msgs[i], 1);
+        CheckPoolInUse("SmsConcatPendingPool",
+                       (i < SMSCONCAT_MAX_PENDING_MSGS) ? i + 1 : SMSCONCAT_MAX_PENDING_MSGS);
+
+        // Update the first message, so that it is evicted after the second one
+        if (1 == i)
+        {
+            AddPart(&msgs[0], 2);
+        }
+    }
+
+    // Second message, then first one
+    LE_ASSERT(3 == NumDelivered);
+    CheckSinglePart(Delivered[0], &msgs[1], 1);
+    CheckSinglePart(Delivered[1], &msgs[0], 1);
+    CheckSinglePart(Delivered[2], &msgs[0], 2);
+    ReleaseAllDelivered();
+
+    // The pending messages are still reassembled
+    AddPart(&msgs[NUM_ARRAY_MEMBERS(msgs) - 1], 3);
+    AddPart(&msgs[NUM_ARRAY_MEMBERS(msgs) - 1], 2);
+    LE_ASSERT(1 == NumDelivered);
+    CheckReassembled(Delivered[0], &msgs[NUM_ARRAY_MEMBERS(msgs) - 1]);
+    ReleaseAllDelivered();
+
+    smsConcat_Flush();
+    LE_ASSERT(SMSCONCAT_MAX_PENDING_MSGS - 1 == NumDelivered);
+    ReleaseAllDelivered();
+    CheckEmpty();
+
+    // Too many pending parts: the least recently updated messages are evicted
+    for (i = 0; i < SMSCONCAT_MAX_PENDING_PARTS / (LE_SMS_CONCAT_MAX_PARTS - 1) + 1; i++)
+    {
+        int j;
+
+        BuildMsg(&msgs[i], i % MAX_SENDERS, i, true, LE_SMS_CONCAT_MAX_PARTS,
+                 LE_SMS_FORMAT_BINARY, 0);
+        for (j = 1; j < LE_SMS_CONCAT_MAX_PARTS; j++)
+        {
+            AddPart(&msgs[i], j);
+        }
+    }
+    LE_ASSERT(LE_SMS_CONCAT_MAX_PARTS - 1 == NumDelivered);
+    for (i = 0; i < NumDelivered; i++)
+    {
+        CheckSinglePart(Delivered[i], &msgs[0], i + 1);
+    }
+    ReleaseAllDelivered();
+
+    smsConcat_Flush();
+    ReleaseAllDelivered();
+    CheckEmpty();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a start time, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetElapsedUsec
+(
+    le_clk_Time_t start
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return elapsed.sec * 1e6 + elapsed.usec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the memory taken by a pool of the reassembly table.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t PrintPool
+(
+    const char* poolNamePtr
+)
+{
+    le_mem_PoolRef_t pool = le_mem_FindPool(poolNamePtr);
+    le_mem_PoolStats_t stats;
+    size_t size = le_mem_GetObjectFullSize(pool) * le_mem_GetObjectCount(pool);
+
+    le_mem_GetStats(pool, &stats);
+    printf("%-24s %zu objects of %zu bytes, %zu max used, %zu bytes\n", poolNamePtr,
+           le_mem_GetObjectCount(pool), le_mem_GetObjectFullSize(pool), stats.maxNumBlocksUsed,
+           size);
+
+    return size;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the reassembly of interleaved messages of 4 text parts of 153 characters.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Benchmark
+(
+    int numMsgs
+)
+{
+    static TestMsg_t msgs[BENCH_INTERLEAVED_MSGS];
+    StreamPart_t stream[BENCH_INTERLEAVED_MSGS * BENCH_PARTS];
+    double elapsedUsec = 0;
+    int numParts = 0;
+    int i, j;
+
+    for (i = 0; i < BENCH_INTERLEAVED_MSGS; i++)
+    {
+        BuildMsg(&msgs[i], i % MAX_SENDERS, i, false, BENCH_PARTS, LE_SMS_FORMAT_TEXT, 153);
+        for (j = 1; j <= BENCH_PARTS; j++)
+        {
+            stream[i * BENCH_PARTS + j - 1].msgPtr = &msgs[i];
+            stream[i * BENCH_PARTS + j - 1].seqNum = j;
+        }
+    }
+
+    ReleaseDelivered = true;
+    NumDelivered = 0;
+
+    for (i = 0; i < numMsgs; i += BENCH_INTERLEAVED_MSGS)
+    {
+        Shuffle(stream, NUM_ARRAY_MEMBERS(stream));
+
+        le_clk_Time_t start = le_clk_GetRelativeTime();
+        for (j = 0; j < NUM_ARRAY_MEMBERS(stream); j++)
+        {
+            AddPart(stream[j].msgPtr, stream[j].seqNum);
+        }
+        elapsedUsec += GetElapsedUsec(start);
+        numParts += NUM_ARRAY_MEMBERS(stream);
+    }
+
+    ReleaseDelivered = false;
+
+    printf("Reassembly: %d parts, %d messages delivered: %.3f us/part, %.0f messages/s\n",
+           numParts, NumDelivered, elapsedUsec / numParts, NumDelivered * 1e6 / elapsedUsec);
+    printf("Handler calls per message: %.2f (%d without reassembly)\n",
+           (double)NumDelivered / (numParts / BENCH_PARTS), BENCH_PARTS);
+
+    size_t size = PrintPool("SmsConcatPendingPool");
+    size += PrintPool("SmsConcatPartPool");
+    printf("Reassembly table: %zu bytes\n", size);
+    PrintPool("SmsConcatMsgPool");
+
+    NumDelivered = 0;
+    CheckEmpty();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the evicted message is released, and end the test.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndTest
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    CheckEmpty();
+
+    LE_INFO("======== SMS concatenation test ends with SUCCESS ========");
+    exit(EXIT_SUCCESS);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the message evicted at timeout.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TimeoutMsgHandler
+(
+    smsConcat_Msg_t* msgPtr
+)
+{
+    double elapsedUsec = GetElapsedUsec(TimeoutStart);
+
+    LE_INFO("Message evicted after %.3f s", elapsedUsec / 1e6);
+    LE_ASSERT(elapsedUsec >= TIMEOUT * 1e6);
+
+    CheckSinglePart(msgPtr, &TimeoutMsg, 2);
+    le_mem_Release(msgPtr);
+
+    // The pending message is released once its parts are delivered
+    le_event_QueueFunction(EndTest, NULL, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The message wasn't evicted in time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TimeoutFailureHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    LE_FATAL("Message not evicted");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs the fuzzing, then the benchmark if requested, then waits for the eviction of a message.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    int numFuzz = DEFAULT_NUM_FUZZ;
+    int seed = time(NULL);
+    int numBench = 0;
+    int i;
+
+    le_arg_SetIntVar(&numFuzz, "n", "fuzz");
+    le_arg_SetIntVar(&seed, "s", "seed");
+    le_arg_SetIntVar(&numBench, "b", "bench");
+    le_arg_Scan();
+
+    LE_INFO("Fuzzing %d times with seed %d", numFuzz, seed);
+    srand(seed);
+
+    smsConcat_Init(TIMEOUT, MsgHandler);
+
+    TestBounds();
+    TestTableFull();
+
+    for (i = 0; i < numFuzz; i++)
+    {
+        FuzzInterleaved();
+    }
+
+    if (numBench > 0)
+    {
+        Benchmark(numBench);
+    }
+
+    // The eviction timer runs in the event loop: the second part of the message is delivered
+    // once the timeout expires.
+    BuildMsg(&TimeoutMsg, 0, 0xABCD, true, 2, LE_SMS_FORMAT_UCS2, 0);
+    WaitTimeout = true;
+    TimeoutStart = le_clk_GetRelativeTime();
+    AddPart(&TimeoutMsg, 2);
+
+    le_timer_Ref_t timerRef = le_timer_Create("TimeoutFailure");
+    le_clk_Time_t interval = { .sec = TIMEOUT + 2, .usec = 0 };
+    le_timer_SetInterval(timerRef, interval);
+    le_timer_SetHandler(timerRef, TimeoutFailureHandler);
+    le_timer_Start(timerRef);
+}
@@ -34,6 +34,13 @@ static bool StatusReportActivation = false;
 //--------------------------------------------------------------------------------------------------
 static le_cfg_IteratorRef_t SimuIteratorRef = NULL;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of committed write transactions.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t NumCommits = 0;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Length of the strings used by this API.
@@ -113,7 +120,7 @@ void le_cfg_CommitTxn
     le_cfg_IteratorRef_t iteratorRef    ///< [IN] Iterator object to commit.
 )
 {
-    return;
+    NumCommits++;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -322,3 +329,16 @@ void le_cfg_SetBool
 {
     le_cfgSimu_SetBoolNodeValue(iteratorRef, path, value);
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of committed write transactions.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t le_cfgSimu_GetNumCommits
+(
+    void
+)
+{
+    return NumCommits;
+}
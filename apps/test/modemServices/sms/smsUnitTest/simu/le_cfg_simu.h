@@ -39,4 +39,14 @@ void le_cfgSimu_SetBoolNodeValue
     bool value                          ///< [IN] Value to write.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of committed write transactions.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t le_cfgSimu_GetNumCommits
+(
+    void
+);
+
 #endif // LE_CFGSIMU_INTERFACE_H_INCLUDE_GUARD
@@ -13,6 +13,8 @@
 #include "time.h"
 #include "le_sms_local.h"
 #include "pa_sms_simu.h"
+#include "le_cfg_simu.h"
+#include "mdmCfgEntries.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -220,6 +222,22 @@ static void Testle_sms_SetGetText
 
     LE_ASSERT(strncmp(text, TEXT_TEST_PATTERN, strlen(TEXT_TEST_PATTERN)) == 0);
 
+    // Read the text in pieces of 4 characters.
+    char piece[5];
+    uint32_t offset = 0;
+    memset(text, 0, sizeof(text));
+    while (offset < strlen(TEXT_TEST_PATTERN))
+    {
+        LE_ASSERT(le_sms_GetTextFrom(myMsg, offset, piece, sizeof(piece)) == LE_OK);
+        LE_ASSERT(strlen(piece) > 0);
+        strcat(text, piece);
+        offset += strlen(piece);
+    }
+    LE_ASSERT(strcmp(text, TEXT_TEST_PATTERN) == 0);
+    LE_ASSERT(le_sms_GetTextFrom(myMsg, offset, piece, sizeof(piece)) == LE_OK);
+    LE_ASSERT(piece[0] == '\0');
+    LE_ASSERT(le_sms_GetTextFrom(myMsg, offset + 1, piece, sizeof(piece)) == LE_OUT_OF_RANGE);
+
     LE_ASSERT(le_sms_SetDestination(myMsg, VOID_PATTERN) == LE_BAD_PARAMETER);
 
     length=1;
@@ -282,7 +300,26 @@ static void Testle_sms_SetGetBinary
     }
 
     LE_ASSERT(length == sizeof(BINARY_TEST_PATTERN));
+
+    // Read the message in pieces of 3 bytes.
+    uint32_t offset = 0;
+    memset(raw, 0, sizeof(raw));
+    while (offset < sizeof(BINARY_TEST_PATTERN))
+    {
+        length = 3;
+        LE_ASSERT(le_sms_GetBinaryFrom(myMsg, offset, raw + offset, &length) == LE_OK);
+        LE_ASSERT((length > 0) && (length <= 3));
+        offset += length;
+    }
+    LE_ASSERT(memcmp(raw, BINARY_TEST_PATTERN, sizeof(BINARY_TEST_PATTERN)) == 0);
+    length = 3;
+    LE_ASSERT(le_sms_GetBinaryFrom(myMsg, offset, raw, &length) == LE_OK);
+    LE_ASSERT(length == 0);
+    length = 3;
+    LE_ASSERT(le_sms_GetBinaryFrom(myMsg, offset + 1, raw, &length) == LE_OUT_OF_RANGE);
+
     LE_ASSERT(le_sms_GetText(myMsg, text, 1) == LE_FORMAT_ERROR);
+    LE_ASSERT(le_sms_GetTextFrom(myMsg, 0, text, sizeof(text)) == LE_FORMAT_ERROR);
 
     length = 1;
     LE_ASSERT(le_sms_GetUCS2(myMsg, ucs2Raw, &length) == LE_FORMAT_ERROR);
@@ -343,6 +380,23 @@ static void Testle_sms_SetGetUCS2
 
     LE_ASSERT(length == sizeof(UCS2_TEST_PATTERN) / 2);
 
+    // Read the message in pieces of 2 characters.
+    uint32_t offset = 0;
+    memset(ucs2Raw, 0, sizeof(ucs2Raw));
+    while (offset < sizeof(UCS2_TEST_PATTERN) / 2)
+    {
+        length = 2;
+        LE_ASSERT(le_sms_GetUCS2From(myMsg, offset, ucs2Raw + offset, &length) == LE_OK);
+        LE_ASSERT((length > 0) && (length <= 2));
+        offset += length;
+    }
+    LE_ASSERT(memcmp(ucs2Raw, UCS2_TEST_PATTERN, sizeof(UCS2_TEST_PATTERN)) == 0);
+    length = 2;
+    LE_ASSERT(le_sms_GetUCS2From(myMsg, offset + 1, ucs2Raw, &length) == LE_OUT_OF_RANGE);
+
+    length = sizeof(UCS2_TEST_PATTERN);
+    LE_ASSERT(le_sms_GetBinaryFrom(myMsg, 0, (uint8_t*)ucs2Raw, &length) == LE_FORMAT_ERROR);
+
     LE_ASSERT(le_sms_SetDestination(myMsg, VOID_PATTERN) == LE_BAD_PARAMETER);
 
 
@@ -1308,6 +1362,51 @@ static void Testle_sms_Statistics
     LE_ASSERT(LE_BAD_PARAMETER == le_sms_GetCount(LE_SMS_TYPE_BROADCAST_RX, NULL));
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Testle_sms_StatisticsPersistence: this function measures the config tree commits needed to
+ * count sent messages
+ */
+//--------------------------------------------------------------------------------------------------
+static void Testle_sms_StatisticsPersistence
+(
+    void
+)
+{
+    int32_t count;
+    int i;
+
+    le_sms_StartCount();
+    le_sms_ResetCount();
+    LE_ASSERT(0 == le_cfg_GetInt(NULL, CFG_NODE_TX_COUNT, -1));
+
+    uint32_t numCommits = le_cfgSimu_GetNumCommits();
+
+    for (i = 0; i < 1000; i++)
+    {
+        le_sms_MsgRef_t myMsg = le_sms_Create();
+        LE_ASSERT(myMsg);
+        LE_ASSERT_OK(le_sms_SetDestination(myMsg, DEST_TEST_PATTERN));
+        LE_ASSERT_OK(le_sms_SetText(myMsg, TEXT_TEST_PATTERN));
+        LE_ASSERT_OK(le_sms_Send(myMsg));
+        le_sms_Delete(myMsg);
+    }
+
+    numCommits = le_cfgSimu_GetNumCommits() - numCommits;
+    LE_INFO("%u config tree commits for 1000 sent messages", numCommits);
+
+    // The counters are written in batches, and the unsaved updates are bounded
+    LE_ASSERT(numCommits < 1000 / 10);
+    LE_ASSERT_OK(le_sms_GetCount(LE_SMS_TYPE_TX, &count));
+    LE_ASSERT(1000 == count);
+    LE_ASSERT(le_cfg_GetInt(NULL, CFG_NODE_TX_COUNT, -1) > 0);
+    LE_ASSERT(le_cfg_GetInt(NULL, CFG_NODE_TX_COUNT, -1) <= 1000);
+
+    // A reset is written at once
+    le_sms_ResetCount();
+    LE_ASSERT(0 == le_cfg_GetInt(NULL, CFG_NODE_TX_COUNT, -1));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Testle_sms_StatusReport: this function tests the SMS Status Report
@@ -1421,6 +1520,9 @@ void testle_sms_SmsApiUnitTest
     LE_INFO("Test Testle_sms_Statistics started");
     Testle_sms_Statistics();
 
+    LE_INFO("Test Testle_sms_StatisticsPersistence started");
+    Testle_sms_StatisticsPersistence();
+
     LE_INFO("Test Testle_sms_StatusReport started");
     Testle_sms_StatusReport();
 
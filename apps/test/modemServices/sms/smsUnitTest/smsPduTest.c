@@ -802,7 +802,7 @@ static const PduReceived_t PduReceivedDb[] =
      */
     {
         .checkLength = true,
-        .checkData = false, /* Due to special char in the string */
+        .checkData = false, /* Due to special char in the string and truncated PDU */
         .proto = PA_SMS_PROTOCOL_GSM,
         .length = 136,
         .data =
@@ -870,7 +870,7 @@ static const PduReceived_t PduReceivedDb[] =
      * */
     {
         .checkLength = true,
-        .checkData = false, /* Due to special char in the string */
+        .checkData = false, /* Due to special char in the string and truncated PDU */
         .proto = PA_SMS_PROTOCOL_GSM,
         .length = 136,
         .data =
@@ -933,7 +933,7 @@ static const PduReceived_t PduReceivedDb[] =
      */
     {
         .checkLength = true,
-        .checkData = false, /* Due to special char in the string */
+        .checkData = false, /* Due to special char in the string and truncated PDU */
         .proto = PA_SMS_PROTOCOL_GSM,
         .length = 136,
         .data =
@@ -955,19 +955,21 @@ static const PduReceived_t PduReceivedDb[] =
         },
         .expected =
         {
-            .result = LE_UNSUPPORTED,
+            .result = LE_OK,
             .encoding = SMSPDU_7_BITS,
             .message =
             {
                 .type = PA_SMS_DELIVER,
                 .smsDeliver =
                 {
+                    .option = PA_SMS_OPTIONMASK_CONCAT,
                     .oa = "Orange",
                     .format = LE_SMS_FORMAT_TEXT,
                     .scts = "13/07/05,09:31:19+08",
-                    .data = "Toute l'équipe Orange Business Services vous présente ses"
-                        " meilleurs voeux pour 2015 ! Plus d'infos sur http://business,(",
-                        .dataLen = 160,
+                    .data = "Orange:Profitez dès aujourd'hui de la 4G dans 103 villes.Découvrez nos"
+                        " offres et mobiles 4G sur: http://oran.ge/10e£",
+                    .dataLen = 153,
+                    .concat = { .ref = 0x0D, .maxNum = 2, .seqNum = 1 },
                 },
             },
         },
@@ -992,8 +994,8 @@ static const PduReceived_t PduReceivedDb[] =
      * Length: 15
      */
     {
-        .checkLength = false, /* SMS not supported */
-        .checkData = false, /* SMS not supported */
+        .checkLength = true,
+        .checkData = true,
         .proto = PA_SMS_PROTOCOL_GSM,
         .length = 42,
         .data =
@@ -1006,18 +1008,20 @@ static const PduReceived_t PduReceivedDb[] =
         },
         .expected =
         {
-            .result = LE_UNSUPPORTED,
+            .result = LE_OK,
             .encoding = SMSPDU_7_BITS,
             .message =
             {
                 .type = PA_SMS_DELIVER,
                 .smsDeliver =
                 {
-                    .oa = "Orange Info",
+                    .option = PA_SMS_OPTIONMASK_CONCAT,
+                    .oa = "Orange",
                     .format = LE_SMS_FORMAT_TEXT,
                     .scts = "13/07/05,09:31:20+08",
-                    .data = "uscrite",
-                    .dataLen = 15,
+                    .data = "uscrite ",
+                    .dataLen = 8,
+                    .concat = { .ref = 0x0D, .maxNum = 2, .seqNum = 2 },
                 },
             },
         },
@@ -1042,12 +1046,12 @@ static const PduReceived_t PduReceivedDb[] =
      * Alphabet: UCS2 (16bit)
      * User Data Header: 05 00 03 13 04 04
      *
-     * <not decoded>
+     * 2ofjrgp55l9e. 1 wb16671dh1711hf2f82 il. 2 2ff@...
      * Length: 57
      */
     {
-        .checkLength = false, /* SMS not supported */
-        .checkData = false, /* SMS not supported */
+        .checkLength = true,
+        .checkData = false, /* Truncated PDU */
         .proto = PA_SMS_PROTOCOL_GSM,
         .length = 136,
         .data =
@@ -1069,18 +1073,20 @@ static const PduReceived_t PduReceivedDb[] =
         },
         .expected =
         {
-            .result = LE_UNSUPPORTED,
-            .encoding = SMSPDU_7_BITS,
+            .result = LE_OK,
+            .encoding = SMSPDU_UCS2_16_BITS,
             .message =
             {
                 .type = PA_SMS_DELIVER,
                 .smsDeliver =
                 {
-                    .oa = "33688266023",
-                    .format = LE_SMS_FORMAT_TEXT,
+                    .option = PA_SMS_OPTIONMASK_CONCAT,
+                    .oa = "+33688266023",
+                    .format = LE_SMS_FORMAT_UCS2,
                     .scts = "15/05/07,10:28:31+08",
-                    .data = "",
-                    .dataLen = 57,
+                    .data = { 0x00, 0x32, 0x00, 0x6F, 0x00, 0x66, 0x00, 0x6A },
+                    .dataLen = 108,
+                    .concat = { .ref = 0x13, .maxNum = 4, .seqNum = 4 },
                 },
             },
         },
@@ -1468,6 +1474,105 @@ static const PduReceived_t PduReceivedDb[] =
             },
         },
     },
+
+    /* 14 */
+    /*
+     * 07913386094000F0440B913316325476F80000515070018213801006080412340202D0B09C0EA2DFDF
+     *
+     * SMS DELIVER (receive)
+     * SMSC: 33689004000
+     * Sender: +33612345678
+     * TimeStamp: 07/05/15 10:28:31 GMT +02:00
+     * TP-PID: 00
+     * TP-DCS: 00
+     * Alphabet: Default (7bit)
+     * User Data Header: 06 08 04 12 34 02 02 (16 bits reference, no fill bits)
+     *
+     * Part two
+     * Length: 8
+     */
+    {
+        .checkLength = true,
+        .checkData = true,
+        .proto = PA_SMS_PROTOCOL_GSM,
+        .length = 41,
+        .data =
+        {
+            0x07, 0x91, 0x33, 0x86, 0x09, 0x40, 0x00, 0xF0, 0x44, 0x0B,
+            0x91, 0x33, 0x16, 0x32, 0x54, 0x76, 0xF8, 0x00, 0x00, 0x51,
+            0x50, 0x70, 0x01, 0x82, 0x13, 0x80, 0x10, 0x06, 0x08, 0x04,
+            0x12, 0x34, 0x02, 0x02, 0xD0, 0xB0, 0x9C, 0x0E, 0xA2, 0xDF,
+            0xDF,
+        },
+        .expected =
+        {
+            .result = LE_OK,
+            .encoding = SMSPDU_7_BITS,
+            .message =
+            {
+                .type = PA_SMS_DELIVER,
+                .smsDeliver =
+                {
+                    .option = PA_SMS_OPTIONMASK_CONCAT,
+                    .oa = "+33612345678",
+                    .format = LE_SMS_FORMAT_TEXT,
+                    .scts = "15/05/07,10:28:31+08",
+                    .data = "Part two",
+                    .dataLen = 8,
+                    .concat = { .ref = 0x1234, .ref16Bits = true, .maxNum = 2, .seqNum = 2 },
+                },
+            },
+        },
+    },
+
+    /* 15 */
+    /*
+     * 07913386094000F0440B913316325476F80004515070018213800A0500032A030301020304
+     *
+     * SMS DELIVER (receive)
+     * SMSC: 33689004000
+     * Sender: +33612345678
+     * TimeStamp: 07/05/15 10:28:31 GMT +02:00
+     * TP-PID: 00
+     * TP-DCS: 04
+     * Alphabet: 8bit data
+     * User Data Header: 05 00 03 2A 03 03
+     *
+     * 01020304
+     * Length: 4
+     */
+    {
+        .checkLength = true,
+        .checkData = true,
+        .proto = PA_SMS_PROTOCOL_GSM,
+        .length = 37,
+        .data =
+        {
+            0x07, 0x91, 0x33, 0x86, 0x09, 0x40, 0x00, 0xF0, 0x44, 0x0B,
+            0x91, 0x33, 0x16, 0x32, 0x54, 0x76, 0xF8, 0x00, 0x04, 0x51,
+            0x50, 0x70, 0x01, 0x82, 0x13, 0x80, 0x0A, 0x05, 0x00, 0x03,
+            0x2A, 0x03, 0x03, 0x01, 0x02, 0x03, 0x04,
+        },
+        .expected =
+        {
+            .result = LE_OK,
+            .encoding = SMSPDU_8_BITS,
+            .message =
+            {
+                .type = PA_SMS_DELIVER,
+                .smsDeliver =
+                {
+                    .option = PA_SMS_OPTIONMASK_CONCAT,
+                    .oa = "+33612345678",
+                    .format = LE_SMS_FORMAT_BINARY,
+                    .scts = "15/05/07,10:28:31+08",
+                    .data = { 0x01, 0x02, 0x03, 0x04 },
+                    .dataLen = 4,
+                    .concat = { .ref = 0x2A, .maxNum = 3, .seqNum = 3 },
+                },
+            },
+        },
+    },
 };
 
 static le_result_t TestDecodePdu
@@ -1560,6 +1665,29 @@ static le_result_t TestDecodePdu
                             return LE_FAULT;
                         }
                     }
+
+                    if ((message.smsDeliver.option & PA_SMS_OPTIONMASK_CONCAT) !=
+                        (receivedPtr->expected.message.smsDeliver.option & PA_SMS_OPTIONMASK_CONCAT))
+                    {
+                        LE_ERROR("option 0x%X, expected 0x%X", message.smsDeliver.option,
+                                 receivedPtr->expected.message.smsDeliver.option);
+                        return LE_FAULT;
+                    }
+
+                    if ((message.smsDeliver.option & PA_SMS_OPTIONMASK_CONCAT) &&
+                        (memcmp(&message.smsDeliver.concat,
+                                &receivedPtr->expected.message.smsDeliver.concat,
+                                sizeof(pa_sms_Concat_t)) != 0))
+                    {
+                        LE_ERROR("concat ref %u part %u/%u, expected ref %u part %u/%u",
+                                 message.smsDeliver.concat.ref,
+                                 message.smsDeliver.concat.seqNum,
+                                 message.smsDeliver.concat.maxNum,
+                                 receivedPtr->expected.message.smsDeliver.concat.ref,
+                                 receivedPtr->expected.message.smsDeliver.concat.seqNum,
+                                 receivedPtr->expected.message.smsDeliver.concat.maxNum);
+                        return LE_FAULT;
+                    }
                 }
                 break;
 
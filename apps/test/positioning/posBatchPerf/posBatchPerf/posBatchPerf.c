@@ -0,0 +1,173 @@
+ /**
+  * Micro-benchmark for batched calls.
+  *
+  * Reads every value of the current location the way a tracking app would, first with a call to
+  * the Positioning Service for each value, and then with the same calls queued in one batch.  This
+  * shows the cost of a round trip to the server for each call.
+  *
+  * Needs the Positioning Service to be running.  The values read don't need a fix to be valid.
+  *
+  * Usage: app runProc posBatchPerf posBatchPerf -- [-n READS]
+  *
+  * Copyright (C) Sierra Wireless Inc.
+  */
+
+#include "legato.h"
+#include "interfaces.h"
+
+#define DEFAULT_NUM_READS 1000
+
+static int NumReads = DEFAULT_NUM_READS;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * All the values of the current location.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int32_t latitude;
+    int32_t longitude;
+    int32_t hAccuracy;
+    int32_t altitude;
+    int32_t vAccuracy;
+    uint16_t hours;
+    uint16_t minutes;
+    uint16_t seconds;
+    uint16_t milliseconds;
+    uint16_t year;
+    uint16_t month;
+    uint16_t day;
+    uint32_t hSpeed;
+    uint32_t hSpeedAccuracy;
+    int32_t vSpeed;
+    int32_t vSpeedAccuracy;
+    uint32_t heading;
+    uint32_t headingAccuracy;
+    uint32_t direction;
+    uint32_t directionAccuracy;
+    le_pos_FixState_t fixState;
+    le_result_t results[8];
+}
+Location_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the elapsed time since a given start time, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double ElapsedSecs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return elapsed.sec + (elapsed.usec / 1000000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the current location with a call to the server for each value.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadLocation
+(
+    Location_t* locPtr
+)
+{
+    locPtr->results[0] = le_pos_Get3DLocation(&locPtr->latitude, &locPtr->longitude,
+                                              &locPtr->hAccuracy, &locPtr->altitude,
+                                              &locPtr->vAccuracy);
+    locPtr->results[1] = le_pos_GetTime(&locPtr->hours, &locPtr->minutes, &locPtr->seconds,
+                                        &locPtr->milliseconds);
+    locPtr->results[2] = le_pos_GetDate(&locPtr->year, &locPtr->month, &locPtr->day);
+    locPtr->results[3] = le_pos_GetMotion(&locPtr->hSpeed, &locPtr->hSpeedAccuracy,
+                                          &locPtr->vSpeed, &locPtr->vSpeedAccuracy);
+    locPtr->results[4] = le_pos_GetHeading(&locPtr->heading, &locPtr->headingAccuracy);
+    locPtr->results[5] = le_pos_GetDirection(&locPtr->direction, &locPtr->directionAccuracy);
+    locPtr->results[6] = le_pos_GetFixState(&locPtr->fixState);
+    locPtr->results[7] = le_pos_Get2DLocation(&locPtr->latitude, &locPtr->longitude,
+                                              &locPtr->hAccuracy);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the current location with all the calls sent to the server in one batch.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadLocationBatched
+(
+    Location_t* locPtr
+)
+{
+    le_pos_StartBatch();
+
+    le_pos_QueueGet3DLocation(&locPtr->latitude, &locPtr->longitude, &locPtr->hAccuracy,
+                              &locPtr->altitude, &locPtr->vAccuracy, &locPtr->results[0]);
+    le_pos_QueueGetTime(&locPtr->hours, &locPtr->minutes, &locPtr->seconds,
+                        &locPtr->milliseconds, &locPtr->results[1]);
+    le_pos_QueueGetDate(&locPtr->year, &locPtr->month, &locPtr->day, &locPtr->results[2]);
+    le_pos_QueueGetMotion(&locPtr->hSpeed, &locPtr->hSpeedAccuracy, &locPtr->vSpeed,
+                          &locPtr->vSpeedAccuracy, &locPtr->results[3]);
+    le_pos_QueueGetHeading(&locPtr->heading, &locPtr->headingAccuracy, &locPtr->results[4]);
+    le_pos_QueueGetDirection(&locPtr->direction, &locPtr->directionAccuracy,
+                             &locPtr->results[5]);
+    le_pos_QueueGetFixState(&locPtr->fixState, &locPtr->results[6]);
+    le_pos_QueueGet2DLocation(&locPtr->latitude, &locPtr->longitude, &locPtr->hAccuracy,
+                              &locPtr->results[7]);
+
+    le_pos_EndBatch();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the current location a number of times.
+ *
+ * @return The average time taken by each read of the location, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double TimeReads
+(
+    void (*readFunc)(Location_t* locPtr)
+)
+{
+    Location_t location;
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    int i;
+
+    for (i = 0; i < NumReads; i++)
+    {
+        readFunc(&location);
+    }
+
+    return (ElapsedSecs(startTime) * 1000000.0) / NumReads;
+}
+
+
+COMPONENT_INIT
+{
+    le_arg_SetIntVar(&NumReads, "n", "reads");
+    le_arg_Scan();
+
+    LE_ASSERT(NumReads > 0);
+
+    le_posCtrl_ActivationRef_t activationRef = le_posCtrl_Request();
+    LE_ASSERT(activationRef != NULL);
+
+    double perCallUs = TimeReads(ReadLocation);
+    double batchedUs = TimeReads(ReadLocationBatched);
+
+    printf("*** Performance test for batched calls (8 calls per read). ***\n");
+    printf("%16s %16s\n", "per-call read us", "batched read us");
+    printf("%16.2f %16.2f\n", perCallUs, batchedUs);
+
+    le_posCtrl_Release(activationRef);
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,255 @@
+/**
+ * This module implements the unit tests for the message store of the smsInboxService.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "msgStore.h"
+#include <sys/resource.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message store directory and log file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_DIR_PATH           "/tmp/msgStoreUnitTest"
+#define TEST_LOG_PATH           TEST_DIR_PATH "/messages.log"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of message boxes used by the test.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_MBOX                2
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of messages added by the test.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_MSG                 3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Identifiers of the messages added by the test.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t MsgIds[NUM_MSG];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build a text message.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildMsg
+(
+    MsgStore_Msg_t* msgPtr,     ///< [OUT] Message
+    int index                   ///< [IN] Index of the message
+)
+{
+    memset(msgPtr, 0, sizeof(*msgPtr));
+
+    msgPtr->format = LE_SMS_FORMAT_TEXT;
+    msgPtr->flags = MSGSTORE_HAS_SENDERTEL | MSGSTORE_HAS_DATA;
+    snprintf(msgPtr->senderTel, sizeof(msgPtr->senderTel), "+3361234567%d", index);
+    msgPtr->dataLen = snprintf((char*)msgPtr->data, sizeof(msgPtr->data), "Message %d", index);
+    msgPtr->msgLen = msgPtr->dataLen;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of the log file.
+ */
+//--------------------------------------------------------------------------------------------------
+static off_t GetLogSize
+(
+    void
+)
+{
+    struct stat st;
+
+    LE_ASSERT(stat(TEST_LOG_PATH, &st) == 0);
+
+    return st.st_size;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: add messages, read them back, and browse the message boxes.
+ *
+ * API tested:
+ * - MsgStore_Open
+ * - MsgStore_Add
+ * - MsgStore_Read
+ * - MsgStore_GetCount
+ * - MsgStore_Browse
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_MsgStore_Add
+(
+    void
+)
+{
+    MsgStore_Msg_t msg;
+    uint32_t nextId;
+    int i;
+
+    LE_ASSERT_OK(MsgStore_Open(TEST_LOG_PATH, NUM_MBOX));
+
+    for (i = 0; i < NUM_MSG; i++)
+    {
+        BuildMsg(&msg, i);
+        LE_ASSERT_OK(MsgStore_Add(&msg, (1 << NUM_MBOX) - 1, &MsgIds[i]));
+    }
+
+    for (i = 0; i < NUM_MSG; i++)
+    {
+        const MsgStore_Msg_t* msgPtr = MsgStore_Read(MsgIds[i]);
+
+        BuildMsg(&msg, i);
+        LE_ASSERT(msgPtr != NULL);
+        LE_ASSERT(msgPtr->dataLen == msg.dataLen);
+        LE_ASSERT(memcmp(msgPtr->data, msg.data, msg.dataLen) == 0);
+        LE_ASSERT(strcmp(msgPtr->senderTel, msg.senderTel) == 0);
+    }
+
+    LE_ASSERT(MsgStore_GetCount(0) == NUM_MSG);
+    LE_ASSERT(MsgStore_GetCount(1) == NUM_MSG);
+
+    // The message boxes are browsed from the oldest message to the newest one.
+    LE_ASSERT(MsgStore_Browse(0, 0, &nextId) == MsgIds[0]);
+    LE_ASSERT(nextId == MsgIds[1]);
+    LE_ASSERT(MsgStore_Browse(0, nextId, &nextId) == MsgIds[1]);
+    LE_ASSERT(MsgStore_Browse(0, nextId, &nextId) == MsgIds[2]);
+    LE_ASSERT(nextId == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: read/unread status.
+ *
+ * API tested:
+ * - MsgStore_IsUnread
+ * - MsgStore_SetUnread
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_MsgStore_Unread
+(
+    void
+)
+{
+    LE_ASSERT(MsgStore_IsUnread(MsgIds[0], 0));
+    LE_ASSERT(MsgStore_IsUnread(MsgIds[0], 1));
+
+    MsgStore_SetUnread(MsgIds[0], 0, false);
+
+    LE_ASSERT(!MsgStore_IsUnread(MsgIds[0], 0));
+    LE_ASSERT(MsgStore_IsUnread(MsgIds[0], 1));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: remove messages from message boxes.
+ *
+ * API tested:
+ * - MsgStore_Remove
+ * - MsgStore_IsInMbox
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_MsgStore_Remove
+(
+    void
+)
+{
+    LE_ASSERT_OK(MsgStore_Remove(MsgIds[0], 0));
+    LE_ASSERT(!MsgStore_IsInMbox(MsgIds[0], 0));
+    LE_ASSERT(MsgStore_IsInMbox(MsgIds[0], 1));
+    LE_ASSERT(MsgStore_GetCount(0) == NUM_MSG - 1);
+
+    // Removing it again does nothing.
+    LE_ASSERT_OK(MsgStore_Remove(MsgIds[0], 0));
+    LE_ASSERT(MsgStore_GetCount(0) == NUM_MSG - 1);
+
+    // The message is deleted once it's removed from all the message boxes.
+    LE_ASSERT_OK(MsgStore_Remove(MsgIds[0], 1));
+    LE_ASSERT(MsgStore_Read(MsgIds[0]) == NULL);
+    LE_ASSERT(MsgStore_Remove(MsgIds[0], 1) == LE_NOT_FOUND);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: the log can't be written to.
+ *
+ * The file size limit is set to the current size of the log, so that appending a record fails.
+ * Nothing may change then, and a caller making room in a full message box must be told, instead of
+ * finding the box still full.
+ *
+ * API tested:
+ * - MsgStore_Remove
+ * - MsgStore_Add
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_MsgStore_WriteFailure
+(
+    void
+)
+{
+    MsgStore_Msg_t msg;
+    uint32_t msgId;
+    struct rlimit oldLimit;
+    struct rlimit limit;
+    off_t logSize = GetLogSize();
+
+    LE_ASSERT(getrlimit(RLIMIT_FSIZE, &oldLimit) == 0);
+    limit = oldLimit;
+    limit.rlim_cur = logSize;
+    LE_ASSERT(signal(SIGXFSZ, SIG_IGN) != SIG_ERR);
+    LE_ASSERT(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+
+    LE_ASSERT(MsgStore_Remove(MsgIds[1], 0) == LE_FAULT);
+    LE_ASSERT(MsgStore_IsInMbox(MsgIds[1], 0));
+    LE_ASSERT(MsgStore_GetCount(0) == NUM_MSG - 1);
+
+    BuildMsg(&msg, NUM_MSG);
+    LE_ASSERT(MsgStore_Add(&msg, 1, &msgId) == LE_FAULT);
+    LE_ASSERT(MsgStore_GetCount(0) == NUM_MSG - 1);
+
+    LE_ASSERT(GetLogSize() == logSize);
+
+    // Once the log can be written again, so can the changes.
+    LE_ASSERT(setrlimit(RLIMIT_FSIZE, &oldLimit) == 0);
+
+    LE_ASSERT_OK(MsgStore_Remove(MsgIds[1], 0));
+    LE_ASSERT(!MsgStore_IsInMbox(MsgIds[1], 0));
+    LE_ASSERT(MsgStore_GetCount(0) == NUM_MSG - 2);
+    LE_ASSERT(GetLogSize() > logSize);
+}
+
+
+COMPONENT_INIT
+{
+    LE_INFO("======== START UnitTest of SMS INBOX message store ========");
+
+    LE_ASSERT(le_dir_RemoveRecursive(TEST_DIR_PATH) == LE_OK);
+    LE_ASSERT(le_dir_MakePath(TEST_DIR_PATH, S_IRWXU) == LE_OK);
+
+    LE_INFO("======== msgStore Add test ========");
+    Test_MsgStore_Add();
+
+    LE_INFO("======== msgStore Unread test ========");
+    Test_MsgStore_Unread();
+
+    LE_INFO("======== msgStore Remove test ========");
+    Test_MsgStore_Remove();
+
+    LE_INFO("======== msgStore WriteFailure test ========");
+    Test_MsgStore_WriteFailure();
+
+    le_dir_RemoveRecursive(TEST_DIR_PATH);
+
+    LE_INFO("======== UnitTest of SMS INBOX message store FINISHED ========");
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,125 @@
+/**
+ * Benchmark of the SMS Inbox service.
+ *
+ * Simulates the reception of text messages, and measures through the le_smsInbox1 API the time
+ * taken to store a received message, to browse the message box with GetFirst/GetNext, to read a
+ * message and to delete it.
+ *
+ * Usage: smsInboxServicePerf [-n NUM_MESSAGES]
+ *
+ * The SMS Inbox directory (/tmp/smsInbox on a host) must be empty when the benchmark starts.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+#include "legato.h"
+#include "interfaces.h"
+
+#define DEFAULT_NUM_MESSAGES    10000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a start time, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetElapsedUsec
+(
+    le_clk_Time_t start
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return elapsed.sec * 1e6 + elapsed.usec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the time taken per operation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintResult
+(
+    const char* namePtr,
+    int numOps,
+    double elapsedUsec
+)
+{
+    printf("%-20s %d operations: %.3f us/operation\n", namePtr, numOps, elapsedUsec / numOps);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Runs the benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    int numMsgs = DEFAULT_NUM_MESSAGES;
+    uint32_t* msgIdPtr;
+    uint32_t msgId;
+    le_clk_Time_t start;
+    int i;
+
+    le_arg_SetIntVar(&numMsgs, "n", "messages");
+    le_arg_Scan();
+
+    msgIdPtr = calloc(numMsgs, sizeof(uint32_t));
+    LE_ASSERT(msgIdPtr != NULL);
+
+    le_smsInbox1_SessionRef_t mboxRef = le_smsInbox1_Open();
+    LE_ASSERT(mboxRef != NULL);
+
+    LE_FATAL_IF(le_smsInbox1_GetFirst(mboxRef) != 0, "The message box isn't empty");
+
+    // Store the messages
+    start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < numMsgs; i++)
+    {
+        smsPerf_SimulateRxMsg();
+    }
+
+    PrintResult("Receive and store", numMsgs, GetElapsedUsec(start));
+
+    // Browse the message box
+    start = le_clk_GetRelativeTime();
+
+    i = 0;
+    for (msgId = le_smsInbox1_GetFirst(mboxRef); msgId != 0; msgId = le_smsInbox1_GetNext(mboxRef))
+    {
+        LE_ASSERT(i < numMsgs);
+        msgIdPtr[i++] = msgId;
+    }
+
+    PrintResult("GetFirst/GetNext", i + 1, GetElapsedUsec(start));
+    LE_ASSERT(i == numMsgs);
+
+    // Read the messages, which marks them as read
+    start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < numMsgs; i++)
+    {
+        char text[LE_SMS_TEXT_MAX_BYTES];
+
+        LE_ASSERT(le_smsInbox1_IsUnread(msgIdPtr[i]));
+        LE_ASSERT_OK(le_smsInbox1_GetText(msgIdPtr[i], text, sizeof(text)));
+    }
+
+    PrintResult("IsUnread+GetText", numMsgs, GetElapsedUsec(start));
+
+    // Delete the messages
+    start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < numMsgs; i++)
+    {
+        le_smsInbox1_DeleteMsg(msgIdPtr[i]);
+    }
+
+    PrintResult("DeleteMsg", numMsgs, GetElapsedUsec(start));
+    LE_ASSERT(le_smsInbox1_GetFirst(mboxRef) == 0);
+
+    le_smsInbox1_Close(mboxRef);
+    free(msgIdPtr);
+
+    exit(EXIT_SUCCESS);
+}
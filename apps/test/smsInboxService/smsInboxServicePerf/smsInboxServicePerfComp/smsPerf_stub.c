@@ -0,0 +1,488 @@
+/**
+ * This module implements the sms, sim and cfg stubs of the SMS Inbox benchmark.
+ *
+ * Received messages are text messages, whose content is generated from the message reference.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the message boxes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PERF_MBOX_SIZE      100000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SMS reception handler of the SMS Inbox service.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sms_RxMessageHandlerFunc_t RxHandlerPtr = NULL;
+static void* RxContextPtr = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of simulated messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static uintptr_t NumRxMsg = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server Service Reference
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_ServiceRef_t _ServerServiceRef = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client Session Reference for the current message received from a client
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_SessionRef_t _ClientSessionRef = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the text of a simulated message.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetMsgText
+(
+    le_sms_MsgRef_t msgRef,
+    char* textPtr,
+    size_t textSize
+)
+{
+    snprintf(textPtr, textSize, "Benchmark message %" PRIuPTR ": temperature 21.5, humidity 40",
+             (uintptr_t)msgRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the reception of a text message by the modem.
+ */
+//--------------------------------------------------------------------------------------------------
+void smsPerf_SimulateRxMsg
+(
+    void
+)
+{
+    LE_ASSERT(RxHandlerPtr != NULL);
+
+    NumRxMsg++;
+    RxHandlerPtr((le_sms_MsgRef_t)NumRxMsg, RxContextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_smsInbox2_GetServiceRef
+(
+    void
+)
+{
+    return _ServerServiceRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_smsInbox1_GetServiceRef
+(
+    void
+)
+{
+    return _ServerServiceRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the client session reference for the current message
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_smsInbox2_GetClientSessionRef
+(
+    void
+)
+{
+    return _ClientSessionRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the client session reference for the current message
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t le_smsInbox1_GetClientSessionRef
+(
+    void
+)
+{
+    return _ClientSessionRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Registers a function to be called whenever one of this service's sessions is closed by
+ * the client.  (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionEventHandlerRef_t MyAddServiceCloseHandler
+(
+    le_msg_ServiceRef_t             serviceRef, ///< [in] Reference to the service.
+    le_msg_SessionEventHandler_t    handlerFunc,///< [in] Handler function.
+    void*                           contextPtr  ///< [in] Opaque pointer value to pass to handler.
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the message format.
+ */
+//--------------------------------------------------------------------------------------------------
+le_sms_Format_t le_sms_GetFormat
+(
+    le_sms_MsgRef_t msgRef
+)
+{
+   return LE_SMS_FORMAT_TEXT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next Message object reference in the list of messages in the SIM: there is none.
+ */
+//--------------------------------------------------------------------------------------------------
+le_sms_MsgRef_t le_sms_GetNext
+(
+    le_sms_MsgListRef_t msgListRef
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the first Message object reference in the list of messages in the SIM: there is none.
+ */
+//--------------------------------------------------------------------------------------------------
+le_sms_MsgRef_t le_sms_GetFirst
+(
+    le_sms_MsgListRef_t msgListRef
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an object's reference of the list of messages in the SIM: there is none.
+ */
+//--------------------------------------------------------------------------------------------------
+le_sms_MsgListRef_t le_sms_CreateRxMsgList
+(
+    void
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the Sender Telephone number.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_GetSenderTel
+(
+    le_sms_MsgRef_t msgRef,
+    char* tel,
+    size_t telSize
+)
+{
+    return le_utf8_Copy(tel, "+33612345678", telSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the Service Center Time Stamp string.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_GetTimeStamp
+(
+    le_sms_MsgRef_t msgRef,
+    char* timestamp,
+    size_t timestampSize
+)
+{
+    return le_utf8_Copy(timestamp, "17/08/29,18:36:41+22", timestampSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the message Length value.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_sms_GetUserdataLen
+(
+    le_sms_MsgRef_t msgRef
+)
+{
+    char text[LE_SMS_TEXT_MAX_BYTES];
+
+    GetMsgText(msgRef, text, sizeof(text));
+
+    return strlen(text);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the text Message.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_GetText
+(
+    le_sms_MsgRef_t msgRef,
+    char* text,
+    size_t textSize
+)
+{
+    GetMsgText(msgRef, text, textSize);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the binary Message.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_GetBinary
+(
+    le_sms_MsgRef_t msgRef,
+    uint8_t* binPtr,
+    size_t* binSizePtr
+)
+{
+    return LE_FORMAT_ERROR;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the UCS2 Message (16-bit format).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_GetUCS2
+(
+    le_sms_MsgRef_t msgRef,
+    uint16_t* ucs2Ptr,
+    size_t* ucs2SizePtr
+)
+{
+    return LE_FORMAT_ERROR;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the PDU message.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_GetPDU
+(
+    le_sms_MsgRef_t msgRef,
+    uint8_t* pduPtr,
+    size_t* pduSizePtr
+)
+{
+    return LE_FORMAT_ERROR;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the PDU message Length value.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_sms_GetPDULen
+(
+    le_sms_MsgRef_t msgRef
+)
+{
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an SMS message from the storage area.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_DeleteFromStorage
+(
+    le_sms_MsgRef_t msgRef
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the list of the Messages retrieved from the message storage.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_sms_DeleteList
+(
+    le_sms_MsgListRef_t msgListRef
+)
+{
+    return;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a Message data structure.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_sms_Delete
+(
+    le_sms_MsgRef_t msgRef
+)
+{
+    return;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_sms_RxMessage': the handler is called by
+ * smsPerf_SimulateRxMsg().
+ */
+//--------------------------------------------------------------------------------------------------
+le_sms_RxMessageHandlerRef_t le_sms_AddRxMessageHandler
+(
+    le_sms_RxMessageHandlerFunc_t handlerPtr,
+    void* contextPtr
+)
+{
+    RxHandlerPtr = handlerPtr;
+    RxContextPtr = contextPtr;
+
+    return (le_sms_RxMessageHandlerRef_t)1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Retrieves the identification number (IMSI) of the SIM card.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sim_GetIMSI
+(
+    le_sim_Id_t simId,
+    char* imsi,
+    size_t imsiSize
+)
+{
+    return le_utf8_Copy(imsi, "208011234567890", imsiSize, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add handler function for EVENT 'le_sim_NewState'
+ */
+//--------------------------------------------------------------------------------------------------
+le_sim_NewStateHandlerRef_t le_sim_AddNewStateHandler
+(
+    le_sim_NewStateHandlerFunc_t handlerPtr,
+    void* contextPtr
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current selected card.
+ */
+//--------------------------------------------------------------------------------------------------
+le_sim_Id_t le_sim_GetSelectedCard
+(
+    void
+)
+{
+   return LE_SIM_EXTERNAL_SLOT_1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the SIM state: the SIM is ready.
+ */
+//--------------------------------------------------------------------------------------------------
+le_sim_States_t le_sim_GetState
+(
+    le_sim_Id_t simId
+)
+{
+    return LE_SIM_READY;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a write transaction.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_IteratorRef_t le_cfg_CreateWriteTxn
+(
+    const char *basePath
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check to see if a given node in the config tree exists.
+ */
+//--------------------------------------------------------------------------------------------------
+bool le_cfg_NodeExists
+(
+    le_cfg_IteratorRef_t iteratorRef,
+    const char* path
+)
+{
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close and free the given iterator object.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_cfg_CancelTxn
+(
+    le_cfg_IteratorRef_t iteratorRef
+)
+{
+    return;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a signed integer value from the config tree: the size of the message boxes.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t le_cfg_GetInt
+(
+    le_cfg_IteratorRef_t iteratorRef,
+    const char *path,
+    int32_t defaultValue
+)
+{
+    return PERF_MBOX_SIZE;
+}
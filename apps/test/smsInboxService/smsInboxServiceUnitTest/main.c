@@ -17,6 +17,7 @@
 //--------------------------------------------------------------------------------------------------
 #define SIMU_MSG_PATH           " /tmp/smsInbox/msg/"
 #define SIMU_CONF_PATH          " /tmp/smsInbox/cfg/"
+#define SIMU_MSG_FILE           "/tmp/smsInbox/msg/0000002d.json"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -153,6 +154,26 @@ static void Testle_smsInbox_GetNext
     LE_ASSERT(le_smsInbox1_GetFirst(NULL) == LE_BAD_PARAMETER)
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: import of the message files of the previous versions.
+ *
+ * The message files are imported, in the order of their identifiers, when the message box is
+ * opened, and then deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Testle_smsInbox_Import
+(
+    void
+)
+{
+    LE_ASSERT(MyMsgId1 == 0x2d);
+    LE_ASSERT(MyMsgId2 == 0x2e);
+    LE_ASSERT(MyMsgId3 == 0x2f);
+    LE_ASSERT(le_smsInbox1_GetNext(MyMbx1Ref) == 0);
+    LE_ASSERT(access(SIMU_MSG_FILE, F_OK) != 0);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Test: Read/Unread status smsInbox.
@@ -441,6 +462,7 @@ static void Simulate_smsInbox_cfgFileInit
 )
 {
     LE_INFO("Init Sms InBox cfg files");
+    system("mkdir -p" SIMU_CONF_PATH);
     char cfgCpCommand[512] = "cp -rf ";
     size_t cfgFilePathLen = strlen(smsCfgFilePath);
     strncat(cfgCpCommand, smsCfgFilePath, cfgFilePathLen + 1);
@@ -459,6 +481,7 @@ static void Simulate_smsInbox_msgFileInit
 )
 {
     LE_INFO("Init Sms InBox msg files");
+    system("mkdir -p" SIMU_MSG_PATH);
     char msgCpCommand[512]= "cp -rf ";
     size_t msgFilePathLen = strlen(smsMsgFilePath);
     strncat(msgCpCommand, smsMsgFilePath, msgFilePathLen + 1);
@@ -529,6 +552,9 @@ COMPONENT_INIT
     LE_INFO("======== smsInbox GetNext test ========");
     Testle_smsInbox_GetNext();
 
+    LE_INFO("======== smsInbox Import test ========");
+    Testle_smsInbox_Import();
+
     LE_INFO("======== smsInbox MarkRead test ========");
     Testle_smsInbox_ReadUnreadStatus();
 
@@ -20,18 +20,12 @@
 
 #include "limit.h"
 #include "assetData.h"
+#include "timeSeries.h"
 #include "le_print.h"
 
 // For htonl
 #include <arpa/inet.h>
 
-#ifdef LEGATO_FEATURE_TIMESERIES
-
-#include "tinycbor/cbor.h"
-#include "zlib.h"
-
-#endif
-
 //--------------------------------------------------------------------------------------------------
 // Macros
 //--------------------------------------------------------------------------------------------------
@@ -60,31 +54,26 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum number of bytes for CBOR encoded time series data
- */
-//--------------------------------------------------------------------------------------------------
-#define MAX_CBOR_BUFFER_NUMBYTES 1024
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Checks the return value from the tinyCBOR encoder and returns from function if an error is found.
+ * Config tree path of the time series limits, and their default values.
+ *
+ * By default a time series keeps up to 8 KB of compressed history in RAM, and up to 64 KB in all.
  */
 //--------------------------------------------------------------------------------------------------
-#ifdef LEGATO_FEATURE_TIMESERIES
+#define CFG_TIME_SERIES_PATH                "/timeSeries"
+#define CFG_TIME_SERIES_MAX_RAM_BYTES       "maxRamBytes"
+#define CFG_TIME_SERIES_MAX_BYTES           "maxBytes"
+#define CFG_TIME_SERIES_SPILL_DIR           "spillDir"
 
-#define \
-    RETURN_IF_CBOR_ERROR( err ) \
-    ({ \
-        if (err != CborNoError) \
-        { \
-            LE_ERROR("CBOR encoding error %s", cbor_error_string(err)); \
-            return LE_FAULT; \
-        } \
-    })
+#define DEFAULT_TIME_SERIES_MAX_RAM_BYTES   8192
+#define DEFAULT_TIME_SERIES_MAX_BYTES       65536
 
+#ifdef LEGATO_EMBEDDED
+#define DEFAULT_TIME_SERIES_SPILL_DIR       "/data/avc/timeSeries"
+#else
+#define DEFAULT_TIME_SERIES_SPILL_DIR       "/tmp/avc/timeSeries"
 #endif
 
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Supported data types.  (Not all LWM2M types are listed yet)
@@ -153,38 +142,6 @@ typedef struct le_avdata_AssetInstance
 InstanceData_t;
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Data contained in time series
- */
-//--------------------------------------------------------------------------------------------------
-typedef struct
-{
-    uint8_t* bufferPtr;             ///< Buffer for accumulating history data.
-    size_t bufferSize;              ///< Buffer size of history data.
-
-#ifdef LEGATO_FEATURE_TIMESERIES
-    double timeStampFactor;         ///< Factor of time stamp.
-    uint64_t prevTimeStamp;         ///< Time stamp of last data capture, used for delta encoding.
-
-    double factor;                  ///< Factor of data.
-    union
-    {
-        int prevIntValue;           ///< Value of of last data capture - used for delta encoding.
-        double prevFloatValue;      ///< Value of last data capture - used for delta encoding.
-    };
-
-    uint32_t numElements;           ///< Number of elements in cbor encoded stream.
-
-    CborEncoder streamRef;          ///< CBOR encoded stream reference.
-    CborEncoder mapRef;             ///< CBOR encoded map reference.
-    CborEncoder sampleRef;          ///< CBOR encoded sample data reference.
-#endif
-}
-TimeSeriesData_t;
-
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Data contained in a single field of an asset instance
@@ -208,7 +165,7 @@ typedef struct
         char* strValuePtr;
     };
 
-    TimeSeriesData_t* timeSeriesPtr;
+    timeSeries_Ref_t timeSeriesRef;
 
     le_dls_Link_t link;          ///< For adding to the field list
 }
@@ -331,22 +288,6 @@ static le_hashmap_Ref_t AssetMapByName = NULL;
 static le_timer_Ref_t RegUpdateTimerRef;
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Time series data memory pool.  Initialized in assetData_Init().
- */
-//--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t TimeSeriesDataPoolRef = NULL;
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- * CBOR buffer memory pool.  Initialized in assetData_Init().
- */
-//--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t CborBufferPoolRef = NULL;
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Table mapping data type strings to DataType_t values
@@ -560,7 +501,7 @@ static void InitDefaultFieldData
     fieldDataPtr->isObserve = false;
     fieldDataPtr->readCallBackOpRef = NULL;
 
-    fieldDataPtr->timeSeriesPtr = NULL;
+    fieldDataPtr->timeSeriesRef = NULL;
 
     switch ( fieldDataPtr->type )
     {
@@ -1309,11 +1250,7 @@ static le_result_t StartTimeSeries
 
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint8_t* timeSeriesBufferPtr;
     char headerId[64];
-    CborError err;
-    CborEncoder headerArray;
-    CborEncoder factorArray;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
     if ( result != LE_OK )
@@ -1323,7 +1260,7 @@ static le_result_t StartTimeSeries
     }
 
     // Is time series enabled on this field.
-    if (fieldDataPtr->timeSeriesPtr != NULL)
+    if (fieldDataPtr->timeSeriesRef != NULL)
     {
         LE_ERROR("Time series already enabled on this field.");
         return LE_BUSY;
@@ -1335,80 +1272,14 @@ static le_result_t StartTimeSeries
                  instanceRef->instanceId,
                  fieldId);
 
-    fieldDataPtr->timeSeriesPtr = le_mem_ForceAlloc(TimeSeriesDataPoolRef);
-
-    memset(fieldDataPtr->timeSeriesPtr, 0, sizeof(TimeSeriesData_t));
-
-    timeSeriesBufferPtr = le_mem_ForceAlloc(CborBufferPoolRef);
-    fieldDataPtr->timeSeriesPtr->bufferPtr = timeSeriesBufferPtr;
-
-    fieldDataPtr->timeSeriesPtr->bufferSize = MAX_CBOR_BUFFER_NUMBYTES;
-
-    // Initialize CBOR stream.
-    cbor_encoder_init(&fieldDataPtr->timeSeriesPtr->streamRef,
-                      timeSeriesBufferPtr,
-                      MAX_CBOR_BUFFER_NUMBYTES,
-                      0);
-
-    err = cbor_encoder_create_map(&fieldDataPtr->timeSeriesPtr->streamRef,
-                                  &fieldDataPtr->timeSeriesPtr->mapRef,
-                                  NUM_TIME_SERIES_MAPS);
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Create a map and add the header in to the map.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "h");
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Create an array for the header.
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &headerArray,
-                                    1);
-    RETURN_IF_CBOR_ERROR(err);
-
-    err = cbor_encode_text_string(&headerArray, headerId, strlen(headerId));
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Close the heade map i.e done with entering in to header array.
-    // e.g. "h" : [/1000/0]  --> map for header.
-    cbor_encoder_close_container(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                 &headerArray);
-
-    // Create a map for factor.
-    // e.g. "f" : [1]  --> map for factor.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "f");
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Create an array of factors (time stamp factor, data factor)
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &factorArray,
-                                    2);
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Add factor for time stamp.
-    err = cbor_encode_double(&factorArray, timeStampFactor);
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Add factor for sample.
-    err = cbor_encode_double(&factorArray, factor);
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Close the map i.e done with entering in to factor array.
-    cbor_encoder_close_container(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                 &factorArray);
+    fieldDataPtr->timeSeriesRef = timeSeries_Create(headerId, factor, timeStampFactor);
 
-    // Create an array for samples. The sample array will have time stamp and data pair.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "s");
-    RETURN_IF_CBOR_ERROR(err);
-
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &fieldDataPtr->timeSeriesPtr->sampleRef,
-                                    CborIndefiniteLength);
-    RETURN_IF_CBOR_ERROR(err);
-
-    fieldDataPtr->timeSeriesPtr->factor = factor;
-    fieldDataPtr->timeSeriesPtr->timeStampFactor = timeStampFactor;
+    if (fieldDataPtr->timeSeriesRef == NULL)
+    {
+        return LE_FAULT;
+    }
 
-    return result;
+    return LE_OK;
 
 #else
     LE_ERROR("Time series not supported.");
@@ -1444,16 +1315,15 @@ static le_result_t StopTimeSeries
         return result;
     }
 
-    if (fieldDataPtr->timeSeriesPtr == NULL)
+    if (fieldDataPtr->timeSeriesRef == NULL)
     {
         LE_ERROR("Time series not enabled on this field.");
         return LE_CLOSED;
     }
 
-    le_mem_Release(fieldDataPtr->timeSeriesPtr->bufferPtr);
-    le_mem_Release(fieldDataPtr->timeSeriesPtr);
+    timeSeries_Delete(fieldDataPtr->timeSeriesRef);
 
-    fieldDataPtr->timeSeriesPtr = NULL;
+    fieldDataPtr->timeSeriesRef = NULL;
 
     return LE_OK;
 
@@ -1487,13 +1357,11 @@ static le_result_t PushTimeSeries
 #ifdef LEGATO_FEATURE_TIMESERIES
 
     le_result_t result;
+    le_result_t finishResult;
     FieldData_t* fieldDataPtr;
-    uint32_t cborStreamSize;
-    unsigned char compressedBuf[MAX_CBOR_BUFFER_NUMBYTES];
-    unsigned long int compressBufLength;
-    z_stream defstream;
+    uint8_t* compressedBufPtr;
+    size_t compressBufLength;
     pa_avc_LWM2MOperationDataRef_t opRef;
-    CborError err;
 
     double dataFactor;
     double timeStampFactor;
@@ -1504,7 +1372,7 @@ static le_result_t PushTimeSeries
         return result;
     }
 
-    if (fieldDataPtr->timeSeriesPtr == NULL)
+    if (fieldDataPtr->timeSeriesRef == NULL)
     {
         // Time series not enabled on this field.
         LE_ERROR("Time series not enabled on this field.");
@@ -1519,60 +1387,40 @@ static le_result_t PushTimeSeries
     }
 
     // Remember the factors used.
-    dataFactor = fieldDataPtr->timeSeriesPtr->factor;
-    timeStampFactor = fieldDataPtr->timeSeriesPtr->timeStampFactor;
-
-    // Close the map i.e done with entering in to sample array.
-    err = cbor_encoder_close_container_checked(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                               &fieldDataPtr->timeSeriesPtr->sampleRef);
-
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Close the stream.
-    err = cbor_encoder_close_container_checked(&fieldDataPtr->timeSeriesPtr->streamRef,
-                                               &fieldDataPtr->timeSeriesPtr->mapRef);
-    RETURN_IF_CBOR_ERROR(err);
+    timeSeries_GetFactors(fieldDataPtr->timeSeriesRef, &dataFactor, &timeStampFactor);
 
-    // Dump CBOR encoded data.
-    cborStreamSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                                  fieldDataPtr->timeSeriesPtr->bufferPtr);
+    // Close the CBOR stream and finish its compression.
+    finishResult = timeSeries_Finish(fieldDataPtr->timeSeriesRef,
+                                     &compressedBufPtr,
+                                     &compressBufLength);
 
-    //LE_DEBUG("cborStreamSize = %d", cborStreamSize);
-    //LE_DUMP(fieldDataPtr->timeSeriesPtr->bufferPtr, cborStreamSize);
-
-    // Compress the cbor encoded data
-    // ToDo: In place compression
-    defstream.zalloc = Z_NULL;
-    defstream.zfree = Z_NULL;
-    defstream.opaque = Z_NULL;
-
-    defstream.avail_in = cborStreamSize;
-    defstream.next_in = (Bytef *)fieldDataPtr->timeSeriesPtr->bufferPtr;
-    defstream.avail_out = (uInt)sizeof(compressedBuf);
-    defstream.next_out = (Bytef *)compressedBuf;
-
-    deflateInit(&defstream, Z_BEST_COMPRESSION);
-    deflate(&defstream, Z_FINISH);
-    deflateEnd(&defstream);
-
-    compressBufLength = defstream.total_out;
+    if (finishResult == LE_OK)
+    {
+        LE_DEBUG("Pushing %u samples of field %d in %zu bytes.",
+                 timeSeries_GetNumSamples(fieldDataPtr->timeSeriesRef),
+                 fieldId,
+                 compressBufLength);
 
-    //LE_DEBUG("Compressed size is: %lu\n", compressBufLength);
-    //LE_DUMP(compressedBuf, compressBufLength);
+        // Send the delta encoded + CBOR encoded + Zipped data to the server.
+        opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
+                                    instanceRef->assetDataPtr->assetId,
+                                    -1,
+                                    -1,
+                                    PA_AVC_OPTYPE_NOTIFY,
+                                    SIERRA_CBOR_ENCODING,
+                                    fieldDataPtr->token,
+                                    fieldDataPtr->tokenLength);
 
-    // Send the delta encoded + CBOR encoded + Zipped data to the server.
-    opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                instanceRef->assetDataPtr->assetId,
-                                -1,
-                                -1,
-                                PA_AVC_OPTYPE_NOTIFY,
-                                SIERRA_CBOR_ENCODING,
-                                fieldDataPtr->token,
-                                fieldDataPtr->tokenLength);
+        pa_avc_NotifyChange(opRef, compressedBufPtr, compressBufLength);
 
-    pa_avc_NotifyChange(opRef, compressedBuf, compressBufLength);
+        free(compressedBufPtr);
+    }
+    else
+    {
+        LE_ERROR("Failed to compress time series of field %d.", fieldId);
+    }
 
-    // Stop time series.
+    // Stop time series.  A finished time series can't take new samples, even if finishing failed.
     result = StopTimeSeries(instanceRef, fieldId);
 
     // Restart time series if asked.
@@ -1581,6 +1429,11 @@ static le_result_t PushTimeSeries
         result = StartTimeSeries(instanceRef, fieldId, dataFactor, timeStampFactor);
     }
 
+    if (finishResult != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
     return result;
 
 #else
@@ -1619,7 +1472,7 @@ le_result_t GetTimeSeriesStatus
         return result;
     }
 
-    if (fieldDataPtr->timeSeriesPtr == NULL)
+    if (fieldDataPtr->timeSeriesRef == NULL)
     {
         // Time series not enabled on this field.
         LE_DEBUG("Time series not enabled on this field.");
@@ -1630,7 +1483,7 @@ le_result_t GetTimeSeriesStatus
     else
     {
         *isTimeSeriesPtr = true;
-        *numDataPointsPtr = fieldDataPtr->timeSeriesPtr->numElements;
+        *numDataPointsPtr = timeSeries_GetNumSamples(fieldDataPtr->timeSeriesRef);
     }
 
     return LE_OK;
@@ -1644,7 +1497,7 @@ le_result_t GetTimeSeriesStatus
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the sampled data in to the CBOR sample array.
+ * Add the sampled data in to the time series.
  *
  * @return:
  *      - LE_OK on success
@@ -1662,133 +1515,51 @@ static le_result_t TimeSeriesAddEntry
 
 #ifdef LEGATO_FEATURE_TIMESERIES
 
-    CborError err;
-    uint64_t timeStamp;
-    int intDelta;
-    double floatDelta;
-    size_t currentSize;
-    struct timeval tv;
-
-    // Reserve CBOR_RESERVED_BYTES bytes for closing the container.
-    // The stream has to be flushed it starts getting in to the reserved area.
-    currentSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                               fieldDataPtr->timeSeriesPtr->bufferPtr);
-
-
-    if (currentSize > (fieldDataPtr->timeSeriesPtr->bufferSize - CBOR_RESERVED_BYTES))
-    {
-        LE_WARN("Time series buffer overflow on field %d.", fieldDataPtr->fieldId);
-        LE_DEBUG("currentSize = %zd.", currentSize);
-
-        return LE_OVERFLOW;
-    }
-
-    // Get current system time if utc milli seconds is not provided.
-    // The time stamp is expected in UTC milli seconds by the server.
-    if (utcMilliSec == 0)
-    {
-        gettimeofday(&tv, NULL);
-        utcMilliSec = (uint64_t)(tv.tv_sec) * 1000 + (uint64_t)(tv.tv_usec) / 1000;
-    }
-
-    // For the first entry write the absolute value, for all other entries calculate delta.
-    if (fieldDataPtr->timeSeriesPtr->numElements == 0)
-    {
-        timeStamp = utcMilliSec * fieldDataPtr->timeSeriesPtr->timeStampFactor;
-    }
-    else
-    {
-        timeStamp = (utcMilliSec - fieldDataPtr->timeSeriesPtr->prevTimeStamp) *
-                    fieldDataPtr->timeSeriesPtr->timeStampFactor;
-    }
-
-    // Add time stamp to sample array.
-    err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, timeStamp);
-    RETURN_IF_CBOR_ERROR(err);
-
-    fieldDataPtr->timeSeriesPtr->prevTimeStamp = utcMilliSec;
+    le_result_t result;
 
-    // Add the data to sample array.
+    // Add the data to the time series.
     switch ( fieldDataPtr->type )
     {
         case DATA_TYPE_INT:
-            if (fieldDataPtr->timeSeriesPtr->numElements == 0)
-            {
-                intDelta = fieldDataPtr->intValue * fieldDataPtr->timeSeriesPtr->factor;
-            }
-            else
-            {
-                intDelta = (fieldDataPtr->intValue - fieldDataPtr->timeSeriesPtr->prevIntValue) *
-                            fieldDataPtr->timeSeriesPtr->factor;
-            }
-
-            //LE_DEBUG("intDelta = %d", intDelta);
-
-            err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, intDelta);
-
-            fieldDataPtr->timeSeriesPtr->prevIntValue = fieldDataPtr->intValue;
+            result = timeSeries_AddInt(fieldDataPtr->timeSeriesRef,
+                                       utcMilliSec,
+                                       fieldDataPtr->intValue);
             break;
 
         case DATA_TYPE_BOOL:
-            err = cbor_encode_boolean(&fieldDataPtr->timeSeriesPtr->sampleRef, fieldDataPtr->boolValue);
+            result = timeSeries_AddBool(fieldDataPtr->timeSeriesRef,
+                                        utcMilliSec,
+                                        fieldDataPtr->boolValue);
             break;
 
         case DATA_TYPE_STRING:
-            err = cbor_encode_text_string(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                          fieldDataPtr->strValuePtr,
-                                          strlen(fieldDataPtr->strValuePtr));
+            result = timeSeries_AddString(fieldDataPtr->timeSeriesRef,
+                                          utcMilliSec,
+                                          fieldDataPtr->strValuePtr);
             break;
 
         case DATA_TYPE_FLOAT:
-            // ToDO: float doesn't benefit from use of factor - investigate.
-            if (fieldDataPtr->timeSeriesPtr->numElements == 0)
-            {
-                floatDelta = fieldDataPtr->floatValue * fieldDataPtr->timeSeriesPtr->factor;
-            }
-            else
-            {
-                floatDelta = (fieldDataPtr->floatValue - fieldDataPtr->timeSeriesPtr->prevFloatValue);
-                floatDelta = floatDelta * fieldDataPtr->timeSeriesPtr->factor;
-            }
-
-            if ((uint64_t)fieldDataPtr->timeSeriesPtr->factor == 1)
-            {
-                err = cbor_encode_double(&fieldDataPtr->timeSeriesPtr->sampleRef, floatDelta);
-            }
-            else
-            {
-                LE_DEBUG("Float data encoded as integer.");
-                err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, (int64_t)floatDelta);
-            }
-
-            fieldDataPtr->timeSeriesPtr->prevFloatValue = fieldDataPtr->floatValue;
+            result = timeSeries_AddFloat(fieldDataPtr->timeSeriesRef,
+                                         utcMilliSec,
+                                         fieldDataPtr->floatValue);
             break;
 
-        case DATA_TYPE_NONE:
+        default:
             LE_ERROR("Failed to add an entry in CBOR stream.");
-            break;
+            return LE_FAULT;
     }
 
-    RETURN_IF_CBOR_ERROR(err);
-
-    fieldDataPtr->timeSeriesPtr->numElements++;
-
-
-    // Reserve CBOR_RESERVED_BYTES bytes for closing the container.
-    // The stream has to be flushed it starts getting in to the reserved area.
-    currentSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                               fieldDataPtr->timeSeriesPtr->bufferPtr);
-
-    if (currentSize > (fieldDataPtr->timeSeriesPtr->bufferSize - CBOR_RESERVED_BYTES))
+    if (result == LE_OVERFLOW)
+    {
+        LE_WARN("Time series buffer overflow on field %d.", fieldDataPtr->fieldId);
+    }
+    else if (result == LE_NO_MEMORY)
     {
         LE_WARN("Time series buffer full; flush and restart time series on field %d.",
                  fieldDataPtr->fieldId);
-        LE_DEBUG("currentSize = %zd.", currentSize);
-
-        return LE_NO_MEMORY;
     }
 
-    return LE_OK;
+    return result;
 
 #else
     LE_ERROR("Time series not supported.");
@@ -2198,7 +1969,7 @@ static le_result_t SetInt
 
     // If time series is enabled add the data to time series history and get out. If time series is
     // not enabled send the observe notification right away.
-    if (fieldDataPtr->timeSeriesPtr != NULL)
+    if (fieldDataPtr->timeSeriesRef != NULL)
     {
         return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
     }
@@ -2312,7 +2083,7 @@ static le_result_t SetFloat
 
     // If time series is enabled add the data to time series history and get out. If time series is
     // not enabled send the observe notification right away.
-    if (fieldDataPtr->timeSeriesPtr != NULL)
+    if (fieldDataPtr->timeSeriesRef != NULL)
     {
         return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
     }
@@ -2467,7 +2238,7 @@ static le_result_t SetBool
 
     // If time series is enabled add the data to time series history and get out. If time series is
     // not enabled send the observe notification right away.
-    if (fieldDataPtr->timeSeriesPtr != NULL)
+    if (fieldDataPtr->timeSeriesRef != NULL)
     {
         return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
     }
@@ -2625,7 +2396,7 @@ static le_result_t SetString
 
     // If time series is enabled add the data to time series history and get out. If time series is
     // not enabled send the observe notification right away.
-    if (fieldDataPtr->timeSeriesPtr != NULL)
+    if (fieldDataPtr->timeSeriesRef != NULL)
     {
         return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
     }
@@ -3188,11 +2959,10 @@ void assetData_DeleteInstance
         }
 
         // Release Time Series resources.
-        if (fieldDataPtr->timeSeriesPtr != NULL)
+        if (fieldDataPtr->timeSeriesRef != NULL)
         {
             LE_DEBUG("Releasing time series resources of %s", fieldDataPtr->name);
-            le_mem_Release(fieldDataPtr->timeSeriesPtr->bufferPtr);
-            le_mem_Release(fieldDataPtr->timeSeriesPtr);
+            timeSeries_Delete(fieldDataPtr->timeSeriesRef);
         }
 
         // Release the field.
@@ -4511,6 +4281,52 @@ static void RegUpdateTimerHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the time series limits from the config tree, and init the time series sub-component.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitTimeSeries
+(
+    void
+)
+{
+    le_cfg_IteratorRef_t cfgRef;
+    int maxRamBytes;
+    int maxBytes;
+    char spillDir[LIMIT_MAX_PATH_BYTES];
+
+    cfgRef = le_cfg_CreateReadTxn(CFG_TIME_SERIES_PATH);
+
+    maxRamBytes = le_cfg_GetInt(cfgRef,
+                                CFG_TIME_SERIES_MAX_RAM_BYTES,
+                                DEFAULT_TIME_SERIES_MAX_RAM_BYTES);
+    maxBytes = le_cfg_GetInt(cfgRef, CFG_TIME_SERIES_MAX_BYTES, DEFAULT_TIME_SERIES_MAX_BYTES);
+
+    if (le_cfg_GetString(cfgRef,
+                         CFG_TIME_SERIES_SPILL_DIR,
+                         spillDir,
+                         sizeof(spillDir),
+                         DEFAULT_TIME_SERIES_SPILL_DIR) != LE_OK)
+    {
+        LE_WARN("Invalid time series spill directory, using '%s'.", DEFAULT_TIME_SERIES_SPILL_DIR);
+        LE_ASSERT(le_utf8_Copy(spillDir, DEFAULT_TIME_SERIES_SPILL_DIR, sizeof(spillDir), NULL)
+                  == LE_OK);
+    }
+
+    le_cfg_CancelTxn(cfgRef);
+
+    if ((maxRamBytes < 0) || (maxBytes <= 0))
+    {
+        LE_WARN("Invalid time series limits %d and %d, using defaults.", maxRamBytes, maxBytes);
+        maxRamBytes = DEFAULT_TIME_SERIES_MAX_RAM_BYTES;
+        maxBytes = DEFAULT_TIME_SERIES_MAX_BYTES;
+    }
+
+    timeSeries_Init(maxRamBytes, maxBytes, spillDir);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Init this sub-component
@@ -4528,9 +4344,8 @@ le_result_t assetData_Init
     ActionHandlerDataPoolRef = le_mem_CreatePool("Action handler data pool",
                                                  sizeof(ActionHandlerData_t));
 
-    // Memory pool for time series data.
-    TimeSeriesDataPoolRef = le_mem_CreatePool("TimeSeries data pool", sizeof(TimeSeriesData_t));
-    CborBufferPoolRef = le_mem_CreatePool("CBOR buffer pool", MAX_CBOR_BUFFER_NUMBYTES);
+    // Time series sub-component.
+    InitTimeSeries();
 
     StringValuePoolRef = le_mem_CreatePool("String value pool", STRING_VALUE_NUMBYTES);
     AddressStringPoolRef = le_mem_CreatePool("Address pool", 100);
@@ -0,0 +1,958 @@
+/**
+ * @file timeSeries.c
+ *
+ * Implementation of the time series sub-component.
+ *
+ * The history of a time series is a CBOR map, compressed with zlib:
+ *
+ *     { "h" : [ header id ], "f" : [ time stamp factor, factor ], "s" : [ time stamp, value, ... ] }
+ *
+ * Time stamps and numeric values are delta encoded: the first sample holds the absolute values
+ * multiplied by the factors, and the next ones the difference with the previous sample multiplied
+ * by the factors.
+ *
+ * Samples are CBOR encoded in a small buffer, and the buffer is compressed into the chunks of the
+ * time series each time it is full, so the encoded samples are never copied.  The compression
+ * stream is the biggest part of the memory used by a time series, so it is only created when the
+ * buffer is first full: short time series are compressed in one go when they are finished.
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "timeSeries.h"
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+#include "tinycbor/cbor.h"
+#include "zlib.h"
+
+//--------------------------------------------------------------------------------------------------
+// Definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes of the buffer in which samples are encoded before being compressed.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ENCODE_BUFFER_NUMBYTES 1024
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes of a chunk of compressed history.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHUNK_NUMBYTES 1024
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compression parameters.  The window and the memory level are reduced from the zlib defaults
+ * (15 and 8), which would use about 256 KB per time series, to use about 24 KB.  Samples are a few
+ * bytes each, so the matches found in a small window are about as good as in a large one, and the
+ * best compression level takes a third more time than the default one for 1% smaller history.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPRESSION_LEVEL   Z_DEFAULT_COMPRESSION
+#define WINDOW_BITS         12
+#define MEM_LEVEL           4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CBOR "break" byte, which closes an indefinite length array.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_BREAK_BYTE 0xff
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the return value from the tinyCBOR encoder and returns from function if an error is found.
+ */
+//--------------------------------------------------------------------------------------------------
+#define \
+    RETURN_IF_CBOR_ERROR( err ) \
+    ({ \
+        if (err != CborNoError) \
+        { \
+            LE_ERROR("CBOR encoding error %s", cbor_error_string(err)); \
+            return LE_FAULT; \
+        } \
+    })
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Chunk of compressed history
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t link;             ///< For adding to the chunk list of the time series.
+    size_t numBytes;                ///< Number of bytes used in the chunk.
+    uint8_t data[CHUNK_NUMBYTES];   ///< Compressed history.
+}
+Chunk_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data contained in time series
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct timeSeries_Series
+{
+    double timeStampFactor;         ///< Factor of time stamp.
+    uint64_t prevTimeStamp;         ///< Time stamp of last data capture, used for delta encoding.
+
+    double factor;                  ///< Factor of data.
+    union
+    {
+        int prevIntValue;           ///< Value of of last data capture - used for delta encoding.
+        double prevFloatValue;      ///< Value of last data capture - used for delta encoding.
+    };
+
+    uint32_t numSamples;            ///< Number of samples in the time series.
+
+    uint8_t* bufferPtr;             ///< Encoded samples which are not compressed yet.
+    size_t bufferNumBytes;          ///< Number of bytes in the buffer.
+
+    bool isDeflating;               ///< Has the compression stream been initialized?
+    z_stream stream;                ///< Compression stream.
+    size_t unflushedNumBytes;       ///< Bytes compressed since the stream was last flushed, which
+                                    ///  may still be held by the stream.
+
+    le_sls_List_t chunkList;        ///< Compressed history kept in RAM, oldest first.
+    size_t ramNumBytes;             ///< Number of bytes of compressed history kept in RAM.
+
+    int spillFd;                    ///< Spill file holding the oldest compressed history, or -1.
+    size_t spillNumBytes;           ///< Number of bytes of compressed history in the spill file.
+}
+Series_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample, with its value delta encoded.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    CborType type;                  ///< Type of the encoded value.
+    union
+    {
+        int64_t intValue;
+        double doubleValue;
+        bool boolValue;
+        const char* strValuePtr;
+    };
+}
+Sample_t;
+
+
+//--------------------------------------------------------------------------------------------------
+// Data structures
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pools for time series, their encoding buffer and their chunks.  Initialized in
+ * timeSeries_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SeriesPoolRef = NULL;
+static le_mem_PoolRef_t BufferPoolRef = NULL;
+static le_mem_PoolRef_t ChunkPoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Limits of a time series, and directory of the spill files.  Initialized in timeSeries_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t MaxRamBytes;
+static size_t MaxBytes;
+static char SpillDir[PATH_MAX];
+
+
+//--------------------------------------------------------------------------------------------------
+// Local functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the spill file of a time series.  The file is unlinked right away, so that it is removed
+ * when it is closed, including when the daemon stops or crashes.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenSpillFile
+(
+    Series_t* seriesPtr
+)
+{
+    char path[PATH_MAX];
+
+    if (le_dir_MakePath(SpillDir, S_IRWXU) != LE_OK)
+    {
+        LE_ERROR("Failed to create time series spill directory '%s'.", SpillDir);
+        return LE_FAULT;
+    }
+
+    if (snprintf(path, sizeof(path), "%s/timeSeriesXXXXXX", SpillDir) >= (int)sizeof(path))
+    {
+        LE_ERROR("Time series spill directory path '%s' is too long.", SpillDir);
+        return LE_FAULT;
+    }
+
+    seriesPtr->spillFd = mkstemp(path);
+
+    if (seriesPtr->spillFd == -1)
+    {
+        LE_ERROR("Failed to create time series spill file in '%s' (%m).", SpillDir);
+        return LE_FAULT;
+    }
+
+    unlink(path);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the oldest chunks of a time series to its spill file, until the compressed history kept in
+ * RAM is under the limit.  The last chunk is always kept, as the compression stream writes in it.
+ *
+ * If the chunks can't be written, they are kept in RAM.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Spill
+(
+    Series_t* seriesPtr
+)
+{
+    le_sls_Link_t* linkPtr;
+
+    while ((seriesPtr->ramNumBytes > MaxRamBytes) &&
+           ((linkPtr = le_sls_Peek(&seriesPtr->chunkList)) != NULL) &&
+           !le_sls_IsTail(&seriesPtr->chunkList, linkPtr))
+    {
+        Chunk_t* chunkPtr = CONTAINER_OF(linkPtr, Chunk_t, link);
+        size_t numWritten = 0;
+
+        if ((seriesPtr->spillFd == -1) && (OpenSpillFile(seriesPtr) != LE_OK))
+        {
+            return;
+        }
+
+        // Bytes written past spillNumBytes by a failed attempt are overwritten by the next one.
+        while (numWritten < chunkPtr->numBytes)
+        {
+            ssize_t result = pwrite(seriesPtr->spillFd,
+                                    chunkPtr->data + numWritten,
+                                    chunkPtr->numBytes - numWritten,
+                                    seriesPtr->spillNumBytes + numWritten);
+
+            if (result > 0)
+            {
+                numWritten += result;
+            }
+            else if ((result == -1) && (errno != EINTR))
+            {
+                LE_ERROR("Failed to write time series spill file (%m).");
+                return;
+            }
+        }
+
+        seriesPtr->spillNumBytes += chunkPtr->numBytes;
+        seriesPtr->ramNumBytes -= chunkPtr->numBytes;
+
+        le_sls_Pop(&seriesPtr->chunkList);
+        le_mem_Release(chunkPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compress the encoded samples of a time series, and empty its buffer.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Deflate
+(
+    Series_t* seriesPtr,
+    int flush                       ///< [IN] Z_NO_FLUSH, or Z_FINISH to finish the compression.
+)
+{
+    z_stream* streamPtr = &seriesPtr->stream;
+    int result;
+
+    if (!seriesPtr->isDeflating)
+    {
+        streamPtr->zalloc = Z_NULL;
+        streamPtr->zfree = Z_NULL;
+        streamPtr->opaque = Z_NULL;
+
+        result = deflateInit2(streamPtr,
+                              COMPRESSION_LEVEL,
+                              Z_DEFLATED,
+                              WINDOW_BITS,
+                              MEM_LEVEL,
+                              Z_DEFAULT_STRATEGY);
+        if (result != Z_OK)
+        {
+            LE_ERROR("Failed to initialize time series compression (%d).", result);
+            return LE_FAULT;
+        }
+
+        seriesPtr->isDeflating = true;
+    }
+
+    streamPtr->next_in = seriesPtr->bufferPtr;
+    streamPtr->avail_in = seriesPtr->bufferNumBytes;
+
+    // Compress directly in the last chunk, and in new chunks as they are filled.
+    do
+    {
+        le_sls_Link_t* linkPtr = le_sls_PeekTail(&seriesPtr->chunkList);
+        Chunk_t* chunkPtr = (linkPtr == NULL) ? NULL : CONTAINER_OF(linkPtr, Chunk_t, link);
+        size_t numBytes;
+
+        if ((chunkPtr == NULL) || (chunkPtr->numBytes == CHUNK_NUMBYTES))
+        {
+            chunkPtr = le_mem_ForceAlloc(ChunkPoolRef);
+            chunkPtr->link = LE_SLS_LINK_INIT;
+            chunkPtr->numBytes = 0;
+            le_sls_Queue(&seriesPtr->chunkList, &chunkPtr->link);
+        }
+
+        streamPtr->next_out = chunkPtr->data + chunkPtr->numBytes;
+        streamPtr->avail_out = CHUNK_NUMBYTES - chunkPtr->numBytes;
+
+        result = deflate(streamPtr, flush);
+        if (result == Z_STREAM_ERROR)
+        {
+            LE_ERROR("Time series compression error.");
+            return LE_FAULT;
+        }
+
+        numBytes = CHUNK_NUMBYTES - chunkPtr->numBytes - streamPtr->avail_out;
+        chunkPtr->numBytes += numBytes;
+        seriesPtr->ramNumBytes += numBytes;
+    }
+    while ((streamPtr->avail_out == 0) || ((flush == Z_FINISH) && (result != Z_STREAM_END)));
+
+    if (flush == Z_NO_FLUSH)
+    {
+        seriesPtr->unflushedNumBytes += seriesPtr->bufferNumBytes;
+    }
+    else
+    {
+        seriesPtr->unflushedNumBytes = 0;
+    }
+    seriesPtr->bufferNumBytes = 0;
+
+    Spill(seriesPtr);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a time series is within its maximum number of bytes, keeping CBOR_RESERVED_BYTES bytes
+ * to close the sample array and finish the compression.
+ *
+ * The bytes that may still be held by the compression stream, and the encoded samples which are
+ * not compressed yet, are counted as is, which is more than they take once compressed.  If that
+ * count is over the limit, the stream is flushed to get the exact number of compressed bytes.
+ *
+ * @return:
+ *      - LE_OK if the time series is within its limit.
+ *      - LE_NO_MEMORY if it isn't.
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CheckLimit
+(
+    Series_t* seriesPtr
+)
+{
+    size_t maxNumBytes = MaxBytes - CBOR_RESERVED_BYTES;
+
+    if ((seriesPtr->spillNumBytes + seriesPtr->ramNumBytes + seriesPtr->unflushedNumBytes +
+         seriesPtr->bufferNumBytes) <= maxNumBytes)
+    {
+        return LE_OK;
+    }
+
+    if ((seriesPtr->unflushedNumBytes > 0) || (seriesPtr->bufferNumBytes > 0))
+    {
+        if (Deflate(seriesPtr, Z_SYNC_FLUSH) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+    }
+
+    return ((seriesPtr->spillNumBytes + seriesPtr->ramNumBytes) <= maxNumBytes) ? LE_OK
+                                                                                : LE_NO_MEMORY;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encode a sample.
+ */
+//--------------------------------------------------------------------------------------------------
+static CborError EncodeSample
+(
+    CborEncoder* encoderPtr,
+    uint64_t timeStamp,
+    const Sample_t* samplePtr
+)
+{
+    CborError err = cbor_encode_int(encoderPtr, timeStamp);
+
+    if (err != CborNoError)
+    {
+        return err;
+    }
+
+    switch (samplePtr->type)
+    {
+        case CborIntegerType:
+            return cbor_encode_int(encoderPtr, samplePtr->intValue);
+
+        case CborDoubleType:
+            return cbor_encode_double(encoderPtr, samplePtr->doubleValue);
+
+        case CborBooleanType:
+            return cbor_encode_boolean(encoderPtr, samplePtr->boolValue);
+
+        case CborTextStringType:
+            return cbor_encode_text_stringz(encoderPtr, samplePtr->strValuePtr);
+
+        default:
+            return CborUnknownError;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a sample to a time series.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ *      - LE_OVERFLOW if the sample was not added as the time series is full.
+ *      - LE_NO_MEMORY if the sample was added but there is no space for next one.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddSample
+(
+    Series_t* seriesPtr,
+    uint64_t utcMilliSec,
+    const Sample_t* samplePtr
+)
+{
+    CborError err;
+    CborEncoder encoder;
+    uint8_t* startPtr;
+    uint64_t timeStamp;
+    struct timeval tv;
+    le_result_t result = CheckLimit(seriesPtr);
+
+    if (result != LE_OK)
+    {
+        return (result == LE_NO_MEMORY) ? LE_OVERFLOW : result;
+    }
+
+    // Get current system time if utc milli seconds is not provided.
+    // The time stamp is expected in UTC milli seconds by the server.
+    if (utcMilliSec == 0)
+    {
+        gettimeofday(&tv, NULL);
+        utcMilliSec = (uint64_t)(tv.tv_sec) * 1000 + (uint64_t)(tv.tv_usec) / 1000;
+    }
+
+    // For the first entry write the absolute value, for all other entries calculate delta.
+    if (seriesPtr->numSamples == 0)
+    {
+        timeStamp = utcMilliSec * seriesPtr->timeStampFactor;
+    }
+    else
+    {
+        timeStamp = (utcMilliSec - seriesPtr->prevTimeStamp) * seriesPtr->timeStampFactor;
+    }
+
+    // Encode the sample after the previous ones.  If the buffer is full, compress it and encode the
+    // sample again at its start.
+    startPtr = seriesPtr->bufferPtr + seriesPtr->bufferNumBytes;
+    cbor_encoder_init(&encoder, startPtr, ENCODE_BUFFER_NUMBYTES - seriesPtr->bufferNumBytes, 0);
+
+    err = EncodeSample(&encoder, timeStamp, samplePtr);
+
+    if (err == CborErrorOutOfMemory)
+    {
+        if (Deflate(seriesPtr, Z_NO_FLUSH) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        startPtr = seriesPtr->bufferPtr;
+        cbor_encoder_init(&encoder, startPtr, ENCODE_BUFFER_NUMBYTES, 0);
+
+        err = EncodeSample(&encoder, timeStamp, samplePtr);
+    }
+    RETURN_IF_CBOR_ERROR(err);
+
+    seriesPtr->bufferNumBytes += cbor_encoder_get_buffer_size(&encoder, startPtr);
+    seriesPtr->prevTimeStamp = utcMilliSec;
+    seriesPtr->numSamples++;
+
+    return CheckLimit(seriesPtr);
+}
+
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+// Interface functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeries_Init
+(
+    size_t maxRamBytes,         ///< [IN] Compressed bytes kept in RAM before spilling to a file.
+    size_t maxBytes,            ///< [IN] Maximum number of compressed bytes of a time series.
+    const char* spillDirPtr     ///< [IN] Directory of the spill files.
+)
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+    SeriesPoolRef = le_mem_CreatePool("TimeSeries data pool", sizeof(Series_t));
+    BufferPoolRef = le_mem_CreatePool("CBOR buffer pool", ENCODE_BUFFER_NUMBYTES);
+    ChunkPoolRef = le_mem_CreatePool("TimeSeries chunk pool", sizeof(Chunk_t));
+
+    // A time series can always hold as many samples as a full encoding buffer.
+    MaxBytes = (maxBytes < ENCODE_BUFFER_NUMBYTES) ? ENCODE_BUFFER_NUMBYTES : maxBytes;
+    MaxRamBytes = maxRamBytes;
+
+    LE_FATAL_IF(le_utf8_Copy(SpillDir, spillDirPtr, sizeof(SpillDir), NULL) != LE_OK,
+                "Time series spill directory path '%s' is too long.", spillDirPtr);
+
+    LE_DEBUG("Time series limits: %zu bytes, %zu bytes in RAM, spill directory '%s'.",
+             MaxBytes, MaxRamBytes, SpillDir);
+
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a time series and encode its header.
+ *
+ * @return
+ *      Reference to the time series, or NULL on error.
+ */
+//--------------------------------------------------------------------------------------------------
+timeSeries_Ref_t timeSeries_Create
+(
+    const char* headerIdPtr,    ///< [IN] Resource path of the field, e.g. "/0/1".
+    double factor,              ///< [IN] Multiplication factor used for delta encoding of data
+    double timeStampFactor      ///< [IN] Multiplication factor used for delta encoding of time stamp
+)
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+    Series_t* seriesPtr;
+    CborError err;
+    CborEncoder streamRef;
+    CborEncoder mapRef;
+    CborEncoder headerArray;
+    CborEncoder factorArray;
+    CborEncoder sampleRef;
+
+    seriesPtr = le_mem_ForceAlloc(SeriesPoolRef);
+
+    memset(seriesPtr, 0, sizeof(Series_t));
+
+    seriesPtr->factor = factor;
+    seriesPtr->timeStampFactor = timeStampFactor;
+    seriesPtr->bufferPtr = le_mem_ForceAlloc(BufferPoolRef);
+    seriesPtr->chunkList = LE_SLS_LIST_INIT;
+    seriesPtr->spillFd = -1;
+
+    // Initialize CBOR stream.
+    cbor_encoder_init(&streamRef, seriesPtr->bufferPtr, ENCODE_BUFFER_NUMBYTES, 0);
+
+    err = cbor_encoder_create_map(&streamRef, &mapRef, NUM_TIME_SERIES_MAPS);
+
+    // Create a map and add the header in to the map.
+    // e.g. "h" : [/1000/0]  --> map for header.
+    err |= cbor_encode_text_stringz(&mapRef, "h");
+    err |= cbor_encoder_create_array(&mapRef, &headerArray, 1);
+    err |= cbor_encode_text_stringz(&headerArray, headerIdPtr);
+    err |= cbor_encoder_close_container(&mapRef, &headerArray);
+
+    // Create an array of factors (time stamp factor, data factor)
+    // e.g. "f" : [1, 1]  --> map for factor.
+    err |= cbor_encode_text_stringz(&mapRef, "f");
+    err |= cbor_encoder_create_array(&mapRef, &factorArray, 2);
+    err |= cbor_encode_double(&factorArray, timeStampFactor);
+    err |= cbor_encode_double(&factorArray, factor);
+    err |= cbor_encoder_close_container(&mapRef, &factorArray);
+
+    // Create an array for samples. The sample array will have time stamp and data pair.  The array
+    // is left open: the samples are encoded after it with their own encoder, and the array is
+    // closed by timeSeries_Finish().
+    err |= cbor_encode_text_stringz(&mapRef, "s");
+    err |= cbor_encoder_create_array(&mapRef, &sampleRef, CborIndefiniteLength);
+
+    if (err != CborNoError)
+    {
+        LE_ERROR("CBOR encoding error %s", cbor_error_string(err));
+        timeSeries_Delete(seriesPtr);
+        return NULL;
+    }
+
+    seriesPtr->bufferNumBytes = cbor_encoder_get_buffer_size(&sampleRef, seriesPtr->bufferPtr);
+
+    return seriesPtr;
+
+#else
+    LE_ERROR("Time series not supported.");
+    return NULL;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a time series and the history it holds.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeries_Delete
+(
+    timeSeries_Ref_t seriesRef  ///< [IN] Time series
+)
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+    le_sls_Link_t* linkPtr;
+
+    if (seriesRef->isDeflating)
+    {
+        deflateEnd(&seriesRef->stream);
+    }
+
+    while ((linkPtr = le_sls_Pop(&seriesRef->chunkList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, Chunk_t, link));
+    }
+
+    if (seriesRef->spillFd != -1)
+    {
+        close(seriesRef->spillFd);
+    }
+
+    le_mem_Release(seriesRef->bufferPtr);
+    le_mem_Release(seriesRef);
+
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an integer sample.  The time stamp is in milli seconds since epoch, or 0 to use the current
+ * system time.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ *      - LE_OVERFLOW if the sample was not added as the time series is full.
+ *      - LE_NO_MEMORY if the sample was added but there is no space for next one.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddInt
+(
+    timeSeries_Ref_t seriesRef, ///< [IN] Time series
+    uint64_t utcMilliSec,       ///< [IN] Time stamp
+    int value                   ///< [IN] Value
+)
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+    le_result_t result;
+    int intDelta;
+
+    if (seriesRef->numSamples == 0)
+    {
+        intDelta = value * seriesRef->factor;
+    }
+    else
+    {
+        intDelta = (value - seriesRef->prevIntValue) * seriesRef->factor;
+    }
+
+    result = AddSample(seriesRef, utcMilliSec,
+                       &(Sample_t){ .type = CborIntegerType, .intValue = intDelta });
+
+    if ((result == LE_OK) || (result == LE_NO_MEMORY))
+    {
+        seriesRef->prevIntValue = value;
+    }
+
+    return result;
+
+#else
+    return LE_FAULT;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a float sample.  See timeSeries_AddInt().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddFloat
+(
+    timeSeries_Ref_t seriesRef, ///< [IN] Time series
+    uint64_t utcMilliSec,       ///< [IN] Time stamp
+    double value                ///< [IN] Value
+)
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+    le_result_t result;
+    double floatDelta;
+    Sample_t sample;
+
+    // ToDO: float doesn't benefit from use of factor - investigate.
+    if (seriesRef->numSamples == 0)
+    {
+        floatDelta = value * seriesRef->factor;
+    }
+    else
+    {
+        floatDelta = (value - seriesRef->prevFloatValue) * seriesRef->factor;
+    }
+
+    if ((uint64_t)seriesRef->factor == 1)
+    {
+        sample.type = CborDoubleType;
+        sample.doubleValue = floatDelta;
+    }
+    else
+    {
+        // Float data encoded as integer.
+        sample.type = CborIntegerType;
+        sample.intValue = (int64_t)floatDelta;
+    }
+
+    result = AddSample(seriesRef, utcMilliSec, &sample);
+
+    if ((result == LE_OK) || (result == LE_NO_MEMORY))
+    {
+        seriesRef->prevFloatValue = value;
+    }
+
+    return result;
+
+#else
+    return LE_FAULT;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a boolean sample.  See timeSeries_AddInt().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddBool
+(
+    timeSeries_Ref_t seriesRef, ///< [IN] Time series
+    uint64_t utcMilliSec,       ///< [IN] Time stamp
+    bool value                  ///< [IN] Value
+)
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+    return AddSample(seriesRef, utcMilliSec,
+                     &(Sample_t){ .type = CborBooleanType, .boolValue = value });
+
+#else
+    return LE_FAULT;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a string sample.  See timeSeries_AddInt().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddString
+(
+    timeSeries_Ref_t seriesRef, ///< [IN] Time series
+    uint64_t utcMilliSec,       ///< [IN] Time stamp
+    const char* valuePtr        ///< [IN] Value
+)
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+    return AddSample(seriesRef, utcMilliSec,
+                     &(Sample_t){ .type = CborTextStringType, .strValuePtr = valuePtr });
+
+#else
+    return LE_FAULT;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of samples of a time series.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t timeSeries_GetNumSamples
+(
+    timeSeries_Ref_t seriesRef  ///< [IN] Time series
+)
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+    return seriesRef->numSamples;
+#else
+    return 0;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the factors of a time series.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeries_GetFactors
+(
+    timeSeries_Ref_t seriesRef, ///< [IN] Time series
+    double* factorPtr,          ///< [OUT] Multiplication factor of data
+    double* timeStampFactorPtr  ///< [OUT] Multiplication factor of time stamp
+)
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+    *factorPtr = seriesRef->factor;
+    *timeStampFactorPtr = seriesRef->timeStampFactor;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the sample array and finish the compression of a time series, and get its compressed
+ * history in one buffer.  No sample can be added to the time series after this.
+ *
+ * @return:
+ *      - LE_OK on success, the buffer must then be freed with free().
+ *      - LE_NO_MEMORY if the buffer could not be allocated.
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_Finish
+(
+    timeSeries_Ref_t seriesRef, ///< [IN] Time series
+    uint8_t** bufferPtrPtr,     ///< [OUT] Compressed history
+    size_t* numBytesPtr         ///< [OUT] Number of bytes of the compressed history
+)
+{
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+    le_sls_Link_t* linkPtr;
+    uint8_t* bufferPtr;
+    size_t numBytes = 0;
+
+    // Close the sample array.  The map has a definite length, so it is then complete.
+    if (seriesRef->bufferNumBytes == ENCODE_BUFFER_NUMBYTES)
+    {
+        if (Deflate(seriesRef, Z_NO_FLUSH) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+    }
+    seriesRef->bufferPtr[seriesRef->bufferNumBytes++] = CBOR_BREAK_BYTE;
+
+    if (Deflate(seriesRef, Z_FINISH) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    // The payload has to be sent in one buffer, which can be bigger than any memory pool block.
+    bufferPtr = malloc(seriesRef->spillNumBytes + seriesRef->ramNumBytes);
+
+    if (bufferPtr == NULL)
+    {
+        LE_ERROR("Failed to allocate %zu bytes for time series.",
+                 seriesRef->spillNumBytes + seriesRef->ramNumBytes);
+        return LE_NO_MEMORY;
+    }
+
+    while (numBytes < seriesRef->spillNumBytes)
+    {
+        ssize_t result = pread(seriesRef->spillFd,
+                               bufferPtr + numBytes,
+                               seriesRef->spillNumBytes - numBytes,
+                               numBytes);
+
+        if ((result == 0) || ((result == -1) && (errno != EINTR)))
+        {
+            LE_ERROR("Failed to read time series spill file (%m).");
+            free(bufferPtr);
+            return LE_FAULT;
+        }
+        else if (result > 0)
+        {
+            numBytes += result;
+        }
+    }
+
+    for (linkPtr = le_sls_Peek(&seriesRef->chunkList);
+         linkPtr != NULL;
+         linkPtr = le_sls_PeekNext(&seriesRef->chunkList, linkPtr))
+    {
+        Chunk_t* chunkPtr = CONTAINER_OF(linkPtr, Chunk_t, link);
+
+        memcpy(bufferPtr + numBytes, chunkPtr->data, chunkPtr->numBytes);
+        numBytes += chunkPtr->numBytes;
+    }
+
+    *bufferPtrPtr = bufferPtr;
+    *numBytesPtr = numBytes;
+
+    return LE_OK;
+
+#else
+    return LE_FAULT;
+#endif
+}
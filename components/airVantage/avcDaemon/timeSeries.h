@@ -0,0 +1,196 @@
+/**
+ * @file timeSeries.h
+ *
+ * Interface for the time series sub-component, which accumulates the history of an asset field.
+ *
+ * Samples are delta encoded, CBOR encoded and compressed as they are added, so a time series only
+ * keeps the compressed history in memory.  The compressed history is kept in chunks which are
+ * allocated as the history grows, up to a maximum number of bytes per time series.  Beyond another,
+ * smaller, number of bytes, the oldest chunks are moved to a file in the spill directory.
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef LEGATO_TIME_SERIES_INCLUDE_GUARD
+#define LEGATO_TIME_SERIES_INCLUDE_GUARD
+
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+// Definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Number of maps (called objects in JSON) in the CBOR encoded data (header, factor & sample).
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_TIME_SERIES_MAPS 3
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Number of bytes reserved in the CBOR stream. After all the samples are added to CBOR stream few
+ *  more bytes are needed to close the sample array and the stream.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_RESERVED_BYTES 32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a time series.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct timeSeries_Series* timeSeries_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+// Interface functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeries_Init
+(
+    size_t maxRamBytes,         ///< [IN] Compressed bytes kept in RAM before spilling to a file.
+    size_t maxBytes,            ///< [IN] Maximum number of compressed bytes of a time series.
+    const char* spillDirPtr     ///< [IN] Directory of the spill files.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a time series and encode its header.
+ *
+ * @return
+ *      Reference to the time series, or NULL on error.
+ */
+//--------------------------------------------------------------------------------------------------
+timeSeries_Ref_t timeSeries_Create
+(
+    const char* headerIdPtr,    ///< [IN] Resource path of the field, e.g. "/0/1".
+    double factor,              ///< [IN] Multiplication factor used for delta encoding of data
+    double timeStampFactor      ///< [IN] Multiplication factor used for delta encoding of time stamp
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a time series and the history it holds.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeries_Delete
+(
+    timeSeries_Ref_t seriesRef  ///< [IN] Time series
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an integer sample.  The time stamp is in milli seconds since epoch, or 0 to use the current
+ * system time.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ *      - LE_OVERFLOW if the sample was not added as the time series is full.
+ *      - LE_NO_MEMORY if the sample was added but there is no space for next one.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddInt
+(
+    timeSeries_Ref_t seriesRef, ///< [IN] Time series
+    uint64_t utcMilliSec,       ///< [IN] Time stamp
+    int value                   ///< [IN] Value
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a float sample.  See timeSeries_AddInt().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddFloat
+(
+    timeSeries_Ref_t seriesRef, ///< [IN] Time series
+    uint64_t utcMilliSec,       ///< [IN] Time stamp
+    double value                ///< [IN] Value
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a boolean sample.  See timeSeries_AddInt().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddBool
+(
+    timeSeries_Ref_t seriesRef, ///< [IN] Time series
+    uint64_t utcMilliSec,       ///< [IN] Time stamp
+    bool value                  ///< [IN] Value
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a string sample.  See timeSeries_AddInt().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddString
+(
+    timeSeries_Ref_t seriesRef, ///< [IN] Time series
+    uint64_t utcMilliSec,       ///< [IN] Time stamp
+    const char* valuePtr        ///< [IN] Value
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of samples of a time series.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t timeSeries_GetNumSamples
+(
+    timeSeries_Ref_t seriesRef  ///< [IN] Time series
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the factors of a time series.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeries_GetFactors
+(
+    timeSeries_Ref_t seriesRef, ///< [IN] Time series
+    double* factorPtr,          ///< [OUT] Multiplication factor of data
+    double* timeStampFactorPtr  ///< [OUT] Multiplication factor of time stamp
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the sample array and finish the compression of a time series, and get its compressed
+ * history in one buffer.  No sample can be added to the time series after this.
+ *
+ * @return:
+ *      - LE_OK on success, the buffer must then be freed with free().
+ *      - LE_NO_MEMORY if the buffer could not be allocated.
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_Finish
+(
+    timeSeries_Ref_t seriesRef, ///< [IN] Time series
+    uint8_t** bufferPtrPtr,     ///< [OUT] Compressed history
+    size_t* numBytesPtr         ///< [OUT] Number of bytes of the compressed history
+);
+
+#endif // LEGATO_TIME_SERIES_INCLUDE_GUARD
@@ -105,6 +105,13 @@
 //--------------------------------------------------------------------------------------------------
 #define UNSOLICITED_POOL_SIZE 10
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unsolicited pattern trie nodes pool size (one node per pattern character)
+ */
+//--------------------------------------------------------------------------------------------------
+#define UNSOLICITED_NODE_POOL_SIZE  (UNSOLICITED_POOL_SIZE * 8)
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Rx Buffer length
@@ -235,6 +242,25 @@ typedef struct RxParser
 }
 RxParser_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Node of the unsolicited patterns trie.
+ *
+ * Each node stands for one character of the patterns going through it, and lists the unsolicited
+ * subscriptions whose pattern ends there.  The patterns matching a received line are then found
+ * by walking down the trie along the line, instead of comparing the line with each pattern.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct UnsolNode
+{
+    struct UnsolNode* childPtr;         ///< First child node
+    struct UnsolNode* siblingPtr;       ///< Next node with the same parent
+    le_dls_List_t     unsolList;        ///< Unsolicited whose pattern ends at this node
+    char              character;        ///< Pattern character of this node
+}
+UnsolNode_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Unsolicited structure
@@ -249,10 +275,14 @@ typedef struct
     char          unsolBuffer[LE_ATDEFS_UNSOLICITED_MAX_BYTES]; ///< Unsolicited buffer
     uint32_t      lineCount;                                    ///< Unsolicited lines number
     uint32_t      lineCounter;                                  ///< Received line counter
+    uint32_t      lastLine;                                     ///< Last received line added
     bool          inProgress;                                   ///< Reception in progress
     le_atClient_UnsolicitedResponseHandlerRef_t ref;            ///< Unsolicited reference
     DeviceContextPtr_t interfacePtr;                            ///< device context
     le_dls_Link_t link;                                         ///< link in Unsolicited List
+    UnsolNode_t*  nodePtr;                                      ///< trie node of the pattern
+    le_dls_Link_t nodeLink;                                     ///< link in trie node list
+    le_dls_Link_t progressLink;                                 ///< link in in progress list
     le_msg_SessionRef_t sessionRef;                             ///< client session reference
 }
 Unsolicited_t;
@@ -274,6 +304,9 @@ typedef struct DeviceContext
     le_timer_Ref_t  timerRef;           ///< command timer
     le_dls_List_t   atCommandList;      ///< List of command waiting for execution
     le_dls_List_t   unsolicitedList;    ///< unsolicited command list
+    UnsolNode_t     unsolTrie;          ///< root of the unsolicited patterns trie
+    le_dls_List_t   unsolProgressList;  ///< unsolicited with a reception in progress
+    uint32_t        unsolLineCount;     ///< received lines counter, for unsolicited checking
     le_sem_Ref_t    waitingSemaphore;   ///< semaphore used for synchronization
     le_atClient_DeviceRef_t ref;        ///< reference of the device context
     le_msg_SessionRef_t sessionRef;     ///< client session reference
@@ -338,6 +371,13 @@ static le_mem_PoolRef_t  RspStringPool;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t  UnsolicitedPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for unsolicited patterns trie nodes
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t  UnsolNodePool;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Map for AT commands
@@ -372,68 +412,215 @@ static void UpdateTransitionManager(ClientStatePtr_t  parserStatePtr,
 static void SendLine(RxParserPtr_t charParserPtr);
 static void SendData(RxParserPtr_t charParserPtr);
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to find the child of a trie node for a pattern character.
+ *
+ * @return pointer to the child node, or NULL if there is none
+ */
+//--------------------------------------------------------------------------------------------------
+static UnsolNode_t* FindUnsolNode
+(
+    UnsolNode_t* nodePtr,
+    char         character
+)
+{
+    UnsolNode_t* childPtr = nodePtr->childPtr;
+
+    while ((childPtr != NULL) && (childPtr->character != character))
+    {
+        childPtr = childPtr->siblingPtr;
+    }
+
+    return childPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to add the trie nodes of an unsolicited pattern.
+ *
+ * @return pointer to the node where the pattern ends
+ */
+//--------------------------------------------------------------------------------------------------
+static UnsolNode_t* AddUnsolNodes
+(
+    UnsolNode_t* nodePtr,
+    const char*  patternPtr
+)
+{
+    for (; *patternPtr != '\0'; patternPtr++)
+    {
+        UnsolNode_t* childPtr = FindUnsolNode(nodePtr, *patternPtr);
+
+        if (childPtr == NULL)
+        {
+            childPtr = le_mem_ForceAlloc(UnsolNodePool);
+            childPtr->childPtr = NULL;
+            childPtr->siblingPtr = nodePtr->childPtr;
+            childPtr->unsolList = LE_DLS_LIST_INIT;
+            childPtr->character = *patternPtr;
+
+            nodePtr->childPtr = childPtr;
+        }
+
+        nodePtr = childPtr;
+    }
+
+    return nodePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to remove the trie nodes of an unsolicited pattern which are not used by
+ * other patterns anymore.
+ *
+ * @return true if the node itself is not used anymore
+ */
+//--------------------------------------------------------------------------------------------------
+static bool RemoveUnsolNodes
+(
+    UnsolNode_t* nodePtr,
+    const char*  patternPtr
+)
+{
+    if (*patternPtr != '\0')
+    {
+        UnsolNode_t** childPtrPtr = &nodePtr->childPtr;
+
+        while ((*childPtrPtr)->character != *patternPtr)
+        {
+            childPtrPtr = &(*childPtrPtr)->siblingPtr;
+        }
+
+        UnsolNode_t* childPtr = *childPtrPtr;
+
+        if (RemoveUnsolNodes(childPtr, patternPtr + 1))
+        {
+            *childPtrPtr = childPtr->siblingPtr;
+            le_mem_Release(childPtr);
+        }
+    }
+
+    return ((nodePtr->childPtr == NULL) && le_dls_IsEmpty(&nodePtr->unsolList));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to add a received line to an unsolicited response, and to call the
+ * unsolicited handler when all its lines are received.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddUnsolicitedLine
+(
+    Unsolicited_t* unsolPtr,
+    char*          unsolRspPtr,
+    size_t         stringSize
+)
+{
+    DeviceContext_t* interfacePtr = unsolPtr->interfacePtr;
+
+    uint32_t len =
+        (stringSize < LE_ATDEFS_UNSOLICITED_MAX_LEN-strlen(unsolPtr->unsolBuffer)) ?
+        stringSize :
+        LE_ATDEFS_UNSOLICITED_MAX_LEN-strlen(unsolPtr->unsolBuffer);
+
+    strncpy(unsolPtr->unsolBuffer+strlen(unsolPtr->unsolBuffer), unsolRspPtr, len);
+
+    unsolPtr->lastLine = interfacePtr->unsolLineCount;
+
+    if (!unsolPtr->inProgress)
+    {
+        unsolPtr->inProgress = true;
+        le_dls_Queue(&interfacePtr->unsolProgressList, &unsolPtr->progressLink);
+    }
+
+    if ( (unsolPtr->lineCount - unsolPtr->lineCounter) == 1 )
+    {
+        unsolPtr->handlerPtr(unsolPtr->unsolBuffer, unsolPtr->contextPtr );
+        memset(unsolPtr->unsolBuffer,0,LE_ATDEFS_UNSOLICITED_MAX_BYTES);
+        unsolPtr->lineCounter = 0;
+        unsolPtr->inProgress = false;
+        le_dls_Remove(&interfacePtr->unsolProgressList, &unsolPtr->progressLink);
+    }
+    else
+    {
+        if (LE_ATDEFS_UNSOLICITED_MAX_LEN - strlen(unsolPtr->unsolBuffer) >= 2)
+        {
+            snprintf( unsolPtr->unsolBuffer+strlen(unsolPtr->unsolBuffer),
+           LE_ATDEFS_UNSOLICITED_MAX_BYTES,
+            "\r\n" );
+        }
+
+        unsolPtr->lineCounter++;
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is used to check if the received data matches with a subscribed unsolicited
  * response.
  *
+ * The unsolicited responses already in progress get the line first, then the line is classified
+ * in one pass by walking down the patterns trie: each node reached on the way ends the patterns
+ * which are a prefix of the line.
+ *
  */
 //--------------------------------------------------------------------------------------------------
 static void CheckUnsolicited
 (
     char* unsolRspPtr,
     size_t stringSize,
-    le_dls_List_t *unsolListPtr
+    DeviceContext_t* interfacePtr
 )
 {
     LE_DEBUG("Start checking unsolicited");
 
-    le_dls_Link_t* linkPtr = le_dls_Peek(unsolListPtr);
+    interfacePtr->unsolLineCount++;
 
-    /* Browse all the queue while the string is not found */
+    le_dls_Link_t* linkPtr = le_dls_Peek(&interfacePtr->unsolProgressList);
+
+    /* Continue the unsolicited responses in progress */
     while (linkPtr != NULL)
     {
         Unsolicited_t *unsolPtr = CONTAINER_OF(linkPtr,
                                                Unsolicited_t,
-                                                link);
+                                               progressLink);
 
-        if ((strncmp(unsolPtr->unsolRsp,unsolRspPtr,strlen(unsolPtr->unsolRsp)) == 0) ||
-            (unsolPtr->inProgress))
-        {
-            LE_DEBUG("unsol found");
-            uint32_t len =
-                (stringSize < LE_ATDEFS_UNSOLICITED_MAX_LEN-strlen(unsolPtr->unsolBuffer)) ?
-                stringSize :
-                LE_ATDEFS_UNSOLICITED_MAX_LEN-strlen(unsolPtr->unsolBuffer);
+        linkPtr = le_dls_PeekNext(&interfacePtr->unsolProgressList, linkPtr);
 
-            strncpy(unsolPtr->unsolBuffer+strlen(unsolPtr->unsolBuffer), unsolRspPtr, len);
+        AddUnsolicitedLine(unsolPtr, unsolRspPtr, stringSize);
+    }
 
-            unsolPtr->inProgress = true;
-        }
+    /* Start the unsolicited responses whose pattern is a prefix of the line */
+    UnsolNode_t* nodePtr = &interfacePtr->unsolTrie;
+    size_t idx = 0;
+
+    while (nodePtr != NULL)
+    {
+        linkPtr = le_dls_Peek(&nodePtr->unsolList);
 
-        if (unsolPtr->inProgress)
+        while (linkPtr != NULL)
         {
-            if ( (unsolPtr->lineCount - unsolPtr->lineCounter) == 1 )
+            Unsolicited_t *unsolPtr = CONTAINER_OF(linkPtr,
+                                                   Unsolicited_t,
+                                                   nodeLink);
+
+            linkPtr = le_dls_PeekNext(&nodePtr->unsolList, linkPtr);
+
+            if (unsolPtr->lastLine != interfacePtr->unsolLineCount)
             {
-                unsolPtr->handlerPtr(unsolPtr->unsolBuffer, unsolPtr->contextPtr );
-                memset(unsolPtr->unsolBuffer,0,LE_ATDEFS_UNSOLICITED_MAX_BYTES);
-                unsolPtr->lineCounter = 0;
-                unsolPtr->inProgress = false;
+                LE_DEBUG("unsol found");
+                AddUnsolicitedLine(unsolPtr, unsolRspPtr, stringSize);
             }
-            else
-            {
-                if (LE_ATDEFS_UNSOLICITED_MAX_LEN - strlen(unsolPtr->unsolBuffer) >= 2)
-                {
-                    snprintf( unsolPtr->unsolBuffer+strlen(unsolPtr->unsolBuffer),
-                   LE_ATDEFS_UNSOLICITED_MAX_BYTES,
-                    "\r\n" );
-                }
+        }
 
-                unsolPtr->lineCounter++;
-            }
+        if (idx == stringSize)
+        {
+            break;
         }
 
-        linkPtr = le_dls_PeekNext(unsolListPtr, linkPtr);
+        nodePtr = FindUnsolNode(nodePtr, unsolRspPtr[idx++]);
     }
 
     LE_DEBUG("Stop checking unsolicited");
@@ -658,12 +845,6 @@ static void DestroyDeviceThread
 
     LE_DEBUG("Destroy thread for interface %d", interfacePtr->device.fd);
 
-    while ((linkPtr=le_dls_Pop(&interfacePtr->unsolicitedList)) != NULL)
-    {
-        Unsolicited_t *unsolPtr = CONTAINER_OF(linkPtr, Unsolicited_t, link);
-        le_mem_Release(unsolPtr);
-    }
-
     while ((linkPtr=le_dls_Pop(&interfacePtr->atCommandList)) != NULL)
     {
         AtCmd_t* atCmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
@@ -1027,7 +1208,7 @@ static void WaitingState
 
             CheckUnsolicited((char*)&(parserPtr->buffer[parserPtr->idxLastCrLf]),
                               lineSize,
-                              &interfacePtr->unsolicitedList);
+                              interfacePtr);
             break;
         }
         default:
@@ -1219,6 +1400,47 @@ static void AtCmdPoolDestructor
     le_ref_DeleteRef(CmdRefMap, oldPtr->ref);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is queued to a device thread to make it exit, once it has run the functions queued
+ * to it before.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ExitDeviceThread
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    le_thread_Exit(NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to release the nodes of an unsolicited patterns trie below a node.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseUnsolNodes
+(
+    UnsolNode_t* nodePtr
+)
+{
+    UnsolNode_t* childPtr = nodePtr->childPtr;
+
+    while (childPtr != NULL)
+    {
+        UnsolNode_t* siblingPtr = childPtr->siblingPtr;
+
+        ReleaseUnsolNodes(childPtr);
+        le_mem_Release(childPtr);
+        childPtr = siblingPtr;
+    }
+
+    nodePtr->childPtr = NULL;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is the destructor for DeviceContext_t struct
@@ -1231,14 +1453,29 @@ static void DevicesPoolDestructor
 )
 {
     DeviceContext_t* interfacePtr = ptr;
+    le_dls_Link_t* linkPtr;
+
+    // Let the device thread add and remove the unsolicited subscriptions already queued to it,
+    // rather than cancelling it, which would drop them and leak the subscriptions.
+    le_event_QueueFunctionToThread(interfacePtr->threadRef, ExitDeviceThread, NULL, NULL);
+
+    le_thread_Join(interfacePtr->threadRef,NULL);
 
-    if (le_thread_Cancel(interfacePtr->threadRef))
+    // No thread uses the subscriptions and the patterns trie of the device anymore.
+    while ((linkPtr=le_dls_Pop(&interfacePtr->unsolicitedList)) != NULL)
     {
-        LE_ERROR("failed to Cancel device thread");
-        return;
+        Unsolicited_t *unsolPtr = CONTAINER_OF(linkPtr, Unsolicited_t, link);
+
+        // The subscription may not have been removed by its client.
+        if (le_ref_Lookup(UnsolRefMap, unsolPtr->ref) == unsolPtr)
+        {
+            le_ref_DeleteRef(UnsolRefMap, unsolPtr->ref);
+        }
+
+        le_mem_Release(unsolPtr);
     }
 
-    le_thread_Join(interfacePtr->threadRef,NULL);
+    ReleaseUnsolNodes(&interfacePtr->unsolTrie);
 
     le_ref_DeleteRef(DevicesRefMap, interfacePtr->ref);
 
@@ -1256,10 +1493,11 @@ static void UnsolicitedPoolDestructor
 )
 {
     Unsolicited_t* unsolicitedPtr = ptr;
+    DeviceContext_t* interfacePtr = unsolicitedPtr->interfacePtr;
     le_dls_List_t* listPtr;
     le_dls_Link_t* linkPtr;
 
-    listPtr = &unsolicitedPtr->interfacePtr->unsolicitedList;
+    listPtr = &interfacePtr->unsolicitedList;
     linkPtr = &unsolicitedPtr->link;
 
     LE_DEBUG("Destroy unsolicited %s", unsolicitedPtr->unsolRsp);
@@ -1268,6 +1506,17 @@ static void UnsolicitedPoolDestructor
     {
         le_dls_Remove(listPtr, linkPtr);
     }
+
+    if (unsolicitedPtr->inProgress)
+    {
+        le_dls_Remove(&interfacePtr->unsolProgressList, &unsolicitedPtr->progressLink);
+    }
+
+    if (unsolicitedPtr->nodePtr != NULL)
+    {
+        le_dls_Remove(&unsolicitedPtr->nodePtr->unsolList, &unsolicitedPtr->nodeLink);
+        RemoveUnsolNodes(&interfacePtr->unsolTrie, unsolicitedPtr->unsolRsp);
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1306,6 +1555,31 @@ static char* GetIntermediateResponse
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function adds an unsolicited response subscription to the device's patterns trie.  It runs
+ * in the device thread, which uses the trie.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddUnsolicited
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    Unsolicited_t* unsolicitedPtr = param1Ptr;
+    DeviceContext_t* interfacePtr = unsolicitedPtr->interfacePtr;
+
+    le_dls_Queue(&interfacePtr->unsolicitedList, &unsolicitedPtr->link);
+
+    unsolicitedPtr->nodePtr = AddUnsolNodes(&interfacePtr->unsolTrie, unsolicitedPtr->unsolRsp);
+    le_dls_Queue(&unsolicitedPtr->nodePtr->unsolList, &unsolicitedPtr->nodeLink);
+
+    // Release the reference taken for this function: the subscription may have been removed
+    // in the meantime.
+    le_mem_Release(unsolicitedPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function removes an unsolicited response subscription.
@@ -2013,9 +2287,17 @@ le_atClient_UnsolicitedResponseHandlerRef_t le_atClient_AddUnsolicitedResponseHa
     unsolicitedPtr->ref = le_ref_CreateRef(UnsolRefMap, unsolicitedPtr);
     unsolicitedPtr->interfacePtr = interfacePtr;
     unsolicitedPtr->link = LE_DLS_LINK_INIT;
+    unsolicitedPtr->nodePtr = NULL;
+    unsolicitedPtr->nodeLink = LE_DLS_LINK_INIT;
+    unsolicitedPtr->progressLink = LE_DLS_LINK_INIT;
     unsolicitedPtr->sessionRef = le_atClient_GetClientSessionRef();
 
-    le_dls_Queue(&interfacePtr->unsolicitedList, &unsolicitedPtr->link);
+    // The patterns trie is only used by the device thread.
+    le_mem_AddRef(unsolicitedPtr);
+    le_event_QueueFunctionToThread(interfacePtr->threadRef,
+                                   AddUnsolicited,
+                                   (void*) unsolicitedPtr,
+                                   (void*) NULL);
 
     return unsolicitedPtr->ref;
 }
@@ -2069,7 +2351,13 @@ static void CloseSessionEventHandler
         {
             if (sessionRef == unsolPtr->sessionRef)
             {
-                le_mem_Release(unsolPtr);
+                // The patterns trie is only used by the device thread.
+                le_event_QueueFunctionToThread(unsolPtr->interfacePtr->threadRef,
+                                               RemoveUnsolicited,
+                                               (void*) unsolPtr,
+                                               (void*) NULL);
+
+                le_ref_DeleteRef(UnsolRefMap, unsolPtr->ref);
             }
         }
     }
@@ -2219,6 +2507,10 @@ COMPONENT_INIT
     le_mem_SetDestructor(UnsolicitedPool,UnsolicitedPoolDestructor);
     UnsolRefMap = le_ref_CreateMap("UnsolRefMap", UNSOLICITED_POOL_SIZE);
 
+    // Unsolicited patterns trie pool allocation
+    UnsolNodePool = le_mem_CreatePool("AtUnsolNodePool",sizeof(UnsolNode_t));
+    le_mem_ExpandPool(UnsolNodePool,UNSOLICITED_NODE_POOL_SIZE);
+
     // Add a handler to the close session service
     le_msg_AddServiceCloseHandler(
         le_atClient_GetServiceRef(), CloseSessionEventHandler, NULL);
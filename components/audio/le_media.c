@@ -57,6 +57,21 @@
 //--------------------------------------------------------------------------------------------------
 #define NO_MORE_SAMPLES_INFINITE_TIMEOUT -1
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffer batching the recorded samples before they are written in a WAV file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define WAV_REC_BUFFER_SIZE     (32*1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Amount of recorded data after which the header of a WAV file is updated. The header is also
+ * updated when the recording is stopped.
+ */
+//--------------------------------------------------------------------------------------------------
+#define WAV_REC_CHECKPOINT_SIZE (4*WAV_REC_BUFFER_SIZE)
+
 //--------------------------------------------------------------------------------------------------
 // Data structures.
 //--------------------------------------------------------------------------------------------------
@@ -108,7 +123,12 @@ DtmfParams_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    uint32_t recordingSize;      ///< recording Wav file size
+    WavHeader_t hdr;                          ///< Header of the recorded file
+    bool        isSeekable;                   ///< The header can be updated
+    uint32_t    recordingSize;                ///< Data size written in the recorded file
+    uint32_t    checkpointSize;               ///< Data size written in the header
+    uint32_t    bufferLen;                    ///< Length of the data pending in the buffer
+    uint8_t     buffer[WAV_REC_BUFFER_SIZE];  ///< Buffer of the data pending to be written
 }
 WavParams_t;
 
@@ -540,7 +560,8 @@ static le_result_t PlayTone
 static le_result_t SetWavHeader
 (
     int32_t      fd,
-    le_audio_SamplePcmConfig_t* pcmConfigPtr
+    le_audio_SamplePcmConfig_t* pcmConfigPtr,
+    WavHeader_t* hdrPtr
 )
 {
     WavHeader_t hdr;
@@ -559,6 +580,7 @@ static le_result_t SetWavHeader
     hdr.dataId = ID_DATA;
     hdr.dataSize = 0;
     hdr.riffSize = hdr.dataSize + 44 - 8;
+    memcpy(hdrPtr, &hdr, sizeof(hdr));
     if (WriteFd(fd, &hdr, sizeof(hdr)) != sizeof(hdr))
     {
         LE_ERROR("Cannot write wave header");
@@ -659,10 +681,83 @@ static le_result_t AmrWriteFd
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the data size in the header of a recorded WAV file.
+ *
+ * The header is written in place, without moving the file offset. It is only updated once the
+ * data is written, so that it never covers more data than the file contains.
+ *
+ * @return LE_OK    on success
+ * @return LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t UpdateWavHeader
+(
+    int32_t      fd,                ///< [IN] File descriptor of the recorded file
+    WavParams_t* wavParamPtr        ///< [IN] WAV parameters
+)
+{
+    if ((!wavParamPtr->isSeekable) || (wavParamPtr->checkpointSize == wavParamPtr->recordingSize))
+    {
+        return LE_OK;
+    }
+
+    wavParamPtr->hdr.dataSize = wavParamPtr->recordingSize;
+    wavParamPtr->hdr.riffSize = wavParamPtr->recordingSize + sizeof(WavHeader_t) - 8;
+
+    if (pwrite(fd, &wavParamPtr->hdr, sizeof(WavHeader_t), 0) != sizeof(WavHeader_t))
+    {
+        LE_ERROR("Cannot update wave header, errno %d", errno);
+        return LE_FAULT;
+    }
+
+    wavParamPtr->checkpointSize = wavParamPtr->recordingSize;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the data pending in the buffer of a recorded WAV file, and update the header when a
+ * checkpoint is reached.
+ *
+ * @return LE_OK    on success
+ * @return LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlushWavBuffer
+(
+    int32_t      fd,                ///< [IN] File descriptor of the recorded file
+    WavParams_t* wavParamPtr        ///< [IN] WAV parameters
+)
+{
+    int32_t len = WriteFd(fd, wavParamPtr->buffer, wavParamPtr->bufferLen);
+
+    if (len != wavParamPtr->bufferLen)
+    {
+        LE_ERROR("write error: %d written, expected %d, errno %d",
+                 len, wavParamPtr->bufferLen, errno);
+        return LE_FAULT;
+    }
+
+    wavParamPtr->recordingSize += len;
+    wavParamPtr->bufferLen = 0;
+
+    if ((wavParamPtr->recordingSize - wavParamPtr->checkpointSize) >= WAV_REC_CHECKPOINT_SIZE)
+    {
+        return UpdateWavHeader(fd, wavParamPtr);
+    }
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Write on a file descriptor a WAV audio file.
  *
+ * The samples are batched in a buffer, written sequentially when the buffer is full. The header
+ * is updated at checkpoints and when the recording is stopped.
  */
 //--------------------------------------------------------------------------------------------------
 static le_result_t WavWriteFd
@@ -672,56 +767,73 @@ static le_result_t WavWriteFd
     uint32_t                       bufferLen     ///< [IN] Buffer length
 )
 {
-    WavHeader_t hdr;
     WavParams_t* wavParamPtr =  (WavParams_t*) mediaCtxPtr->codecParams;
     int oldstate = PTHREAD_CANCEL_ENABLE, dummy = PTHREAD_CANCEL_ENABLE;
+    le_result_t result = LE_OK;
 
     // This function is set to no cancelable to avoid desynchronisation between the data and the
     // header
     pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldstate);
 
-    int32_t len = WriteFd(mediaCtxPtr->fd_out, bufferInPtr, bufferLen);
-
-    if (len != bufferLen)
+    while (bufferLen > 0)
     {
-        LE_ERROR("write error: %d written, expected %d, errno %d", len, bufferLen, errno);
-        pthread_setcancelstate(oldstate, &dummy);
-        return LE_FAULT;
-    }
+        uint32_t len = sizeof(wavParamPtr->buffer) - wavParamPtr->bufferLen;
 
-    wavParamPtr->recordingSize += len;
+        if (len > bufferLen)
+        {
+            len = bufferLen;
+        }
 
-    lseek(mediaCtxPtr->fd_out, ((uint8_t*)&hdr.dataSize - (uint8_t*)&hdr), SEEK_SET);
+        memcpy(wavParamPtr->buffer + wavParamPtr->bufferLen, bufferInPtr, len);
+        wavParamPtr->bufferLen += len;
+        bufferInPtr += len;
+        bufferLen -= len;
 
-    len = WriteFd(mediaCtxPtr->fd_out,
-                &wavParamPtr->recordingSize,
-                sizeof(wavParamPtr->recordingSize));
+        if (wavParamPtr->bufferLen == sizeof(wavParamPtr->buffer))
+        {
+            result = FlushWavBuffer(mediaCtxPtr->fd_out, wavParamPtr);
 
-    if (len != sizeof(wavParamPtr->recordingSize))
-    {
-        LE_ERROR("read error: %d written, errno %d", len, errno);
-        pthread_setcancelstate(oldstate, &dummy);
-        return LE_FAULT;
+            if (result != LE_OK)
+            {
+                break;
+            }
+        }
     }
 
-    lseek(mediaCtxPtr->fd_out, ((uint8_t*)&hdr.riffSize - (uint8_t*)&hdr), SEEK_SET);
+    pthread_setcancelstate(oldstate, &dummy);
 
-    uint32_t riffSize = wavParamPtr->recordingSize + 44 - 8;
+    return result;
+}
 
-    len = WriteFd(mediaCtxPtr->fd_out, &riffSize, sizeof(riffSize));
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a WAV audio file recording: write the pending data, update the header and release the
+ * WAV parameters.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CloseRecWavFile
+(
+    le_audio_MediaThreadContext_t* mediaCtxPtr   ///< [IN] Media thread context
+)
+{
+    WavParams_t* wavParamPtr =  (WavParams_t*) mediaCtxPtr->codecParams;
+    le_result_t result = LE_OK;
 
-    if (len != sizeof(riffSize))
+    if (wavParamPtr)
     {
-        LE_ERROR("read error: %d written, errno %d", len, errno);
-        pthread_setcancelstate(oldstate, &dummy);
-        return LE_FAULT;
-    }
+        result = FlushWavBuffer(mediaCtxPtr->fd_out, wavParamPtr);
 
-    lseek(mediaCtxPtr->fd_out, sizeof(WavHeader_t)+wavParamPtr->recordingSize, SEEK_SET);
+        if (UpdateWavHeader(mediaCtxPtr->fd_out, wavParamPtr) != LE_OK)
+        {
+            result = LE_FAULT;
+        }
 
-    pthread_setcancelstate(oldstate, &dummy);
+        le_mem_Release(wavParamPtr);
+        mediaCtxPtr->codecParams = NULL;
+    }
 
-    return LE_OK;
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -777,7 +889,12 @@ static le_result_t InitRecWavFile
     le_audio_MediaThreadContext_t*   mediaCtxPtr   ///< [IN] Media thread context
 )
 {
-    SetWavHeader(mediaCtxPtr->fd_out, &(streamPtr->samplePcmConfig));
+    WavParams_t* wavParamPtr =  (WavParams_t*) mediaCtxPtr->codecParams;
+
+    SetWavHeader(mediaCtxPtr->fd_out, &(streamPtr->samplePcmConfig), &wavParamPtr->hdr);
+
+    // The header can't be updated in a pipe or a socket
+    wavParamPtr->isSeekable = (lseek(mediaCtxPtr->fd_out, 0, SEEK_CUR) != -1);
 
     mediaCtxPtr->format = LE_AUDIO_FILE_WAVE;
     mediaCtxPtr->bufferSize = 1024;
@@ -1233,7 +1350,7 @@ static le_result_t RecordWavFile
     mediaCtxPtr->initFunc = InitRecWavFile;
     mediaCtxPtr->readFunc = MediaReadFd;
     mediaCtxPtr->writeFunc = WavWriteFd;
-    mediaCtxPtr->closeFunc = ReleaseCodecParams;
+    mediaCtxPtr->closeFunc = CloseRecWavFile;
     *formatPtr = LE_AUDIO_FILE_WAVE;
 
     return LE_OK;
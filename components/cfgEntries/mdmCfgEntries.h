@@ -40,6 +40,9 @@
 #define CFG_NODE_RX_COUNT                   "rxCount"
 #define CFG_NODE_TX_COUNT                   "txCount"
 #define CFG_NODE_RX_CB_COUNT                "rxCbCount"
+#define CFG_NODE_STATS_WRITE_INTERVAL       "statsWriteInterval"
+#define CFG_NODE_STATS_MAX_UNSAVED          "statsMaxUnsaved"
 #define CFG_NODE_STATUS_REPORT              "statusReportEnabled"
+#define CFG_NODE_CONCAT_TIMEOUT             "concatTimeout"
 
 #endif // LEGATO_MDMCFGENTRIES_INCLUDE_GUARD
@@ -30,6 +30,7 @@
 #include "pa_sms.h"
 #include "pa_sim.h"
 #include "smsPdu.h"
+#include "smsConcat.h"
 #include "time.h"
 #include "mdmCfgEntries.h"
 
@@ -67,6 +68,21 @@
 //--------------------------------------------------------------------------------------------------
 #define SMS_MAX_SESSION 5
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default time after which updated message counters are written in the config tree, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_STATS_WRITE_INTERVAL    60
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default number of counter updates after which the message counters are written in the config
+ * tree, whatever the write interval: this bounds the number of counted messages lost on a crash.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_STATS_MAX_UNSAVED       50
+
 //--------------------------------------------------------------------------------------------------
 /**
  * SMS command Type.
@@ -79,9 +95,43 @@ typedef enum
 }
 CmdType_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client sessions notified of a received message.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    RECIPIENTS_ALL,         ///< All the sessions.
+    RECIPIENTS_NO_CONCAT,   ///< Sessions which don't reassemble concatenated messages.
+    RECIPIENTS_CONCAT       ///< Sessions which reassemble concatenated messages.
+}
+Recipients_t;
+
 //--------------------------------------------------------------------------------------------------
 // Data structures.
 //--------------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------------
+/**
+ * Storage location of a part of a concatenated message.
+ *
+ * A part is held by the message object notified to the clients which don't reassemble concatenated
+ * messages, and by the reassembled message (or by the reassembly table until then). The location
+ * is deleted at once when its only holder deletes it, otherwise once it's no longer held.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pa_sms_Storage_t  storage;      ///< SMS storage location.
+    uint32_t          storageIdx;   ///< SMS index in storage.
+    pa_sms_Protocol_t protocol;     ///< SMS Protocol.
+    uint32_t          holdCount;    ///< Number of holders.
+    bool              delAsked;     ///< Whether the deletion is asked.
+    bool              deleted;      ///< Whether the location is deleted, and may be reused.
+    le_dls_Link_t     link;         ///< Link in PartStorageList, until deleted.
+}
+PartStorage_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Message structure.
@@ -135,6 +185,13 @@ typedef struct le_sms_Msg
     uint8_t           typeOfAddress;                                ///< Type of Address
     char              dischargeTime[LE_SMS_TIMESTAMP_MAX_BYTES];    ///< TP Discharge Time
     uint8_t           status;                                       ///< TP Status
+
+    /// Reassembled concatenated message, replacing the user data
+    smsConcat_Msg_t*  concatPtr;                           ///< Reassembled message, or NULL.
+
+    /// Storage locations held as the part of a concatenated message, or as the parts of a
+    /// reassembled message
+    PartStorage_t*    partStoragePtr[LE_SMS_CONCAT_MAX_PARTS];
 }le_sms_Msg_t;
 
 
@@ -186,10 +243,12 @@ typedef struct
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    bool    counting;   ///< Is message counting activated.
-    int32_t rxCount;    ///< Number of messages successfully received.
-    int32_t rxCbCount;  ///< Number of broadcast messages successfully received.
-    int32_t txCount;    ///< Number of messages successfully sent.
+    bool     counting;      ///< Is message counting activated.
+    int32_t  rxCount;       ///< Number of messages successfully received.
+    int32_t  rxCbCount;     ///< Number of broadcast messages successfully received.
+    int32_t  txCount;       ///< Number of messages successfully sent.
+    uint32_t unsavedCount;  ///< Number of counter updates not written in the config tree.
+    uint32_t maxUnsaved;    ///< Number of counter updates triggering a write.
 }
 le_sms_MsgStats_t;
 
@@ -207,6 +266,7 @@ typedef struct
     le_msg_SessionRef_t sessionRef;           ///< Client sessionRef.
     le_dls_List_t       msgRefList;           ///< Message reference list.
     le_dls_List_t       handlerList;          ///< Handler list.
+    bool                concatEnabled;        ///< Are concatenated messages reassembled.
     le_dls_Link_t       link;                 ///< Link for SessionCtxList.
 }
 SessionCtxNode_t;
@@ -263,6 +323,22 @@ static le_mem_PoolRef_t   MsgPool;
 //--------------------------------------------------------------------------------------------------
 static le_ref_MapRef_t MsgRefMap;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pool for the storage locations of the parts of concatenated messages.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t   PartStoragePool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Storage locations of the parts of concatenated messages, which are not deleted yet.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t  PartStorageList = LE_DLS_LIST_INIT;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Memory Pool for Listed SMS messages.
@@ -348,6 +424,21 @@ static le_sem_Ref_t SmsSem;
 //--------------------------------------------------------------------------------------------------
 static le_sms_MsgStats_t MessageStats;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex protecting the message statistics, updated by the main and the sending threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mutex_Ref_t StatsMutex;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer writing the updated message counts, and the thread it belongs to.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t StatsTimer;
+static le_thread_Ref_t MainThreadRef;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * SMS Status Report activation state.
@@ -366,92 +457,158 @@ static le_dls_List_t  SessionCtxList;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read the message counting state
+ * Write the message counting state
  */
 //--------------------------------------------------------------------------------------------------
-static bool GetCountingState
+static void SetCountingState
 (
-    void
+    bool countState     ///< New message counting state
 )
 {
-    bool countingState;
     le_cfg_IteratorRef_t iteratorRef;
 
-    iteratorRef = le_cfg_CreateReadTxn(CFG_MODEMSERVICE_SMS_PATH);
-    countingState = le_cfg_GetBool(iteratorRef, CFG_NODE_COUNTING, true);
-    le_cfg_CancelTxn(iteratorRef);
+    LE_DEBUG("New message counting state: %d", countState);
 
-    LE_DEBUG("Retrieved counting state: %d", countingState);
+    iteratorRef = le_cfg_CreateWriteTxn(CFG_MODEMSERVICE_SMS_PATH);
+    le_cfg_SetBool(iteratorRef, CFG_NODE_COUNTING, countState);
+    le_cfg_CommitTxn(iteratorRef);
 
-    return countingState;
+    MessageStats.counting = countState;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write the message counting state
+ * Write all the message counts in a single transaction.
+ *
+ * @note Must be called with StatsMutex locked.
  */
 //--------------------------------------------------------------------------------------------------
-static void SetCountingState
+static void WriteMessageCounts
 (
-    bool countState     ///< New message counting state
+    void
 )
 {
     le_cfg_IteratorRef_t iteratorRef;
 
-    LE_DEBUG("New message counting state: %d", countState);
-
     iteratorRef = le_cfg_CreateWriteTxn(CFG_MODEMSERVICE_SMS_PATH);
-    le_cfg_SetBool(iteratorRef, CFG_NODE_COUNTING, countState);
+    le_cfg_SetInt(iteratorRef, CFG_NODE_RX_COUNT, MessageStats.rxCount);
+    le_cfg_SetInt(iteratorRef, CFG_NODE_TX_COUNT, MessageStats.txCount);
+    le_cfg_SetInt(iteratorRef, CFG_NODE_RX_CB_COUNT, MessageStats.rxCbCount);
     le_cfg_CommitTxn(iteratorRef);
 
-    MessageStats.counting = countState;
+    LE_DEBUG("Counts written: rx=%d, tx=%d, rxCb=%d, %u updates",
+             MessageStats.rxCount, MessageStats.txCount, MessageStats.rxCbCount,
+             MessageStats.unsavedCount);
+
+    MessageStats.unsavedCount = 0;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read the message count for a message type
+ * Write the message counts if they were updated since the last write.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetMessageCount
+static void FlushMessageCounts
 (
-    le_sms_Type_t   messageType,        ///< [IN] Message type
-    int32_t*        messageCountPtr     ///< [OUT] Message count pointer
+    void
 )
 {
-    le_cfg_IteratorRef_t iteratorRef;
-    char countPath[LE_CFG_STR_LEN_BYTES];
+    le_mutex_Lock(StatsMutex);
+    if (MessageStats.unsavedCount)
+    {
+        WriteMessageCounts();
+    }
+    le_mutex_Unlock(StatsMutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics timer handler: write the counts updated during the write interval.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StatsTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Statistics timer.
+)
+{
+    FlushMessageCounts();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the statistics timer, in the main thread. The counts are written when it expires.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartStatsTimer
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    if (!le_timer_IsRunning(StatsTimer))
+    {
+        le_timer_Start(StatsTimer);
+    }
+}
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the message count of a message type.
+ *
+ * @return The message count, or NULL if the message type is unknown.
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t* GetMessageCountPtr
+(
+    le_sms_Type_t   messageType     ///< [IN] Message type
+)
+{
     switch (messageType)
     {
         case LE_SMS_TYPE_RX:
-            snprintf(countPath, sizeof(countPath), "%s", CFG_NODE_RX_COUNT);
-            break;
+            return &MessageStats.rxCount;
 
         case LE_SMS_TYPE_TX:
-            snprintf(countPath, sizeof(countPath), "%s", CFG_NODE_TX_COUNT);
-            break;
+            return &MessageStats.txCount;
 
         case LE_SMS_TYPE_BROADCAST_RX:
-            snprintf(countPath, sizeof(countPath), "%s", CFG_NODE_RX_CB_COUNT);
-            break;
+            return &MessageStats.rxCbCount;
 
         default:
-            LE_ERROR("Unknown message type %d", messageType);
-            return LE_FAULT;
+            return NULL;
     }
+}
 
-    iteratorRef = le_cfg_CreateReadTxn(CFG_MODEMSERVICE_SMS_PATH);
-    *messageCountPtr = le_cfg_GetInt(iteratorRef, countPath, 0);
-    le_cfg_CancelTxn(iteratorRef);
-
-    LE_DEBUG("Type=%d, count=%d", messageType, *messageCountPtr);
-
-    return LE_OK;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record an update of the message counts.
+ *
+ * The counts are kept in memory, and written in the config tree when the write interval expires,
+ * or at once when the number of updates reaches the maximum number of unsaved updates.
+ *
+ * @note Must be called with StatsMutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MessageCountUpdated
+(
+    void
+)
+{
+    MessageStats.unsavedCount++;
+    if (MessageStats.unsavedCount >= MessageStats.maxUnsaved)
+    {
+        WriteMessageCounts();
+    }
+    else if (1 == MessageStats.unsavedCount)
+    {
+        // Counts can be updated by the sending thread, the timer belongs to the main thread.
+        le_event_QueueFunctionToThread(MainThreadRef, StartStatsTimer, NULL, NULL);
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write the message count for a message type
+ * Set the message count for a message type.
  */
 //--------------------------------------------------------------------------------------------------
 static le_result_t SetMessageCount
@@ -460,43 +617,74 @@ static le_result_t SetMessageCount
     int32_t         messageCount    ///< [IN] New message count
 )
 {
-    le_cfg_IteratorRef_t iteratorRef;
-    char countPath[LE_CFG_STR_LEN_BYTES];
+    le_mutex_Lock(StatsMutex);
 
-    switch (messageType)
+    int32_t* countPtr = GetMessageCountPtr(messageType);
+    if (NULL == countPtr)
     {
-        case LE_SMS_TYPE_RX:
-            MessageStats.rxCount = messageCount;
-            snprintf(countPath, sizeof(countPath), "%s", CFG_NODE_RX_COUNT);
-            break;
+        le_mutex_Unlock(StatsMutex);
+        LE_ERROR("Unknown message type %d", messageType);
+        return LE_FAULT;
+    }
 
-        case LE_SMS_TYPE_TX:
-            MessageStats.txCount = messageCount;
-            snprintf(countPath, sizeof(countPath), "%s", CFG_NODE_TX_COUNT);
-            break;
+    *countPtr = messageCount;
+    LE_DEBUG("Type=%d, count=%d", messageType, messageCount);
+    MessageCountUpdated();
 
-        case LE_SMS_TYPE_BROADCAST_RX:
-            MessageStats.rxCbCount = messageCount;
-            snprintf(countPath, sizeof(countPath), "%s", CFG_NODE_RX_CB_COUNT);
-            break;
+    le_mutex_Unlock(StatsMutex);
 
-        default:
-            LE_ERROR("Unknown message type %d", messageType);
-            return LE_FAULT;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Increment the message count for a message type. The count is read and updated under the lock,
+ * as messages are counted by both the main thread and the sending thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t IncrementMessageCount
+(
+    le_sms_Type_t   messageType     ///< [IN] Message type
+)
+{
+    le_mutex_Lock(StatsMutex);
+
+    int32_t* countPtr = GetMessageCountPtr(messageType);
+    if (NULL == countPtr)
+    {
+        le_mutex_Unlock(StatsMutex);
+        LE_ERROR("Unknown message type %d", messageType);
+        return LE_FAULT;
     }
 
-    iteratorRef = le_cfg_CreateWriteTxn(CFG_MODEMSERVICE_SMS_PATH);
-    le_cfg_SetInt(iteratorRef, countPath, messageCount);
-    le_cfg_CommitTxn(iteratorRef);
+    (*countPtr)++;
+    LE_DEBUG("Type=%d, count=%d", messageType, *countPtr);
+    MessageCountUpdated();
 
-    LE_DEBUG("Type=%d, count=%d", messageType, messageCount);
+    le_mutex_Unlock(StatsMutex);
 
     return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Initialize message statistics structure
+ * SIGTERM handler: write the counts before exiting.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TermSignalHandler
+(
+    int sigNum      ///< [IN] The signal that was received.
+)
+{
+    FlushMessageCounts();
+
+    LE_INFO("Terminated");
+    exit(EXIT_SUCCESS);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize message statistics structure, from a single read of the config tree.
  */
 //--------------------------------------------------------------------------------------------------
 static void InitializeMessageStatistics
@@ -504,19 +692,49 @@ static void InitializeMessageStatistics
     void
 )
 {
-    MessageStats.counting = GetCountingState();
-    if (LE_OK != GetMessageCount(LE_SMS_TYPE_RX, &MessageStats.rxCount))
-    {
-        LE_ERROR("Unable to retrieve received message count");
-    }
-    if (LE_OK != GetMessageCount(LE_SMS_TYPE_TX, &MessageStats.txCount))
+    le_cfg_IteratorRef_t iteratorRef;
+    int32_t writeInterval;
+    int32_t maxUnsaved;
+
+    iteratorRef = le_cfg_CreateReadTxn(CFG_MODEMSERVICE_SMS_PATH);
+    MessageStats.counting = le_cfg_GetBool(iteratorRef, CFG_NODE_COUNTING, true);
+    MessageStats.rxCount = le_cfg_GetInt(iteratorRef, CFG_NODE_RX_COUNT, 0);
+    MessageStats.txCount = le_cfg_GetInt(iteratorRef, CFG_NODE_TX_COUNT, 0);
+    MessageStats.rxCbCount = le_cfg_GetInt(iteratorRef, CFG_NODE_RX_CB_COUNT, 0);
+    writeInterval = le_cfg_GetInt(iteratorRef, CFG_NODE_STATS_WRITE_INTERVAL,
+                                  DEFAULT_STATS_WRITE_INTERVAL);
+    maxUnsaved = le_cfg_GetInt(iteratorRef, CFG_NODE_STATS_MAX_UNSAVED,
+                               DEFAULT_STATS_MAX_UNSAVED);
+    le_cfg_CancelTxn(iteratorRef);
+
+    if (writeInterval <= 0)
     {
-        LE_ERROR("Unable to retrieve sent message count");
+        LE_WARN("Invalid statistics write interval %d", writeInterval);
+        writeInterval = DEFAULT_STATS_WRITE_INTERVAL;
     }
-    if (LE_OK != GetMessageCount(LE_SMS_TYPE_BROADCAST_RX, &MessageStats.rxCbCount))
+    if (maxUnsaved <= 0)
     {
-        LE_ERROR("Unable to retrieve received broadcast message count");
+        LE_WARN("Invalid statistics maximum unsaved updates %d", maxUnsaved);
+        maxUnsaved = DEFAULT_STATS_MAX_UNSAVED;
     }
+
+    MessageStats.unsavedCount = 0;
+    MessageStats.maxUnsaved = maxUnsaved;
+
+    LE_DEBUG("Counting %d: rx=%d, tx=%d, rxCb=%d, written every %d s or %d updates",
+             MessageStats.counting, MessageStats.rxCount, MessageStats.txCount,
+             MessageStats.rxCbCount, writeInterval, maxUnsaved);
+
+    StatsMutex = le_mutex_CreateNonRecursive("SmsStatsMutex");
+    MainThreadRef = le_thread_GetCurrent();
+
+    le_clk_Time_t interval = { .sec = writeInterval, .usec = 0 };
+    StatsTimer = le_timer_Create("SmsStatsTimer");
+    le_timer_SetInterval(StatsTimer, interval);
+    le_timer_SetHandler(StatsTimer, StatsTimerHandler);
+
+    // Write the counts when the service is stopped.
+    le_sig_SetEventHandler(SIGTERM, TermSignalHandler);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -541,6 +759,34 @@ static bool GetStatusReportState
     return statusReportState;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the time to wait for the missing parts of a concatenated message, in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetConcatTimeout
+(
+    void
+)
+{
+    int32_t concatTimeout;
+    le_cfg_IteratorRef_t iteratorRef;
+
+    iteratorRef = le_cfg_CreateReadTxn(CFG_MODEMSERVICE_SMS_PATH);
+    concatTimeout = le_cfg_GetInt(iteratorRef, CFG_NODE_CONCAT_TIMEOUT, SMSCONCAT_DEFAULT_TIMEOUT);
+    le_cfg_CancelTxn(iteratorRef);
+
+    if (concatTimeout <= 0)
+    {
+        LE_WARN("Invalid concatenated message timeout %d", concatTimeout);
+        concatTimeout = SMSCONCAT_DEFAULT_TIMEOUT;
+    }
+
+    LE_DEBUG("Retrieved concatenated message timeout: %d", concatTimeout);
+
+    return concatTimeout;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Write the SMS Status Report activation state
@@ -618,6 +864,305 @@ static void ReInitializeList
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the user data of a message: the reassembled data of a concatenated message, or the data of
+ * the message itself.
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint8_t* GetUserData
+(
+    const le_sms_Msg_t* msgPtr  ///< [IN] Message object pointer.
+)
+{
+    if (msgPtr->concatPtr)
+    {
+        return msgPtr->concatPtr->data;
+    }
+
+    return msgPtr->binary;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a piece of the user data of a message, starting at a given byte.
+ *
+ * @return
+ *  - LE_OUT_OF_RANGE   The offset is past the end of the user data.
+ *  - LE_OK             Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CopyUserDataFrom
+(
+    const le_sms_Msg_t* msgPtr,     ///< [IN] Message object pointer.
+    size_t              offset,     ///< [IN] Offset of the first byte to copy.
+    uint8_t*            bufPtr,     ///< [OUT] Buffer to copy the bytes into.
+    size_t*             sizePtr     ///< [IN,OUT] Size of the buffer, then number of bytes copied.
+)
+{
+    if (offset > msgPtr->userdataLen)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    size_t numBytes = msgPtr->userdataLen - offset;
+    if (numBytes > *sizePtr)
+    {
+        numBytes = *sizePtr;
+    }
+
+    memcpy(bufPtr, GetUserData(msgPtr) + offset, numBytes);
+    *sizePtr = numBytes;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a message from the SMS storage.
+ *
+ * @return
+ *  - LE_OK             Function succeeded.
+ *  - LE_FAULT          Function failed.
+ *  - LE_COMM_ERROR     Radio link failure occurred.
+ *  - LE_TIMEOUT        No response was received from the Modem.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DelMsgFromMem
+(
+    pa_sms_Protocol_t protocol,     ///< [IN] SMS Protocol.
+    pa_sms_Storage_t  storage,      ///< [IN] SMS storage location.
+    uint32_t          storageIdx    ///< [IN] SMS index in storage.
+)
+{
+    le_result_t resp;
+
+    le_sem_Wait(SmsSem);
+    resp = pa_sms_DelMsgFromMem(storageIdx, protocol, storage);
+    le_sem_Post(SmsSem);
+
+    return resp;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the storage location of a part of a concatenated message.
+ *
+ * @return The storage location, or NULL if it isn't held or is already deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+static PartStorage_t* FindPartStorage
+(
+    pa_sms_Storage_t storage,       ///< [IN] SMS storage location.
+    uint32_t         storageIdx     ///< [IN] SMS index in storage.
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&PartStorageList);
+
+    while (linkPtr)
+    {
+        PartStorage_t* partPtr = CONTAINER_OF(linkPtr, PartStorage_t, link);
+
+        if ((partPtr->storage == storage) && (partPtr->storageIdx == storageIdx))
+        {
+            return partPtr;
+        }
+
+        linkPtr = le_dls_PeekNext(&PartStorageList, linkPtr);
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hold the storage location of a part of a concatenated message.
+ *
+ * @return The storage location, or NULL if the part isn't stored.
+ */
+//--------------------------------------------------------------------------------------------------
+static PartStorage_t* HoldPartStorage
+(
+    pa_sms_Protocol_t protocol,     ///< [IN] SMS Protocol.
+    pa_sms_Storage_t  storage,      ///< [IN] SMS storage location.
+    uint32_t          storageIdx    ///< [IN] SMS index in storage.
+)
+{
+    if ((PA_SMS_STORAGE_NONE == storage) || (PA_SMS_STORAGE_UNKNOWN == storage))
+    {
+        return NULL;
+    }
+
+    PartStorage_t* partPtr = FindPartStorage(storage, storageIdx);
+
+    if (NULL == partPtr)
+    {
+        partPtr = le_mem_ForceAlloc(PartStoragePool);
+        partPtr->storage = storage;
+        partPtr->storageIdx = storageIdx;
+        partPtr->protocol = protocol;
+        partPtr->holdCount = 0;
+        partPtr->delAsked = false;
+        partPtr->deleted = false;
+        partPtr->link = LE_DLS_LINK_INIT;
+        le_dls_Queue(&PartStorageList, &partPtr->link);
+    }
+
+    partPtr->holdCount++;
+
+    return partPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the storage location of a part of a concatenated message, on behalf of one of its
+ * holders. The deletion is deferred until the other holders release the location.
+ *
+ * @return
+ *  - LE_OK             Function succeeded, or the deletion is deferred.
+ *  - LE_FAULT          Function failed.
+ *  - LE_COMM_ERROR     Radio link failure occurred.
+ *  - LE_TIMEOUT        No response was received from the Modem.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DeletePartStorage
+(
+    PartStorage_t* partPtr          ///< [IN] Storage location.
+)
+{
+    if (partPtr->deleted)
+    {
+        return LE_OK;
+    }
+
+    if (partPtr->holdCount > 1)
+    {
+        LE_DEBUG("Deletion of part %u deferred, %u holders", partPtr->storageIdx,
+                 partPtr->holdCount);
+        partPtr->delAsked = true;
+        return LE_OK;
+    }
+
+    le_result_t resp = DelMsgFromMem(partPtr->protocol, partPtr->storage, partPtr->storageIdx);
+
+    if (LE_OK == resp)
+    {
+        partPtr->deleted = true;
+        le_dls_Remove(&PartStorageList, &partPtr->link);
+    }
+
+    return resp;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the storage location of a part of a concatenated message. The location is deleted if it
+ * was asked for while it was held by others.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleasePartStorage
+(
+    PartStorage_t* partPtr          ///< [IN] Storage location.
+)
+{
+    LE_ASSERT(partPtr->holdCount > 0);
+
+    if (--partPtr->holdCount > 0)
+    {
+        return;
+    }
+
+    if (!partPtr->deleted)
+    {
+        le_dls_Remove(&PartStorageList, &partPtr->link);
+
+        if (partPtr->delAsked &&
+            (LE_OK != DelMsgFromMem(partPtr->protocol, partPtr->storage, partPtr->storageIdx)))
+        {
+            LE_ERROR("Unable to delete part %u from storage", partPtr->storageIdx);
+        }
+    }
+
+    le_mem_Release(partPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a message from the SMS storage. The parts of a concatenated message are only deleted
+ * once no other message object holds them.
+ *
+ * @return
+ *  - LE_OK             Function succeeded.
+ *  - LE_FAULT          Function failed.
+ *  - LE_COMM_ERROR     Radio link failure occurred.
+ *  - LE_TIMEOUT        No response was received from the Modem.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DeleteMsgStorage
+(
+    le_sms_Msg_t* msgPtr    ///< [IN] Message object pointer.
+)
+{
+    le_result_t resp = LE_OK;
+    bool isHolder = false;
+    int i;
+
+    for (i = 0; (i < LE_SMS_CONCAT_MAX_PARTS) && (LE_OK == resp); i++)
+    {
+        if (msgPtr->partStoragePtr[i])
+        {
+            isHolder = true;
+            resp = DeletePartStorage(msgPtr->partStoragePtr[i]);
+        }
+    }
+
+    if (isHolder)
+    {
+        return resp;
+    }
+
+    // A part listed from the storage may still be held by the message objects it was notified
+    // with.
+    PartStorage_t* partPtr = FindPartStorage(msgPtr->storage, msgPtr->storageIdx);
+
+    if (partPtr)
+    {
+        partPtr->delAsked = true;
+        return LE_OK;
+    }
+
+    return DelMsgFromMem(msgPtr->protocol, msgPtr->storage, msgPtr->storageIdx);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destructor of the message objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MsgDestructor
+(
+    void* objPtr    ///< [IN] Message object pointer.
+)
+{
+    le_sms_Msg_t* msgPtr = objPtr;
+    int i;
+
+    for (i = 0; i < LE_SMS_CONCAT_MAX_PARTS; i++)
+    {
+        if (msgPtr->partStoragePtr[i])
+        {
+            ReleasePartStorage(msgPtr->partStoragePtr[i]);
+            msgPtr->partStoragePtr[i] = NULL;
+        }
+    }
+
+    if (msgPtr->concatPtr)
+    {
+        le_mem_Release(msgPtr->concatPtr);
+        msgPtr->concatPtr = NULL;
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create and Populate a new message object from an unknown PDU encoding.
@@ -672,6 +1217,13 @@ static le_result_t PopulateSmsDeliver
     newSmsMsgObjPtr->type = LE_SMS_TYPE_RX;
     newSmsMsgObjPtr->format = decodedMsgPtr->smsDeliver.format;
 
+    // Parts of concatenated messages are only available in PDU format: their user data is
+    // available once the message is reassembled.
+    if (decodedMsgPtr->smsDeliver.option & PA_SMS_OPTIONMASK_CONCAT)
+    {
+        newSmsMsgObjPtr->format = LE_SMS_FORMAT_PDU;
+    }
+
     switch (newSmsMsgObjPtr->format)
     {
         case LE_SMS_FORMAT_PDU:
@@ -1410,6 +1962,7 @@ static SessionCtxNode_t* CreateSessionCtx
     sessionCtxPtr->link = LE_DLS_LINK_INIT;
     sessionCtxPtr->msgRefList = LE_DLS_LIST_INIT;
     sessionCtxPtr->handlerList = LE_DLS_LIST_INIT;
+    sessionCtxPtr->concatEnabled = false;
 
     le_dls_Queue(&SessionCtxList, &(sessionCtxPtr->link));
 
@@ -1563,13 +2116,66 @@ static void RemoveMsgRefFromSessionCtx
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Call all subscribed handlers.
+ * Check whether a session is a recipient of received messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsRecipient
+(
+    SessionCtxNode_t* sessionCtxPtr,    ///< [IN] Session context.
+    Recipients_t      recipients        ///< [IN] Recipient sessions.
+)
+{
+    switch (recipients)
+    {
+        case RECIPIENTS_NO_CONCAT:
+            return !sessionCtxPtr->concatEnabled;
+        case RECIPIENTS_CONCAT:
+            return sessionCtxPtr->concatEnabled;
+        case RECIPIENTS_ALL:
+        default:
+            return true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a handler is subscribed by any of the recipient sessions.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsHandlerPresent
+(
+    Recipients_t recipients ///< [IN] Recipient sessions.
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&SessionCtxList);
+
+    // For all sessions, check if any handlers are present.
+    while (linkPtr)
+    {
+        SessionCtxNode_t* sessionCtxPtr = CONTAINER_OF(linkPtr, SessionCtxNode_t, link);
+        linkPtr = le_dls_PeekNext(&SessionCtxList, linkPtr);
+
+        if (IsRecipient(sessionCtxPtr, recipients) && le_dls_Peek(&(sessionCtxPtr->handlerList)))
+        {
+            LE_DEBUG("Handler has been subscribed for the session (%p)", sessionCtxPtr);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call all handlers subscribed by the recipient sessions. The message is released if no handler
+ * is called.
  *
  */
 //--------------------------------------------------------------------------------------------------
 static void MessageHandlers
 (
-    le_sms_Msg_t* msgPtr ///< [IN] SMS structure pointer.
+    le_sms_Msg_t* msgPtr,       ///< [IN] SMS structure pointer.
+    Recipients_t  recipients    ///< [IN] Recipient sessions.
 )
 {
     bool newMessage = true;
@@ -1583,6 +2189,11 @@ static void MessageHandlers
 
         linkPtr = le_dls_PeekPrev(&SessionCtxList, linkPtr);
 
+        if (!IsRecipient(sessionCtxPtr, recipients))
+        {
+            continue;
+        }
+
         // Peek the tail of the handlers list: this is important for handlers subscribed by
         // reference for modemDaemon.
         le_dls_Link_t* linkHandlerPtr = le_dls_PeekTail(&(sessionCtxPtr->handlerList));
@@ -1632,43 +2243,75 @@ static void MessageHandlers
             LE_DEBUG("sessionCtxPtr %p has no handler", sessionCtxPtr);
         }
     }
+
+    if (newMessage)
+    {
+        LE_DEBUG("No handler called for message %p", msgPtr);
+        le_mem_Release(msgPtr);
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * New SMS message handler function.
+ * Reassembled concatenated message handler function.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static void NewSmsHandler
+static void ConcatMsgHandler
 (
-    pa_sms_NewMessageIndication_t *newMessageIndicationPtr
+    smsConcat_Msg_t* concatMsgPtr   ///< [IN] Reassembled message.
 )
 {
-    pa_sms_Pdu_t messagePdu;
-    le_result_t res = LE_OK;
-    bool handlerPresent = false;
-    bool smscInfoPresent = true;
+    le_sms_Msg_t* msgPtr = (le_sms_Msg_t*)le_mem_ForceAlloc(MsgPool);
 
-    le_dls_Link_t* linkPtr = le_dls_Peek(&SessionCtxList);
+    memset(msgPtr, 0, sizeof(le_sms_Msg_t));
 
-    // For all sessions, check if any handlers are present.
-    while (linkPtr)
-    {
-        SessionCtxNode_t* sessionCtxPtr = CONTAINER_OF(linkPtr, SessionCtxNode_t, link);
-        linkPtr = le_dls_PeekNext(&SessionCtxList, linkPtr);
-        le_dls_Link_t* linkHandlerPtr = le_dls_Peek(&(sessionCtxPtr->handlerList));
+    msgPtr->readonly = true;
+    msgPtr->type = LE_SMS_TYPE_RX;
+    msgPtr->format = concatMsgPtr->format;
+    msgPtr->protocol = PA_SMS_PROTOCOL_GSM;
+    msgPtr->storage = concatMsgPtr->part[0].storage;
+    msgPtr->storageIdx = concatMsgPtr->part[0].storageIdx;
+    memcpy(msgPtr->tel, concatMsgPtr->oa, LE_MDMDEFS_PHONE_NUM_MAX_BYTES);
+    memcpy(msgPtr->timestamp, concatMsgPtr->scts, LE_SMS_TIMESTAMP_MAX_BYTES);
+    msgPtr->userdataLen = concatMsgPtr->dataLen;
+    msgPtr->concatPtr = concatMsgPtr;
 
-        if (linkHandlerPtr)
-        {
-            LE_DEBUG("Handler has been subscribed for the session (%p)", sessionCtxPtr);
-            handlerPresent = true;
-            break;
-        }
+    // The message takes over the storage locations held since the parts were added.
+    uint8_t i;
+    for (i = 0; i < concatMsgPtr->numParts; i++)
+    {
+        msgPtr->partStoragePtr[i] = FindPartStorage(concatMsgPtr->part[i].storage,
+                                                    concatMsgPtr->part[i].storageIdx);
     }
 
+    // No PDU for a reassembled message
+    msgPtr->pduReady = false;
+    msgPtr->pdu.status = LE_SMS_STATUS_UNKNOWN;
+    msgPtr->pdu.errorCode.code3GPP2 = LE_SMS_ERROR_3GPP2_MAX;
+    msgPtr->pdu.errorCode.rp = LE_SMS_ERROR_3GPP_MAX;
+    msgPtr->pdu.errorCode.tp = LE_SMS_ERROR_3GPP_MAX;
+
+    MessageHandlers(msgPtr, RECIPIENTS_CONCAT);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * New SMS message handler function.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void NewSmsHandler
+(
+    pa_sms_NewMessageIndication_t *newMessageIndicationPtr
+)
+{
+    pa_sms_Pdu_t messagePdu;
+    le_result_t res = LE_OK;
+    bool smscInfoPresent = true;
+
     // If no client session are subscribed for handler then do not decode the message.
-    if (false == handlerPresent)
+    if (!IsHandlerPresent(RECIPIENTS_ALL))
     {
         LE_DEBUG("No client sessions are subscribed for handler. So do not decode the message");
         return;
@@ -1751,11 +2394,11 @@ static void NewSmsHandler
     {
         if (LE_SMS_TYPE_RX == newSmsMsgObjPtr->type)
         {
-            SetMessageCount(newSmsMsgObjPtr->type, MessageStats.rxCount + 1);
+            IncrementMessageCount(newSmsMsgObjPtr->type);
         }
         else if (LE_SMS_TYPE_BROADCAST_RX == newSmsMsgObjPtr->type)
         {
-            SetMessageCount(newSmsMsgObjPtr->type, MessageStats.rxCbCount + 1);
+            IncrementMessageCount(newSmsMsgObjPtr->type);
         }
         else if (LE_SMS_TYPE_STATUS_REPORT == newSmsMsgObjPtr->type)
         {
@@ -1767,8 +2410,32 @@ static void NewSmsHandler
         }
     }
 
-    // Notify all the registered client's handlers with own reference.
-    MessageHandlers(newSmsMsgObjPtr);
+    if (   (LE_OK == res)
+        && (PA_SMS_DELIVER == messageConverted.type)
+        && (messageConverted.smsDeliver.option & PA_SMS_OPTIONMASK_CONCAT))
+    {
+        newSmsMsgObjPtr->partStoragePtr[0] = HoldPartStorage(newSmsMsgObjPtr->protocol,
+                                                             newSmsMsgObjPtr->storage,
+                                                             newSmsMsgObjPtr->storageIdx);
+
+        // Sessions reassembling concatenated messages are notified of the whole message only.
+        // The part is held until the reassembled message is released.
+        if (IsHandlerPresent(RECIPIENTS_CONCAT))
+        {
+            HoldPartStorage(newSmsMsgObjPtr->protocol,
+                            newSmsMsgObjPtr->storage,
+                            newSmsMsgObjPtr->storageIdx);
+            smsConcat_AddPart(&messageConverted.smsDeliver,
+                              newMessageIndicationPtr->storage,
+                              newMessageIndicationPtr->msgIndex);
+        }
+        MessageHandlers(newSmsMsgObjPtr, RECIPIENTS_NO_CONCAT);
+    }
+    else
+    {
+        // Notify all the registered client's handlers with own reference.
+        MessageHandlers(newSmsMsgObjPtr, RECIPIENTS_ALL);
+    }
 
     LE_DEBUG("All the registered client's handlers notified with objPtr %p, Obj %p",
              &newSmsMsgObjPtr, newSmsMsgObjPtr);
@@ -1995,7 +2662,7 @@ static void SendSmsSendingStateEvent
         // Update sent message count if necessary
         if ((MessageStats.counting) && (LE_SMS_SENT == msgPtr->pdu.status))
         {
-            SetMessageCount(LE_SMS_TYPE_TX, MessageStats.txCount + 1);
+            IncrementMessageCount(LE_SMS_TYPE_TX);
         }
 
         Myfunction(messageRef, msgPtr->pdu.status, msgPtr->ctxPtr);
@@ -2306,6 +2973,8 @@ static void CloseSessionEventHandler
 
     if (sessionCtxPtr)
     {
+        sessionCtxPtr->concatEnabled = false;
+
         le_dls_Link_t* linkPtr = le_dls_Pop(&(sessionCtxPtr->msgRefList));
 
         while (linkPtr)
@@ -2362,9 +3031,16 @@ le_result_t le_sms_Init
     // Initialize Status Report activation state
     StatusReportActivation = GetStatusReportState();
 
+    // Initialize the reassembly of concatenated messages
+    smsConcat_Init(GetConcatTimeout(), ConcatMsgHandler);
+
     // Create a pool for Message objects.
     MsgPool = le_mem_CreatePool("SmsMsgPool", sizeof(le_sms_Msg_t));
     le_mem_ExpandPool(MsgPool, MAX_NUM_OF_SMS_MSG);
+    le_mem_SetDestructor(MsgPool, MsgDestructor);
+
+    // Create a pool for the storage locations of the parts of concatenated messages.
+    PartStoragePool = le_mem_CreatePool("SmsPartStoragePool", sizeof(PartStorage_t));
 
     // Create the Safe Reference Map to use for Message object Safe References.
     MsgRefMap = le_ref_CreateMap("SmsMsgMap", MAX_NUM_OF_SMS_MSG);
@@ -2490,6 +3166,8 @@ le_sms_MsgRef_t le_sms_Create
     msgPtr->typeOfAddress = 0;
     msgPtr->dischargeTime[0] = '\0';
     msgPtr->status = 0;
+    msgPtr->concatPtr = NULL;
+    memset(msgPtr->partStoragePtr, 0, sizeof(msgPtr->partStoragePtr));
 
     // Return a Safe Reference for this message object.
     return SetMsgRefForSessionCtx(msgPtr, sessionCtxPtr);
@@ -2623,7 +3301,8 @@ void le_sms_Delete
     }
 
     if ((le_dls_NumLinks(&(sessionCtxPtr->handlerList)) == 0) &&
-             (le_dls_NumLinks(&(sessionCtxPtr->msgRefList)) == 0))
+             (le_dls_NumLinks(&(sessionCtxPtr->msgRefList)) == 0) &&
+             (!sessionCtxPtr->concatEnabled))
     {
         // delete the session context as it is not used anymore
         le_dls_Remove(&SessionCtxList, &(sessionCtxPtr->link));
@@ -3097,13 +3776,13 @@ le_result_t le_sms_GetUCS2
 
     if (msgPtr->userdataLen > (*ucs2NumElementsPtr*2))
     {
-        memcpy((uint8_t *) ucs2Ptr, msgPtr->binary, (*ucs2NumElementsPtr*2));
+        memcpy((uint8_t *) ucs2Ptr, GetUserData(msgPtr), (*ucs2NumElementsPtr*2));
         LE_ERROR("datalen %d > Buff size %d",(int)msgPtr->userdataLen,(int)(*ucs2NumElementsPtr*2));
         return LE_OVERFLOW;
     }
     else
     {
-        memcpy ((uint8_t *) ucs2Ptr, msgPtr->binary, msgPtr->userdataLen);
+        memcpy ((uint8_t *) ucs2Ptr, GetUserData(msgPtr), msgPtr->userdataLen);
         *ucs2NumElementsPtr = msgPtr->userdataLen / 2;
         return LE_OK;
     }
@@ -3112,6 +3791,75 @@ le_result_t le_sms_GetUCS2
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a piece of the UCS2 Message (16-bit format), starting at a given character.
+ *
+ * Output parameters are updated with as many characters of the UCS2 message as fit in 'ucs2Ptr',
+ * starting at 'offset', and their number.
+ *
+ * @return
+ *  - LE_FORMAT_ERROR  Message is not in UCS2 format.
+ *  - LE_OUT_OF_RANGE  The offset is past the end of the message.
+ *  - LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_GetUCS2From
+(
+    le_sms_MsgRef_t msgRef,
+        ///< [IN]
+        ///< Reference to the message object.
+
+    uint32_t offset,
+        ///< [IN]
+        ///< Offset in the message of the first character to read.
+
+    uint16_t* ucs2Ptr,
+        ///< [OUT]
+        ///< Piece of the UCS2 message.
+
+    size_t* ucs2NumElementsPtr
+        ///< [INOUT]
+)
+{
+    le_sms_Msg_t* msgPtr = le_ref_Lookup(MsgRefMap, msgRef);
+
+    if (msgPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", msgRef);
+        return LE_NOT_FOUND;
+    }
+
+    if (ucs2Ptr == NULL)
+    {
+        LE_KILL_CLIENT("ucs2Ptr is NULL !");
+        return LE_FAULT;
+    }
+
+    if (ucs2NumElementsPtr == NULL)
+    {
+        LE_KILL_CLIENT("ucs2NumElementsPtr is NULL !");
+        return LE_FAULT;
+    }
+
+    if (msgPtr->format != LE_SMS_FORMAT_UCS2)
+    {
+        LE_ERROR("Error.%d : Invalid format!", LE_FORMAT_ERROR);
+        return LE_FORMAT_ERROR;
+    }
+
+    size_t numBytes = *ucs2NumElementsPtr * 2;
+    le_result_t res = CopyUserDataFrom(msgPtr, (size_t)offset * 2, (uint8_t *) ucs2Ptr, &numBytes);
+
+    if (LE_OK == res)
+    {
+        *ucs2NumElementsPtr = numBytes / 2;
+    }
+
+    return res;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create and asynchronously send a text message.
@@ -3549,18 +4297,75 @@ le_result_t le_sms_GetText
         return LE_FORMAT_ERROR;
     }
 
-    if (strlen(msgPtr->text) > (len - 1))
+    const char* msgTextPtr = (const char*)GetUserData(msgPtr);
+
+    if (strlen(msgTextPtr) > (len - 1))
     {
         return LE_OVERFLOW;
     }
     else
     {
-        strncpy(textPtr, msgPtr->text, len);
+        strncpy(textPtr, msgTextPtr, len);
     }
     return LE_OK;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to get a piece of the text Message, starting at a given character.
+ *
+ * Output parameter is updated with as many characters of the text, starting at 'offset', as fit in
+ * 'text' with a null-character appended at the end.
+ *
+ * @return LE_FORMAT_ERROR  Message is not in text format.
+ * @return LE_OUT_OF_RANGE  The offset is past the end of the text.
+ * @return LE_OK            The function succeeded.
+ *
+ * @note If the caller is passing a bad pointer into this function, it is a fatal error, the
+ *       function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_GetTextFrom
+(
+    le_sms_MsgRef_t  msgRef,  ///< [IN]  The pointer to the message data structure.
+    uint32_t         offset,  ///< [IN]  Offset in the text of the first character to read.
+    char*            textPtr, ///< [OUT] The piece of the SMS text.
+    size_t           len      ///< [IN] The maximum length of the piece of text.
+)
+{
+    le_sms_Msg_t* msgPtr = le_ref_Lookup(MsgRefMap, msgRef);
+
+    if (msgPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", msgRef);
+        return LE_NOT_FOUND;
+    }
+
+    if ((textPtr == NULL) || (len == 0))
+    {
+        LE_KILL_CLIENT("textPtr is NULL !");
+        return LE_FAULT;
+    }
+
+    if (msgPtr->format != LE_SMS_FORMAT_TEXT)
+    {
+        LE_ERROR("Error.%d : Invalid format!", LE_FORMAT_ERROR);
+        return LE_FORMAT_ERROR;
+    }
+
+    size_t numChars = len - 1;
+    le_result_t res = CopyUserDataFrom(msgPtr, offset, (uint8_t *) textPtr, &numChars);
+
+    if (LE_OK == res)
+    {
+        textPtr[numChars] = '\0';
+    }
+
+    return res;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to get the binary Message.
@@ -3612,18 +4417,71 @@ le_result_t le_sms_GetBinary
 
     if (msgPtr->userdataLen > *lenPtr)
     {
-        memcpy(binPtr, msgPtr->binary, *lenPtr);
+        memcpy(binPtr, GetUserData(msgPtr), *lenPtr);
         return LE_OVERFLOW;
     }
     else
     {
-        memcpy (binPtr, msgPtr->binary, msgPtr->userdataLen);
+        memcpy (binPtr, GetUserData(msgPtr), msgPtr->userdataLen);
         *lenPtr=msgPtr->userdataLen;
         return LE_OK;
     }
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to get a piece of the binary Message, starting at a given byte.
+ *
+ * The output parameters are updated with as many bytes of the binary message, starting at
+ * 'offset', as fit in 'binPtr', and their number.
+ *
+ * @return LE_FORMAT_ERROR  Message is not in binary format.
+ * @return LE_OUT_OF_RANGE  The offset is past the end of the message.
+ * @return LE_OK            The function succeeded.
+ *
+ * @note If the caller is passing a bad pointer into this function, it is a fatal error, the
+ *       function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_GetBinaryFrom
+(
+    le_sms_MsgRef_t  msgRef, ///< [IN]  The pointer to the message data structure.
+    uint32_t         offset, ///< [IN]  Offset in the message of the first byte to read.
+    uint8_t*         binPtr, ///< [OUT] The piece of the binary message.
+    size_t*          lenPtr  ///< [IN,OUT] The length of the piece of the binary message in bytes.
+)
+{
+    le_sms_Msg_t* msgPtr = le_ref_Lookup(MsgRefMap, msgRef);
+
+    if (msgPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", msgRef);
+        return LE_NOT_FOUND;
+    }
+
+    if (binPtr == NULL)
+    {
+        LE_KILL_CLIENT("binPtr is NULL !");
+        return LE_FAULT;
+    }
+
+    if (lenPtr == NULL)
+    {
+        LE_KILL_CLIENT("lenPtr is NULL !");
+        return LE_FAULT;
+    }
+
+    if (msgPtr->format != LE_SMS_FORMAT_BINARY)
+    {
+        LE_ERROR("Error.%d : Invalid format!", LE_FORMAT_ERROR);
+        return LE_FORMAT_ERROR;
+    }
+
+    return CopyUserDataFrom(msgPtr, offset, binPtr, lenPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to get the PDU message.
@@ -3888,7 +4746,7 @@ le_result_t le_sms_Send
             // Update sent message count if necessary
             if (MessageStats.counting)
             {
-                SetMessageCount(LE_SMS_TYPE_TX, MessageStats.txCount + 1);
+                IncrementMessageCount(LE_SMS_TYPE_TX);
             }
         }
     }
@@ -4126,9 +4984,7 @@ le_result_t le_sms_DeleteFromStorage
 
     if (1 == msgPtr->smsUserCount)
     {
-        le_sem_Wait(SmsSem);
-        resp = pa_sms_DelMsgFromMem(msgPtr->storageIdx, msgPtr->protocol, msgPtr->storage);
-        le_sem_Post(SmsSem);
+        resp = DeleteMsgStorage(msgPtr);
 
         if ((LE_COMM_ERROR == resp) || (LE_TIMEOUT == resp))
         {
@@ -4800,24 +5656,15 @@ le_result_t le_sms_GetCount
         return LE_BAD_PARAMETER;
     }
 
-    switch (messageType)
-    {
-        case LE_SMS_TYPE_RX:
-            *messageCountPtr = MessageStats.rxCount;
-            break;
-
-        case LE_SMS_TYPE_TX:
-            *messageCountPtr = MessageStats.txCount;
-            break;
-
-        case LE_SMS_TYPE_BROADCAST_RX:
-            *messageCountPtr = MessageStats.rxCbCount;
-            break;
+    le_mutex_Lock(StatsMutex);
+    int32_t* countPtr = GetMessageCountPtr(messageType);
+    *messageCountPtr = countPtr ? *countPtr : 0;
+    le_mutex_Unlock(StatsMutex);
 
-        default:
-            LE_ERROR("Unknown message type %d", messageType);
-            *messageCountPtr = 0;
-            return LE_BAD_PARAMETER;
+    if (NULL == countPtr)
+    {
+        LE_ERROR("Unknown message type %d", messageType);
+        return LE_BAD_PARAMETER;
     }
 
     LE_DEBUG("Type=%d, count=%d", messageType, *messageCountPtr);
@@ -4869,10 +5716,11 @@ void le_sms_ResetCount
 {
     LE_DEBUG("Reset message counters");
 
-    // Reset the message count for all types.
+    // Reset the message count for all types, and write them at once.
     SetMessageCount(LE_SMS_TYPE_RX, 0);
     SetMessageCount(LE_SMS_TYPE_TX, 0);
     SetMessageCount(LE_SMS_TYPE_BROADCAST_RX, 0);
+    FlushMessageCounts();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -4936,6 +5784,97 @@ le_result_t le_sms_IsStatusReportEnabled
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the activation state of the reassembly of concatenated messages for the client.
+ *
+ * @return
+ *  - LE_OK             Function succeeded.
+ *  - LE_FAULT          Function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetConcatenationState
+(
+    bool concatEnabled  ///< [IN] New activation state
+)
+{
+    // search the sessionCtx; create it if doesn't exist.
+    SessionCtxNode_t* sessionCtxPtr = GetSessionCtx(le_sms_GetClientSessionRef());
+    if (!sessionCtxPtr)
+    {
+        // Create the session context.
+        sessionCtxPtr = CreateSessionCtx();
+    }
+
+    LE_DEBUG("Concatenation %s for sessionRef %p", (concatEnabled ? "enabled" : "disabled"),
+             sessionCtxPtr->sessionRef);
+
+    sessionCtxPtr->concatEnabled = concatEnabled;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable the reassembly of concatenated messages received by the client.
+ *
+ * @return
+ *  - LE_OK             Function succeeded.
+ *  - LE_FAULT          Function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_EnableConcatenation
+(
+    void
+)
+{
+    return SetConcatenationState(true);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Disable the reassembly of concatenated messages received by the client: each part is notified
+ * in PDU format.
+ *
+ * @return
+ *  - LE_OK             Function succeeded.
+ *  - LE_FAULT          Function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_DisableConcatenation
+(
+    void
+)
+{
+    return SetConcatenationState(false);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the activation state of the reassembly of concatenated messages for the client.
+ *
+ * @return
+ *  - LE_OK             Function succeeded.
+ *  - LE_BAD_PARAMETER  Parameter is invalid.
+ *  - LE_FAULT          Function failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_sms_IsConcatenationEnabled
+(
+    bool* enabledPtr    ///< [OUT] True when the reassembly is enabled, false otherwise.
+)
+{
+    if (!enabledPtr)
+    {
+        LE_ERROR("NULL pointer!");
+        return LE_BAD_PARAMETER;
+    }
+
+    SessionCtxNode_t* sessionCtxPtr = GetSessionCtx(le_sms_GetClientSessionRef());
+
+    *enabledPtr = (sessionCtxPtr ? sessionCtxPtr->concatEnabled : false);
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get TP-Message-Reference of SMS Status Report.
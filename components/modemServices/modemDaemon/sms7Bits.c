@@ -0,0 +1,1125 @@
+/** @file sms7Bits.c
+ *
+ * Source code of functions to pack, unpack and transcode SMS 7 bits characters.
+ *
+ * Septets are packed and unpacked 8 at a time: 8 septets are loaded as a 64 bits word, whose bytes
+ * are merged into 56 bits with a few shifts and masks, and stored as 7 bytes. Characters are
+ * transcoded through lookup tables.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "sms7Bits.h"
+
+
+/* Define Non-Printable Characters as a question mark */
+#define NPC7    63
+#define NPC8    '?'
+#define NPC16   0x003F
+
+/* Escape to the extension table */
+#define ESC7    27
+
+/****************************************************************************
+ * This lookup table converts from ISO-8859-1 8-bit ASCII to the
+ * 7 bit "default alphabet" as defined in ETSI GSM 03.38
+ *
+ * ISO-characters that don't have any corresponding character in the
+ * 7-bit alphabet is replaced with the NPC7-character.  If there's
+ * a close match between the ISO-char and a 7-bit character (for example
+ * the letter i with a circumflex and the plain i-character) a substitution
+ * is done.
+ *
+ * There are some character (for example the square brace "]") that must
+ * be converted into a 2 byte 7-bit sequence.  These characters are
+ * marked in the table by having 128 added to its value.
+ ****************************************************************************/
+static const uint8_t Ascii8to7[] = {
+    NPC7,       /*     0      null [NUL]                              */
+    NPC7,       /*     1      start of heading [SOH]                  */
+    NPC7,       /*     2      start of text [STX]                     */
+    NPC7,       /*     3      end of text [ETX]                       */
+    NPC7,       /*     4      end of transmission [EOT]               */
+    NPC7,       /*     5      enquiry [ENQ]                           */
+    NPC7,       /*     6      acknowledge [ACK]                       */
+    NPC7,       /*     7      bell [BEL]                              */
+    NPC7,       /*     8      backspace [BS]                          */
+    NPC7,       /*     9      horizontal tab [HT]                     */
+    10,         /*    10      line feed [LF]                          */
+    NPC7,       /*    11      vertical tab [VT]                       */
+    10+128,     /*    12      form feed [FF]                          */
+    13,         /*    13      carriage return [CR]                    */
+    NPC7,       /*    14      shift out [SO]                          */
+    NPC7,       /*    15      shift in [SI]                           */
+    NPC7,       /*    16      data link escape [DLE]                  */
+    NPC7,       /*    17      device control 1 [DC1]                  */
+    NPC7,       /*    18      device control 2 [DC2]                  */
+    NPC7,       /*    19      device control 3 [DC3]                  */
+    NPC7,       /*    20      device control 4 [DC4]                  */
+    NPC7,       /*    21      negative acknowledge [NAK]              */
+    NPC7,       /*    22      synchronous idle [SYN]                  */
+    NPC7,       /*    23      end of trans. block [ETB]               */
+    NPC7,       /*    24      cancel [CAN]                            */
+    NPC7,       /*    25      end of medium [EM]                      */
+    NPC7,       /*    26      substitute [SUB]                        */
+    NPC7,       /*    27      escape [ESC]                            */
+    NPC7,       /*    28      file separator [FS]                     */
+    NPC7,       /*    29      group separator [GS]                    */
+    NPC7,       /*    30      record separator [RS]                   */
+    NPC7,       /*    31      unit separator [US]                     */
+    32,         /*    32      space                                   */
+    33,         /*    33    ! exclamation mark                        */
+    34,         /*    34    " double quotation mark                   */
+    35,         /*    35    # number sign                             */
+    2,          /*    36    $ dollar sign                             */
+    37,         /*    37    % percent sign                            */
+    38,         /*    38    & ampersand                               */
+    39,         /*    39    ' apostrophe                              */
+    40,         /*    40    ( left parenthesis                        */
+    41,         /*    41    ) right parenthesis                       */
+    42,         /*    42    * asterisk                                */
+    43,         /*    43    + plus sign                               */
+    44,         /*    44    , comma                                   */
+    45,         /*    45    - hyphen                                  */
+    46,         /*    46    . period                                  */
+    47,         /*    47    / slash,                                  */
+    48,         /*    48    0 digit 0                                 */
+    49,         /*    49    1 digit 1                                 */
+    50,         /*    50    2 digit 2                                 */
+    51,         /*    51    3 digit 3                                 */
+    52,         /*    52    4 digit 4                                 */
+    53,         /*    53    5 digit 5                                 */
+    54,         /*    54    6 digit 6                                 */
+    55,         /*    55    7 digit 7                                 */
+    56,         /*    56    8 digit 8                                 */
+    57,         /*    57    9 digit 9                                 */
+    58,         /*    58    : colon                                   */
+    59,         /*    59    ; semicolon                               */
+    60,         /*    60    < less-than sign                          */
+    61,         /*    61    = equal sign                              */
+    62,         /*    62    > greater-than sign                       */
+    63,         /*    63    ? question mark                           */
+    0,          /*    64    @ commercial at sign                      */
+    65,         /*    65    A uppercase A                             */
+    66,         /*    66    B uppercase B                             */
+    67,         /*    67    C uppercase C                             */
+    68,         /*    68    D uppercase D                             */
+    69,         /*    69    E uppercase E                             */
+    70,         /*    70    F uppercase F                             */
+    71,         /*    71    G uppercase G                             */
+    72,         /*    72    H uppercase H                             */
+    73,         /*    73    I uppercase I                             */
+    74,         /*    74    J uppercase J                             */
+    75,         /*    75    K uppercase K                             */
+    76,         /*    76    L uppercase L                             */
+    77,         /*    77    M uppercase M                             */
+    78,         /*    78    N uppercase N                             */
+    79,         /*    79    O uppercase O                             */
+    80,         /*    80    P uppercase P                             */
+    81,         /*    81    Q uppercase Q                             */
+    82,         /*    82    R uppercase R                             */
+    83,         /*    83    S uppercase S                             */
+    84,         /*    84    T uppercase T                             */
+    85,         /*    85    U uppercase U                             */
+    86,         /*    86    V uppercase V                             */
+    87,         /*    87    W uppercase W                             */
+    88,         /*    88    X uppercase X                             */
+    89,         /*    89    Y uppercase Y                             */
+    90,         /*    90    Z uppercase Z                             */
+    60+128,     /*    91    [ left square bracket                     */
+    47+128,     /*    92    \ backslash                               */
+    62+128,     /*    93    ] right square bracket                    */
+    20+128,     /*    94    ^ circumflex accent                       */
+    17,         /*    95    _ underscore                              */
+    -39,        /*    96    ` back apostrophe                         */
+    97,         /*    97    a lowercase a                             */
+    98,         /*    98    b lowercase b                             */
+    99,         /*    99    c lowercase c                             */
+    100,        /*   100    d lowercase d                             */
+    101,        /*   101    e lowercase e                             */
+    102,        /*   102    f lowercase f                             */
+    103,        /*   103    g lowercase g                             */
+    104,        /*   104    h lowercase h                             */
+    105,        /*   105    i lowercase i                             */
+    106,        /*   106    j lowercase j                             */
+    107,        /*   107    k lowercase k                             */
+    108,        /*   108    l lowercase l                             */
+    109,        /*   109    m lowercase m                             */
+    110,        /*   110    n lowercase n                             */
+    111,        /*   111    o lowercase o                             */
+    112,        /*   112    p lowercase p                             */
+    113,        /*   113    q lowercase q                             */
+    114,        /*   114    r lowercase r                             */
+    115,        /*   115    s lowercase s                             */
+    116,        /*   116    t lowercase t                             */
+    117,        /*   117    u lowercase u                             */
+    118,        /*   118    v lowercase v                             */
+    119,        /*   119    w lowercase w                             */
+    120,        /*   120    x lowercase x                             */
+    121,        /*   121    y lowercase y                             */
+    122,        /*   122    z lowercase z                             */
+    40+128,     /*   123    { left brace                              */
+    64+128,     /*   124    | vertical bar                            */
+    41+128,     /*   125    } right brace                             */
+    61+128,     /*   126    ~ tilde accent                            */
+    NPC7,       /*   127      delete [DEL]                            */
+    NPC7,       /*   128                                              */
+    NPC7,       /*   129                                              */
+    39,         /*   130      low left rising single quote            */
+    102,        /*   131      lowercase italic f                      */
+    34,         /*   132      low left rising double quote            */
+    NPC7,       /*   133      low horizontal ellipsis                 */
+    NPC7,       /*   134      dagger mark                             */
+    NPC7,       /*   135      double dagger mark                      */
+    NPC7,       /*   136      letter modifying circumflex             */
+    NPC7,       /*   137      per thousand (mille) sign               */
+    83,         /*   138      uppercase S caron or hacek              */
+    39,         /*   139      left single angle quote mark            */
+    214,        /*   140      uppercase OE ligature                   */
+    NPC7,       /*   141                                              */
+    NPC7,       /*   142                                              */
+    NPC7,       /*   143                                              */
+    NPC7,       /*   144                                              */
+    39,         /*   145      left single quotation mark              */
+    39,         /*   146      right single quote mark                 */
+    34,         /*   147      left double quotation mark              */
+    34,         /*   148      right double quote mark                 */
+    42,         /*   149      round filled bullet                     */
+    45,         /*   150      en dash                                 */
+    45,         /*   151      em dash                                 */
+    39,         /*   152      small spacing tilde accent              */
+    NPC7,       /*   153      trademark sign                          */
+    115,        /*   154      lowercase s caron or hacek              */
+    39,         /*   155      right single angle quote mark           */
+    111,        /*   156      lowercase oe ligature                   */
+    NPC7,       /*   157                                              */
+    NPC7,       /*   158                                              */
+    89,         /*   159      uppercase Y dieresis or umlaut          */
+    32,         /*   160      non-breaking space                      */
+    64,         /*   161    ¡ inverted exclamation mark               */
+    99,         /*   162    ¢ cent sign                               */
+    1,          /*   163    £ pound sterling sign                     */
+    36,         /*   164    € general currency sign                   */
+    3,          /*   165    ¥ yen sign                                */
+    33,         /*   166    Š broken vertical bar                     */
+    95,         /*   167    § section sign                            */
+    34,         /*   168    š spacing dieresis or umlaut              */
+    NPC7,       /*   169    © copyright sign                          */
+    NPC7,       /*   170    ª feminine ordinal indicator              */
+    60,         /*   171    « left (double) angle quote               */
+    NPC7,       /*   172    ¬ logical not sign                        */
+    45,         /*   173    ­ soft hyphen                             */
+    NPC7,       /*   174    ® registered trademark sign               */
+    NPC7,       /*   175    ¯ spacing macron (long) accent            */
+    NPC7,       /*   176    ° degree sign                             */
+    NPC7,       /*   177    ± plus-or-minus sign                      */
+    50,         /*   178    ² superscript 2                           */
+    51,         /*   179    ³ superscript 3                           */
+    39,         /*   180    Ž spacing acute accent                    */
+    117,        /*   181    µ micro sign                              */
+    NPC7,       /*   182    ¶ paragraph sign, pilcrow sign            */
+    NPC7,       /*   183    · middle dot, centered dot                */
+    NPC7,       /*   184    ž spacing cedilla                         */
+    49,         /*   185    ¹ superscript 1                           */
+    NPC7,       /*   186    º masculine ordinal indicator             */
+    62,         /*   187    » right (double) angle quote (guillemet)  */
+    NPC7,       /*   188    Œ fraction 1/4                            */
+    NPC7,       /*   189    œ fraction 1/2                            */
+    NPC7,       /*   190    Ÿ fraction 3/4                            */
+    96,         /*   191    ¿ inverted question mark                  */
+    65,         /*   192    À uppercase A grave                       */
+    65,         /*   193    Á uppercase A acute                       */
+    65,         /*   194    Â uppercase A circumflex                  */
+    65,         /*   195    Ã uppercase A tilde                       */
+    91,         /*   196    Ä uppercase A dieresis or umlaut          */
+    14,         /*   197    Å uppercase A ring                        */
+    28,         /*   198    Æ uppercase AE ligature                   */
+    9,          /*   199    Ç uppercase C cedilla                     */
+    31,         /*   200    È uppercase E grave                       */
+    31,         /*   201    É uppercase E acute                       */
+    31,         /*   202    Ê uppercase E circumflex                  */
+    31,         /*   203    Ë uppercase E dieresis or umlaut          */
+    73,         /*   204    Ì uppercase I grave                       */
+    73,         /*   205    Í uppercase I acute                       */
+    73,         /*   206    Î uppercase I circumflex                  */
+    73,         /*   207    Ï uppercase I dieresis or umlaut          */
+    68,         /*   208    Ð uppercase ETH                           */
+    93,         /*   209    Ñ uppercase N tilde                       */
+    79,         /*   210    Ò uppercase O grave                       */
+    79,         /*   211    Ó uppercase O acute                       */
+    79,         /*   212    Ô uppercase O circumflex                  */
+    79,         /*   213    Õ uppercase O tilde                       */
+    92,         /*   214    Ö uppercase O dieresis or umlaut          */
+    42,         /*   215    × multiplication sign                     */
+    11,         /*   216    Ø uppercase O slash                       */
+    85,         /*   217    Ù uppercase U grave                       */
+    85,         /*   218    Ú uppercase U acute                       */
+    85,         /*   219    Û uppercase U circumflex                  */
+    94,         /*   220    Ü uppercase U dieresis or umlaut          */
+    89,         /*   221    Ý uppercase Y acute                       */
+    NPC7,       /*   222    Þ uppercase THORN                         */
+    30,         /*   223    ß lowercase sharp s, sz ligature          */
+    127,        /*   224    à lowercase a grave                       */
+    97,         /*   225    á lowercase a acute                       */
+    97,         /*   226    â lowercase a circumflex                  */
+    97,         /*   227    ã lowercase a tilde                       */
+    123,        /*   228    ä lowercase a dieresis or umlaut          */
+    15,         /*   229    å lowercase a ring                        */
+    29,         /*   230    æ lowercase ae ligature                   */
+    9,          /*   231    ç lowercase c cedilla                     */
+    4,          /*   232    è lowercase e grave                       */
+    5,          /*   233    é lowercase e acute                       */
+    101,        /*   234    ê lowercase e circumflex                  */
+    101,        /*   235    ë lowercase e dieresis or umlaut          */
+    7,          /*   236    ì lowercase i grave                       */
+    7,          /*   237    í lowercase i acute                       */
+    105,        /*   238    î lowercase i circumflex                  */
+    105,        /*   239    ï lowercase i dieresis or umlaut          */
+    NPC7,       /*   240    ð lowercase eth                           */
+    125,        /*   241    ñ lowercase n tilde                       */
+    8,          /*   242    ò lowercase o grave                       */
+    111,        /*   243    ó lowercase o acute                       */
+    111,        /*   244    ô lowercase o circumflex                  */
+    111,        /*   245    õ lowercase o tilde                       */
+    124,        /*   246    ö lowercase o dieresis or umlaut          */
+    47,         /*   247    ÷ division sign                           */
+    12,         /*   248    ø lowercase o slash                       */
+    6,          /*   249    ù lowercase u grave                       */
+    117,        /*   250    ú lowercase u acute                       */
+    117,        /*   251    û lowercase u circumflex                  */
+    126,        /*   252    ü lowercase u dieresis or umlaut          */
+    121,        /*   253    ý lowercase y acute                       */
+    NPC7,       /*   254    þ lowercase thorn                         */
+    121         /*   255    ÿ lowercase y dieresis or umlaut          */
+};
+
+
+
+/****************************************************************************
+ *  This lookup table converts from the 7 bit "default alphabet" as
+ *   defined in ETSI GSM 03.38 to a standard ISO-8859-1 8-bit ASCII.
+ *
+ *   Some characters in the 7-bit alphabet does not exist in the ISO
+ *   character set, they are replaced by the NPC8-character.
+ *
+ *   If the character is decimal 27 (ESC) the following character have
+ *   a special meaning and must be handled separately.
+ ****************************************************************************/
+static const uint8_t Ascii7to8[] = {
+    64,         /*  0      @  COMMERCIAL AT                           */
+    163,        /*  1      £  POUND SIGN                              */
+    36,         /*  2      $  DOLLAR SIGN                             */
+    165,        /*  3      ¥  YEN SIGN                                */
+    232,        /*  4      è  LATIN SMALL LETTER E WITH GRAVE         */
+    233,        /*  5      é  LATIN SMALL LETTER E WITH ACUTE         */
+    249,        /*  6      ù  LATIN SMALL LETTER U WITH GRAVE         */
+    236,        /*  7      ì  LATIN SMALL LETTER I WITH GRAVE         */
+    242,        /*  8      ò  LATIN SMALL LETTER O WITH GRAVE         */
+    199,        /*  9      Ç  LATIN CAPITAL LETTER C WITH CEDILLA     */
+    10,         /*  10        LINE FEED                               */
+    216,        /*  11     Ø  LATIN CAPITAL LETTER O WITH STROKE      */
+    248,        /*  12     ø  LATIN SMALL LETTER O WITH STROKE        */
+    13,         /*  13        CARRIAGE RETURN                         */
+    197,        /*  14     Å  LATIN CAPITAL LETTER A WITH RING ABOVE  */
+    229,        /*  15     å  LATIN SMALL LETTER A WITH RING ABOVE    */
+    NPC8,       /*  16        GREEK CAPITAL LETTER DELTA              */
+    95,         /*  17     _  LOW LINE                                */
+    NPC8,       /*  18        GREEK CAPITAL LETTER PHI                */
+    NPC8,       /*  19        GREEK CAPITAL LETTER GAMMA              */
+    NPC8,       /*  20        GREEK CAPITAL LETTER LAMBDA             */
+    NPC8,       /*  21        GREEK CAPITAL LETTER OMEGA              */
+    NPC8,       /*  22        GREEK CAPITAL LETTER PI                 */
+    NPC8,       /*  23        GREEK CAPITAL LETTER PSI                */
+    NPC8,       /*  24        GREEK CAPITAL LETTER SIGMA              */
+    NPC8,       /*  25        GREEK CAPITAL LETTER THETA              */
+    NPC8,       /*  26        GREEK CAPITAL LETTER XI                 */
+    27,         /*  27        ESCAPE TO EXTENSION TABLE               */
+    198,        /*  28     Æ  LATIN CAPITAL LETTER AE                 */
+    230,        /*  29     æ  LATIN SMALL LETTER AE                   */
+    223,        /*  30     ß  LATIN SMALL LETTER SHARP S (German)     */
+    201,        /*  31     É  LATIN CAPITAL LETTER E WITH ACUTE       */
+    32,         /*  32        SPACE                                   */
+    33,         /*  33     !  EXCLAMATION MARK                        */
+    34,         /*  34     "  QUOTATION MARK                          */
+    35,         /*  35     #  NUMBER SIGN                             */
+    164,        /*  36     €  CURRENCY SIGN                           */
+    37,         /*  37     %  PERCENT SIGN                            */
+    38,         /*  38     &  AMPERSAND                               */
+    39,         /*  39     '  APOSTROPHE                              */
+    40,         /*  40     (  LEFT PARENTHESIS                        */
+    41,         /*  41     )  RIGHT PARENTHESIS                       */
+    42,         /*  42     *  ASTERISK                                */
+    43,         /*  43     +  PLUS SIGN                               */
+    44,         /*  44     ,  COMMA                                   */
+    45,         /*  45     -  HYPHEN-MINUS                            */
+    46,         /*  46     .  FULL STOP                               */
+    47,         /*  47     /  SOLIDUS (SLASH)                         */
+    48,         /*  48     0  DIGIT ZERO                              */
+    49,         /*  49     1  DIGIT ONE                               */
+    50,         /*  50     2  DIGIT TWO                               */
+    51,         /*  51     3  DIGIT THREE                             */
+    52,         /*  52     4  DIGIT FOUR                              */
+    53,         /*  53     5  DIGIT FIVE                              */
+    54,         /*  54     6  DIGIT SIX                               */
+    55,         /*  55     7  DIGIT SEVEN                             */
+    56,         /*  56     8  DIGIT EIGHT                             */
+    57,         /*  57     9  DIGIT NINE                              */
+    58,         /*  58     :  COLON                                   */
+    59,         /*  59     ;  SEMICOLON                               */
+    60,         /*  60     <  LESS-THAN SIGN                          */
+    61,         /*  61     =  EQUALS SIGN                             */
+    62,         /*  62     >  GREATER-THAN SIGN                       */
+    63,         /*  63     ?  QUESTION MARK                           */
+    161,        /*  64     ¡  INVERTED EXCLAMATION MARK               */
+    65,         /*  65     A  LATIN CAPITAL LETTER A                  */
+    66,         /*  66     B  LATIN CAPITAL LETTER B                  */
+    67,         /*  67     C  LATIN CAPITAL LETTER C                  */
+    68,         /*  68     D  LATIN CAPITAL LETTER D                  */
+    69,         /*  69     E  LATIN CAPITAL LETTER E                  */
+    70,         /*  70     F  LATIN CAPITAL LETTER F                  */
+    71,         /*  71     G  LATIN CAPITAL LETTER G                  */
+    72,         /*  72     H  LATIN CAPITAL LETTER H                  */
+    73,         /*  73     I  LATIN CAPITAL LETTER I                  */
+    74,         /*  74     J  LATIN CAPITAL LETTER J                  */
+    75,         /*  75     K  LATIN CAPITAL LETTER K                  */
+    76,         /*  76     L  LATIN CAPITAL LETTER L                  */
+    77,         /*  77     M  LATIN CAPITAL LETTER M                  */
+    78,         /*  78     N  LATIN CAPITAL LETTER N                  */
+    79,         /*  79     O  LATIN CAPITAL LETTER O                  */
+    80,         /*  80     P  LATIN CAPITAL LETTER P                  */
+    81,         /*  81     Q  LATIN CAPITAL LETTER Q                  */
+    82,         /*  82     R  LATIN CAPITAL LETTER R                  */
+    83,         /*  83     S  LATIN CAPITAL LETTER S                  */
+    84,         /*  84     T  LATIN CAPITAL LETTER T                  */
+    85,         /*  85     U  LATIN CAPITAL LETTER U                  */
+    86,         /*  86     V  LATIN CAPITAL LETTER V                  */
+    87,         /*  87     W  LATIN CAPITAL LETTER W                  */
+    88,         /*  88     X  LATIN CAPITAL LETTER X                  */
+    89,         /*  89     Y  LATIN CAPITAL LETTER Y                  */
+    90,         /*  90     Z  LATIN CAPITAL LETTER Z                  */
+    196,        /*  91     Ä  LATIN CAPITAL LETTER A WITH DIAERESIS   */
+    214,        /*  92     Ö  LATIN CAPITAL LETTER O WITH DIAERESIS   */
+    209,        /*  93     Ñ  LATIN CAPITAL LETTER N WITH TILDE       */
+    220,        /*  94     Ü  LATIN CAPITAL LETTER U WITH DIAERESIS   */
+    167,        /*  95     §  SECTION SIGN                            */
+    191,        /*  96     ¿  INVERTED QUESTION MARK                  */
+    97,         /*  97     a  LATIN SMALL LETTER A                    */
+    98,         /*  98     b  LATIN SMALL LETTER B                    */
+    99,         /*  99     c  LATIN SMALL LETTER C                    */
+    100,        /*  100    d  LATIN SMALL LETTER D                    */
+    101,        /*  101    e  LATIN SMALL LETTER E                    */
+    102,        /*  102    f  LATIN SMALL LETTER F                    */
+    103,        /*  103    g  LATIN SMALL LETTER G                    */
+    104,        /*  104    h  LATIN SMALL LETTER H                    */
+    105,        /*  105    i  LATIN SMALL LETTER I                    */
+    106,        /*  106    j  LATIN SMALL LETTER J                    */
+    107,        /*  107    k  LATIN SMALL LETTER K                    */
+    108,        /*  108    l  LATIN SMALL LETTER L                    */
+    109,        /*  109    m  LATIN SMALL LETTER M                    */
+    110,        /*  110    n  LATIN SMALL LETTER N                    */
+    111,        /*  111    o  LATIN SMALL LETTER O                    */
+    112,        /*  112    p  LATIN SMALL LETTER P                    */
+    113,        /*  113    q  LATIN SMALL LETTER Q                    */
+    114,        /*  114    r  LATIN SMALL LETTER R                    */
+    115,        /*  115    s  LATIN SMALL LETTER S                    */
+    116,        /*  116    t  LATIN SMALL LETTER T                    */
+    117,        /*  117    u  LATIN SMALL LETTER U                    */
+    118,        /*  118    v  LATIN SMALL LETTER V                    */
+    119,        /*  119    w  LATIN SMALL LETTER W                    */
+    120,        /*  120    x  LATIN SMALL LETTER X                    */
+    121,        /*  121    y  LATIN SMALL LETTER Y                    */
+    122,        /*  122    z  LATIN SMALL LETTER Z                    */
+    228,        /*  123    ä  LATIN SMALL LETTER A WITH DIAERESIS     */
+    246,        /*  124    ö  LATIN SMALL LETTER O WITH DIAERESIS     */
+    241,        /*  125    ñ  LATIN SMALL LETTER N WITH TILDE         */
+    252,        /*  126    ü  LATIN SMALL LETTER U WITH DIAERESIS     */
+    224         /*  127    à  LATIN SMALL LETTER A WITH GRAVE         */
+
+    /*  The double bytes below must be handled separately after the
+     *   table lookup.
+     *
+     *   12             27 10      FORM FEED
+     *   94             27 20   ^  CIRCUMFLEX ACCENT
+     *   123            27 40   {  LEFT CURLY BRACKET
+     *   125            27 41   }  RIGHT CURLY BRACKET
+     *   92             27 47   \  REVERSE SOLIDUS (BACKSLASH)
+     *   91             27 60   [  LEFT SQUARE BRACKET
+     *   126            27 61   ~  TILDE
+     *   93             27 62   ]  RIGHT SQUARE BRACKET
+     *   124            27 64   |  VERTICAL BAR                             */
+
+};
+
+/****************************************************************************
+ *  This lookup table converts the characters of the GSM 03.38 extension
+ *   table, following an escape, to ISO-8859-1 8-bit ASCII.
+ *
+ *   Characters which are not in the extension table, or don't exist in the
+ *   ISO character set, are left to 0 and replaced by the NPC8-character.
+ ****************************************************************************/
+static const uint8_t AsciiExt7to8[128] =
+{
+    [10] = 12,          /* FORM FEED                                */
+    [20] = '^',         /* CIRCUMFLEX ACCENT                        */
+    [40] = '{',         /* LEFT CURLY BRACKET                       */
+    [41] = '}',         /* RIGHT CURLY BRACKET                      */
+    [47] = '\\',        /* REVERSE SOLIDUS (BACKSLASH)              */
+    [60] = '[',         /* LEFT SQUARE BRACKET                      */
+    [61] = '~',         /* TILDE                                    */
+    [62] = ']',         /* RIGHT SQUARE BRACKET                     */
+    [64] = '|',         /* VERTICAL BAR                             */
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * GSM 03.38 default alphabet to UCS-2.
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint16_t Ucs2Default[128] =
+{
+    0x0040, 0x00A3, 0x0024, 0x00A5, 0x00E8, 0x00E9, 0x00F9, 0x00EC,     /* 0x00 */
+    0x00F2, 0x00C7, 0x000A, 0x00D8, 0x00F8, 0x000D, 0x00C5, 0x00E5,     /* 0x08 */
+    0x0394, 0x005F, 0x03A6, 0x0393, 0x039B, 0x03A9, 0x03A0, 0x03A8,     /* 0x10 */
+    0x03A3, 0x0398, 0x039E, 0x001B, 0x00C6, 0x00E6, 0x00DF, 0x00C9,     /* 0x18 */
+    0x0020, 0x0021, 0x0022, 0x0023, 0x00A4, 0x0025, 0x0026, 0x0027,     /* 0x20 */
+    0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F,     /* 0x28 */
+    0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,     /* 0x30 */
+    0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F,     /* 0x38 */
+    0x00A1, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047,     /* 0x40 */
+    0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F,     /* 0x48 */
+    0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057,     /* 0x50 */
+    0x0058, 0x0059, 0x005A, 0x00C4, 0x00D6, 0x00D1, 0x00DC, 0x00A7,     /* 0x58 */
+    0x00BF, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,     /* 0x60 */
+    0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,     /* 0x68 */
+    0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,     /* 0x70 */
+    0x0078, 0x0079, 0x007A, 0x00E4, 0x00F6, 0x00F1, 0x00FC, 0x00E0,     /* 0x78 */
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * UCS-2 characters beyond ISO-8859-1 which have an equivalent in GSM 03.38: their septet, + 128
+ * for the extension table. The other characters are converted through Ascii8to7.
+ */
+//--------------------------------------------------------------------------------------------------
+static const struct
+{
+    uint16_t ucs2;      ///< UCS-2 character
+    uint8_t  septet;    ///< Septet, + 128 for the extension table
+}
+Ucs2Extra[] =
+{
+    { 0x20AC, 101+128 },    /* EURO SIGN                                */
+    { 0x0394, 16 },         /* GREEK CAPITAL LETTER DELTA               */
+    { 0x03A6, 18 },         /* GREEK CAPITAL LETTER PHI                 */
+    { 0x0393, 19 },         /* GREEK CAPITAL LETTER GAMMA               */
+    { 0x039B, 20 },         /* GREEK CAPITAL LETTER LAMBDA              */
+    { 0x03A9, 21 },         /* GREEK CAPITAL LETTER OMEGA               */
+    { 0x03A0, 22 },         /* GREEK CAPITAL LETTER PI                  */
+    { 0x03A8, 23 },         /* GREEK CAPITAL LETTER PSI                 */
+    { 0x03A3, 24 },         /* GREEK CAPITAL LETTER SIGMA               */
+    { 0x0398, 25 },         /* GREEK CAPITAL LETTER THETA               */
+    { 0x039E, 26 },         /* GREEK CAPITAL LETTER XI                  */
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extension table to UCS-2, 0 for characters which are not in the extension table.
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint16_t Ucs2Ext[128] =
+{
+    [10]  = 0x000C,     /* FORM FEED                                */
+    [20]  = 0x005E,     /* CIRCUMFLEX ACCENT                        */
+    [40]  = 0x007B,     /* LEFT CURLY BRACKET                       */
+    [41]  = 0x007D,     /* RIGHT CURLY BRACKET                      */
+    [47]  = 0x005C,     /* REVERSE SOLIDUS (BACKSLASH)              */
+    [60]  = 0x005B,     /* LEFT SQUARE BRACKET                      */
+    [61]  = 0x007E,     /* TILDE                                    */
+    [62]  = 0x005D,     /* RIGHT SQUARE BRACKET                     */
+    [64]  = 0x007C,     /* VERTICAL BAR                             */
+    [101] = 0x20AC,     /* EURO SIGN                                */
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the septets of an UCS-2 character, + 128 for the extension table.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t Ucs2ToSeptet
+(
+    uint16_t ucs2       ///< [IN] UCS-2 character
+)
+{
+    size_t i;
+
+    if (ucs2 < NUM_ARRAY_MEMBERS(Ascii8to7))
+    {
+        return Ascii8to7[ucs2];
+    }
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Ucs2Extra); i++)
+    {
+        if (Ucs2Extra[i].ucs2 == ucs2)
+        {
+            return Ucs2Extra[i].septet;
+        }
+    }
+
+    return NPC7;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load 8 bytes as a little endian word. The compiler turns this into a single load where the
+ * target allows it.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t Load8Le
+(
+    const uint8_t* bufPtr
+)
+{
+    return (uint64_t)bufPtr[0]       | (uint64_t)bufPtr[1] << 8  |
+           (uint64_t)bufPtr[2] << 16 | (uint64_t)bufPtr[3] << 24 |
+           (uint64_t)bufPtr[4] << 32 | (uint64_t)bufPtr[5] << 40 |
+           (uint64_t)bufPtr[6] << 48 | (uint64_t)bufPtr[7] << 56;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load 8 bytes as a big endian word.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t Load8Be
+(
+    const uint8_t* bufPtr
+)
+{
+    return (uint64_t)bufPtr[0] << 56 | (uint64_t)bufPtr[1] << 48 |
+           (uint64_t)bufPtr[2] << 40 | (uint64_t)bufPtr[3] << 32 |
+           (uint64_t)bufPtr[4] << 24 | (uint64_t)bufPtr[5] << 16 |
+           (uint64_t)bufPtr[6] << 8  | (uint64_t)bufPtr[7];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store a word as 8 little endian bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void Store8Le
+(
+    uint8_t* bufPtr,
+    uint64_t word
+)
+{
+    bufPtr[0] = word;
+    bufPtr[1] = word >> 8;
+    bufPtr[2] = word >> 16;
+    bufPtr[3] = word >> 24;
+    bufPtr[4] = word >> 32;
+    bufPtr[5] = word >> 40;
+    bufPtr[6] = word >> 48;
+    bufPtr[7] = word >> 56;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store a word as 8 big endian bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void Store8Be
+(
+    uint8_t* bufPtr,
+    uint64_t word
+)
+{
+    bufPtr[0] = word >> 56;
+    bufPtr[1] = word >> 48;
+    bufPtr[2] = word >> 40;
+    bufPtr[3] = word >> 32;
+    bufPtr[4] = word >> 24;
+    bufPtr[5] = word >> 16;
+    bufPtr[6] = word >> 8;
+    bufPtr[7] = word;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load less than 8 bytes as a little endian word.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t LoadLe
+(
+    const uint8_t* bufPtr,
+    size_t         size
+)
+{
+    uint64_t word = 0;
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        word |= (uint64_t)bufPtr[i] << (8 * i);
+    }
+
+    return word;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load less than 8 bytes as the high bytes of a big endian word.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t LoadBe
+(
+    const uint8_t* bufPtr,
+    size_t         size
+)
+{
+    uint64_t word = 0;
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        word |= (uint64_t)bufPtr[i] << (56 - 8 * i);
+    }
+
+    return word;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store the low bytes of a word, little endian.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void StoreLe
+(
+    uint8_t* bufPtr,
+    uint64_t word,
+    size_t   size
+)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        bufPtr[i] = word >> (8 * i);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store the high bytes of a word, big endian.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void StoreBe
+(
+    uint8_t* bufPtr,
+    uint64_t word,
+    size_t   size
+)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        bufPtr[i] = word >> (56 - 8 * i);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack the 8 septets held in the bytes of a word into its 56 low bits. Each byte is merged with its
+ * neighbour, then each pair of 14 bits with its neighbour, then each pair of 28 bits, so that the
+ * septet of the byte n ends up at bit 7n.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t GatherSeptets
+(
+    uint64_t word
+)
+{
+    word &= 0x7F7F7F7F7F7F7F7FULL;
+    word = (word & 0x007F007F007F007FULL) | ((word & 0x7F007F007F007F00ULL) >> 1);
+    word = (word & 0x00003FFF00003FFFULL) | ((word & 0x3FFF00003FFF0000ULL) >> 2);
+    word = (word & 0x000000000FFFFFFFULL) | ((word & 0x0FFFFFFF00000000ULL) >> 4);
+
+    return word;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Spread the 8 septets packed in the 56 low bits of a word into its bytes: the reverse of
+ * GatherSeptets().
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t ScatterSeptets
+(
+    uint64_t word
+)
+{
+    word = (word & 0x000000000FFFFFFFULL) | ((word << 4) & 0x0FFFFFFF00000000ULL);
+    word = (word & 0x00003FFF00003FFFULL) | ((word << 2) & 0x3FFF00003FFF0000ULL);
+    word = (word & 0x007F007F007F007FULL) | ((word << 1) & 0x7F007F007F007F00ULL);
+
+    return word;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack GSM septets, LSB first. The 8th bit of the septets is ignored.
+ *
+ * @return Number of written bytes (SMS7BITS_PACKED_SIZE(numSeptets))
+ */
+//--------------------------------------------------------------------------------------------------
+size_t sms7Bits_Pack
+(
+    const uint8_t* septetsPtr,  ///< [IN] septets to pack
+    size_t         numSeptets,  ///< [IN] number of septets
+    uint8_t*       bytesPtr     ///< [OUT] packed septets
+)
+{
+    size_t remaining = numSeptets;
+
+    // 8 septets -> 7 bytes. While another group follows, the 8th byte written is overwritten by
+    // the next group.
+    while (remaining >= 16)
+    {
+        Store8Le(bytesPtr, GatherSeptets(Load8Le(septetsPtr)));
+        septetsPtr += 8;
+        bytesPtr += 7;
+        remaining -= 8;
+    }
+
+    if (remaining >= 8)
+    {
+        StoreLe(bytesPtr, GatherSeptets(Load8Le(septetsPtr)), 7);
+        septetsPtr += 8;
+        bytesPtr += 7;
+        remaining -= 8;
+    }
+
+    if (remaining)
+    {
+        StoreLe(bytesPtr,
+                GatherSeptets(LoadLe(septetsPtr, remaining)),
+                SMS7BITS_PACKED_SIZE(remaining));
+    }
+
+    return SMS7BITS_PACKED_SIZE(numSeptets);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack GSM septets packed LSB first. SMS7BITS_PACKED_SIZE(numSeptets) bytes are read.
+ */
+//--------------------------------------------------------------------------------------------------
+void sms7Bits_Unpack
+(
+    const uint8_t* bytesPtr,    ///< [IN] packed septets
+    size_t         numSeptets,  ///< [IN] number of septets to unpack
+    uint8_t*       septetsPtr   ///< [OUT] septets
+)
+{
+    size_t remaining = numSeptets;
+
+    // 7 bytes -> 8 septets. While another group follows, its first byte can be loaded too.
+    while (remaining >= 16)
+    {
+        Store8Le(septetsPtr, ScatterSeptets(Load8Le(bytesPtr) & 0x00FFFFFFFFFFFFFFULL));
+        bytesPtr += 7;
+        septetsPtr += 8;
+        remaining -= 8;
+    }
+
+    if (remaining >= 8)
+    {
+        Store8Le(septetsPtr, ScatterSeptets(LoadLe(bytesPtr, 7)));
+        bytesPtr += 7;
+        septetsPtr += 8;
+        remaining -= 8;
+    }
+
+    if (remaining)
+    {
+        StoreLe(septetsPtr,
+                ScatterSeptets(LoadLe(bytesPtr, SMS7BITS_PACKED_SIZE(remaining))),
+                remaining);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack CDMA septets, MSB first. The 8th bit of the septets is ignored.
+ *
+ * @return Number of written bytes (SMS7BITS_PACKED_SIZE(numSeptets))
+ */
+//--------------------------------------------------------------------------------------------------
+size_t sms7Bits_PackCdma
+(
+    const uint8_t* septetsPtr,  ///< [IN] septets to pack
+    size_t         numSeptets,  ///< [IN] number of septets
+    uint8_t*       bytesPtr     ///< [OUT] packed septets
+)
+{
+    size_t remaining = numSeptets;
+
+    // Loaded big endian, the first septet ends up in the high bits of the 56 bits word, which is
+    // then stored big endian from its 7 high bytes.
+    while (remaining >= 16)
+    {
+        Store8Be(bytesPtr, GatherSeptets(Load8Be(septetsPtr)) << 8);
+        septetsPtr += 8;
+        bytesPtr += 7;
+        remaining -= 8;
+    }
+
+    if (remaining >= 8)
+    {
+        StoreBe(bytesPtr, GatherSeptets(Load8Be(septetsPtr)) << 8, 7);
+        septetsPtr += 8;
+        bytesPtr += 7;
+        remaining -= 8;
+    }
+
+    if (remaining)
+    {
+        StoreBe(bytesPtr,
+                GatherSeptets(LoadBe(septetsPtr, remaining)) << 8,
+                SMS7BITS_PACKED_SIZE(remaining));
+    }
+
+    return SMS7BITS_PACKED_SIZE(numSeptets);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack CDMA septets packed MSB first. SMS7BITS_PACKED_SIZE(numSeptets) bytes are read.
+ */
+//--------------------------------------------------------------------------------------------------
+void sms7Bits_UnpackCdma
+(
+    const uint8_t* bytesPtr,    ///< [IN] packed septets
+    size_t         numSeptets,  ///< [IN] number of septets to unpack
+    uint8_t*       septetsPtr   ///< [OUT] septets
+)
+{
+    size_t remaining = numSeptets;
+
+    while (remaining >= 16)
+    {
+        Store8Be(septetsPtr, ScatterSeptets(Load8Be(bytesPtr) >> 8));
+        bytesPtr += 7;
+        septetsPtr += 8;
+        remaining -= 8;
+    }
+
+    if (remaining >= 8)
+    {
+        Store8Be(septetsPtr, ScatterSeptets(LoadBe(bytesPtr, 7) >> 8));
+        bytesPtr += 7;
+        septetsPtr += 8;
+        remaining -= 8;
+    }
+
+    if (remaining)
+    {
+        StoreBe(septetsPtr,
+                ScatterSeptets(LoadBe(bytesPtr, SMS7BITS_PACKED_SIZE(remaining)) >> 8),
+                remaining);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert ISO-8859-1 characters to GSM 03.38 septets. Characters of the extension table take two
+ * septets, characters without equivalent are replaced by a question mark.
+ *
+ * @return Number of septets, or LE_OVERFLOW if septetsSize is too small
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t sms7Bits_FromLatin1
+(
+    const uint8_t* latin1Ptr,   ///< [IN] ISO-8859-1 characters
+    size_t         length,      ///< [IN] number of characters
+    uint8_t*       septetsPtr,  ///< [OUT] septets
+    size_t         septetsSize  ///< [IN] septets buffer size
+)
+{
+    size_t read;
+    size_t write = 0;
+
+    for (read = 0; read < length; read++)
+    {
+        uint8_t septet = Ascii8to7[latin1Ptr[read]];
+
+        if (septet >= 128)
+        {
+            if (write + 2 > septetsSize)
+            {
+                return LE_OVERFLOW;
+            }
+
+            septetsPtr[write++] = ESC7;
+            septetsPtr[write++] = septet - 128;
+        }
+        else
+        {
+            if (write + 1 > septetsSize)
+            {
+                return LE_OVERFLOW;
+            }
+
+            septetsPtr[write++] = septet;
+        }
+    }
+
+    return write;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert GSM 03.38 septets to ISO-8859-1 characters. Characters without equivalent are replaced
+ * by a question mark.
+ *
+ * @return Number of characters, or LE_OVERFLOW if latin1Size is too small
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t sms7Bits_ToLatin1
+(
+    const uint8_t* septetsPtr,  ///< [IN] septets
+    size_t         numSeptets,  ///< [IN] number of septets
+    uint8_t*       latin1Ptr,   ///< [OUT] ISO-8859-1 characters
+    size_t         latin1Size   ///< [IN] characters buffer size
+)
+{
+    size_t read;
+    size_t write = 0;
+
+    for (read = 0; read < numSeptets; read++)
+    {
+        uint8_t septet = septetsPtr[read] & 0x7F;
+
+        if (write >= latin1Size)
+        {
+            return LE_OVERFLOW;
+        }
+
+        if (septet != ESC7)
+        {
+            latin1Ptr[write++] = Ascii7to8[septet];
+        }
+        else
+        {
+            // If we're escaped then the next septet has a special meaning.
+            read++;
+            latin1Ptr[write] = NPC8;
+
+            if ((read < numSeptets) && AsciiExt7to8[septetsPtr[read] & 0x7F])
+            {
+                latin1Ptr[write] = AsciiExt7to8[septetsPtr[read] & 0x7F];
+            }
+
+            write++;
+        }
+    }
+
+    return write;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert UCS-2 characters to GSM 03.38 septets. Characters of the extension table take two
+ * septets, characters without equivalent are replaced by a question mark.
+ *
+ * @return Number of septets, or LE_OVERFLOW if septetsSize is too small
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t sms7Bits_FromUcs2
+(
+    const uint16_t* ucs2Ptr,    ///< [IN] UCS-2 characters
+    size_t          length,     ///< [IN] number of characters
+    uint8_t*        septetsPtr, ///< [OUT] septets
+    size_t          septetsSize ///< [IN] septets buffer size
+)
+{
+    size_t read;
+    size_t write = 0;
+
+    for (read = 0; read < length; read++)
+    {
+        uint8_t septet = Ucs2ToSeptet(ucs2Ptr[read]);
+
+        if (septet >= 128)
+        {
+            if (write + 2 > septetsSize)
+            {
+                return LE_OVERFLOW;
+            }
+
+            septetsPtr[write++] = ESC7;
+            septetsPtr[write++] = septet - 128;
+        }
+        else
+        {
+            if (write + 1 > septetsSize)
+            {
+                return LE_OVERFLOW;
+            }
+
+            septetsPtr[write++] = septet;
+        }
+    }
+
+    return write;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert GSM 03.38 septets to UCS-2 characters. Unknown extension characters are replaced by a
+ * question mark.
+ *
+ * @return Number of characters, or LE_OVERFLOW if ucs2Size is too small
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t sms7Bits_ToUcs2
+(
+    const uint8_t* septetsPtr,  ///< [IN] septets
+    size_t         numSeptets,  ///< [IN] number of septets
+    uint16_t*      ucs2Ptr,     ///< [OUT] UCS-2 characters
+    size_t         ucs2Size     ///< [IN] number of characters of the buffer
+)
+{
+    size_t read;
+    size_t write = 0;
+
+    for (read = 0; read < numSeptets; read++)
+    {
+        uint8_t septet = septetsPtr[read] & 0x7F;
+
+        if (write >= ucs2Size)
+        {
+            return LE_OVERFLOW;
+        }
+
+        if (septet != ESC7)
+        {
+            ucs2Ptr[write++] = Ucs2Default[septet];
+        }
+        else
+        {
+            read++;
+            ucs2Ptr[write] = NPC16;
+
+            if ((read < numSeptets) && Ucs2Ext[septetsPtr[read] & 0x7F])
+            {
+                ucs2Ptr[write] = Ucs2Ext[septetsPtr[read] & 0x7F];
+            }
+
+            write++;
+        }
+    }
+
+    return write;
+}
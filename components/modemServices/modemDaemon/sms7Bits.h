@@ -0,0 +1,141 @@
+/** @file sms7Bits.h
+ *
+ * Functions to pack, unpack and transcode SMS 7 bits characters.
+ *
+ * GSM text is made of characters of the GSM 03.38 default alphabet ("septets"), packed LSB first:
+ * the first septet is in the 7 low bits of the first byte. CDMA 7 bits ASCII text is packed MSB
+ * first: the first septet is in the 7 high bits of the first byte. In both cases, 8 septets take
+ * 7 bytes.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+#ifndef SMS7BITS_H_
+#define SMS7BITS_H_
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes taken by packed septets.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SMS7BITS_PACKED_SIZE(numSeptets)    (((numSeptets) * 7 + 7) / 8)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack GSM septets, LSB first. The 8th bit of the septets is ignored.
+ *
+ * @return Number of written bytes (SMS7BITS_PACKED_SIZE(numSeptets))
+ */
+//--------------------------------------------------------------------------------------------------
+size_t sms7Bits_Pack
+(
+    const uint8_t* septetsPtr,  ///< [IN] septets to pack
+    size_t         numSeptets,  ///< [IN] number of septets
+    uint8_t*       bytesPtr     ///< [OUT] packed septets
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack GSM septets packed LSB first. SMS7BITS_PACKED_SIZE(numSeptets) bytes are read.
+ */
+//--------------------------------------------------------------------------------------------------
+void sms7Bits_Unpack
+(
+    const uint8_t* bytesPtr,    ///< [IN] packed septets
+    size_t         numSeptets,  ///< [IN] number of septets to unpack
+    uint8_t*       septetsPtr   ///< [OUT] septets
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack CDMA septets, MSB first. The 8th bit of the septets is ignored.
+ *
+ * @return Number of written bytes (SMS7BITS_PACKED_SIZE(numSeptets))
+ */
+//--------------------------------------------------------------------------------------------------
+size_t sms7Bits_PackCdma
+(
+    const uint8_t* septetsPtr,  ///< [IN] septets to pack
+    size_t         numSeptets,  ///< [IN] number of septets
+    uint8_t*       bytesPtr     ///< [OUT] packed septets
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack CDMA septets packed MSB first. SMS7BITS_PACKED_SIZE(numSeptets) bytes are read.
+ */
+//--------------------------------------------------------------------------------------------------
+void sms7Bits_UnpackCdma
+(
+    const uint8_t* bytesPtr,    ///< [IN] packed septets
+    size_t         numSeptets,  ///< [IN] number of septets to unpack
+    uint8_t*       septetsPtr   ///< [OUT] septets
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert ISO-8859-1 characters to GSM 03.38 septets. Characters of the extension table take two
+ * septets, characters without equivalent are replaced by a question mark.
+ *
+ * @return Number of septets, or LE_OVERFLOW if septetsSize is too small
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t sms7Bits_FromLatin1
+(
+    const uint8_t* latin1Ptr,   ///< [IN] ISO-8859-1 characters
+    size_t         length,      ///< [IN] number of characters
+    uint8_t*       septetsPtr,  ///< [OUT] septets
+    size_t         septetsSize  ///< [IN] septets buffer size
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert GSM 03.38 septets to ISO-8859-1 characters. Characters without equivalent are replaced
+ * by a question mark.
+ *
+ * @return Number of characters, or LE_OVERFLOW if latin1Size is too small
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t sms7Bits_ToLatin1
+(
+    const uint8_t* septetsPtr,  ///< [IN] septets
+    size_t         numSeptets,  ///< [IN] number of septets
+    uint8_t*       latin1Ptr,   ///< [OUT] ISO-8859-1 characters
+    size_t         latin1Size   ///< [IN] characters buffer size
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert UCS-2 characters to GSM 03.38 septets. Characters of the extension table take two
+ * septets, characters without equivalent are replaced by a question mark.
+ *
+ * @return Number of septets, or LE_OVERFLOW if septetsSize is too small
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t sms7Bits_FromUcs2
+(
+    const uint16_t* ucs2Ptr,    ///< [IN] UCS-2 characters
+    size_t          length,     ///< [IN] number of characters
+    uint8_t*        septetsPtr, ///< [OUT] septets
+    size_t          septetsSize ///< [IN] septets buffer size
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert GSM 03.38 septets to UCS-2 characters. Unknown extension characters are replaced by a
+ * question mark.
+ *
+ * @return Number of characters, or LE_OVERFLOW if ucs2Size is too small
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t sms7Bits_ToUcs2
+(
+    const uint8_t* septetsPtr,  ///< [IN] septets
+    size_t         numSeptets,  ///< [IN] number of septets
+    uint16_t*      ucs2Ptr,     ///< [OUT] UCS-2 characters
+    size_t         ucs2Size     ///< [IN] number of characters of the buffer
+);
+
+#endif // SMS7BITS_H_
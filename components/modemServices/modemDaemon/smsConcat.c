@@ -0,0 +1,515 @@
+/** @file smsConcat.c
+ *
+ * Reassembly of concatenated SMS messages.
+ *
+ * Pending messages are queued from the least recently to the most recently updated one, so that
+ * the head of the list is always the next message to evict. A single timer is armed for the
+ * expiry time of the head.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "smsConcat.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Received part of a pending message.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    smsConcat_PartStorage_t storage;                            ///< Storage of the part
+    char                    scts[LE_SMS_TIMESTAMP_MAX_BYTES];   ///< Time stamp of the part
+    uint32_t                dataLen;                            ///< User data length
+    uint8_t                 data[LE_SMS_TEXT_MAX_BYTES];        ///< User data
+}
+Part_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message with pending parts.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char            oa[LE_MDMDEFS_PHONE_NUM_MAX_BYTES];     ///< Originating address
+    uint16_t        ref;                                    ///< Reference number
+    bool            ref16Bits;                              ///< 16 bits reference number
+    uint8_t         maxNum;                                 ///< Number of parts of the message
+    le_sms_Format_t format;                                 ///< User data format
+    uint8_t         numParts;                               ///< Number of received parts
+    Part_t*         partPtr[LE_SMS_CONCAT_MAX_PARTS];       ///< Received parts, by sequence number
+    le_clk_Time_t   expiryTime;                             ///< Relative time of the eviction
+    le_dls_Link_t   link;                                   ///< Link for PendingMsgList
+}
+PendingMsg_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for pending messages, of SMSCONCAT_MAX_PENDING_MSGS objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PendingMsgPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for pending parts, of SMSCONCAT_MAX_PENDING_PARTS objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PartPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for delivered messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t MsgPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pending messages, the least recently updated first.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t PendingMsgList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Eviction timer, and the expiry time it is armed for.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t EvictionTimer;
+static le_clk_Time_t  ArmedExpiryTime;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time to wait for the missing parts of a message.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t Timeout;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler delivering the messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static smsConcat_MsgHandlerFunc_t MsgHandlerPtr;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the maximum length of a reassembled message in the given format.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetMaxDataLen
+(
+    le_sms_Format_t format
+)
+{
+    switch (format)
+    {
+        case LE_SMS_FORMAT_TEXT:
+            return LE_SMS_CONCAT_TEXT_MAX_LEN;
+        case LE_SMS_FORMAT_BINARY:
+            return LE_SMS_CONCAT_BINARY_MAX_BYTES;
+        case LE_SMS_FORMAT_UCS2:
+            return LE_SMS_CONCAT_UCS2_MAX_BYTES;
+        default:
+            return 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a received part.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetPart
+(
+    Part_t*                    partPtr,     ///< [OUT] Part
+    const pa_sms_SmsDeliver_t* smsPtr,      ///< [IN] Decoded part
+    pa_sms_Storage_t           storage,     ///< [IN] SMS storage location
+    uint32_t                   storageIdx   ///< [IN] SMS index in storage
+)
+{
+    partPtr->storage.storage = storage;
+    partPtr->storage.storageIdx = storageIdx;
+    memcpy(partPtr->scts, smsPtr->scts, sizeof(partPtr->scts));
+    partPtr->dataLen = smsPtr->dataLen;
+    memcpy(partPtr->data, smsPtr->data, smsPtr->dataLen);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deliver a single part.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeliverPart
+(
+    const char*     oaPtr,      ///< [IN] Originating address
+    le_sms_Format_t format,     ///< [IN] User data format
+    const Part_t*   partPtr     ///< [IN] Part
+)
+{
+    smsConcat_Msg_t* msgPtr = le_mem_ForceAlloc(MsgPool);
+
+    memcpy(msgPtr->oa, oaPtr, sizeof(msgPtr->oa));
+    memcpy(msgPtr->scts, partPtr->scts, sizeof(msgPtr->scts));
+    msgPtr->format = format;
+    msgPtr->numParts = 1;
+    msgPtr->part[0] = partPtr->storage;
+    msgPtr->dataLen = partPtr->dataLen;
+    memcpy(msgPtr->data, partPtr->data, partPtr->dataLen);
+    msgPtr->data[partPtr->dataLen] = '\0';
+
+    MsgHandlerPtr(msgPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a pending message and deliver its received parts one by one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EvictMsg
+(
+    PendingMsg_t* pendingPtr
+)
+{
+    int i;
+
+    LE_WARN("Evict message %u from %s: %u/%u parts received",
+            pendingPtr->ref, pendingPtr->oa, pendingPtr->numParts, pendingPtr->maxNum);
+
+    le_dls_Remove(&PendingMsgList, &pendingPtr->link);
+
+    for (i = 0; i < pendingPtr->maxNum; i++)
+    {
+        if (pendingPtr->partPtr[i])
+        {
+            DeliverPart(pendingPtr->oa, pendingPtr->format, pendingPtr->partPtr[i]);
+            le_mem_Release(pendingPtr->partPtr[i]);
+        }
+    }
+
+    le_mem_Release(pendingPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a pending message whose parts are all received, and deliver the reassembled message.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReassembleMsg
+(
+    PendingMsg_t* pendingPtr
+)
+{
+    uint32_t dataLen = 0;
+    int i;
+
+    for (i = 0; i < pendingPtr->maxNum; i++)
+    {
+        dataLen += pendingPtr->partPtr[i]->dataLen;
+    }
+
+    if (dataLen > GetMaxDataLen(pendingPtr->format))
+    {
+        LE_WARN("Message %u from %s too long (%u bytes)", pendingPtr->ref, pendingPtr->oa, dataLen);
+        EvictMsg(pendingPtr);
+        return;
+    }
+
+    le_dls_Remove(&PendingMsgList, &pendingPtr->link);
+
+    smsConcat_Msg_t* msgPtr = le_mem_ForceAlloc(MsgPool);
+
+    memcpy(msgPtr->oa, pendingPtr->oa, sizeof(msgPtr->oa));
+    memcpy(msgPtr->scts, pendingPtr->partPtr[0]->scts, sizeof(msgPtr->scts));
+    msgPtr->format = pendingPtr->format;
+    msgPtr->numParts = pendingPtr->maxNum;
+    msgPtr->dataLen = 0;
+
+    for (i = 0; i < pendingPtr->maxNum; i++)
+    {
+        Part_t* partPtr = pendingPtr->partPtr[i];
+
+        msgPtr->part[i] = partPtr->storage;
+        memcpy(msgPtr->data + msgPtr->dataLen, partPtr->data, partPtr->dataLen);
+        msgPtr->dataLen += partPtr->dataLen;
+        le_mem_Release(partPtr);
+    }
+    msgPtr->data[msgPtr->dataLen] = '\0';
+
+    LE_DEBUG("Message %u from %s reassembled: %u parts, %u bytes",
+             pendingPtr->ref, pendingPtr->oa, msgPtr->numParts, msgPtr->dataLen);
+
+    le_mem_Release(pendingPtr);
+
+    MsgHandlerPtr(msgPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Arm the eviction timer for the expiry time of the least recently updated message.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ArmEvictionTimer
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&PendingMsgList);
+    bool running = le_timer_IsRunning(EvictionTimer);
+
+    if (NULL == linkPtr)
+    {
+        if (running)
+        {
+            le_timer_Stop(EvictionTimer);
+        }
+        return;
+    }
+
+    PendingMsg_t* pendingPtr = CONTAINER_OF(linkPtr, PendingMsg_t, link);
+
+    // Most of the time, a new part doesn't change the head of the list
+    if (running && le_clk_Equal(pendingPtr->expiryTime, ArmedExpiryTime))
+    {
+        return;
+    }
+
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    le_clk_Time_t interval = { .sec = 0, .usec = 1000 };
+
+    if (le_clk_GreaterThan(pendingPtr->expiryTime, le_clk_Add(now, interval)))
+    {
+        interval = le_clk_Sub(pendingPtr->expiryTime, now);
+    }
+
+    if (running)
+    {
+        le_timer_Stop(EvictionTimer);
+    }
+    le_timer_SetInterval(EvictionTimer, interval);
+    le_timer_Start(EvictionTimer);
+    ArmedExpiryTime = pendingPtr->expiryTime;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Eviction timer handler: evict the messages whose missing parts are not received in time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EvictionTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    le_dls_Link_t* linkPtr;
+
+    while (NULL != (linkPtr = le_dls_Peek(&PendingMsgList)))
+    {
+        PendingMsg_t* pendingPtr = CONTAINER_OF(linkPtr, PendingMsg_t, link);
+
+        if (le_clk_GreaterThan(pendingPtr->expiryTime, now))
+        {
+            break;
+        }
+
+        EvictMsg(pendingPtr);
+    }
+
+    ArmEvictionTimer();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the pending message a part belongs to.
+ *
+ * @return The pending message, or NULL if not found
+ */
+//--------------------------------------------------------------------------------------------------
+static PendingMsg_t* FindPendingMsg
+(
+    const pa_sms_SmsDeliver_t* smsPtr   ///< [IN] Decoded part
+)
+{
+    // Search from the most recently updated message, which is the most likely
+    le_dls_Link_t* linkPtr = le_dls_PeekTail(&PendingMsgList);
+
+    while (linkPtr)
+    {
+        PendingMsg_t* pendingPtr = CONTAINER_OF(linkPtr, PendingMsg_t, link);
+
+        if (   (pendingPtr->ref == smsPtr->concat.ref)
+            && (pendingPtr->ref16Bits == smsPtr->concat.ref16Bits)
+            && (pendingPtr->maxNum == smsPtr->concat.maxNum)
+            && (pendingPtr->format == smsPtr->format)
+            && (0 == strcmp(pendingPtr->oa, smsPtr->oa)))
+        {
+            return pendingPtr;
+        }
+
+        linkPtr = le_dls_PeekPrev(&PendingMsgList, linkPtr);
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a part or a pending message, evicting the least recently updated messages if needed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* AllocPendingObject
+(
+    le_mem_PoolRef_t pool
+)
+{
+    void* objPtr;
+
+    while (NULL == (objPtr = le_mem_TryAlloc(pool)))
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&PendingMsgList);
+
+        LE_FATAL_IF(NULL == linkPtr, "No pending message to evict");
+        EvictMsg(CONTAINER_OF(linkPtr, PendingMsg_t, link));
+    }
+
+    return objPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the reassembly of concatenated messages.
+ */
+//--------------------------------------------------------------------------------------------------
+void smsConcat_Init
+(
+    uint32_t                   timeout,     ///< [IN] Time to wait for missing parts, in seconds
+    smsConcat_MsgHandlerFunc_t handlerPtr   ///< [IN] Handler delivering the messages
+)
+{
+    PendingMsgPool = le_mem_CreatePool("SmsConcatPendingPool", sizeof(PendingMsg_t));
+    le_mem_ExpandPool(PendingMsgPool, SMSCONCAT_MAX_PENDING_MSGS);
+
+    PartPool = le_mem_CreatePool("SmsConcatPartPool", sizeof(Part_t));
+    le_mem_ExpandPool(PartPool, SMSCONCAT_MAX_PENDING_PARTS);
+
+    MsgPool = le_mem_CreatePool("SmsConcatMsgPool", sizeof(smsConcat_Msg_t));
+
+    EvictionTimer = le_timer_Create("SmsConcatEviction");
+    le_timer_SetHandler(EvictionTimer, EvictionTimerHandler);
+
+    Timeout.sec = timeout;
+    Timeout.usec = 0;
+    MsgHandlerPtr = handlerPtr;
+
+    LE_DEBUG("Concatenated messages reassembly timeout %u s", timeout);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a received part of a concatenated message (PA_SMS_OPTIONMASK_CONCAT option set).
+ *
+ * The message is delivered when its last missing part is added. Parts of messages which can't be
+ * reassembled are delivered immediately.
+ */
+//--------------------------------------------------------------------------------------------------
+void smsConcat_AddPart
+(
+    const pa_sms_SmsDeliver_t* partPtr,     ///< [IN] Decoded part
+    pa_sms_Storage_t           storage,     ///< [IN] SMS storage location
+    uint32_t                   storageIdx   ///< [IN] SMS index in storage
+)
+{
+    const pa_sms_Concat_t* concatPtr = &partPtr->concat;
+
+    LE_DEBUG("Part %u/%u of message %u from %s",
+             concatPtr->seqNum, concatPtr->maxNum, concatPtr->ref, partPtr->oa);
+
+    if (   (concatPtr->maxNum > LE_SMS_CONCAT_MAX_PARTS)
+        || (concatPtr->seqNum < 1) || (concatPtr->seqNum > concatPtr->maxNum)
+        || (0 == GetMaxDataLen(partPtr->format)))
+    {
+        Part_t part;
+
+        LE_WARN("Part %u/%u of message %u can't be reassembled",
+                concatPtr->seqNum, concatPtr->maxNum, concatPtr->ref);
+        SetPart(&part, partPtr, storage, storageIdx);
+        DeliverPart(partPtr->oa, partPtr->format, &part);
+        return;
+    }
+
+    PendingMsg_t* pendingPtr = FindPendingMsg(partPtr);
+
+    // A part received twice starts a new message: the reference was reused by the sender
+    if (pendingPtr && pendingPtr->partPtr[concatPtr->seqNum - 1])
+    {
+        LE_WARN("Part %u of message %u received twice", concatPtr->seqNum, concatPtr->ref);
+        EvictMsg(pendingPtr);
+        pendingPtr = NULL;
+    }
+
+    Part_t* newPartPtr;
+
+    if (pendingPtr)
+    {
+        // Take the message out of the list so that freeing a part doesn't evict it
+        le_dls_Remove(&PendingMsgList, &pendingPtr->link);
+        newPartPtr = AllocPendingObject(PartPool);
+        le_dls_Queue(&PendingMsgList, &pendingPtr->link);
+    }
+    else
+    {
+        newPartPtr = AllocPendingObject(PartPool);
+
+        pendingPtr = AllocPendingObject(PendingMsgPool);
+        memset(pendingPtr, 0, sizeof(PendingMsg_t));
+        memcpy(pendingPtr->oa, partPtr->oa, sizeof(pendingPtr->oa));
+        pendingPtr->ref = concatPtr->ref;
+        pendingPtr->ref16Bits = concatPtr->ref16Bits;
+        pendingPtr->maxNum = concatPtr->maxNum;
+        pendingPtr->format = partPtr->format;
+        pendingPtr->link = LE_DLS_LINK_INIT;
+        le_dls_Queue(&PendingMsgList, &pendingPtr->link);
+    }
+
+    SetPart(newPartPtr, partPtr, storage, storageIdx);
+    pendingPtr->partPtr[concatPtr->seqNum - 1] = newPartPtr;
+    pendingPtr->numParts++;
+
+    if (pendingPtr->numParts == pendingPtr->maxNum)
+    {
+        ReassembleMsg(pendingPtr);
+    }
+    else
+    {
+        // The message is now the most recently updated one
+        pendingPtr->expiryTime = le_clk_Add(le_clk_GetRelativeTime(), Timeout);
+        le_dls_Remove(&PendingMsgList, &pendingPtr->link);
+        le_dls_Queue(&PendingMsgList, &pendingPtr->link);
+    }
+
+    ArmEvictionTimer();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deliver one by one all the pending parts.
+ */
+//--------------------------------------------------------------------------------------------------
+void smsConcat_Flush
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    while (NULL != (linkPtr = le_dls_Peek(&PendingMsgList)))
+    {
+        EvictMsg(CONTAINER_OF(linkPtr, PendingMsg_t, link));
+    }
+
+    ArmEvictionTimer();
+}
@@ -0,0 +1,121 @@
+/** @file smsConcat.h
+ *
+ * Reassembly of concatenated SMS messages.
+ *
+ * The parts of a concatenated message are identified by their originating address, their
+ * reference number (8 or 16 bits), the number of parts and the user data format. Pending parts
+ * are kept in a table of bounded size until all the parts of the message are received. When the
+ * missing parts are not received within a timeout, or when the table is full, the oldest pending
+ * message is evicted and its received parts are delivered one by one.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "pa_sms.h"
+
+#ifndef SMSCONCAT_H_
+#define SMSCONCAT_H_
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of messages with pending parts.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SMSCONCAT_MAX_PENDING_MSGS      16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of pending parts, all messages included.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SMSCONCAT_MAX_PENDING_PARTS     64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default time to wait for the missing parts of a message, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SMSCONCAT_DEFAULT_TIMEOUT       120
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Storage location of a part.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pa_sms_Storage_t storage;       ///< SMS storage location
+    uint32_t         storageIdx;    ///< SMS index in storage
+}
+smsConcat_PartStorage_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delivered message: either a reassembled message, or a single part of a message which couldn't
+ * be reassembled.
+ *
+ * Objects of this type are allocated from a memory pool: the receiver releases them with
+ * le_mem_Release().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char                    oa[LE_MDMDEFS_PHONE_NUM_MAX_BYTES]; ///< Originating address
+    char                    scts[LE_SMS_TIMESTAMP_MAX_BYTES];   ///< Time stamp of the first part
+    le_sms_Format_t         format;                             ///< User data format
+    uint8_t                 numParts;                           ///< Number of parts
+    smsConcat_PartStorage_t part[LE_SMS_CONCAT_MAX_PARTS];      ///< Storage of the parts
+    uint32_t                dataLen;                            ///< User data length
+    uint8_t                 data[LE_SMS_CONCAT_TEXT_MAX_BYTES]; ///< User data, null-terminated
+                                                                ///< in text format
+}
+smsConcat_Msg_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype of the handler called to deliver a message.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*smsConcat_MsgHandlerFunc_t)
+(
+    smsConcat_Msg_t* msgPtr     ///< [IN] Delivered message, to release with le_mem_Release()
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the reassembly of concatenated messages.
+ */
+//--------------------------------------------------------------------------------------------------
+void smsConcat_Init
+(
+    uint32_t                   timeout,     ///< [IN] Time to wait for missing parts, in seconds
+    smsConcat_MsgHandlerFunc_t handlerPtr   ///< [IN] Handler delivering the messages
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a received part of a concatenated message (PA_SMS_OPTIONMASK_CONCAT option set).
+ *
+ * The message is delivered when its last missing part is added. Parts of messages which can't be
+ * reassembled are delivered immediately.
+ */
+//--------------------------------------------------------------------------------------------------
+void smsConcat_AddPart
+(
+    const pa_sms_SmsDeliver_t* partPtr,     ///< [IN] Decoded part
+    pa_sms_Storage_t           storage,     ///< [IN] SMS storage location
+    uint32_t                   storageIdx   ///< [IN] SMS index in storage
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deliver one by one all the pending parts.
+ */
+//--------------------------------------------------------------------------------------------------
+void smsConcat_Flush
+(
+    void
+);
+
+#endif // SMSCONCAT_H_
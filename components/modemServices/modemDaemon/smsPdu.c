@@ -9,6 +9,7 @@
 #include "legato.h"
 #include "smsPdu.h"
 #include "cdmaPdu.h"
+#include "sms7Bits.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -25,9 +26,12 @@ static le_log_TraceRef_t TraceRef;
 #define IS_TRACE_ENABLED LE_IS_TRACE_ENABLED(TraceRef)
 
 
-/* Define Non-Printable Characters as a question mark */
-#define NPC7    63
-#define NPC8    '?'
+/* Maximum number of septets of a text: TP-UDL is one byte */
+#define MAX_SEPTETS 255
+
+/* Concatenated short messages information element identifiers (3GPP TS 23.040 9.2.3.24) */
+#define SMSPDU_IEI_CONCAT_8BITS_REF     0x00
+#define SMSPDU_IEI_CONCAT_16BITS_REF    0x08
 
 #ifndef min
 # define min(a, b) ((a)<(b) ? (a) : (b))
@@ -98,436 +102,6 @@ static const char *DtmfChars = "D1234567890*#ABC";
 #define TYPE_OF_ADDRESS_UNKNOWN         0x81
 #define TYPE_OF_ADDRESS_INTERNATIONAL   0x91
 
-/****************************************************************************
- * This lookup table converts from ISO-8859-1 8-bit ASCII to the
- * 7 bit "default alphabet" as defined in ETSI GSM 03.38
- *
- * ISO-characters that don't have any corresponding character in the
- * 7-bit alphabet is replaced with the NPC7-character.  If there's
- * a close match between the ISO-char and a 7-bit character (for example
- * the letter i with a circumflex and the plain i-character) a substitution
- * is done.
- *
- * There are some character (for example the square brace "]") that must
- * be converted into a 2 byte 7-bit sequence.  These characters are
- * marked in the table by having 128 added to its value.
- ****************************************************************************/
-const uint8_t Ascii8to7[] = {
-    NPC7,       /*     0      null [NUL]                              */
-    NPC7,       /*     1      start of heading [SOH]                  */
-    NPC7,       /*     2      start of text [STX]                     */
-    NPC7,       /*     3      end of text [ETX]                       */
-    NPC7,       /*     4      end of transmission [EOT]               */
-    NPC7,       /*     5      enquiry [ENQ]                           */
-    NPC7,       /*     6      acknowledge [ACK]                       */
-    NPC7,       /*     7      bell [BEL]                              */
-    NPC7,       /*     8      backspace [BS]                          */
-    NPC7,       /*     9      horizontal tab [HT]                     */
-    10,         /*    10      line feed [LF]                          */
-    NPC7,       /*    11      vertical tab [VT]                       */
-    10+128,     /*    12      form feed [FF]                          */
-    13,         /*    13      carriage return [CR]                    */
-    NPC7,       /*    14      shift out [SO]                          */
-    NPC7,       /*    15      shift in [SI]                           */
-    NPC7,       /*    16      data link escape [DLE]                  */
-    NPC7,       /*    17      device control 1 [DC1]                  */
-    NPC7,       /*    18      device control 2 [DC2]                  */
-    NPC7,       /*    19      device control 3 [DC3]                  */
-    NPC7,       /*    20      device control 4 [DC4]                  */
-    NPC7,       /*    21      negative acknowledge [NAK]              */
-    NPC7,       /*    22      synchronous idle [SYN]                  */
-    NPC7,       /*    23      end of trans. block [ETB]               */
-    NPC7,       /*    24      cancel [CAN]                            */
-    NPC7,       /*    25      end of medium [EM]                      */
-    NPC7,       /*    26      substitute [SUB]                        */
-    NPC7,       /*    27      escape [ESC]                            */
-    NPC7,       /*    28      file separator [FS]                     */
-    NPC7,       /*    29      group separator [GS]                    */
-    NPC7,       /*    30      record separator [RS]                   */
-    NPC7,       /*    31      unit separator [US]                     */
-    32,         /*    32      space                                   */
-    33,         /*    33    ! exclamation mark                        */
-    34,         /*    34    " double quotation mark                   */
-    35,         /*    35    # number sign                             */
-    2,          /*    36    $ dollar sign                             */
-    37,         /*    37    % percent sign                            */
-    38,         /*    38    & ampersand                               */
-    39,         /*    39    ' apostrophe                              */
-    40,         /*    40    ( left parenthesis                        */
-    41,         /*    41    ) right parenthesis                       */
-    42,         /*    42    * asterisk                                */
-    43,         /*    43    + plus sign                               */
-    44,         /*    44    , comma                                   */
-    45,         /*    45    - hyphen                                  */
-    46,         /*    46    . period                                  */
-    47,         /*    47    / slash,                                  */
-    48,         /*    48    0 digit 0                                 */
-    49,         /*    49    1 digit 1                                 */
-    50,         /*    50    2 digit 2                                 */
-    51,         /*    51    3 digit 3                                 */
-    52,         /*    52    4 digit 4                                 */
-    53,         /*    53    5 digit 5                                 */
-    54,         /*    54    6 digit 6                                 */
-    55,         /*    55    7 digit 7                                 */
-    56,         /*    56    8 digit 8                                 */
-    57,         /*    57    9 digit 9                                 */
-    58,         /*    58    : colon                                   */
-    59,         /*    59    ; semicolon                               */
-    60,         /*    60    < less-than sign                          */
-    61,         /*    61    = equal sign                              */
-    62,         /*    62    > greater-than sign                       */
-    63,         /*    63    ? question mark                           */
-    0,          /*    64    @ commercial at sign                      */
-    65,         /*    65    A uppercase A                             */
-    66,         /*    66    B uppercase B                             */
-    67,         /*    67    C uppercase C                             */
-    68,         /*    68    D uppercase D                             */
-    69,         /*    69    E uppercase E                             */
-    70,         /*    70    F uppercase F                             */
-    71,         /*    71    G uppercase G                             */
-    72,         /*    72    H uppercase H                             */
-    73,         /*    73    I uppercase I                             */
-    74,         /*    74    J uppercase J                             */
-    75,         /*    75    K uppercase K                             */
-    76,         /*    76    L uppercase L                             */
-    77,         /*    77    M uppercase M                             */
-    78,         /*    78    N uppercase N                             */
-    79,         /*    79    O uppercase O                             */
-    80,         /*    80    P uppercase P                             */
-    81,         /*    81    Q uppercase Q                             */
-    82,         /*    82    R uppercase R                             */
-    83,         /*    83    S uppercase S                             */
-    84,         /*    84    T uppercase T                             */
-    85,         /*    85    U uppercase U                             */
-    86,         /*    86    V uppercase V                             */
-    87,         /*    87    W uppercase W                             */
-    88,         /*    88    X uppercase X                             */
-    89,         /*    89    Y uppercase Y                             */
-    90,         /*    90    Z uppercase Z                             */
-    60+128,     /*    91    [ left square bracket                     */
-    47+128,     /*    92    \ backslash                               */
-    62+128,     /*    93    ] right square bracket                    */
-    20+128,     /*    94    ^ circumflex accent                       */
-    17,         /*    95    _ underscore                              */
-    -39,        /*    96    ` back apostrophe                         */
-    97,         /*    97    a lowercase a                             */
-    98,         /*    98    b lowercase b                             */
-    99,         /*    99    c lowercase c                             */
-    100,        /*   100    d lowercase d                             */
-    101,        /*   101    e lowercase e                             */
-    102,        /*   102    f lowercase f                             */
-    103,        /*   103    g lowercase g                             */
-    104,        /*   104    h lowercase h                             */
-    105,        /*   105    i lowercase i                             */
-    106,        /*   106    j lowercase j                             */
-    107,        /*   107    k lowercase k                             */
-    108,        /*   108    l lowercase l                             */
-    109,        /*   109    m lowercase m                             */
-    110,        /*   110    n lowercase n                             */
-    111,        /*   111    o lowercase o                             */
-    112,        /*   112    p lowercase p                             */
-    113,        /*   113    q lowercase q                             */
-    114,        /*   114    r lowercase r                             */
-    115,        /*   115    s lowercase s                             */
-    116,        /*   116    t lowercase t                             */
-    117,        /*   117    u lowercase u                             */
-    118,        /*   118    v lowercase v                             */
-    119,        /*   119    w lowercase w                             */
-    120,        /*   120    x lowercase x                             */
-    121,        /*   121    y lowercase y                             */
-    122,        /*   122    z lowercase z                             */
-    40+128,     /*   123    { left brace                              */
-    64+128,     /*   124    | vertical bar                            */
-    41+128,     /*   125    } right brace                             */
-    61+128,     /*   126    ~ tilde accent                            */
-    NPC7,       /*   127      delete [DEL]                            */
-    NPC7,       /*   128                                              */
-    NPC7,       /*   129                                              */
-    39,         /*   130      low left rising single quote            */
-    102,        /*   131      lowercase italic f                      */
-    34,         /*   132      low left rising double quote            */
-    NPC7,       /*   133      low horizontal ellipsis                 */
-    NPC7,       /*   134      dagger mark                             */
-    NPC7,       /*   135      double dagger mark                      */
-    NPC7,       /*   136      letter modifying circumflex             */
-    NPC7,       /*   137      per thousand (mille) sign               */
-    83,         /*   138      uppercase S caron or hacek              */
-    39,         /*   139      left single angle quote mark            */
-    214,        /*   140      uppercase OE ligature                   */
-    NPC7,       /*   141                                              */
-    NPC7,       /*   142                                              */
-    NPC7,       /*   143                                              */
-    NPC7,       /*   144                                              */
-    39,         /*   145      left single quotation mark              */
-    39,         /*   146      right single quote mark                 */
-    34,         /*   147      left double quotation mark              */
-    34,         /*   148      right double quote mark                 */
-    42,         /*   149      round filled bullet                     */
-    45,         /*   150      en dash                                 */
-    45,         /*   151      em dash                                 */
-    39,         /*   152      small spacing tilde accent              */
-    NPC7,       /*   153      trademark sign                          */
-    115,        /*   154      lowercase s caron or hacek              */
-    39,         /*   155      right single angle quote mark           */
-    111,        /*   156      lowercase oe ligature                   */
-    NPC7,       /*   157                                              */
-    NPC7,       /*   158                                              */
-    89,         /*   159      uppercase Y dieresis or umlaut          */
-    32,         /*   160      non-breaking space                      */
-    64,         /*   161    ¡ inverted exclamation mark               */
-    99,         /*   162    ¢ cent sign                               */
-    1,          /*   163    £ pound sterling sign                     */
-    36,         /*   164    € general currency sign                   */
-    3,          /*   165    ¥ yen sign                                */
-    33,         /*   166    Š broken vertical bar                     */
-    95,         /*   167    § section sign                            */
-    34,         /*   168    š spacing dieresis or umlaut              */
-    NPC7,       /*   169    © copyright sign                          */
-    NPC7,       /*   170    ª feminine ordinal indicator              */
-    60,         /*   171    « left (double) angle quote               */
-    NPC7,       /*   172    ¬ logical not sign                        */
-    45,         /*   173    ­ soft hyphen                             */
-    NPC7,       /*   174    ® registered trademark sign               */
-    NPC7,       /*   175    ¯ spacing macron (long) accent            */
-    NPC7,       /*   176    ° degree sign                             */
-    NPC7,       /*   177    ± plus-or-minus sign                      */
-    50,         /*   178    ² superscript 2                           */
-    51,         /*   179    ³ superscript 3                           */
-    39,         /*   180    Ž spacing acute accent                    */
-    117,        /*   181    µ micro sign                              */
-    NPC7,       /*   182    ¶ paragraph sign, pilcrow sign            */
-    NPC7,       /*   183    · middle dot, centered dot                */
-    NPC7,       /*   184    ž spacing cedilla                         */
-    49,         /*   185    ¹ superscript 1                           */
-    NPC7,       /*   186    º masculine ordinal indicator             */
-    62,         /*   187    » right (double) angle quote (guillemet)  */
-    NPC7,       /*   188    Œ fraction 1/4                            */
-    NPC7,       /*   189    œ fraction 1/2                            */
-    NPC7,       /*   190    Ÿ fraction 3/4                            */
-    96,         /*   191    ¿ inverted question mark                  */
-    65,         /*   192    À uppercase A grave                       */
-    65,         /*   193    Á uppercase A acute                       */
-    65,         /*   194    Â uppercase A circumflex                  */
-    65,         /*   195    Ã uppercase A tilde                       */
-    91,         /*   196    Ä uppercase A dieresis or umlaut          */
-    14,         /*   197    Å uppercase A ring                        */
-    28,         /*   198    Æ uppercase AE ligature                   */
-    9,          /*   199    Ç uppercase C cedilla                     */
-    31,         /*   200    È uppercase E grave                       */
-    31,         /*   201    É uppercase E acute                       */
-    31,         /*   202    Ê uppercase E circumflex                  */
-    31,         /*   203    Ë uppercase E dieresis or umlaut          */
-    73,         /*   204    Ì uppercase I grave                       */
-    73,         /*   205    Í uppercase I acute                       */
-    73,         /*   206    Î uppercase I circumflex                  */
-    73,         /*   207    Ï uppercase I dieresis or umlaut          */
-    68,         /*   208    Ð uppercase ETH                           */
-    93,         /*   209    Ñ uppercase N tilde                       */
-    79,         /*   210    Ò uppercase O grave                       */
-    79,         /*   211    Ó uppercase O acute                       */
-    79,         /*   212    Ô uppercase O circumflex                  */
-    79,         /*   213    Õ uppercase O tilde                       */
-    92,         /*   214    Ö uppercase O dieresis or umlaut          */
-    42,         /*   215    × multiplication sign                     */
-    11,         /*   216    Ø uppercase O slash                       */
-    85,         /*   217    Ù uppercase U grave                       */
-    85,         /*   218    Ú uppercase U acute                       */
-    85,         /*   219    Û uppercase U circumflex                  */
-    94,         /*   220    Ü uppercase U dieresis or umlaut          */
-    89,         /*   221    Ý uppercase Y acute                       */
-    NPC7,       /*   222    Þ uppercase THORN                         */
-    30,         /*   223    ß lowercase sharp s, sz ligature          */
-    127,        /*   224    à lowercase a grave                       */
-    97,         /*   225    á lowercase a acute                       */
-    97,         /*   226    â lowercase a circumflex                  */
-    97,         /*   227    ã lowercase a tilde                       */
-    123,        /*   228    ä lowercase a dieresis or umlaut          */
-    15,         /*   229    å lowercase a ring                        */
-    29,         /*   230    æ lowercase ae ligature                   */
-    9,          /*   231    ç lowercase c cedilla                     */
-    4,          /*   232    è lowercase e grave                       */
-    5,          /*   233    é lowercase e acute                       */
-    101,        /*   234    ê lowercase e circumflex                  */
-    101,        /*   235    ë lowercase e dieresis or umlaut          */
-    7,          /*   236    ì lowercase i grave                       */
-    7,          /*   237    í lowercase i acute                       */
-    105,        /*   238    î lowercase i circumflex                  */
-    105,        /*   239    ï lowercase i dieresis or umlaut          */
-    NPC7,       /*   240    ð lowercase eth                           */
-    125,        /*   241    ñ lowercase n tilde                       */
-    8,          /*   242    ò lowercase o grave                       */
-    111,        /*   243    ó lowercase o acute                       */
-    111,        /*   244    ô lowercase o circumflex                  */
-    111,        /*   245    õ lowercase o tilde                       */
-    24,         /*   246    ö lowercase o dieresis or umlaut          */
-    47,         /*   247    ÷ division sign                           */
-    12,         /*   248    ø lowercase o slash                       */
-    6,          /*   249    ù lowercase u grave                       */
-    117,        /*   250    ú lowercase u acute                       */
-    117,        /*   251    û lowercase u circumflex                  */
-    126,        /*   252    ü lowercase u dieresis or umlaut          */
-    121,        /*   253    ý lowercase y acute                       */
-    NPC7,       /*   254    þ lowercase thorn                         */
-    121         /*   255    ÿ lowercase y dieresis or umlaut          */
-};
-
-
-
-/****************************************************************************
- *  This lookup table converts from the 7 bit "default alphabet" as
- *   defined in ETSI GSM 03.38 to a standard ISO-8859-1 8-bit ASCII.
- *
- *   Some characters in the 7-bit alphabet does not exist in the ISO
- *   character set, they are replaced by the NPC8-character.
- *
- *   If the character is decimal 27 (ESC) the following character have
- *   a special meaning and must be handled separately.
- ****************************************************************************/
-const uint8_t Ascii7to8[] = {
-    64,         /*  0      @  COMMERCIAL AT                           */
-    163,        /*  1      £  POUND SIGN                              */
-    36,         /*  2      $  DOLLAR SIGN                             */
-    165,        /*  3      ¥  YEN SIGN                                */
-    232,        /*  4      è  LATIN SMALL LETTER E WITH GRAVE         */
-    233,        /*  5      é  LATIN SMALL LETTER E WITH ACUTE         */
-    249,        /*  6      ù  LATIN SMALL LETTER U WITH GRAVE         */
-    236,        /*  7      ì  LATIN SMALL LETTER I WITH GRAVE         */
-    242,        /*  8      ò  LATIN SMALL LETTER O WITH GRAVE         */
-    199,        /*  9      Ç  LATIN CAPITAL LETTER C WITH CEDILLA     */
-    10,         /*  10        LINE FEED                               */
-    216,        /*  11     Ø  LATIN CAPITAL LETTER O WITH STROKE      */
-    248,        /*  12     ø  LATIN SMALL LETTER O WITH STROKE        */
-    13,         /*  13        CARRIAGE RETURN                         */
-    197,        /*  14     Å  LATIN CAPITAL LETTER A WITH RING ABOVE  */
-    229,        /*  15     å  LATIN SMALL LETTER A WITH RING ABOVE    */
-    NPC8,       /*  16        GREEK CAPITAL LETTER DELTA              */
-    95,         /*  17     _  LOW LINE                                */
-    NPC8,       /*  18        GREEK CAPITAL LETTER PHI                */
-    NPC8,       /*  19        GREEK CAPITAL LETTER GAMMA              */
-    NPC8,       /*  20        GREEK CAPITAL LETTER LAMBDA             */
-    NPC8,       /*  21        GREEK CAPITAL LETTER OMEGA              */
-    NPC8,       /*  22        GREEK CAPITAL LETTER PI                 */
-    NPC8,       /*  23        GREEK CAPITAL LETTER PSI                */
-    NPC8,       /*  24        GREEK CAPITAL LETTER SIGMA              */
-    NPC8,       /*  25        GREEK CAPITAL LETTER THETA              */
-    NPC8,       /*  26        GREEK CAPITAL LETTER XI                 */
-    27,         /*  27        ESCAPE TO EXTENSION TABLE               */
-    198,        /*  28     Æ  LATIN CAPITAL LETTER AE                 */
-    230,        /*  29     æ  LATIN SMALL LETTER AE                   */
-    223,        /*  30     ß  LATIN SMALL LETTER SHARP S (German)     */
-    201,        /*  31     É  LATIN CAPITAL LETTER E WITH ACUTE       */
-    32,         /*  32        SPACE                                   */
-    33,         /*  33     !  EXCLAMATION MARK                        */
-    34,         /*  34     "  QUOTATION MARK                          */
-    35,         /*  35     #  NUMBER SIGN                             */
-    164,        /*  36     €  CURRENCY SIGN                           */
-    37,         /*  37     %  PERCENT SIGN                            */
-    38,         /*  38     &  AMPERSAND                               */
-    39,         /*  39     '  APOSTROPHE                              */
-    40,         /*  40     (  LEFT PARENTHESIS                        */
-    41,         /*  41     )  RIGHT PARENTHESIS                       */
-    42,         /*  42     *  ASTERISK                                */
-    43,         /*  43     +  PLUS SIGN                               */
-    44,         /*  44     ,  COMMA                                   */
-    45,         /*  45     -  HYPHEN-MINUS                            */
-    46,         /*  46     .  FULL STOP                               */
-    47,         /*  47     /  SOLIDUS (SLASH)                         */
-    48,         /*  48     0  DIGIT ZERO                              */
-    49,         /*  49     1  DIGIT ONE                               */
-    50,         /*  50     2  DIGIT TWO                               */
-    51,         /*  51     3  DIGIT THREE                             */
-    52,         /*  52     4  DIGIT FOUR                              */
-    53,         /*  53     5  DIGIT FIVE                              */
-    54,         /*  54     6  DIGIT SIX                               */
-    55,         /*  55     7  DIGIT SEVEN                             */
-    56,         /*  56     8  DIGIT EIGHT                             */
-    57,         /*  57     9  DIGIT NINE                              */
-    58,         /*  58     :  COLON                                   */
-    59,         /*  59     ;  SEMICOLON                               */
-    60,         /*  60     <  LESS-THAN SIGN                          */
-    61,         /*  61     =  EQUALS SIGN                             */
-    62,         /*  62     >  GREATER-THAN SIGN                       */
-    63,         /*  63     ?  QUESTION MARK                           */
-    161,        /*  64     ¡  INVERTED EXCLAMATION MARK               */
-    65,         /*  65     A  LATIN CAPITAL LETTER A                  */
-    66,         /*  66     B  LATIN CAPITAL LETTER B                  */
-    67,         /*  67     C  LATIN CAPITAL LETTER C                  */
-    68,         /*  68     D  LATIN CAPITAL LETTER D                  */
-    69,         /*  69     E  LATIN CAPITAL LETTER E                  */
-    70,         /*  70     F  LATIN CAPITAL LETTER F                  */
-    71,         /*  71     G  LATIN CAPITAL LETTER G                  */
-    72,         /*  72     H  LATIN CAPITAL LETTER H                  */
-    73,         /*  73     I  LATIN CAPITAL LETTER I                  */
-    74,         /*  74     J  LATIN CAPITAL LETTER J                  */
-    75,         /*  75     K  LATIN CAPITAL LETTER K                  */
-    76,         /*  76     L  LATIN CAPITAL LETTER L                  */
-    77,         /*  77     M  LATIN CAPITAL LETTER M                  */
-    78,         /*  78     N  LATIN CAPITAL LETTER N                  */
-    79,         /*  79     O  LATIN CAPITAL LETTER O                  */
-    80,         /*  80     P  LATIN CAPITAL LETTER P                  */
-    81,         /*  81     Q  LATIN CAPITAL LETTER Q                  */
-    82,         /*  82     R  LATIN CAPITAL LETTER R                  */
-    83,         /*  83     S  LATIN CAPITAL LETTER S                  */
-    84,         /*  84     T  LATIN CAPITAL LETTER T                  */
-    85,         /*  85     U  LATIN CAPITAL LETTER U                  */
-    86,         /*  86     V  LATIN CAPITAL LETTER V                  */
-    87,         /*  87     W  LATIN CAPITAL LETTER W                  */
-    88,         /*  88     X  LATIN CAPITAL LETTER X                  */
-    89,         /*  89     Y  LATIN CAPITAL LETTER Y                  */
-    90,         /*  90     Z  LATIN CAPITAL LETTER Z                  */
-    196,        /*  91     Ä  LATIN CAPITAL LETTER A WITH DIAERESIS   */
-    214,        /*  92     Ö  LATIN CAPITAL LETTER O WITH DIAERESIS   */
-    209,        /*  93     Ñ  LATIN CAPITAL LETTER N WITH TILDE       */
-    220,        /*  94     Ü  LATIN CAPITAL LETTER U WITH DIAERESIS   */
-    167,        /*  95     §  SECTION SIGN                            */
-    191,        /*  96     ¿  INVERTED QUESTION MARK                  */
-    97,         /*  97     a  LATIN SMALL LETTER A                    */
-    98,         /*  98     b  LATIN SMALL LETTER B                    */
-    99,         /*  99     c  LATIN SMALL LETTER C                    */
-    100,        /*  100    d  LATIN SMALL LETTER D                    */
-    101,        /*  101    e  LATIN SMALL LETTER E                    */
-    102,        /*  102    f  LATIN SMALL LETTER F                    */
-    103,        /*  103    g  LATIN SMALL LETTER G                    */
-    104,        /*  104    h  LATIN SMALL LETTER H                    */
-    105,        /*  105    i  LATIN SMALL LETTER I                    */
-    106,        /*  106    j  LATIN SMALL LETTER J                    */
-    107,        /*  107    k  LATIN SMALL LETTER K                    */
-    108,        /*  108    l  LATIN SMALL LETTER L                    */
-    109,        /*  109    m  LATIN SMALL LETTER M                    */
-    110,        /*  110    n  LATIN SMALL LETTER N                    */
-    111,        /*  111    o  LATIN SMALL LETTER O                    */
-    112,        /*  112    p  LATIN SMALL LETTER P                    */
-    113,        /*  113    q  LATIN SMALL LETTER Q                    */
-    114,        /*  114    r  LATIN SMALL LETTER R                    */
-    115,        /*  115    s  LATIN SMALL LETTER S                    */
-    116,        /*  116    t  LATIN SMALL LETTER T                    */
-    117,        /*  117    u  LATIN SMALL LETTER U                    */
-    118,        /*  118    v  LATIN SMALL LETTER V                    */
-    119,        /*  119    w  LATIN SMALL LETTER W                    */
-    120,        /*  120    x  LATIN SMALL LETTER X                    */
-    121,        /*  121    y  LATIN SMALL LETTER Y                    */
-    122,        /*  122    z  LATIN SMALL LETTER Z                    */
-    228,        /*  123    ä  LATIN SMALL LETTER A WITH DIAERESIS     */
-    246,        /*  124    ö  LATIN SMALL LETTER O WITH DIAERESIS     */
-    241,        /*  125    ñ  LATIN SMALL LETTER N WITH TILDE         */
-    252,        /*  126    ü  LATIN SMALL LETTER U WITH DIAERESIS     */
-    224         /*  127    à  LATIN SMALL LETTER A WITH GRAVE         */
-
-    /*  The double bytes below must be handled separately after the
-     *   table lookup.
-     *
-     *   12             27 10      FORM FEED
-     *   94             27 20   ^  CIRCUMFLEX ACCENT
-     *   123            27 40   {  LEFT CURLY BRACKET
-     *   125            27 41   }  RIGHT CURLY BRACKET
-     *   92             27 47   \  REVERSE SOLIDUS (BACKSLASH)
-     *   91             27 60   [  LEFT SQUARE BRACKET
-     *   126            27 61   ~  TILDE
-     *   93             27 62   ]  RIGHT SQUARE BRACKET
-     *   124            27 64   |  VERTICAL BAR                             */
-
-};
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Dump the PDU
@@ -560,225 +134,65 @@ static void DumpPdu
 }
 
 
-static inline unsigned int Read7Bits
-(
-    const uint8_t* bufferPtr,
-    uint32_t       pos
-)
-{
-    int a = bufferPtr[pos/8] >> (pos&7);
-    int b = 0;
-    if ((pos&7) > 1) {
-        b = bufferPtr[(pos/8)+1] << (8-(pos&7));
-    }
-
-    return (a|b) & 0x7F;
-}
-
-static inline void Write7Bits
-(
-    uint8_t* bufferPtr,
-    uint8_t  val,
-    uint32_t pos
-)
-{
-    val &= 0x7F;
-    uint8_t idx = pos/8;
-
-
-    if (!(pos&7)) {
-        bufferPtr[idx] = val;
-    }
-    else if ((pos&7) == 1) {
-        bufferPtr[idx] = bufferPtr[idx] | (val<<1);
-    }
-    else {
-        bufferPtr[idx] = bufferPtr[idx] | (val<<(pos&7));
-        bufferPtr[idx+1] = (val>>(8-(pos&7)));
-    }
-}
-
-static inline unsigned int ReadCdma7Bits
-(
-    const uint8_t* bufferPtr,
-    uint32_t       pos
-)
-{
-    uint8_t idx = pos/8;
-
-    return (((bufferPtr[idx]<<(pos&7))&0xFF)|(bufferPtr[idx+1]>>(8-(pos&7))))>>1;
-}
-
-static inline void WriteCdma7Bits
-(
-    uint8_t* bufferPtr,
-    uint8_t  val,
-    uint32_t pos
-)
-{
-    val &= 0x7F;
-    uint8_t idx = pos/8;
-
-    if (!(pos&7)) {
-        bufferPtr[idx] = val << 1;
-    }
-    else if ((pos&7) == 1) {
-        bufferPtr[idx] = bufferPtr[idx] | val;
-    }
-    else {
-        bufferPtr[idx] = bufferPtr[idx] | (val>>((pos&7)-1));
-        bufferPtr[idx+1] = ((val<<(8-((pos&7)-1)))&0xff);
-    }
-}
-
 /**
  * Convert an ascii array into a 7bits array
  * length is the number of bytes in the ascii buffer
  *
- * @return the size of the a7bit string (in 7bit chars!), or LE_OVERFLOW if a7bitPtr is too small.
+ * @return the size of the a7bit string (in bytes), or LE_OVERFLOW if a7bitPtr is too small.
  */
 static int32_t Convert8BitsTo7Bits
 (
     const uint8_t *a8bitPtr,    ///< [IN] 8bits array to convert
-    int            pos,         ///< [IN] starting position of conversion
     int            length,      ///< [IN] size of 8bits byte conversion
     uint8_t       *a7bitPtr,    ///< [OUT] 7bits array result
     size_t         a7bitSize,   ///< [IN] 7bits array size
     uint8_t       *a7bitsNumber ///< [OUT] number of char in &7bitsPtr
 )
 {
-    int read;
-    int write = 0;
-    int size = 0;
-
-    for (read = pos; read < length+pos; ++read)
-    {
-        uint8_t byte = Ascii8to7[a8bitPtr[read]];
-
-        /* Escape */
-        if (byte >= 128)
-        {
-            if (size>a7bitSize)
-            {
-                return LE_OVERFLOW;
-            }
-
-            Write7Bits(a7bitPtr, 0x1B, write*7);
-            write++;
-            byte -= 128;
-        }
-
-        if (size>a7bitSize)
-        {
-            return LE_OVERFLOW;
-        }
-
-        Write7Bits(a7bitPtr, byte, write*7);
-        write++;
-
-        /* Number of 8 bit chars */
-        size = (write * 7);
-        size = (size % 8 != 0) ? (size/8 + 1) : (size/8);
-    }
+    uint8_t septets[MAX_SEPTETS];
+    int32_t numSeptets;
 
-    if (size>a7bitSize)
+    // At most a7bitSize*8/7 septets fit in a7bitPtr once packed.
+    numSeptets = sms7Bits_FromLatin1(a8bitPtr,
+                                     length,
+                                     septets,
+                                     min(sizeof(septets), (a7bitSize * 8) / 7));
+    if (numSeptets == LE_OVERFLOW)
     {
         return LE_OVERFLOW;
     }
 
     /* Number of written chars */
-    *a7bitsNumber = write;
+    *a7bitsNumber = numSeptets;
 
-    return size;
+    return sms7Bits_Pack(septets, numSeptets, a7bitPtr);
 }
 
 /**
  * Convert a 7bit array into a ascii array
- * length is the number of 7bit char in the a7bit buffer
+ * length is the number of 7bit char in the a7bit buffer, after the pos first ones which are skipped
  *
  * @return the size of the ascii array, of LE_OVERFLOW if a8bitPtr is too small.
  */
 static int32_t Convert7BitsTo8Bits
 (
     const uint8_t *a7bitPtr,     ///< [IN] 7bits array to convert
-    int            pos,          ///< [IN] starting position of conversion
+    int            pos,          ///< [IN] number of 7bits chars to skip
     int            length,       ///< [IN] size of 7bits byte conversion
     uint8_t       *a8bitPtr,     ///< [OUT] 8bits array restul
     size_t         a8bitSize     ///< [IN] 8bits array size.
 )
 {
-    int r;
-    int w;
+    uint8_t septets[MAX_SEPTETS];
 
-    w = 0;
-    for (r = pos; r < length+pos; r++)
+    if ((pos + length) > sizeof(septets))
     {
-        uint8_t byte = Read7Bits(a7bitPtr, r*7);
-        byte = Ascii7to8[byte];
-
-        if (byte != 27)
-        {
-            if (w < a8bitSize)
-            {
-                a8bitPtr[w] = byte;
-                w++;
-            }
-            else
-            {
-                return LE_OVERFLOW;
-            }
-        }
-        else
-        {
-            /* If we're escaped then the next byte have a special meaning. */
-            r++;
-
-            byte = Read7Bits(a7bitPtr, r*7);
-            if (w < a8bitSize)
-            {
-                switch (byte)
-                {
-                    case 10:
-                        a8bitPtr[w] = 12;
-                        break;
-                    case 20:
-                        a8bitPtr[w] = '^';
-                        break;
-                    case 40:
-                        a8bitPtr[w] = '{';
-                        break;
-                    case 41:
-                        a8bitPtr[w] = '}';
-                        break;
-                    case 47:
-                        a8bitPtr[w] = '\\';
-                        break;
-                    case 60:
-                        a8bitPtr[w] = '[';
-                        break;
-                    case 61:
-                        a8bitPtr[w] = '~';
-                        break;
-                    case 62:
-                        a8bitPtr[w] = ']';
-                        break;
-                    case 64:
-                        a8bitPtr[w] = '|';
-                        break;
-                    default:
-                        a8bitPtr[w] = NPC8;
-                        break;
-                }
-                w++;
-            }
-            else
-            {
-                return LE_OVERFLOW;
-            }
-        }
+        return LE_OVERFLOW;
     }
 
-    return w;
+    sms7Bits_Unpack(a7bitPtr, pos + length, septets);
+
+    return sms7Bits_ToLatin1(septets + pos, length, a8bitPtr, a8bitSize);
 }
 
 static inline uint8_t ReadByte
@@ -993,6 +407,70 @@ static smsPdu_Encoding_t DetermineEncoding
     return encoding;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode a user data header of a PDU (TP-UDH), looking for a concatenated short message
+ * information element (8 or 16 bits reference number).
+ * Defined in 3GPP TS 23.040 section 9.2.3.24.
+ *
+ * @return
+ *  - LE_OK            A valid concatenated short message information element is found
+ *  - LE_NOT_FOUND     The header doesn't contain any valid concatenation information
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DecodeUserDataHeader
+(
+    const uint8_t*   udhPtr,    ///< [IN] Information elements of the header
+    uint8_t          tpUdhl,    ///< [IN] TP User Data Header Length
+    pa_sms_Concat_t* concatPtr  ///< [OUT] Concatenation information
+)
+{
+    le_result_t result = LE_NOT_FOUND;
+    uint8_t pos = 0;
+
+    while ((pos + 2) <= tpUdhl)
+    {
+        uint8_t iei = ReadByte(udhPtr, pos);
+        uint8_t iedl = ReadByte(udhPtr, pos + 1);
+        const uint8_t* iedPtr = &udhPtr[pos + 2];
+
+        if ((pos + 2 + iedl) > tpUdhl)
+        {
+            LE_WARN("Truncated information element %u (%u bytes)", iei, iedl);
+            break;
+        }
+
+        // Information elements with an invalid sequence number are ignored (3GPP TS 23.040).
+        // If the element is repeated, the last occurrence is used.
+        if ((SMSPDU_IEI_CONCAT_8BITS_REF == iei) && (3 == iedl) &&
+            (iedPtr[2] >= 1) && (iedPtr[2] <= iedPtr[1]))
+        {
+            concatPtr->ref = iedPtr[0];
+            concatPtr->ref16Bits = false;
+            concatPtr->maxNum = iedPtr[1];
+            concatPtr->seqNum = iedPtr[2];
+            result = LE_OK;
+        }
+        else if ((SMSPDU_IEI_CONCAT_16BITS_REF == iei) && (4 == iedl) &&
+                 (iedPtr[3] >= 1) && (iedPtr[3] <= iedPtr[2]))
+        {
+            concatPtr->ref = (iedPtr[0] << 8) | iedPtr[1];
+            concatPtr->ref16Bits = true;
+            concatPtr->maxNum = iedPtr[2];
+            concatPtr->seqNum = iedPtr[3];
+            result = LE_OK;
+        }
+        else
+        {
+            LE_DEBUG("Information element %u (%u bytes) ignored", iei, iedl);
+        }
+
+        pos += 2 + iedl;
+    }
+
+    return result;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Decode a user data field of a PDU (TP-UD)
@@ -1001,10 +479,11 @@ static smsPdu_Encoding_t DetermineEncoding
 static le_result_t DecodeUserDataField
 (
     const uint8_t*    dataPtr,      ///< [IN] PDU data to decode
-    uint8_t*          posPtr,       ///< [INOUT] Position in PDU
+    uint8_t*          posPtr,       ///< [INOUT] Position in PDU, at the beginning of TP-UD
     smsPdu_Encoding_t encoding,     ///< [IN] Encoding
     uint8_t           tpUdl,        ///< [IN] TP User Data Length
-    uint8_t           tpUdhl,       ///< [IN] TP User Data Header Length
+    uint8_t           udhSize,      ///< [IN] Size of the TP User Data Header including its length
+                                    ///<      field, 0 if there is no header
     pa_sms_Message_t* smsPtr        ///< [OUT] Buffer to store decoded data
 )
 {
@@ -1038,11 +517,12 @@ static le_result_t DecodeUserDataField
     switch (encoding)
     {
         case SMSPDU_8_BITS:
-            messageLen = tpUdl - tpUdhl;
+            // TP-UDL is a number of bytes, header included
+            messageLen = tpUdl - udhSize;
             *formatPtr = LE_SMS_FORMAT_BINARY;
-            if (messageLen < destDataSize)
+            if ((messageLen >= 0) && (messageLen < destDataSize))
             {
-                memcpy(destDataPtr, &dataPtr[*posPtr], messageLen);
+                memcpy(destDataPtr, &dataPtr[*posPtr + udhSize], messageLen);
                 *destDataLenPtr = messageLen;
             }
             else
@@ -1054,16 +534,18 @@ static le_result_t DecodeUserDataField
             break;
 
         case SMSPDU_7_BITS:
-            messageLen = ((tpUdl * 7) - (tpUdhl * 8)) /7;
+        {
+            // TP-UDL is a number of septets, header and its fill bits included
+            int headerLen = ((udhSize * 8) + 6) / 7;
+            messageLen = tpUdl - headerLen;
             if (messageLen <= 0)
             {
                 LE_ERROR("the message length %d is <= 0 ",messageLen);
                 return LE_FAULT;
             }
-            *posPtr -= ((tpUdhl * 8) + 6) / 7; // translate the pos in 7bits char unit
             *formatPtr = LE_SMS_FORMAT_TEXT;
             int size = Convert7BitsTo8Bits(&dataPtr[*posPtr],
-                                           0,
+                                           headerLen,
                                            messageLen,
                                            destDataPtr,
                                            destDataSize);
@@ -1075,13 +557,15 @@ static le_result_t DecodeUserDataField
             *destDataLenPtr = size;
             LE_INFO(" messageLen %d, pos %d, size %d ", messageLen, *posPtr, size);
             break;
+        }
 
         case SMSPDU_UCS2_16_BITS:
-            messageLen = tpUdl - tpUdhl;
+            // TP-UDL is a number of bytes, header included
+            messageLen = tpUdl - udhSize;
             *formatPtr = LE_SMS_FORMAT_UCS2;
-            if (messageLen < destDataSize)
+            if ((messageLen >= 0) && (messageLen < destDataSize))
             {
-                memcpy(destDataPtr, &dataPtr[*posPtr], messageLen);
+                memcpy(destDataPtr, &dataPtr[*posPtr + udhSize], messageLen);
                 *destDataLenPtr = messageLen;
             }
             else
@@ -1229,21 +713,36 @@ static le_result_t DecodePduDeliver
     tpUdl = ReadByte(dataPtr, pos++);
     LE_DEBUG("TP-UDL: %d", tpUdl);
 
-    // TP User Data Header Length
-    tpUdhl = tpUdhi ? ReadByte(dataPtr, pos++) : 0;
-    LE_DEBUG("TP-UDHL: %d", tpUdhl);
-
     // TP User Data
     DumpPdu("TP-UD", &dataPtr[pos], tpUdl);
 
-    if (tpUdhl)
+    if (tpUdhi)
     {
-        LE_WARN("Multi part SMS are not available yet");
-        DumpPdu("TP-UDH", &dataPtr[pos-1], tpUdhl+1);
-        return LE_UNSUPPORTED;
+        // TP User Data Header Length
+        tpUdhl = ReadByte(dataPtr, pos);
+        LE_DEBUG("TP-UDHL: %d", tpUdhl);
+        DumpPdu("TP-UDH", &dataPtr[pos], tpUdhl+1);
+
+        // Only the parts of concatenated messages are supported
+        if (LE_OK != DecodeUserDataHeader(&dataPtr[pos+1], tpUdhl, &smsPtr->smsDeliver.concat))
+        {
+            LE_WARN("User data header not supported");
+            return LE_UNSUPPORTED;
+        }
+        smsPtr->smsDeliver.option |= PA_SMS_OPTIONMASK_CONCAT;
+        LE_DEBUG("Concatenated SMS: ref %u (%s), part %u/%u",
+                 smsPtr->smsDeliver.concat.ref,
+                 smsPtr->smsDeliver.concat.ref16Bits ? "16 bits" : "8 bits",
+                 smsPtr->smsDeliver.concat.seqNum,
+                 smsPtr->smsDeliver.concat.maxNum);
+
+        result = DecodeUserDataField(dataPtr, &pos, encoding, tpUdl, tpUdhl + 1, smsPtr);
+    }
+    else
+    {
+        result = DecodeUserDataField(dataPtr, &pos, encoding, tpUdl, 0, smsPtr);
     }
 
-    result = DecodeUserDataField(dataPtr, &pos, encoding, tpUdl, tpUdhl, smsPtr);
     if (LE_OK != result)
     {
         return result;
@@ -1328,7 +827,7 @@ static le_result_t DecodePduSubmit
         return LE_UNSUPPORTED;
     }
 
-    result = DecodeUserDataField(dataPtr, &pos, encoding, tpUdl, tpUdhl, smsPtr);
+    result = DecodeUserDataField(dataPtr, &pos, encoding, tpUdl, 0, smsPtr);
     if (LE_OK != result)
     {
         return result;
@@ -1576,7 +1075,6 @@ static le_result_t EncodeMessageGsm
             {
                 uint8_t newMessageLen;
                 int size = Convert8BitsTo7Bits(dataPtr->messagePtr,
-                                               0,
                                                messageLen,
                                                &pduPtr->data[pos],
                                                LE_SMS_PDU_MAX_PAYLOAD,
@@ -1808,7 +1306,8 @@ static le_result_t DecodeMessageGWCB
             *formatPtr = LE_SMS_FORMAT_TEXT;
             /* Content of message started dataPtr + 6 */
             int size = Convert7BitsTo8Bits(&dataPtr[6],
-                            0, messageLen,
+                            0,
+                            messageLen,
                             destDataPtr, destDataSize);
             if (size == LE_OVERFLOW)
             {
@@ -1846,29 +1345,17 @@ static le_result_t EncodeCdma7BitsData
     uint8_t       *a7bitsNumber ///< [OUT] number of char in 7bitsPtr
 )
 {
-    int read;
-    int write = 0;
-    int size = 0;
-
-    memset(a7bitPtr,0,a7bitSize);
-
-    for (read = 0; read < a8bitPtrSize; ++read)
+    if (SMS7BITS_PACKED_SIZE(a8bitPtrSize) > a7bitSize)
     {
-        if (size>a7bitSize)
-        {
-            return LE_OVERFLOW;
-        }
+        return LE_OVERFLOW;
+    }
 
-        WriteCdma7Bits(a7bitPtr, a8bitPtr[read], write*7);
-        write++;
+    memset(a7bitPtr,0,a7bitSize);
 
-        /* Number of 8 bit chars */
-        size = (write * 7);
-        size = (size % 8 != 0) ? (size/8 + 1) : (size/8);
-    }
+    sms7Bits_PackCdma(a8bitPtr, a8bitPtrSize, a7bitPtr);
 
     /* Number of written chars */
-    *a7bitsNumber = write;
+    *a7bitsNumber = a8bitPtrSize;
 
     return LE_OK;
 }
@@ -1890,24 +1377,16 @@ static le_result_t DecodeCdma7bitsData
     uint32_t      *a8bitNumber   ///< [OUT] number of char written
 )
 {
-    int read;
-    int write;
-
     memset(a8bitPtr,0,a8bitSize);
 
-    for (read = 0, write = 0; read < a7bitPtrSize; read++, write++)
+    if (a7bitPtrSize > a8bitSize)
     {
-        if (write < a8bitSize)
-        {
-            a8bitPtr[write] = ReadCdma7Bits(a7bitPtr, read*7);
-        }
-        else
-        {
-            return LE_OVERFLOW;
-        }
+        return LE_OVERFLOW;
     }
 
-    *a8bitNumber = write;
+    sms7Bits_UnpackCdma(a7bitPtr, a7bitPtrSize, a8bitPtr);
+
+    *a8bitNumber = a7bitPtrSize;
 
     return LE_OK;
 }
@@ -72,7 +72,9 @@ typedef enum
     PA_SMS_OPTIONMASK_OA        = 0x0001, ///< TP Originating Address is present
     PA_SMS_OPTIONMASK_SCTS      = 0x0002, ///< TP Service Centre Time Stamp is present
     PA_SMS_OPTIONMASK_DA        = 0x0004, ///< TP Destination Address is present
-    PA_SMS_OPTIONMASK_RA        = 0x0008  ///< TP Recipient Address is present
+    PA_SMS_OPTIONMASK_RA        = 0x0008, ///< TP Recipient Address is present
+    PA_SMS_OPTIONMASK_CONCAT    = 0x0010  ///< Concatenated short message information element
+                                          ///< is present
 }
 pa_sms_OptionMask_t;
 
@@ -130,6 +132,21 @@ pa_sms_Storage_t;
 // APIs.
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Concatenated short message information element, found in the user data header of each part of
+ * a multipart message.
+ * Defined in 3GPP TS 23.040 sections 9.2.3.24.1 and 9.2.3.24.8.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct {
+    uint16_t ref;       ///< Concatenated short message reference number
+    bool     ref16Bits; ///< The reference number is a 16 bits number
+    uint8_t  maxNum;    ///< Maximum number of short messages in the concatenated message
+    uint8_t  seqNum;    ///< Sequence number of the current short message, starting at 1
+}
+pa_sms_Concat_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * SMS-DELIVER message type structure.
@@ -144,6 +161,7 @@ typedef struct {
     le_sms_Format_t     format;                           ///< mandatory, SMS user data format
     uint8_t             data[LE_SMS_TEXT_MAX_BYTES];      ///< mandatory, SMS user data
     uint32_t            dataLen;                          ///< mandatory, SMS user data length
+    pa_sms_Concat_t     concat;                           ///< optional, concatenation information
 }
 pa_sms_SmsDeliver_t;
 
@@ -0,0 +1,1217 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  SMS Inbox Server
+ *
+ * Message store: append-only log file of the messages, indexed in memory.
+ *
+ * The log file starts with a header, followed by records. A message record holds a message and the
+ * message boxes it was added to; a state record holds the new message boxes and read/unread status
+ * of a message. A message is deleted when a state record removes it from all the message boxes.
+ * Each record is protected by a CRC, so that a record partially written when the device was powered
+ * off is dropped when the log is loaded.
+ *
+ * The index holds, for each live message, its identifier, its message boxes and read/unread status,
+ * and the position of its message record in the log. The messages are linked by identifier in a
+ * list per message box, and found by identifier in a hashmap.
+ *
+ * The log is compacted when more than half of it is garbage (deleted messages and state records):
+ * the live message records are copied, with their current state, into a new log file which then
+ * replaces the old one.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ */
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "msgStore.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbols and enums.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log file identification and format version.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_MAGIC               0x4c534d53  // "SMSL"
+#define LOG_VERSION             1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record types.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_MSG              1
+#define RECORD_STATE            2
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The log isn't compacted as long as its garbage is smaller than this.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPACT_MIN_BYTES       (32 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffers used to load and compact the log.
+ */
+//--------------------------------------------------------------------------------------------------
+#define IO_BUFFER_BYTES         (16 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Suffix of the temporary file used to compact the log.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPACT_SUFFIX          ".tmp"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Suffix of an unreadable log file, kept aside.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BAD_SUFFIX              ".bad"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initial capacity of the message index.
+ */
+//--------------------------------------------------------------------------------------------------
+#define INDEX_CAPACITY          64
+
+//--------------------------------------------------------------------------------------------------
+// Data structures.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log file header.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;         ///< LOG_MAGIC
+    uint32_t version;       ///< LOG_VERSION
+    uint32_t nextMsgId;     ///< Next message identifier when the log was created
+    uint32_t crc;           ///< CRC of the fields above
+}
+LogHeader_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record header, followed by len bytes of payload (the used part of a MsgStore_Msg_t for a message
+ * record, nothing for a state record).
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t crc;           ///< CRC of the fields below and of the payload
+    uint16_t type;          ///< RECORD_MSG or RECORD_STATE
+    uint16_t len;           ///< Number of bytes of the payload
+    uint32_t msgId;         ///< Message identifier
+    uint16_t mboxMask;      ///< Message boxes holding the message
+    uint16_t unreadMask;    ///< Message boxes where the message is unread
+}
+RecordHeader_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest record.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    RecordHeader_t header;  ///< Record header
+    MsgStore_Msg_t msg;     ///< Message
+}
+Record_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index entry of a message.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t      msgId;        ///< Message identifier, key of the index
+    uint32_t      offset;       ///< Position of the message record in the log
+    uint16_t      recordSize;   ///< Number of bytes of the message record
+    uint16_t      mboxMask;     ///< Message boxes holding the message
+    uint16_t      unreadMask;   ///< Message boxes where the message is unread
+    le_dls_Link_t link;         ///< Link in the list of all the messages
+    le_dls_Link_t mboxLinks[];  ///< Links in the message box lists, one per message box
+}
+Entry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message box.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_List_t list;         ///< Messages, by identifier
+    uint32_t      count;        ///< Number of messages
+}
+Mbox_t;
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pool for the index entries.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t EntryPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index of the messages, by identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t EntryMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * All the messages, by identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t MsgList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message boxes.
+ */
+//--------------------------------------------------------------------------------------------------
+static Mbox_t Mboxes[MSGSTORE_MAX_MBOX];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of message boxes.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t NumMbox;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log file path, descriptor and size.
+ */
+//--------------------------------------------------------------------------------------------------
+static char LogPath[PATH_MAX];
+static int LogFd = -1;
+static uint32_t LogSize;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes of the live message records.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t LiveBytes;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log size below which the log isn't compacted again after a failed compaction.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t CompactRetrySize;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Next message identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t NextMsgId = 1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last read message. Clients usually read several fields of a message in a row.
+ */
+//--------------------------------------------------------------------------------------------------
+static struct
+{
+    uint32_t       msgId;       ///< Identifier of the message, 0 if none
+    MsgStore_Msg_t msg;         ///< Message
+}
+ReadCache;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the CRC of a record.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RecordCrc
+(
+    Record_t* recordPtr     ///<[IN] Record
+)
+{
+    return le_crc_Crc32((uint8_t*)&recordPtr->header.type,
+                        sizeof(RecordHeader_t) - offsetof(RecordHeader_t, type)
+                        + recordPtr->header.len,
+                        LE_CRC_START_CRC32);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the entry of a message box link.
+ */
+//--------------------------------------------------------------------------------------------------
+static Entry_t* EntryFromMboxLink
+(
+    le_dls_Link_t* linkPtr, ///<[IN] Link in a message box list
+    uint32_t mbox           ///<[IN] Message box
+)
+{
+    return (Entry_t*)((uint8_t*)(linkPtr - mbox) - offsetof(Entry_t, mboxLinks));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Insert an entry in a message box list, by identifier. Messages are usually added in identifier
+ * order, so the list is searched from its tail.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LinkInMbox
+(
+    Entry_t* entryPtr,      ///<[IN] Entry
+    uint32_t mbox           ///<[IN] Message box
+)
+{
+    le_dls_List_t* listPtr = &Mboxes[mbox].list;
+    le_dls_Link_t* linkPtr = le_dls_PeekTail(listPtr);
+
+    while (linkPtr && (EntryFromMboxLink(linkPtr, mbox)->msgId > entryPtr->msgId))
+    {
+        linkPtr = le_dls_PeekPrev(listPtr, linkPtr);
+    }
+
+    entryPtr->mboxLinks[mbox] = LE_DLS_LINK_INIT;
+
+    if (linkPtr)
+    {
+        le_dls_AddAfter(listPtr, linkPtr, &entryPtr->mboxLinks[mbox]);
+    }
+    else
+    {
+        le_dls_Stack(listPtr, &entryPtr->mboxLinks[mbox]);
+    }
+
+    Mboxes[mbox].count++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Insert an entry in the list of all the messages, by identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LinkInMsgList
+(
+    Entry_t* entryPtr       ///<[IN] Entry
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_PeekTail(&MsgList);
+
+    while (linkPtr && (CONTAINER_OF(linkPtr, Entry_t, link)->msgId > entryPtr->msgId))
+    {
+        linkPtr = le_dls_PeekPrev(&MsgList, linkPtr);
+    }
+
+    entryPtr->link = LE_DLS_LINK_INIT;
+
+    if (linkPtr)
+    {
+        le_dls_AddAfter(&MsgList, linkPtr, &entryPtr->link);
+    }
+    else
+    {
+        le_dls_Stack(&MsgList, &entryPtr->link);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the message boxes and read/unread status of an entry in the index. The entry is deleted
+ * if it no longer belongs to any message box.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetEntryState
+(
+    Entry_t* entryPtr,      ///<[IN] Entry
+    uint16_t mboxMask,      ///<[IN] New message boxes
+    uint16_t unreadMask     ///<[IN] New read/unread status
+)
+{
+    uint32_t mbox;
+
+    for (mbox = 0; mbox < NumMbox; mbox++)
+    {
+        uint16_t bit = 1 << mbox;
+
+        if ((entryPtr->mboxMask & bit) && !(mboxMask & bit))
+        {
+            le_dls_Remove(&Mboxes[mbox].list, &entryPtr->mboxLinks[mbox]);
+            Mboxes[mbox].count--;
+        }
+        else if (!(entryPtr->mboxMask & bit) && (mboxMask & bit))
+        {
+            LinkInMbox(entryPtr, mbox);
+        }
+    }
+
+    entryPtr->mboxMask = mboxMask;
+    entryPtr->unreadMask = unreadMask & mboxMask;
+
+    if (mboxMask == 0)
+    {
+        if (ReadCache.msgId == entryPtr->msgId)
+        {
+            ReadCache.msgId = 0;
+        }
+
+        le_dls_Remove(&MsgList, &entryPtr->link);
+        le_hashmap_Remove(EntryMap, &entryPtr->msgId);
+        LiveBytes -= entryPtr->recordSize;
+        le_mem_Release(entryPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a message record to the index, replacing any entry with the same identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+static void IndexMsg
+(
+    const RecordHeader_t* headerPtr,    ///<[IN] Message record header
+    uint32_t offset                     ///<[IN] Position of the message record in the log
+)
+{
+    Entry_t* entryPtr = le_hashmap_Get(EntryMap, &headerPtr->msgId);
+
+    if (entryPtr)
+    {
+        SetEntryState(entryPtr, 0, 0);
+    }
+
+    if (headerPtr->msgId >= NextMsgId)
+    {
+        NextMsgId = headerPtr->msgId + 1;
+    }
+
+    if ((headerPtr->mboxMask & ((1 << NumMbox) - 1)) == 0)
+    {
+        return;
+    }
+
+    entryPtr = le_mem_ForceAlloc(EntryPool);
+    entryPtr->msgId = headerPtr->msgId;
+    entryPtr->offset = offset;
+    entryPtr->recordSize = sizeof(RecordHeader_t) + headerPtr->len;
+    entryPtr->mboxMask = 0;
+    entryPtr->unreadMask = 0;
+
+    le_hashmap_Put(EntryMap, &entryPtr->msgId, entryPtr);
+    LinkInMsgList(entryPtr);
+    LiveBytes += entryPtr->recordSize;
+
+    SetEntryState(entryPtr,
+                  headerPtr->mboxMask & ((1 << NumMbox) - 1),
+                  headerPtr->unreadMask);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a buffer, retrying on partial writes.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteAll
+(
+    int fd,                 ///<[IN] File descriptor
+    const void* bufPtr,     ///<[IN] Data
+    size_t len              ///<[IN] Number of bytes
+)
+{
+    const uint8_t* dataPtr = bufPtr;
+
+    while (len > 0)
+    {
+        ssize_t writtenSize = write(fd, dataPtr, len);
+
+        if (writtenSize < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            LE_ERROR("Write error: %m");
+            return LE_FAULT;
+        }
+
+        dataPtr += writtenSize;
+        len -= writtenSize;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the log header in a new log file.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteLogHeader
+(
+    int fd                  ///<[IN] File descriptor
+)
+{
+    LogHeader_t header;
+
+    header.magic = LOG_MAGIC;
+    header.version = LOG_VERSION;
+    header.nextMsgId = NextMsgId;
+    header.crc = le_crc_Crc32((uint8_t*)&header, offsetof(LogHeader_t, crc), LE_CRC_START_CRC32);
+
+    return WriteAll(fd, &header, sizeof(header));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a record to the log.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on error, the log is left unchanged
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AppendRecord
+(
+    Record_t* recordPtr,    ///<[IN] Record, its CRC is filled in
+    bool sync               ///<[IN] Sync the log to the file system
+)
+{
+    size_t recordSize = sizeof(RecordHeader_t) + recordPtr->header.len;
+
+    recordPtr->header.crc = RecordCrc(recordPtr);
+
+    if ((WriteAll(LogFd, recordPtr, recordSize) != LE_OK) ||
+        (sync && (fdatasync(LogFd) < 0)))
+    {
+        LE_ERROR("Unable to append to %s", LogPath);
+
+        // Drop the partially written record.
+        if (ftruncate(LogFd, LogSize) < 0)
+        {
+            LE_ERROR("Unable to truncate %s: %m", LogPath);
+        }
+
+        return LE_FAULT;
+    }
+
+    LogSize += recordSize;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the log file for appending and reading.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenLog
+(
+    void
+)
+{
+    LogFd = open(LogPath, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+
+    if (LogFd < 0)
+    {
+        LE_ERROR("Unable to open %s: %m", LogPath);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a message record from the log.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the record can't be read or is corrupted
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadRecord
+(
+    Entry_t* entryPtr,      ///<[IN] Entry of the message
+    Record_t* recordPtr     ///<[OUT] Message record
+)
+{
+    ssize_t readSize;
+
+    do
+    {
+        readSize = pread(LogFd, recordPtr, entryPtr->recordSize, entryPtr->offset);
+    }
+    while ((readSize < 0) && (EINTR == errno));
+
+    if ((readSize != entryPtr->recordSize) ||
+        (recordPtr->header.type != RECORD_MSG) ||
+        (recordPtr->header.msgId != entryPtr->msgId) ||
+        (sizeof(RecordHeader_t) + recordPtr->header.len != entryPtr->recordSize) ||
+        (recordPtr->header.crc != RecordCrc(recordPtr)))
+    {
+        LE_ERROR("Unable to read message %08x from %s", entryPtr->msgId, LogPath);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact the log: write the live message records, with their current state, in a new log file
+ * which replaces the current one.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on error, the current log is kept
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Compact
+(
+    void
+)
+{
+    char tmpPath[sizeof(LogPath) + sizeof(COMPACT_SUFFIX)];
+    uint8_t buf[IO_BUFFER_BYTES];
+    size_t bufLen = 0;
+    Record_t record;
+    uint32_t offset = sizeof(LogHeader_t);
+    le_dls_Link_t* linkPtr;
+    le_result_t result = LE_OK;
+
+    LE_DEBUG("Compact %s: %u bytes, %u live", LogPath, LogSize, LiveBytes);
+
+    snprintf(tmpPath, sizeof(tmpPath), "%s%s", LogPath, COMPACT_SUFFIX);
+
+    int fd = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+
+    if (fd < 0)
+    {
+        LE_ERROR("Unable to create %s: %m", tmpPath);
+        return LE_FAULT;
+    }
+
+    result = WriteLogHeader(fd);
+
+    linkPtr = le_dls_Peek(&MsgList);
+
+    while (linkPtr && (result == LE_OK))
+    {
+        Entry_t* entryPtr = CONTAINER_OF(linkPtr, Entry_t, link);
+
+        linkPtr = le_dls_PeekNext(&MsgList, linkPtr);
+
+        if (ReadRecord(entryPtr, &record) != LE_OK)
+        {
+            // Drop the unreadable message.
+            SetEntryState(entryPtr, 0, 0);
+            continue;
+        }
+
+        record.header.mboxMask = entryPtr->mboxMask;
+        record.header.unreadMask = entryPtr->unreadMask;
+        record.header.crc = RecordCrc(&record);
+
+        if (bufLen + entryPtr->recordSize > sizeof(buf))
+        {
+            result = WriteAll(fd, buf, bufLen);
+            bufLen = 0;
+        }
+
+        memcpy(buf + bufLen, &record, entryPtr->recordSize);
+        bufLen += entryPtr->recordSize;
+    }
+
+    if (result == LE_OK)
+    {
+        result = WriteAll(fd, buf, bufLen);
+    }
+
+    if ((result != LE_OK) || (fdatasync(fd) < 0) || (close(fd) < 0))
+    {
+        LE_ERROR("Unable to write %s", tmpPath);
+        close(fd);
+        unlink(tmpPath);
+        return LE_FAULT;
+    }
+
+    if (rename(tmpPath, LogPath) < 0)
+    {
+        LE_ERROR("Unable to rename %s: %m", tmpPath);
+        unlink(tmpPath);
+        return LE_FAULT;
+    }
+
+    close(LogFd);
+
+    // The new log holds the message records in the same order.
+    for (linkPtr = le_dls_Peek(&MsgList); linkPtr; linkPtr = le_dls_PeekNext(&MsgList, linkPtr))
+    {
+        Entry_t* entryPtr = CONTAINER_OF(linkPtr, Entry_t, link);
+
+        entryPtr->offset = offset;
+        offset += entryPtr->recordSize;
+    }
+
+    LogSize = offset;
+
+    LE_FATAL_IF(OpenLog() != LE_OK, "Unable to reopen %s", LogPath);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact the log if more than half of it is garbage. After a failed compaction, the next one is
+ * attempted once COMPACT_MIN_BYTES more bytes are appended.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompactIfNeeded
+(
+    void
+)
+{
+    uint32_t garbageBytes = LogSize - sizeof(LogHeader_t) - LiveBytes;
+
+    if ((garbageBytes > COMPACT_MIN_BYTES) && (garbageBytes > LiveBytes) &&
+        (LogSize >= CompactRetrySize))
+    {
+        CompactRetrySize = (Compact() == LE_OK) ? 0 : LogSize + COMPACT_MIN_BYTES;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a state record for a message, and update the index.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on error, the message is left unchanged
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetState
+(
+    Entry_t* entryPtr,      ///<[IN] Entry of the message
+    uint16_t mboxMask,      ///<[IN] New message boxes
+    uint16_t unreadMask     ///<[IN] New read/unread status
+)
+{
+    Record_t record;
+
+    if ((entryPtr->mboxMask == mboxMask) && (entryPtr->unreadMask == (unreadMask & mboxMask)))
+    {
+        return LE_OK;
+    }
+
+    record.header.type = RECORD_STATE;
+    record.header.len = 0;
+    record.header.msgId = entryPtr->msgId;
+    record.header.mboxMask = mboxMask;
+    record.header.unreadMask = unreadMask & mboxMask;
+
+    if (AppendRecord(&record, false) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    SetEntryState(entryPtr, mboxMask, unreadMask);
+
+    CompactIfNeeded();
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a message record, and add it to the index.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddMsg
+(
+    uint32_t msgId,                 ///<[IN] Identifier of the message
+    const MsgStore_Msg_t* msgPtr,   ///<[IN] Message
+    uint16_t mboxMask,              ///<[IN] Message boxes holding the message
+    uint16_t unreadMask             ///<[IN] Message boxes where the message is unread
+)
+{
+    Record_t record;
+    uint32_t offset = LogSize;
+
+    LE_ASSERT(msgPtr->dataLen <= sizeof(msgPtr->data));
+
+    record.header.type = RECORD_MSG;
+    record.header.len = offsetof(MsgStore_Msg_t, data) + msgPtr->dataLen;
+    record.header.msgId = msgId;
+    record.header.mboxMask = mboxMask;
+    record.header.unreadMask = unreadMask & mboxMask;
+    memcpy(&record.msg, msgPtr, record.header.len);
+
+    if (AppendRecord(&record, true) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    IndexMsg(&record.header, offset);
+
+    CompactIfNeeded();
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the log into the index. Records following a corrupted one are dropped from the log.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the file isn't a message log
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t LoadLog
+(
+    FILE* filePtr           ///<[IN] Log file
+)
+{
+    LogHeader_t header;
+    Record_t record;
+    uint32_t offset = sizeof(LogHeader_t);
+
+    if ((fread(&header, sizeof(header), 1, filePtr) != 1) ||
+        (header.magic != LOG_MAGIC) ||
+        (header.version != LOG_VERSION) ||
+        (header.crc != le_crc_Crc32((uint8_t*)&header, offsetof(LogHeader_t, crc),
+                                    LE_CRC_START_CRC32)))
+    {
+        LE_ERROR("%s is not a message log", LogPath);
+        return LE_FAULT;
+    }
+
+    if (header.nextMsgId > NextMsgId)
+    {
+        NextMsgId = header.nextMsgId;
+    }
+
+    while (fread(&record.header, sizeof(RecordHeader_t), 1, filePtr) == 1)
+    {
+        if ((record.header.len > sizeof(MsgStore_Msg_t)) ||
+            (fread(&record.msg, 1, record.header.len, filePtr) != record.header.len) ||
+            (record.header.crc != RecordCrc(&record)))
+        {
+            break;
+        }
+
+        if (record.header.type == RECORD_MSG)
+        {
+            IndexMsg(&record.header, offset);
+        }
+        else if (record.header.type == RECORD_STATE)
+        {
+            Entry_t* entryPtr = le_hashmap_Get(EntryMap, &record.header.msgId);
+
+            if (entryPtr)
+            {
+                SetEntryState(entryPtr,
+                              record.header.mboxMask & ((1 << NumMbox) - 1),
+                              record.header.unreadMask);
+            }
+        }
+
+        offset += sizeof(RecordHeader_t) + record.header.len;
+    }
+
+    LogSize = offset;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the message store, and build its index from the log file.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the log file can't be opened or created
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t MsgStore_Open
+(
+    const char* pathPtr,    ///< [IN] Log file path
+    uint32_t    numMbox     ///< [IN] Number of message boxes
+)
+{
+    struct stat st;
+
+    LE_ASSERT(numMbox <= MSGSTORE_MAX_MBOX);
+
+    if (LogFd >= 0)
+    {
+        return LE_OK;
+    }
+
+    if (EntryPool == NULL)
+    {
+        EntryPool = le_mem_CreatePool("MsgStoreEntryPool",
+                                      sizeof(Entry_t) + numMbox * sizeof(le_dls_Link_t));
+        EntryMap = le_hashmap_Create("MsgStoreIndex", INDEX_CAPACITY,
+                                     le_hashmap_HashUInt32, le_hashmap_EqualsUInt32);
+    }
+
+    NumMbox = numMbox;
+
+    if (le_utf8_Copy(LogPath, pathPtr, sizeof(LogPath), NULL) != LE_OK)
+    {
+        LE_ERROR("Path too long: %s", pathPtr);
+        return LE_FAULT;
+    }
+
+    FILE* filePtr = fopen(LogPath, "r");
+    le_result_t result = LE_NOT_FOUND;
+
+    if (filePtr)
+    {
+        char buf[IO_BUFFER_BYTES];
+
+        setvbuf(filePtr, buf, _IOFBF, sizeof(buf));
+        result = LoadLog(filePtr);
+        fclose(filePtr);
+    }
+    else if (errno != ENOENT)
+    {
+        LE_ERROR("Unable to open %s: %m", LogPath);
+        return LE_FAULT;
+    }
+
+    if (result == LE_OK)
+    {
+        if ((stat(LogPath, &st) == 0) && (st.st_size > LogSize))
+        {
+            LE_WARN("Drop %u corrupted bytes at the end of %s",
+                    (uint32_t)(st.st_size - LogSize), LogPath);
+
+            if (truncate(LogPath, LogSize) < 0)
+            {
+                LE_ERROR("Unable to truncate %s: %m", LogPath);
+                return LE_FAULT;
+            }
+        }
+
+        if (OpenLog() != LE_OK)
+        {
+            return LE_FAULT;
+        }
+    }
+    else
+    {
+        if (result == LE_FAULT)
+        {
+            // Keep the unreadable file aside, and start a new log.
+            char badPath[sizeof(LogPath) + sizeof(BAD_SUFFIX)];
+
+            snprintf(badPath, sizeof(badPath), "%s%s", LogPath, BAD_SUFFIX);
+            LE_ERROR("Moving %s to %s", LogPath, badPath);
+
+            if (rename(LogPath, badPath) < 0)
+            {
+                LE_ERROR("Unable to rename %s: %m", LogPath);
+                return LE_FAULT;
+            }
+        }
+
+        if (OpenLog() != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        if (WriteLogHeader(LogFd) != LE_OK)
+        {
+            close(LogFd);
+            LogFd = -1;
+            unlink(LogPath);
+            return LE_FAULT;
+        }
+
+        LogSize = sizeof(LogHeader_t);
+    }
+
+    LE_INFO("%u messages in %s", (uint32_t)le_hashmap_Size(EntryMap), LogPath);
+
+    CompactIfNeeded();
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a new message, unread, to some message boxes. The message is synced to the file system
+ * before this function returns.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the message can't be written
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t MsgStore_Add
+(
+    const MsgStore_Msg_t* msgPtr,   ///< [IN] Message
+    uint16_t mboxMask,              ///< [IN] Message boxes to add the message to (bit per box)
+    uint32_t* msgIdPtr              ///< [OUT] Identifier of the message
+)
+{
+    uint32_t msgId = NextMsgId;
+
+    if (AddMsg(msgId, msgPtr, mboxMask, mboxMask) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    *msgIdPtr = msgId;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a message with a given identifier, replacing any stored message with the same identifier.
+ * This is used to import messages from another storage.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the message can't be written
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t MsgStore_Import
+(
+    uint32_t msgId,                 ///< [IN] Identifier of the message
+    const MsgStore_Msg_t* msgPtr,   ///< [IN] Message
+    uint16_t mboxMask,              ///< [IN] Message boxes holding the message (bit per box)
+    uint16_t unreadMask             ///< [IN] Message boxes where the message is unread
+)
+{
+    if (msgId == 0)
+    {
+        return LE_FAULT;
+    }
+
+    return AddMsg(msgId, msgPtr, mboxMask, unreadMask);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a message.
+ *
+ * @return
+ *      - Pointer to the message, valid until the next call to a MsgStore function
+ *      - NULL if the message doesn't exist or can't be read
+ */
+//--------------------------------------------------------------------------------------------------
+const MsgStore_Msg_t* MsgStore_Read
+(
+    uint32_t msgId      ///< [IN] Identifier of the message
+)
+{
+    Entry_t* entryPtr = le_hashmap_Get(EntryMap, &msgId);
+    Record_t record;
+
+    if (entryPtr == NULL)
+    {
+        return NULL;
+    }
+
+    if (ReadCache.msgId != msgId)
+    {
+        if (ReadRecord(entryPtr, &record) != LE_OK)
+        {
+            return NULL;
+        }
+
+        memset(&ReadCache.msg, 0, sizeof(ReadCache.msg));
+        memcpy(&ReadCache.msg, &record.msg, record.header.len);
+        ReadCache.msgId = msgId;
+    }
+
+    return &ReadCache.msg;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message belongs to a message box.
+ */
+//--------------------------------------------------------------------------------------------------
+bool MsgStore_IsInMbox
+(
+    uint32_t msgId,     ///< [IN] Identifier of the message
+    uint32_t mbox       ///< [IN] Message box
+)
+{
+    Entry_t* entryPtr = le_hashmap_Get(EntryMap, &msgId);
+
+    return entryPtr && (entryPtr->mboxMask & (1 << mbox));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a message from a message box. The message is deleted once it's removed from all the
+ * message boxes.
+ *
+ * @return
+ *      - LE_OK on success, or if the message isn't in the message box
+ *      - LE_NOT_FOUND if the message doesn't exist
+ *      - LE_FAULT if the removal can't be written to the log
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t MsgStore_Remove
+(
+    uint32_t msgId,     ///< [IN] Identifier of the message
+    uint32_t mbox       ///< [IN] Message box
+)
+{
+    Entry_t* entryPtr = le_hashmap_Get(EntryMap, &msgId);
+
+    if (entryPtr == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    return SetState(entryPtr, entryPtr->mboxMask & ~(1 << mbox), entryPtr->unreadMask);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message is unread in a message box.
+ */
+//--------------------------------------------------------------------------------------------------
+bool MsgStore_IsUnread
+(
+    uint32_t msgId,     ///< [IN] Identifier of the message
+    uint32_t mbox       ///< [IN] Message box
+)
+{
+    Entry_t* entryPtr = le_hashmap_Get(EntryMap, &msgId);
+
+    return entryPtr && (entryPtr->unreadMask & (1 << mbox));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mark a message as read or unread in a message box.
+ */
+//--------------------------------------------------------------------------------------------------
+void MsgStore_SetUnread
+(
+    uint32_t msgId,     ///< [IN] Identifier of the message
+    uint32_t mbox,      ///< [IN] Message box
+    bool     isUnread   ///< [IN] New status
+)
+{
+    Entry_t* entryPtr = le_hashmap_Get(EntryMap, &msgId);
+
+    if (entryPtr)
+    {
+        uint16_t unreadMask = isUnread ? (entryPtr->unreadMask | (1 << mbox))
+                                       : (entryPtr->unreadMask & ~(1 << mbox));
+
+        SetState(entryPtr, entryPtr->mboxMask, unreadMask);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of messages of a message box.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t MsgStore_GetCount
+(
+    uint32_t mbox       ///< [IN] Message box
+)
+{
+    return Mboxes[mbox].count;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Browse a message box, from the oldest message to the newest one.
+ *
+ * Returns the first message of the box whose identifier is greater than or equal to fromId, and
+ * the identifier of the message following it in the box. Passing this identifier back as fromId
+ * gets the next message in constant time, even if the returned message is removed in between.
+ *
+ * @return
+ *      - Identifier of the message
+ *      - 0 if there is no such message
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t MsgStore_Browse
+(
+    uint32_t mbox,          ///< [IN] Message box
+    uint32_t fromId,        ///< [IN] Identifier to start from, 0 for the oldest message
+    uint32_t* nextIdPtr     ///< [OUT] Identifier of the following message, 0 if none
+)
+{
+    le_dls_List_t* listPtr = &Mboxes[mbox].list;
+    Entry_t* entryPtr = le_hashmap_Get(EntryMap, &fromId);
+    le_dls_Link_t* linkPtr;
+
+    *nextIdPtr = 0;
+
+    if (entryPtr && (entryPtr->mboxMask & (1 << mbox)))
+    {
+        linkPtr = &entryPtr->mboxLinks[mbox];
+    }
+    else
+    {
+        // Browsing from the oldest message, or the message was removed from the box since it was
+        // returned as the next one: look for the first one following it.
+        linkPtr = le_dls_Peek(listPtr);
+
+        while (linkPtr && (EntryFromMboxLink(linkPtr, mbox)->msgId < fromId))
+        {
+            linkPtr = le_dls_PeekNext(listPtr, linkPtr);
+        }
+    }
+
+    if (linkPtr == NULL)
+    {
+        return 0;
+    }
+
+    le_dls_Link_t* nextLinkPtr = le_dls_PeekNext(listPtr, linkPtr);
+
+    if (nextLinkPtr)
+    {
+        *nextIdPtr = EntryFromMboxLink(nextLinkPtr, mbox)->msgId;
+    }
+
+    return EntryFromMboxLink(linkPtr, mbox)->msgId;
+}
@@ -0,0 +1,214 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  SMS Inbox Server
+ *
+ * Declaration of the message store.
+ *
+ * The messages of all the message boxes are kept in one append-only log file, and indexed in
+ * memory: a message record is appended when a message is received, and a small state record is
+ * appended each time the message boxes holding a message, or its read/unread status, change.  The
+ * log is compacted when the records of deleted messages and the out of date state records take more
+ * room than the live messages.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ */
+// -------------------------------------------------------------------------------------------------
+
+#ifndef MSGSTORE_H_INCLUDE_GUARD
+#define MSGSTORE_H_INCLUDE_GUARD
+
+
+#include "legato.h"
+
+// Interface specific includes
+#include "interfaces.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of message boxes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSGSTORE_MAX_MBOX       16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a message payload (text, binary or PDU).
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSGSTORE_DATA_MAX_BYTES LE_SMS_PDU_MAX_BYTES
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message flags, telling which optional fields are set.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSGSTORE_HAS_SENDERTEL  0x01
+#define MSGSTORE_HAS_TIMESTAMP  0x02
+#define MSGSTORE_HAS_DATA       0x04
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message content, as written in the log file. Only the used bytes of data[] are written.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t  format;                                    ///< le_sms_Format_t
+    uint8_t  flags;                                     ///< MSGSTORE_HAS_xxx
+    uint16_t msgLen;                                    ///< Message length, see GetMsgLen
+    char     imsi[LE_SIM_IMSI_BYTES];                   ///< IMSI of the receiver SIM
+    char     senderTel[LE_MDMDEFS_PHONE_NUM_MAX_BYTES]; ///< Sender telephone number
+    char     timestamp[LE_SMS_TIMESTAMP_MAX_BYTES];     ///< Time stamp
+    uint16_t dataLen;                                   ///< Number of bytes of data[]
+    uint8_t  data[MSGSTORE_DATA_MAX_BYTES];             ///< Text, binary or PDU payload
+}
+MsgStore_Msg_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the message store, and build its index from the log file.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the log file can't be opened or created
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t MsgStore_Open
+(
+    const char* pathPtr,    ///< [IN] Log file path
+    uint32_t    numMbox     ///< [IN] Number of message boxes
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a new message, unread, to some message boxes. The message is synced to the file system
+ * before this function returns.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the message can't be written
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t MsgStore_Add
+(
+    const MsgStore_Msg_t* msgPtr,   ///< [IN] Message
+    uint16_t mboxMask,              ///< [IN] Message boxes to add the message to (bit per box)
+    uint32_t* msgIdPtr              ///< [OUT] Identifier of the message
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a message with a given identifier, replacing any stored message with the same identifier.
+ * This is used to import messages from another storage.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the message can't be written
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t MsgStore_Import
+(
+    uint32_t msgId,                 ///< [IN] Identifier of the message
+    const MsgStore_Msg_t* msgPtr,   ///< [IN] Message
+    uint16_t mboxMask,              ///< [IN] Message boxes holding the message (bit per box)
+    uint16_t unreadMask             ///< [IN] Message boxes where the message is unread
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a message.
+ *
+ * @return
+ *      - Pointer to the message, valid until the next call to a MsgStore function
+ *      - NULL if the message doesn't exist or can't be read
+ */
+//--------------------------------------------------------------------------------------------------
+const MsgStore_Msg_t* MsgStore_Read
+(
+    uint32_t msgId      ///< [IN] Identifier of the message
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message belongs to a message box.
+ */
+//--------------------------------------------------------------------------------------------------
+bool MsgStore_IsInMbox
+(
+    uint32_t msgId,     ///< [IN] Identifier of the message
+    uint32_t mbox       ///< [IN] Message box
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a message from a message box. The message is deleted once it's removed from all the
+ * message boxes.
+ *
+ * @return
+ *      - LE_OK on success, or if the message isn't in the message box
+ *      - LE_NOT_FOUND if the message doesn't exist
+ *      - LE_FAULT if the removal can't be written to the log
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t MsgStore_Remove
+(
+    uint32_t msgId,     ///< [IN] Identifier of the message
+    uint32_t mbox       ///< [IN] Message box
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message is unread in a message box.
+ */
+//--------------------------------------------------------------------------------------------------
+bool MsgStore_IsUnread
+(
+    uint32_t msgId,     ///< [IN] Identifier of the message
+    uint32_t mbox       ///< [IN] Message box
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mark a message as read or unread in a message box.
+ */
+//--------------------------------------------------------------------------------------------------
+void MsgStore_SetUnread
+(
+    uint32_t msgId,     ///< [IN] Identifier of the message
+    uint32_t mbox,      ///< [IN] Message box
+    bool     isUnread   ///< [IN] New status
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of messages of a message box.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t MsgStore_GetCount
+(
+    uint32_t mbox       ///< [IN] Message box
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Browse a message box, from the oldest message to the newest one.
+ *
+ * Returns the first message of the box whose identifier is greater than or equal to fromId, and
+ * the identifier of the message following it in the box. Passing this identifier back as fromId
+ * gets the next message in constant time, even if the returned message is removed in between.
+ *
+ * @return
+ *      - Identifier of the message
+ *      - 0 if there is no such message
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t MsgStore_Browse
+(
+    uint32_t mbox,          ///< [IN] Message box
+    uint32_t fromId,        ///< [IN] Identifier to start from, 0 for the oldest message
+    uint32_t* nextIdPtr     ///< [OUT] Identifier of the following message, 0 if none
+);
+
+
+#endif // MSGSTORE_H_INCLUDE_GUARD
@@ -2,18 +2,20 @@
 /**
  *  SMS Inbox Server
  *
- * When the service is activated, or when a SMS is received, the SMS is copied from the SIM to a
- * specific folder (SMSINBOX_PATH/MSG_PATH).
+ * When the service is activated, or when a SMS is received, the SMS is moved from the SIM to the
+ * message store (SMSINBOX_PATH/STORE_FILE), and added to the message box of each application using
+ * the SMS Inbox Server. A message box holds at most a configured number of messages: the oldest
+ * message of a full message box is removed from it when a new one is received.
  *
- * Each SMS is copied into a dedicated file (named with a unique message identifier). The data
- * are stored using the Jannsson representation: Each data (imsi, SMS format, message length,
- * text/pdu, sender telephone number, timestamp, read/unread) are recorded with a key to retrieve
- * each value.
+ * The message store (see msgStore.h) keeps all the messages in one append-only log file, and
+ * indexes them in memory: the message boxes, the read/unread status of each message and the
+ * message browsing don't need any file access, and receiving a message appends one record to the
+ * log. A message box is identified in the store by the index of its name in le_smsInbox_mboxName.
  *
- * Each application using the SMS Inbox Server possesses a configuration file in
- * SMSINBOX_PATH/CONF_PATH directory (also encoding using Jansson format): this file is used to
- * store the message identifier contained in the application mailbox. It is updated each time is new
- * SMS is received.
+ * Previous versions of the SMS Inbox Server stored each SMS in a dedicated Jansson file in
+ * SMSINBOX_PATH/MSG_PATH, and the message identifiers of each message box in a Jansson file in
+ * SMSINBOX_PATH/CONF_PATH. These files are imported in the message store, then deleted, when the
+ * store is opened.
  *
  *  Copyright (C) Sierra Wireless Inc.
  */
@@ -23,6 +25,7 @@
 #include "interfaces.h"
 #include "mdmCfgEntries.h"
 #include "le_smsInbox.h"
+#include "msgStore.h"
 
 #include "le_print.h"
 #include "le_hex.h"
@@ -44,14 +47,15 @@
 #else
 #define SMSINBOX_PATH "/tmp/smsInbox/"
 #endif
-#define MSG_PATH "msg/"
-#define CONF_PATH "cfg/"
+#define STORE_FILE "messages.log"
 
 //--------------------------------------------------------------------------------------------------
 /**
- * File extension definition.
+ * Directories and file extension of the Jansson files of the previous versions.
  */
 //--------------------------------------------------------------------------------------------------
+#define MSG_PATH "msg/"
+#define CONF_PATH "cfg/"
 #define FILE_EXTENSION ".json"
 
 //--------------------------------------------------------------------------------------------------
@@ -68,7 +72,6 @@
 #define JSON_MSGLEN "msgLen"
 #define JSON_TIMESTAMP "timestamp"
 #define JSON_ISUNREAD "isUnread"
-#define JSON_ISDELETED "isDeleted"
 #define JSON_MSGINBOX "msgInBox"
 
 //--------------------------------------------------------------------------------------------------
@@ -76,7 +79,7 @@
  * Maximum number of user applications.
  */
 //--------------------------------------------------------------------------------------------------
-#define MAX_APPS 16
+#define MAX_APPS MSGSTORE_MAX_MBOX
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -125,40 +128,10 @@ typedef uint32_t MessageId_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    json_t* jsonObjPtr;
-    json_t* jsonArrayPtr;
-    uint32_t currentMessageIndex;
-    uint32_t maxIndex;
+    MessageId_t nextMessageId;      ///< Message returned by the next GetNext call, 0 if none
 }
 BrowseCtx_t;
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Entry description structure.
- *
- */
-//--------------------------------------------------------------------------------------------------
-typedef struct
-{
-    enum
-    {
-        DESC_INT,
-        DESC_STRING,
-        DESC_BOOL
-    }                               type;       ///< Union type (string or integer
-    union
-    {
-        struct
-        {
-            char*   strPtr;                     ///< String
-            size_t  lenStr;                     ///< Length of the string
-        }                  str;                 ///< Value for string
-        uint32_t           val;                 ///< Value for integer
-        bool               boolVal;             ///< Boolean value
-    }                               uVal;       ///< Union type
-}
-EntryDesc_t;
-
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -299,11 +272,11 @@ static char SimImsi[LE_SIM_IMSI_BYTES];
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Next message Identifier
+ * Is the message store open.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static MessageId_t NextMessageId = 1;
+static bool IsStoreOpen = false;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -322,124 +295,16 @@ static le_ref_MapRef_t ActivationRequestRefMap;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add a boolean value of a key in a Jason object
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t AddBooleanKeyInJsonObject
-(
-    json_t *jsonObjPtr, ///<[IN] json object
-    const char* key,    ///<[IN] Key to be added
-    bool value          ///<[IN] Value to be added
-)
-{
-    json_t *jsonBoolPtr;
-    int ret = -1;
-
-    if ( value == true )
-    {
-        jsonBoolPtr = json_true();
-    }
-    else
-    {
-        jsonBoolPtr = json_false();
-    }
-
-    if (jsonBoolPtr)
-    {
-        ret = json_object_set_new(jsonObjPtr, key, jsonBoolPtr);
-    }
-    else
-    {
-        LE_ERROR("Error during set of the key %s", key);
-    }
-
-    if (ret == 0)
-    {
-        return LE_OK;
-    }
-    else
-    {
-        return LE_FAULT;
-    }
-}
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Add an integer value of a key in a Jason object
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t AddIntegerKeyInJsonObject
-(
-    json_t *jsonObjPtr, ///<[IN] json object
-    const char* key,    ///<[IN] Key to be added
-    int  value          ///<[IN] Value to be added
-)
-{
-    json_t *jsonIntPtr = json_integer(value);
-    int ret = -1;
-
-    if (jsonIntPtr)
-    {
-        if (json_is_array(jsonObjPtr))
-        {
-            ret = json_array_append_new(jsonObjPtr, jsonIntPtr);
-        }
-        else
-        {
-            ret = json_object_set_new(jsonObjPtr, key, jsonIntPtr);
-        }
-    }
-    else
-    {
-        LE_ERROR("Error during set of the key %s", key);
-    }
-
-    if (ret == 0)
-    {
-        return LE_OK;
-    }
-    else
-    {
-        return LE_FAULT;
-    }
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Add a string value of a key in a Jason object
+ * Get the index of a message box, which identifies it in the message store
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddStringKeyInJsonObject
+static uint32_t GetMboxIndex
 (
-    json_t *jsonObjPtr, ///<[IN] json object
-    const char* key,    ///<[IN] Key to be added
-    char* string        ///<[IN] String to be added
+    MboxCtx_t* mboxCtxPtr   ///<[IN] message box
 )
 {
-    json_t * jsonStrPtr = json_string(string);
-    int ret = -1;
-
-    if (jsonStrPtr)
-    {
-        ret = json_object_set_new(jsonObjPtr, key, jsonStrPtr);
-    }
-    else
-    {
-        LE_ERROR("Error during set of the key %s", key);
-    }
-
-    if (ret == 0)
-    {
-        return LE_OK;
-    }
-    else
-    {
-        return LE_FAULT;
-    }
+    return mboxCtxPtr - Apps;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -506,814 +371,420 @@ static void GetSMSInboxConfigPath
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Modify Json object
+ * Check if a message belongs to a message box
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ModifyJsonObj
+static le_result_t CheckMessageIdInMbox
 (
-    json_t* jsonObjPtr,         ///<[IN] Json object (root object)
-    json_t* jsonValPtr,         ///<[IN] Json value to be modified
-    char*   key,                ///<[IN] Key to modify
-    EntryDesc_t * modifPtr      ///<[IN] Requested modification
+    MboxCtx_t* mboxCtxPtr,      ///<[IN] message box
+    MessageId_t messageId       ///<[IN] Message identifier
 )
 {
-    int res = 0;
-
-    if (jsonValPtr == NULL)
-    {
-        return LE_FAULT;
-    }
-
-    switch (modifPtr->type)
+    if (!MsgStore_IsInMbox(messageId, GetMboxIndex(mboxCtxPtr)))
     {
-        case DESC_STRING:
-            // check the type
-            if (json_is_string(jsonValPtr) == false)
-            {
-                LE_ERROR("Bad key format");
-                res = -1;
-            }
-
-            if ( res == 0 )
-            {
-                res = json_string_set(jsonValPtr, modifPtr->uVal.str.strPtr);
-            }
-        break;
-        case DESC_INT:
-            // check the type
-            if (json_is_integer(jsonValPtr) == false )
-            {
-                LE_ERROR("Bad key format");
-                res = -1;
-            }
-
-            if ( res == 0 )
-            {
-                res = json_integer_set(jsonValPtr, modifPtr->uVal.val);
-            }
-        break;
-        case DESC_BOOL:
-            // check the type
-            if ( (json_is_true(jsonValPtr) != true) && (json_is_false(jsonValPtr) != true) )
-            {
-                LE_ERROR("Bad key format");
-                res = -1;
-            }
-
-            if (( res == 0 ) &&
-                (AddBooleanKeyInJsonObject(jsonObjPtr, key, modifPtr->uVal.boolVal) != LE_OK))
-            {
-                res = -1;
-            }
-        break;
-        default:
-            res = -1;
-        break;
-    }
-
-    if (res < 0)
-    {
-        LE_ERROR(("Update error %d"), modifPtr->type);
+        LE_ERROR("Bad msg id or mbox name");
         return LE_FAULT;
     }
-    else
-    {
-        return LE_OK;
-    }
 
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Modify message file
+ * Read a message of a message box. A message which can't be read is removed from the message box.
  *
+ * @return
+ *      - Pointer to the message, valid until the next call to a MsgStore function
+ *      - NULL on error
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ModifyMsgEntry
+static const MsgStore_Msg_t* ReadMsgEntry
 (
-    MessageId_t messageId,      ///<[IN] Message identifier to be modified
-    char* keyPtr[],              ///<[IN] Key to modify
-    uint8_t nbKey,              ///<[IN] Number of elements in keyPtr
-    EntryDesc_t * modifPtr      ///<[IN] Requested modification
+    MboxCtx_t* mboxCtxPtr,      ///<[IN] message box
+    MessageId_t messageId       ///<[IN] Message identifier to read
 )
 {
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path, 0, pathLen);
-    json_error_t error;
-    le_result_t res;
-    int indexKey = -1;
+    const MsgStore_Msg_t* msgPtr = MsgStore_Read(messageId);
 
-    GetSMSInboxMessagePath(messageId, path, pathLen);
-
-    json_t* jsonRootPtr = json_load_file(path, 0, &error);
-
-    if ( jsonRootPtr == NULL )
+    if (msgPtr == NULL)
     {
-        LE_ERROR("json decoder error %s", error.text);
-        return LE_FAULT;
+        LE_ERROR("Unable to read message %08x", (int) messageId);
+        MsgStore_Remove(messageId, GetMboxIndex(mboxCtxPtr));
     }
 
-    json_t* jsonValPtr = jsonRootPtr;
-    json_t* jsonSubObjPtr = jsonRootPtr;
-
-    while ( ( json_is_object(jsonValPtr) == true ) && ( nbKey > indexKey ) )
-    {
-        indexKey++;
-        jsonSubObjPtr = jsonValPtr;
-        jsonValPtr = json_object_get(jsonSubObjPtr, keyPtr[indexKey]);
-    }
-
-    if ( !jsonValPtr )
-    {
-        if ((indexKey > -1) && (indexKey < nbKey))
-        {
-            LE_ERROR("Unable to get the object %s", keyPtr[indexKey]);
-        }
-        else
-        {
-            LE_ERROR("indexKey: %d is out of range", indexKey);
-        }
-
-        res = LE_FAULT;
-    }
-    else
-    {
-        res = ModifyJsonObj(jsonSubObjPtr, jsonValPtr, keyPtr[indexKey], modifPtr);
-    }
+    return msgPtr;
+}
 
-    if ( res == LE_OK )
-    {
-        if (json_dump_file(jsonRootPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0)
-        {
-            LE_ERROR("json error");
-            res = LE_FAULT;
-        }
-    }
-    else
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a string field of a message
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the buffer is too small
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CopyMsgString
+(
+    const char* srcPtr,     ///<[IN] string field
+    char* dstPtr,           ///<[OUT] buffer
+    size_t dstSize          ///<[IN] buffer size
+)
+{
+    if (strlen(srcPtr) >= dstSize)
     {
-        LE_ERROR("Something was wrong in ModifyJsonObj");
+        LE_ERROR("String too long");
+        return LE_OVERFLOW;
     }
 
-    json_decref(jsonRootPtr);
+    strcpy(dstPtr, srcPtr);
 
-    return res;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read Json object
+ * Encode a SMS in a message store entry
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ReadJsonObj
+static void EncodeMsgEntry
 (
-    json_t* jsonValPtr,         ///<[IN] Json value to be read
-    char* keyPtr[],             ///<[IN] Key to read
-    uint8_t nbKey,              ///<[IN] Number of elements in keyPtr
-    EntryDesc_t * decodePtr     ///<[OUT] Decoding result
+    le_sms_MsgRef_t msgRef,     ///<[IN] SMS to be encoding
+    MsgStore_Msg_t* msgPtr      ///<[OUT] message store entry
 )
 {
-    le_result_t res = LE_OK;
+    memset(msgPtr, 0, sizeof(MsgStore_Msg_t));
 
-    if ( jsonValPtr == NULL )
-    {
-        LE_ERROR("No information");
-        return LE_FAULT;
-    }
+    // Add imsi
+    le_utf8_Copy(msgPtr->imsi, SimImsi, sizeof(msgPtr->imsi), NULL);
+
+    // Add sms format
+    le_sms_Format_t format = le_sms_GetFormat(msgRef);
+    msgPtr->format = format;
 
-    switch json_typeof(jsonValPtr)
+    switch ( format )
     {
-        case JSON_STRING:
+        case LE_SMS_FORMAT_TEXT:
+        case LE_SMS_FORMAT_BINARY:
         {
-            if ( decodePtr->type != DESC_STRING )
+            // Add phone number
+            le_result_t result = le_sms_GetSenderTel(msgRef, msgPtr->senderTel,
+                                                     sizeof(msgPtr->senderTel));
+
+            if (result != LE_OK)
             {
-                res = LE_FAULT;
-                LE_ERROR("Bad format");
+                LE_ERROR("Unable to get the tel number %d", result);
             }
-
-            if (res == LE_OK)
+            else
             {
-                const char* strPtr = json_string_value((const json_t *)jsonValPtr);
-
-                if ( strlen(strPtr) >= decodePtr->uVal.str.lenStr )
-                {
-                    LE_ERROR("String too long");
-                    res = LE_OVERFLOW;
-                }
-                else
-                {
-                    strncpy(decodePtr->uVal.str.strPtr, strPtr, decodePtr->uVal.str.lenStr);
-                    decodePtr->uVal.str.lenStr = strlen(strPtr);
-                }
+                LE_DEBUG("tel num: %s", msgPtr->senderTel);
+                msgPtr->flags |= MSGSTORE_HAS_SENDERTEL;
             }
-        }
-        break;
-        case JSON_INTEGER:
-        {
-            if ( decodePtr->type != DESC_INT )
+
+            // Add timestamp
+            result = le_sms_GetTimeStamp(msgRef, msgPtr->timestamp, sizeof(msgPtr->timestamp));
+
+            if (result != LE_OK)
             {
-                LE_ERROR("Bad format");
-                res = LE_FAULT;
+                LE_ERROR("Unable to get the timestamp %d", result);
             }
             else
             {
-                decodePtr->uVal.val = json_integer_value((const json_t *)jsonValPtr);
+                LE_DEBUG("timestamp: %s", msgPtr->timestamp);
+                msgPtr->flags |= MSGSTORE_HAS_TIMESTAMP;
             }
-        }
-        break;
-        case JSON_TRUE:
-        case JSON_FALSE:
-        {
-            if ( decodePtr->type != DESC_BOOL )
+
+            msgPtr->msgLen = le_sms_GetUserdataLen(msgRef);
+
+            if (format == LE_SMS_FORMAT_TEXT)
             {
-                LE_ERROR("Bad format");
-                res = LE_FAULT;
+                // Get text
+                result = le_sms_GetText(msgRef, (char*) msgPtr->data, sizeof(msgPtr->data));
+                msgPtr->dataLen = strnlen((char*) msgPtr->data, sizeof(msgPtr->data));
             }
             else
             {
-                decodePtr->uVal.boolVal = json_is_true((const json_t *)jsonValPtr);
+                // Get binary
+                size_t len = sizeof(msgPtr->data);
+                result = le_sms_GetBinary(msgRef, msgPtr->data, &len);
+                msgPtr->dataLen = len;
             }
-        }
-        break;
-        case JSON_OBJECT:
-        {
-            // if key-value is an object, read the next key
-            if (nbKey >= 1)
-            {
-                json_t* jsonSubValPtr = json_object_get(jsonValPtr, keyPtr[0]);
 
-                if ( jsonSubValPtr )
-                {
-                    res = ReadJsonObj(jsonSubValPtr, &keyPtr[1], nbKey-1,  decodePtr );
-                }
-                else
-                {
-                    res = LE_FAULT;
-                }
+            if (result != LE_OK)
+            {
+                LE_ERROR("Unable to get payload %d", result);
+                msgPtr->msgLen = 0;
+                msgPtr->dataLen = 0;
             }
             else
             {
-                res = LE_FAULT;
+                msgPtr->flags |= MSGSTORE_HAS_DATA;
             }
         }
         break;
-        case JSON_ARRAY:
-        case JSON_REAL:
-        case JSON_NULL:
-        default:
-            res = LE_FAULT;
-        break;
-    }
-
-    return res;
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Read Application's config file
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t GetMsgListFromMbox
-(
-    char* pathPtr,              ///<[IN] Application's config file path
-    json_t **jsonRootObjPtr,    ///<[OUT] json root object
-    json_t **jsonArrayPtr       ///<[OUT] messages in box list
-)
-{
-    json_error_t error;
-    *jsonRootObjPtr = json_load_file(pathPtr, 0, &error);
-
-    if ( !(*jsonRootObjPtr) )
-    {
-        // File doesn't exist, create objects
-        *jsonRootObjPtr = json_object();
-
-        if ( !(*jsonRootObjPtr) )
-        {
-            LE_ERROR("json error");
-            return LE_FAULT;
-        }
-    }
-
-    *jsonArrayPtr = json_object_get(*jsonRootObjPtr, JSON_MSGINBOX);
-
-    if ( !(*jsonArrayPtr) )
-    {
-        // Array doesn't exist, create it
-        *jsonArrayPtr = json_array();
-
-        if (!(*jsonArrayPtr))
-        {
-            json_decref(*jsonRootObjPtr);
-            LE_ERROR("json error");
-            return LE_FAULT;
-        }
 
-        if ( json_object_set(*jsonRootObjPtr, JSON_MSGINBOX, *jsonArrayPtr) < 0 )
+        case LE_SMS_FORMAT_PDU:
         {
-            json_decref(*jsonRootObjPtr);
-            LE_ERROR("json error");
-            return LE_FAULT;
-        }
-    }
+            msgPtr->msgLen = le_sms_GetPDULen(msgRef);
 
-    return LE_OK;
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Remove a message from the application's cfg file
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t DeleteMsgInAppCfg
-(
-    char *appNamePtr,               ///<[IN] application name
-    MessageId_t deleteMessageId     ///<[IN] message to delete
-)
-{
-    uint32_t pathLen = GetSMSInboxConfigPathLen(appNamePtr);
-    char path[pathLen];
-    memset(path,0,pathLen);
-    GetSMSInboxConfigPath(appNamePtr, path, pathLen);
-    json_t *jsonObjPtr;
-    json_t *jsonArrayPtr;
-
-    if (GetMsgListFromMbox(path, &jsonObjPtr, &jsonArrayPtr) != LE_OK)
-    {
-        return LE_FAULT;
-    }
-
-    int i;
-    MessageId_t messageId;
-
-    for (i=0; i < json_array_size(jsonArrayPtr); i++)
-    {
-        json_t * jsonIntegerPtr = json_array_get(jsonArrayPtr, i);
-
-        if (jsonIntegerPtr)
-        {
-            messageId = json_integer_value(jsonIntegerPtr);
+            // Add pdu
+            size_t len = sizeof(msgPtr->data);
+            le_result_t result = le_sms_GetPDU(msgRef, msgPtr->data, &len);
 
-            if (messageId == deleteMessageId)
+            if (result != LE_OK)
             {
-                LE_DEBUG("Remove %d", (int) messageId);
-                json_array_remove(jsonArrayPtr, i);
+                LE_ERROR("Unable to get pdu %d", result);
+                msgPtr->msgLen = 0;
+            }
+            else
+            {
+                msgPtr->dataLen = len;
+                msgPtr->flags |= MSGSTORE_HAS_DATA;
             }
         }
-        else
-        {
-            LE_ERROR("Json error");
-        }
-    }
-
-    le_result_t res = LE_OK;
-    if ( json_dump_file(jsonObjPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0 )
-    {
-        res = LE_FAULT;
+        break;
+        case LE_SMS_FORMAT_UNKNOWN:
+        default:
+            LE_ERROR("Bad format %d", format);
     }
-
-    json_decref(jsonObjPtr);
-
-    return res;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Check if a message belongs to a message box
+ * Create a new message entry, and add it in the message box of all the applications. The oldest
+ * message of a full message box is removed from it.
  *
  */
 //--------------------------------------------------------------------------------------------------
-
-le_result_t CheckMessageIdInMbox
+static le_result_t CreateMsgEntry
 (
-    char* mboxName,
-    MessageId_t messageId
+    le_sms_MsgRef_t msgRef,     ///<[IN] SMS to be stored
+    MessageId_t *msgPtr         ///<[OUT] create messageId
 )
 {
-    json_t *jsonRootObjPtr;
-    json_t *jsonArrayPtr;
-    uint32_t pathLen = GetSMSInboxConfigPathLen(mboxName);
-    char path[pathLen];
-    GetSMSInboxConfigPath(mboxName, path, pathLen);
+    MsgStore_Msg_t msg;
+    uint16_t mboxMask = 0;
+    uint32_t i;
 
-    if ( GetMsgListFromMbox(path, &jsonRootObjPtr, &jsonArrayPtr) != LE_OK )
-    {
-        LE_ERROR("Error in GetMsgListFromMbox");
-        return LE_FAULT;
-    }
+    EncodeMsgEntry(msgRef, &msg);
 
-    int i = 0;
-
-    while (i < json_array_size(jsonArrayPtr))
+    // For all the applications
+    for (i = 0; i < MAX_APPS; i++)
     {
-        json_t * jsonIntegerPtr = json_array_get(jsonArrayPtr, i);
-        MessageId_t msgId = 0;
-
-        if (jsonIntegerPtr)
-        {
-            msgId = json_integer_value(jsonIntegerPtr);
-        }
-        else
+        if ( Apps[i].namePtr && strlen(Apps[i].namePtr) && Apps[i].inboxSize )
         {
-            LE_ERROR("json error");
-            json_decref(jsonRootObjPtr);
-            return LE_FAULT;
-        }
+            while (MsgStore_GetCount(i) >= Apps[i].inboxSize)
+            {
+                // delete older entry
+                uint32_t nextId;
 
-        if (msgId == messageId)
-        {
-            json_decref(jsonRootObjPtr);
-            return LE_OK;
-        }
+                if (MsgStore_Remove(MsgStore_Browse(i, 0, &nextId), i) != LE_OK)
+                {
+                    LE_ERROR("Unable to remove the oldest message of %s", Apps[i].namePtr);
+                    break;
+                }
+            }
 
-        i++;
+            mboxMask |= 1 << i;
+        }
     }
 
-    LE_ERROR("Bad msg id or mbox name");
-    json_decref(jsonRootObjPtr);
-    return LE_FAULT;
-}
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Decode message file
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t DecodeMsgEntry
-(
-    char* mboxName,                      ///<[IN] mbox name
-    MessageId_t messageId,               ///<[IN] Message identifier to decode
-    char* keyPtr[],                      ///<[IN] Key to retrieve
-    uint8_t nbKey,                       ///<[IN] Number of elements in keyPtr
-    EntryDesc_t * decodePtr              ///<[IN/OUT] Decoding result
-)
-{
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path, 0, pathLen);
-    json_error_t error;
-    le_result_t res = LE_OK;
-
-    GetSMSInboxMessagePath(messageId, path, pathLen);
-
-    json_t* jsonRootPtr = json_load_file(path, JSON_REJECT_DUPLICATES, &error);
-
-    if ( jsonRootPtr == NULL )
+    if (MsgStore_Add(&msg, mboxMask, msgPtr) != LE_OK)
     {
-        LE_ERROR("json decoder error %s", error.text);
-        DeleteMsgInAppCfg(mboxName, messageId);
+        LE_ERROR("Unable to store the message");
         return LE_FAULT;
     }
 
-    res = ReadJsonObj(jsonRootPtr, keyPtr, nbKey, decodePtr);
-
-    json_decref(jsonRootPtr);
+    LE_DEBUG("New entry: %08x", (int) *msgPtr);
 
-    return res;
+    return LE_OK;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Check if an application requested the deletion of a message
+ * Convert the file name string in hexa
  *
  */
 //--------------------------------------------------------------------------------------------------
-static bool IsDeleted
+static MessageId_t GetMessageId
 (
-    MessageId_t messageId,  ///<[IN] Message identifier
-    char* appNamePtr        ///<[IN] Application name
+    char* fileName  ///<[IN] file name to be converted
 )
 {
-    EntryDesc_t decode;
-    decode.type = DESC_BOOL;
-    char* key[2] = {JSON_ISDELETED, appNamePtr};
-
-    if (DecodeMsgEntry(appNamePtr, messageId, key, 2, &decode) == LE_OK)
-    {
-        return decode.uVal.boolVal;
-    }
-    else
-    {
-        // if error, delete the message
-        return true;
-    }
+    char *savePtr;
+    char *str = strtok_r(fileName,".", &savePtr);
+    return le_hex_HexaToInteger(str);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Perform the deleteion
+ * Compare two message identifiers (for qsort and bsearch)
  *
  */
 //--------------------------------------------------------------------------------------------------
-static void PerformDeletion
+static int CompareMessageId
 (
-    MessageId_t messageId   ///<[IN] Message identifier
+    const void* aPtr,
+    const void* bPtr
 )
 {
-    int i;
-    bool deleted = true;
-
-    for (i=0; i < MAX_APPS; i++)
-    {
-        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
-        {
-            deleted &= IsDeleted(messageId, Apps[i].namePtr);
-        }
-    }
-
-    // All applications mark this message to be delteted => erase physically the message
-    if (deleted)
-    {
-        uint16_t pathLen = GetSMSInboxMessagePathLen();
-        char path[pathLen];
-        memset(path,0,pathLen);
-
-        GetSMSInboxMessagePath(messageId, path, pathLen);
+    MessageId_t a = *(const MessageId_t*) aPtr;
+    MessageId_t b = *(const MessageId_t*) bPtr;
 
-        unlink(path);
-    }
+    return (a > b) - (a < b);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add a message in the application's cfg file
+ * Read the sorted message identifiers of an application's Jansson config file
  *
+ * @return
+ *      - Message identifiers, to be freed with free()
+ *      - NULL if the file doesn't exist or is empty
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddMsgInAppCfg
+static MessageId_t* GetJsonMsgList
 (
-    MboxCtx_t* appsPtr,         ///<[IN] application config
-    MessageId_t messageId     ///<[IN] message to add
+    char* appNamePtr,           ///<[IN] application name
+    size_t* nbMsgPtr            ///<[OUT] number of messages
 )
 {
-    uint32_t pathLen = GetSMSInboxConfigPathLen(appsPtr->namePtr);
+    uint32_t pathLen = GetSMSInboxConfigPathLen(appNamePtr);
     char path[pathLen];
-    GetSMSInboxConfigPath(appsPtr->namePtr, path, pathLen);
-    json_t* jsonMsgIdPtr = NULL;
-    json_t* jsonPtr;
-    json_t* jsonArrayPtr;
-
-    if ( GetMsgListFromMbox (path, &jsonPtr, &jsonArrayPtr) != LE_OK )
-    {
-        return LE_FAULT;
-    }
+    GetSMSInboxConfigPath(appNamePtr, path, pathLen);
+    json_error_t error;
+    MessageId_t* msgListPtr = NULL;
 
-    if ( json_array_size(jsonArrayPtr) == appsPtr->inboxSize )
-    {
-        // delete older entry
-        jsonMsgIdPtr = json_array_get(jsonArrayPtr, 0);
-        MessageId_t messageId = 0;
+    *nbMsgPtr = 0;
 
-        if (jsonMsgIdPtr)
-        {
-            messageId = json_integer_value(jsonMsgIdPtr);
-        }
+    json_t* jsonRootObjPtr = json_load_file(path, 0, &error);
 
-        if (messageId != 0)
-        {
-            json_array_remove(jsonArrayPtr, 0);
+    if (!jsonRootObjPtr)
+    {
+        return NULL;
+    }
 
-            EntryDesc_t modif;
-            modif.type = DESC_BOOL;
-            modif.uVal.boolVal = true;
-            char* key[2]={JSON_ISDELETED, appsPtr->namePtr};
+    json_t* jsonArrayPtr = json_object_get(jsonRootObjPtr, JSON_MSGINBOX);
+    size_t size = json_array_size(jsonArrayPtr);
 
-            if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
-            {
-                LE_ERROR("Can't modify entry %08x", (int) messageId);
-            }
+    if (size > 0)
+    {
+        msgListPtr = malloc(size * sizeof(MessageId_t));
+        LE_ASSERT(msgListPtr);
 
-            PerformDeletion(messageId);
-        }
-        else
+        size_t i;
+        for (i = 0; i < size; i++)
         {
-            json_decref(jsonPtr);
-            LE_ERROR("json error");
-            return LE_FAULT;
+            msgListPtr[i] = json_integer_value(json_array_get(jsonArrayPtr, i));
         }
-    }
 
-    if (AddIntegerKeyInJsonObject(jsonArrayPtr, NULL, messageId) != LE_OK)
-    {
-        json_decref(jsonPtr);
-        LE_ERROR("json error");
-        return LE_FAULT;
+        qsort(msgListPtr, size, sizeof(MessageId_t), CompareMessageId);
+        *nbMsgPtr = size;
     }
 
-    if ( json_dump_file(jsonPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0 )
-    {
-        json_decref(jsonPtr);
-        LE_ERROR("json error");
-        return LE_FAULT;
-    }
-
-    json_decref(jsonPtr);
-
-    // Use for the first initialization
-    if (jsonArrayPtr->refcount > 0)
-    {
-        json_decref(jsonArrayPtr);
-    }
+    json_decref(jsonRootObjPtr);
 
-    return LE_OK;
+    return msgListPtr;
 }
 
-
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Encode Json file
+ * Decode a Jansson message file in a message store entry
  *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the file can't be decoded
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t EncodeMsgEntry
+static le_result_t DecodeJsonMsgEntry
 (
-    uint32_t fd,            ///<[IN] file descriptor
-    le_sms_MsgRef_t msgRef  ///<[IN] SMS to be encoding
+    const char* pathPtr,        ///<[IN] Jansson message file
+    MsgStore_Msg_t* msgPtr,     ///<[OUT] message store entry
+    uint16_t* unreadMaskPtr     ///<[OUT] applications for which the message is unread
 )
 {
-    json_t *jsonRootPtr = json_object();
+    json_error_t error;
+    json_t* jsonRootPtr = json_load_file(pathPtr, JSON_REJECT_DUPLICATES, &error);
+    json_t* jsonValPtr;
+    const char* jsonKey;
+    uint32_t i;
 
-    if (!jsonRootPtr)
+    if ( jsonRootPtr == NULL )
     {
-        LE_ERROR("Json error");
+        LE_ERROR("json decoder error %s", error.text);
         return LE_FAULT;
     }
 
-    // Add imsi in json file
-    AddStringKeyInJsonObject(jsonRootPtr, JSON_IMSI, SimImsi);
+    memset(msgPtr, 0, sizeof(MsgStore_Msg_t));
 
-    // Add sms format in json file
-    le_sms_Format_t format = le_sms_GetFormat(msgRef);
-    AddIntegerKeyInJsonObject(jsonRootPtr, JSON_FORMAT, (int) format);
+    le_utf8_Copy(msgPtr->imsi, json_string_value(json_object_get(jsonRootPtr, JSON_IMSI)) ?: "",
+                 sizeof(msgPtr->imsi), NULL);
+    msgPtr->format = json_integer_value(json_object_get(jsonRootPtr, JSON_FORMAT));
+    msgPtr->msgLen = json_integer_value(json_object_get(jsonRootPtr, JSON_MSGLEN));
 
-    // Unread by default for all applications
-    json_t *jsonUnreadPtr = json_object();
-    int i;
-    for (i=0; i < MAX_APPS; i++)
+    jsonValPtr = json_object_get(jsonRootPtr, JSON_SENDERTEL);
+    if (json_is_string(jsonValPtr))
     {
-        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
-        {
-            AddBooleanKeyInJsonObject(jsonUnreadPtr, Apps[i].namePtr, true);
-        }
+        le_utf8_Copy(msgPtr->senderTel, json_string_value(jsonValPtr),
+                     sizeof(msgPtr->senderTel), NULL);
+        msgPtr->flags |= MSGSTORE_HAS_SENDERTEL;
     }
 
-    json_object_set_new(jsonRootPtr, JSON_ISUNREAD, jsonUnreadPtr);
-
-    // Undeleted by default for all applications
-    json_t *jsonDeletePtr = json_object();
-    for (i=0; i < MAX_APPS; i++)
+    jsonValPtr = json_object_get(jsonRootPtr, JSON_TIMESTAMP);
+    if (json_is_string(jsonValPtr))
     {
-        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
-        {
-            AddBooleanKeyInJsonObject(jsonDeletePtr, Apps[i].namePtr, false);
-        }
+        le_utf8_Copy(msgPtr->timestamp, json_string_value(jsonValPtr),
+                     sizeof(msgPtr->timestamp), NULL);
+        msgPtr->flags |= MSGSTORE_HAS_TIMESTAMP;
     }
-
-    json_object_set_new(jsonRootPtr, JSON_ISDELETED, jsonDeletePtr);
-
-    switch ( format )
-    {
-        case LE_SMS_FORMAT_TEXT:
-        case LE_SMS_FORMAT_BINARY:
-        {
-            char tel[LE_MDMDEFS_PHONE_NUM_MAX_BYTES];
-            memset(tel,0,LE_MDMDEFS_PHONE_NUM_MAX_BYTES);
-
-            // Add phone number
-            le_result_t result = le_sms_GetSenderTel(msgRef, tel, LE_MDMDEFS_PHONE_NUM_MAX_BYTES);
-
-            if (result != LE_OK)
-            {
-                LE_ERROR("Unable to get the tel number %d", result);
-            }
-            else
-            {
-                LE_DEBUG("tel num: %s", tel);
-                AddStringKeyInJsonObject(jsonRootPtr, JSON_SENDERTEL, tel);
-            }
-
-            // Add timestamp
-            char timeStamp[LE_SMS_TIMESTAMP_MAX_BYTES];
-            result = le_sms_GetTimeStamp (msgRef, timeStamp, LE_SMS_TIMESTAMP_MAX_BYTES);
-
-            if (result != LE_OK)
-            {
-                LE_ERROR("Unable to get the timestamp %d", result);
-            }
-            else
-            {
-                LE_DEBUG("timestamp: %s", timeStamp);
-                AddStringKeyInJsonObject(jsonRootPtr, JSON_TIMESTAMP, timeStamp);
-            }
-
-            size_t len = le_sms_GetUserdataLen(msgRef);
-            AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, len);
-
-            // Add a character for last '\0'
-            len++;
-
-            uint8_t bin[len];
-            memset(bin,0,len);
-            int32_t strLen = 2*len + 1;
-            char string[strLen];
-            memset(string,0,strLen);
-            const char* jsonKey;
-
-            if (format == LE_SMS_FORMAT_TEXT)
-            {
-                // Get text
-                result = le_sms_GetText(msgRef, (char*) bin, len);
-                jsonKey = JSON_TEXT;
-            }
-            else
-            {
-                // Get binary
-                result = le_sms_GetBinary(msgRef, bin, &len);
-                jsonKey = JSON_BIN;
-            }
-
-            if (result != LE_OK)
-            {
-                LE_ERROR("Unable to get payload %d", result);
-                AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, 0);
-            }
-            else
-            {
-                // Convert payload in string: json supports only utf-8 characters.
-                // Some extended-ASCII characters can be sent by SMS (such as character with accent)
-                // and can't be convert directly in utf-8. A convertion in string solves this issue.
-                strLen = le_hex_BinaryToString(bin, len, string, strLen);
-                AddStringKeyInJsonObject(jsonRootPtr, jsonKey, string);
-
-            }
-        }
-        break;
-
-        case LE_SMS_FORMAT_PDU:
-        {
-            size_t len = le_sms_GetPDULen(msgRef);
-            AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, len);
-            // Add a character for last '\0'
-            len++;
-            uint8_t pdu[len];
-            memset(pdu,0,len);
-            int32_t strLen = 2*len + 1;
-            char string[strLen];
-            memset(string,0,strLen);
-
-            // Add pdu
-            le_result_t result = le_sms_GetPDU(msgRef, pdu, &len);
-
-            if (result != LE_OK)
-            {
-                LE_ERROR("Unable to get pdu %d", result);
-                AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, 0);
-            }
-            else
-            {
-                // Convert pdu in string
-                strLen = le_hex_BinaryToString(pdu, len, string, strLen);
-                AddStringKeyInJsonObject(jsonRootPtr, JSON_PDU, string);
-            }
-        }
+
+    switch (msgPtr->format)
+    {
+        case LE_SMS_FORMAT_TEXT:
+            jsonKey = JSON_TEXT;
+        break;
+        case LE_SMS_FORMAT_BINARY:
+            jsonKey = JSON_BIN;
         break;
-        case LE_SMS_FORMAT_UNKNOWN:
         default:
-            LE_ERROR("Bad format %d", format);
+            jsonKey = JSON_PDU;
+        break;
     }
 
-    // Write json file in the file system
-    char* jsondumpStr = json_dumps( (const json_t *) jsonRootPtr,
-                                    JSON_INDENT(1) | JSON_PRESERVE_ORDER);
-    if (!jsondumpStr)
+    // The payload is stored as an hexadecimal string
+    jsonValPtr = json_object_get(jsonRootPtr, jsonKey);
+    if (json_is_string(jsonValPtr))
     {
-        LE_ERROR("jsondumpStr is NULL");
-        return LE_FAULT;
+        const char* strPtr = json_string_value(jsonValPtr);
+        int32_t len = le_hex_StringToBinary(strPtr, strlen(strPtr),
+                                            msgPtr->data, sizeof(msgPtr->data));
+
+        if (len >= 0)
+        {
+            msgPtr->dataLen = len;
+            msgPtr->flags |= MSGSTORE_HAS_DATA;
+        }
     }
 
-    char* restJsondumpStr = jsondumpStr;
-    ssize_t writeSize = strlen(jsondumpStr);
-    ssize_t writtenSize;
+    // The text was stored with its terminating null character
+    if (msgPtr->format == LE_SMS_FORMAT_TEXT)
+    {
+        msgPtr->dataLen = strnlen((char*) msgPtr->data, msgPtr->dataLen);
+    }
 
-    do
+    *unreadMaskPtr = 0;
+    jsonValPtr = json_object_get(jsonRootPtr, JSON_ISUNREAD);
+    for (i = 0; i < MAX_APPS; i++)
     {
-        writtenSize = write( fd, restJsondumpStr, writeSize );
-        if (writtenSize > 0)
+        if ( Apps[i].namePtr && json_is_true(json_object_get(jsonValPtr, Apps[i].namePtr)) )
         {
-            writeSize -= writtenSize;
-            restJsondumpStr += writtenSize;
+            *unreadMaskPtr |= 1 << i;
         }
     }
-    while ((writeSize > 0) && ((writtenSize >= 0) || (EINTR == errno)));
 
-    free(jsondumpStr);
     json_decref(jsonRootPtr);
 
     return LE_OK;
@@ -1321,127 +792,143 @@ static le_result_t EncodeMsgEntry
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a new message entry
+ * Import the Jansson files of the previous versions in the message store, and delete them
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t CreateMsgEntry
+static void ImportJsonFiles
 (
-    MessageId_t *msgPtr,    ///<[OUT] create messageId
-    int32_t *fdPtr         ///<[OUT] Created file descriptor
+    void
 )
 {
+    struct dirent **namelist;
+    MessageId_t* msgListPtr[MAX_APPS] = {NULL};
+    size_t nbMsg[MAX_APPS] = {0};
+    int nbSmsEntries;
+    int nbImported = 0;
+    uint32_t i;
+
     uint16_t pathLen = GetSMSInboxMessagePathLen();
     char path[pathLen];
-    memset(path, 0, pathLen);
-
-    GetSMSInboxMessagePath(NextMessageId, path, pathLen);
+    memset(path,0,pathLen);
+    snprintf(path, pathLen, "%s%s", SMSINBOX_PATH, MSG_PATH);
 
-    *fdPtr = open( path, O_CREAT | O_RDWR | O_SYNC, S_IRUSR | S_IWUSR );
+    nbSmsEntries = scandir(path, &namelist, NULL, alphasort);
 
-    if (*fdPtr < 0)
+    if (nbSmsEntries < 0)
     {
-        LE_ERROR("No such file: %s", path);
-        return LE_FAULT;
+        // Nothing to import
+        return;
     }
 
-    LE_DEBUG("New entry: %s", path);
-
-    int i;
-
-    // For all the applications
     for (i = 0; i < MAX_APPS; i++)
     {
-        if ( Apps[i].namePtr && strlen(Apps[i].namePtr) )
+        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
         {
-            AddMsgInAppCfg(&Apps[i], NextMessageId);
+            msgListPtr[i] = GetJsonMsgList(Apps[i].namePtr, &nbMsg[i]);
         }
     }
 
-    *msgPtr = NextMessageId;
+    int n;
+    for (n = 0; n < nbSmsEntries; n++)
+    {
+        char* namePtr = namelist[n]->d_name;
+        size_t len = strlen(namePtr);
+
+        if ((len > strlen(FILE_EXTENSION)) &&
+            (strcmp(namePtr + len - strlen(FILE_EXTENSION), FILE_EXTENSION) == 0))
+        {
+            char name[len+1];
+            memcpy(name, namePtr, len+1);
+            MessageId_t messageId = GetMessageId(name);
+            uint16_t mboxMask = 0;
+            uint16_t unreadMask;
+            MsgStore_Msg_t msg;
+
+            // The message belongs to the message boxes listing it
+            for (i = 0; i < MAX_APPS; i++)
+            {
+                if ( msgListPtr[i] &&
+                     bsearch(&messageId, msgListPtr[i], nbMsg[i], sizeof(MessageId_t),
+                             CompareMessageId) )
+                {
+                    mboxMask |= 1 << i;
+                }
+            }
 
-    NextMessageId++;
+            GetSMSInboxMessagePath(messageId, path, pathLen);
 
-    return LE_OK;
-}
+            if ((mboxMask != 0) &&
+                (DecodeJsonMsgEntry(path, &msg, &unreadMask) == LE_OK) &&
+                (MsgStore_Import(messageId, &msg, mboxMask, unreadMask) == LE_OK))
+            {
+                nbImported++;
+            }
 
+            unlink(path);
+        }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Convert the file name string in hexa
- *
- */
-//--------------------------------------------------------------------------------------------------
-static MessageId_t GetMessageId
-(
-    char* fileName  ///<[IN] file name to be converted
-)
-{
-    char *savePtr;
-    char *str = strtok_r(fileName,".", &savePtr);
-    return le_hex_HexaToInteger(str);
+        free(namelist[n]);
+    }
+
+    free(namelist);
+
+    for (i = 0; i < MAX_APPS; i++)
+    {
+        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
+        {
+            uint32_t cfgPathLen = GetSMSInboxConfigPathLen(Apps[i].namePtr);
+            char cfgPath[cfgPathLen];
+            GetSMSInboxConfigPath(Apps[i].namePtr, cfgPath, cfgPathLen);
+            unlink(cfgPath);
+        }
+
+        free(msgListPtr[i]);
+    }
+
+    snprintf(path, pathLen, "%s%s", SMSINBOX_PATH, MSG_PATH);
+    rmdir(path);
+    snprintf(path, pathLen, "%s%s", SMSINBOX_PATH, CONF_PATH);
+    rmdir(path);
+
+    LE_INFO("%d messages imported", nbImported);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Init the SMSInBox directory
+ * Open the message store, on first use
  *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the message store can't be opened
  */
 //--------------------------------------------------------------------------------------------------
-static void InitSmsInBoxDirectory
+static le_result_t OpenMsgStore
 (
     void
 )
 {
-    struct dirent **namelist;
-    uint32_t nbSmsEntries;
-
-    LE_DEBUG("InitSmsInBoxDirectory");
-
-    // create directories
-    if (0 > mkdir( SMSINBOX_PATH, S_IRWXU|S_IRWXG ))
-    {
-        LE_ERROR("Unable to create directory %s: %m", SMSINBOX_PATH);
-        return;
-    }
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path,0,pathLen);
-    snprintf(path, pathLen, "%s%s", SMSINBOX_PATH, CONF_PATH);
-    if (0 > mkdir( path, S_IRWXU|S_IRWXG ))
-    {
-        LE_ERROR("Unable to create directory %s: %m", path );
-        return;
-    }
-    memset(path,0,pathLen);
-    snprintf(path, pathLen, "%s%s", SMSINBOX_PATH, MSG_PATH);
-    if (0 > mkdir( path, S_IRWXU|S_IRWXG ))
+    if (IsStoreOpen)
     {
-        LE_ERROR("Unable to create directory %s: %m", path );
-        return;
+        return LE_OK;
     }
 
-
-    nbSmsEntries = scandir(path, &namelist, NULL, alphasort);
-
-    if ( nbSmsEntries > 2 )
+    if (le_dir_MakePath(SMSINBOX_PATH, S_IRWXU|S_IRWXG) != LE_OK)
     {
-        uint8_t len = strlen(namelist[nbSmsEntries-1]->d_name);
-        char name[len+1];
-        memset(name, 0, len+1);
-        strncpy(name, namelist[nbSmsEntries-1]->d_name, len);
-        NextMessageId = GetMessageId(name);
-        NextMessageId++;
-
-        LE_DEBUG("NextMessageId %d", (int) NextMessageId);
+        LE_ERROR("Unable to create directory %s", SMSINBOX_PATH);
+        return LE_FAULT;
     }
 
-    while (nbSmsEntries--)
+    if (MsgStore_Open(SMSINBOX_PATH STORE_FILE, le_smsInbox_NbMbx) != LE_OK)
     {
-        free(namelist[nbSmsEntries]);
+        return LE_FAULT;
     }
 
-    free(namelist);
+    ImportJsonFiles();
+
+    IsStoreOpen = true;
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1455,9 +942,14 @@ static void MoveSmsFromSimToFolder
     void
 )
 {
-    int32_t fd;
     le_result_t result = LE_OK;
 
+    if (OpenMsgStore() != LE_OK)
+    {
+        // Keep the SMS in the SIM
+        return;
+    }
+
     le_sms_MsgListRef_t msgListRef = le_sms_CreateRxMsgList();
 
     if (!msgListRef)
@@ -1472,18 +964,9 @@ static void MoveSmsFromSimToFolder
     {
         MessageId_t msgId;
 
-        result = CreateMsgEntry(&msgId, &fd);
+        result = CreateMsgEntry(smsRef, &msgId);
 
-        if (result == LE_OK)
-        {
-            if ( EncodeMsgEntry(fd, smsRef) != LE_OK )
-            {
-                LE_ERROR("Encoding issue");
-            }
-
-            close(fd);
-        }
-        else
+        if (result != LE_OK)
         {
             LE_ERROR("Error during new entry creation");
         }
@@ -1511,17 +994,14 @@ static void NewSmsMsgHandler
     void*           contextPtr
 )
 {
-    int32_t fd;
     le_result_t result;
     MessageId_t msgId;
 
-    result = CreateMsgEntry(&msgId, &fd);
+    result = OpenMsgStore();
 
     if (result == LE_OK)
     {
-        result = EncodeMsgEntry(fd, msgRef);
-        close(fd);
-
+        result = CreateMsgEntry(msgRef, &msgId);
     }
 
     if (result == LE_OK)
@@ -1718,9 +1198,6 @@ COMPONENT_INIT
     // Retrieve the smsInbox settings from the configuration tree
     LoadInboxSettings();
 
-    // Initialization of the smsInbox directory
-    InitSmsInBoxDirectory();
-
     // Create an event Id for new messages
     RxMsgEventId = le_event_CreateId("RxMsgEventId", sizeof(MessageId_t));
 
@@ -1766,6 +1243,11 @@ SmsInbox_SessionRef_t SmsInbox_Open
         return NULL;
     }
 
+    if (OpenMsgStore() != LE_OK)
+    {
+        return NULL;
+    }
+
     int i;
 
     for (i=0; i < MAX_APPS; i++)
@@ -1937,30 +1419,13 @@ void SmsInbox_DeleteMsg
         return;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = true;
-    char* key[2]={JSON_ISDELETED, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
-    {
-        LE_ERROR("ModifyMsgEntry error");
-    }
-
-    if (DeleteMsgInAppCfg(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId)
-                          != LE_OK)
-    {
-        LE_ERROR("DeleteMsgInAppCfg error");
-    }
-
-    PerformDeletion(messageId);
+    MsgStore_Remove(msgId, GetMboxIndex(clientRequestPtr->mboxSessionPtr->mboxCtxPtr));
 }
 
 
@@ -2008,15 +1473,12 @@ le_result_t SmsInbox_GetImsi
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    le_result_t res;
-
     memset(imsiPtr,0,imsiNumElements);
 
     if ( imsiNumElements < LE_SIM_IMSI_BYTES )
@@ -2024,14 +1486,16 @@ le_result_t SmsInbox_GetImsi
         return LE_OVERFLOW;
     }
 
-    EntryDesc_t decode;
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = imsiPtr;
-    decode.uVal.str.lenStr = imsiNumElements;
-    char* key[1] = {JSON_IMSI};
+    const MsgStore_Msg_t* msgPtr = ReadMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId);
+
+    if (msgPtr == NULL)
+    {
+        return LE_FAULT;
+    }
+
+    le_result_t res = CopyMsgString(msgPtr->imsi, imsiPtr, imsiNumElements);
 
-    if ((res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr,
-                              messageId, key, 1, &decode)) == LE_OK)
+    if (res == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
     }
@@ -2075,27 +1539,24 @@ le_sms_Format_t SmsInbox_GetFormat
         return 0;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return 0;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    decode.type = DESC_INT;
-    char* key[1] = {JSON_FORMAT};
+    const MsgStore_Msg_t* msgPtr = ReadMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId);
 
-    if (DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1,
-                      &decode) == LE_OK)
-    {
-        SmsInbox_MarkRead(sessionRef, msgId);
-        return decode.uVal.val;
-    }
-    else
+    if (msgPtr == NULL)
     {
         return LE_SMSINBOX_FORMAT_UNKNOWN;
     }
+
+    le_sms_Format_t format = msgPtr->format;
+
+    SmsInbox_MarkRead(sessionRef, msgId);
+
+    return format;
 }
 
 
@@ -2140,23 +1601,24 @@ le_result_t SmsInbox_GetSenderTel
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    le_result_t res;
-    EntryDesc_t decode;
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = telPtr;
-    decode.uVal.str.lenStr = telNumElements;
     memset(telPtr,0,telNumElements);
-    char* key[1] = {JSON_SENDERTEL};
 
-    if ((res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key,
-                              1, &decode)) == LE_OK)
+    const MsgStore_Msg_t* msgPtr = ReadMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId);
+
+    if ((msgPtr == NULL) || !(msgPtr->flags & MSGSTORE_HAS_SENDERTEL))
+    {
+        return LE_FAULT;
+    }
+
+    le_result_t res = CopyMsgString(msgPtr->senderTel, telPtr, telNumElements);
+
+    if (res == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
     }
@@ -2210,23 +1672,24 @@ le_result_t SmsInbox_GetTimeStamp
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = timestampPtr;
-    decode.uVal.str.lenStr = timestampNumElements;
     memset(timestampPtr,0,timestampNumElements);
-    char* key[1] = {JSON_TIMESTAMP};
-    le_result_t res;
 
-    if ( (res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId,
-                               key, 1, &decode)) == LE_OK )
+    const MsgStore_Msg_t* msgPtr = ReadMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId);
+
+    if ((msgPtr == NULL) || !(msgPtr->flags & MSGSTORE_HAS_TIMESTAMP))
+    {
+        return LE_FAULT;
+    }
+
+    le_result_t res = CopyMsgString(msgPtr->timestamp, timestampPtr, timestampNumElements);
+
+    if (res == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
     }
@@ -2267,33 +1730,24 @@ size_t SmsInbox_GetMsgLen
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-
-    EntryDesc_t decode;
-    decode.type = DESC_INT;
-    char* key[1] = {JSON_MSGLEN};
-    le_result_t res;
+    const MsgStore_Msg_t* msgPtr = ReadMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId);
 
-    if ( (res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr,
-                                messageId,
-                                key,
-                                1,
-                                &decode)) == LE_OK )
-    {
-        SmsInbox_MarkRead(sessionRef, msgId);
-
-        return decode.uVal.val;
-    }
-    else
+    if (msgPtr == NULL)
     {
         return 0;
     }
+
+    size_t msgLen = msgPtr->msgLen;
+
+    SmsInbox_MarkRead(sessionRef, msgId);
+
+    return msgLen;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2339,42 +1793,35 @@ le_result_t SmsInbox_GetText
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    le_result_t res;
-    size_t len = 2*textNumElements+1;
-    char tmpTextPtr[len];
-    memset(tmpTextPtr,0,len);
     memset(textPtr,0,textNumElements);
 
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = tmpTextPtr;
-    decode.uVal.str.lenStr = len;
-    char* key[1] = {JSON_TEXT};
-
-    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1,
-                         &decode);
+    const MsgStore_Msg_t* msgPtr = ReadMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId);
 
-    if ( res == LE_OK )
+    if ((msgPtr == NULL) ||
+        (msgPtr->format != LE_SMS_FORMAT_TEXT) ||
+        !(msgPtr->flags & MSGSTORE_HAS_DATA))
     {
-        if ( le_hex_StringToBinary(tmpTextPtr,
-                                   decode.uVal.str.lenStr,
-                                   (uint8_t*) textPtr,
-                                   textNumElements ) < 0 )
-        {
-            return LE_FAULT;
-        }
+        return LE_FAULT;
+    }
 
-        SmsInbox_MarkRead(sessionRef, msgId);
+    // Keep room for the terminating null character
+    if (msgPtr->dataLen >= textNumElements)
+    {
+        LE_ERROR("String too long");
+        return LE_OVERFLOW;
     }
 
-    return res;
+    memcpy(textPtr, msgPtr->data, msgPtr->dataLen);
+
+    SmsInbox_MarkRead(sessionRef, msgId);
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2420,46 +1867,35 @@ le_result_t SmsInbox_GetBinary
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    le_result_t res;
-    EntryDesc_t decode;
-    size_t len = 2*(*binNumElementsPtr)+1;
-    char tmpBinPtr[len];
-    memset(tmpBinPtr,0,len);
     memset(binPtr,0,*binNumElementsPtr);
 
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = tmpBinPtr;
-    decode.uVal.str.lenStr = len;
-    char* key[1] = {JSON_BIN};
-
-    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId,
-                         key, 1, &decode);
+    const MsgStore_Msg_t* msgPtr = ReadMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId);
 
-    if ( res == LE_OK )
+    if ((msgPtr == NULL) ||
+        (msgPtr->format != LE_SMS_FORMAT_BINARY) ||
+        !(msgPtr->flags & MSGSTORE_HAS_DATA))
     {
-        int32_t binNumElements = le_hex_StringToBinary(tmpBinPtr,
-                                                    decode.uVal.str.lenStr,
-                                                    binPtr,
-                                                    *binNumElementsPtr);
+        return LE_FAULT;
+    }
 
-        if ( binNumElements < 0 )
-        {
-            return LE_FAULT;
-        }
+    if (msgPtr->dataLen > *binNumElementsPtr)
+    {
+        LE_ERROR("Buffer too small");
+        return LE_OVERFLOW;
+    }
 
-        *binNumElementsPtr = binNumElements;
+    memcpy(binPtr, msgPtr->data, msgPtr->dataLen);
+    *binNumElementsPtr = msgPtr->dataLen;
 
-        SmsInbox_MarkRead(sessionRef, msgId);
-    }
+    SmsInbox_MarkRead(sessionRef, msgId);
 
-    return res;
+    return LE_OK;
 }
 
 
@@ -2509,46 +1945,35 @@ le_result_t SmsInbox_GetPdu
         return 0;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return 0;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    le_result_t res;
-    EntryDesc_t decode;
-    size_t len = 2*(*pduNumElementsPtr)+1;
-    char tmpPduPtr[len];
-    memset(tmpPduPtr,0,len);
     memset(pduPtr,0,*pduNumElementsPtr);
 
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = tmpPduPtr;
-    decode.uVal.str.lenStr = len;
-    char* key[1] = {JSON_PDU};
-
-    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1,
-                         &decode);
+    const MsgStore_Msg_t* msgPtr = ReadMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId);
 
-    if ( res == LE_OK )
+    if ((msgPtr == NULL) ||
+        (msgPtr->format != LE_SMS_FORMAT_PDU) ||
+        !(msgPtr->flags & MSGSTORE_HAS_DATA))
     {
-        int32_t pduNumElements = le_hex_StringToBinary(tmpPduPtr,
-                                                    decode.uVal.str.lenStr,
-                                                    pduPtr,
-                                                    *pduNumElementsPtr);
+        return LE_FAULT;
+    }
 
-        if ( pduNumElements < 0 )
-        {
-            return LE_FAULT;
-        }
+    if (msgPtr->dataLen > *pduNumElementsPtr)
+    {
+        LE_ERROR("Buffer too small");
+        return LE_OVERFLOW;
+    }
 
-        *pduNumElementsPtr = pduNumElements;
+    memcpy(pduPtr, msgPtr->data, msgPtr->dataLen);
+    *pduNumElementsPtr = msgPtr->dataLen;
 
-        SmsInbox_MarkRead(sessionRef, msgId);
-    }
+    SmsInbox_MarkRead(sessionRef, msgId);
 
-    return res;
+    return LE_OK;
 }
 
 
@@ -2583,75 +2008,17 @@ uint32_t SmsInbox_GetFirst
         return 0;
     }
 
-    uint32_t pathLen = GetSMSInboxConfigPathLen(clientRequestPtr->
-                                                mboxSessionPtr->mboxCtxPtr->namePtr);
-    char path[pathLen];
-    memset(path,0,pathLen);
-    GetSMSInboxConfigPath(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, path, pathLen);
-    le_result_t res = LE_OK;
-    MessageId_t messageId=0;
-
-    if ( GetMsgListFromMbox(path,
-                        &clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr,
-                        &clientRequestPtr->mboxSessionPtr->browseCtx.jsonArrayPtr) != LE_OK )
-    {
-        LE_ERROR("error in GetMsgListFromMbox");
-        return 0;
-    }
-
-    clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex =
-                      json_array_size(clientRequestPtr->mboxSessionPtr->browseCtx.jsonArrayPtr);
-
-    LE_DEBUG("maxIndex %d", clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex);
-
-    if ( clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex > 0 )
-    {
-        json_t * jsonIntegerPtr =
-                 json_array_get(clientRequestPtr->mboxSessionPtr->browseCtx.jsonArrayPtr, 0);
+    BrowseCtx_t* browseCtxPtr = &clientRequestPtr->mboxSessionPtr->browseCtx;
 
-        if (jsonIntegerPtr)
-        {
-            messageId = json_integer_value(jsonIntegerPtr);
-        }
-        else
-        {
-            LE_ERROR("json error");
-            res = LE_FAULT;
-        }
+    MessageId_t messageId = MsgStore_Browse(GetMboxIndex(clientRequestPtr->mboxSessionPtr->mboxCtxPtr), 0,
+                                            &browseCtxPtr->nextMessageId);
 
-        if (messageId)
-        {
-            clientRequestPtr->mboxSessionPtr->browseCtx.currentMessageIndex = 1;
-        }
-        else
-        {
-            LE_ERROR("json error");
-            res = LE_FAULT;
-        }
-    }
-    else
+    if (messageId == 0)
     {
-        res = LE_FAULT;
         LE_DEBUG("Empty mbox");
     }
 
-    if (res == LE_FAULT)
-    {
-        if (clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr)
-        {
-            json_decref(clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr);
-        }
-
-        memset(&clientRequestPtr->mboxSessionPtr->browseCtx, 0, sizeof(BrowseCtx_t));
-
-        return 0;
-    }
-    else
-    {
-        return messageId;
-    }
-
-    return 0;
+    return messageId;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2679,60 +2046,23 @@ uint32_t SmsInbox_GetNext
         return LE_BAD_PARAMETER;
     }
 
-    while(clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex !=
-          clientRequestPtr->mboxSessionPtr->browseCtx.currentMessageIndex)
+    if (clientRequestPtr->mboxSessionPtr == NULL)
     {
-        LE_DEBUG("currentIndex %d, maxIndex %d", clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.currentMessageIndex,
-                                                 clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.maxIndex);
-
-        json_t * jsonIntegerPtr = json_array_get(clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.jsonArrayPtr,
-                                                 clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.currentMessageIndex);
-
-        if (jsonIntegerPtr)
-        {
-            MessageId_t messageId = json_integer_value(jsonIntegerPtr);
-
-            if (messageId > 0)
-            {
-                clientRequestPtr->mboxSessionPtr->browseCtx.currentMessageIndex++;
-
-                // Check if the message exist (it may be deleted since the GetFirst call)
-                uint16_t pathLen = GetSMSInboxMessagePathLen();
-                char path[pathLen];
-                memset(path, 0, pathLen);
-                GetSMSInboxMessagePath(messageId, path, pathLen);
-                int32_t fd = open(path, O_RDWR);
+        LE_ERROR("Bad mbox reference");
+        return 0;
+    }
 
-                if (fd >= 0)
-                {
-                    // message is still existing
-                    close(fd);
-                    return messageId;
-                }
+    BrowseCtx_t* browseCtxPtr = &clientRequestPtr->mboxSessionPtr->browseCtx;
 
-                // else continue the parsing
-            }
-            else
-            {
-                LE_ERROR("json error");
-            }
-        }
-        else
-        {
-            LE_ERROR("json error");
-        }
+    // Messages deleted since the GetFirst call are skipped
+    if (browseCtxPtr->nextMessageId == 0)
+    {
+        LE_DEBUG("No more messages");
+        return 0;
     }
 
-    // Parsing end => free the memory
-    LE_DEBUG("No more messages");
-    json_decref(clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr);
-    memset(&clientRequestPtr->mboxSessionPtr->browseCtx, 0, sizeof(BrowseCtx_t));
-
-    return 0;
+    return MsgStore_Browse(GetMboxIndex(clientRequestPtr->mboxSessionPtr->mboxCtxPtr), browseCtxPtr->nextMessageId,
+                           &browseCtxPtr->nextMessageId);
 }
 //--------------------------------------------------------------------------------------------------
 /**
@@ -2771,27 +2101,13 @@ bool SmsInbox_IsUnread
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    decode.type = DESC_BOOL;
-    char* key[] = {JSON_ISUNREAD, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 2,
-                       &decode) == LE_OK)
-    {
-        return decode.uVal.boolVal;
-    }
-    else
-    {
-        LE_ERROR("Error in DecodeMsgEntry");
-        return false;
-    }
+    return MsgStore_IsUnread(msgId, GetMboxIndex(clientRequestPtr->mboxSessionPtr->mboxCtxPtr));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2826,22 +2142,13 @@ void SmsInbox_MarkRead
         return;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = false;
-    char* key[2]={JSON_ISUNREAD, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
-    {
-        LE_ERROR("Error in ModifyMsgEntry");
-    }
+    MsgStore_SetUnread(msgId, GetMboxIndex(clientRequestPtr->mboxSessionPtr->mboxCtxPtr), false);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2876,20 +2183,11 @@ void SmsInbox_MarkUnread
         return;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = true;
-    char* key[2]={JSON_ISUNREAD, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
-    {
-        LE_ERROR("Error in ModifyMsgEntry");
-    }
+    MsgStore_SetUnread(msgId, GetMboxIndex(clientRequestPtr->mboxSessionPtr->mboxCtxPtr), true);
 }
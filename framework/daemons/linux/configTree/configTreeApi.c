@@ -1197,6 +1197,51 @@ void le_cfg_SetBool
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a node and everything below it as a snapshot, or the part of it that fits in the reply
+ *  starting at the given offset.
+ *
+ *  If the path is empty, the iterator's current node will be read.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfg_GetSnapshot
+(
+    le_cfg_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                       ///<      request.
+    le_cfg_IteratorRef_t externalRef,  ///< [IN] Iterator to use as a basis for the transaction.
+    const char* pathPtr,               ///< [IN] Absolute or relative path to read from.
+    uint32_t offset,                   ///< [IN] Offset in the snapshot of the first byte to read.
+    size_t dataSize                    ///< [IN] Maximum number of bytes to read.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Reading a snapshot of the iterator's <%p> current node from offset %" PRIu32 ".",
+             externalRef,
+             offset);
+    LE_DEBUG_IF((pathPtr != NULL) && (strlen(pathPtr) != 0), "** Offset by \"%s\"", pathPtr);
+
+    // Replies are sent before the next request is handled, so one buffer is enough.
+    static uint8_t snapshotBuffer[LE_CFG_SNAPSHOT_LEN];
+
+    ni_IteratorRef_t iteratorRef = GetIteratorFromRef(externalRef);
+    le_result_t result = LE_NOT_FOUND;
+    size_t size = 0;
+    uint32_t totalSize = 0;
+
+    if ((NULL != pathPtr) && (NULL != iteratorRef)
+        && (false == CheckPathForSpecifier(pathPtr)))
+    {
+        size = (dataSize < sizeof(snapshotBuffer)) ? dataSize : sizeof(snapshotBuffer);
+        result = ni_GetSnapshot(iteratorRef, pathPtr, offset, snapshotBuffer, &size, &totalSize);
+    }
+
+    le_cfg_GetSnapshotRespond(commandRef, result, snapshotBuffer, size, totalSize);
+}
+
+
+
+
 
 
 // -------------------------------------------------------------------------------------------------
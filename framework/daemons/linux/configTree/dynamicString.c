@@ -3,7 +3,20 @@
 /**
  *  @file dynamicString.c
  *
- *  A memory pool backed dynamic string API.
+ *  A memory pool backed, interned string API.
+ *
+ *  Each string's text is stored contiguously, null terminated, right after a small header, in one
+ *  block from one of a few memory pools of different block sizes.  The smallest pool that fits the
+ *  text is used, so short strings like most node names only take up one small block.
+ *
+ *  Every string is also filed in the Intern Table, a hash table keyed on the string's text.  Before
+ *  a new string is created the table is checked for an existing string with the same text, and if
+ *  one is found it is shared instead.  Names like "procs", "args" or "envVars" (and values like
+ *  "true") that appear all over a configuration tree are therefore only stored once, and two
+ *  strings can be compared by comparing their references.
+ *
+ *  Strings are reference counted using the memory pool's reference counts.  When the last
+ *  reference to a string is released, the pool destructor removes it from the Intern Table.
  *
  *  Copyright (C) Sierra Wireless Inc.
  *
@@ -16,114 +29,94 @@
 
 
 
-/// This value is stored in the string header block so that the access functions can make sure that
-/// the string is valid.
-#define HEADER_MAGIC 0xdca00acd
-
-
-
-
-/// This macro will use the HEADER_MAGIC value to perform a sanity check on a string object supplied
-/// to this API.
-#define VALIDATE_HEADER(strPtr) \
-    LE_FATAL_IF((strPtr) == NULL, "Trying to access a NULL dynamic string."); \
-    LE_FATAL_IF((strPtr)->head.magic != HEADER_MAGIC, "Corrupted dynamic string detected.");
-
-
-
-
 //--------------------------------------------------------------------------------------------------
 /**
- *  Node that represents the head of a dynamic string.
+ *  A string.  The header is followed by the string's text, which runs to the end of the block.
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct
+typedef struct Dstr
 {
-    int32_t magic;       ///< Safety value.  If this isn't set to HEADER_MAGIC then the string is
-                         ///<   invalid.
-    le_sls_List_t list;  ///< The list of the segments that this string is made up of.
-
-    // TODO: Other quick access stats as needed.  Like byte and char counts.
+    struct Dstr* nextPtr;  ///< Next string in the same Intern Table bucket.
+    uint32_t hash;         ///< Hash of the text.
+    uint16_t numBytes;     ///< Length of the text in bytes, excluding the null terminator.
+    char text[];           ///< The null terminated text.
 }
-HeadNode_t;
-
-
-
-
-/// Define how big the text in a segment is.
-#define SEGMENT_SIZE (size_t)32
+Dstr_t;
 
 
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Strings are made up of pool-allocated segments.  The SEGMENT_SIZE should be tuned for optimal
- *  efficiency.
+ *  One of the memory pools that strings are allocated from.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    char value[SEGMENT_SIZE];  ///< Buffer to hold the actual text of the string.  Each buffer is
-                               ///<   expected to be NULL terminated.
-    le_sls_Link_t link;        ///< Link to the next node in the chain.
+    const char* name;          ///< Name of the memory pool.
+    size_t textBytes;          ///< Largest text that fits, including the null terminator.
+    size_t minObjects;         ///< Number of blocks to expand the pool to at start-up.
+    le_mem_PoolRef_t poolRef;  ///< The memory pool.
 }
-BodyNode_t;
+StringPool_t;
 
 
+/// The string pools, from smallest to largest.  The last one must hold DSTR_MAX_BYTES of text.
+static StringPool_t StringPools[] =
+{
+    { "smallStringPool",  24,             3000, NULL },
+    { "mediumStringPool", 128,            200,  NULL },
+    { "largeStringPool",  DSTR_MAX_BYTES, 20,   NULL },
+};
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- *  These blocks are either string headers or string segments.  This is used so that we can get away
- *  with using only one memory pool.
- *
- *  TODO: Decide if it's worth it staying with this approach, or if it's better to use two pools
- *        afterall.
- */
-//--------------------------------------------------------------------------------------------------
-typedef struct Dstr
-{
-    union
-    {
-        HeadNode_t head;
-        BodyNode_t body;
-    };
-}
-Dstr_t;
 
 
+/// Number of buckets the Intern Table starts with.  Must be a power of two.
+#define INTERN_TABLE_MIN_BUCKETS 256
+
+
+/// The buckets of the Intern Table.  Each bucket is a chain of strings linked through their nextPtr.
+static Dstr_t** InternBucketsPtr = NULL;
 
 
-/// This pool is used to manage the memory used by the dynamic strings.
-static le_mem_PoolRef_t DynamicStringPoolRef = NULL;
+/// Number of buckets in the Intern Table, always a power of two.
+static size_t InternBucketCount = 0;
 
 
-/// Name of the dynamic string memory pool.
-#define CFG_DSTR_POOL_NAME "dynamicStringPool"
+/// Number of strings currently filed in the Intern Table.
+static size_t InternStringCount = 0;
 
 
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Create a new, blank segment ready to be inserted into a string.
+ *  Compute the hash of a string's text.  (This is the 32-bit FNV-1a hash.)
  *
- *  @return A pointer to the newly allocated and initialized segment.
+ *  @return The hash of the text.
  */
 //--------------------------------------------------------------------------------------------------
-static dstr_Ref_t NewSegment
+static uint32_t HashText
 (
-    void
+    const char* textPtr,  ///< [IN] The text to hash.
+    size_t* numBytesPtr   ///< [OUT] Length of the text in bytes, excluding the null terminator.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    dstr_Ref_t newSegmentRef = le_mem_ForceAlloc(DynamicStringPoolRef);
+    const char* startPtr = textPtr;
+    uint32_t hash = 2166136261u;
 
-    memset(newSegmentRef->body.value, 0, SEGMENT_SIZE);
-    newSegmentRef->body.link = LE_SLS_LINK_INIT;
+    while (*textPtr != '\0')
+    {
+        hash ^= (uint8_t)*textPtr;
+        hash *= 16777619u;
+        textPtr++;
+    }
+
+    *numBytesPtr = textPtr - startPtr;
 
-    return newSegmentRef;
+    return hash;
 }
 
 
@@ -131,30 +124,18 @@ static dstr_Ref_t NewSegment
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Get the first segment containing actual string data.  The usage pattern is to first call
- *  FirstSegmentRef on a string.  Then later as you are iterating call NextSegmentRef to return
- *  following segments.  The iteration is complete when NextSegmentRef returns NULL.
+ *  Get the head of the Intern Table bucket that a given hash is filed in.
  *
- *  @return A pointer to the first segment chunk that can contain string data.  Or NULL if the
- *          string contains no data.
+ *  @return Pointer to the bucket's head.
  */
 //--------------------------------------------------------------------------------------------------
-static dstr_Ref_t FirstSegmentRef
+static Dstr_t** GetBucket
 (
-    dstr_Ref_t headRef  ///< [IN] The head of the string.
+    uint32_t hash  ///< [IN] The hash of the text.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    VALIDATE_HEADER(headRef);
-
-    le_sls_Link_t* linkPtr = le_sls_Peek(&headRef->head.list);
-
-    if (linkPtr == NULL)
-    {
-        return NULL;
-    }
-
-    return CONTAINER_OF(linkPtr, Dstr_t, body.link);
+    return &InternBucketsPtr[hash & (InternBucketCount - 1)];
 }
 
 
@@ -162,30 +143,41 @@ static dstr_Ref_t FirstSegmentRef
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Function used while iterating the contents of a dynamic string.  Called to get the next segment
- *  of a string.
- *
- *  @return A pointer to the next segment pointer in the chain.  NULL otherwise.
+ *  Double the number of buckets in the Intern Table, moving all of the strings into the new
+ *  buckets.
  */
 //--------------------------------------------------------------------------------------------------
-static dstr_Ref_t NextSegmentRef
+static void GrowInternTable
 (
-    dstr_Ref_t headRef,    ///< [IN] The head of the string.
-    dstr_Ref_t currentPtr  ///< [IN] The current sub-section of the string.
+    void
 )
 //--------------------------------------------------------------------------------------------------
 {
-    VALIDATE_HEADER(headRef);
-    LE_FATAL_IF(currentPtr == NULL, "Fatal corrupted string iteration detected.");
+    Dstr_t** oldBucketsPtr = InternBucketsPtr;
+    size_t oldBucketCount = InternBucketCount;
+    size_t i;
 
-    le_sls_Link_t* linkPtr = le_sls_PeekNext(&headRef->head.list, &currentPtr->body.link);
+    InternBucketCount = oldBucketCount * 2;
+    InternBucketsPtr = calloc(InternBucketCount, sizeof(Dstr_t*));
+    LE_ASSERT(InternBucketsPtr != NULL);
 
-    if (linkPtr == NULL)
+    for (i = 0; i < oldBucketCount; i++)
     {
-        return NULL;
+        Dstr_t* strPtr = oldBucketsPtr[i];
+
+        while (strPtr != NULL)
+        {
+            Dstr_t* nextPtr = strPtr->nextPtr;
+            Dstr_t** bucketPtr = GetBucket(strPtr->hash);
+
+            strPtr->nextPtr = *bucketPtr;
+            *bucketPtr = strPtr;
+
+            strPtr = nextPtr;
+        }
     }
 
-    return CONTAINER_OF(linkPtr, Dstr_t, body.link);
+    free(oldBucketsPtr);
 }
 
 
@@ -193,29 +185,34 @@ static dstr_Ref_t NextSegmentRef
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Get the first string segment of a string.  If there isn't one, create it and return that
- *  instead.
+ *  Look for a string in the Intern Table.
  *
- *  @return A pointer to the first segment in the string.
+ *  @return The string, or NULL if there is no string with the given text.
  */
 //--------------------------------------------------------------------------------------------------
-static dstr_Ref_t NewOrFirstSegmentRef
+static Dstr_t* FindString
 (
-    dstr_Ref_t headRef  ///< [IN] The head of the string.
+    const char* textPtr,  ///< [IN] The text to look for.
+    size_t numBytes,      ///< [IN] Length of the text in bytes, excluding the null terminator.
+    uint32_t hash         ///< [IN] Hash of the text.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    dstr_Ref_t segmentRef = FirstSegmentRef(headRef);
+    Dstr_t* strPtr = *GetBucket(hash);
 
-    if (segmentRef != NULL)
+    while (strPtr != NULL)
     {
-        return segmentRef;
-    }
+        if (   (strPtr->hash == hash)
+            && (strPtr->numBytes == numBytes)
+            && (memcmp(strPtr->text, textPtr, numBytes) == 0))
+        {
+            return strPtr;
+        }
 
-    segmentRef = NewSegment();
-    le_sls_Stack(&headRef->head.list, &segmentRef->body.link);
+        strPtr = strPtr->nextPtr;
+    }
 
-    return segmentRef;
+    return NULL;
 }
 
 
@@ -223,28 +220,27 @@ static dstr_Ref_t NewOrFirstSegmentRef
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Get the next segment in the string after currentPtr.  If one doesn't exist, one is created and
- *  appended to the string.
+ *  Destructor for strings.  Called by the memory system when the last reference to a string is
+ *  released, to take the string out of the Intern Table.
  */
 //--------------------------------------------------------------------------------------------------
-static dstr_Ref_t NewOrNextSegmentRef
+static void StringDestructor
 (
-    dstr_Ref_t headRef,    ///< [IN] The head of the string.
-    dstr_Ref_t currentPtr  ///< [IN] The current sub-section of the string.
+    void* objectPtr  ///< [IN] The string being freed.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    dstr_Ref_t segmentRef = NextSegmentRef(headRef, currentPtr);
+    Dstr_t* strPtr = objectPtr;
+    Dstr_t** linkPtr = GetBucket(strPtr->hash);
 
-    if (segmentRef != NULL)
+    while (*linkPtr != strPtr)
     {
-        return segmentRef;
+        LE_FATAL_IF(*linkPtr == NULL, "Corrupted dynamic string detected.");
+        linkPtr = &(*linkPtr)->nextPtr;
     }
 
-    segmentRef = NewSegment();
-    le_sls_AddAfter(&headRef->head.list, &currentPtr->body.link, &segmentRef->body.link);
-
-    return segmentRef;
+    *linkPtr = strPtr->nextPtr;
+    InternStringCount--;
 }
 
 
@@ -252,28 +248,41 @@ static dstr_Ref_t NewOrNextSegmentRef
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Truncate any remaining string segments after currentPtr.
+ *  Init the dynamic string API and the internal memory resources it depends on.
  */
 //--------------------------------------------------------------------------------------------------
-static void FreeAnyAfter
+void dstr_Init
 (
-    dstr_Ref_t headRef,    ///< [IN] The head of the string.
-    dstr_Ref_t currentPtr  ///< [IN] The current sub-section of the string.
+    void
 )
 //--------------------------------------------------------------------------------------------------
 {
-    VALIDATE_HEADER(headRef);
-    LE_FATAL_IF(currentPtr == NULL, "Corrupted string free encountered.");
+    LE_DEBUG("** Initialize Dynamic String subsystem.");
 
-    le_sls_Link_t* linkPtr;
+    size_t i;
 
-    while ((linkPtr = le_sls_PeekNext(&headRef->head.list, &currentPtr->body.link)) != NULL)
+    for (i = 0; i < NUM_ARRAY_MEMBERS(StringPools); i++)
     {
-        dstr_Ref_t segmentRef = CONTAINER_OF(linkPtr, Dstr_t, body.link);
+        StringPool_t* poolPtr = &StringPools[i];
 
-        le_sls_RemoveAfter(&headRef->head.list, &currentPtr->body.link);
-        le_mem_Release(segmentRef);
+        poolPtr->poolRef = le_mem_CreatePool(poolPtr->name, sizeof(Dstr_t) + poolPtr->textBytes);
+        le_mem_SetDestructor(poolPtr->poolRef, StringDestructor);
+        le_mem_SetNumObjsToForce(poolPtr->poolRef, 100);    // Grow in chunks of 100 blocks.
+
+        // For now (until pool config is added to the framework), set a minimum size.
+        if (le_mem_GetObjectCount(poolPtr->poolRef) != 0)
+        {
+            LE_WARN("TODO: Remove this code.");
+        }
+        else
+        {
+            le_mem_ExpandPool(poolPtr->poolRef, poolPtr->minObjects);
+        }
     }
+
+    InternBucketCount = INTERN_TABLE_MIN_BUCKETS;
+    InternBucketsPtr = calloc(InternBucketCount, sizeof(Dstr_t*));
+    LE_ASSERT(InternBucketsPtr != NULL);
 }
 
 
@@ -281,51 +290,59 @@ static void FreeAnyAfter
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Init the dynamic string API and the internal memory resources it depends on.
+ *  Get a reference to the string holding the given text, creating the string if it doesn't exist
+ *  yet.  The reference must be released with dstr_Release() when it's no longer needed.
+ *
+ *  @note The text must fit within DSTR_MAX_BYTES, (including the null terminator.)
  */
 //--------------------------------------------------------------------------------------------------
-void dstr_Init
+dstr_Ref_t dstr_NewFromCstr
 (
-    void
+    const char* originalStrPtr  ///< [IN] The orignal C-String to copy.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    LE_DEBUG("** Initialize Dynamic String subsystem.");
-
-    DynamicStringPoolRef = le_mem_CreatePool(CFG_DSTR_POOL_NAME, sizeof(Dstr_t));
-    le_mem_SetNumObjsToForce(DynamicStringPoolRef, 100);    // Grow in chunks of 100 blocks.
+    size_t numBytes;
+    uint32_t hash = HashText(originalStrPtr, &numBytes);
+    Dstr_t* strPtr = FindString(originalStrPtr, numBytes, hash);
 
-    // For now (until pool config is added to the framework), set a minimum size.
-    if (le_mem_GetObjectCount(DynamicStringPoolRef) != 0)
+    if (strPtr != NULL)
     {
-        LE_WARN("TODO: Remove this code.");
+        le_mem_AddRef(strPtr);
+        return strPtr;
     }
-    else
+
+    LE_FATAL_IF(numBytes >= DSTR_MAX_BYTES,
+                "String of %zu bytes is too large, (max %d.)",
+                numBytes,
+                DSTR_MAX_BYTES - 1);
+
+    // Pick the smallest pool that the text fits in.
+    size_t i = 0;
+
+    while (numBytes >= StringPools[i].textBytes)
     {
-        le_mem_ExpandPool(DynamicStringPoolRef, 3000);
+        i++;
     }
-}
 
+    strPtr = le_mem_ForceAlloc(StringPools[i].poolRef);
+    strPtr->hash = hash;
+    strPtr->numBytes = numBytes;
+    memcpy(strPtr->text, originalStrPtr, numBytes + 1);
 
+    Dstr_t** bucketPtr = GetBucket(hash);
 
+    strPtr->nextPtr = *bucketPtr;
+    *bucketPtr = strPtr;
+    InternStringCount++;
 
-//--------------------------------------------------------------------------------------------------
-/**
- *  Create a new and empty dynamic string.
- */
-//--------------------------------------------------------------------------------------------------
-dstr_Ref_t dstr_New
-(
-    void
-)
-//--------------------------------------------------------------------------------------------------
-{
-    dstr_Ref_t newHeadRef = le_mem_ForceAlloc(DynamicStringPoolRef);
-
-    newHeadRef->head.magic = HEADER_MAGIC;
-    newHeadRef->head.list = LE_SLS_LIST_INIT;
+    // Keep the chains short by keeping at least one bucket per string.
+    if (InternStringCount > InternBucketCount)
+    {
+        GrowInternTable();
+    }
 
-    return newHeadRef;
+    return strPtr;
 }
 
 
@@ -333,19 +350,22 @@ dstr_Ref_t dstr_New
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Create a new dynamic string, but make it a copy of the existing C-String.
+ *  Get another reference to an existing string.  The reference must be released with
+ *  dstr_Release() when it's no longer needed.
+ *
+ *  @return The same string reference.
  */
 //--------------------------------------------------------------------------------------------------
-dstr_Ref_t dstr_NewFromCstr
+dstr_Ref_t dstr_NewFromDstr
 (
-    const char* originalStrPtr  ///< [IN] The orignal C-String to copy.
+    const dstr_Ref_t originalStrPtr  ///< [IN] The original dynamic string to copy.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    dstr_Ref_t newStringRef = dstr_New();
+    LE_FATAL_IF(originalStrPtr == NULL, "Trying to access a NULL dynamic string.");
 
-    dstr_CopyFromCstr(newStringRef, originalStrPtr);
-    return newStringRef;
+    le_mem_AddRef(originalStrPtr);
+    return originalStrPtr;
 }
 
 
@@ -353,26 +373,30 @@ dstr_Ref_t dstr_NewFromCstr
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Create a new dynamic string that is a copy of a pre-existing one.
+ *  Look for the string holding the given text, without creating it or taking a reference to it.
+ *
+ *  @return The string, or NULL if no string currently holds that text.
  */
 //--------------------------------------------------------------------------------------------------
-dstr_Ref_t dstr_NewFromDstr
+dstr_Ref_t dstr_Lookup
 (
-    const dstr_Ref_t originalStrPtr  ///< [IN] The original dynamic string to copy.
+    const char* textPtr  ///< [IN] The text to look for.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    dstr_Ref_t newStringRef = dstr_New();
+    size_t numBytes;
+    uint32_t hash = HashText(textPtr, &numBytes);
 
-    dstr_Copy(newStringRef, originalStrPtr);
-    return newStringRef;
+    return FindString(textPtr, numBytes, hash);
 }
 
 
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- *  Free a dynamic string and return it's memory to the pool from whence it came.
+ *  Release a reference to a dynamic string.  Once the last reference is released the string's
+ *  memory is returned to the pool from whence it came.
  */
 //--------------------------------------------------------------------------------------------------
 void dstr_Release
@@ -381,15 +405,7 @@ void dstr_Release
 )
 //--------------------------------------------------------------------------------------------------
 {
-    dstr_Ref_t segmentRef = FirstSegmentRef(strRef);
-
-    while (segmentRef != NULL)
-    {
-        dstr_Ref_t nextSegmentRef = NextSegmentRef(strRef, segmentRef);
-
-        le_mem_Release(segmentRef);
-        segmentRef = nextSegmentRef;
-    }
+    LE_FATAL_IF(strRef == NULL, "Trying to access a NULL dynamic string.");
 
     le_mem_Release(strRef);
 }
@@ -415,41 +431,23 @@ le_result_t dstr_CopyToCstr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    dstr_Ref_t segmentRef = NULL;
+    LE_FATAL_IF(sourceStrRef == NULL, "Trying to access a NULL dynamic string.");
 
-    if (totalCopied)
+    // Fast path, the whole string fits.
+    if (sourceStrRef->numBytes < destStrMax)
     {
-        *totalCopied = 0;
-    }
-
-    for (segmentRef = FirstSegmentRef(sourceStrRef);
-         segmentRef != NULL;
-         segmentRef = NextSegmentRef(sourceStrRef, segmentRef))
-    {
-        size_t bytesCopied = 0;
-        le_result_t result = le_utf8_Copy(destStrPtr,
-                                          segmentRef->body.value,
-                                          destStrMax,
-                                          &bytesCopied);
+        memcpy(destStrPtr, sourceStrRef->text, sourceStrRef->numBytes + 1);
 
         if (totalCopied)
         {
-            *totalCopied += bytesCopied;
+            *totalCopied = sourceStrRef->numBytes;
         }
 
-        if (result == LE_OVERFLOW)
-        {
-            return LE_OVERFLOW;
-        }
-
-        LE_FATAL_IF(result != LE_OK, "Unexpected result code returned, %s.", LE_RESULT_TXT(result));
-
-        destStrMax -= bytesCopied;
-        destStrPtr += bytesCopied;
-
+        return LE_OK;
     }
 
-    return LE_OK;
+    // Otherwise, let the utf-8 code take care of truncating at a character boundary.
+    return le_utf8_Copy(destStrPtr, sourceStrRef->text, destStrMax, totalCopied);
 }
 
 
@@ -457,72 +455,21 @@ le_result_t dstr_CopyToCstr
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Copy the contents from a C-style string into a dynamic string.  The dynamic string will
- *  automatically grow or shrink as required.
- */
-//--------------------------------------------------------------------------------------------------
-void dstr_CopyFromCstr
-(
-    dstr_Ref_t destStrRef,    ///< [OUT] The dynamic string to copy to.
-    const char* sourceStrPtr  ///< [IN]  The C-style string to copy from.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    le_result_t result;
-    dstr_Ref_t destSegmentRef = NewOrFirstSegmentRef(destStrRef);
-
-    do
-    {
-        size_t bytesCopied = 0;
-
-        result = le_utf8_Copy(destSegmentRef->body.value,
-                              sourceStrPtr,
-                              SEGMENT_SIZE,
-                              &bytesCopied);
-
-        sourceStrPtr += bytesCopied;
-
-        if (result == LE_OVERFLOW)
-        {
-            destSegmentRef = NewOrNextSegmentRef(destStrRef, destSegmentRef);
-        }
-    }
-    while (result == LE_OVERFLOW);
-
-    FreeAnyAfter(destStrRef, destSegmentRef);
-}
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Copy the contents from one dynamic string to another.  The destination string will automatically
- *  grow or shrink as required.
+ *  Get the hash of a dynamic string's text.  The hash is computed once, when the string is
+ *  created.
+ *
+ *  @return The 32-bit FNV-1a hash of the string's text.
  */
 //--------------------------------------------------------------------------------------------------
-void dstr_Copy
+uint32_t dstr_GetHash
 (
-    dstr_Ref_t destStrPtr,         ///< [OUT] The string to copy into.
-    const dstr_Ref_t sourceStrPtr  ///< [IN]  The string to copy from.
+    const dstr_Ref_t strRef  ///< [IN] The dynamic string object to read.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    dstr_Ref_t sourceSegmentRef = FirstSegmentRef(sourceStrPtr);
-    dstr_Ref_t destSegmentRef = NewOrFirstSegmentRef(destStrPtr);
+    LE_FATAL_IF(strRef == NULL, "Trying to access a NULL dynamic string.");
 
-    while (sourceSegmentRef != NULL)
-    {
-        memcpy(destSegmentRef->body.value, sourceSegmentRef->body.value, SEGMENT_SIZE);
-
-        sourceSegmentRef = NextSegmentRef(sourceStrPtr, sourceSegmentRef);
-        if (sourceSegmentRef != NULL)
-        {
-            destSegmentRef = NewOrNextSegmentRef(destStrPtr, destSegmentRef);
-        }
-    }
-
-    FreeAnyAfter(destStrPtr, destSegmentRef);
+    return strRef->hash;
 }
 
 
@@ -542,15 +489,7 @@ bool dstr_IsNullOrEmpty
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // If we're dealing with a NULL node string the consider it empty.
-    if (strRef == NULL)
-    {
-        return true;
-    }
-
-    // Also, consider the string empty if the first character is NULL.
-    dstr_Ref_t segmentRef = FirstSegmentRef(strRef);
-    return (segmentRef == NULL) || (segmentRef->body.value[0] == '\0');
+    return (strRef == NULL) || (strRef->numBytes == 0);
 }
 
 
@@ -569,21 +508,13 @@ size_t dstr_NumChars
 )
 //--------------------------------------------------------------------------------------------------
 {
-    dstr_Ref_t segmentRef = NULL;
-    size_t count = 0;
+    LE_FATAL_IF(strRef == NULL, "Trying to access a NULL dynamic string.");
 
-    for (segmentRef = FirstSegmentRef(strRef);
-         segmentRef != NULL;
-         segmentRef = NextSegmentRef(strRef, segmentRef))
-    {
-        ssize_t localCount = le_utf8_NumChars(segmentRef->body.value);
+    ssize_t count = le_utf8_NumChars(strRef->text);
 
-        if (localCount == LE_FORMAT_ERROR)
-        {
-            return 0;
-        }
-
-        count += localCount;
+    if (count == LE_FORMAT_ERROR)
+    {
+        return 0;
     }
 
     return count;
@@ -605,15 +536,7 @@ size_t dstr_NumBytes
 )
 //--------------------------------------------------------------------------------------------------
 {
-    dstr_Ref_t segmentRef = NULL;
-    size_t count = 0;
+    LE_FATAL_IF(strRef == NULL, "Trying to access a NULL dynamic string.");
 
-    for (segmentRef = FirstSegmentRef(strRef);
-         segmentRef != NULL;
-         segmentRef = NextSegmentRef(strRef, segmentRef))
-    {
-        count += le_utf8_NumBytes(segmentRef->body.value);
-    }
-
-    return count;
+    return strRef->numBytes;
 }
@@ -3,7 +3,11 @@
 /**
  *  @file dynamicString.h
  *
- *  A memory pool backed dynamic string API.
+ *  A memory pool backed, interned string API.
+ *
+ *  Strings are immutable and shared.  There is only ever one copy of a given text, so two string
+ *  references hold the same text if, and only if, they are the same reference.  To change a string,
+ *  release it and get a new one.
  *
  *  Copyright (C) Sierra Wireless Inc.
  *
@@ -16,6 +20,12 @@
 
 
 
+/// Maximum size of a string's text, in bytes, including the null terminator.
+#define DSTR_MAX_BYTES 512
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  The dynamic string object pointer.
@@ -41,12 +51,15 @@ void dstr_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Create a new and empty dynamic string.
+ *  Get a reference to the string holding the given text, creating the string if it doesn't exist
+ *  yet.  The reference must be released with dstr_Release() when it's no longer needed.
+ *
+ *  @note The text must fit within DSTR_MAX_BYTES, (including the null terminator.)
  */
 //--------------------------------------------------------------------------------------------------
-dstr_Ref_t dstr_New
+dstr_Ref_t dstr_NewFromCstr
 (
-    void
+    const char* originalStrPtr  ///< [IN] The orignal C-String to copy.
 );
 
 
@@ -54,12 +67,15 @@ dstr_Ref_t dstr_New
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Create a new dynamic string, but make it a copy of the existing C-String.
+ *  Get another reference to an existing string.  The reference must be released with
+ *  dstr_Release() when it's no longer needed.
+ *
+ *  @return The same string reference.
  */
 //--------------------------------------------------------------------------------------------------
-dstr_Ref_t dstr_NewFromCstr
+dstr_Ref_t dstr_NewFromDstr
 (
-    const char* originalStrPtr  ///< [IN] The orignal C-String to copy.
+    const dstr_Ref_t originalStrPtr  ///< [IN] The original dynamic string to copy.
 );
 
 
@@ -67,19 +83,23 @@ dstr_Ref_t dstr_NewFromCstr
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Create a new dynamic string that is a copy of a pre-existing one.
+ *  Look for the string holding the given text, without creating it or taking a reference to it.
+ *
+ *  @return The string, or NULL if no string currently holds that text.
  */
 //--------------------------------------------------------------------------------------------------
-dstr_Ref_t dstr_NewFromDstr
+dstr_Ref_t dstr_Lookup
 (
-    const dstr_Ref_t originalStrPtr  ///< [IN] The original dynamic string to copy.
+    const char* textPtr  ///< [IN] The text to look for.
 );
 
 
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- *  Free a dynamic string and return it's memory to the pool from whence it came.
+ *  Release a reference to a dynamic string.  Once the last reference is released the string's
+ *  memory is returned to the pool from whence it came.
  */
 //--------------------------------------------------------------------------------------------------
 void dstr_Release
@@ -112,29 +132,15 @@ le_result_t dstr_CopyToCstr
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Copy the contents from a C-style string into a dynamic string.  The dynamic string will
- *  automatically grow or shrink as required.
- */
-//--------------------------------------------------------------------------------------------------
-void dstr_CopyFromCstr
-(
-    dstr_Ref_t destStrRef,    ///< [OUT] The dynamic string to copy to.
-    const char* sourceStrPtr  ///< [IN]  The C-style string to copy from.
-);
-
-
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Copy the contents from one dynamic string to another.  The destination string will automatically
- *  grow or shrink as required.
+ *  Get the hash of a dynamic string's text.  The hash is computed once, when the string is
+ *  created.
+ *
+ *  @return The 32-bit FNV-1a hash of the string's text.
  */
 //--------------------------------------------------------------------------------------------------
-void dstr_Copy
+uint32_t dstr_GetHash
 (
-    dstr_Ref_t destStrPtr,         ///< [OUT] The string to copy into.
-    const dstr_Ref_t sourceStrPtr  ///< [IN]  The string to copy from.
+    const dstr_Ref_t strRef  ///< [IN] The dynamic string object to read.
 );
 
 
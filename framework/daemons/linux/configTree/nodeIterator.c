@@ -212,6 +212,148 @@ static le_result_t CloneAndAppendPath
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Window of a snapshot to be copied into a client's buffer while the snapshot is being written.
+ *  Bytes outside of the window are only counted, which allows a large snapshot to be read in
+ *  pieces without having to hold all of it in memory.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t* bufferPtr;  ///< The client's buffer.
+    size_t bufferMax;    ///< Size of the client's buffer.
+    size_t offset;       ///< Offset in the snapshot of the first byte of the buffer.
+    size_t size;         ///< Number of bytes written to the snapshot so far.
+}
+SnapshotWriter_t;
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write bytes at a given position of a snapshot.  Only the bytes that fall inside the writer's
+ *  window are actually copied.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteSnapshotBytesAt
+(
+    SnapshotWriter_t* writerPtr,  ///< [IN] The snapshot being written.
+    size_t position,              ///< [IN] Position in the snapshot of the first byte.
+    const void* bytesPtr,         ///< [IN] The bytes to write.
+    size_t numBytes               ///< [IN] How many bytes to write.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t windowEnd = writerPtr->offset + writerPtr->bufferMax;
+    size_t start = (position > writerPtr->offset) ? position : writerPtr->offset;
+    size_t end = ((position + numBytes) < windowEnd) ? (position + numBytes) : windowEnd;
+
+    if (start < end)
+    {
+        memcpy(writerPtr->bufferPtr + (start - writerPtr->offset),
+               (const uint8_t*)bytesPtr + (start - position),
+               end - start);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append bytes to the end of a snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendSnapshotBytes
+(
+    SnapshotWriter_t* writerPtr,  ///< [IN] The snapshot being written.
+    const void* bytesPtr,         ///< [IN] The bytes to append.
+    size_t numBytes               ///< [IN] How many bytes to append.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    WriteSnapshotBytesAt(writerPtr, writerPtr->size, bytesPtr, numBytes);
+    writerPtr->size += numBytes;
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Append a node, and everything below it, to a snapshot in the format described by the le_cfg
+ *  API.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteSnapshotNode
+(
+    SnapshotWriter_t* writerPtr,  ///< [IN] The snapshot being written.
+    tdb_NodeRef_t nodeRef         ///< [IN] The node to write.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char name[LE_CFG_NAME_LEN_BYTES] = "";
+    uint8_t header[2];
+
+    // The buffer is big enough for any name the tree accepts, so the name can't be truncated.
+    LE_ASSERT(tdb_GetNodeName(nodeRef, name, sizeof(name)) == LE_OK);
+
+    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
+    size_t nameLen = strlen(name);
+
+    header[0] = (uint8_t)type;
+    header[1] = (uint8_t)nameLen;
+    AppendSnapshotBytes(writerPtr, header, sizeof(header));
+    AppendSnapshotBytes(writerPtr, name, nameLen);
+
+    if (type == LE_CFG_TYPE_STEM)
+    {
+        // The length of the children is only known once they have been written, so leave room for
+        // it and fill it in afterwards.
+        size_t lengthPos = writerPtr->size;
+        uint8_t length[4] = { 0 };
+
+        AppendSnapshotBytes(writerPtr, length, sizeof(length));
+
+        tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+        while (childRef != NULL)
+        {
+            WriteSnapshotNode(writerPtr, childRef);
+            childRef = tdb_GetNextActiveSiblingNode(childRef);
+        }
+
+        size_t childrenLen = writerPtr->size - lengthPos - sizeof(length);
+
+        length[0] = (uint8_t)childrenLen;
+        length[1] = (uint8_t)(childrenLen >> 8);
+        length[2] = (uint8_t)(childrenLen >> 16);
+        length[3] = (uint8_t)(childrenLen >> 24);
+        WriteSnapshotBytesAt(writerPtr, lengthPos, length, sizeof(length));
+    }
+    else if (type != LE_CFG_TYPE_EMPTY)
+    {
+        char value[LE_CFG_STR_LEN_BYTES] = "";
+
+        if (tdb_GetValueAsString(nodeRef, value, sizeof(value), "") != LE_OK)
+        {
+            LE_WARN("Value of node '%s' truncated in snapshot.", name);
+        }
+
+        size_t valueLen = strlen(value);
+
+        header[0] = (uint8_t)valueLen;
+        header[1] = (uint8_t)(valueLen >> 8);
+        AppendSnapshotBytes(writerPtr, header, sizeof(header));
+        AppendSnapshotBytes(writerPtr, value, valueLen);
+    }
+}
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Init the node iterator subsystem and get it ready for use by the other subsystems in this
@@ -1310,3 +1452,70 @@ void ni_SetNodeValueBool
         tdb_SetValueAsBool(nodeRef, value);
     }
 }
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read a node and everything below it as a snapshot, as described by the le_cfg API.  The
+ *  snapshot is written again on each call, and only the bytes from the given offset that fit in
+ *  the buffer are copied.
+ *
+ *  @return LE_OK if the bytes were read, LE_NOT_FOUND if the node doesn't exist, LE_OUT_OF_RANGE
+ *          if the offset is past the end of the snapshot.  If a fatal problem is encountered and
+ *          the client connection needs to be closed LE_FAULT will be returned.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ni_GetSnapshot
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN]     The iterator object to access.
+    const char* pathPtr,           ///< [IN]     Optional path to another node in the tree.
+    size_t offset,                 ///< [IN]     Offset in the snapshot of the first byte to read.
+    uint8_t* destBufferPtr,        ///< [OUT]    The buffer to copy the snapshot bytes into.
+    size_t* bufferSizePtr,         ///< [IN/OUT] Size of the buffer on entry, number of bytes
+                                   ///<          copied on exit.
+    uint32_t* totalSizePtr         ///< [OUT]    Size of the whole snapshot.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    tdb_NodeRef_t nodeRef = ni_GetNode(iteratorRef, pathPtr);
+
+    *totalSizePtr = 0;
+
+    if (iteratorRef->isTerminated)
+    {
+        *bufferSizePtr = 0;
+        return LE_FAULT;
+    }
+
+    if (tdb_GetNodeType(nodeRef) == LE_CFG_TYPE_DOESNT_EXIST)
+    {
+        *bufferSizePtr = 0;
+        return LE_NOT_FOUND;
+    }
+
+    SnapshotWriter_t writer = { .bufferPtr = destBufferPtr,
+                                .bufferMax = *bufferSizePtr,
+                                .offset = offset,
+                                .size = 0 };
+    uint8_t version = LE_CFG_SNAPSHOT_VERSION;
+
+    AppendSnapshotBytes(&writer, &version, sizeof(version));
+    WriteSnapshotNode(&writer, nodeRef);
+
+    *totalSizePtr = writer.size;
+
+    if (offset >= writer.size)
+    {
+        *bufferSizePtr = 0;
+        return LE_OUT_OF_RANGE;
+    }
+
+    if ((writer.size - offset) < *bufferSizePtr)
+    {
+        *bufferSizePtr = writer.size - offset;
+    }
+
+    return LE_OK;
+}
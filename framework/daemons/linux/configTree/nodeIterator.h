@@ -612,4 +612,28 @@ void ni_SetNodeValueBool
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read a node and everything below it as a snapshot, as described by the le_cfg API.  Only the
+ *  bytes from the given offset that fit in the buffer are copied.
+ *
+ *  @return LE_OK if the bytes were read, LE_NOT_FOUND if the node doesn't exist, LE_OUT_OF_RANGE
+ *          if the offset is past the end of the snapshot.  If a fatal problem is encountered and
+ *          the client connection needs to be closed LE_FAULT will be returned.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t ni_GetSnapshot
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN]     The iterator object to access.
+    const char* pathPtr,           ///< [IN]     Optional path to another node in the tree.
+    size_t offset,                 ///< [IN]     Offset in the snapshot of the first byte to read.
+    uint8_t* destBufferPtr,        ///< [OUT]    The buffer to copy the snapshot bytes into.
+    size_t* bufferSizePtr,         ///< [IN/OUT] Size of the buffer on entry, number of bytes
+                                   ///<          copied on exit.
+    uint32_t* totalSizePtr         ///< [OUT]    Size of the whole snapshot.
+);
+
+
+
+
 #endif
@@ -120,6 +120,77 @@
  *  in order to have a handler registed for it.  In fact, a handler will be called when a node is
  *  deleted and when it is recreated.
  *
+ *  <b>Child Name Index:</b>
+ *
+ *  Looking up a child by name normally means walking the stem's child list and comparing each
+ *  child's name in turn.  That's fine for the typical stem, but some stems (like system:/apps) can
+ *  collect hundreds or thousands of children, and path lookups under them would then dominate.
+ *
+ *  So, once a lookup has to walk past CHILD_INDEX_THRESHOLD children, a Child Index is built for
+ *  that stem.  The index is a hash table of the stem's children, keyed on child name.  Each child
+ *  caches the hash of its name and is chained into its bucket through its own nextIndexedRef link,
+ *  so the index itself is just an array of bucket heads that is doubled as the stem grows.  From
+ *  then on, children are added to and removed from the index as they are added to, renamed in or
+ *  removed from the stem.  The index is thrown away when the stem is cleared or destroyed.
+ *
+ *  Shadow stems are indexed the same way as the stems of the original trees.  Shadow nodes that
+ *  haven't been renamed are indexed under the name of the node they shadow.
+ *
+ *  <b>Tree Journal:</b>
+ *
+ *  Each tree is saved as a "tree file", which holds the whole tree, plus a "journal" of the changes
+ *  committed since that tree file was written.  For the revision "rock" of the tree "system" these
+ *  are the files:
+ *
+ *  @verbatim
+    system.rock
+    system.rock.journal
+@endverbatim
+ *
+ *  When a write transaction is committed, a single record is appended to the journal.  The record
+ *  holds the paths of the nodes that the transaction removed or renamed, and the path and new
+ *  contents of the top-most nodes that it changed, in the same text format as the tree file.  So,
+ *  changing one value costs a few dozen bytes of flash, instead of a rewrite of the whole tree.
+ *
+ *  Each record starts with a header holding its size and CRC.  A record that was only partly
+ *  written, (because the system went down in the middle of the commit,) fails the check and is cut
+ *  off the end of the journal the next time the tree is loaded.  Loading a tree reads the tree file
+ *  then replays the journal's records over it, in order.  A node that was renamed is replayed as a
+ *  removal followed by a new node, so after a reload it's found after its former siblings.
+ *
+ *  The journal is folded into a new tree file, using the usual rock/paper/scissors revisions,
+ *  when a commit would grow it past JOURNAL_MAX_BYTES, or JOURNAL_MAX_AGE seconds after its first
+ *  record was written.  The new tree file is written and flushed before the old tree file and its
+ *  journal are deleted, so that at every point either the old pair or the new tree file is
+ *  complete.
+ *
+ *  <b>Tree Snapshots:</b>
+ *
+ *  Tree files are written as binary "snapshots", so that loading a tree doesn't mean parsing the
+ *  whole text format, one character at a time.  A snapshot is laid out as:
+ *
+ *  @verbatim
+    +-----------------+-----------------------------------+------------------------+
+    | Snapshot Header | Node Records, (in breadth order.) | String Table           |
+    +-----------------+-----------------------------------+------------------------+
+@endverbatim
+ *
+ *  Every node has a fixed size record, and the records of a stem's children follow one another, so
+ *  a stem record only needs to hold the location of its first child and the number of children it
+ *  has.  Names and values are null terminated strings in the string table, each one stored only
+ *  once.  All locations are stored as byte offsets from the record that refers to them.
+ *
+ *  When a tree is loaded from a snapshot, the file is mapped into memory and checked, but only the
+ *  root node is created.  A stem that was loaded from a snapshot keeps a pointer to its record, and
+ *  its children are only created, (again, without their own children,) the first time they're
+ *  looked at.  So the cost of loading a tree is paid a little at a time, and only for the parts of
+ *  the tree that are actually used.  The mapping is kept until the tree is released, or until the
+ *  next snapshot of the tree is written, (which loads every node.)
+ *
+ *  Tree files in the text format, (as written by older versions of the Config Tree or by the Update
+ *  Daemon,) are still read and are replaced by a snapshot JOURNAL_MAX_AGE seconds after they're
+ *  loaded.  Tree imports and exports always use the text format.
+ *
  *  Copyright (C) Sierra Wireless Inc.
  *
  */
@@ -134,6 +205,8 @@
 #include "treeUser.h"
 #include "nodeIterator.h"
 #include "sysPaths.h"
+#include "fileDescriptor.h"
+#include <sys/mman.h>
 
 
 
@@ -148,6 +221,36 @@
 
 
 
+/// Number of children a stem must have before a name lookup builds a Child Index for it.
+#define CHILD_INDEX_THRESHOLD 16
+
+
+/// Number of buckets in a newly built Child Index.  Must be a power of two.
+#define CHILD_INDEX_MIN_BUCKETS 32
+
+
+
+/// Size, in bytes, that a tree's journal may grow to before it is folded into a new tree file.
+#define JOURNAL_MAX_BYTES (64 * 1024)
+
+
+/// Seconds after the first record is written to a journal that it is folded into a new tree file.
+#define JOURNAL_MAX_AGE 60
+
+
+/// Value found at the start of every journal record, ("CFGJ".)
+#define JOURNAL_RECORD_MAGIC 0x4A474643
+
+
+/// Value found at the start of every tree snapshot, ("CFGS".)
+#define SNAPSHOT_MAGIC 0x53474643
+
+
+/// Version of the tree snapshot format.
+#define SNAPSHOT_VERSION 1
+
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -271,12 +374,132 @@ typedef struct Node
         le_dls_List_t children;      ///< The linked list of children belonging to this node.
     }
     info;                            ///< The actual inforation that this node stores.
+
+    struct ChildIndex* childIndexPtr;  ///< Index of this stem's children by name, or NULL if the
+                                       ///<   stem hasn't been indexed.
+
+    uint32_t nameHash;               ///< Hash of the name this node is filed under in its
+                                     ///<   parent's Child Index.
+    struct Node* nextIndexedRef;     ///< Next node in the same Child Index bucket.
+
+    const struct SnapshotNode* snapshotNodePtr;  ///< If this stem's children haven't been loaded
+                                                 ///<   from the tree's snapshot yet, this is the
+                                                 ///<   stem's record in the snapshot.  Otherwise
+                                                 ///<   NULL.
 }
 Node_t;
 
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Hash table of a stem's children, keyed on child name.  The buckets are chains of child nodes
+ *  linked through their nextIndexedRef.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct ChildIndex
+{
+    size_t childCount;               ///< Number of children filed in the index.
+    size_t bucketCount;              ///< Number of buckets, always a power of two.
+    Node_t** bucketsPtr;             ///< Array of bucketCount bucket heads.
+}
+ChildIndex_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Header written in front of each record in a tree's journal.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct JournalHeader
+{
+    uint32_t magic;                  ///< Always JOURNAL_RECORD_MAGIC.
+    uint32_t size;                   ///< Size of the record that follows, in bytes.
+    uint32_t crc;                    ///< CRC32 of the record that follows.
+}
+JournalHeader_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Header found at the start of a tree snapshot.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct SnapshotHeader
+{
+    uint32_t magic;                  ///< Always SNAPSHOT_MAGIC.
+    uint32_t version;                ///< Always SNAPSHOT_VERSION.
+    uint32_t size;                   ///< Size of the whole snapshot, in bytes.
+    uint32_t nodeCount;              ///< Number of node records in the snapshot.
+    uint32_t crc;                    ///< CRC32 of everything that follows the header.
+}
+SnapshotHeader_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  The record of a node in a tree snapshot.  Offsets are in bytes, counted from the start of the
+ *  record itself.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct SnapshotNode
+{
+    uint32_t nameOffset;             ///< Offset of the node's name, or 0 for the root node.
+    uint32_t valueOffset;            ///< Offset of the node's value, or of the record of its first
+                                     ///<   child if the node is a stem.
+    uint32_t childCount;             ///< Number of children of a stem, 0 for other nodes.
+    uint32_t type;                   ///< The le_cfg_nodeType_t of the node.
+}
+SnapshotNode_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  A tree snapshot being put together, in memory, before it's written to a tree file.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct SnapshotWriter
+{
+    tdb_NodeRef_t* nodesPtr;         ///< The nodes to write, in the order they're written.
+    SnapshotNode_t* recordsPtr;      ///< The records of those nodes.
+    size_t nodeCount;                ///< Number of nodes added so far.
+    size_t nodeMax;                  ///< Number of nodes there's room for.
+
+    char* stringsPtr;                ///< The string table.
+    size_t stringsSize;              ///< Number of bytes used in the string table.
+    size_t stringsMax;               ///< Number of bytes there's room for in the string table.
+}
+SnapshotWriter_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  A journal record being put together, in memory, while a write transaction is merged.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct JournalRecord
+{
+    FILE* filePtr;                   ///< Memory stream the record is written through.
+    char* bufferPtr;                 ///< The record's text, once the stream is closed.
+    size_t size;                     ///< Size of the record's text, in bytes.
+    le_result_t result;              ///< LE_OK, or LE_IO_ERROR if the record couldn't be written.
+}
+JournalRecord_t;
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Structure used to keep track of the trees loaded in the configTree daemon.
@@ -307,6 +530,14 @@ typedef struct Tree
 
     le_sls_List_t requestList;            ///< Each tree maintains it's own list of pending
                                           ///<   requests.
+
+    size_t journalBytes;                  ///< Size of the journal of the current revision.
+    le_timer_Ref_t compactTimerRef;       ///< Folds the journal into a new tree file once it's
+                                          ///<   JOURNAL_MAX_AGE seconds old.  NULL until needed.
+
+    void* snapshotPtr;                    ///< The tree's snapshot, mapped into memory, while it
+                                          ///<   still holds nodes that haven't been loaded yet.
+    size_t snapshotSize;                  ///< Size of the mapped snapshot, in bytes.
 }
 Tree_t;
 
@@ -387,6 +618,14 @@ static le_mem_PoolRef_t RegistrationPool = NULL;
 #define CFG_REGISTRATION_POOL_NAME "RegistrationPool"
 
 
+/// Strings in the string table of the snapshot being written, mapped to their offsets in the table
+/// plus one, (so that no entry is NULL.)
+static le_hashmap_Ref_t SnapshotStringMap = NULL;
+
+/// Name of the snapshot string map.
+#define CFG_SNAPSHOT_STRING_MAP_NAME "snapshotStringMap"
+
+
 
 
 // -------------------------------------------------------------------------------------------------
@@ -565,6 +804,10 @@ static tdb_NodeRef_t NewNode
     newNodeRef->nameRef = NULL;
     newNodeRef->siblingList = LE_DLS_LINK_INIT;
     memset(&newNodeRef->info, 0, sizeof(newNodeRef->info));
+    newNodeRef->childIndexPtr = NULL;
+    newNodeRef->nameHash = 0;
+    newNodeRef->nextIndexedRef = NULL;
+    newNodeRef->snapshotNodePtr = NULL;
 
     return newNodeRef;
 }
@@ -572,65 +815,33 @@ static tdb_NodeRef_t NewNode
 
 
 
+/// The memory pool responsible for Child Index objects.
+static le_mem_PoolRef_t ChildIndexPoolRef = NULL;
+
+/// The name of the memory pool that handles Child Index objects.
+#define CFG_CHILD_INDEX_POOL_NAME "childIndexPool"
 // -------------------------------------------------------------------------------------------------
 /**
- *  The node destructor function.  This will take care of freeing a node's string values and any
- *  children it may have.  Called automaticly by the memory system when a node is released.
+ *  Get the name of a node.  Shadow nodes that haven't been renamed use the name of the node they
+ *  shadow.
+ *
+ *  @return The node's name, or NULL if the node has no name.
  */
 // -------------------------------------------------------------------------------------------------
-static void NodeDestructor
+static dstr_Ref_t GetNameRef
 (
-    void* objectPtr  ///< [IN] The generic object to free.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t nodeRef = (tdb_NodeRef_t)objectPtr;
-
-    if (nodeRef->nameRef)
-    {
-        dstr_Release(nodeRef->nameRef);
-    }
-
-    switch (nodeRef->type)
+    if (   (IsShadow(nodeRef))
+        && (nodeRef->nameRef == NULL)
+        && (nodeRef->shadowRef != NULL))
     {
-        case LE_CFG_TYPE_EMPTY:
-        case LE_CFG_TYPE_DOESNT_EXIST:
-            // Nothing to do here.
-            break;
-
-        case LE_CFG_TYPE_STRING:
-        case LE_CFG_TYPE_BOOL:
-        case LE_CFG_TYPE_INT:
-        case LE_CFG_TYPE_FLOAT:
-            if (nodeRef->info.valueRef)
-            {
-                dstr_Release(nodeRef->info.valueRef);
-            }
-            break;
-
-        case LE_CFG_TYPE_STEM:
-            {
-                tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
-
-                while (childRef != NULL)
-                {
-                    tdb_NodeRef_t nextChildRef = tdb_GetNextSiblingNode(childRef);
-
-                    le_mem_Release(childRef);
-                    childRef = nextChildRef;
-                }
-            }
-            break;
+        return nodeRef->shadowRef->nameRef;
     }
 
-    if (nodeRef->parentRef != NULL)
-    {
-        LE_ASSERT(nodeRef->parentRef->type == LE_CFG_TYPE_STEM);
-        LE_ASSERT(le_dls_IsEmpty(&nodeRef->parentRef->info.children) == false);
-        LE_ASSERT(le_dls_IsInList(&nodeRef->parentRef->info.children, &nodeRef->siblingList));
-
-        le_dls_Remove(&nodeRef->parentRef->info.children, &nodeRef->siblingList);
-    }
+    return nodeRef->nameRef;
 }
 
 
@@ -638,40 +849,19 @@ static void NodeDestructor
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Allocate a new node from our pool, and turn it into a shadow of an existing node.
+ *  Get the head of the Child Index bucket that a given name hash is filed in.
  *
- *  @return A new node that shadows the existing node.
+ *  @return Pointer to the bucket's head.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewShadowNode
+static Node_t** GetIndexBucket
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to shadow.
+    ChildIndex_t* indexPtr,  ///< [IN] The index to look in.
+    uint32_t hash            ///< [IN] The name hash.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Allocate a new blank node.
-    tdb_NodeRef_t newShadowRef = NewNode();
-
-    // Turn it into a shadow of the original node.  It's possible for nodeRef to be NULL.  We could
-    // be creating a shadow node for which no original exists.  Which is the case when creating a
-    // new path that didn't exist in the original tree.
-    if (nodeRef != NULL)
-    {
-        newShadowRef->type = nodeRef->type;
-        newShadowRef->flags = nodeRef->flags;
-        newShadowRef->shadowRef = nodeRef;
-
-        // Now, if the parent node, (if there is a parent node,) is marked as deleted, then do the
-        // same with this new node.
-        if (   (nodeRef->parentRef != NULL)
-            && (IsDeleted(nodeRef->parentRef)))
-        {
-            SetDeletedFlag(newShadowRef);
-        }
-    }
-
-    SetShadowFlag(newShadowRef);
-    return newShadowRef;
+    return &indexPtr->bucketsPtr[hash & (indexPtr->bucketCount - 1)];
 }
 
 
@@ -679,48 +869,41 @@ static tdb_NodeRef_t NewShadowNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new node and insert it into the given node's children collection.
- *
- *  @return The newly create node, already inserted into the supplied node's child collection.
+ *  Move all of the nodes in a Child Index into a new array of buckets.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewChildNode
+static void ResizeChildIndex
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to be given with a new child.
+    ChildIndex_t* indexPtr,  ///< [IN] The index to resize.
+    size_t bucketCount       ///< [IN] The new number of buckets.  Must be a power of two.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the node is currently empty, then turn it into a stem.
-    if (nodeRef->type == LE_CFG_TYPE_EMPTY)
-    {
-        nodeRef->type = LE_CFG_TYPE_STEM;
-    }
+    Node_t** oldBucketsPtr = indexPtr->bucketsPtr;
+    size_t oldBucketCount = indexPtr->bucketCount;
+    size_t i;
 
-    LE_ASSERT(nodeRef->type == LE_CFG_TYPE_STEM);
+    indexPtr->bucketsPtr = calloc(bucketCount, sizeof(Node_t*));
+    LE_ASSERT(indexPtr->bucketsPtr != NULL);
+    indexPtr->bucketCount = bucketCount;
 
-    // Create a new node.  Then set it's parent to the given node
-    tdb_NodeRef_t newRef = NewNode();
+    for (i = 0; i < oldBucketCount; i++)
+    {
+        Node_t* currentRef = oldBucketsPtr[i];
 
-    newRef->parentRef = nodeRef;
-    newRef->type = LE_CFG_TYPE_EMPTY;
+        while (currentRef != NULL)
+        {
+            Node_t* nextRef = currentRef->nextIndexedRef;
+            Node_t** bucketPtr = GetIndexBucket(indexPtr, currentRef->nameHash);
 
-    // Get the new node to inheret the parent's shadow and deletion flags.
-    if (IsShadow(nodeRef))
-    {
-        SetShadowFlag(newRef);
-        SetDeletedFlag(newRef);
-    }
+            currentRef->nextIndexedRef = *bucketPtr;
+            *bucketPtr = currentRef;
 
-    if (IsDeleted(nodeRef))
-    {
-        SetDeletedFlag(newRef);
+            currentRef = nextRef;
+        }
     }
 
-    // Now make sure to add the new child node to the end of the parents collection.
-    le_dls_Queue(&nodeRef->info.children, &newRef->siblingList);
-
-    // Finally return the newly created node to the caller.
-    return newRef;
+    free(oldBucketsPtr);
 }
 
 
@@ -728,58 +911,43 @@ static tdb_NodeRef_t NewChildNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to shadow a node's collection of children.
+ *  File a node in its parent's Child Index, if the parent has one.  Nodes that haven't been given
+ *  a name yet are left out, they are filed when they're named.
  */
 // -------------------------------------------------------------------------------------------------
-static void ShadowChildren
+static void IndexChild
 (
-    tdb_NodeRef_t shadowParentRef  ///< [IN] The node we're shadowing the children of.
+    tdb_NodeRef_t childRef  ///< [IN] The node to file.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the parent node isn't a stem then there isn't much else to do here.
-    if (shadowParentRef->type != LE_CFG_TYPE_STEM)
+    if (   (childRef->parentRef == NULL)
+        || (childRef->parentRef->childIndexPtr == NULL))
     {
         return;
     }
 
-    // Does this node have any children currently?  If yes, then we don't need to do anything else.
-    if (le_dls_IsEmpty(&shadowParentRef->info.children) == false)
-    {
-        return;
-    }
+    ChildIndex_t* indexPtr = childRef->parentRef->childIndexPtr;
+    dstr_Ref_t nameRef = GetNameRef(childRef);
 
-    // Has this node been modified?  If so, then the shadow children may have been cleared from
-    // this collection.
-    if (IsModified(shadowParentRef) == true)
+    if (dstr_IsNullOrEmpty(nameRef))
     {
         return;
     }
 
-    // This node has no shadow children.  So what we do now is check the original node... Does it
-    // have any children?  If it does, we simply recreate the whole collection now.  (We do not
-    // recurse into the grandchildren though.)  Doing this now makes life simpler, instead of doing
-    // this piecemeal and possibly out of order.
-    tdb_NodeRef_t originalRef = shadowParentRef->shadowRef;
+    Node_t** bucketPtr;
 
-    if (   (originalRef == NULL)
-        || (originalRef->type != LE_CFG_TYPE_STEM))
-    {
-        return;
-    }
+    childRef->nameHash = dstr_GetHash(nameRef);
+    bucketPtr = GetIndexBucket(indexPtr, childRef->nameHash);
+    childRef->nextIndexedRef = *bucketPtr;
+    *bucketPtr = childRef;
 
-    // Simply iterate through the original collection and add a new shadow child to our own
-    // collection.
-    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
+    // Keep the chains short by keeping at least one bucket per child.
+    indexPtr->childCount++;
 
-    while (originalChildRef != NULL)
+    if (indexPtr->childCount > indexPtr->bucketCount)
     {
-        tdb_NodeRef_t newShadowRef = NewShadowNode(originalChildRef);
-        newShadowRef->parentRef = shadowParentRef;
-
-        le_dls_Queue(&shadowParentRef->info.children, &newShadowRef->siblingList);
-
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+        ResizeChildIndex(indexPtr, indexPtr->bucketCount * 2);
     }
 }
 
@@ -788,24 +956,37 @@ static void ShadowChildren
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Search up through a node tree until we find the root node.
+ *  Remove a node from its parent's Child Index.  Nothing happens if the node isn't filed there.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t GetRootParentNode
+static void UnindexChild
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Find the greatest grand parent of this node.
+    tdb_NodeRef_t childRef  ///< [IN] The node to remove.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t parentRef = NULL;
-
-    while (nodeRef != NULL)
+    if (   (childRef->parentRef == NULL)
+        || (childRef->parentRef->childIndexPtr == NULL))
     {
-        parentRef = nodeRef;
-        nodeRef = tdb_GetNodeParent(nodeRef);
+        return;
     }
 
-    return parentRef;
+    ChildIndex_t* indexPtr = childRef->parentRef->childIndexPtr;
+    Node_t** linkPtr = GetIndexBucket(indexPtr, childRef->nameHash);
+
+    while (*linkPtr != NULL)
+    {
+        if (*linkPtr == childRef)
+        {
+            *linkPtr = childRef->nextIndexedRef;
+            childRef->nextIndexedRef = NULL;
+            indexPtr->childCount--;
+
+            return;
+        }
+
+        linkPtr = &(*linkPtr)->nextIndexedRef;
+    }
 }
 
 
@@ -813,53 +994,35 @@ static tdb_NodeRef_t GetRootParentNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to look for a named child in a given node's child collection.
+ *  Build a Child Index for a stem, and file all of the stem's current children in it.
  *
- *  @return Reference to the found child node, or NULL if a node was not found.
+ *  The stem's shadow children, (if any,) must have already been created.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t GetNamedChild
+static void BuildChildIndex
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
-    const char* nameRef     ///< [IN] The name we're searching for.
+    tdb_NodeRef_t nodeRef  ///< [IN] The stem to index.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Is this one of the "special" names?
-    if (strcmp(nameRef, ".") == 0)
-    {
-        return nodeRef;
-    }
-
-    if (strcmp(nameRef, "..") == 0)
-    {
-        return nodeRef->parentRef;
-    }
+    LE_ASSERT(nodeRef->childIndexPtr == NULL);
 
-    // If the current node isn't a stem, then this node can't have any children.
-    if (nodeRef->type != LE_CFG_TYPE_STEM)
-    {
-        return NULL;
-    }
+    ChildIndex_t* indexPtr = le_mem_ForceAlloc(ChildIndexPoolRef);
 
-    // Search the child list for a node with the given name.
-    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(nodeRef);
-    char currentNameRef[LE_CFG_NAME_LEN_BYTES] = "";
+    indexPtr->childCount = 0;
+    indexPtr->bucketCount = CHILD_INDEX_MIN_BUCKETS;
+    indexPtr->bucketsPtr = calloc(CHILD_INDEX_MIN_BUCKETS, sizeof(Node_t*));
+    LE_ASSERT(indexPtr->bucketsPtr != NULL);
 
-    while (currentRef != NULL)
-    {
-        tdb_GetNodeName(currentRef, currentNameRef, sizeof(currentNameRef));
+    nodeRef->childIndexPtr = indexPtr;
 
-        if (strncmp(currentNameRef, nameRef, sizeof(currentNameRef)) == 0)
-        {
-            return currentRef;
-        }
+    le_dls_Link_t* linkPtr = le_dls_Peek(&nodeRef->info.children);
 
-        currentRef = tdb_GetNextSiblingNode(currentRef);
+    while (linkPtr != NULL)
+    {
+        IndexChild(CONTAINER_OF(linkPtr, Node_t, siblingList));
+        linkPtr = le_dls_PeekNext(&nodeRef->info.children, linkPtr);
     }
-
-    // Looks like there was no node to return.
-    return NULL;
 }
 
 
@@ -867,46 +1030,21 @@ static tdb_NodeRef_t GetNamedChild
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to create a named child in a nodes child collection.  However, this function will only
- *  create nodes on shadow trees.
- *
- *  @return Reference to newly created child node, or NULL if it can not be created.
+ *  Throw away a stem's Child Index, if it has one.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t CreateNamedChild
+static void DeleteChildIndex
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
-    const char* nameRef     ///< [IN] The name we're searching for.
+    tdb_NodeRef_t nodeRef  ///< [IN] The stem to update.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t childRef = NULL;
-
-    if (IsShadow(nodeRef) == true)
+    if (nodeRef->childIndexPtr != NULL)
     {
-        // If the node isn't a stem, then convert it into an empty one now.
-        if (   (nodeRef->type != LE_CFG_TYPE_STEM)
-            && (nodeRef->type != LE_CFG_TYPE_EMPTY))
-        {
-            tdb_SetEmpty(nodeRef);
-            nodeRef->type = LE_CFG_TYPE_STEM;
-            nodeRef->info.children = LE_DLS_LIST_INIT;
-        }
-
-        // Create the node, and set it's deleted flag as it hasn't been used for anything yet.
-        childRef = NewChildNode(nodeRef);
-        SetDeletedFlag(childRef);
-
-        // Set the name of the new node, if that fails then the user had given us a bad name for the
-        // new node.  So in that case free the node and return NULL.
-        if (tdb_SetNodeName(childRef, nameRef) != LE_OK)
-        {
-            le_mem_Release(childRef);
-            childRef = NULL;
-        }
+        free(nodeRef->childIndexPtr->bucketsPtr);
+        le_mem_Release(nodeRef->childIndexPtr);
+        nodeRef->childIndexPtr = NULL;
     }
-
-    return childRef;
 }
 
 
@@ -914,34 +1052,37 @@ static tdb_NodeRef_t CreateNamedChild
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check to see if a given node exists within a node's child collection.
- *
- *  @return True if the given node exists within the parent node's collection.  False if not.
+ *  Give a node the value from its record in a tree snapshot.  If the node is a stem, its children
+ *  are left in the snapshot until they're needed.
  */
 // -------------------------------------------------------------------------------------------------
-static bool NodeExists
+static void InitFromSnapshot
 (
-    tdb_NodeRef_t parentRef,  ///< [IN] The parent node to search.
-    const char* namePtr       ///< [IN] The name to search for.
+    tdb_NodeRef_t nodeRef,                ///< [IN] The node to update.
+    const SnapshotNode_t* recordPtr       ///< [IN] The node's record.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(parentRef);
-    char currentName[LE_CFG_NAME_LEN_BYTES] = "";
-
-    while (currentRef != NULL)
+    switch (recordPtr->type)
     {
-        tdb_GetNodeName(currentRef, currentName, sizeof(currentName));
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_BOOL:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+            nodeRef->type = (le_cfg_nodeType_t)recordPtr->type;
+            nodeRef->info.valueRef = dstr_NewFromCstr((const char*)recordPtr
+                                                      + recordPtr->valueOffset);
+            break;
 
-        if (strncmp(currentName, namePtr, sizeof(currentName)) == 0)
-        {
-            return true;
-        }
+        case LE_CFG_TYPE_STEM:
+            nodeRef->type = LE_CFG_TYPE_STEM;
+            nodeRef->snapshotNodePtr = recordPtr;
+            break;
 
-        currentRef = tdb_GetNextSiblingNode(currentRef);
+        default:
+            // Empty nodes have nothing more to load.
+            break;
     }
-
-    return false;
 }
 
 
@@ -949,28 +1090,38 @@ static bool NodeExists
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the given node type and see if it should have a string value.
- *
- *  @return True if the given node could hold a string value.  False if not.
+ *  If a stem's children are still waiting in the tree's snapshot, create them now.
  */
 // -------------------------------------------------------------------------------------------------
-static bool IsStringType
+static void LoadSnapshotChildren
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
+    tdb_NodeRef_t nodeRef  ///< [IN] The stem to load the children of.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
+    const SnapshotNode_t* recordPtr = nodeRef->snapshotNodePtr;
 
-    if (   (type == LE_CFG_TYPE_STRING)
-        || (type == LE_CFG_TYPE_BOOL)
-        || (type == LE_CFG_TYPE_INT)
-        || (type == LE_CFG_TYPE_FLOAT))
+    if (recordPtr == NULL)
     {
-        return true;
+        return;
     }
 
-    return false;
+    nodeRef->snapshotNodePtr = NULL;
+
+    const SnapshotNode_t* childRecordPtr =
+        (const SnapshotNode_t*)((const char*)recordPtr + recordPtr->valueOffset);
+
+    for (uint32_t i = 0; i < recordPtr->childCount; i++, childRecordPtr++)
+    {
+        tdb_NodeRef_t childRef = NewNode();
+
+        childRef->parentRef = nodeRef;
+        childRef->nameRef = dstr_NewFromCstr((const char*)childRecordPtr
+                                             + childRecordPtr->nameOffset);
+        InitFromSnapshot(childRef, childRecordPtr);
+
+        le_dls_Queue(&nodeRef->info.children, &childRef->siblingList);
+    }
 }
 
 
@@ -978,33 +1129,68 @@ static bool IsStringType
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  This function will copy a string value from an original tree node into a node that has shadowed
- *  it.
+ *  The node destructor function.  This will take care of freeing a node's string values and any
+ *  children it may have.  Called automaticly by the memory system when a node is released.
  */
 // -------------------------------------------------------------------------------------------------
-static void PropagateValue
+static void NodeDestructor
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node ref to update.
+    void* objectPtr  ///< [IN] The generic object to free.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the node doesn't even have a ref to an original node, then there's nothing left to do
-    // here.
-    tdb_NodeRef_t shadowRef = nodeRef->shadowRef;
+    tdb_NodeRef_t nodeRef = (tdb_NodeRef_t)objectPtr;
 
-    if (shadowRef == NULL)
+    if (nodeRef->nameRef)
     {
-        return;
+        dstr_Release(nodeRef->nameRef);
     }
 
-    // Ok, figure out the type for this node.  If it has a value, and the original
-    if (   (IsStringType(nodeRef) == true)
-        && (IsStringType(shadowRef) == true)
-        && (nodeRef->info.valueRef == NULL)
-        && (shadowRef->info.valueRef != NULL))
+    // Drop the index first, so that the children don't have to be taken out of it one by one.
+    // Children that were never loaded from the tree's snapshot don't need to be released at all.
+    DeleteChildIndex(nodeRef);
+    nodeRef->snapshotNodePtr = NULL;
+
+    switch (nodeRef->type)
     {
-        // Looks like the value hasn't been propagated or changed yet.  So, do so now.
-        nodeRef->info.valueRef = dstr_NewFromDstr(shadowRef->info.valueRef);
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            // Nothing to do here.
+            break;
+
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_BOOL:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+            if (nodeRef->info.valueRef)
+            {
+                dstr_Release(nodeRef->info.valueRef);
+            }
+            break;
+
+        case LE_CFG_TYPE_STEM:
+            {
+                tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
+
+                while (childRef != NULL)
+                {
+                    tdb_NodeRef_t nextChildRef = tdb_GetNextSiblingNode(childRef);
+
+                    le_mem_Release(childRef);
+                    childRef = nextChildRef;
+                }
+            }
+            break;
+    }
+
+    if (nodeRef->parentRef != NULL)
+    {
+        LE_ASSERT(nodeRef->parentRef->type == LE_CFG_TYPE_STEM);
+        LE_ASSERT(le_dls_IsEmpty(&nodeRef->parentRef->info.children) == false);
+        LE_ASSERT(le_dls_IsInList(&nodeRef->parentRef->info.children, &nodeRef->siblingList));
+
+        UnindexChild(nodeRef);
+        le_dls_Remove(&nodeRef->parentRef->info.children, &nodeRef->siblingList);
     }
 }
 
@@ -1013,116 +1199,94 @@ static void PropagateValue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Merge a shadow node with the original it represents.
+ *  Allocate a new node from our pool, and turn it into a shadow of an existing node.
+ *
+ *  @return A new node that shadows the existing node.
  */
 // -------------------------------------------------------------------------------------------------
-static void MergeNode
+static tdb_NodeRef_t NewShadowNode
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to merge.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to shadow.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    LE_ASSERT(nodeRef != NULL);
+    // Allocate a new blank node.
+    tdb_NodeRef_t newShadowRef = NewNode();
 
-    // If this shadow node for some reason doesn't have a ref check for an original version of it in
-    // the original tree.  This shadow node may have been destroyed and re-created loosing this
-    // link.
-    if (nodeRef->shadowRef == NULL)
+    // Turn it into a shadow of the original node.  It's possible for nodeRef to be NULL.  We could
+    // be creating a shadow node for which no original exists.  Which is the case when creating a
+    // new path that didn't exist in the original tree.
+    if (nodeRef != NULL)
     {
-        tdb_NodeRef_t shadowedParentRef = tdb_GetNodeParent(nodeRef)->shadowRef;
+        newShadowRef->type = nodeRef->type;
+        newShadowRef->flags = nodeRef->flags;
+        newShadowRef->shadowRef = nodeRef;
 
-        if (shadowedParentRef != NULL)
+        // Now, if the parent node, (if there is a parent node,) is marked as deleted, then do the
+        // same with this new node.
+        if (   (nodeRef->parentRef != NULL)
+            && (IsDeleted(nodeRef->parentRef)))
         {
-            char name[LE_CFG_NAME_LEN_BYTES] = "";
-
-            tdb_GetNodeName(nodeRef, name, sizeof(name));
-            nodeRef->shadowRef = GetNamedChild(shadowedParentRef, name);
+            SetDeletedFlag(newShadowRef);
         }
     }
 
-    // If this node has been marked as deleted, then simply drop the original node and move on.
-    if (IsDeleted(nodeRef))
-    {
-        if (   (nodeRef->shadowRef != NULL)
-            && (tdb_GetNodeParent(nodeRef->shadowRef) != NULL))
-        {
-            le_mem_Release(nodeRef->shadowRef);
-        }
-        else
-        {
-            // We delete every node but the root node.  Since this is the root node, we just need
-            // to clear it out.
-            tdb_SetEmpty(nodeRef->shadowRef);
-        }
+    SetShadowFlag(newShadowRef);
+    return newShadowRef;
+}
 
-        return;
-    }
 
-    // If the original node doesn't exist, create it now.
-    tdb_NodeRef_t originalRef = nodeRef->shadowRef;
 
-    if (originalRef == NULL)
-    {
-        LE_ASSERT(nodeRef->parentRef != NULL);
-        LE_ASSERT(nodeRef->parentRef->shadowRef != NULL);
 
-        nodeRef->shadowRef = originalRef = NewChildNode(nodeRef->parentRef->shadowRef);
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a new node and insert it into the given node's children collection.
+ *
+ *  @return The newly create node, already inserted into the supplied node's child collection.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t NewChildNode
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to be given with a new child.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // The new child goes after any children still waiting in the tree's snapshot.
+    LoadSnapshotChildren(nodeRef);
+
+    // If the node is currently empty, then turn it into a stem.  Any index left over from the
+    // node's previous life as a stem is stale.
+    if (nodeRef->type == LE_CFG_TYPE_EMPTY)
+    {
+        nodeRef->type = LE_CFG_TYPE_STEM;
+        DeleteChildIndex(nodeRef);
     }
 
-    ClearModifiedFlag(originalRef);
+    LE_ASSERT(nodeRef->type == LE_CFG_TYPE_STEM);
 
-    // If the name has been changed, then copy it over now.
-    if (dstr_IsNullOrEmpty(nodeRef->nameRef) == false)
-    {
-        if (originalRef->nameRef != NULL)
-        {
-            dstr_Copy(originalRef->nameRef, nodeRef->nameRef);
-        }
-        else
-        {
-            originalRef->nameRef = dstr_NewFromDstr(nodeRef->nameRef);
-        }
-    }
+    // Create a new node.  Then set it's parent to the given node
+    tdb_NodeRef_t newRef = NewNode();
 
-    // Check the types of the original and the shadow nodes.  If the new node has been cleared,
-    // then clear out the original node.  If the types have changed, then clear out the original so
-    // that we can properly populate it again.
-    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
+    newRef->parentRef = nodeRef;
+    newRef->type = LE_CFG_TYPE_EMPTY;
 
-    if (   (nodeType == LE_CFG_TYPE_EMPTY)
-        || (nodeType != originalRef->type))
+    // Get the new node to inheret the parent's shadow and deletion flags.
+    if (IsShadow(nodeRef))
     {
-        tdb_SetEmpty(originalRef);
+        SetShadowFlag(newRef);
+        SetDeletedFlag(newRef);
     }
 
-    // Ok, we know that the node hasn't been deleted.  Check to see if it's considered empty and
-    // that it isn't a stem.  If not, then copy over the string value.
-    if (   (nodeType != LE_CFG_TYPE_EMPTY)
-        && (nodeType != LE_CFG_TYPE_STEM))
+    if (IsDeleted(nodeRef))
     {
-        if (nodeRef->info.valueRef != NULL)
-        {
-            if (originalRef->info.valueRef != NULL)
-            {
-                dstr_Copy(originalRef->info.valueRef, nodeRef->info.valueRef);
-            }
-            else
-            {
-                originalRef->info.valueRef = dstr_NewFromDstr(nodeRef->info.valueRef);
-            }
-
-            // Propigate over the type as that may have changed, like going from an int value to a
-            // bool value.
-
-            originalRef->type = nodeRef->type;
-        }
+        SetDeletedFlag(newRef);
     }
 
-    // Now at this point, if both the original and the shadow node are stems, we'll let the function
-    // InternalMergeTree take care of the children, (if any.)
+    // Now make sure to add the new child node to the end of the parents collection.
+    le_dls_Queue(&nodeRef->info.children, &newRef->siblingList);
 
-    // If the original has been cleared out, we can still just rely on InternalMergeTree to
-    // propigate over the new nodes.
+    // Finally return the newly created node to the caller.
+    return newRef;
 }
 
 
@@ -1130,77 +1294,85 @@ static void MergeNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to fire any callbacks registered on the given node path.  If nothing is registered on the
- *  given path, nothing happens.
+ *  Called to shadow a node's collection of children.
  */
 // -------------------------------------------------------------------------------------------------
-static void TriggerCallbacks
+static void ShadowChildren
 (
-    le_pathIter_Ref_t pathRef  ///< [IN] The path to search for callback registrations.
+    tdb_NodeRef_t shadowParentRef  ///< [IN] The node we're shadowing the children of.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Read the path out of the buffer.
-    char pathBuffer[CFG_MAX_PATH_SIZE] = { 0 };
-    if (le_pathIter_GetPath(pathRef, pathBuffer, sizeof(pathBuffer)) != LE_OK)
+    // If the parent node isn't a stem then there isn't much else to do here.
+    if (shadowParentRef->type != LE_CFG_TYPE_STEM)
     {
-        LE_ERROR("Callback path buffer overflow.");
         return;
     }
 
-    // Try to find a registration object for this path.  If one is found, flag it for calling once
-    // the merge is complete.
-    Registration_t* foundRegistrationPtr = le_hashmap_Get(HandlerRegistrationMap, pathBuffer);
+    // Does this node have any children currently?  If yes, then we don't need to do anything else.
+    if (le_dls_IsEmpty(&shadowParentRef->info.children) == false)
+    {
+        return;
+    }
 
-    if (foundRegistrationPtr != NULL)
+    // Has this node been modified?  If so, then the shadow children may have been cleared from
+    // this collection.
+    if (IsModified(shadowParentRef) == true)
     {
-        foundRegistrationPtr->triggered = true;
+        return;
     }
-}
 
+    // This node has no shadow children.  So what we do now is check the original node... Does it
+    // have any children?  If it does, we simply recreate the whole collection now.  (We do not
+    // recurse into the grandchildren though.)  Doing this now makes life simpler, instead of doing
+    // this piecemeal and possibly out of order.
+    tdb_NodeRef_t originalRef = shadowParentRef->shadowRef;
+
+    if (   (originalRef == NULL)
+        || (originalRef->type != LE_CFG_TYPE_STEM))
+    {
+        return;
+    }
+
+    // Simply iterate through the original collection and add a new shadow child to our own
+    // collection.
+    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
+
+    while (originalChildRef != NULL)
+    {
+        tdb_NodeRef_t newShadowRef = NewShadowNode(originalChildRef);
+        newShadowRef->parentRef = shadowParentRef;
+
+        le_dls_Queue(&shadowParentRef->info.children, &newShadowRef->siblingList);
+        IndexChild(newShadowRef);
+
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
+}
 
 
 
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Go through all of the registered event callbacks, and fire the call backs for each of the
- *  registrations that has been makred as triggered.
- *
- *  Once this is done, the triggered flag is cleared for next time.
+ *  Search up through a node tree until we find the root node.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireTriggeredCallbacks
+static tdb_NodeRef_t GetRootParentNode
 (
-    void
+    tdb_NodeRef_t nodeRef  ///< [IN] Find the greatest grand parent of this node.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Go through the registration map.
-    le_hashmap_It_Ref_t handlerIterRef = le_hashmap_GetIterator(HandlerRegistrationMap);
+    tdb_NodeRef_t parentRef = NULL;
 
-    while (le_hashmap_NextNode(handlerIterRef) == LE_OK)
+    while (nodeRef != NULL)
     {
-        // For each registration, check to see if it was triggered.
-        Registration_t* registrationPtr = (Registration_t*)le_hashmap_GetValue(handlerIterRef);
-
-        if (registrationPtr->triggered)
-        {
-            // This registration has been triggered, so call all of the handlers attached to it.
-            le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
-
-            while (linkPtr != NULL)
-            {
-                Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
-
-                handlerObjectPtr->handlerPtr(handlerObjectPtr->contextPtr);
-                linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
-            }
-
-            // Now that that's done, clear the triggered flag.
-            registrationPtr->triggered = false;
-        }
+        parentRef = nodeRef;
+        nodeRef = tdb_GetNodeParent(nodeRef);
     }
+
+    return parentRef;
 }
 
 
@@ -1208,39 +1380,71 @@ static void FireTriggeredCallbacks
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the given node to see if it was renamed.
+ *  Search a node's child collection, (including any children marked as deleted,) for a child with
+ *  the given name.  Small collections are simply searched in order, but once a search has to go
+ *  past CHILD_INDEX_THRESHOLD children the collection is indexed, and the index is used from then
+ *  on.
  *
- *  @return True if the node was renamed within this transaction.  False if not.
+ *  @return Reference to the found child node, or NULL if a node was not found.
  */
 // -------------------------------------------------------------------------------------------------
-static bool WasRenamed
+static tdb_NodeRef_t FindChild
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Check this node to see if it was renamed in this transaction.
+    tdb_NodeRef_t parentRef,  ///< [IN] The node to search.
+    const char* namePtr       ///< [IN] The name to search for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    if (IsModified(nodeRef) == false)
+    // Note that this also takes care of creating a shadow node's children, if need be.
+    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(parentRef);
+
+    // Names are interned, so if there is no string with this name then no node has it either.
+    // Otherwise, the nodes with this name are exactly the ones that share this string.
+    dstr_Ref_t nameRef = dstr_Lookup(namePtr);
+
+    if (   (currentRef == NULL)
+        || (nameRef == NULL))
     {
-        // The node wasn't even modified, so it can not have been renamed.
-        return false;
+        return NULL;
     }
 
-    if (nodeRef->shadowRef == NULL)
+    if (parentRef->childIndexPtr == NULL)
     {
-        // If the node doesn't have a shadow reference, then most likely this is a new node and not
-        // a rename of an existing one.
-        return false;
+        size_t count = 0;
+
+        while (   (currentRef != NULL)
+               && (count < CHILD_INDEX_THRESHOLD))
+        {
+            if (GetNameRef(currentRef) == nameRef)
+            {
+                return currentRef;
+            }
+
+            currentRef = tdb_GetNextSiblingNode(currentRef);
+            count++;
+        }
+
+        if (currentRef == NULL)
+        {
+            return NULL;
+        }
+
+        BuildChildIndex(parentRef);
     }
 
-    if (nodeRef->nameRef == NULL)
+    currentRef = *GetIndexBucket(parentRef->childIndexPtr, dstr_GetHash(nameRef));
+
+    while (currentRef != NULL)
     {
-        // The shadow node does not have a local copy of a name, so it can not have been renamed.
-        // It must have been modified for other reasons.
-        return false;
+        if (GetNameRef(currentRef) == nameRef)
+        {
+            return currentRef;
+        }
+
+        currentRef = currentRef->nextIndexedRef;
     }
 
-    // Looks like the node has a new name.
-    return true;
+    return NULL;
 }
 
 
@@ -1248,26 +1452,36 @@ static bool WasRenamed
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the original non-shadow node to see if it will need to be cleared during the merge.
+ *  Called to look for a named child in a given node's child collection.
  *
- *  @return True if the merge will clear out the original value.  False if not.
+ *  @return Reference to the found child node, or NULL if a node was not found.
  */
 // -------------------------------------------------------------------------------------------------
-static bool OriginalToBeCleared
+static tdb_NodeRef_t GetNamedChild
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to check.
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
+    const char* nameRef     ///< [IN] The name we're searching for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
+    // Is this one of the "special" names?
+    if (strcmp(nameRef, ".") == 0)
+    {
+        return nodeRef;
+    }
 
-    if (   (nodeType == LE_CFG_TYPE_EMPTY)
-        || (nodeType != tdb_GetNodeType(nodeRef->shadowRef)))
+    if (strcmp(nameRef, "..") == 0)
     {
-        return true;
+        return nodeRef->parentRef;
     }
 
-    return false;
+    // If the current node isn't a stem, then this node can't have any children.
+    if (nodeRef->type != LE_CFG_TYPE_STEM)
+    {
+        return NULL;
+    }
+
+    return FindChild(nodeRef, nameRef);
 }
 
 
@@ -1275,27 +1489,47 @@ static bool OriginalToBeCleared
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Append the name of a node onto the end of a path object.
+ *  Called to create a named child in a nodes child collection.  However, this function will only
+ *  create nodes on shadow trees.
+ *
+ *  @return Reference to newly created child node, or NULL if it can not be created.
  */
 // -------------------------------------------------------------------------------------------------
-static void AppendNodeName
+static tdb_NodeRef_t CreateNamedChild
 (
-    le_pathIter_Ref_t pathRef,  ///< [IN] The path we're appending to.
-    tdb_NodeRef_t nodeRef       ///< [IN] The node we're appending.
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
+    const char* nameRef     ///< [IN] The name we're searching for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+    tdb_NodeRef_t childRef = NULL;
 
-    LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
-    le_result_t result = le_pathIter_Append(pathRef, nodeName);
+    if (IsShadow(nodeRef) == true)
+    {
+        // If the node isn't a stem, then convert it into an empty one now.
+        if (   (nodeRef->type != LE_CFG_TYPE_STEM)
+            && (nodeRef->type != LE_CFG_TYPE_EMPTY))
+        {
+            tdb_SetEmpty(nodeRef);
+            nodeRef->type = LE_CFG_TYPE_STEM;
+            nodeRef->info.children = LE_DLS_LIST_INIT;
+            DeleteChildIndex(nodeRef);
+        }
 
-    LE_WARN_IF(result != LE_OK,
-               "Could not append node '%s' onto the update callback tracking path.  "
-               "Reason: %d, '%s'.",
-               nodeName,
-               result,
-               LE_RESULT_TXT(result));
+        // Create the node, and set it's deleted flag as it hasn't been used for anything yet.
+        childRef = NewChildNode(nodeRef);
+        SetDeletedFlag(childRef);
+
+        // Set the name of the new node, if that fails then the user had given us a bad name for the
+        // new node.  So in that case free the node and return NULL.
+        if (tdb_SetNodeName(childRef, nameRef) != LE_OK)
+        {
+            le_mem_Release(childRef);
+            childRef = NULL;
+        }
+    }
+
+    return childRef;
 }
 
 
@@ -1303,21 +1537,19 @@ static void AppendNodeName
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new config path for the tree name given.
+ *  Check to see if a given node exists within a node's child collection.
  *
- *  @return A new config path, rooted on the given tree.
+ *  @return True if the given node exists within the parent node's collection.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static le_pathIter_Ref_t CreateBasePath
+static bool NodeExists
 (
-    const char* treeNamePtr  ///< [IN] The tree name to use for the new path object.
+    tdb_NodeRef_t parentRef,  ///< [IN] The parent node to search.
+    const char* namePtr       ///< [IN] The name to search for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char basePath[CFG_MAX_PATH_SIZE] = { 0 };
-
-    snprintf(basePath, sizeof(basePath), "%s:/", treeNamePtr);
-    return le_pathIter_CreateForUnix(basePath);
+    return FindChild(parentRef, namePtr) != NULL;
 }
 
 
@@ -1325,23 +1557,28 @@ static le_pathIter_Ref_t CreateBasePath
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Generate a config path to the given node.
+ *  Check the given node type and see if it should have a string value.
+ *
+ *  @return True if the given node could hold a string value.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static void GeneratePath
+static bool IsStringType
 (
-    le_pathIter_Ref_t pathRef,  ///< [IN] The path object we're updating.
-    tdb_NodeRef_t nodeRef       ///< [IN] The node we're creating a path for.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    if (nodeRef == NULL)
+    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
+
+    if (   (type == LE_CFG_TYPE_STRING)
+        || (type == LE_CFG_TYPE_BOOL)
+        || (type == LE_CFG_TYPE_INT)
+        || (type == LE_CFG_TYPE_FLOAT))
     {
-        return;
+        return true;
     }
 
-    GeneratePath(pathRef, nodeRef->parentRef);
-    AppendNodeName(pathRef, nodeRef);
+    return false;
 }
 
 
@@ -1349,36 +1586,34 @@ static void GeneratePath
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Trigger callbacks for this node and all of it's children.
+ *  This function will copy a string value from an original tree node into a node that has shadowed
+ *  it.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireAllChildren
+static void PropagateValue
 (
-    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of the current node.
-    tdb_NodeRef_t nodeRef       ///< [IN] Node and any children to merge.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node ref to update.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Add this node to the path we're using to find registered callbacks.
-    AppendNodeName(pathRef, nodeRef);
+    // If the node doesn't even have a ref to an original node, then there's nothing left to do
+    // here.
+    tdb_NodeRef_t shadowRef = nodeRef->shadowRef;
 
-    // If the node is a stem then traverse it's children and try to trigger callbacks for them.  If
-    // there are no callbacks registered for those nodes, then nothing will happen.
-    if (nodeRef->type == LE_CFG_TYPE_STEM)
+    if (shadowRef == NULL)
     {
-        tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
-
-        while (childRef != NULL)
-        {
-            FireAllChildren(pathRef, childRef);
-            childRef = tdb_GetNextSiblingNode(childRef);
-        }
+        return;
     }
 
-    // Like with the children, try to do the same for this node.  Then remove this node from the
-    // tracking path.
-    TriggerCallbacks(pathRef);
-    le_pathIter_Truncate(pathRef);
+    // Ok, figure out the type for this node.  If it has a value, and the original
+    if (   (IsStringType(nodeRef) == true)
+        && (IsStringType(shadowRef) == true)
+        && (nodeRef->info.valueRef == NULL)
+        && (shadowRef->info.valueRef != NULL))
+    {
+        // Looks like the value hasn't been propagated or changed yet.  So, do so now.
+        nodeRef->info.valueRef = dstr_NewFromDstr(shadowRef->info.valueRef);
+    }
 }
 
 
@@ -1386,176 +1621,118 @@ static void FireAllChildren
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check a given shadow node and the original node it's shadowing.  If the original has children
- *  that will be lost because of a merge, then we need to fire callbacks for those nodes that are
- *  about to go away.
- *
- *  The algorithm employed by this function is as follows:
- *
- *      1. Check the original node for the given shadow node.  If it exists and is a stem node,
- *         mark all of the children as deleted.  (This is done with the expectation that the
- *         original tree does not have nodes with the deleted flag set.)
- *
- *      2. Go through the shadow collection, and any shadow children that have links to the original
- *         nodes, clear the deleted flag.  These nodes are still considered "live."
- *
- *      3. Travers the original children one more time.  For any node that is still marked as
- *         deleted we queue up an event handler.  As this node has been removed from the colection
- *         and will be removed as part of the final merge.  The delete flag is also cleared at this
- *         step to ensure that there are no external side effects.
+ *  Merge a shadow node with the original it represents.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireLostChildren
+static void MergeNode
 (
-    le_pathIter_Ref_t pathRef,   ///< [IN] Path to the parent of the current node.
-    tdb_NodeRef_t shadowNodeRef  ///< [IN] Node and any children to merge.
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to merge.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Is the original a stem?  If no, then done.
-    tdb_NodeRef_t originalRef = shadowNodeRef->shadowRef;
-
-    if (originalRef->type != LE_CFG_TYPE_STEM)
-    {
-        return;
-    }
-
-    // Mark all originals deleted.
-    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
-
-    while (originalChildRef != NULL)
-    {
-        // Children in the original tree shouldn't currently be marked as deleted.
-        LE_ASSERT(IsDeleted(originalChildRef) == false);
-
-        SetDeletedFlag(originalChildRef);
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
-    }
+    LE_ASSERT(nodeRef != NULL);
 
-    // Follow through all of the shadow links and unmark deletions.
-    if (shadowNodeRef->type == LE_CFG_TYPE_STEM)
+    // If this shadow node for some reason doesn't have a ref check for an original version of it in
+    // the original tree.  This shadow node may have been destroyed and re-created loosing this
+    // link.
+    if (nodeRef->shadowRef == NULL)
     {
-        tdb_NodeRef_t shadowChildRef = tdb_GetFirstChildNode(shadowNodeRef);
+        tdb_NodeRef_t shadowedParentRef = tdb_GetNodeParent(nodeRef)->shadowRef;
 
-        while (shadowChildRef != NULL)
+        if (shadowedParentRef != NULL)
         {
-            if (shadowChildRef->shadowRef != NULL)
-            {
-                ClearDeletedFlag(shadowChildRef->shadowRef);
-            }
+            char name[LE_CFG_NAME_LEN_BYTES] = "";
 
-            shadowChildRef = tdb_GetNextSiblingNode(shadowChildRef);
+            tdb_GetNodeName(nodeRef, name, sizeof(name));
+            nodeRef->shadowRef = GetNamedChild(shadowedParentRef, name);
         }
     }
 
-    // Fire on all original nodes still marked.  But also take care to clear the deleted flags here
-    // in order to leave everything as it was.
-    originalChildRef = tdb_GetFirstChildNode(originalRef);
-
-    while (originalChildRef != NULL)
+    // If this node has been marked as deleted, then simply drop the original node and move on.
+    if (IsDeleted(nodeRef))
     {
-        if (IsDeleted(originalChildRef) == true)
+        if (   (nodeRef->shadowRef != NULL)
+            && (tdb_GetNodeParent(nodeRef->shadowRef) != NULL))
         {
-            FireAllChildren(pathRef, originalChildRef);
-            ClearDeletedFlag(originalChildRef);
+            le_mem_Release(nodeRef->shadowRef);
+        }
+        else
+        {
+            // We delete every node but the root node.  Since this is the root node, we just need
+            // to clear it out.
+            tdb_SetEmpty(nodeRef->shadowRef);
         }
 
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+        return;
     }
-}
-
-
 
+    // If the original node doesn't exist, create it now.
+    tdb_NodeRef_t originalRef = nodeRef->shadowRef;
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Recursive function to merge a collection of shadow nodes with the original tree.
- *
- *  @return True if the given node or any if it's children have been modified.  False if not.
- */
-// -------------------------------------------------------------------------------------------------
-static bool InternalMergeTree
-(
-    const char* treeNamePtr,    ///< [IN] The name of the tree we're merging.
-    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of hte current node.
-    tdb_NodeRef_t nodeRef,      ///< [IN] Node and any children to merge.
-    bool forceFire              ///< [IN] Should update handlers be fired for this node and all it's
-                                ///<      children, regardless of wether or not this node has been
-                                ///<      directly modified?
-)
-// -------------------------------------------------------------------------------------------------
-{
-    bool isModified = IsModified(nodeRef);
-    bool renamed = WasRenamed(nodeRef);
+    if (originalRef == NULL)
+    {
+        LE_ASSERT(nodeRef->parentRef != NULL);
+        LE_ASSERT(nodeRef->parentRef->shadowRef != NULL);
 
-    // If this node was renamed, then all children also need to be triggered as well.
-    forceFire = renamed || forceFire;
+        nodeRef->shadowRef = originalRef = NewChildNode(nodeRef->parentRef->shadowRef);
+    }
 
-    // If this node has been renamed, marked as deleted or set empty, then all of the children need
-    // notifications fired on the original nodes.
-    if (   (renamed == true)
-        || (IsDeleted(nodeRef) == true)
-        || (OriginalToBeCleared(nodeRef) == true))
+    // If the name has been changed, then copy it over now.
+    if (   (dstr_IsNullOrEmpty(nodeRef->nameRef) == false)
+        && (nodeRef->nameRef != originalRef->nameRef))
     {
-        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
-
-        if (nodeRef->shadowRef != NULL)
+        if (originalRef->nameRef != NULL)
         {
-            GeneratePath(originalPathRef, nodeRef->shadowRef->parentRef);
-            FireAllChildren(originalPathRef, nodeRef->shadowRef);
+            dstr_Release(originalRef->nameRef);
         }
 
-        le_pathIter_Delete(originalPathRef);
-    }
-    else if (   (isModified == true)
-             && (nodeRef->type == LE_CFG_TYPE_STEM))
-    {
-        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
-
-        GeneratePath(originalPathRef, nodeRef->shadowRef);
-        FireLostChildren(originalPathRef, nodeRef);
+        originalRef->nameRef = dstr_NewFromDstr(nodeRef->nameRef);
 
-        le_pathIter_Delete(originalPathRef);
+        UnindexChild(originalRef);
+        IndexChild(originalRef);
     }
 
-    AppendNodeName(pathRef, nodeRef);
+    // Check the types of the original and the shadow nodes.  If the new node has been cleared,
+    // then clear out the original node.  If the types have changed, then clear out the original so
+    // that we can properly populate it again.
+    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
 
-    // IF this node is modified, mearge it.  If this node is a stem, then merge it's children.  Keep
-    // track of whether any of those children have been modified as well.
-    if (isModified)
+    if (   (nodeType == LE_CFG_TYPE_EMPTY)
+        || (nodeType != originalRef->type))
     {
-        MergeNode(nodeRef);
+        tdb_SetEmpty(originalRef);
     }
 
-    if (   (nodeRef->type == LE_CFG_TYPE_STEM)
-        && (IsDeleted(nodeRef) == false))
+    // Ok, we know that the node hasn't been deleted.  Check to see if it's considered empty and
+    // that it isn't a stem.  If not, then copy over the string value.
+    if (   (nodeType != LE_CFG_TYPE_EMPTY)
+        && (nodeType != LE_CFG_TYPE_STEM))
     {
-        nodeRef = tdb_GetFirstChildNode(nodeRef);
-
-        while (nodeRef != NULL)
+        if (nodeRef->info.valueRef != NULL)
         {
-            tdb_NodeRef_t nextNodeRef = tdb_GetNextSiblingNode(nodeRef);
+            if (originalRef->info.valueRef != NULL)
+            {
+                dstr_Release(originalRef->info.valueRef);
+            }
 
-            isModified = InternalMergeTree(treeNamePtr, pathRef, nodeRef, forceFire) || isModified;
-            nodeRef = nextNodeRef;
+            originalRef->info.valueRef = dstr_NewFromDstr(nodeRef->info.valueRef);
+
+            // Propigate over the type as that may have changed, like going from an int value to a
+            // bool value.
+
+            originalRef->type = nodeRef->type;
         }
     }
 
-    // If this node, or any of it's children have been modified.  Try to fire any callbacks that may
-    // be registered.
-    if (isModified || forceFire)
-    {
-        TriggerCallbacks(pathRef);
-    }
+    // Clearing the original, above, flags it as modified.  Make sure that the flag doesn't stick,
+    // because shadow nodes inherit the flags of the nodes they shadow.
+    ClearModifiedFlag(originalRef);
 
-    // Now remove this node from the tracking path and let our caller know if any modifications have
-    // happened at this level or lower.
-    if (le_pathIter_GoToEnd(pathRef) == LE_OK)
-    {
-        le_pathIter_Truncate(pathRef);
-    }
+    // Now at this point, if both the original and the shadow node are stems, we'll let the function
+    // InternalMergeTree take care of the children, (if any.)
 
-    return isModified;
+    // If the original has been cleared out, we can still just rely on InternalMergeTree to
+    // propigate over the new nodes.
 }
 
 
@@ -1563,98 +1740,76 @@ static bool InternalMergeTree
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new tree object and set it to default values.
- *
- *  @return A ref to the newly created tree object.
+ *  Called to fire any callbacks registered on the given node path.  If nothing is registered on the
+ *  given path, nothing happens.
  */
 // -------------------------------------------------------------------------------------------------
-tdb_TreeRef_t NewTree
+static void TriggerCallbacks
 (
-    const char* treeNameRef,   ///< [IN] The name of the new tree.
-    tdb_NodeRef_t rootNodeRef  ///< [IN] The root node of this new tree.
+    le_pathIter_Ref_t pathRef  ///< [IN] The path to search for callback registrations.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_TreeRef_t treeRef = le_mem_ForceAlloc(TreePoolRef);
-
-    LE_ASSERT(le_utf8_Copy(treeRef->name, treeNameRef, MAX_TREE_NAME_BYTES, NULL) == LE_OK);
+    // Read the path out of the buffer.
+    char pathBuffer[CFG_MAX_PATH_SIZE] = { 0 };
+    if (le_pathIter_GetPath(pathRef, pathBuffer, sizeof(pathBuffer)) != LE_OK)
+    {
+        LE_ERROR("Callback path buffer overflow.");
+        return;
+    }
 
-    treeRef->isDeletePending = false;
-    treeRef->originalTreeRef = NULL;
-    treeRef->revisionId = 0;
-    treeRef->rootNodeRef = (rootNodeRef != NULL) ? rootNodeRef : NewNode();
-    treeRef->activeReadCount = 0;
-    treeRef->activeWriteIterRef = NULL;
-    treeRef->requestList = LE_SLS_LIST_INIT;
+    // Try to find a registration object for this path.  If one is found, flag it for calling once
+    // the merge is complete.
+    Registration_t* foundRegistrationPtr = le_hashmap_Get(HandlerRegistrationMap, pathBuffer);
 
-    return treeRef;
+    if (foundRegistrationPtr != NULL)
+    {
+        foundRegistrationPtr->triggered = true;
+    }
 }
 
 
 
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Destructor called when a tree object is to be freed from memory.
- */
-// -------------------------------------------------------------------------------------------------
-static void TreeDestructor
-(
-    void* objectPtr  ///< The memory object to destruct.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    tdb_TreeRef_t treeRef = (tdb_TreeRef_t)objectPtr;
-
-    // Kill the root node.
-    le_mem_Release(treeRef->rootNodeRef);
-    treeRef->rootNodeRef = NULL;
-
-    // Sanity check, is the tree actually ready to clean up?
-    LE_ASSERT(treeRef->activeReadCount == 0);
-    LE_ASSERT(treeRef->activeWriteIterRef == NULL);
-    LE_ASSERT(le_sls_IsEmpty(&treeRef->requestList) == true);
-}
-
-
-
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a path to a tree file with the given revision id.
+ *  Go through all of the registered event callbacks, and fire the call backs for each of the
+ *  registrations that has been makred as triggered.
  *
- *  @return A stringBuffer backed string containing the full path to the tree file.
+ *  Once this is done, the triggered flag is cleared for next time.
  */
 // -------------------------------------------------------------------------------------------------
-static void GetTreePath
+static void FireTriggeredCallbacks
 (
-    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
-    int revisionId,           ///< [IN] Generate a name based on the tree revision.
-    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
-    size_t pathSize           ///< [IN] Size of the path buffer.
+    void
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // paper    --> rock       1 -> 2
-    // rock     --> scissors   2 -> 3
-    // scissors --> paper      3 -> 1
+    // Go through the registration map.
+    le_hashmap_It_Ref_t handlerIterRef = le_hashmap_GetIterator(HandlerRegistrationMap);
 
-    static const char* revNames[] = { "paper", "rock", "scissors" };
-    int printSize;
+    while (le_hashmap_NextNode(handlerIterRef) == LE_OK)
+    {
+        // For each registration, check to see if it was triggered.
+        Registration_t* registrationPtr = (Registration_t*)le_hashmap_GetValue(handlerIterRef);
 
-    LE_ASSERT((revisionId >= 1) && (revisionId <= 3));
+        if (registrationPtr->triggered)
+        {
+            // This registration has been triggered, so call all of the handlers attached to it.
+            le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
 
-    printSize = snprintf(pathBuffer,
-                         pathSize,
-                         "%s/%s.%s",
-                         CFG_TREE_PATH,
-                         treeNameRef,
-                         revNames[revisionId - 1]);
+            while (linkPtr != NULL)
+            {
+                Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
 
-    if (printSize >= pathSize)
-    {
-       LE_ERROR("Unable to store config tree path in buffer");
-       pathBuffer[0] = '\0';
+                handlerObjectPtr->handlerPtr(handlerObjectPtr->contextPtr);
+                linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
+            }
+
+            // Now that that's done, clear the triggered flag.
+            registrationPtr->triggered = false;
+        }
     }
 }
 
@@ -1663,56 +1818,38 @@ static void GetTreePath
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check to see if a configTree file at the given revision already exists in the filesystem.
- *
- *  @note If the tree file exists, but is empty, then it is invalid and will be deleted.
+ *  Check the given node to see if it was renamed.
  *
- *  @return True if the named file exists, false otherwise.
+ *  @return True if the node was renamed within this transaction.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static bool TreeFileExists
+static bool WasRenamed
 (
-    const char* treeNameRef,  ///< [IN] Name of the tree to check.
-    int revisionId            ///< [IN] The revision of the tree to check against.
+    tdb_NodeRef_t nodeRef  ///< [IN] Check this node to see if it was renamed in this transaction.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char fullPath[LE_CFG_STR_LEN_BYTES] = "";
-    GetTreePath(treeNameRef, revisionId, fullPath, sizeof(fullPath));
-
-    // Make sure this part was successful.
-    if (fullPath[0] == '\0')
+    if (IsModified(nodeRef) == false)
     {
+        // The node wasn't even modified, so it can not have been renamed.
         return false;
     }
 
-    // stat() the file to see if it exists and get its size.
-    struct stat s;
-    if (stat(fullPath, &s) == -1)
+    if (nodeRef->shadowRef == NULL)
     {
-        LE_DEBUG("Can't stat file '%s' (%m).", fullPath);
+        // If the node doesn't have a shadow reference, then most likely this is a new node and not
+        // a rename of an existing one.
         return false;
     }
 
-    // Make sure it's a regular file.
-    if (!S_ISREG(s.st_mode))
-    {
-        LE_FATAL("Object at '%s' is not a regular file.", fullPath);
-    }
-
-    // If it's zero size, delete it and report that it doesn't exist.
-    if (s.st_size == 0)
+    if (nodeRef->nameRef == NULL)
     {
-        if (unlink(fullPath) == -1)
-        {
-            LE_FATAL("Failed to unlink empty file '%s' (%m).", fullPath);
-        }
-
+        // The shadow node does not have a local copy of a name, so it can not have been renamed.
+        // It must have been modified for other reasons.
         return false;
     }
 
-    // NOTE: The Config Tree generally runs as root, so permissions should be irrelevant.
-
+    // Looks like the node has a new name.
     return true;
 }
 
@@ -1721,52 +1858,26 @@ static bool TreeFileExists
 
 // -------------------------------------------------------------------------------------------------
 /**
- * Check the filesystem and get the current "valid" version of the file and update the tree object
- * with that version number.
+ *  Check the original non-shadow node to see if it will need to be cleared during the merge.
  *
- * If there are two files for a given tree, we use the older one.  The idea being, if there are
- * two versions of the same file in the filesystem then there was a system failure during a save
- * operation.  So we abandon the newer (probably incomplete) file and go with the older file;
- * unless the size of the older file is zero, which can happen if deletion of that file is
- * interrupted.
+ *  @return True if the merge will clear out the original value.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static void UpdateRevision
+static bool OriginalToBeCleared
 (
-    tdb_TreeRef_t treeRef  ///< [IN] Update the revision for this tree object.
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to check.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    int newRevision = 0;
+    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
 
-    if (TreeFileExists(treeRef->name, 1))
-    {
-        if (TreeFileExists(treeRef->name, 3))
-        {
-            newRevision = 3;
-        }
-        else
-        {
-            newRevision = 1;
-        }
-    }
-    else if (TreeFileExists(treeRef->name, 3))
-    {
-        if (TreeFileExists(treeRef->name, 2))
-        {
-            newRevision = 2;
-        }
-        else
-        {
-            newRevision = 3;
-        }
-    }
-    else if (TreeFileExists(treeRef->name, 2))
+    if (   (nodeType == LE_CFG_TYPE_EMPTY)
+        || (nodeType != tdb_GetNodeType(nodeRef->shadowRef)))
     {
-        newRevision = 2;
+        return true;
     }
 
-    treeRef->revisionId = newRevision;
+    return false;
 }
 
 
@@ -1774,19 +1885,27 @@ static void UpdateRevision
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Peek into the input stream one character ahead.
+ *  Append the name of a node onto the end of a path object.
  */
 // -------------------------------------------------------------------------------------------------
-static signed char PeekChar
+static void AppendNodeName
 (
-    FILE* filePtr  ///< [IN] The file stream to peek into.
+    le_pathIter_Ref_t pathRef,  ///< [IN] The path we're appending to.
+    tdb_NodeRef_t nodeRef       ///< [IN] The node we're appending.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char next = fgetc(filePtr);
-    ungetc(next, filePtr);
+    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
 
-    return next;
+    LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+    le_result_t result = le_pathIter_Append(pathRef, nodeName);
+
+    LE_WARN_IF(result != LE_OK,
+               "Could not append node '%s' onto the update callback tracking path.  "
+               "Reason: %d, '%s'.",
+               nodeName,
+               result,
+               LE_RESULT_TXT(result));
 }
 
 
@@ -1794,45 +1913,21 @@ static signed char PeekChar
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Skip any whitespace encountered in the input stream.  Stop skipping once we hit a valid token.
+ *  Create a new config path for the tree name given.
  *
- *  @return LE_OK if the whitespace is skiped and there is still more file to read.
- *          LE_OUT_OF_RANGE if the end of the file is hit.
+ *  @return A new config path, rooted on the given tree.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t SkipWhiteSpace
+static le_pathIter_Ref_t CreateBasePath
 (
-    FILE* filePtr  ///< [IN] The file stream to seek through.
+    const char* treeNamePtr  ///< [IN] The tree name to use for the new path object.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    bool done = false;
-    bool isEof = false;
-
-    while (done == false)
-    {
-        switch (PeekChar(filePtr))
-        {
-            case '\n':
-            case '\r':
-            case '\t':
-            case ' ':
-                // Eat the character.
-                fgetc(filePtr);
-                break;
-
-            case EOF:
-                done = true;
-                isEof = true;
-                break;
-
-            default:
-                done = true;
-                break;
-        }
-    }
+    char basePath[CFG_MAX_PATH_SIZE] = { 0 };
 
-    return isEof == true ? LE_OUT_OF_RANGE : LE_OK;
+    snprintf(basePath, sizeof(basePath), "%s:/", treeNamePtr);
+    return le_pathIter_CreateForUnix(basePath);
 }
 
 
@@ -1840,32 +1935,23 @@ static le_result_t SkipWhiteSpace
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a boolean literal from the input file.
- *
- *  @return LE_OK if the literal could be read.
- *          LE_FORMAT_ERROR if the literal could not be read.
+ *  Generate a config path to the given node.
  */
 // -------------------------------------------------------------------------------------------------
-static bool ReadBoolToken
+static void GeneratePath
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    le_pathIter_Ref_t pathRef,  ///< [IN] The path object we're updating.
+    tdb_NodeRef_t nodeRef       ///< [IN] The node we're creating a path for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    signed char next = fgetc(filePtr);
-
-    if (   (next == 't')
-        || (next == 'f'))
+    if (nodeRef == NULL)
     {
-        stringPtr[0] = next;
-        stringPtr[1] = 0;
-
-        return LE_OK;
+        return;
     }
 
-    return LE_FORMAT_ERROR;
+    GeneratePath(pathRef, nodeRef->parentRef);
+    AppendNodeName(pathRef, nodeRef);
 }
 
 
@@ -1873,67 +1959,36 @@ static bool ReadBoolToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a textual literal from the input file, the read is terminated successfuly if the terminal
- *  character is found.
- *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  Trigger callbacks for this node and all of it's children.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadTextLiteral
+static void FireAllChildren
 (
-    FILE* filePtr,        ///< [IN]  The file we're reading from.
-    char* stringPtr,      ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize,    ///< [IN]  How big is the supplied string buffer?
-    signed char terminal  ///< [IN]  The terminal character we're searching for.
+    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of the current node.
+    tdb_NodeRef_t nodeRef       ///< [IN] Node and any children to merge.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    signed char next;
-    size_t count = 0;
-
-    char* oldPtr = stringPtr;
+    // Add this node to the path we're using to find registered callbacks.
+    AppendNodeName(pathRef, nodeRef);
 
-    while ((next = fgetc(filePtr)) != terminal)
+    // If the node is a stem then traverse it's children and try to trigger callbacks for them.  If
+    // there are no callbacks registered for those nodes, then nothing will happen.
+    if (nodeRef->type == LE_CFG_TYPE_STEM)
     {
-        if (next == EOF)
-        {
-            LE_ERROR("Missing end specifier, ']' in int value.");
-            return LE_FORMAT_ERROR;
-        }
-
-        if (next == '\\')
-        {
-            next = fgetc(filePtr);
-
-            if (next == EOF)
-            {
-                LE_ERROR("Unexpected EOF after finding \\ character.");
-                return LE_FORMAT_ERROR;
-            }
-        }
-
-        *stringPtr = next;
-
-        ++stringPtr;
-        ++count;
+        tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
 
-        if (count >= (stringSize - 1))
+        while (childRef != NULL)
         {
-            *stringPtr = 0;
-
-            LE_ERROR("String literal, '%s', too large.  (%zd/%zd)",
-                     oldPtr,
-                     strlen(oldPtr),
-                     stringSize);
-
-            return LE_FORMAT_ERROR;
+            FireAllChildren(pathRef, childRef);
+            childRef = tdb_GetNextSiblingNode(childRef);
         }
     }
 
-    *stringPtr = 0;
-
-    return LE_OK;
+    // Like with the children, try to do the same for this node.  Then remove this node from the
+    // tracking path.
+    TriggerCallbacks(pathRef);
+    le_pathIter_Truncate(pathRef);
 }
 
 
@@ -1941,51 +1996,82 @@ static le_result_t ReadTextLiteral
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read an integer token string from the file.
+ *  Check a given shadow node and the original node it's shadowing.  If the original has children
+ *  that will be lost because of a merge, then we need to fire callbacks for those nodes that are
+ *  about to go away.
  *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  The algorithm employed by this function is as follows:
+ *
+ *      1. Check the original node for the given shadow node.  If it exists and is a stem node,
+ *         mark all of the children as deleted.  (This is done with the expectation that the
+ *         original tree does not have nodes with the deleted flag set.)
+ *
+ *      2. Go through the shadow collection, and any shadow children that have links to the original
+ *         nodes, clear the deleted flag.  These nodes are still considered "live."
+ *
+ *      3. Travers the original children one more time.  For any node that is still marked as
+ *         deleted we queue up an event handler.  As this node has been removed from the colection
+ *         and will be removed as part of the final merge.  The delete flag is also cleared at this
+ *         step to ensure that there are no external side effects.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadIntToken
+static void FireLostChildren
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    le_pathIter_Ref_t pathRef,   ///< [IN] Path to the parent of the current node.
+    tdb_NodeRef_t shadowNodeRef  ///< [IN] Node and any children to merge.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ']');
+    // Is the original a stem?  If no, then done.
+    tdb_NodeRef_t originalRef = shadowNodeRef->shadowRef;
 
-    // TODO: Validate the int string.
+    if (originalRef->type != LE_CFG_TYPE_STEM)
+    {
+        return;
+    }
 
-    return result;
-}
+    // Mark all originals deleted.
+    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
+
+    while (originalChildRef != NULL)
+    {
+        // Children in the original tree shouldn't currently be marked as deleted.
+        LE_ASSERT(IsDeleted(originalChildRef) == false);
 
+        SetDeletedFlag(originalChildRef);
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
 
+    // Follow through all of the shadow links and unmark deletions.
+    if (shadowNodeRef->type == LE_CFG_TYPE_STEM)
+    {
+        tdb_NodeRef_t shadowChildRef = tdb_GetFirstChildNode(shadowNodeRef);
 
+        while (shadowChildRef != NULL)
+        {
+            if (shadowChildRef->shadowRef != NULL)
+            {
+                ClearDeletedFlag(shadowChildRef->shadowRef);
+            }
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Read a floating point token string from the file.
- *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
- */
-// -------------------------------------------------------------------------------------------------
-static le_result_t ReadFloatToken
-(
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
-)
-// -------------------------------------------------------------------------------------------------
-{
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ')');
+            shadowChildRef = tdb_GetNextSiblingNode(shadowChildRef);
+        }
+    }
 
-    // TODO: Validate the float string.
+    // Fire on all original nodes still marked.  But also take care to clear the deleted flags here
+    // in order to leave everything as it was.
+    originalChildRef = tdb_GetFirstChildNode(originalRef);
 
-    return result;
+    while (originalChildRef != NULL)
+    {
+        if (IsDeleted(originalChildRef) == true)
+        {
+            FireAllChildren(pathRef, originalChildRef);
+            ClearDeletedFlag(originalChildRef);
+        }
+
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
 }
 
 
@@ -1993,95 +2079,93 @@ static le_result_t ReadFloatToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a string from the config tree file.
+ *  Recursive function to merge a collection of shadow nodes with the original tree.
  *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *  @return True if the given node or any if it's children have been modified.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadStringToken
+static bool InternalMergeTree
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    const char* treeNamePtr,    ///< [IN] The name of the tree we're merging.
+    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of hte current node.
+    tdb_NodeRef_t nodeRef,      ///< [IN] Node and any children to merge.
+    bool forceFire              ///< [IN] Should update handlers be fired for this node and all it's
+                                ///<      children, regardless of wether or not this node has been
+                                ///<      directly modified?
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, '"');
+    bool isModified = IsModified(nodeRef);
+    bool renamed = WasRenamed(nodeRef);
 
-    // TODO: Validate the literal string.
+    // If this node was renamed, then all children also need to be triggered as well.
+    forceFire = renamed || forceFire;
 
-    return result;
-}
+    // If this node has been renamed, marked as deleted or set empty, then all of the children need
+    // notifications fired on the original nodes.
+    if (   (renamed == true)
+        || (IsDeleted(nodeRef) == true)
+        || (OriginalToBeCleared(nodeRef) == true))
+    {
+        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
 
+        if (nodeRef->shadowRef != NULL)
+        {
+            GeneratePath(originalPathRef, nodeRef->shadowRef->parentRef);
+            FireAllChildren(originalPathRef, nodeRef->shadowRef);
+        }
 
+        le_pathIter_Delete(originalPathRef);
+    }
+    else if (   (isModified == true)
+             && (nodeRef->type == LE_CFG_TYPE_STEM))
+    {
+        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
 
+        GeneratePath(originalPathRef, nodeRef->shadowRef);
+        FireLostChildren(originalPathRef, nodeRef);
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Read a token from the input stream.
- *
- *  @return LE_OK if a token could be read.  LE_OUT_OF_RANGE if the end of the stream is reached
- *          before a token could be finished.
- */
-// -------------------------------------------------------------------------------------------------
-static le_result_t ReadToken
-(
-    FILE* filePtr,         ///< [IN]  The file we're reading from.
-    char* stringPtr,       ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize,     ///< [IN]  How big is the supplied string buffer?
-    TokenType_t* typePtr   ///< [OUT] The type of token read from the file.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    *stringPtr = 0;
+        le_pathIter_Delete(originalPathRef);
+    }
 
-    if (SkipWhiteSpace(filePtr) != LE_OK)
+    AppendNodeName(pathRef, nodeRef);
+
+    // IF this node is modified, mearge it.  If this node is a stem, then merge it's children.  Keep
+    // track of whether any of those children have been modified as well.
+    if (isModified)
     {
-        return LE_OUT_OF_RANGE;
+        MergeNode(nodeRef);
     }
 
-    signed char next;
-
-    while ((next = fgetc(filePtr)) != EOF)
+    if (   (nodeRef->type == LE_CFG_TYPE_STEM)
+        && (IsDeleted(nodeRef) == false))
     {
-        switch (next)
-        {
-            case '~':
-                *typePtr = TT_EMPTY_VALUE;
-                return LE_OK;
-
-            case '!':
-                *typePtr = TT_BOOL_VALUE;
-                return ReadBoolToken(filePtr, stringPtr, stringSize);
-
-            case '[':
-                *typePtr = TT_INT_VALUE;
-                return ReadIntToken(filePtr, stringPtr, stringSize);
-
-            case '(':
-                *typePtr = TT_FLOAT_VALUE;
-                return ReadFloatToken(filePtr, stringPtr, stringSize);
+        nodeRef = tdb_GetFirstChildNode(nodeRef);
 
-            case '\"':
-                *typePtr = TT_STRING_VALUE;
-                return ReadStringToken(filePtr, stringPtr, stringSize);
+        while (nodeRef != NULL)
+        {
+            tdb_NodeRef_t nextNodeRef = tdb_GetNextSiblingNode(nodeRef);
 
-            case '{':
-                *typePtr = TT_OPEN_GROUP;
-                return LE_OK;
+            isModified = InternalMergeTree(treeNamePtr, pathRef, nodeRef, forceFire) || isModified;
+            nodeRef = nextNodeRef;
+        }
+    }
 
-            case '}':
-                *typePtr = TT_CLOSE_GROUP;
-                return LE_OK;
+    // If this node, or any of it's children have been modified.  Try to fire any callbacks that may
+    // be registered.
+    if (isModified || forceFire)
+    {
+        TriggerCallbacks(pathRef);
+    }
 
-            default:
-                LE_ERROR("Unexpected character in input stream.");
-                return LE_FORMAT_ERROR;
-        }
+    // Now remove this node from the tracking path and let our caller know if any modifications have
+    // happened at this level or lower.
+    if (le_pathIter_GoToEnd(pathRef) == LE_OK)
+    {
+        le_pathIter_Truncate(pathRef);
     }
 
-    return LE_OUT_OF_RANGE;
+    return isModified;
 }
 
 
@@ -2089,83 +2173,164 @@ static le_result_t ReadToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Write data to the output stream.  This function will record any faults to the system log.
+ *  Create a new tree object and set it to default values.
  *
- *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ *  @return A ref to the newly created tree object.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t WriteFile
+tdb_TreeRef_t NewTree
 (
-    FILE* filePtr,        ///< [IN] The file being written to.
-    const void* dataPtr,  ///< [IN] The data being written to the file.
-    size_t dataSize       ///< [IN] The amount of data being written.
+    const char* treeNameRef,   ///< [IN] The name of the new tree.
+    tdb_NodeRef_t rootNodeRef  ///< [IN] The root node of this new tree.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    ssize_t written = fwrite(dataPtr, 1, dataSize, filePtr);
+    tdb_TreeRef_t treeRef = le_mem_ForceAlloc(TreePoolRef);
 
-    if (ferror(filePtr) != 0)
+    LE_ASSERT(le_utf8_Copy(treeRef->name, treeNameRef, MAX_TREE_NAME_BYTES, NULL) == LE_OK);
+
+    treeRef->isDeletePending = false;
+    treeRef->originalTreeRef = NULL;
+    treeRef->revisionId = 0;
+    treeRef->rootNodeRef = (rootNodeRef != NULL) ? rootNodeRef : NewNode();
+    treeRef->activeReadCount = 0;
+    treeRef->activeWriteIterRef = NULL;
+    treeRef->requestList = LE_SLS_LIST_INIT;
+    treeRef->journalBytes = 0;
+    treeRef->compactTimerRef = NULL;
+    treeRef->snapshotPtr = NULL;
+    treeRef->snapshotSize = 0;
+
+    return treeRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Unmap a tree's snapshot, if it has one mapped.  None of the tree's nodes may still be waiting to
+ *  be loaded from it.
+ */
+// -------------------------------------------------------------------------------------------------
+static void ReleaseSnapshot
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to update.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (treeRef->snapshotPtr != NULL)
     {
-        LE_EMERG("Failed to write to config tree file.");
-        return LE_IO_ERROR;
+        LE_ERROR_IF(munmap(treeRef->snapshotPtr, treeRef->snapshotSize) == -1,
+                    "Failed to unmap the snapshot of tree '%s' (%m).",
+                    treeRef->name);
+
+        treeRef->snapshotPtr = NULL;
+        treeRef->snapshotSize = 0;
     }
+}
 
-    if (written < dataSize)
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Destructor called when a tree object is to be freed from memory.
+ */
+// -------------------------------------------------------------------------------------------------
+static void TreeDestructor
+(
+    void* objectPtr  ///< The memory object to destruct.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_TreeRef_t treeRef = (tdb_TreeRef_t)objectPtr;
+
+    // Kill the root node.  Once it's gone, nothing refers to the tree's snapshot any more.
+    le_mem_Release(treeRef->rootNodeRef);
+    treeRef->rootNodeRef = NULL;
+
+    ReleaseSnapshot(treeRef);
+
+    if (treeRef->compactTimerRef != NULL)
     {
-        LE_EMERG("Data truncated while writing to configuration file.");
-        return LE_IO_ERROR;
+        le_timer_Delete(treeRef->compactTimerRef);
+        treeRef->compactTimerRef = NULL;
     }
 
-    return LE_OK;
+    // Sanity check, is the tree actually ready to clean up?
+    LE_ASSERT(treeRef->activeReadCount == 0);
+    LE_ASSERT(treeRef->activeWriteIterRef == NULL);
+    LE_ASSERT(le_sls_IsEmpty(&treeRef->requestList) == true);
 }
 
 
 
+
 // -------------------------------------------------------------------------------------------------
 /**
- *  Write a string token to the output stream.  This function will write the string and escape all
- *  control characters as it does so.
+ *  Create a path to a tree file with the given revision id.
  *
- *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ *  @return A stringBuffer backed string containing the full path to the tree file.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t WriteStringValue
+static void GetTreePath
 (
-    FILE* filePtr,         ///< [IN] The file to write to.
-    char startChar,        ///< [IN] The delimiter to use.
-    char endChar,          ///< [IN] The closing delimiter to use.
-    const char* stringPtr  ///< [IN] The actual string to write.
+    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
+    int revisionId,           ///< [IN] Generate a name based on the tree revision.
+    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
+    size_t pathSize           ///< [IN] Size of the path buffer.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = LE_OK;
+    // paper    --> rock       1 -> 2
+    // rock     --> scissors   2 -> 3
+    // scissors --> paper      3 -> 1
 
-    result = WriteFile(filePtr, &startChar, 1);
+    static const char* revNames[] = { "paper", "rock", "scissors" };
+    int printSize;
 
-    while (   (*stringPtr != 0)
-           && (result == LE_OK))
-    {
-        if (   (*stringPtr == '\"')
-            || (*stringPtr == '\\'))
-        {
-            result = WriteFile(filePtr, "\\", 1);
-        }
+    LE_ASSERT((revisionId >= 1) && (revisionId <= 3));
 
-        if (result == LE_OK)
-        {
-            result = WriteFile(filePtr, stringPtr, 1);
-        }
+    printSize = snprintf(pathBuffer,
+                         pathSize,
+                         "%s/%s.%s",
+                         CFG_TREE_PATH,
+                         treeNameRef,
+                         revNames[revisionId - 1]);
 
-        stringPtr++;
+    if (printSize >= pathSize)
+    {
+       LE_ERROR("Unable to store config tree path in buffer");
+       pathBuffer[0] = '\0';
     }
+}
 
-    if (result == LE_OK)
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a path to the journal that goes with the tree file of the given revision id.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GetJournalPath
+(
+    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
+    int revisionId,           ///< [IN] Generate a name based on the tree revision.
+    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
+    size_t pathSize           ///< [IN] Size of the path buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    GetTreePath(treeNameRef, revisionId, pathBuffer, pathSize);
+
+    if (   (pathBuffer[0] != '\0')
+        && (le_utf8_Append(pathBuffer, ".journal", pathSize, NULL) != LE_OK))
     {
-        char strBuffer[2] = { endChar, ' ' };
-        result = WriteFile(filePtr, strBuffer, sizeof(strBuffer));
+       LE_ERROR("Unable to store config journal path in buffer");
+       pathBuffer[0] = '\0';
     }
-
-    return result;
 }
 
 
@@ -2173,55 +2338,565 @@ static le_result_t WriteStringValue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a node value from the given file.  If the value is a collection, then read in those nodes
- *  too.
+ *  Check to see if a configTree file at the given revision already exists in the filesystem.
  *
- *  @return LE_OK if the read is successful.
- *          LE_FORMAT_ERROR if parse errors are encountered.
- *          LE_NOT_FOUND if the end of file is reached.
+ *  @note If the tree file exists, but is empty, then it is invalid and will be deleted.
+ *
+ *  @return True if the named file exists, false otherwise.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t InternalReadNode
+static bool TreeFileExists
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node we're reading a value for.
-    FILE* filePtr,          ///< [IN] The file we're reading the value from.
-    size_t pathLen          ///< [IN] The length of the path including nodeRef.
+    const char* treeNameRef,  ///< [IN] Name of the tree to check.
+    int revisionId            ///< [IN] The revision of the tree to check against.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    char fullPath[LE_CFG_STR_LEN_BYTES] = "";
+    GetTreePath(treeNameRef, revisionId, fullPath, sizeof(fullPath));
 
-    TokenType_t tokenType;
+    // Make sure this part was successful.
+    if (fullPath[0] == '\0')
+    {
+        return false;
+    }
 
-    // Try to read this node's value.
-    if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
+    // stat() the file to see if it exists and get its size.
+    struct stat s;
+    if (stat(fullPath, &s) == -1)
     {
-        LE_ERROR("Unexpected EOF or bad token in file.");
-        return LE_FORMAT_ERROR;
+        LE_DEBUG("Can't stat file '%s' (%m).", fullPath);
+        return false;
     }
 
-    tdb_SetEmpty(nodeRef);
+    // Make sure it's a regular file.
+    if (!S_ISREG(s.st_mode))
+    {
+        LE_FATAL("Object at '%s' is not a regular file.", fullPath);
+    }
 
-    switch (tokenType)
+    // If it's zero size, delete it and report that it doesn't exist.
+    if (s.st_size == 0)
     {
-        case TT_BOOL_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_BOOL;
-            break;
+        if (unlink(fullPath) == -1)
+        {
+            LE_FATAL("Failed to unlink empty file '%s' (%m).", fullPath);
+        }
 
-        case TT_INT_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_INT;
-            break;
+        return false;
+    }
 
-        case TT_FLOAT_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_FLOAT;
-            break;
+    // NOTE: The Config Tree generally runs as root, so permissions should be irrelevant.
 
-        case TT_STRING_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            break;
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * Check the filesystem and get the current "valid" version of the file and update the tree object
+ * with that version number.
+ *
+ * If there are two files for a given tree, we use the older one.  The idea being, if there are
+ * two versions of the same file in the filesystem then there was a system failure during a save
+ * operation.  So we abandon the newer (probably incomplete) file and go with the older file;
+ * unless the size of the older file is zero, which can happen if deletion of that file is
+ * interrupted.
+ */
+// -------------------------------------------------------------------------------------------------
+static void UpdateRevision
+(
+    tdb_TreeRef_t treeRef  ///< [IN] Update the revision for this tree object.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    int newRevision = 0;
+
+    if (TreeFileExists(treeRef->name, 1))
+    {
+        if (TreeFileExists(treeRef->name, 3))
+        {
+            newRevision = 3;
+        }
+        else
+        {
+            newRevision = 1;
+        }
+    }
+    else if (TreeFileExists(treeRef->name, 3))
+    {
+        if (TreeFileExists(treeRef->name, 2))
+        {
+            newRevision = 2;
+        }
+        else
+        {
+            newRevision = 3;
+        }
+    }
+    else if (TreeFileExists(treeRef->name, 2))
+    {
+        newRevision = 2;
+    }
+
+    treeRef->revisionId = newRevision;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Peek into the input stream one character ahead.
+ */
+// -------------------------------------------------------------------------------------------------
+static signed char PeekChar
+(
+    FILE* filePtr  ///< [IN] The file stream to peek into.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char next = fgetc(filePtr);
+    ungetc(next, filePtr);
+
+    return next;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Skip any whitespace encountered in the input stream.  Stop skipping once we hit a valid token.
+ *
+ *  @return LE_OK if the whitespace is skiped and there is still more file to read.
+ *          LE_OUT_OF_RANGE if the end of the file is hit.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t SkipWhiteSpace
+(
+    FILE* filePtr  ///< [IN] The file stream to seek through.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    bool done = false;
+    bool isEof = false;
+
+    while (done == false)
+    {
+        switch (PeekChar(filePtr))
+        {
+            case '\n':
+            case '\r':
+            case '\t':
+            case ' ':
+                // Eat the character.
+                fgetc(filePtr);
+                break;
+
+            case EOF:
+                done = true;
+                isEof = true;
+                break;
+
+            default:
+                done = true;
+                break;
+        }
+    }
+
+    return isEof == true ? LE_OUT_OF_RANGE : LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a boolean literal from the input file.
+ *
+ *  @return LE_OK if the literal could be read.
+ *          LE_FORMAT_ERROR if the literal could not be read.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool ReadBoolToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    signed char next = fgetc(filePtr);
+
+    if (   (next == 't')
+        || (next == 'f'))
+    {
+        stringPtr[0] = next;
+        stringPtr[1] = 0;
+
+        return LE_OK;
+    }
+
+    return LE_FORMAT_ERROR;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a textual literal from the input file, the read is terminated successfuly if the terminal
+ *  character is found.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadTextLiteral
+(
+    FILE* filePtr,        ///< [IN]  The file we're reading from.
+    char* stringPtr,      ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize,    ///< [IN]  How big is the supplied string buffer?
+    signed char terminal  ///< [IN]  The terminal character we're searching for.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    signed char next;
+    size_t count = 0;
+
+    char* oldPtr = stringPtr;
+
+    while ((next = fgetc(filePtr)) != terminal)
+    {
+        if (next == EOF)
+        {
+            LE_ERROR("Missing end specifier, ']' in int value.");
+            return LE_FORMAT_ERROR;
+        }
+
+        if (next == '\\')
+        {
+            next = fgetc(filePtr);
+
+            if (next == EOF)
+            {
+                LE_ERROR("Unexpected EOF after finding \\ character.");
+                return LE_FORMAT_ERROR;
+            }
+        }
+
+        *stringPtr = next;
+
+        ++stringPtr;
+        ++count;
+
+        if (count >= (stringSize - 1))
+        {
+            *stringPtr = 0;
+
+            LE_ERROR("String literal, '%s', too large.  (%zd/%zd)",
+                     oldPtr,
+                     strlen(oldPtr),
+                     stringSize);
+
+            return LE_FORMAT_ERROR;
+        }
+    }
+
+    *stringPtr = 0;
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read an integer token string from the file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadIntToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ']');
+
+    // TODO: Validate the int string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a floating point token string from the file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadFloatToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ')');
+
+    // TODO: Validate the float string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a string from the config tree file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadStringToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, '"');
+
+    // TODO: Validate the literal string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a token from the input stream.
+ *
+ *  @return LE_OK if a token could be read.  LE_OUT_OF_RANGE if the end of the stream is reached
+ *          before a token could be finished.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadToken
+(
+    FILE* filePtr,         ///< [IN]  The file we're reading from.
+    char* stringPtr,       ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize,     ///< [IN]  How big is the supplied string buffer?
+    TokenType_t* typePtr   ///< [OUT] The type of token read from the file.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    *stringPtr = 0;
+
+    if (SkipWhiteSpace(filePtr) != LE_OK)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    signed char next;
+
+    while ((next = fgetc(filePtr)) != EOF)
+    {
+        switch (next)
+        {
+            case '~':
+                *typePtr = TT_EMPTY_VALUE;
+                return LE_OK;
+
+            case '!':
+                *typePtr = TT_BOOL_VALUE;
+                return ReadBoolToken(filePtr, stringPtr, stringSize);
+
+            case '[':
+                *typePtr = TT_INT_VALUE;
+                return ReadIntToken(filePtr, stringPtr, stringSize);
+
+            case '(':
+                *typePtr = TT_FLOAT_VALUE;
+                return ReadFloatToken(filePtr, stringPtr, stringSize);
+
+            case '\"':
+                *typePtr = TT_STRING_VALUE;
+                return ReadStringToken(filePtr, stringPtr, stringSize);
+
+            case '{':
+                *typePtr = TT_OPEN_GROUP;
+                return LE_OK;
+
+            case '}':
+                *typePtr = TT_CLOSE_GROUP;
+                return LE_OK;
+
+            default:
+                LE_ERROR("Unexpected character in input stream.");
+                return LE_FORMAT_ERROR;
+        }
+    }
+
+    return LE_OUT_OF_RANGE;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write data to the output stream.  This function will record any faults to the system log.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t WriteFile
+(
+    FILE* filePtr,        ///< [IN] The file being written to.
+    const void* dataPtr,  ///< [IN] The data being written to the file.
+    size_t dataSize       ///< [IN] The amount of data being written.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    ssize_t written = fwrite(dataPtr, 1, dataSize, filePtr);
+
+    if (ferror(filePtr) != 0)
+    {
+        LE_EMERG("Failed to write to config tree file.");
+        return LE_IO_ERROR;
+    }
+
+    if (written < dataSize)
+    {
+        LE_EMERG("Data truncated while writing to configuration file.");
+        return LE_IO_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a string token to the output stream.  This function will write the string and escape all
+ *  control characters as it does so.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t WriteStringValue
+(
+    FILE* filePtr,         ///< [IN] The file to write to.
+    char startChar,        ///< [IN] The delimiter to use.
+    char endChar,          ///< [IN] The closing delimiter to use.
+    const char* stringPtr  ///< [IN] The actual string to write.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+
+    result = WriteFile(filePtr, &startChar, 1);
+
+    while (   (*stringPtr != 0)
+           && (result == LE_OK))
+    {
+        if (   (*stringPtr == '\"')
+            || (*stringPtr == '\\'))
+        {
+            result = WriteFile(filePtr, "\\", 1);
+        }
+
+        if (result == LE_OK)
+        {
+            result = WriteFile(filePtr, stringPtr, 1);
+        }
+
+        stringPtr++;
+    }
+
+    if (result == LE_OK)
+    {
+        char strBuffer[2] = { endChar, ' ' };
+        result = WriteFile(filePtr, strBuffer, sizeof(strBuffer));
+    }
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a node value from the given file.  If the value is a collection, then read in those nodes
+ *  too.
+ *
+ *  @return LE_OK if the read is successful.
+ *          LE_FORMAT_ERROR if parse errors are encountered.
+ *          LE_NOT_FOUND if the end of file is reached.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t InternalReadNode
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node we're reading a value for.
+    FILE* filePtr,          ///< [IN] The file we're reading the value from.
+    size_t pathLen          ///< [IN] The length of the path including nodeRef.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+
+    TokenType_t tokenType;
+
+    // Try to read this node's value.
+    if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
+    {
+        LE_ERROR("Unexpected EOF or bad token in file.");
+        return LE_FORMAT_ERROR;
+    }
+
+    tdb_SetEmpty(nodeRef);
+
+    switch (tokenType)
+    {
+        case TT_BOOL_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            nodeRef->type = LE_CFG_TYPE_BOOL;
+            break;
+
+        case TT_INT_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            nodeRef->type = LE_CFG_TYPE_INT;
+            break;
+
+        case TT_FLOAT_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            nodeRef->type = LE_CFG_TYPE_FLOAT;
+            break;
+
+        case TT_STRING_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            break;
 
         case TT_EMPTY_VALUE:
             // The node has already been cleared, so there's nothing left to do but make sure that
@@ -2229,83 +2904,1057 @@ static le_result_t InternalReadNode
             ClearDeletedFlag(nodeRef);
             break;
 
-        case TT_OPEN_GROUP:
-            while (tokenType != TT_CLOSE_GROUP)
-            {
-                if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
-                {
-                    LE_ERROR("Unexpected EOF or bad token in file while looking for '}'.");
-                    return LE_FORMAT_ERROR;
-                }
+        case TT_OPEN_GROUP:
+            while (tokenType != TT_CLOSE_GROUP)
+            {
+                if (ReadToken(filePtr, stringBuffer, sizeof(stringBuffer), &tokenType) != LE_OK)
+                {
+                    LE_ERROR("Unexpected EOF or bad token in file while looking for '}'.");
+                    return LE_FORMAT_ERROR;
+                }
+
+                if (tokenType == TT_STRING_VALUE)
+                {
+                    size_t strLen = le_utf8_NumBytes(stringBuffer);
+                    size_t newPathLen = pathLen + 1 + strLen;
+
+                    if (newPathLen > LE_CFG_STR_LEN)
+                    {
+                        LE_ERROR("New path length for node '%s' is too long.  %zu of %zu bytes.",
+                                 stringBuffer,
+                                 strLen,
+                                 (size_t)LE_CFG_STR_LEN);
+
+                        return LE_FORMAT_ERROR;
+                    }
+
+                    tdb_NodeRef_t childRef = GetNamedChild(nodeRef, stringBuffer);
+
+                    if (childRef == NULL)
+                    {
+                        childRef = NewChildNode(nodeRef);
+                        if (tdb_SetNodeName(childRef, stringBuffer) != LE_OK)
+                        {
+                            LE_ERROR("Bad node name, '%s'.", stringBuffer);
+                            return LE_FORMAT_ERROR;
+                        }
+
+                        LE_DEBUG("New node, %s", stringBuffer);
+                    }
+
+                    tdb_EnsureExists(childRef);
+
+                    le_result_t result = InternalReadNode(childRef, filePtr, newPathLen);
+
+                    if (result != LE_OK)
+                    {
+                        return result;
+                    }
+                }
+                else if (tokenType == TT_CLOSE_GROUP)
+                {
+                    break;
+                }
+                else
+                {
+                    LE_ERROR("Unexpected token in found while looking for '}'.");
+                    return LE_FORMAT_ERROR;
+                }
+            }
+            break;
+
+        case TT_CLOSE_GROUP:
+        default:
+            LE_ERROR("Unexpected token found.");
+            return LE_FORMAT_ERROR;
+    }
+
+    if (IsShadow(nodeRef) == false)
+    {
+        ClearModifiedFlag(nodeRef);
+    }
+    else
+    {
+        SetModifiedFlag(nodeRef);
+    }
+
+    tdb_EnsureExists(nodeRef);
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Serialize a tree node and it's children to a file in the filesystem.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t InternalWriteNode
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node being written.
+    FILE* filePtr           ///< [IN] The file being written to.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If there is no node to write, or if the node is marked as having been deleted...  Then write
+    // a blank node.
+    if (   (nodeRef == NULL)
+        || (IsDeleted(nodeRef) == true))
+    {
+        return WriteFile(filePtr, "~ ", 2);
+    }
+
+    // Get the node's value as a string.
+    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    le_result_t result = LE_OK;
+
+    tdb_GetValueAsString(nodeRef, stringBuffer, sizeof(stringBuffer), "");
+
+    // Now, depending on the type of node, write out any required format information.
+    switch (nodeRef->type)
+    {
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            result = WriteFile(filePtr, "~ ", 2);
+            break;
+
+        case LE_CFG_TYPE_BOOL:
+            {
+                const char boolBuffer[3] = { '!', stringBuffer[0], ' ' };
+                result = WriteFile(filePtr, boolBuffer, sizeof(boolBuffer));
+            }
+            break;
+
+        case LE_CFG_TYPE_STRING:
+            result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
+            break;
+
+        case LE_CFG_TYPE_INT:
+            result = WriteStringValue(filePtr, '[', ']', stringBuffer);
+            break;
+
+        case LE_CFG_TYPE_FLOAT:
+            result = WriteStringValue(filePtr, '(', ')', stringBuffer);
+            break;
+
+        // Looks like this node is a collection, so write out it's child nodes now.
+        case LE_CFG_TYPE_STEM:
+            if ((result = WriteFile(filePtr, "{ ", 2)) == LE_OK)
+            {
+                tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+                while (   (childRef != NULL)
+                       && (result == LE_OK))
+                {
+                    tdb_GetNodeName(childRef, stringBuffer, sizeof(stringBuffer));
+                    result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
+
+                    if (result == LE_OK)
+                    {
+                        result = InternalWriteNode(childRef, filePtr);
+                    }
+
+                    childRef = tdb_GetNextActiveSiblingNode(childRef);
+                }
+
+                if (result == LE_OK)
+                {
+                    result = WriteFile(filePtr, "} ", 2);
+                }
+            }
+            break;
+    }
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Calculate the number of bytes required to store a node path, including seperators and a trailing
+ *  NULL.
+ *
+ *  @return The amount of bytes required to store the whole path string.
+ */
+// -------------------------------------------------------------------------------------------------
+static size_t ComputePathLength
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] Compute a path for this node.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    size_t pathLen = 0;
+    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+
+    while (nodeRef != NULL)
+    {
+        LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+
+        // Add this path segment's length to our running total, along with the required path
+        // seperator.
+        pathLen += 1 + le_utf8_NumBytes(nodeName);
+        nodeRef = tdb_GetNodeParent(nodeRef);
+    }
+
+    // Don't forget to include a spot for the trailing NULL.
+    return pathLen + 1;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Bump up the version id of this tree.
+ */
+// -------------------------------------------------------------------------------------------------
+static void IncrementRevision
+(
+    tdb_TreeRef_t treeRef  ///< [IN] Increment the revision of this tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    treeRef->revisionId++;
+
+    if (treeRef->revisionId > 3)
+    {
+        treeRef->revisionId = 1;
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Find the node at the given path in a tree that's having its journal replayed.
+ *
+ *  @return The node, or NULL if it doesn't exist and wasn't to be created.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t GetJournalNode
+(
+    tdb_NodeRef_t rootRef,  ///< [IN] Root node of the tree.
+    const char* pathPtr,    ///< [IN] Absolute path to the node.
+    bool create             ///< [IN] Create the node, and any missing parents, if it doesn't exist.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_pathIter_Ref_t pathRef = le_pathIter_CreateForUnix(pathPtr);
+    tdb_NodeRef_t currentRef = rootRef;
+    char name[LE_CFG_NAME_LEN_BYTES] = "";
+
+    le_result_t result = le_pathIter_GoToStart(pathRef);
+
+    while (   (result != LE_NOT_FOUND)
+           && (currentRef != NULL))
+    {
+        result = le_pathIter_GetCurrentNode(pathRef, name, sizeof(name));
+
+        if (result == LE_OVERFLOW)
+        {
+            LE_ERROR("Path segment overflow on path.");
+            currentRef = NULL;
+        }
+        else if (result == LE_OK)
+        {
+            tdb_NodeRef_t childRef = GetNamedChild(currentRef, name);
+
+            if (   (childRef == NULL)
+                && (create == true))
+            {
+                // Only stems and empty nodes can be given children.
+                if (currentRef->type != LE_CFG_TYPE_STEM)
+                {
+                    tdb_SetEmpty(currentRef);
+                    ClearModifiedFlag(currentRef);
+                }
+
+                childRef = NewChildNode(currentRef);
+
+                if (tdb_SetNodeName(childRef, name) != LE_OK)
+                {
+                    LE_ERROR("Bad node name, '%s'.", name);
+                    le_mem_Release(childRef);
+                    childRef = NULL;
+                }
+                else
+                {
+                    ClearModifiedFlag(childRef);
+                }
+            }
+
+            currentRef = childRef;
+            result = le_pathIter_GoToNext(pathRef);
+        }
+    }
+
+    le_pathIter_Delete(pathRef);
+
+    return currentRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Apply the changes held in a journal record to a tree.
+ *
+ *  A record is a list of operations, each one being a node path preceded by one of:
+ *
+ *    - '-' Remove the node.
+ *    - '=' Replace the node with the value, (or collection of nodes,) that follows the path.
+ *
+ *  @return LE_OK if the record was applied, LE_FORMAT_ERROR if it could not be parsed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ApplyJournalRecord
+(
+    tdb_NodeRef_t rootRef,  ///< [IN] Root node of the tree to update.
+    FILE* filePtr           ///< [IN] The record to read.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    static char pathBuffer[CFG_MAX_PATH_SIZE] = "";
+
+    TokenType_t tokenType;
+
+    while (SkipWhiteSpace(filePtr) == LE_OK)
+    {
+        int operation = fgetc(filePtr);
+
+        if (   (ReadToken(filePtr, pathBuffer, sizeof(pathBuffer), &tokenType) != LE_OK)
+            || (tokenType != TT_STRING_VALUE))
+        {
+            LE_ERROR("Bad node path in journal record.");
+            return LE_FORMAT_ERROR;
+        }
+
+        if (operation == '-')
+        {
+            tdb_NodeRef_t nodeRef = GetJournalNode(rootRef, pathBuffer, false);
+
+            if (nodeRef == rootRef)
+            {
+                // The root node is never removed, only cleared.
+                tdb_SetEmpty(rootRef);
+                ClearModifiedFlag(rootRef);
+            }
+            else if (nodeRef != NULL)
+            {
+                le_mem_Release(nodeRef);
+            }
+        }
+        else if (operation == '=')
+        {
+            tdb_NodeRef_t nodeRef = GetJournalNode(rootRef, pathBuffer, true);
+
+            if (nodeRef == NULL)
+            {
+                return LE_FORMAT_ERROR;
+            }
+
+            le_result_t result = InternalReadNode(nodeRef, filePtr, ComputePathLength(nodeRef));
+
+            if (result != LE_OK)
+            {
+                return result;
+            }
+        }
+        else
+        {
+            LE_ERROR("Unexpected operation, '%c', in journal record.", operation);
+            return LE_FORMAT_ERROR;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Replay the journal of a tree's current revision over the tree, which must already have been
+ *  loaded from the tree file.  Any incomplete or corrupt records found at the end of the journal
+ *  are dropped from it.
+ */
+// -------------------------------------------------------------------------------------------------
+static void ReplayJournal
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to update.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char pathPtr[LE_CFG_STR_LEN_BYTES] = "";
+    GetJournalPath(treeRef->name, treeRef->revisionId, pathPtr, sizeof(pathPtr));
+
+    treeRef->journalBytes = 0;
+
+    int fileRef = -1;
+
+    do
+    {
+        fileRef = open(pathPtr, O_RDONLY);
+    }
+    while ((fileRef == -1) && (errno == EINTR));
+
+    if (fileRef == -1)
+    {
+        LE_ERROR_IF(errno != ENOENT,
+                    "Could not open configuration tree journal: %s, reason: %s",
+                    pathPtr,
+                    strerror(errno));
+        return;
+    }
+
+    // Read the whole journal in one go.  It's kept short by folding it into the tree file.
+    struct stat fileStat;
+    char* journalPtr = NULL;
+    ssize_t readSize = -1;
+
+    if (fstat(fileRef, &fileStat) == 0)
+    {
+        journalPtr = malloc(fileStat.st_size + 1);
+        LE_ASSERT(journalPtr != NULL);
+
+        readSize = fd_ReadSize(fileRef, journalPtr, fileStat.st_size);
+    }
+
+    int retVal = -1;
+
+    do
+    {
+        retVal = close(fileRef);
+    }
+    while ((retVal == -1) && (errno == EINTR));
+
+    if (readSize < 0)
+    {
+        LE_ERROR("Could not read configuration tree journal: %s.", pathPtr);
+        free(journalPtr);
+
+        // Don't append to a journal that couldn't be read, replace it with a new tree file instead.
+        treeRef->journalBytes = JOURNAL_MAX_BYTES;
+        return;
+    }
+
+    // Apply each record in turn, stopping at the first one that is incomplete or corrupt.
+    size_t journalSize = readSize;
+    size_t offset = 0;
+
+    while (offset + sizeof(JournalHeader_t) <= journalSize)
+    {
+        JournalHeader_t header;
+        memcpy(&header, journalPtr + offset, sizeof(header));
+
+        uint8_t* recordPtr = (uint8_t*)journalPtr + offset + sizeof(header);
+
+        if (   (header.magic != JOURNAL_RECORD_MAGIC)
+            || (header.size == 0)
+            || (header.size > journalSize - offset - sizeof(header))
+            || (le_crc_Crc32(recordPtr, header.size, LE_CRC_START_CRC32) != header.crc))
+        {
+            break;
+        }
+
+        FILE* recordFilePtr = fmemopen(recordPtr, header.size, "r");
+        LE_ASSERT(recordFilePtr != NULL);
+
+        le_result_t result = ApplyJournalRecord(treeRef->rootNodeRef, recordFilePtr);
+        fclose(recordFilePtr);
+
+        if (result != LE_OK)
+        {
+            LE_ERROR("Could not apply the record at offset %zu of configuration tree journal: %s.",
+                     offset,
+                     pathPtr);
+            break;
+        }
+
+        offset += sizeof(header) + header.size;
+    }
+
+    free(journalPtr);
+
+    treeRef->journalBytes = offset;
+
+    // Cut off whatever couldn't be replayed, so that new records aren't appended after it.
+    if (offset < journalSize)
+    {
+        LE_WARN("Dropping %zu bytes of incomplete records from configuration tree journal: %s.",
+                journalSize - offset,
+                pathPtr);
+
+        if (truncate(pathPtr, offset) == -1)
+        {
+            LE_ERROR("Could not truncate configuration tree journal: %s, reason: %s",
+                     pathPtr,
+                     strerror(errno));
+
+            treeRef->journalBytes = JOURNAL_MAX_BYTES;
+        }
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check that a string referred to by a snapshot record lies within the snapshot's string table,
+ *  and isn't too long to be loaded.
+ *
+ *  @return True if the string is in the string table and fits, false if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool IsSnapshotString
+(
+    const uint8_t* snapshotPtr,  ///< [IN] The mapped snapshot.
+    size_t recordOffset,         ///< [IN] Offset of the record from the start of the snapshot.
+    uint32_t offset,             ///< [IN] Offset of the string from the start of the record.
+    size_t stringsOffset,        ///< [IN] Offset of the string table from the start of the
+                                 ///<      snapshot.
+    size_t size,                 ///< [IN] Size of the snapshot.
+    size_t maxBytes              ///< [IN] Maximum size of the string, including its terminator.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    size_t stringOffset = recordOffset + offset;
+
+    if (   (stringOffset < stringsOffset)
+        || (stringOffset >= size))
+    {
+        return false;
+    }
+
+    size_t numBytes = size - stringOffset;
+
+    if (numBytes > maxBytes)
+    {
+        numBytes = maxBytes;
+    }
+
+    return memchr(snapshotPtr + stringOffset, '\0', numBytes) != NULL;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check a mapped snapshot's CRC, and make sure that its records form a proper tree and only refer
+ *  to strings within the snapshot.  This way, nodes can be loaded from the snapshot later on
+ *  without any further checks.
+ *
+ *  @return True if the snapshot can be used, false if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool IsSnapshotValid
+(
+    const uint8_t* snapshotPtr,         ///< [IN] The mapped snapshot.
+    const SnapshotHeader_t* headerPtr   ///< [IN] The snapshot's header.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    size_t size = headerPtr->size;
+    size_t stringsOffset = sizeof(SnapshotHeader_t) + headerPtr->nodeCount * sizeof(SnapshotNode_t);
+
+    if (le_crc_Crc32((uint8_t*)snapshotPtr + sizeof(SnapshotHeader_t),
+                     size - sizeof(SnapshotHeader_t),
+                     LE_CRC_START_CRC32) != headerPtr->crc)
+    {
+        LE_ERROR("Snapshot CRC mismatch.");
+        return false;
+    }
+
+    // As long as the string table ends with a terminator, so does every string within it.
+    if (   (stringsOffset < size)
+        && (snapshotPtr[size - 1] != '\0'))
+    {
+        LE_ERROR("Snapshot string table is not terminated.");
+        return false;
+    }
+
+    // Every record but the root's must be the child of a stem that came before it, and the
+    // children of each stem must come right after those of the stem before it.
+    const SnapshotNode_t* recordPtr = (const SnapshotNode_t*)(snapshotPtr + sizeof(SnapshotHeader_t));
+    size_t nextChild = 1;
+
+    for (size_t i = 0; i < headerPtr->nodeCount; i++, recordPtr++)
+    {
+        size_t recordOffset = sizeof(SnapshotHeader_t) + i * sizeof(SnapshotNode_t);
+
+        if (   (i > 0)
+            && (   (i >= nextChild)
+                || (IsSnapshotString(snapshotPtr,
+                                     recordOffset,
+                                     recordPtr->nameOffset,
+                                     stringsOffset,
+                                     size,
+                                     LE_CFG_NAME_LEN_BYTES) == false)))
+        {
+            LE_ERROR("Bad name or parent for snapshot record %zu.", i);
+            return false;
+        }
+
+        switch (recordPtr->type)
+        {
+            case LE_CFG_TYPE_EMPTY:
+                break;
+
+            case LE_CFG_TYPE_STRING:
+            case LE_CFG_TYPE_BOOL:
+            case LE_CFG_TYPE_INT:
+            case LE_CFG_TYPE_FLOAT:
+                if (IsSnapshotString(snapshotPtr,
+                                     recordOffset,
+                                     recordPtr->valueOffset,
+                                     stringsOffset,
+                                     size,
+                                     LE_CFG_STR_LEN_BYTES) == false)
+                {
+                    LE_ERROR("Bad value for snapshot record %zu.", i);
+                    return false;
+                }
+                break;
+
+            case LE_CFG_TYPE_STEM:
+                if (   (recordPtr->childCount == 0)
+                    || (recordOffset + recordPtr->valueOffset
+                        != sizeof(SnapshotHeader_t) + nextChild * sizeof(SnapshotNode_t))
+                    || (recordPtr->childCount > headerPtr->nodeCount - nextChild))
+                {
+                    LE_ERROR("Bad children for snapshot record %zu.", i);
+                    return false;
+                }
+
+                nextChild += recordPtr->childCount;
+                break;
+
+            default:
+                LE_ERROR("Bad type, %u, for snapshot record %zu.", recordPtr->type, i);
+                return false;
+        }
+    }
+
+    if (nextChild != headerPtr->nodeCount)
+    {
+        LE_ERROR("Snapshot has %zu records with no parent.", headerPtr->nodeCount - nextChild);
+        return false;
+    }
+
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Load a tree from a tree file, if the file holds a snapshot.  The snapshot is mapped into memory,
+ *  but only the tree's root node is loaded from it now.
+ *
+ *  @return LE_OK if the tree was loaded.
+ *          LE_FORMAT_ERROR if the file doesn't hold a snapshot.
+ *          LE_FAULT if the file holds a snapshot, but it's damaged or couldn't be mapped.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadSnapshot
+(
+    tdb_TreeRef_t treeRef,  ///< [IN] The tree to load, its root node must be empty.
+    int descriptor          ///< [IN] The tree file.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    SnapshotHeader_t header;
+    struct stat fileStat;
+
+    if (   (fstat(descriptor, &fileStat) == -1)
+        || (fileStat.st_size < (off_t)sizeof(header))
+        || (pread(descriptor, &header, sizeof(header), 0) != sizeof(header))
+        || (header.magic != SNAPSHOT_MAGIC))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    if (   (header.version != SNAPSHOT_VERSION)
+        || (header.size != fileStat.st_size)
+        || (header.nodeCount == 0)
+        || (header.nodeCount > (header.size - sizeof(header)) / sizeof(SnapshotNode_t)))
+    {
+        LE_ERROR("Bad snapshot header, version %u, %u bytes, %u nodes.",
+                 header.version,
+                 header.size,
+                 header.nodeCount);
+        return LE_FAULT;
+    }
+
+    void* snapshotPtr = mmap(NULL, header.size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+    if (snapshotPtr == MAP_FAILED)
+    {
+        LE_ERROR("Failed to map the snapshot (%m).");
+        return LE_FAULT;
+    }
+
+    if (IsSnapshotValid(snapshotPtr, &header) == false)
+    {
+        munmap(snapshotPtr, header.size);
+        return LE_FAULT;
+    }
+
+    treeRef->snapshotPtr = snapshotPtr;
+    treeRef->snapshotSize = header.size;
+
+    InitFromSnapshot(treeRef->rootNodeRef,
+                     (const SnapshotNode_t*)((uint8_t*)snapshotPtr + sizeof(header)));
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Attempt to load a configuration tree from a config file.  This function will look for the latest
+ *  valid version of the config file and load that one.
+ *
+ *  @return True if the tree was read from a tree file in the text format, which should be replaced
+ *          with a snapshot.  False otherwise.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool LoadTree
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree object to load from the filesystem.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    bool isTextFile = false;
+
+    // If we don't know the revision then hunt it out from the filesystem.
+    if (treeRef->revisionId == 0)
+    {
+        UpdateRevision(treeRef);
+    }
+
+    // If this tree has no root, create it now.
+    if (treeRef->rootNodeRef == NULL)
+    {
+        treeRef->rootNodeRef = NewNode();
+    }
+
+    // Ok, if we found a valid revision of the tree in the fs, try to load it now.
+    if (treeRef->revisionId != 0)
+    {
+        char pathPtr[LE_CFG_STR_LEN_BYTES] = "";
+        GetTreePath(treeRef->name, treeRef->revisionId, pathPtr, sizeof(pathPtr));
+
+        LE_DEBUG("** Loading configuration tree from '%s'.", pathPtr);
+
+        int fileRef = -1;
+
+        do
+        {
+            fileRef = open(pathPtr, O_RDONLY);
+        }
+        while ((fileRef == -1) && (errno == EINTR));
+
+        tdb_EnsureExists(treeRef->rootNodeRef);
+
+        if (fileRef == -1)
+        {
+            LE_ERROR("Could not open configuration tree file: %s, reason: %s",
+                     pathPtr,
+                     strerror(errno));
+        }
+        else
+        {
+            le_result_t result = ReadSnapshot(treeRef, fileRef);
+
+            if (result == LE_FORMAT_ERROR)
+            {
+                isTextFile = true;
+                result = tdb_ReadTreeNode(treeRef->rootNodeRef, fileRef) ? LE_OK : LE_FAULT;
+            }
+
+            if (result != LE_OK)
+            {
+                LE_ERROR("Could not parse configuration tree file: %s.", pathPtr);
+                le_mem_Release(treeRef->rootNodeRef);
+                treeRef->rootNodeRef = NewNode();
+                isTextFile = false;
+            }
+            else
+            {
+                ReplayJournal(treeRef);
+            }
+
+            int retVal = -1;
+
+            do
+            {
+                retVal = close(fileRef);
+            }
+            while ((retVal == -1) && (errno == EINTR));
+        }
+    }
+
+    return isTextFile;
+}
 
-                if (tokenType == TT_STRING_VALUE)
-                {
-                    size_t strLen = le_utf8_NumBytes(stringBuffer);
-                    size_t newPathLen = pathLen + 1 + strLen;
 
-                    if (newPathLen > LE_CFG_STR_LEN)
-                    {
-                        LE_ERROR("New path length for node '%s' is too long.  %zu of %zu bytes.",
-                                 stringBuffer,
-                                 strLen,
-                                 (size_t)LE_CFG_STR_LEN);
 
-                        return LE_FORMAT_ERROR;
-                    }
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Removes the handler object from the given registration object.  This function will also free the
+ *  memory that the handler object had used.
+ */
+// -------------------------------------------------------------------------------------------------
+static void RemoveHandler
+(
+    Registration_t* registrationPtr,  ///< [IN] The registration object to remove the link from.
+    Handler_t* handlerPtr             ///< [IN] The handler object we're removing.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Kill the ref, and remove the object from the registration list.
+    le_ref_DeleteRef(HandlerSafeRefMap, handlerPtr->safeRef);
+    le_dls_Remove(&registrationPtr->handlerList, &handlerPtr->link);
 
-                    tdb_NodeRef_t childRef = GetNamedChild(nodeRef, stringBuffer);
+    // Clear out the link data, just to be safe.
+    handlerPtr->link = LE_DLS_LINK_INIT;
+    handlerPtr->sessionRef = NULL;
+    handlerPtr->registrationPtr = NULL;
+    handlerPtr->safeRef = NULL;
 
-                    if (childRef == NULL)
-                    {
-                        childRef = NewChildNode(nodeRef);
-                        if (tdb_SetNodeName(childRef, stringBuffer) != LE_OK)
-                        {
-                            LE_ERROR("Bad node name, '%s'.", stringBuffer);
-                            return LE_FORMAT_ERROR;
-                        }
+    // Finally kill the object.
+    le_mem_Release(handlerPtr);
+}
 
-                        LE_DEBUG("New node, %s", stringBuffer);
-                    }
 
-                    tdb_EnsureExists(childRef);
 
-                    le_result_t result = InternalReadNode(childRef, filePtr, newPathLen);
 
-                    if (result != LE_OK)
-                    {
-                        return result;
-                    }
-                }
-                else if (tokenType == TT_CLOSE_GROUP)
-                {
-                    break;
-                }
-                else
-                {
-                    LE_ERROR("Unexpected token in found while looking for '}'.");
-                    return LE_FORMAT_ERROR;
-                }
-            }
-            break;
+// -------------------------------------------------------------------------------------------------
+/**
+ *  This function is called by the hash map ForEach function, which is invoked when a session closed
+ *  event occurs.
+ *
+ *  This function takes care of cleaning out orphaned event handlers from the registration objects
+ *  currently stored in the registration hash map.  If a given registration handler is no longer
+ *  required then the object itself is queued for deletion.  It is queued and not deleted in place
+ *  because the hash map does not support deleting objects in the middle of an iteration.
+ *
+ *  @return True.  This function always returns true to indicate that iteration should continue
+ *          until the end of the hash map.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool OnHandlerRegistrationCleanup
+(
+    const void* keyPtr,    ///< [IN] The key used by this hash entry.
+    const void* valuePtr,  ///< [IN] The registration object.
+    void* contextPtr       ///< [IN] Context info including the ref for the session that closed.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Convert our pointers into something useable.
+    Registration_t* registrationPtr = (Registration_t*)valuePtr;
+    CleanUpContext_t* cleanUpContextPtr = (CleanUpContext_t*)contextPtr;
 
-        case TT_CLOSE_GROUP:
-        default:
-            LE_ERROR("Unexpected token found.");
-            return LE_FORMAT_ERROR;
+    // Go through this registration object's list of update handlers and check to see if they were
+    // registered on the target session.  If so, free them from the list.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
+
+    while (linkPtr != NULL)
+    {
+        Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
+        linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
+
+        if (handlerObjectPtr->sessionRef == cleanUpContextPtr->sessionRef)
+        {
+            RemoveHandler(registrationPtr, handlerObjectPtr);
+        }
     }
 
-    if (IsShadow(nodeRef) == false)
+    // Now, check to see if there are any handlers left in this object.  If the registration object
+    // is empty, then queue it for deletion.
+    if (le_dls_IsEmpty(&registrationPtr->handlerList))
     {
-        ClearModifiedFlag(nodeRef);
+        registrationPtr->link = LE_SLS_LINK_INIT;
+        le_sls_Queue(&cleanUpContextPtr->deleteQueue, &registrationPtr->link);
     }
-    else
+
+    // We want to continue iterating through the collection.
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Call this function to delete a tree file from the filesystem.
+ */
+// -------------------------------------------------------------------------------------------------
+static void DeleteTreeFile
+(
+    const char* filePathPtr  ///< Path to the tree file in question.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Deleting tree file, '%s'.", filePathPtr);
+
+    if (unlink(filePathPtr) != 0)
     {
-        SetModifiedFlag(nodeRef);
+        LE_ERROR("File delete failure, '%s', reason '%m'.", filePathPtr);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Call this function to delete the journal of a given tree revision, if there is one.
+ */
+// -------------------------------------------------------------------------------------------------
+static void DeleteJournalFile
+(
+    const char* treeNamePtr,  ///< [IN] Name of the tree.
+    int revisionId            ///< [IN] The revision the journal goes with.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char filePath[LE_CFG_STR_LEN_BYTES] = "";
+    GetJournalPath(treeNamePtr, revisionId, filePath, sizeof(filePath));
+
+    if (   (filePath[0] != '\0')
+        && (unlink(filePath) != 0)
+        && (errno != ENOENT))
+    {
+        LE_ERROR("File delete failure, '%s', reason '%m'.", filePath);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Find the root node represented by the path ref.
+ *
+ *  If the path is an absolute path, then the base node for the reference is the root node of the
+ *  tree in question.
+ *
+ *  If the path is a relative path, then the base node of the request is the node given.
+ *
+ *  @return A reference to the base node of the operation.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t GetPathBaseNodeRef
+(
+    tdb_NodeRef_t nodeRef,         ///< [IN] The base node to start from.
+    le_pathIter_Ref_t nodePathRef  ///< [IN] The path we're searching for in the tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If the path is absolute and the node we were given is NOT the root node of it's tree, find
+    // the root node of the tree.  Otherwise just return the node reference we were given.
+    if (   (le_pathIter_IsAbsolute(nodePathRef))
+        && (nodeRef->parentRef != NULL))
+    {
+        nodeRef = GetRootParentNode(nodeRef);
+    }
+
+    return nodeRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a new C style file pointer from the POSIX file descriptor.
+ *
+ *  @return A file pointer that may be read or written if successful.  A null pointer otherwise.
+ */
+// -------------------------------------------------------------------------------------------------
+static FILE* OpenFilePtr
+(
+    int descriptor,   ///< [IN] The POSIX file descriptor to create a file pointer from.
+    const char* mode  ///< [IN] The mode to open the file pointer in.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Duplicate the file descriptor, this is because we later use a C library file pointer for the
+    // parsing routines.  When the file pointer is closed it also closes the underlying descriptor,
+    // which may not be what the caller wants or expects.
+    int newDescriptor = -1;
+
+    do
+    {
+        newDescriptor = dup(descriptor);
+    }
+    while (   (newDescriptor == -1)
+           && (errno == EINTR));
+
+    if (newDescriptor == -1)
+    {
+        LE_ERROR("Could not duplicate file descriptor, reason: %s", strerror(errno));
+        return NULL;
+    }
+
+    // Attempt to open the file pointer from the descriptor.
+    FILE* filePtr = fdopen(newDescriptor, mode);
+
+    if (filePtr == NULL)
+    {
+        // The open failed, so clean up the dangling descriptor.
+        int oldErrno = errno;
+        int closeResult;
+
+        do
+        {
+            closeResult = close(newDescriptor);
+        }
+        while (   (closeResult == -1)
+               && (errno == EINTR));
+
+        LE_ERROR("Could not access the input stream for tree import, reason: %s",
+                 strerror(oldErrno));
     }
 
-    tdb_EnsureExists(nodeRef);
+    // Return the file pointer we have now.  Note, it may be NULL at this point.
+    return filePtr;
+}
+
 
-    return LE_OK;
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Close the file pointer and flush any data left unwritten.
+ */
+// -------------------------------------------------------------------------------------------------
+static void CloseFilePtr
+(
+    FILE* filePtr  ///< The file pointer to close.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (fclose(filePtr) == EOF)
+    {
+        LE_ERROR("Could not properly close file, reason: %s", strerror(errno));
+    }
 }
 
 
@@ -2313,88 +3962,123 @@ static le_result_t InternalReadNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Serialize a tree node and it's children to a file in the filesystem.
+ *  Write the absolute path of a node to a journal record.
  *
  *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t InternalWriteNode
+static le_result_t WriteNodePath
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node being written.
-    FILE* filePtr           ///< [IN] The file being written to.
+    FILE* filePtr,         ///< [IN] The record being written to.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to write the path of.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If there is no node to write, or if the node is marked as having been deleted...  Then write
-    // a blank node.
-    if (   (nodeRef == NULL)
-        || (IsDeleted(nodeRef) == true))
+    char path[CFG_MAX_PATH_SIZE] = "";
+    le_pathIter_Ref_t pathRef = le_pathIter_CreateForUnix("/");
+
+    GeneratePath(pathRef, nodeRef);
+    le_result_t result = le_pathIter_GetPath(pathRef, path, sizeof(path));
+    le_pathIter_Delete(pathRef);
+
+    if (result != LE_OK)
     {
-        return WriteFile(filePtr, "~ ", 2);
+        LE_ERROR("Path to node is too long for the journal.");
+        return LE_IO_ERROR;
     }
 
-    // Get the node's value as a string.
-    static char stringBuffer[LE_CFG_STR_LEN_BYTES] = "";
-    le_result_t result = LE_OK;
+    return WriteStringValue(filePtr, '\"', '\"', path);
+}
 
-    tdb_GetValueAsString(nodeRef, stringBuffer, sizeof(stringBuffer), "");
 
-    // Now, depending on the type of node, write out any required format information.
-    switch (nodeRef->type)
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Add the changes found in a shadow node, and its children, to a journal record.
+ *
+ *  This is called twice for each commit.  Before the shadow tree is merged, to record the original
+ *  nodes that are about to be removed or renamed.  Then after the merge, to record the new contents
+ *  of the changed nodes.  Once a modified node is found, it's written out as a whole, so its
+ *  children don't need to be looked at.
+ */
+// -------------------------------------------------------------------------------------------------
+static void RecordChanges
+(
+    JournalRecord_t* recordPtr,  ///< [IN] The record being put together.
+    tdb_NodeRef_t nodeRef,       ///< [IN] The shadow node to check.
+    bool isMerged                ///< [IN] Has the shadow tree been merged yet?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (recordPtr->result != LE_OK)
     {
-        case LE_CFG_TYPE_EMPTY:
-        case LE_CFG_TYPE_DOESNT_EXIST:
-            result = WriteFile(filePtr, "~ ", 2);
-            break;
+        return;
+    }
 
-        case LE_CFG_TYPE_BOOL:
+    if (IsModified(nodeRef))
+    {
+        if (isMerged == false)
+        {
+            if (   (IsDeleted(nodeRef) == false)
+                && (WasRenamed(nodeRef) == false))
             {
-                const char boolBuffer[3] = { '!', stringBuffer[0], ' ' };
-                result = WriteFile(filePtr, boolBuffer, sizeof(boolBuffer));
+                return;
             }
-            break;
 
-        case LE_CFG_TYPE_STRING:
-            result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
-            break;
+            // Find the original node the same way that MergeNode() will.
+            tdb_NodeRef_t originalRef = nodeRef->shadowRef;
 
-        case LE_CFG_TYPE_INT:
-            result = WriteStringValue(filePtr, '[', ']', stringBuffer);
-            break;
+            if (   (originalRef == NULL)
+                && (nodeRef->parentRef != NULL)
+                && (nodeRef->parentRef->shadowRef != NULL))
+            {
+                char name[LE_CFG_NAME_LEN_BYTES] = "";
 
-        case LE_CFG_TYPE_FLOAT:
-            result = WriteStringValue(filePtr, '(', ')', stringBuffer);
-            break;
+                tdb_GetNodeName(nodeRef, name, sizeof(name));
+                originalRef = GetNamedChild(nodeRef->parentRef->shadowRef, name);
+            }
 
-        // Looks like this node is a collection, so write out it's child nodes now.
-        case LE_CFG_TYPE_STEM:
-            if ((result = WriteFile(filePtr, "{ ", 2)) == LE_OK)
+            if (originalRef != NULL)
             {
-                tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+                recordPtr->result = WriteFile(recordPtr->filePtr, "- ", 2);
 
-                while (   (childRef != NULL)
-                       && (result == LE_OK))
+                if (recordPtr->result == LE_OK)
                 {
-                    tdb_GetNodeName(childRef, stringBuffer, sizeof(stringBuffer));
-                    result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
-
-                    if (result == LE_OK)
-                    {
-                        result = InternalWriteNode(childRef, filePtr);
-                    }
-
-                    childRef = tdb_GetNextActiveSiblingNode(childRef);
+                    recordPtr->result = WriteNodePath(recordPtr->filePtr, originalRef);
                 }
+            }
+        }
+        else if (IsDeleted(nodeRef) == false)
+        {
+            recordPtr->result = WriteFile(recordPtr->filePtr, "= ", 2);
 
-                if (result == LE_OK)
-                {
-                    result = WriteFile(filePtr, "} ", 2);
-                }
+            if (recordPtr->result == LE_OK)
+            {
+                recordPtr->result = WriteNodePath(recordPtr->filePtr, nodeRef->shadowRef);
             }
-            break;
+
+            if (recordPtr->result == LE_OK)
+            {
+                recordPtr->result = InternalWriteNode(nodeRef->shadowRef, recordPtr->filePtr);
+            }
+        }
+
+        return;
     }
 
-    return result;
+    // Only the children that have been shadowed can have been changed, so don't go through
+    // tdb_GetFirstChildNode(), which would shadow the rest.
+    if (nodeRef->type == LE_CFG_TYPE_STEM)
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&nodeRef->info.children);
+
+        while (linkPtr != NULL)
+        {
+            RecordChanges(recordPtr, CONTAINER_OF(linkPtr, Node_t, siblingList), isMerged);
+            linkPtr = le_dls_PeekNext(&nodeRef->info.children, linkPtr);
+        }
+    }
 }
 
 
@@ -2402,33 +4086,30 @@ static le_result_t InternalWriteNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Calculate the number of bytes required to store a node path, including seperators and a trailing
- *  NULL.
- *
- *  @return The amount of bytes required to store the whole path string.
+ *  Add a node to the end of a snapshot being put together.  The node's record is filled in later.
  */
 // -------------------------------------------------------------------------------------------------
-static size_t ComputePathLength
+static void AddSnapshotNode
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Compute a path for this node.
+    SnapshotWriter_t* writerPtr,  ///< [IN] The snapshot being put together.
+    tdb_NodeRef_t nodeRef         ///< [IN] The node to add.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    size_t pathLen = 0;
-    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
-
-    while (nodeRef != NULL)
+    if (writerPtr->nodeCount == writerPtr->nodeMax)
     {
-        LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+        writerPtr->nodeMax = (writerPtr->nodeMax == 0) ? 256 : writerPtr->nodeMax * 2;
+        writerPtr->nodesPtr = realloc(writerPtr->nodesPtr,
+                                      writerPtr->nodeMax * sizeof(tdb_NodeRef_t));
+        writerPtr->recordsPtr = realloc(writerPtr->recordsPtr,
+                                        writerPtr->nodeMax * sizeof(SnapshotNode_t));
 
-        // Add this path segment's length to our running total, along with the required path
-        // seperator.
-        pathLen += 1 + le_utf8_NumBytes(nodeName);
-        nodeRef = tdb_GetNodeParent(nodeRef);
+        LE_ASSERT(   (writerPtr->nodesPtr != NULL)
+                  && (writerPtr->recordsPtr != NULL));
     }
 
-    // Don't forget to include a spot for the trailing NULL.
-    return pathLen + 1;
+    writerPtr->nodesPtr[writerPtr->nodeCount] = nodeRef;
+    writerPtr->nodeCount++;
 }
 
 
@@ -2436,21 +4117,46 @@ static size_t ComputePathLength
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Bump up the version id of this tree.
+ *  Add a string to the string table of a snapshot being put together, unless it's already there.
+ *
+ *  @return The offset of the string in the string table.
  */
 // -------------------------------------------------------------------------------------------------
-static void IncrementRevision
+static size_t AddSnapshotString
 (
-    tdb_TreeRef_t treeRef  ///< [IN] Increment the revision of this tree.
+    SnapshotWriter_t* writerPtr,  ///< [IN] The snapshot being put together.
+    dstr_Ref_t strRef             ///< [IN] The string to add.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    treeRef->revisionId++;
+    LE_ASSERT(strRef != NULL);
 
-    if (treeRef->revisionId > 3)
+    // Strings are interned, so the same text is always the same string.
+    uintptr_t entry = (uintptr_t)le_hashmap_Get(SnapshotStringMap, strRef);
+
+    if (entry != 0)
     {
-        treeRef->revisionId = 1;
+        return entry - 1;
+    }
+
+    size_t size = dstr_NumBytes(strRef) + 1;
+
+    while (writerPtr->stringsSize + size > writerPtr->stringsMax)
+    {
+        writerPtr->stringsMax = (writerPtr->stringsMax == 0) ? 4096 : writerPtr->stringsMax * 2;
+        writerPtr->stringsPtr = realloc(writerPtr->stringsPtr, writerPtr->stringsMax);
+
+        LE_ASSERT(writerPtr->stringsPtr != NULL);
     }
+
+    size_t offset = writerPtr->stringsSize;
+
+    LE_ASSERT(dstr_CopyToCstr(writerPtr->stringsPtr + offset, size, strRef, NULL) == LE_OK);
+    writerPtr->stringsSize += size;
+
+    le_hashmap_Put(SnapshotStringMap, strRef, (void*)(offset + 1));
+
+    return offset;
 }
 
 
@@ -2458,155 +4164,245 @@ static void IncrementRevision
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Attempt to load a configuration tree from a config file.  This function will look for the latest
- *  valid version of the config file and load that one.
+ *  Write a tree to a tree file, as a snapshot.  This loads any of the tree's nodes that are still
+ *  waiting in the tree's old snapshot.
+ *
+ *  @return LE_OK if the write succeeded, LE_OVERFLOW if the tree is too big for a snapshot, or
+ *          LE_IO_ERROR if the write failed.
  */
 // -------------------------------------------------------------------------------------------------
-static void LoadTree
+static le_result_t WriteSnapshot
 (
-    tdb_TreeRef_t treeRef  ///< [IN] The tree object to load from the filesystem.
+    tdb_NodeRef_t rootRef,  ///< [IN] The root of the tree to write.
+    int descriptor          ///< [IN] The file to write to.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If we don't know the revision then hunt it out from the filesystem.
-    if (treeRef->revisionId == 0)
-    {
-        UpdateRevision(treeRef);
-    }
+    SnapshotWriter_t writer = { 0 };
 
-    // If this tree has no root, create it now.
-    if (treeRef->rootNodeRef == NULL)
-    {
-        treeRef->rootNodeRef = NewNode();
-    }
+    // Lay the nodes out in breadth first order, so that the children of each stem end up one after
+    // another.  The list of nodes added so far doubles as the queue of nodes still to visit.
+    AddSnapshotNode(&writer, rootRef);
 
-    // Ok, if we found a valid revision of the tree in the fs, try to load it now.
-    if (treeRef->revisionId != 0)
+    for (size_t i = 0; i < writer.nodeCount; i++)
     {
-        char pathPtr[LE_CFG_STR_LEN_BYTES] = "";
-        GetTreePath(treeRef->name, treeRef->revisionId, pathPtr, sizeof(pathPtr));
-
-        LE_DEBUG("** Loading configuration tree from '%s'.", pathPtr);
+        tdb_NodeRef_t nodeRef = writer.nodesPtr[i];
+        SnapshotNode_t record = { 0, 0, 0, LE_CFG_TYPE_EMPTY };
 
-        int fileRef = -1;
-
-        do
+        if (i > 0)
         {
-            fileRef = open(pathPtr, O_RDONLY);
+            record.nameOffset = AddSnapshotString(&writer, GetNameRef(nodeRef));
         }
-        while ((fileRef == -1) && (errno == EINTR));
 
-        tdb_EnsureExists(treeRef->rootNodeRef);
+        le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
 
-        if (fileRef == -1)
+        switch (type)
         {
-            LE_ERROR("Could not open configuration tree file: %s, reason: %s",
-                     pathPtr,
-                     strerror(errno));
+            case LE_CFG_TYPE_STRING:
+            case LE_CFG_TYPE_BOOL:
+            case LE_CFG_TYPE_INT:
+            case LE_CFG_TYPE_FLOAT:
+                record.type = type;
+                record.valueOffset = AddSnapshotString(&writer, nodeRef->info.valueRef);
+                break;
+
+            case LE_CFG_TYPE_STEM:
+                {
+                    record.type = type;
+                    record.valueOffset = writer.nodeCount;
+
+                    tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+                    while (childRef != NULL)
+                    {
+                        AddSnapshotNode(&writer, childRef);
+                        record.childCount++;
+
+                        childRef = tdb_GetNextActiveSiblingNode(childRef);
+                    }
+                }
+                break;
+
+            default:
+                // Empty and deleted nodes are both written as empty.
+                break;
         }
-        else
+
+        writer.recordsPtr[i] = record;
+    }
+
+    le_hashmap_RemoveAll(SnapshotStringMap);
+
+    // Now that the size of the record table is known, turn the string offsets and child indices
+    // into offsets from the records themselves.
+    size_t stringsOffset = sizeof(SnapshotHeader_t) + writer.nodeCount * sizeof(SnapshotNode_t);
+    size_t size = stringsOffset + writer.stringsSize;
+    le_result_t result = LE_OK;
+
+    if (size > UINT32_MAX)
+    {
+        LE_ERROR("Tree is too big for a snapshot, %zu bytes.", size);
+        result = LE_OVERFLOW;
+    }
+    else
+    {
+        for (size_t i = 0; i < writer.nodeCount; i++)
         {
-            if (tdb_ReadTreeNode(treeRef->rootNodeRef, fileRef) == false)
+            SnapshotNode_t* recordPtr = &writer.recordsPtr[i];
+            size_t recordOffset = sizeof(SnapshotHeader_t) + i * sizeof(SnapshotNode_t);
+
+            if (i > 0)
             {
-                LE_ERROR("Could not parse configuration tree file: %s.", pathPtr);
-                le_mem_Release(treeRef->rootNodeRef);
-                treeRef->rootNodeRef = NewNode();
+                recordPtr->nameOffset = stringsOffset + recordPtr->nameOffset - recordOffset;
             }
 
-            int retVal = -1;
-
-            do
+            if (recordPtr->type == LE_CFG_TYPE_STEM)
             {
-                retVal = close(fileRef);
+                recordPtr->valueOffset = (recordPtr->valueOffset - i) * sizeof(SnapshotNode_t);
+            }
+            else if (recordPtr->type != LE_CFG_TYPE_EMPTY)
+            {
+                recordPtr->valueOffset = stringsOffset + recordPtr->valueOffset - recordOffset;
             }
-            while ((retVal == -1) && (errno == EINTR));
         }
-    }
-}
-
 
+        size_t recordsSize = writer.nodeCount * sizeof(SnapshotNode_t);
+        uint32_t crc = le_crc_Crc32((uint8_t*)writer.recordsPtr, recordsSize, LE_CRC_START_CRC32);
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Removes the handler object from the given registration object.  This function will also free the
- *  memory that the handler object had used.
- */
-// -------------------------------------------------------------------------------------------------
-static void RemoveHandler
-(
-    Registration_t* registrationPtr,  ///< [IN] The registration object to remove the link from.
-    Handler_t* handlerPtr             ///< [IN] The handler object we're removing.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    // Kill the ref, and remove the object from the registration list.
-    le_ref_DeleteRef(HandlerSafeRefMap, handlerPtr->safeRef);
-    le_dls_Remove(&registrationPtr->handlerList, &handlerPtr->link);
+        SnapshotHeader_t header =
+            {
+                .magic = SNAPSHOT_MAGIC,
+                .version = SNAPSHOT_VERSION,
+                .size = size,
+                .nodeCount = writer.nodeCount,
+                .crc = le_crc_Crc32((uint8_t*)writer.stringsPtr, writer.stringsSize, crc)
+            };
+
+        if (   (fd_WriteSize(descriptor, &header, sizeof(header)) != sizeof(header))
+            || (fd_WriteSize(descriptor, writer.recordsPtr, recordsSize) != recordsSize)
+            || (fd_WriteSize(descriptor, writer.stringsPtr, writer.stringsSize)
+                != writer.stringsSize))
+        {
+            LE_ERROR("Failed to write the tree snapshot (%m).");
+            result = LE_IO_ERROR;
+        }
+    }
 
-    // Clear out the link data, just to be safe.
-    handlerPtr->link = LE_DLS_LINK_INIT;
-    handlerPtr->sessionRef = NULL;
-    handlerPtr->registrationPtr = NULL;
-    handlerPtr->safeRef = NULL;
+    free(writer.nodesPtr);
+    free(writer.recordsPtr);
+    free(writer.stringsPtr);
 
-    // Finally kill the object.
-    le_mem_Release(handlerPtr);
+    return result;
 }
 
 
 
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  This function is called by the hash map ForEach function, which is invoked when a session closed
- *  event occurs.
- *
- *  This function takes care of cleaning out orphaned event handlers from the registration objects
- *  currently stored in the registration hash map.  If a given registration handler is no longer
- *  required then the object itself is queued for deletion.  It is queued and not deleted in place
- *  because the hash map does not support deleting objects in the middle of an iteration.
- *
- *  @return True.  This function always returns true to indicate that iteration should continue
- *          until the end of the hash map.
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write the whole tree to the tree file of the next revision, then delete the tree file and
+ *  journal of the current revision.
  */
 // -------------------------------------------------------------------------------------------------
-static bool OnHandlerRegistrationCleanup
+static void CompactTree
 (
-    const void* keyPtr,    ///< [IN] The key used by this hash entry.
-    const void* valuePtr,  ///< [IN] The registration object.
-    void* contextPtr       ///< [IN] Context info including the ref for the session that closed.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to save.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Convert our pointers into something useable.
-    Registration_t* registrationPtr = (Registration_t*)valuePtr;
-    CleanUpContext_t* cleanUpContextPtr = (CleanUpContext_t*)contextPtr;
+    int oldId = treeRef->revisionId;
 
-    // Go through this registration object's list of update handlers and check to see if they were
-    // registered on the target session.  If so, free them from the list.
-    le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
+    IncrementRevision(treeRef);
 
-    while (linkPtr != NULL)
+    // A journal may have been left behind from the last time this revision was used, if the
+    // system went down while that tree file was being replaced.  It doesn't belong to the new
+    // tree file.
+    DeleteJournalFile(treeRef->name, treeRef->revisionId);
+
+    char filePath[LE_CFG_STR_LEN_BYTES] = "";
+    GetTreePath(treeRef->name, treeRef->revisionId, filePath, sizeof(filePath));
+
+    LE_DEBUG("Attempting to serialize the tree to '%s'.", filePath);
+
+    int fileRef = -1;
+
+    do
     {
-        Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
-        linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
+        fileRef = open(filePath, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    }
+    while (   (fileRef == -1)
+           && (errno == EINTR));
 
-        if (handlerObjectPtr->sessionRef == cleanUpContextPtr->sessionRef)
-        {
-            RemoveHandler(registrationPtr, handlerObjectPtr);
-        }
+    if ((-1 == fileRef) && (EROFS == errno))
+    {
+        // In case we are R/O for the config tree, we discard the update to flash
+        treeRef->revisionId = oldId;
+        return;
     }
 
-    // Now, check to see if there are any handlers left in this object.  If the registration object
-    // is empty, then queue it for deletion.
-    if (le_dls_IsEmpty(&registrationPtr->handlerList))
+    if (fileRef == -1)
     {
-        registrationPtr->link = LE_SLS_LINK_INIT;
-        le_sls_Queue(&cleanUpContextPtr->deleteQueue, &registrationPtr->link);
+        LE_EMERG("Failed to open config file '%s' (%m).", filePath);
+        LE_EMERG("Changes have been merged in memory, however they could not be committed to the "
+                 "filesystem!!");
+        treeRef->revisionId = oldId;
+        return;
     }
 
-    // We want to continue iterating through the collection.
-    return true;
+    // We have a tree file to write to, so write the new snapshot to it.  Then make sure that it's
+    // actually on the disk before the old tree file and journal are removed.
+    le_result_t writeResult = WriteSnapshot(treeRef->rootNodeRef, fileRef);
+
+    if (   (writeResult == LE_OK)
+        && (fdatasync(fileRef) == -1))
+    {
+        LE_EMERG("Failed to flush the tree file: %s", strerror(errno));
+        writeResult = LE_IO_ERROR;
+    }
+
+    int retVal = -1;
+
+    do
+    {
+        retVal = close(fileRef);
+    }
+    while ((retVal == -1) && (errno == EINTR));
+
+    LE_EMERG_IF(retVal == -1, "An error occurred while closing the tree file: %s", strerror(errno));
+
+
+    // Finally remove the old version of the tree file and its journal, if there are any.
+    if (writeResult == LE_OK)
+    {
+        if (oldId != 0)
+        {
+            if (TreeFileExists(treeRef->name, oldId))
+            {
+                GetTreePath(treeRef->name, oldId, filePath, sizeof(filePath));
+                DeleteTreeFile(filePath);
+            }
+
+            DeleteJournalFile(treeRef->name, oldId);
+        }
+
+        treeRef->journalBytes = 0;
+
+        if (treeRef->compactTimerRef != NULL)
+        {
+            le_timer_Stop(treeRef->compactTimerRef);
+        }
+
+        // Writing the snapshot loaded all of the nodes that were left in the old one.
+        ReleaseSnapshot(treeRef);
+    }
+    else
+    {
+        // The write failed, delete the new file we attempted to create.  The old tree file and
+        // journal are still good, so keep using those.
+        LE_EMERG("The attempt to write to the config tree file, '%s,' failed.", filePath);
+        DeleteTreeFile(filePath);
+        treeRef->revisionId = oldId;
+    }
 }
 
 
@@ -2614,21 +4410,20 @@ static bool OnHandlerRegistrationCleanup
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Call this function to delete a tree file from the filesystem.
+ *  Called when a tree's journal has reached JOURNAL_MAX_AGE, to fold it into a new tree file.
  */
 // -------------------------------------------------------------------------------------------------
-static void DeleteTreeFile
+static void OnCompactTimeout
 (
-    const char* filePathPtr  ///< Path to the tree file in question.
+    le_timer_Ref_t timerRef  ///< [IN] The timer that expired.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    LE_DEBUG("** Deleting tree file, '%s'.", filePathPtr);
+    tdb_TreeRef_t treeRef = (tdb_TreeRef_t)le_timer_GetContextPtr(timerRef);
+    LE_ASSERT(treeRef->compactTimerRef == timerRef);
 
-    if (unlink(filePathPtr) != 0)
-    {
-        LE_ERROR("File delete failure, '%s', reason '%m'.", filePathPtr);
-    }
+    LE_DEBUG("Folding the journal of tree '%s' into a new tree file.", treeRef->name);
+    CompactTree(treeRef);
 }
 
 
@@ -2636,32 +4431,30 @@ static void DeleteTreeFile
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Find the root node represented by the path ref.
- *
- *  If the path is an absolute path, then the base node for the reference is the root node of the
- *  tree in question.
- *
- *  If the path is a relative path, then the base node of the request is the node given.
- *
- *  @return A reference to the base node of the operation.
+ *  Make sure that a tree's journal will be folded into a new tree file once it's JOURNAL_MAX_AGE
+ *  seconds old.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t GetPathBaseNodeRef
+static void StartCompactTimer
 (
-    tdb_NodeRef_t nodeRef,         ///< [IN] The base node to start from.
-    le_pathIter_Ref_t nodePathRef  ///< [IN] The path we're searching for in the tree.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree with the journal.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the path is absolute and the node we were given is NOT the root node of it's tree, find
-    // the root node of the tree.  Otherwise just return the node reference we were given.
-    if (   (le_pathIter_IsAbsolute(nodePathRef))
-        && (nodeRef->parentRef != NULL))
+    if (treeRef->compactTimerRef == NULL)
     {
-        nodeRef = GetRootParentNode(nodeRef);
+        le_clk_Time_t maxAge = { JOURNAL_MAX_AGE, 0 };
+        treeRef->compactTimerRef = le_timer_Create("Journal Timer");
+
+        LE_ASSERT(le_timer_SetInterval(treeRef->compactTimerRef, maxAge) == LE_OK);
+        LE_ASSERT(le_timer_SetHandler(treeRef->compactTimerRef, OnCompactTimeout) == LE_OK);
+        LE_ASSERT(le_timer_SetContextPtr(treeRef->compactTimerRef, treeRef) == LE_OK);
     }
 
-    return nodeRef;
+    if (le_timer_IsRunning(treeRef->compactTimerRef) == false)
+    {
+        LE_ASSERT(le_timer_Start(treeRef->compactTimerRef) == LE_OK);
+    }
 }
 
 
@@ -2669,78 +4462,84 @@ static tdb_NodeRef_t GetPathBaseNodeRef
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new C style file pointer from the POSIX file descriptor.
+ *  Append a record to the journal of a tree's current revision, and flush it to the disk.
  *
- *  @return A file pointer that may be read or written if successful.  A null pointer otherwise.
+ *  @return LE_OK if the record was saved, (or the config tree is read only,) LE_IO_ERROR if not.
  */
 // -------------------------------------------------------------------------------------------------
-static FILE* OpenFilePtr
+static le_result_t AppendJournal
 (
-    int descriptor,   ///< [IN] The POSIX file descriptor to create a file pointer from.
-    const char* mode  ///< [IN] The mode to open the file pointer in.
+    tdb_TreeRef_t treeRef,             ///< [IN] The tree the record is for.
+    const JournalRecord_t* recordPtr   ///< [IN] The record to append.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Duplicate the file descriptor, this is because we later use a C library file pointer for the
-    // parsing routines.  When the file pointer is closed it also closes the underlying descriptor,
-    // which may not be what the caller wants or expects.
-    int newDescriptor = -1;
+    char filePath[LE_CFG_STR_LEN_BYTES] = "";
+    GetJournalPath(treeRef->name, treeRef->revisionId, filePath, sizeof(filePath));
+
+    if (filePath[0] == '\0')
+    {
+        return LE_IO_ERROR;
+    }
+
+    int fileRef = -1;
 
     do
     {
-        newDescriptor = dup(descriptor);
+        fileRef = open(filePath, O_WRONLY | O_CREAT | O_APPEND, S_IRUSR | S_IWUSR);
     }
-    while (   (newDescriptor == -1)
+    while (   (fileRef == -1)
            && (errno == EINTR));
 
-    if (newDescriptor == -1)
+    if ((-1 == fileRef) && (EROFS == errno))
     {
-        LE_ERROR("Could not duplicate file descriptor, reason: %s", strerror(errno));
-        return NULL;
+        // In case we are R/O for the config tree, we discard the update to flash
+        return LE_OK;
     }
 
-    // Attempt to open the file pointer from the descriptor.
-    FILE* filePtr = fdopen(newDescriptor, mode);
-
-    if (filePtr == NULL)
+    if (fileRef == -1)
     {
-        // The open failed, so clean up the dangling descriptor.
-        int oldErrno = errno;
-        int closeResult;
+        LE_ERROR("Failed to open config journal '%s' (%m).", filePath);
+        return LE_IO_ERROR;
+    }
 
-        do
+    JournalHeader_t header =
         {
-            closeResult = close(newDescriptor);
-        }
-        while (   (closeResult == -1)
-               && (errno == EINTR));
+            .magic = JOURNAL_RECORD_MAGIC,
+            .size = recordPtr->size,
+            .crc = le_crc_Crc32((uint8_t*)recordPtr->bufferPtr, recordPtr->size, LE_CRC_START_CRC32)
+        };
 
-        LE_ERROR("Could not access the input stream for tree import, reason: %s",
-                 strerror(oldErrno));
-    }
+    le_result_t result = LE_OK;
 
-    // Return the file pointer we have now.  Note, it may be NULL at this point.
-    return filePtr;
-}
+    if (   (fd_WriteSize(fileRef, &header, sizeof(header)) != sizeof(header))
+        || (fd_WriteSize(fileRef, recordPtr->bufferPtr, recordPtr->size) != recordPtr->size)
+        || (fdatasync(fileRef) == -1))
+    {
+        LE_ERROR("Failed to append to config journal '%s' (%m).", filePath);
+        result = LE_IO_ERROR;
 
+        // Don't leave part of a record behind for the next one to be appended after.
+        LE_ERROR_IF(ftruncate(fileRef, treeRef->journalBytes) == -1,
+                    "Failed to truncate config journal '%s' (%m).",
+                    filePath);
+    }
 
+    int retVal = -1;
 
+    do
+    {
+        retVal = close(fileRef);
+    }
+    while ((retVal == -1) && (errno == EINTR));
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Close the file pointer and flush any data left unwritten.
- */
-// -------------------------------------------------------------------------------------------------
-static void CloseFilePtr
-(
-    FILE* filePtr  ///< The file pointer to close.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    if (fclose(filePtr) == EOF)
+    if (result == LE_OK)
     {
-        LE_ERROR("Could not properly close file, reason: %s", strerror(errno));
+        treeRef->journalBytes += sizeof(header) + recordPtr->size;
+        StartCompactTimer(treeRef);
     }
+
+    return result;
 }
 
 
@@ -2774,6 +4573,8 @@ void tdb_Init
         le_mem_ExpandPool(NodePoolRef, 1000);
     }
 
+    ChildIndexPoolRef = le_mem_CreatePool(CFG_CHILD_INDEX_POOL_NAME, sizeof(ChildIndex_t));
+
 
     TreePoolRef = le_mem_CreatePool(CFG_TREE_POOL_NAME, sizeof(Tree_t));
     le_mem_SetDestructor(TreePoolRef, TreeDestructor);
@@ -2792,6 +4593,11 @@ void tdb_Init
     HandlerPool = le_mem_CreatePool(CFG_HANDLER_POOL_NAME, sizeof(Handler_t));
     RegistrationPool = le_mem_CreatePool(CFG_REGISTRATION_POOL_NAME, sizeof(Registration_t));
 
+    SnapshotStringMap = le_hashmap_Create(CFG_SNAPSHOT_STRING_MAP_NAME,
+                                          1031,
+                                          le_hashmap_HashVoidPointer,
+                                          le_hashmap_EqualsVoidPointer);
+
     // Preload the system tree.
     tdb_GetTree("system");
 }
@@ -2821,7 +4627,15 @@ tdb_TreeRef_t tdb_GetTree
         treeRef = NewTree(treeNamePtr, NULL);
         le_hashmap_Put(TreeCollectionRef, treeRef->name, treeRef);
 
-        LoadTree(treeRef);
+        bool isTextFile = LoadTree(treeRef);
+
+        // Don't leave changes sitting in the journal indefinitely if the tree isn't written to
+        // again.  A tree file in the old text format is replaced by a snapshot the same way.
+        if (   (treeRef->journalBytes > 0)
+            || (isTextFile))
+        {
+            StartCompactTimer(treeRef);
+        }
     }
 
     // Finally return the tree we have to the user.
@@ -2864,6 +4678,8 @@ void tdb_DeleteTree
 
                 DeleteTreeFile(filePathPtr);
             }
+
+            DeleteJournalFile(treeRef->name, id);
         }
 
         LE_ASSERT(le_hashmap_Remove(TreeCollectionRef, treeRef->name) == treeRef);
@@ -3126,8 +4942,8 @@ le_sls_List_t* tdb_GetRequestQueue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Merge a shadow tree into the original tree it was created from.  Once the change is merged the
- *  updated tree is serialized to the filesystem.
+ *  Merge a shadow tree into the original tree it was created from.  Once the change is merged it
+ *  is saved to the tree's journal in the filesystem.
  */
 // -------------------------------------------------------------------------------------------------
 void tdb_MergeTree
@@ -3136,80 +4952,54 @@ void tdb_MergeTree
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Get our shadow tree's root node and merge it's changes into the real tree.  Create a path
-    // iterator to track the merge and allow for update handlers to be called.
+    tdb_TreeRef_t originalTreeRef = shadowTreeRef->originalTreeRef;
     tdb_NodeRef_t nodeRef = shadowTreeRef->rootNodeRef;
-    le_pathIter_Ref_t pathRef = CreateBasePath(shadowTreeRef->originalTreeRef->name);
-
-    InternalMergeTree(shadowTreeRef->originalTreeRef->name, pathRef, nodeRef, false);
-    le_pathIter_Delete(pathRef);
 
-    // Now, go through and call the triggered callbacks.
-    FireTriggeredCallbacks();
+    // Start a journal record for this commit with the nodes that the merge is about to remove.
+    JournalRecord_t record = { .result = LE_OK };
 
-    // Now increment revision of the tree and open a tree file for writing.
-    tdb_TreeRef_t originalTreeRef = shadowTreeRef->originalTreeRef;
-    int oldId = originalTreeRef->revisionId;
+    record.filePtr = open_memstream(&record.bufferPtr, &record.size);
+    LE_ASSERT(record.filePtr != NULL);
 
-    IncrementRevision(originalTreeRef);
+    RecordChanges(&record, nodeRef, false);
 
-    char filePath[LE_CFG_STR_LEN_BYTES] = "";
-    GetTreePath(originalTreeRef->name, originalTreeRef->revisionId, filePath, sizeof(filePath));
+    // Get our shadow tree's root node and merge it's changes into the real tree.  Create a path
+    // iterator to track the merge and allow for update handlers to be called.
+    le_pathIter_Ref_t pathRef = CreateBasePath(originalTreeRef->name);
 
-    LE_DEBUG("Changes merged, now attempting to serialize the tree to '%s'.", filePath);
+    InternalMergeTree(originalTreeRef->name, pathRef, nodeRef, false);
+    le_pathIter_Delete(pathRef);
 
-    int fileRef = -1;
+    // Then finish the record with the new contents of the nodes that were changed.
+    RecordChanges(&record, nodeRef, true);
 
-    do
+    if (fclose(record.filePtr) != 0)
     {
-        fileRef = open(filePath, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+        record.result = LE_IO_ERROR;
     }
-    while (   (fileRef == -1)
-           && (errno == EINTR));
 
-    if ((-1 == fileRef) && (EROFS == errno))
-    {
-        // In case we are R/O for the config tree, we discard the update to flash
-        return;
-    }
+    // Now, go through and call the triggered callbacks.
+    FireTriggeredCallbacks();
 
-    if (fileRef == -1)
+    // Finally save the changes.  Normally, that's just a matter of appending the record to the
+    // tree's journal.  But if the tree has never been saved, or the journal is getting too big,
+    // write out a whole new tree file instead.
+    if (   (record.result == LE_OK)
+        && (record.size == 0))
     {
-        LE_EMERG("Failed to open config file '%s' (%m).", filePath);
-        LE_EMERG("Changes have been merged in memory, however they could not be committed to the "
-                 "filesystem!!");
-        return;
+        LE_DEBUG("Nothing was changed in tree '%s', so there's nothing to save.",
+                 originalTreeRef->name);
     }
-
-    // We have a tree file to write to, so stream the new tree to it then close the output file.
-    le_result_t writeResult = tdb_WriteTreeNode(originalTreeRef->rootNodeRef, fileRef);
-    int retVal = -1;
-
-    do
+    else if (   (record.result != LE_OK)
+             || (originalTreeRef->revisionId == 0)
+             || (originalTreeRef->journalBytes + sizeof(JournalHeader_t) + record.size
+                 > JOURNAL_MAX_BYTES)
+             || (AppendJournal(originalTreeRef, &record) != LE_OK))
     {
-        retVal = close(fileRef);
+        CompactTree(originalTreeRef);
     }
-    while ((retVal == -1) && (errno == EINTR));
-
-    LE_EMERG_IF(retVal == -1, "An error occurred while closing the tree file: %s", strerror(errno));
-
 
-    // Finally remove the old version of the tree file, if there is one.
-    if (writeResult == LE_OK)
-    {
-        if (   (oldId != 0)
-            && (TreeFileExists(originalTreeRef->name, oldId)))
-        {
-            GetTreePath(originalTreeRef->name, oldId, filePath, sizeof(filePath));
-            DeleteTreeFile(filePath);
-        }
-    }
-    else
-    {
-        // The write failed, delete the new file we attempted to create.
-        LE_EMERG("The attempt to write to the config tree file, '%s,' failed.", filePath);
-        DeleteTreeFile(filePath);
-    }
+    free(record.bufferPtr);
 }
 
 
@@ -3504,14 +5294,7 @@ le_result_t tdb_GetNodeName
     // NULL.  The reason that the name may be NULL is because the client never changed the name of
     // the node.  So, we just get the name from the original node, saving memory.  However, nodes
     // like the root node of a tree also do not have names.
-    dstr_Ref_t nameRef = nodeRef->nameRef;
-
-    if (   (IsShadow(nodeRef))
-        && (nodeRef->nameRef == NULL)
-        && (nodeRef->shadowRef != NULL))
-    {
-        nameRef = nodeRef->shadowRef->nameRef;
-    }
+    dstr_Ref_t nameRef = GetNameRef(nodeRef);
 
     // If the node has a name, copy it into the user buffer now.
     if (nameRef != NULL)
@@ -3574,15 +5357,19 @@ le_result_t tdb_SetNodeName
 
     // Copy over the new name.  Note that we don't care if this node is a shadow node.  Coping over
     // the name is taken care of as part of the merge process.
-    if (nodeRef->nameRef == NULL)
-    {
-        nodeRef->nameRef = dstr_NewFromCstr(stringPtr);
-    }
-    else
+    dstr_Ref_t oldNameRef = nodeRef->nameRef;
+
+    nodeRef->nameRef = dstr_NewFromCstr(stringPtr);
+
+    if (oldNameRef != NULL)
     {
-        dstr_CopyFromCstr(nodeRef->nameRef, stringPtr);
+        dstr_Release(oldNameRef);
     }
 
+    // Refile the node under its new name.
+    UnindexChild(nodeRef);
+    IndexChild(nodeRef);
+
     // If this is a shadow node and this is the change that modified it, then try to get it's
     // children now.  This is done so that later when this node is merged the merge code doesn't end
     // up thinking that the child nodes where removed.
@@ -3630,6 +5417,13 @@ le_cfg_nodeType_t tdb_GetNodeType
         return LE_CFG_TYPE_DOESNT_EXIST;
     }
 
+    // Stems are only written to snapshots if they have children, so there's no need to load them
+    // to find out if the stem is empty.
+    if (nodeRef->snapshotNodePtr != NULL)
+    {
+        return LE_CFG_TYPE_STEM;
+    }
+
     // If the node is a stem but has no children, then treat the node as empty.
     if (   (nodeRef->type == LE_CFG_TYPE_STEM)
         && (tdb_GetFirstActiveChildNode(nodeRef) == NULL))
@@ -3708,6 +5502,9 @@ void tdb_SetEmpty
     // If this is a stem node, then go through and clear out the children.
     if (nodeRef->type == LE_CFG_TYPE_STEM)
     {
+        DeleteChildIndex(nodeRef);
+        nodeRef->snapshotNodePtr = NULL;
+
         tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
 
         while (childRef != NULL)
@@ -3817,6 +5614,8 @@ tdb_NodeRef_t tdb_GetFirstChildNode
 {
     LE_ASSERT(nodeRef != NULL);
 
+    LoadSnapshotChildren(nodeRef);
+
     // Is this the type of node that has children?
     if (   (   (nodeRef->type != LE_CFG_TYPE_STEM)
             || (le_dls_IsEmpty(&nodeRef->info.children) == true))
@@ -4012,13 +5811,13 @@ void tdb_SetValueAsString
     // Mark this as a string node, and copy over the value.
     nodeRef->type = LE_CFG_TYPE_STRING;
 
-    if (nodeRef->info.valueRef == NULL)
-    {
-        nodeRef->info.valueRef = dstr_NewFromCstr(stringPtr);
-    }
-    else
+    dstr_Ref_t oldValueRef = nodeRef->info.valueRef;
+
+    nodeRef->info.valueRef = dstr_NewFromCstr(stringPtr);
+
+    if (oldValueRef != NULL)
     {
-        dstr_CopyFromCstr(nodeRef->info.valueRef, stringPtr);
+        dstr_Release(oldValueRef);
     }
 
     // Make sure the system knows this node has been modified so that it can be included for merging
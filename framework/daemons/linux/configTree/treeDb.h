@@ -227,8 +227,8 @@ le_sls_List_t* tdb_GetRequestQueue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Merge a shadow tree into the original tree it was created from.  Once the change is merged the
- *  updated tree is serialized to the filesystem.
+ *  Merge a shadow tree into the original tree it was created from.  Once the change is merged it
+ *  is saved to the tree's journal in the filesystem.
  */
 // -------------------------------------------------------------------------------------------------
 void tdb_MergeTree
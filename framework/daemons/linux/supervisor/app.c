@@ -47,6 +47,7 @@
 #include "proc.h"
 #include "user.h"
 #include "le_cfg_interface.h"
+#include "cfgSnapshot.h"
 #include "resourceLimits.h"
 #include "smack.h"
 #include "supervisor.h"
@@ -341,6 +342,8 @@ typedef struct app_Ref
     le_timer_Ref_t  killTimer;          // Timeout timer for killing processes.
     le_sls_List_t   additionalLinks;    // List of additional links that are temporarily added to
                                         // the app.
+    cfgSnapshot_Ref_t cfgSnapshot;      // Snapshot of our config while the app is being created or
+                                        // started.  NULL otherwise.
 }
 App_t;
 
@@ -436,14 +439,14 @@ static le_result_t CreateSupplementaryGroups
 )
 {
     // Get an iterator to the supplementary groups list in the config.
-    le_cfg_IteratorRef_t cfgIter = le_cfg_CreateReadTxn(appRef->cfgPathRoot);
+    cfgSnapshot_IteratorRef_t cfgIter = cfgSnapshot_CreateIterator(appRef->cfgSnapshot, "");
 
-    le_cfg_GoToNode(cfgIter, CFG_NODE_GROUPS);
+    cfgSnapshot_GoToNode(cfgIter, CFG_NODE_GROUPS);
 
-    if (le_cfg_GoToFirstChild(cfgIter) != LE_OK)
+    if (cfgSnapshot_GoToFirstChild(cfgIter) != LE_OK)
     {
         LE_DEBUG("No supplementary groups for app '%s'.", appRef->name);
-        le_cfg_CancelTxn(cfgIter);
+        cfgSnapshot_DeleteIterator(cfgIter);
 
         return LE_OK;
     }
@@ -454,10 +457,10 @@ static le_result_t CreateSupplementaryGroups
     {
         // Read the supplementary group name from the config.
         char groupName[LIMIT_MAX_USER_NAME_BYTES];
-        if (le_cfg_GetNodeName(cfgIter, "", groupName, sizeof(groupName)) != LE_OK)
+        if (cfgSnapshot_GetNodeName(cfgIter, "", groupName, sizeof(groupName)) != LE_OK)
         {
             LE_ERROR("Could not read supplementary group for app '%s'.", appRef->name);
-            le_cfg_CancelTxn(cfgIter);
+            cfgSnapshot_DeleteIterator(cfgIter);
             return LE_FAULT;
         }
 
@@ -466,7 +469,7 @@ static le_result_t CreateSupplementaryGroups
         if (user_CreateGroup(groupName, &gid) == LE_FAULT)
         {
             LE_ERROR("Could not create supplementary group '%s'.", groupName);
-            le_cfg_CancelTxn(cfgIter);
+            cfgSnapshot_DeleteIterator(cfgIter);
             return LE_FAULT;
         }
 
@@ -474,21 +477,21 @@ static le_result_t CreateSupplementaryGroups
         appRef->supplementGids[i] = gid;
 
         // Go to the next group.
-        if (le_cfg_GoToNextSibling(cfgIter) != LE_OK)
+        if (cfgSnapshot_GoToNextSibling(cfgIter) != LE_OK)
         {
             break;
         }
         else if (i >= LIMIT_MAX_NUM_SUPPLEMENTARY_GROUPS - 1)
         {
             LE_ERROR("Too many supplementary groups for app '%s'.", appRef->name);
-            le_cfg_CancelTxn(cfgIter);
+            cfgSnapshot_DeleteIterator(cfgIter);
             return LE_FAULT;
         }
     }
 
     appRef->numSupplementGids = i + 1;
 
-    le_cfg_CancelTxn(cfgIter);
+    cfgSnapshot_DeleteIterator(cfgIter);
 
     return LE_OK;
 }
@@ -553,7 +556,7 @@ static le_result_t CreateUserAndGroups
 //--------------------------------------------------------------------------------------------------
 static void GetCfgPermissions
 (
-    le_cfg_IteratorRef_t cfgIter,       ///< [IN] Config iterator pointing to the device file.
+    cfgSnapshot_IteratorRef_t cfgIter,  ///< [IN] Config iterator pointing to the device file.
     char* bufPtr,                       ///< [OUT] Buffer to hold the permission string.
     size_t bufSize                      ///< [IN] Size of the buffer.
 )
@@ -563,12 +566,12 @@ static void GetCfgPermissions
 
     int i = 0;
 
-    if (le_cfg_GetBool(cfgIter, "isReadable", false))
+    if (cfgSnapshot_GetBool(cfgIter, "isReadable", false))
     {
         bufPtr[i++] = 'r';
     }
 
-    if (le_cfg_GetBool(cfgIter, "isWritable", false))
+    if (cfgSnapshot_GetBool(cfgIter, "isWritable", false))
     {
         bufPtr[i++] = 'w';
     }
@@ -589,14 +592,14 @@ static void GetCfgPermissions
 static le_result_t GetDevSrcPath
 (
     app_Ref_t appRef,                   ///< [IN] Reference to the application object.
-    le_cfg_IteratorRef_t cfgIter,       ///< [IN] Config iterator for the import.
+    cfgSnapshot_IteratorRef_t cfgIter,  ///< [IN] Config iterator for the import.
     char* bufPtr,                       ///< [OUT] Buffer to store the source path.
     size_t bufSize                      ///< [IN] Size of the buffer.
 )
 {
     char srcPath[LIMIT_MAX_PATH_BYTES] = "";
 
-    if (le_cfg_GetString(cfgIter, "src", srcPath, sizeof(srcPath), "") != LE_OK)
+    if (cfgSnapshot_GetString(cfgIter, "src", srcPath, sizeof(srcPath), "") != LE_OK)
     {
         LE_ERROR("Source file path '%s...' for app '%s' is too long.", srcPath, app_GetName(appRef));
         return LE_FAULT;
@@ -716,13 +719,13 @@ static le_result_t SetCfgDevicePermissions
 )
 {
     // Create an iterator for the app.
-    le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(app_GetConfigPath(appRef));
+    cfgSnapshot_IteratorRef_t appCfg = cfgSnapshot_CreateIterator(appRef->cfgSnapshot, "");
 
     // Get the list of device files.
-    le_cfg_GoToNode(appCfg, CFG_NODE_REQUIRES);
-    le_cfg_GoToNode(appCfg, CFG_NODE_DEVICES);
+    cfgSnapshot_GoToNode(appCfg, CFG_NODE_REQUIRES);
+    cfgSnapshot_GoToNode(appCfg, CFG_NODE_DEVICES);
 
-    if (le_cfg_GoToFirstChild(appCfg) == LE_OK)
+    if (cfgSnapshot_GoToFirstChild(appCfg) == LE_OK)
     {
         // Get the app's SMACK label.
         char appLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
@@ -734,7 +737,7 @@ static le_result_t SetCfgDevicePermissions
             char srcPath[LIMIT_MAX_PATH_BYTES];
             if (GetDevSrcPath(appRef, appCfg, srcPath, sizeof(srcPath)) != LE_OK)
             {
-                le_cfg_CancelTxn(appCfg);
+                cfgSnapshot_DeleteIterator(appCfg);
                 return LE_FAULT;
             }
 
@@ -744,16 +747,16 @@ static le_result_t SetCfgDevicePermissions
 
             if (SetDevicePermissions(appLabel, srcPath, permStr) != LE_OK)
             {
-                le_cfg_CancelTxn(appCfg);
+                cfgSnapshot_DeleteIterator(appCfg);
                 return LE_FAULT;
             }
         }
-        while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
+        while (cfgSnapshot_GoToNextSibling(appCfg) == LE_OK);
 
-        le_cfg_GoToParent(appCfg);
+        cfgSnapshot_GoToParent(appCfg);
     }
 
-    le_cfg_CancelTxn(appCfg);
+    cfgSnapshot_DeleteIterator(appCfg);
 
     return LE_OK;
 }
@@ -770,22 +773,23 @@ static void SetSmackRulesForBindings
     const char* appLabelPtr             ///< [IN] Smack label for the app.
 )
 {
-    // Create a config read transaction to the bindings section for the application.
-    le_cfg_IteratorRef_t bindCfg = le_cfg_CreateReadTxn(appRef->cfgPathRoot);
-    le_cfg_GoToNode(bindCfg, CFG_NODE_BINDINGS);
+    // Create an iterator to the bindings section for the application.
+    cfgSnapshot_IteratorRef_t bindCfg = cfgSnapshot_CreateIterator(appRef->cfgSnapshot, "");
+    cfgSnapshot_GoToNode(bindCfg, CFG_NODE_BINDINGS);
 
     // Search the binding sections for server applications we need to set rules for.
-    if (le_cfg_GoToFirstChild(bindCfg) != LE_OK)
+    if (cfgSnapshot_GoToFirstChild(bindCfg) != LE_OK)
     {
         // No bindings.
-        le_cfg_CancelTxn(bindCfg);
+        cfgSnapshot_DeleteIterator(bindCfg);
+        return;
     }
 
     do
     {
         char serverName[LIMIT_MAX_APP_NAME_BYTES];
 
-        if ( (le_cfg_GetString(bindCfg, "app", serverName, sizeof(serverName), "") == LE_OK) &&
+        if ( (cfgSnapshot_GetString(bindCfg, "app", serverName, sizeof(serverName), "") == LE_OK) &&
              (strcmp(serverName, "") != 0) )
         {
             // Get the server's SMACK label.
@@ -796,9 +800,9 @@ static void SetSmackRulesForBindings
             smack_SetRule(appLabelPtr, "rw", serverLabel);
             smack_SetRule(serverLabel, "rw", appLabelPtr);
         }
-    } while (le_cfg_GoToNextSibling(bindCfg) == LE_OK);
+    } while (cfgSnapshot_GoToNextSibling(bindCfg) == LE_OK);
 
-    le_cfg_CancelTxn(bindCfg);
+    cfgSnapshot_DeleteIterator(bindCfg);
 }
 
 
@@ -1819,14 +1823,14 @@ static le_result_t CreateLibBinLinks
 static le_result_t GetBundledReadOnlySrcPath
 (
     app_Ref_t appRef,                   ///< [IN] Reference to the application object.
-    le_cfg_IteratorRef_t cfgIter,       ///< [IN] Config iterator.
+    cfgSnapshot_IteratorRef_t cfgIter,  ///< [IN] Config iterator.
     char* bufPtr,                       ///< [OUT] Buffer to store the source path.
     size_t bufSize                      ///< [IN] Size of the buffer.
 )
 {
     char srcPath[LIMIT_MAX_PATH_BYTES] = "";
 
-    if (le_cfg_GetString(cfgIter, "src", srcPath, sizeof(srcPath), "") != LE_OK)
+    if (cfgSnapshot_GetString(cfgIter, "src", srcPath, sizeof(srcPath), "") != LE_OK)
     {
         LE_ERROR("Source file path '%s...' for app '%s' is too long.", srcPath, app_GetName(appRef));
         return LE_FAULT;
@@ -1880,12 +1884,12 @@ static le_result_t GetBundledReadOnlySrcPath
 static le_result_t GetDestPath
 (
     app_Ref_t appRef,                   ///< [IN] Reference to the application object.
-    le_cfg_IteratorRef_t cfgIter,       ///< [IN] Config iterator.
+    cfgSnapshot_IteratorRef_t cfgIter,  ///< [IN] Config iterator.
     char* bufPtr,                       ///< [OUT] Buffer to store the path.
     size_t bufSize                      ///< [IN] Size of the buffer.
 )
 {
-    if (le_cfg_GetString(cfgIter, "dest", bufPtr, bufSize, "") != LE_OK)
+    if (cfgSnapshot_GetString(cfgIter, "dest", bufPtr, bufSize, "") != LE_OK)
     {
         LE_ERROR("Destination path '%s...' for app '%s' is too long.", bufPtr, appRef->name);
         return LE_FAULT;
@@ -1913,12 +1917,12 @@ static le_result_t GetDestPath
 static le_result_t GetSrcPath
 (
     app_Ref_t appRef,                   ///< [IN] Reference to the application object.
-    le_cfg_IteratorRef_t cfgIter,       ///< [IN] Config iterator.
+    cfgSnapshot_IteratorRef_t cfgIter,  ///< [IN] Config iterator.
     char* bufPtr,                       ///< [OUT] Buffer to store the path.
     size_t bufSize                      ///< [IN] Size of the buffer.
 )
 {
-    if (le_cfg_GetString(cfgIter, "src", bufPtr, bufSize, "") != LE_OK)
+    if (cfgSnapshot_GetString(cfgIter, "src", bufPtr, bufSize, "") != LE_OK)
     {
         LE_ERROR("Source path '%s...' for app '%s' is too long.", bufPtr, appRef->name);
         return LE_FAULT;
@@ -1950,24 +1954,24 @@ static le_result_t CreateBundledLinks
 )
 {
     // Get a config iterator for this app.
-    le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(appRef->cfgPathRoot);
+    cfgSnapshot_IteratorRef_t appCfg = cfgSnapshot_CreateIterator(appRef->cfgSnapshot, "");
 
     // Go to the bundled directories section.
-    le_cfg_GoToNode(appCfg, CFG_NODE_BUNDLES);
-    le_cfg_GoToNode(appCfg, CFG_NODE_DIRS);
+    cfgSnapshot_GoToNode(appCfg, CFG_NODE_BUNDLES);
+    cfgSnapshot_GoToNode(appCfg, CFG_NODE_DIRS);
 
-    if (le_cfg_GoToFirstChild(appCfg) == LE_OK)
+    if (cfgSnapshot_GoToFirstChild(appCfg) == LE_OK)
     {
         do
         {
             // Only handle read only directories.
-            if (!le_cfg_GetBool(appCfg, "isWritable", false))
+            if (!cfgSnapshot_GetBool(appCfg, "isWritable", false))
             {
                 // Get source path.
                 char srcPath[LIMIT_MAX_PATH_BYTES];
                 if (GetBundledReadOnlySrcPath(appRef, appCfg, srcPath, sizeof(srcPath)) != LE_OK)
                 {
-                    le_cfg_CancelTxn(appCfg);
+                    cfgSnapshot_DeleteIterator(appCfg);
                     return LE_FAULT;
                 }
 
@@ -1975,39 +1979,39 @@ static le_result_t CreateBundledLinks
                 char destPath[LIMIT_MAX_PATH_BYTES];
                 if (GetDestPath(appRef, appCfg, destPath, sizeof(destPath)) != LE_OK)
                 {
-                    le_cfg_CancelTxn(appCfg);
+                    cfgSnapshot_DeleteIterator(appCfg);
                     return LE_FAULT;
                 }
 
                 // Create links for all files in the source directory.
                 if (RecursivelyCreateLinks(appRef, appDirLabelPtr, srcPath, destPath) != LE_OK)
                 {
-                    le_cfg_CancelTxn(appCfg);
+                    cfgSnapshot_DeleteIterator(appCfg);
                     return LE_FAULT;
                 }
             }
         }
-        while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
+        while (cfgSnapshot_GoToNextSibling(appCfg) == LE_OK);
 
-        le_cfg_GoToParent(appCfg);
+        cfgSnapshot_GoToParent(appCfg);
     }
 
     // Go to the requires files section.
-    le_cfg_GoToParent(appCfg);
-    le_cfg_GoToNode(appCfg, CFG_NODE_FILES);
+    cfgSnapshot_GoToParent(appCfg);
+    cfgSnapshot_GoToNode(appCfg, CFG_NODE_FILES);
 
-    if (le_cfg_GoToFirstChild(appCfg) == LE_OK)
+    if (cfgSnapshot_GoToFirstChild(appCfg) == LE_OK)
     {
         do
         {
             // Only handle read only files.
-            if (!le_cfg_GetBool(appCfg, "isWritable", false))
+            if (!cfgSnapshot_GetBool(appCfg, "isWritable", false))
             {
                 // Get source path.
                 char srcPath[LIMIT_MAX_PATH_BYTES];
                 if (GetBundledReadOnlySrcPath(appRef, appCfg, srcPath, sizeof(srcPath)) != LE_OK)
                 {
-                    le_cfg_CancelTxn(appCfg);
+                    cfgSnapshot_DeleteIterator(appCfg);
                     return LE_FAULT;
                 }
 
@@ -2015,21 +2019,21 @@ static le_result_t CreateBundledLinks
                 char destPath[LIMIT_MAX_PATH_BYTES];
                 if (GetDestPath(appRef, appCfg, destPath, sizeof(destPath)) != LE_OK)
                 {
-                    le_cfg_CancelTxn(appCfg);
+                    cfgSnapshot_DeleteIterator(appCfg);
                     return LE_FAULT;
                 }
 
                 if (CreateFileLink(appRef, appDirLabelPtr, srcPath, destPath) != LE_OK)
                 {
-                    le_cfg_CancelTxn(appCfg);
+                    cfgSnapshot_DeleteIterator(appCfg);
                     return LE_FAULT;
                 }
             }
         }
-        while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
+        while (cfgSnapshot_GoToNextSibling(appCfg) == LE_OK);
     }
 
-    le_cfg_CancelTxn(appCfg);
+    cfgSnapshot_DeleteIterator(appCfg);
 
     return LE_OK;
 }
@@ -2048,10 +2052,10 @@ static le_result_t CreateRequiredFileLinks
 (
     app_Ref_t appRef,                   ///< [IN] Application reference.
     const char* appDirLabelPtr,         ///< [IN] SMACK label to use for created directories.
-    le_cfg_IteratorRef_t cfgIter        ///< [IN] Config iterator.
+    cfgSnapshot_IteratorRef_t cfgIter   ///< [IN] Config iterator.
 )
 {
-    if (le_cfg_GoToFirstChild(cfgIter) == LE_OK)
+    if (cfgSnapshot_GoToFirstChild(cfgIter) == LE_OK)
     {
         do
         {
@@ -2075,9 +2079,9 @@ static le_result_t CreateRequiredFileLinks
                 return LE_FAULT;
             }
         }
-        while (le_cfg_GoToNextSibling(cfgIter) == LE_OK);
+        while (cfgSnapshot_GoToNextSibling(cfgIter) == LE_OK);
 
-        le_cfg_GoToParent(cfgIter);
+        cfgSnapshot_GoToParent(cfgIter);
     }
 
     return LE_OK;
@@ -2100,13 +2104,13 @@ static le_result_t CreateRequiredLinks
 )
 {
     // Get a config iterator for this app.
-    le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(appRef->cfgPathRoot);
+    cfgSnapshot_IteratorRef_t appCfg = cfgSnapshot_CreateIterator(appRef->cfgSnapshot, "");
 
     // Go to the required directories section.
-    le_cfg_GoToNode(appCfg, CFG_NODE_REQUIRES);
-    le_cfg_GoToNode(appCfg, CFG_NODE_DIRS);
+    cfgSnapshot_GoToNode(appCfg, CFG_NODE_REQUIRES);
+    cfgSnapshot_GoToNode(appCfg, CFG_NODE_DIRS);
 
-    if (le_cfg_GoToFirstChild(appCfg) == LE_OK)
+    if (cfgSnapshot_GoToFirstChild(appCfg) == LE_OK)
     {
         do
         {
@@ -2115,7 +2119,7 @@ static le_result_t CreateRequiredLinks
 
             if (GetSrcPath(appRef, appCfg, srcPath, sizeof(srcPath)) != LE_OK)
             {
-                le_cfg_CancelTxn(appCfg);
+                cfgSnapshot_DeleteIterator(appCfg);
                 return LE_FAULT;
             }
 
@@ -2123,7 +2127,7 @@ static le_result_t CreateRequiredLinks
             char destPath[LIMIT_MAX_PATH_BYTES];
             if (GetDestPath(appRef, appCfg, destPath, sizeof(destPath)) != LE_OK)
             {
-                le_cfg_CancelTxn(appCfg);
+                cfgSnapshot_DeleteIterator(appCfg);
                 return LE_FAULT;
             }
 
@@ -2137,7 +2141,7 @@ static le_result_t CreateRequiredLinks
             {
                 if (CreateDirLink(appRef, appDirLabelPtr, srcPath, destPath) != LE_OK)
                 {
-                    le_cfg_CancelTxn(appCfg);
+                    cfgSnapshot_DeleteIterator(appCfg);
                     return LE_FAULT;
                 }
             }
@@ -2146,37 +2150,37 @@ static le_result_t CreateRequiredLinks
                 // Create links for all files in the source directory.
                 if (RecursivelyCreateLinks(appRef, appDirLabelPtr, srcPath, destPath) != LE_OK)
                 {
-                    le_cfg_CancelTxn(appCfg);
+                    cfgSnapshot_DeleteIterator(appCfg);
                     return LE_FAULT;
                 }
             }
         }
-        while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
+        while (cfgSnapshot_GoToNextSibling(appCfg) == LE_OK);
 
-        le_cfg_GoToParent(appCfg);
+        cfgSnapshot_GoToParent(appCfg);
     }
 
     // Go to the requires files section
-    le_cfg_GoToParent(appCfg);
-    le_cfg_GoToNode(appCfg, CFG_NODE_FILES);
+    cfgSnapshot_GoToParent(appCfg);
+    cfgSnapshot_GoToNode(appCfg, CFG_NODE_FILES);
 
     if (CreateRequiredFileLinks(appRef, appDirLabelPtr, appCfg) != LE_OK)
     {
-        le_cfg_CancelTxn(appCfg);
+        cfgSnapshot_DeleteIterator(appCfg);
         return LE_FAULT;
     }
 
     // Go to the devices section.
-    le_cfg_GoToParent(appCfg);
-    le_cfg_GoToNode(appCfg, CFG_NODE_DEVICES);
+    cfgSnapshot_GoToParent(appCfg);
+    cfgSnapshot_GoToNode(appCfg, CFG_NODE_DEVICES);
 
     if (CreateRequiredFileLinks(appRef, appDirLabelPtr, appCfg) != LE_OK)
     {
-        le_cfg_CancelTxn(appCfg);
+        cfgSnapshot_DeleteIterator(appCfg);
         return LE_FAULT;
     }
 
-    le_cfg_CancelTxn(appCfg);
+    cfgSnapshot_DeleteIterator(appCfg);
     return LE_OK;
 }
 
@@ -2442,6 +2446,7 @@ void app_Init
     ProcContainerPool = le_mem_CreatePool("ProcContainers", sizeof(ProcContainer_t));
 
     proc_Init();
+    cfgSnapshot_Init();
 
     // Create the appsWriteable area.
     if (le_dir_MakePath(APPS_WRITEABLE_DIR, S_IRUSR | S_IXUSR | S_IROTH | S_IXOTH) != LE_OK)
@@ -2554,6 +2559,24 @@ static ProcContainer_t* CreateProcContainer
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases the app's config snapshot, if it has one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseCfgSnapshot
+(
+    App_t* appPtr                       ///< [IN] The application.
+)
+{
+    if (appPtr->cfgSnapshot != NULL)
+    {
+        cfgSnapshot_Release(appPtr->cfgSnapshot);
+        appPtr->cfgSnapshot = NULL;
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates an application object.
@@ -2594,11 +2617,14 @@ app_Ref_t app_Create
     appPtr->state = APP_STATE_STOPPED;
     appPtr->killTimer = NULL;
 
+    // Read all of the app's config at once, rather than one value at a time.
+    appPtr->cfgSnapshot = cfgSnapshot_Read(appPtr->cfgPathRoot);
+
     // Get a config iterator for this app.
-    le_cfg_IteratorRef_t cfgIterator = le_cfg_CreateReadTxn(appPtr->cfgPathRoot);
+    cfgSnapshot_IteratorRef_t cfgIterator = cfgSnapshot_CreateIterator(appPtr->cfgSnapshot, "");
 
     // See if this is a sandboxed app.
-    appPtr->sandboxed = le_cfg_GetBool(cfgIterator, CFG_NODE_SANDBOXED, true);
+    appPtr->sandboxed = cfgSnapshot_GetBool(cfgIterator, CFG_NODE_SANDBOXED, true);
 
     // @todo: Create the user and all the groups for this app.  This function has a side affect
     //        where it populates the app's supplementary groups list and sets the uid and the
@@ -2640,17 +2666,18 @@ app_Ref_t app_Create
     }
 
     // Move the config iterator to the procs list for this app.
-    le_cfg_GoToNode(cfgIterator, CFG_NODE_PROC_LIST);
+    cfgSnapshot_GoToNode(cfgIterator, CFG_NODE_PROC_LIST);
 
     // Read the list of processes for this application from the config tree.
-    if (le_cfg_GoToFirstChild(cfgIterator) == LE_OK)
+    if (cfgSnapshot_GoToFirstChild(cfgIterator) == LE_OK)
     {
         do
         {
             // Get the process's config path.
             char procCfgPath[LIMIT_MAX_PATH_BYTES];
 
-            if (le_cfg_GetPath(cfgIterator, "", procCfgPath, sizeof(procCfgPath)) == LE_OVERFLOW)
+            if (cfgSnapshot_GetPath(cfgIterator, "", procCfgPath, sizeof(procCfgPath))
+                == LE_OVERFLOW)
             {
                 LE_ERROR("Internal path buffer too small.");
                 goto failed;
@@ -2679,7 +2706,7 @@ app_Ref_t app_Create
 
             le_dls_Queue(&(appPtr->procs), &(procContainerPtr->link));
         }
-        while (le_cfg_GoToNextSibling(cfgIterator) == LE_OK);
+        while (cfgSnapshot_GoToNextSibling(cfgIterator) == LE_OK);
     }
 
     // Set the resource limit for this application.
@@ -2709,13 +2736,14 @@ app_Ref_t app_Create
         goto failed;
     }
 
-    le_cfg_CancelTxn(cfgIterator);
+    cfgSnapshot_DeleteIterator(cfgIterator);
+    ReleaseCfgSnapshot(appPtr);
     return appPtr;
 
 failed:
 
+    cfgSnapshot_DeleteIterator(cfgIterator);
     app_Delete(appPtr);
-    le_cfg_CancelTxn(cfgIterator);
     return NULL;
 }
 
@@ -2762,6 +2790,9 @@ void app_Delete
     // Remove the resource limits.
     resLim_CleanupApp(appRef);
 
+    // Release the config snapshot, in case the app failed while it was being created.
+    ReleaseCfgSnapshot(appRef);
+
     // Delete all the process containers.
     DeleteProcContainersList(appRef->procs);
     DeleteProcContainersList(appRef->auxProcs);
@@ -2779,34 +2810,19 @@ void app_Delete
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Starts an application.
+ * Sets up the app's runtime area that is only needed while it runs, and starts all of its
+ * processes.
  *
  * @return
  *      LE_OK if successful.
  *      LE_FAULT if there was an error.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t app_Start
+static le_result_t StartProcs
 (
     app_Ref_t appRef                    ///< [IN] Reference to the application to start.
 )
 {
-    if (appRef->state == APP_STATE_RUNNING)
-    {
-        LE_ERROR("Application '%s' is already running.", appRef->name);
-
-        return LE_FAULT;
-    }
-
-    if (framework_IsStopping())
-    {
-        LE_ERROR("App '%s' cannot be started because framework is shutting down.",
-                 appRef->name);
-        return LE_FAULT;
-    }
-
-    appRef->state = APP_STATE_RUNNING;
-
     // Create /tmp for sandboxed apps and link in /tmp files.
     if (appRef->sandboxed)
     {
@@ -2854,6 +2870,47 @@ le_result_t app_Start
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts an application.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t app_Start
+(
+    app_Ref_t appRef                    ///< [IN] Reference to the application to start.
+)
+{
+    if (appRef->state == APP_STATE_RUNNING)
+    {
+        LE_ERROR("Application '%s' is already running.", appRef->name);
+
+        return LE_FAULT;
+    }
+
+    if (framework_IsStopping())
+    {
+        LE_ERROR("App '%s' cannot be started because framework is shutting down.",
+                 appRef->name);
+        return LE_FAULT;
+    }
+
+    appRef->state = APP_STATE_RUNNING;
+
+    // Read all of the app's config at once, for the app and its processes to use while starting.
+    appRef->cfgSnapshot = cfgSnapshot_Read(appRef->cfgPathRoot);
+
+    le_result_t result = StartProcs(appRef);
+
+    ReleaseCfgSnapshot(appRef);
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Stops an application.  This is an asynchronous function call that returns immediately but
@@ -3109,6 +3166,30 @@ const char* app_GetConfigPath
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a snapshot of an application's configuration.  While the application is being created or
+ * started the snapshot already read for that is shared, otherwise the configuration is read now.
+ *
+ * @return
+ *      A reference to the snapshot.  Must be released with cfgSnapshot_Release().
+ */
+//--------------------------------------------------------------------------------------------------
+cfgSnapshot_Ref_t app_GetConfigSnapshot
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+)
+{
+    if (appRef->cfgSnapshot != NULL)
+    {
+        cfgSnapshot_AddRef(appRef->cfgSnapshot);
+        return appRef->cfgSnapshot;
+    }
+
+    return cfgSnapshot_Read(appRef->cfgPathRoot);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets an application's supplementary groups list.
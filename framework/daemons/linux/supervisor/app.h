@@ -9,6 +9,7 @@
 #define LEGATO_SRC_APP_INCLUDE_GUARD
 
 #include "watchdogAction.h"
+#include "cfgSnapshot.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -330,6 +331,21 @@ const char* app_GetConfigPath
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a snapshot of an application's configuration.  While the application is being created or
+ * started the snapshot already read for that is shared, otherwise the configuration is read now.
+ *
+ * @return
+ *      A reference to the snapshot.  Must be released with cfgSnapshot_Release().
+ */
+//--------------------------------------------------------------------------------------------------
+cfgSnapshot_Ref_t app_GetConfigSnapshot
+(
+    app_Ref_t appRef                    ///< [IN] The application reference.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets an application's supplementary groups list.
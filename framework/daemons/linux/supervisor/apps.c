@@ -12,6 +12,12 @@
  * An app can be started by either an IPC call or automatically on start-up using the
  * apps_AutoStart() API.
  *
+ * Auto-start apps are started in an order built from their bindings in the config tree: an app
+ * bound to a service of another auto-start app is started after that app.  Apps are launched one
+ * at a time from the event loop, so the Supervisor stays responsive and the servers launched first
+ * are initializing while the rest are being set up.  Each launch is logged with its start time
+ * relative to the start of the auto-start and its duration ("Boot timeline" in the logs).
+ *
  * When an app is started for the first time a new app container object is created which contains a
  * list link, an app stop handler reference and the app object (which is also instantiated).
  *
@@ -102,6 +108,15 @@
 #define CFG_NODE_SANDBOXED                  "sandboxed"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The name of the node in the config tree that contains an app's bindings.  Each binding names
+ * the app that serves it in its "app" node, unless it is served by a non-app user.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CFG_NODE_BINDINGS                   "bindings"
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The name of the socket for the AppStop Server and Client.
@@ -248,6 +263,80 @@ static le_mem_PoolRef_t AppProcContainerPool;
 static le_ref_MapRef_t AppProcMap;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * An app to be started by apps_AutoStart().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char            name[LIMIT_MAX_APP_NAME_BYTES]; ///< Name of the app.
+    le_dls_Link_t   link;           ///< Link in the waiting, ready or launched auto-start list.
+    le_sls_List_t   clientList;     ///< Auto-start apps bound to this app's services.
+    size_t          serverCount;    ///< Number of this app's servers that are not launched yet.
+    bool            isLaunched;     ///< true if the app is on the launched list.
+}
+AutoStartApp_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A client of an app to be started by apps_AutoStart().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t   link;           ///< Link in the server's list of clients.
+    AutoStartApp_t* clientPtr;      ///< The client app.
+}
+AutoStartClient_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pools for auto-start apps and their clients.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t AutoStartAppPool;
+static le_mem_PoolRef_t AutoStartClientPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Auto-start apps waiting for their servers to be launched, apps ready to be launched, and apps
+ * already launched.  Launched apps are kept until the auto-start ends because apps that are still
+ * waiting may refer to them.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t WaitingAutoStartList = LE_DLS_LIST_INIT;
+static le_dls_List_t ReadyAutoStartList = LE_DLS_LIST_INIT;
+static le_dls_List_t LaunchedAutoStartList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true while apps_AutoStart() is launching apps.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AutoStartRunning = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time the auto-start began at, which the boot timeline is relative to.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t AutoStartTime;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler to be called when the auto-start is done.
+ */
+//--------------------------------------------------------------------------------------------------
+static apps_AutoStartDoneHandler_t AutoStartDoneHandler = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Deletes all application process containers for either an application or a client.
@@ -1120,6 +1209,241 @@ static void ProcBlockHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of milliseconds between two times.
+ */
+//--------------------------------------------------------------------------------------------------
+static unsigned long MsBetween
+(
+    le_clk_Time_t startTime,            ///< [IN] Start time.
+    le_clk_Time_t endTime               ///< [IN] End time.
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(endTime, startTime);
+
+    return (elapsed.sec * 1000) + (elapsed.usec / 1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find an app waiting to be auto-started.
+ *
+ * @return
+ *      A pointer to the app if found.
+ *      NULL if the app is not waiting to be auto-started.
+ */
+//--------------------------------------------------------------------------------------------------
+static AutoStartApp_t* GetWaitingAutoStartApp
+(
+    const char* appNamePtr              ///< [IN] Name of the app.
+)
+{
+    le_dls_Link_t* appLinkPtr = le_dls_Peek(&WaitingAutoStartList);
+
+    while (appLinkPtr != NULL)
+    {
+        AutoStartApp_t* appPtr = CONTAINER_OF(appLinkPtr, AutoStartApp_t, link);
+
+        if (strcmp(appPtr->name, appNamePtr) == 0)
+        {
+            return appPtr;
+        }
+
+        appLinkPtr = le_dls_PeekNext(&WaitingAutoStartList, appLinkPtr);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make an auto-start app wait for the servers of its bindings that are also auto-start apps.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddAutoStartServers
+(
+    le_cfg_IteratorRef_t appCfg,        ///< [IN] Iterator at the app's node.
+    AutoStartApp_t* appPtr              ///< [IN] The app.
+)
+{
+    le_cfg_GoToNode(appCfg, CFG_NODE_BINDINGS);
+
+    if (le_cfg_GoToFirstChild(appCfg) == LE_OK)
+    {
+        do
+        {
+            char serverName[LIMIT_MAX_APP_NAME_BYTES];
+
+            if (le_cfg_GetString(appCfg, "app", serverName, sizeof(serverName), "") != LE_OK)
+            {
+                continue;
+            }
+
+            AutoStartApp_t* serverPtr = GetWaitingAutoStartApp(serverName);
+
+            // Servers that aren't auto-started, and bindings to the app itself, don't delay it.
+            if ((serverPtr != NULL) && (serverPtr != appPtr))
+            {
+                AutoStartClient_t* clientPtr = le_mem_ForceAlloc(AutoStartClientPool);
+
+                clientPtr->link = LE_SLS_LINK_INIT;
+                clientPtr->clientPtr = appPtr;
+                le_sls_Queue(&(serverPtr->clientList), &(clientPtr->link));
+
+                appPtr->serverCount++;
+            }
+        }
+        while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
+
+        le_cfg_GoToParent(appCfg);
+    }
+
+    le_cfg_GoToParent(appCfg);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release all auto-start apps on a list.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseAutoStartApps
+(
+    le_dls_List_t* listPtr              ///< [IN] List of apps.
+)
+{
+    le_dls_Link_t* appLinkPtr;
+
+    while ((appLinkPtr = le_dls_Pop(listPtr)) != NULL)
+    {
+        AutoStartApp_t* appPtr = CONTAINER_OF(appLinkPtr, AutoStartApp_t, link);
+        le_sls_Link_t* clientLinkPtr;
+
+        while ((clientLinkPtr = le_sls_Pop(&(appPtr->clientList))) != NULL)
+        {
+            le_mem_Release(CONTAINER_OF(clientLinkPtr, AutoStartClient_t, link));
+        }
+
+        le_mem_Release(appPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the auto-start, releasing the apps that have not been launched yet, and call the auto-start
+ * done handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndAutoStart
+(
+    void
+)
+{
+    ReleaseAutoStartApps(&WaitingAutoStartList);
+    ReleaseAutoStartApps(&ReadyAutoStartList);
+    ReleaseAutoStartApps(&LaunchedAutoStartList);
+
+    AutoStartRunning = false;
+
+    // Clear the handler first, so that it is only ever called once.
+    apps_AutoStartDoneHandler_t doneHandler = AutoStartDoneHandler;
+    AutoStartDoneHandler = NULL;
+
+    if (doneHandler != NULL)
+    {
+        doneHandler();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Launch the next auto-start app, then queue this function again for the app after it.  Apps are
+ * launched one per pass of the event loop so that the Supervisor keeps handling IPC and SIGCHLD,
+ * and the servers already launched get to run, while the rest of the apps are started.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LaunchNextAutoStartApp
+(
+    void* param1Ptr,                    ///< [IN] Not used.
+    void* param2Ptr                     ///< [IN] Not used.
+)
+{
+    if (!AutoStartRunning)
+    {
+        return;
+    }
+
+    le_dls_Link_t* appLinkPtr = le_dls_Pop(&ReadyAutoStartList);
+
+    if (appLinkPtr == NULL)
+    {
+        // The apps left waiting are bound to each other in a cycle, so one of them must be
+        // started before its servers.
+        appLinkPtr = le_dls_Pop(&WaitingAutoStartList);
+
+        if (appLinkPtr == NULL)
+        {
+            LE_INFO("Boot timeline: auto-start done after %lu ms.",
+                    MsBetween(AutoStartTime, le_clk_GetRelativeTime()));
+
+            EndAutoStart();
+            return;
+        }
+
+        LE_WARN("App '%s' is in a cycle of bindings.  Starting it before its servers.",
+                CONTAINER_OF(appLinkPtr, AutoStartApp_t, link)->name);
+    }
+
+    AutoStartApp_t* appPtr = CONTAINER_OF(appLinkPtr, AutoStartApp_t, link);
+
+    appPtr->isLaunched = true;
+    le_dls_Queue(&LaunchedAutoStartList, &(appPtr->link));
+
+    // The app may have been started by an IPC command in the meantime.
+    if (GetActiveApp(appPtr->name) == NULL)
+    {
+        le_clk_Time_t launchTime = le_clk_GetRelativeTime();
+
+        // No need to check the return code because there is nothing we can do about errors.
+        le_result_t result = LaunchApp(appPtr->name);
+
+        le_clk_Time_t doneTime = le_clk_GetRelativeTime();
+
+        LE_INFO("Boot timeline: app '%s' launched at +%lu ms in %lu ms (%s).",
+                appPtr->name,
+                MsBetween(AutoStartTime, launchTime),
+                MsBetween(launchTime, doneTime),
+                LE_RESULT_TXT(result));
+    }
+
+    // Clients of the app no longer wait for it.
+    le_sls_Link_t* clientLinkPtr;
+
+    while ((clientLinkPtr = le_sls_Pop(&(appPtr->clientList))) != NULL)
+    {
+        AutoStartClient_t* clientPtr = CONTAINER_OF(clientLinkPtr, AutoStartClient_t, link);
+        AutoStartApp_t* clientAppPtr = clientPtr->clientPtr;
+
+        clientAppPtr->serverCount--;
+
+        if ((clientAppPtr->serverCount == 0) && !clientAppPtr->isLaunched)
+        {
+            le_dls_Remove(&WaitingAutoStartList, &(clientAppPtr->link));
+            le_dls_Queue(&ReadyAutoStartList, &(clientAppPtr->link));
+        }
+
+        le_mem_Release(clientPtr);
+    }
+
+    le_event_QueueFunction(LaunchNextAutoStartApp, NULL, NULL);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the applications system.
@@ -1135,6 +1459,8 @@ void apps_Init
     // Create memory pools.
     AppContainerPool = le_mem_CreatePool("appContainers", sizeof(AppContainer_t));
     AppProcContainerPool = le_mem_CreatePool("appProcContainers", sizeof(AppProcContainer_t));
+    AutoStartAppPool = le_mem_CreatePool("autoStartApps", sizeof(AutoStartApp_t));
+    AutoStartClientPool = le_mem_CreatePool("autoStartClients", sizeof(AutoStartClient_t));
 
     AppProcMap = le_ref_CreateMap("AppProcs", 5);
     AppMap = le_ref_CreateMap("App", 5);
@@ -1171,6 +1497,9 @@ void apps_Shutdown
     void
 )
 {
+    // Don't launch any more apps.
+    EndAutoStart();
+
     // Deletes all inactive apps first.
     DeletesAllInactiveApp();
 
@@ -1231,13 +1560,23 @@ void apps_SetShutdownHandler
 //--------------------------------------------------------------------------------------------------
 /**
  * Start all applications marked as 'auto' start.
+ *
+ * An app bound to services of other auto-start apps is started after those apps, so that their
+ * servers are already running when it connects.  The apps are started asynchronously, from the
+ * event loop.  The time each app is launched at, and how long its launch took, are logged as the
+ * boot timeline.
+ *
+ * The done handler is called once the last app has been launched, or apps_Shutdown() stopped the
+ * auto-start before that.  If there are no apps to start, it is called before this returns.
  */
 //--------------------------------------------------------------------------------------------------
 void apps_AutoStart
 (
-    void
+    apps_AutoStartDoneHandler_t doneHandler     ///< [IN] Auto-start done handler.  Can be NULL.
 )
 {
+    AutoStartDoneHandler = doneHandler;
+
     // Read the list of applications from the config tree.
     le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(CFG_NODE_APPS_LIST);
 
@@ -1247,9 +1586,13 @@ void apps_AutoStart
 
         le_cfg_CancelTxn(appCfg);
 
+        EndAutoStart();
+
         return;
     }
 
+    AutoStartTime = le_clk_GetRelativeTime();
+
     do
     {
         // Check the start mode for this application.
@@ -1266,15 +1609,60 @@ void apps_AutoStart
             }
             else
             {
-                // Launch the application now.  No need to check the return code because there is
-                // nothing we can do about errors.
-                LaunchApp(appName);
+                AutoStartApp_t* appPtr = le_mem_ForceAlloc(AutoStartAppPool);
+
+                LE_ASSERT(le_utf8_Copy(appPtr->name, appName, sizeof(appPtr->name), NULL) == LE_OK);
+                appPtr->link = LE_DLS_LINK_INIT;
+                appPtr->clientList = LE_SLS_LIST_INIT;
+                appPtr->serverCount = 0;
+                appPtr->isLaunched = false;
+
+                le_dls_Queue(&WaitingAutoStartList, &(appPtr->link));
+            }
+        }
+    }
+    while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
+
+    // Now that all the auto-start apps are known, build the start graph from their bindings.
+    le_cfg_GoToParent(appCfg);
+    le_cfg_GoToFirstChild(appCfg);
+
+    do
+    {
+        char appName[LIMIT_MAX_APP_NAME_BYTES];
+
+        if (le_cfg_GetNodeName(appCfg, "", appName, sizeof(appName)) == LE_OK)
+        {
+            AutoStartApp_t* appPtr = GetWaitingAutoStartApp(appName);
+
+            if (appPtr != NULL)
+            {
+                AddAutoStartServers(appCfg, appPtr);
             }
         }
     }
     while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
 
     le_cfg_CancelTxn(appCfg);
+
+    // Apps without auto-start servers are ready to start, in config order.
+    le_dls_Link_t* appLinkPtr = le_dls_Peek(&WaitingAutoStartList);
+
+    while (appLinkPtr != NULL)
+    {
+        AutoStartApp_t* appPtr = CONTAINER_OF(appLinkPtr, AutoStartApp_t, link);
+
+        appLinkPtr = le_dls_PeekNext(&WaitingAutoStartList, appLinkPtr);
+
+        if (appPtr->serverCount == 0)
+        {
+            le_dls_Remove(&WaitingAutoStartList, &(appPtr->link));
+            le_dls_Queue(&ReadyAutoStartList, &(appPtr->link));
+        }
+    }
+
+    AutoStartRunning = true;
+    le_event_QueueFunction(LaunchNextAutoStartApp, NULL, NULL);
 }
 
 
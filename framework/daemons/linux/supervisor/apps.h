@@ -20,6 +20,17 @@ typedef void (*apps_ShutdownHandler_t)
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype for the handler called when the auto-start of applications is done.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*apps_AutoStartDoneHandler_t)
+(
+    void
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the applications system.
@@ -33,12 +44,14 @@ void apps_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Start all applications marked as 'auto' start.
+ * Start all applications marked as 'auto' start.  The apps are launched asynchronously, and the
+ * done handler is called once the last of them has been launched, or the auto-start was cut short
+ * by a shut down.
  */
 //--------------------------------------------------------------------------------------------------
 void apps_AutoStart
 (
-    void
+    apps_AutoStartDoneHandler_t doneHandler     ///< [IN] Auto-start done handler.  Can be NULL.
 );
 
 
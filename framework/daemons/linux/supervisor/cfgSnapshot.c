@@ -0,0 +1,1119 @@
+//--------------------------------------------------------------------------------------------------
+/** @file supervisor/cfgSnapshot.c
+ *
+ * Implementation of the config snapshot API, which reads a subtree of the config tree with
+ * le_cfg_GetSnapshot() and then reads its values locally.  The format of the snapshot bytes is
+ * described in the le_cfg API.
+ *
+ * The snapshot's bytes are checked once, when the snapshot is created, so that the iterators can
+ * then walk them without checking every length.  An iterator keeps the offsets of the nodes from
+ * the snapshot's node down to its current node, so that moving to a parent or a sibling doesn't
+ * have to search the snapshot again.  Nodes that don't exist in the snapshot are kept as NO_NODE,
+ * so that, like a le_cfg iterator, an iterator can be moved to a node that doesn't exist.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "cfgSnapshot.h"
+#include "interfaces.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum depth of the nodes that can be reached below a snapshot's node.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_DEPTH                                       16
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Offset kept for the nodes that don't exist in the snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NO_NODE                                         SIZE_MAX
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the fixed part of a node: its type and the length of its name.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NODE_HEADER_BYTES                               2
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the length of a stem's children.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHILDREN_LEN_BYTES                              4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the length of a value.
+ */
+//--------------------------------------------------------------------------------------------------
+#define VALUE_LEN_BYTES                                 2
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffer used to convert numbers.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUMBER_BYTES                                    64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct cfgSnapshot_Snapshot
+{
+    char path[LE_CFG_STR_LEN_BYTES];    // Path of the snapshot's node, without leading or trailing
+                                        // separators.
+    uint8_t* bytesPtr;                  // The snapshot's bytes, or NULL if the node doesn't exist.
+    size_t numBytes;                    // Number of bytes.
+}
+Snapshot_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A position in a snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t depth;                       // Depth of the node below the snapshot's node.
+    size_t offsets[MAX_DEPTH + 1];      // Offsets of the nodes from the snapshot's node down.
+    size_t pathLens[MAX_DEPTH + 1];     // Length of the path of each of these nodes.
+    char path[LE_CFG_STR_LEN_BYTES];    // Absolute path of the node.
+}
+Position_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An iterator.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct cfgSnapshot_Iterator
+{
+    Snapshot_t* snapshotPtr;            // The snapshot, which the iterator holds a reference to.
+    Position_t pos;                     // The iterator's current node.
+}
+Iterator_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pools for snapshots and iterators.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SnapshotPool;
+static le_mem_PoolRef_t IteratorPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffer for the pieces of the snapshots read from the config tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t ReadBuffer[LE_CFG_SNAPSHOT_LEN];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Frees the bytes of a snapshot when it is released.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SnapshotDestructor
+(
+    void* objPtr
+)
+{
+    Snapshot_t* snapshotPtr = objPtr;
+
+    free(snapshotPtr->bytesPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads a little-endian length.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetLength
+(
+    const uint8_t* bytesPtr,        ///< [IN] The length's bytes.
+    size_t numBytes                 ///< [IN] Number of bytes.
+)
+{
+    size_t length = 0;
+
+    while (numBytes > 0)
+    {
+        numBytes--;
+        length = (length << 8) | bytesPtr[numBytes];
+    }
+
+    return length;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the offset of what comes after a node's name.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetBodyOffset
+(
+    const Snapshot_t* snapshotPtr,  ///< [IN] The snapshot.
+    size_t offset                   ///< [IN] Offset of the node.
+)
+{
+    return offset + NODE_HEADER_BYTES + snapshotPtr->bytesPtr[offset + 1];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the offset of the first child of a stem.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetChildrenOffset
+(
+    const Snapshot_t* snapshotPtr,  ///< [IN] The snapshot.
+    size_t offset                   ///< [IN] Offset of the stem.
+)
+{
+    return GetBodyOffset(snapshotPtr, offset) + CHILDREN_LEN_BYTES;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the offset of the end of a node.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetEndOffset
+(
+    const Snapshot_t* snapshotPtr,  ///< [IN] The snapshot.
+    size_t offset                   ///< [IN] Offset of the node.
+)
+{
+    size_t bodyOffset = GetBodyOffset(snapshotPtr, offset);
+    const uint8_t* bodyPtr = snapshotPtr->bytesPtr + bodyOffset;
+
+    switch (snapshotPtr->bytesPtr[offset])
+    {
+        case LE_CFG_TYPE_STEM:
+            return bodyOffset + CHILDREN_LEN_BYTES + GetLength(bodyPtr, CHILDREN_LEN_BYTES);
+
+        case LE_CFG_TYPE_EMPTY:
+            return bodyOffset;
+
+        default:
+            return bodyOffset + VALUE_LEN_BYTES + GetLength(bodyPtr, VALUE_LEN_BYTES);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that a node, and everything below it, fits in the given bytes.
+ *
+ * @return
+ *      The offset of the end of the node, or 0 if the node is not valid.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t CheckNode
+(
+    const uint8_t* bytesPtr,        ///< [IN] The snapshot's bytes.
+    size_t offset,                  ///< [IN] Offset of the node.
+    size_t endOffset                ///< [IN] Offset that the node must not go past.
+)
+{
+    if ((endOffset - offset) < NODE_HEADER_BYTES)
+    {
+        return 0;
+    }
+
+    le_cfg_nodeType_t type = bytesPtr[offset];
+    size_t bodyOffset = offset + NODE_HEADER_BYTES + bytesPtr[offset + 1];
+
+    if (bodyOffset > endOffset)
+    {
+        return 0;
+    }
+
+    switch (type)
+    {
+        case LE_CFG_TYPE_EMPTY:
+            return bodyOffset;
+
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_BOOL:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+            if ((endOffset - bodyOffset) < VALUE_LEN_BYTES)
+            {
+                return 0;
+            }
+
+            offset = bodyOffset + VALUE_LEN_BYTES;
+            offset += GetLength(bytesPtr + bodyOffset, VALUE_LEN_BYTES);
+
+            return (offset <= endOffset) ? offset : 0;
+
+        case LE_CFG_TYPE_STEM:
+        {
+            if ((endOffset - bodyOffset) < CHILDREN_LEN_BYTES)
+            {
+                return 0;
+            }
+
+            offset = bodyOffset + CHILDREN_LEN_BYTES;
+
+            size_t childrenLen = GetLength(bytesPtr + bodyOffset, CHILDREN_LEN_BYTES);
+
+            if (childrenLen > (endOffset - offset))
+            {
+                return 0;
+            }
+
+            size_t childrenEnd = offset + childrenLen;
+
+            while (offset < childrenEnd)
+            {
+                offset = CheckNode(bytesPtr, offset, childrenEnd);
+
+                if (offset == 0)
+                {
+                    return 0;
+                }
+            }
+
+            return childrenEnd;
+        }
+
+        default:
+            return 0;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a snapshot that takes over a buffer of bytes, which is freed with the snapshot.
+ *
+ * @return
+ *      The snapshot, or NULL if the bytes are not a valid snapshot, in which case the buffer is
+ *      freed right away.
+ */
+//--------------------------------------------------------------------------------------------------
+static Snapshot_t* CreateSnapshot
+(
+    const char* pathPtr,            ///< [IN] Path in the config tree of the snapshot's node.
+    uint8_t* bytesPtr,              ///< [IN] The snapshot's bytes, allocated with malloc().
+    size_t numBytes                 ///< [IN] Number of bytes.  0 if the node doesn't exist.
+)
+{
+    // Keep the path without its leading and trailing separators, so that the paths of the nodes
+    // can simply be built by appending their names to it.
+    while (*pathPtr == '/')
+    {
+        pathPtr++;
+    }
+
+    size_t pathLen = strlen(pathPtr);
+
+    while ((pathLen > 0) && (pathPtr[pathLen - 1] == '/'))
+    {
+        pathLen--;
+    }
+
+    // Room is also needed for the leading separator of the absolute paths.
+    if (pathLen >= (LE_CFG_STR_LEN_BYTES - 1))
+    {
+        LE_ERROR("Config path '%s' is too long.", pathPtr);
+        free(bytesPtr);
+        return NULL;
+    }
+
+    if (   (numBytes > 0)
+        && (   (bytesPtr[0] != LE_CFG_SNAPSHOT_VERSION)
+            || (CheckNode(bytesPtr, 1, numBytes) != numBytes)))
+    {
+        LE_ERROR("Config snapshot of '%s' is not valid.", pathPtr);
+        free(bytesPtr);
+        return NULL;
+    }
+
+    Snapshot_t* snapshotPtr = le_mem_ForceAlloc(SnapshotPool);
+
+    memcpy(snapshotPtr->path, pathPtr, pathLen);
+    snapshotPtr->path[pathLen] = '\0';
+    snapshotPtr->bytesPtr = bytesPtr;
+    snapshotPtr->numBytes = numBytes;
+
+    return snapshotPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Appends a node name to the path of a position.
+ *
+ * @note This function does not return on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendToPath
+(
+    Position_t* posPtr,             ///< [IN] The position.
+    const char* namePtr,            ///< [IN] The name.
+    size_t nameLen                  ///< [IN] Length of the name.
+)
+{
+    size_t pathLen = posPtr->pathLens[posPtr->depth];
+    size_t sepLen = (pathLen > 1) ? 1 : 0;
+
+    LE_FATAL_IF(pathLen + sepLen + nameLen >= sizeof(posPtr->path),
+                "Config path '%s/%.*s' is too long.", posPtr->path, (int)nameLen, namePtr);
+
+    if (sepLen > 0)
+    {
+        posPtr->path[pathLen] = '/';
+    }
+
+    memcpy(posPtr->path + pathLen + sepLen, namePtr, nameLen);
+
+    posPtr->depth++;
+    posPtr->pathLens[posPtr->depth] = pathLen + sepLen + nameLen;
+    posPtr->path[posPtr->pathLens[posPtr->depth]] = '\0';
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves a position to the snapshot's node.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GoToRoot
+(
+    const Snapshot_t* snapshotPtr,  ///< [IN] The snapshot.
+    Position_t* posPtr              ///< [OUT] The position.
+)
+{
+    posPtr->depth = 0;
+    posPtr->offsets[0] = (snapshotPtr->bytesPtr != NULL) ? 1 : NO_NODE;
+    posPtr->pathLens[0] = snprintf(posPtr->path, sizeof(posPtr->path), "/%s", snapshotPtr->path);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves a position down to one of its node's children, which doesn't have to exist.
+ *
+ * @note This function does not return on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GoToChild
+(
+    const Snapshot_t* snapshotPtr,  ///< [IN] The snapshot.
+    Position_t* posPtr,             ///< [IN/OUT] The position.
+    const char* namePtr,            ///< [IN] Name of the child.
+    size_t nameLen                  ///< [IN] Length of the name.
+)
+{
+    LE_FATAL_IF(posPtr->depth >= MAX_DEPTH,
+                "Config path '%s/%.*s' is too deep.", posPtr->path, (int)nameLen, namePtr);
+
+    size_t offset = posPtr->offsets[posPtr->depth];
+    size_t childOffset = NO_NODE;
+
+    if ((offset != NO_NODE) && (snapshotPtr->bytesPtr[offset] == LE_CFG_TYPE_STEM))
+    {
+        size_t endOffset = GetEndOffset(snapshotPtr, offset);
+
+        offset = GetChildrenOffset(snapshotPtr, offset);
+
+        while (offset < endOffset)
+        {
+            if ((snapshotPtr->bytesPtr[offset + 1] == nameLen)
+                && (memcmp(snapshotPtr->bytesPtr + offset + NODE_HEADER_BYTES, namePtr, nameLen) == 0))
+            {
+                childOffset = offset;
+                break;
+            }
+
+            offset = GetEndOffset(snapshotPtr, offset);
+        }
+    }
+
+    AppendToPath(posPtr, namePtr, nameLen);
+    posPtr->offsets[posPtr->depth] = childOffset;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves a position along a path.
+ *
+ * @note This function does not return on error, including when the path leads outside of the
+ *       snapshot's node.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FollowPath
+(
+    const Snapshot_t* snapshotPtr,  ///< [IN] The snapshot.
+    Position_t* posPtr,             ///< [IN/OUT] The position.
+    const char* pathPtr             ///< [IN] Absolute or relative path.
+)
+{
+    if (pathPtr[0] == '/')
+    {
+        // Absolute paths must start with the path of the snapshot's node.
+        size_t rootLen = strlen(snapshotPtr->path);
+
+        while (*pathPtr == '/')
+        {
+            pathPtr++;
+        }
+
+        LE_FATAL_IF((strncmp(pathPtr, snapshotPtr->path, rootLen) != 0)
+                    || ((pathPtr[rootLen] != '/') && (pathPtr[rootLen] != '\0')),
+                    "Config path '/%s' is outside of the snapshot of '/%s'.",
+                    pathPtr, snapshotPtr->path);
+
+        GoToRoot(snapshotPtr, posPtr);
+        pathPtr += rootLen;
+    }
+
+    while (*pathPtr != '\0')
+    {
+        size_t nameLen = strcspn(pathPtr, "/");
+
+        if ((nameLen == 2) && (strncmp(pathPtr, "..", 2) == 0))
+        {
+            LE_FATAL_IF(posPtr->depth == 0,
+                        "Config path '%s/..' is outside of the snapshot.", posPtr->path);
+
+            posPtr->depth--;
+            posPtr->path[posPtr->pathLens[posPtr->depth]] = '\0';
+        }
+        else if ((nameLen > 0) && !((nameLen == 1) && (pathPtr[0] == '.')))
+        {
+            GoToChild(snapshotPtr, posPtr, pathPtr, nameLen);
+        }
+
+        pathPtr += nameLen;
+
+        if (*pathPtr == '/')
+        {
+            pathPtr++;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the offset of a node relative to an iterator's current node.
+ *
+ * @return
+ *      The offset of the node, or NO_NODE if the node doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t FindNode
+(
+    Iterator_t* iterPtr,            ///< [IN] The iterator.
+    const char* pathPtr             ///< [IN] Path to the node.  Can be empty.
+)
+{
+    if (pathPtr[0] == '\0')
+    {
+        return iterPtr->pos.offsets[iterPtr->pos.depth];
+    }
+
+    Position_t pos = iterPtr->pos;
+
+    FollowPath(iterPtr->snapshotPtr, &pos, pathPtr);
+
+    return pos.offsets[pos.depth];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the type of a node, the same way the config tree would.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_cfg_nodeType_t GetType
+(
+    const Snapshot_t* snapshotPtr,  ///< [IN] The snapshot.
+    size_t offset                   ///< [IN] Offset of the node, or NO_NODE.
+)
+{
+    if (offset == NO_NODE)
+    {
+        return LE_CFG_TYPE_DOESNT_EXIST;
+    }
+
+    return snapshotPtr->bytesPtr[offset];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies the value of a node into a buffer.  The node must hold a value.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the buffer is too small.  The truncated value is still copied.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CopyValue
+(
+    const Snapshot_t* snapshotPtr,  ///< [IN] The snapshot.
+    size_t offset,                  ///< [IN] Offset of the node.
+    char* bufPtr,                   ///< [OUT] Buffer for the value.
+    size_t bufSize                  ///< [IN] Size of the buffer.
+)
+{
+    const uint8_t* bodyPtr = snapshotPtr->bytesPtr + GetBodyOffset(snapshotPtr, offset);
+    size_t valueLen = GetLength(bodyPtr, VALUE_LEN_BYTES);
+    le_result_t result = LE_OK;
+
+    if (valueLen >= bufSize)
+    {
+        valueLen = bufSize - 1;
+        result = LE_OVERFLOW;
+    }
+
+    memcpy(bufPtr, bodyPtr + VALUE_LEN_BYTES, valueLen);
+    bufPtr[valueLen] = '\0';
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the config snapshot subsystem.  Must be called before any other function of this API.
+ */
+//--------------------------------------------------------------------------------------------------
+void cfgSnapshot_Init
+(
+    void
+)
+{
+    SnapshotPool = le_mem_CreatePool("CfgSnapshots", sizeof(Snapshot_t));
+    le_mem_SetDestructor(SnapshotPool, SnapshotDestructor);
+
+    IteratorPool = le_mem_CreatePool("CfgSnapshotIters", sizeof(Iterator_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a node of the config tree and everything below it.  If the node doesn't exist, an empty
+ * snapshot is returned, in which every read returns its default value, as it would from the config
+ * tree.
+ *
+ * @note This function does not return on error.
+ *
+ * @return
+ *      Reference to the snapshot.  Must be released with cfgSnapshot_Release().
+ */
+//--------------------------------------------------------------------------------------------------
+cfgSnapshot_Ref_t cfgSnapshot_Read
+(
+    const char* pathPtr             ///< [IN] Path of the node in the config tree.
+)
+{
+    le_cfg_IteratorRef_t cfgIter = le_cfg_CreateReadTxn(pathPtr);
+    uint8_t* bytesPtr = NULL;
+    size_t numBytes = 0;
+    uint32_t totalSize = 0;
+
+    // The pieces are read within one transaction, so they all come from the same snapshot.
+    do
+    {
+        size_t pieceSize = sizeof(ReadBuffer);
+        le_result_t result = le_cfg_GetSnapshot(cfgIter, "", numBytes, ReadBuffer, &pieceSize,
+                                                &totalSize);
+
+        if (result == LE_NOT_FOUND)
+        {
+            break;
+        }
+
+        LE_FATAL_IF(result != LE_OK, "Could not read the config of '%s' (%s).",
+                    pathPtr, LE_RESULT_TXT(result));
+        LE_FATAL_IF((pieceSize == 0) || ((numBytes + pieceSize) > totalSize),
+                    "Config snapshot of '%s' has an unexpected size.", pathPtr);
+
+        if (bytesPtr == NULL)
+        {
+            bytesPtr = malloc(totalSize);
+            LE_ASSERT(bytesPtr != NULL);
+        }
+
+        memcpy(bytesPtr + numBytes, ReadBuffer, pieceSize);
+        numBytes += pieceSize;
+    }
+    while (numBytes < totalSize);
+
+    le_cfg_CancelTxn(cfgIter);
+
+    cfgSnapshot_Ref_t snapshotRef = CreateSnapshot(pathPtr, bytesPtr, numBytes);
+
+    LE_FATAL_IF(snapshotRef == NULL, "Could not read the config of '%s'.", pathPtr);
+
+    return snapshotRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a snapshot from bytes in the format returned by le_cfg_GetSnapshot().
+ *
+ * @return
+ *      Reference to the snapshot, or NULL if the bytes are not a valid snapshot.  Must be released
+ *      with cfgSnapshot_Release().
+ */
+//--------------------------------------------------------------------------------------------------
+cfgSnapshot_Ref_t cfgSnapshot_Create
+(
+    const char* pathPtr,            ///< [IN] Path in the config tree of the snapshot's node.
+    const uint8_t* bytesPtr,        ///< [IN] The snapshot's bytes.
+    size_t numBytes                 ///< [IN] Number of bytes.
+)
+{
+    uint8_t* copyPtr = NULL;
+
+    if (numBytes > 0)
+    {
+        copyPtr = malloc(numBytes);
+        LE_ASSERT(copyPtr != NULL);
+
+        memcpy(copyPtr, bytesPtr, numBytes);
+    }
+
+    return CreateSnapshot(pathPtr, copyPtr, numBytes);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a reference to a snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+void cfgSnapshot_AddRef
+(
+    cfgSnapshot_Ref_t snapshotRef   ///< [IN] The snapshot.
+)
+{
+    le_mem_AddRef(snapshotRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a reference to a snapshot.  The snapshot is deleted when its last reference is released.
+ */
+//--------------------------------------------------------------------------------------------------
+void cfgSnapshot_Release
+(
+    cfgSnapshot_Ref_t snapshotRef   ///< [IN] The snapshot.
+)
+{
+    le_mem_Release(snapshotRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an iterator over a snapshot.  The iterator holds a reference to the snapshot until it is
+ * deleted.
+ *
+ * @return
+ *      Reference to the iterator.
+ */
+//--------------------------------------------------------------------------------------------------
+cfgSnapshot_IteratorRef_t cfgSnapshot_CreateIterator
+(
+    cfgSnapshot_Ref_t snapshotRef,  ///< [IN] The snapshot.
+    const char* pathPtr             ///< [IN] Path of the iterator's initial node.  Relative paths
+                                    ///       are relative to the snapshot's node.
+)
+{
+    Iterator_t* iterPtr = le_mem_ForceAlloc(IteratorPool);
+
+    le_mem_AddRef(snapshotRef);
+    iterPtr->snapshotPtr = snapshotRef;
+
+    GoToRoot(snapshotRef, &iterPtr->pos);
+    FollowPath(snapshotRef, &iterPtr->pos, pathPtr);
+
+    return iterPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an iterator.
+ */
+//--------------------------------------------------------------------------------------------------
+void cfgSnapshot_DeleteIterator
+(
+    cfgSnapshot_IteratorRef_t iterRef   ///< [IN] The iterator.
+)
+{
+    le_mem_Release(iterRef->snapshotPtr);
+    le_mem_Release(iterRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the iterator to another node, which doesn't have to exist, like le_cfg_GoToNode().
+ */
+//--------------------------------------------------------------------------------------------------
+void cfgSnapshot_GoToNode
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr                 ///< [IN] Absolute or relative path to the node.
+)
+{
+    FollowPath(iterRef->snapshotPtr, &iterRef->pos, pathPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the iterator to the parent of its current node.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the iterator is at the snapshot's node.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgSnapshot_GoToParent
+(
+    cfgSnapshot_IteratorRef_t iterRef   ///< [IN] The iterator.
+)
+{
+    Position_t* posPtr = &iterRef->pos;
+
+    if (posPtr->depth == 0)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    posPtr->depth--;
+    posPtr->path[posPtr->pathLens[posPtr->depth]] = '\0';
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the iterator to the first child of its current node.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the node has no children.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgSnapshot_GoToFirstChild
+(
+    cfgSnapshot_IteratorRef_t iterRef   ///< [IN] The iterator.
+)
+{
+    const Snapshot_t* snapshotPtr = iterRef->snapshotPtr;
+    Position_t* posPtr = &iterRef->pos;
+    size_t offset = posPtr->offsets[posPtr->depth];
+
+    if (GetType(snapshotPtr, offset) != LE_CFG_TYPE_STEM)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    size_t childOffset = GetChildrenOffset(snapshotPtr, offset);
+
+    if (childOffset >= GetEndOffset(snapshotPtr, offset))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    LE_FATAL_IF(posPtr->depth >= MAX_DEPTH, "Config path '%s' is too deep.", posPtr->path);
+
+    AppendToPath(posPtr,
+                 (const char*)snapshotPtr->bytesPtr + childOffset + NODE_HEADER_BYTES,
+                 snapshotPtr->bytesPtr[childOffset + 1]);
+    posPtr->offsets[posPtr->depth] = childOffset;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the iterator to the next sibling of its current node.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the node is the last of its siblings.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgSnapshot_GoToNextSibling
+(
+    cfgSnapshot_IteratorRef_t iterRef   ///< [IN] The iterator.
+)
+{
+    const Snapshot_t* snapshotPtr = iterRef->snapshotPtr;
+    Position_t* posPtr = &iterRef->pos;
+    size_t offset = posPtr->offsets[posPtr->depth];
+
+    if ((posPtr->depth == 0) || (offset == NO_NODE))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    size_t siblingOffset = GetEndOffset(snapshotPtr, offset);
+
+    if (siblingOffset >= GetEndOffset(snapshotPtr, posPtr->offsets[posPtr->depth - 1]))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    posPtr->depth--;
+    AppendToPath(posPtr,
+                 (const char*)snapshotPtr->bytesPtr + siblingOffset + NODE_HEADER_BYTES,
+                 snapshotPtr->bytesPtr[siblingOffset + 1]);
+    posPtr->offsets[posPtr->depth] = siblingOffset;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the absolute path of a node, like le_cfg_GetPath().
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the buffer is too small.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgSnapshot_GetPath
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr,                ///< [IN] Path to the node, relative to the iterator's
+                                        ///       current node.  Can be empty.
+    char* bufPtr,                       ///< [OUT] Buffer for the path.
+    size_t bufSize                      ///< [IN] Size of the buffer.
+)
+{
+    if (pathPtr[0] == '\0')
+    {
+        return le_utf8_Copy(bufPtr, iterRef->pos.path, bufSize, NULL);
+    }
+
+    Position_t pos = iterRef->pos;
+
+    FollowPath(iterRef->snapshotPtr, &pos, pathPtr);
+
+    return le_utf8_Copy(bufPtr, pos.path, bufSize, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of a node, like le_cfg_GetNodeType().
+ *
+ * @return
+ *      The type of the node, or LE_CFG_TYPE_DOESNT_EXIST if the node doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_nodeType_t cfgSnapshot_GetNodeType
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr                 ///< [IN] Path to the node.  Can be empty.
+)
+{
+    return GetType(iterRef->snapshotPtr, FindNode(iterRef, pathPtr));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the name of a node, like le_cfg_GetNodeName().
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the buffer is too small.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgSnapshot_GetNodeName
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr,                ///< [IN] Path to the node.  Can be empty.
+    char* bufPtr,                       ///< [OUT] Buffer for the name.
+    size_t bufSize                      ///< [IN] Size of the buffer.
+)
+{
+    Position_t pos = iterRef->pos;
+
+    FollowPath(iterRef->snapshotPtr, &pos, pathPtr);
+
+    return le_utf8_Copy(bufPtr, le_path_GetBasenamePtr(pos.path, "/"), bufSize, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a node exists.
+ *
+ * @return
+ *      true if the node exists.
+ */
+//--------------------------------------------------------------------------------------------------
+bool cfgSnapshot_NodeExists
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr                 ///< [IN] Path to the node.  Can be empty.
+)
+{
+    return (FindNode(iterRef, pathPtr) != NO_NODE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a node is empty or doesn't exist, like le_cfg_IsEmpty().
+ *
+ * @return
+ *      true if the node is empty or doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+bool cfgSnapshot_IsEmpty
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr                 ///< [IN] Path to the node.  Can be empty.
+)
+{
+    le_cfg_nodeType_t type = cfgSnapshot_GetNodeType(iterRef, pathPtr);
+
+    return ((type == LE_CFG_TYPE_EMPTY) || (type == LE_CFG_TYPE_DOESNT_EXIST));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a value as a string, like le_cfg_GetString().
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the buffer is too small.  The truncated string is still copied.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgSnapshot_GetString
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr,                ///< [IN] Path to the node.  Can be empty.
+    char* bufPtr,                       ///< [OUT] Buffer for the value.
+    size_t bufSize,                     ///< [IN] Size of the buffer.
+    const char* defaultPtr              ///< [IN] Value to use if the node has no value.
+)
+{
+    size_t offset = FindNode(iterRef, pathPtr);
+
+    switch (GetType(iterRef->snapshotPtr, offset))
+    {
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_BOOL:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+            return CopyValue(iterRef->snapshotPtr, offset, bufPtr, bufSize);
+
+        default:
+            return le_utf8_Copy(bufPtr, defaultPtr, bufSize, NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an integer value, like le_cfg_GetInt().  Floating point values are rounded.
+ *
+ * @return
+ *      The value, or the default value if the node doesn't hold a number.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t cfgSnapshot_GetInt
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr,                ///< [IN] Path to the node.  Can be empty.
+    int32_t defaultValue                ///< [IN] Value to use if the node doesn't hold a number.
+)
+{
+    size_t offset = FindNode(iterRef, pathPtr);
+    char number[NUMBER_BYTES];
+
+    switch (GetType(iterRef->snapshotPtr, offset))
+    {
+        case LE_CFG_TYPE_INT:
+            CopyValue(iterRef->snapshotPtr, offset, number, sizeof(number));
+            return atoi(number);
+
+        case LE_CFG_TYPE_FLOAT:
+        {
+            CopyValue(iterRef->snapshotPtr, offset, number, sizeof(number));
+
+            double value = atof(number);
+
+            return (int32_t)(value >= 0.0 ? value + 0.5 : value - 0.5);
+        }
+
+        default:
+            return defaultValue;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a boolean value, like le_cfg_GetBool().
+ *
+ * @return
+ *      The value, or the default value if the node doesn't hold a boolean.
+ */
+//--------------------------------------------------------------------------------------------------
+bool cfgSnapshot_GetBool
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr,                ///< [IN] Path to the node.  Can be empty.
+    bool defaultValue                   ///< [IN] Value to use if the node doesn't hold a boolean.
+)
+{
+    size_t offset = FindNode(iterRef, pathPtr);
+    char value[NUMBER_BYTES];
+
+    if (GetType(iterRef->snapshotPtr, offset) != LE_CFG_TYPE_BOOL)
+    {
+        return defaultValue;
+    }
+
+    CopyValue(iterRef->snapshotPtr, offset, value, sizeof(value));
+
+    return (strcmp(value, "f") != 0);
+}
@@ -0,0 +1,328 @@
+//--------------------------------------------------------------------------------------------------
+/** @file supervisor/cfgSnapshot.h
+ *
+ * API for reading a whole subtree of the config tree at once, and then reading its values locally.
+ *
+ * Starting an app reads dozens of values from its config, and reading them one at a time with the
+ * le_cfg API costs a message to the Config Tree for each of them.  Instead, a snapshot of the app's
+ * config is read with le_cfg_GetSnapshot() in one message (or a few, for large configs) and the
+ * values are read from the snapshot with an iterator that works like a le_cfg iterator.
+ *
+ * A snapshot doesn't see changes made to the config tree after it was read, so snapshots should
+ * only be kept for as long as the config would have been read with a single transaction.
+ *
+ * Paths given to this API can be absolute or relative, but can't lead outside of the snapshot's
+ * node.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef LEGATO_SRC_CFG_SNAPSHOT_INCLUDE_GUARD
+#define LEGATO_SRC_CFG_SNAPSHOT_INCLUDE_GUARD
+
+#include "le_cfg_interface.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a snapshot of a subtree of the config tree.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct cfgSnapshot_Snapshot* cfgSnapshot_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to an iterator over a snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct cfgSnapshot_Iterator* cfgSnapshot_IteratorRef_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the config snapshot subsystem.  Must be called before any other function of this API.
+ */
+//--------------------------------------------------------------------------------------------------
+void cfgSnapshot_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a node of the config tree and everything below it.  If the node doesn't exist, an empty
+ * snapshot is returned, in which every read returns its default value, as it would from the config
+ * tree.
+ *
+ * @note This function does not return on error.
+ *
+ * @return
+ *      Reference to the snapshot.  Must be released with cfgSnapshot_Release().
+ */
+//--------------------------------------------------------------------------------------------------
+cfgSnapshot_Ref_t cfgSnapshot_Read
+(
+    const char* pathPtr             ///< [IN] Path of the node in the config tree.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a snapshot from bytes in the format returned by le_cfg_GetSnapshot().
+ *
+ * @return
+ *      Reference to the snapshot, or NULL if the bytes are not a valid snapshot.  Must be released
+ *      with cfgSnapshot_Release().
+ */
+//--------------------------------------------------------------------------------------------------
+cfgSnapshot_Ref_t cfgSnapshot_Create
+(
+    const char* pathPtr,            ///< [IN] Path in the config tree of the snapshot's node.
+    const uint8_t* bytesPtr,        ///< [IN] The snapshot's bytes.
+    size_t numBytes                 ///< [IN] Number of bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a reference to a snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+void cfgSnapshot_AddRef
+(
+    cfgSnapshot_Ref_t snapshotRef   ///< [IN] The snapshot.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a reference to a snapshot.  The snapshot is deleted when its last reference is released.
+ */
+//--------------------------------------------------------------------------------------------------
+void cfgSnapshot_Release
+(
+    cfgSnapshot_Ref_t snapshotRef   ///< [IN] The snapshot.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an iterator over a snapshot.  The iterator holds a reference to the snapshot until it is
+ * deleted.
+ *
+ * @return
+ *      Reference to the iterator.
+ */
+//--------------------------------------------------------------------------------------------------
+cfgSnapshot_IteratorRef_t cfgSnapshot_CreateIterator
+(
+    cfgSnapshot_Ref_t snapshotRef,  ///< [IN] The snapshot.
+    const char* pathPtr             ///< [IN] Path of the iterator's initial node.  Relative paths
+                                    ///       are relative to the snapshot's node.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an iterator.
+ */
+//--------------------------------------------------------------------------------------------------
+void cfgSnapshot_DeleteIterator
+(
+    cfgSnapshot_IteratorRef_t iterRef   ///< [IN] The iterator.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the iterator to another node, which doesn't have to exist, like le_cfg_GoToNode().
+ */
+//--------------------------------------------------------------------------------------------------
+void cfgSnapshot_GoToNode
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr                 ///< [IN] Absolute or relative path to the node.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the iterator to the parent of its current node.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the iterator is at the snapshot's node.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgSnapshot_GoToParent
+(
+    cfgSnapshot_IteratorRef_t iterRef   ///< [IN] The iterator.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the iterator to the first child of its current node.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the node has no children.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgSnapshot_GoToFirstChild
+(
+    cfgSnapshot_IteratorRef_t iterRef   ///< [IN] The iterator.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the iterator to the next sibling of its current node.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the node is the last of its siblings.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgSnapshot_GoToNextSibling
+(
+    cfgSnapshot_IteratorRef_t iterRef   ///< [IN] The iterator.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the absolute path of a node, like le_cfg_GetPath().
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the buffer is too small.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgSnapshot_GetPath
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr,                ///< [IN] Path to the node, relative to the iterator's
+                                        ///       current node.  Can be empty.
+    char* bufPtr,                       ///< [OUT] Buffer for the path.
+    size_t bufSize                      ///< [IN] Size of the buffer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of a node, like le_cfg_GetNodeType().
+ *
+ * @return
+ *      The type of the node, or LE_CFG_TYPE_DOESNT_EXIST if the node doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_nodeType_t cfgSnapshot_GetNodeType
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr                 ///< [IN] Path to the node.  Can be empty.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the name of a node, like le_cfg_GetNodeName().
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the buffer is too small.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgSnapshot_GetNodeName
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr,                ///< [IN] Path to the node.  Can be empty.
+    char* bufPtr,                       ///< [OUT] Buffer for the name.
+    size_t bufSize                      ///< [IN] Size of the buffer.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a node exists.
+ *
+ * @return
+ *      true if the node exists.
+ */
+//--------------------------------------------------------------------------------------------------
+bool cfgSnapshot_NodeExists
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr                 ///< [IN] Path to the node.  Can be empty.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a node is empty or doesn't exist, like le_cfg_IsEmpty().
+ *
+ * @return
+ *      true if the node is empty or doesn't exist.
+ */
+//--------------------------------------------------------------------------------------------------
+bool cfgSnapshot_IsEmpty
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr                 ///< [IN] Path to the node.  Can be empty.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a value as a string, like le_cfg_GetString().
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the buffer is too small.  The truncated string is still copied.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cfgSnapshot_GetString
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr,                ///< [IN] Path to the node.  Can be empty.
+    char* bufPtr,                       ///< [OUT] Buffer for the value.
+    size_t bufSize,                     ///< [IN] Size of the buffer.
+    const char* defaultPtr              ///< [IN] Value to use if the node has no value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an integer value, like le_cfg_GetInt().  Floating point values are rounded.
+ *
+ * @return
+ *      The value, or the default value if the node doesn't hold a number.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t cfgSnapshot_GetInt
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr,                ///< [IN] Path to the node.  Can be empty.
+    int32_t defaultValue                ///< [IN] Value to use if the node doesn't hold a number.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a boolean value, like le_cfg_GetBool().
+ *
+ * @return
+ *      The value, or the default value if the node doesn't hold a boolean.
+ */
+//--------------------------------------------------------------------------------------------------
+bool cfgSnapshot_GetBool
+(
+    cfgSnapshot_IteratorRef_t iterRef,  ///< [IN] The iterator.
+    const char* pathPtr,                ///< [IN] Path to the node.  Can be empty.
+    bool defaultValue                   ///< [IN] Value to use if the node doesn't hold a boolean.
+);
+
+
+#endif  // LEGATO_SRC_CFG_SNAPSHOT_INCLUDE_GUARD
@@ -15,6 +15,7 @@
 #include "proc.h"
 #include "limit.h"
 #include "le_cfg_interface.h"
+#include "cfgSnapshot.h"
 #include "resourceLimits.h"
 #include "fileDescriptor.h"
 #include "user.h"
@@ -506,7 +507,9 @@ le_result_t SetProcPriority
 //--------------------------------------------------------------------------------------------------
 static void SetSchedulingPriority
 (
-    proc_Ref_t procRef      ///< [IN] The process to set the priority for.
+    proc_Ref_t procRef,             ///< [IN] The process to set the priority for.
+    cfgSnapshot_Ref_t cfgSnapshot   ///< [IN] Snapshot of the app's config, or NULL if the process
+                                    ///       has no config.
 )
 {
     char priorStr[LIMIT_MAX_PRIORITY_NAME_BYTES] = "medium";
@@ -519,16 +522,18 @@ static void SetSchedulingPriority
     else if (procRef->cfgPathPtr != NULL)
     {
         // Read the priority setting from the config tree.
-        le_cfg_IteratorRef_t procCfg = le_cfg_CreateReadTxn(procRef->cfgPathPtr);
+        cfgSnapshot_IteratorRef_t procCfg = cfgSnapshot_CreateIterator(cfgSnapshot,
+                                                                     procRef->cfgPathPtr);
 
-        if (le_cfg_GetString(procCfg, CFG_NODE_PRIORITY, priorStr, sizeof(priorStr), "medium") != LE_OK)
+        if (cfgSnapshot_GetString(procCfg, CFG_NODE_PRIORITY, priorStr, sizeof(priorStr),
+                                  "medium") != LE_OK)
         {
             LE_CRIT("Priority string for process %s is too long.  Using default priority.", procRef->namePtr);
 
             LE_ASSERT(le_utf8_Copy(priorStr, "medium", sizeof(priorStr), NULL) == LE_OK);
         }
 
-        le_cfg_CancelTxn(procCfg);
+        cfgSnapshot_DeleteIterator(procCfg);
     }
 
     if (SetProcPriority(priorStrPtr, procRef->pid) != LE_OK)
@@ -549,48 +554,53 @@ static void SetSchedulingPriority
 //--------------------------------------------------------------------------------------------------
 static le_result_t GetEnvironmentVariables
 (
-    proc_Ref_t procRef,     ///< [IN] The process to get the environment variables for.
-    EnvVar_t envVars[],     ///< [IN] The list of environment variables.
-    size_t maxNumEnvVars    ///< [IN] The maximum number of items envVars can hold.
+    proc_Ref_t procRef,             ///< [IN] The process to get the environment variables for.
+    cfgSnapshot_Ref_t cfgSnapshot,  ///< [IN] Snapshot of the app's config, or NULL if the process
+                                    ///       has no config.
+    EnvVar_t envVars[],             ///< [IN] The list of environment variables.
+    size_t maxNumEnvVars            ///< [IN] The maximum number of items envVars can hold.
 )
 {
     int numEnvVars = 0;
 
     if (procRef->cfgPathPtr != NULL)
     {
-        le_cfg_IteratorRef_t procCfg = le_cfg_CreateReadTxn(procRef->cfgPathPtr);
-        le_cfg_GoToNode(procCfg, CFG_NODE_ENV_VARS);
+        cfgSnapshot_IteratorRef_t procCfg = cfgSnapshot_CreateIterator(cfgSnapshot,
+                                                                     procRef->cfgPathPtr);
+        cfgSnapshot_GoToNode(procCfg, CFG_NODE_ENV_VARS);
 
-        if (le_cfg_GoToFirstChild(procCfg) != LE_OK)
+        if (cfgSnapshot_GoToFirstChild(procCfg) != LE_OK)
         {
             LE_WARN("No environment variables for process '%s'.", procRef->namePtr);
 
-            le_cfg_CancelTxn(procCfg);
+            cfgSnapshot_DeleteIterator(procCfg);
             return 0;
         }
 
         int i = 0;
         for (i = 0; i < maxNumEnvVars; i++)
         {
-            if ( (le_cfg_GetNodeName(procCfg, "", envVars[i].name, LIMIT_MAX_ENV_VAR_NAME_BYTES) != LE_OK) ||
-                 (le_cfg_GetString(procCfg, "", envVars[i].value, LIMIT_MAX_PATH_BYTES, "") != LE_OK) )
+            if ( (cfgSnapshot_GetNodeName(procCfg, "", envVars[i].name,
+                                          LIMIT_MAX_ENV_VAR_NAME_BYTES) != LE_OK) ||
+                 (cfgSnapshot_GetString(procCfg, "", envVars[i].value,
+                                        LIMIT_MAX_PATH_BYTES, "") != LE_OK) )
             {
-                le_cfg_CancelTxn(procCfg);
+                cfgSnapshot_DeleteIterator(procCfg);
                 goto errorReading;
             }
 
-            if (le_cfg_GoToNextSibling(procCfg) != LE_OK)
+            if (cfgSnapshot_GoToNextSibling(procCfg) != LE_OK)
             {
                 break;
             }
             else if (i >= maxNumEnvVars-1)
             {
-                le_cfg_CancelTxn(procCfg);
+                cfgSnapshot_DeleteIterator(procCfg);
                 goto errorReading;
             }
         }
 
-        le_cfg_CancelTxn(procCfg);
+        cfgSnapshot_DeleteIterator(procCfg);
 
         numEnvVars = i + 1;
     }
@@ -689,6 +699,8 @@ static void SetEnvironmentVariables
 static le_result_t GetArgs
 (
     proc_Ref_t procRef,             ///< [IN] The process to get the args for.
+    cfgSnapshot_Ref_t cfgSnapshot,  ///< [IN] Snapshot of the app's config, or NULL if the process
+                                    ///       has no config.
     char argsBuffers[LIMIT_MAX_NUM_CMD_LINE_ARGS][LIMIT_MAX_ARGS_STR_BYTES], ///< [OUT] A pointer to
                                                                              /// an array of buffers
                                                                              /// used to store
@@ -730,27 +742,28 @@ static le_result_t GetArgs
     if (procRef->cfgPathPtr != NULL)
     {
         // Get a config iterator to the arguments list.
-        le_cfg_IteratorRef_t procCfg = le_cfg_CreateReadTxn(procRef->cfgPathPtr);
-        le_cfg_GoToNode(procCfg, CFG_NODE_ARGS);
+        cfgSnapshot_IteratorRef_t procCfg = cfgSnapshot_CreateIterator(cfgSnapshot,
+                                                                     procRef->cfgPathPtr);
+        cfgSnapshot_GoToNode(procCfg, CFG_NODE_ARGS);
 
-        if (le_cfg_GoToFirstChild(procCfg) != LE_OK)
+        if (cfgSnapshot_GoToFirstChild(procCfg) != LE_OK)
         {
             LE_ERROR("No arguments for process '%s'.", procRef->namePtr);
-            le_cfg_CancelTxn(procCfg);
+            cfgSnapshot_DeleteIterator(procCfg);
             return LE_FAULT;
         }
 
         // Record the executable path.
         if (procRef->execPathPtr == NULL)
         {
-            if (le_cfg_GetString(procCfg, "", argsBuffers[bufIndex],
-                                 LIMIT_MAX_ARGS_STR_BYTES, "") != LE_OK)
+            if (cfgSnapshot_GetString(procCfg, "", argsBuffers[bufIndex],
+                                      LIMIT_MAX_ARGS_STR_BYTES, "") != LE_OK)
             {
                 LE_ERROR("Error reading argument '%s...' for process '%s'.",
                          argsBuffers[bufIndex],
                          procRef->namePtr);
 
-                le_cfg_CancelTxn(procCfg);
+                cfgSnapshot_DeleteIterator(procCfg);
                 return LE_FAULT;
             }
 
@@ -765,33 +778,33 @@ static le_result_t GetArgs
 
             while(1)
             {
-                if (le_cfg_GoToNextSibling(procCfg) != LE_OK)
+                if (cfgSnapshot_GoToNextSibling(procCfg) != LE_OK)
                 {
                     break;
                 }
                 else if (bufIndex >= LIMIT_MAX_NUM_CMD_LINE_ARGS)
                 {
                     LE_ERROR("Too many arguments for process '%s'.", procRef->namePtr);
-                    le_cfg_CancelTxn(procCfg);
+                    cfgSnapshot_DeleteIterator(procCfg);
                     return LE_FAULT;
                 }
 
-                if (le_cfg_IsEmpty(procCfg, ""))
+                if (cfgSnapshot_IsEmpty(procCfg, ""))
                 {
                     LE_ERROR("Empty node in argument list for process '%s'.", procRef->namePtr);
 
-                    le_cfg_CancelTxn(procCfg);
+                    cfgSnapshot_DeleteIterator(procCfg);
                     return LE_FAULT;
                 }
 
-                if (le_cfg_GetString(procCfg, "", argsBuffers[bufIndex],
-                                     LIMIT_MAX_ARGS_STR_BYTES, "") != LE_OK)
+                if (cfgSnapshot_GetString(procCfg, "", argsBuffers[bufIndex],
+                                          LIMIT_MAX_ARGS_STR_BYTES, "") != LE_OK)
                 {
                     LE_ERROR("Argument too long '%s...' for process '%s'.",
                              argsBuffers[bufIndex],
                              procRef->namePtr);
 
-                    le_cfg_CancelTxn(procCfg);
+                    cfgSnapshot_DeleteIterator(procCfg);
                     return LE_FAULT;
                 }
 
@@ -802,7 +815,7 @@ static le_result_t GetArgs
             }
         }
 
-        le_cfg_CancelTxn(procCfg);
+        cfgSnapshot_DeleteIterator(procCfg);
     }
 
     // Terminate the list.
@@ -1050,6 +1063,23 @@ static void BlockOnPipe
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases a config snapshot, if there is one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseCfgSnapshot
+(
+    cfgSnapshot_Ref_t cfgSnapshot   ///< [IN] The snapshot, or NULL.
+)
+{
+    if (cfgSnapshot != NULL)
+    {
+        cfgSnapshot_Release(cfgSnapshot);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Starts a process.  If the process belongs to a sandboxed app the process will run in its sandbox,
@@ -1101,14 +1131,25 @@ le_result_t proc_Start
     // @Note The current IPC system does not support forking so any reads to the config DB must be
     //       done in the parent process.
 
+    // Get a snapshot of the app's config, so that the process's settings are not each read with
+    // a separate request to the config tree.
+    cfgSnapshot_Ref_t cfgSnapshot = NULL;
+
+    if (procRef->cfgPathPtr != NULL)
+    {
+        cfgSnapshot = app_GetConfigSnapshot(procRef->appRef);
+    }
+
     // Get the environment variables from the config tree for this process.
     EnvVar_t envVars[LIMIT_MAX_NUM_ENV_VARS] = {{{ 0 }}};
-    int numEnvVars = GetEnvironmentVariables(procRef, envVars, LIMIT_MAX_NUM_ENV_VARS);
+    int numEnvVars = GetEnvironmentVariables(procRef, cfgSnapshot, envVars,
+                                             LIMIT_MAX_NUM_ENV_VARS);
 
     if (numEnvVars == LE_FAULT)
     {
         LE_ERROR("Error getting environment variables.  Process '%s' cannot be started.",
                  procRef->namePtr);
+        ReleaseCfgSnapshot(cfgSnapshot);
         return LE_FAULT;
     }
 
@@ -1116,10 +1157,11 @@ le_result_t proc_Start
     char argsBuffers[LIMIT_MAX_NUM_CMD_LINE_ARGS][LIMIT_MAX_ARGS_STR_BYTES];
     char* argsPtr[NUM_ARGS_PTRS];
 
-    if (GetArgs(procRef, argsBuffers, argsPtr) != LE_OK)
+    if (GetArgs(procRef, cfgSnapshot, argsBuffers, argsPtr) != LE_OK)
     {
         LE_ERROR("Could not get command line arguments, process '%s' cannot be started.",
                  procRef->namePtr);
+        ReleaseCfgSnapshot(cfgSnapshot);
         return LE_FAULT;
     }
 
@@ -1135,6 +1177,7 @@ le_result_t proc_Start
     if (pID < 0)
     {
         LE_EMERG("Failed to fork.  %m.");
+        ReleaseCfgSnapshot(cfgSnapshot);
         return LE_FAULT;
     }
 
@@ -1222,20 +1265,22 @@ le_result_t proc_Start
     fd_Close(syncPipeFd[READ_PIPE]);
 
     // Set the scheduling priority for the child process while the child process is blocked.
-    SetSchedulingPriority(procRef);
+    SetSchedulingPriority(procRef, cfgSnapshot);
 
     // Send standard pipes to the log daemon so they will show up in the logs.
     SendStdPipeToLogDaemon(procRef, logStdErrPipe, STDERR_FILENO);
     SendStdPipeToLogDaemon(procRef, logStdOutPipe, STDOUT_FILENO);
 
     // Set the resource limits for the child process while the child process is blocked.
-    if (resLim_SetProcLimits(procRef) != LE_OK)
+    if (resLim_SetProcLimits(procRef, cfgSnapshot) != LE_OK)
     {
         LE_ERROR("Could not set the resource limits.  %m.");
 
         kill_Hard(procRef->pid);
     }
 
+    ReleaseCfgSnapshot(cfgSnapshot);
+
     LE_INFO("Starting process '%s' with pid %d", procRef->namePtr, procRef->pid);
 
     // Unblock the child process.
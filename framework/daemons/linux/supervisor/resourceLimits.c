@@ -172,16 +172,16 @@
 //--------------------------------------------------------------------------------------------------
 static int GetCfgResourceLimit
 (
-    le_cfg_IteratorRef_t limitCfg,  // The iterator to use to read the configured limit.  This
+    cfgSnapshot_IteratorRef_t limitCfg, // The iterator to use to read the configured limit.  This
                                     // iterator is owned by the caller and should not be deleted
                                     // in this function.
     const char* nodeName,           // The name of the node in the config tree that holds the value.
     int defaultValue                // The default value to use if the config value is invalid.
 )
 {
-    int limitValue = le_cfg_GetInt(limitCfg, nodeName, defaultValue);
+    int limitValue = cfgSnapshot_GetInt(limitCfg, nodeName, defaultValue);
 
-    if (!le_cfg_NodeExists(limitCfg, nodeName))
+    if (!cfgSnapshot_NodeExists(limitCfg, nodeName))
     {
         LE_INFO("Configured resource limit %s is not available.  Using the default value %d.",
                  nodeName, defaultValue);
@@ -189,7 +189,7 @@ static int GetCfgResourceLimit
         return defaultValue;
     }
 
-    if (le_cfg_IsEmpty(limitCfg, nodeName))
+    if (cfgSnapshot_IsEmpty(limitCfg, nodeName))
     {
         LE_WARN("Configured resource limit %s is empty.  Using the default value %d.",
                  nodeName, defaultValue);
@@ -197,7 +197,7 @@ static int GetCfgResourceLimit
         return defaultValue;
     }
 
-    if (le_cfg_GetNodeType(limitCfg, nodeName) != LE_CFG_TYPE_INT)
+    if (cfgSnapshot_GetNodeType(limitCfg, nodeName) != LE_CFG_TYPE_INT)
     {
         LE_ERROR("Configured resource limit %s is the wrong type.  Using the default value %d.",
                  nodeName, defaultValue);
@@ -231,7 +231,9 @@ rlim_t resLim_GetSandboxedAppTmpfsLimit
 )
 {
     // Create a config iterator to get the file system limit from the config tree.
-    le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(app_GetConfigPath(appRef));
+    cfgSnapshot_Ref_t appSnapshot = app_GetConfigSnapshot(appRef);
+    cfgSnapshot_IteratorRef_t appCfg = cfgSnapshot_CreateIterator(appSnapshot, "");
+    cfgSnapshot_Release(appSnapshot);
 
     // Get the resource limit from the config tree.
     int fileSysLimit = GetCfgResourceLimit(appCfg,
@@ -248,7 +250,7 @@ rlim_t resLim_GetSandboxedAppTmpfsLimit
         fileSysLimit = DEFAULT_LIMIT_MAX_FILE_SYSTEM_BYTES;
     }
 
-    le_cfg_CancelTxn(appCfg);
+    cfgSnapshot_DeleteIterator(appCfg);
 
     return (rlim_t)fileSysLimit;
 }
@@ -293,7 +295,7 @@ maximum allowed value.", resourceName, MAX_LIMIT_FILE_DESCRIPTORS);
 static void SetRLimit
 (
     pid_t pid,                      // The pid of the process to set the limit for.
-    le_cfg_IteratorRef_t procCfg,   // The iterator for the process.  This iterator is owned by
+    cfgSnapshot_IteratorRef_t procCfg,  // The iterator for the process.  This iterator is owned by
                                     // the caller and should not be deleted in this function.
     const char* resourceName,       // The resource name in the config tree.
     int resourceID,                 // The resource ID that setrlimit() expects.
@@ -350,7 +352,9 @@ le_result_t resLim_SetAppLimits
     }
 
     // Create a config iterator for this app.
-    le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(app_GetConfigPath(appRef));
+    cfgSnapshot_Ref_t appSnapshot = app_GetConfigSnapshot(appRef);
+    cfgSnapshot_IteratorRef_t appCfg = cfgSnapshot_CreateIterator(appSnapshot, "");
+    cfgSnapshot_Release(appSnapshot);
 
     // Get the cpu share value from the config.
     int cpuShare = GetCfgResourceLimit(appCfg, CFG_NODE_LIMIT_CPU_SHARE, DEFAULT_LIMIT_CPU_SHARE);
@@ -358,7 +362,7 @@ le_result_t resLim_SetAppLimits
     // Set the cpu limit.
     if (cgrp_cpu_SetShare(appNamePtr, cpuShare) != LE_OK)
     {
-        le_cfg_CancelTxn(appCfg);
+        cfgSnapshot_DeleteIterator(appCfg);
         return LE_FAULT;
     }
 
@@ -369,11 +373,11 @@ le_result_t resLim_SetAppLimits
 
     if (cgrp_mem_SetLimit(appNamePtr, maxMemoryBytes / 1024) != LE_OK)
     {
-        le_cfg_CancelTxn(appCfg);
+        cfgSnapshot_DeleteIterator(appCfg);
         return LE_FAULT;
     }
 
-    le_cfg_CancelTxn(appCfg);
+    cfgSnapshot_DeleteIterator(appCfg);
     return LE_OK;
 }
 
@@ -390,7 +394,9 @@ le_result_t resLim_SetAppLimits
 //--------------------------------------------------------------------------------------------------
 le_result_t resLim_SetProcLimits
 (
-    proc_Ref_t procRef              ///< [IN] The process to set resource limits for.
+    proc_Ref_t procRef,             ///< [IN] The process to set resource limits for.
+    cfgSnapshot_Ref_t appSnapshot   ///< [IN] Snapshot of the process's app's config.  Can be NULL
+                                    ///       if the process has no config.
 )
 {
     pid_t pid = proc_GetPID(procRef);
@@ -398,7 +404,8 @@ le_result_t resLim_SetProcLimits
     // Create an iterator for this process.
     if (proc_GetConfigPath(procRef) != NULL)
     {
-        le_cfg_IteratorRef_t procCfg = le_cfg_CreateReadTxn(proc_GetConfigPath(procRef));
+        cfgSnapshot_IteratorRef_t procCfg = cfgSnapshot_CreateIterator(appSnapshot,
+                                                                       proc_GetConfigPath(procRef));
 
         // Set the process resource limits.
         SetRLimit(pid, procCfg, CFG_NODE_LIMIT_MAX_CORE_DUMP_FILE_BYTES, RLIMIT_CORE,
@@ -419,8 +426,8 @@ le_result_t resLim_SetProcLimits
         //       because Linux rlimits are applied to individual processes.
 
         // Goto the application config path from the process config path.
-        le_cfg_GoToParent(procCfg);
-        le_cfg_GoToParent(procCfg);
+        cfgSnapshot_GoToParent(procCfg);
+        cfgSnapshot_GoToParent(procCfg);
 
         SetRLimit(pid, procCfg, CFG_NODE_LIMIT_MAX_MQUEUE_BYTES, RLIMIT_MSGQUEUE,
                   DEFAULT_LIMIT_MAX_MQUEUE_BYTES);
@@ -431,7 +438,7 @@ le_result_t resLim_SetProcLimits
         SetRLimit(pid, procCfg, CFG_NODE_LIMIT_MAX_QUEUED_SIGNALS, RLIMIT_SIGPENDING,
                   DEFAULT_LIMIT_MAX_QUEUED_SIGNALS);
 
-        le_cfg_CancelTxn(procCfg);
+        cfgSnapshot_DeleteIterator(procCfg);
     }
     else
     {
@@ -54,7 +54,9 @@ le_result_t resLim_SetAppLimits
 //--------------------------------------------------------------------------------------------------
 le_result_t resLim_SetProcLimits
 (
-    proc_Ref_t procRef              ///< [IN] The process to set resource limits for.
+    proc_Ref_t procRef,             ///< [IN] The process to set resource limits for.
+    cfgSnapshot_Ref_t appSnapshot   ///< [IN] Snapshot of the process's app's config.  Can be NULL
+                                    ///       if the process has no config.
 );
 
 
@@ -382,6 +382,31 @@ static void ParseCommandLine
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close stdin (and reopen to /dev/null to be safe).
+ *
+ * This signals to the parent process that all apps have been started.  The parent process will
+ * then exit, allowing whatever launched it to continue if it is blocked.
+ *
+ * We do this after advertising services in case anyone uses a "Try" version of an IPC connection
+ * function to connect to one of these services (which would report that the service is
+ * unavailable if it is not yet advertised).  We do it after app launch to improve start-up time by
+ * preventing other boot time activities from contending with us for resources like CPU and flash
+ * memory bandwidth.  The apps are launched asynchronously, so this is called back by the apps
+ * module once the last app is launched.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseStdin
+(
+    void
+)
+{
+    LE_FATAL_IF(freopen("/dev/null", "r", stdin) == NULL,
+                "Failed to redirect stdin to /dev/null.  %m.");
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Starts all framework daemons and apps.
@@ -434,11 +459,12 @@ static void StartFramework
     {
         // Launch all user apps in the config tree that should be launched on system startup.
         LE_INFO("Auto-starting apps.");
-        apps_AutoStart();
+        apps_AutoStart(CloseStdin);
     }
     else
     {
         LE_INFO("Skipping app auto-start.");
+        CloseStdin();
     }
 }
 
@@ -944,18 +970,6 @@ COMPONENT_INIT
 
     StartFramework();
 
-    // Close stdin (and reopen to /dev/null to be safe).
-    // This signals to the parent process that all apps have been started.
-    // The parent process will then exit, allowing whatever launched it to continue if it is
-    // blocked.
-    // We do this after advertising services in case anyone uses a "Try" version of an
-    // IPC connection function to connect to one of these services (which would report
-    // that the service is unavailable if it is not yet advertised).
-    // We do it after app launch to improve start-up time by preventing other boot time activities
-    // from contending with us for resources like CPU and flash memory bandwidth.
-    LE_FATAL_IF(freopen("/dev/null", "r", stdin) == NULL,
-                "Failed to redirect stdin to /dev/null.  %m.");
-
     // Create or remove the SMACK_DISABLED file, which is used by the init scripts to determine to
     // set SMACK labels or not.
     // Ignore the EROFS in case of Legato is Read-Only
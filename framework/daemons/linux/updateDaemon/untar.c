@@ -0,0 +1,1243 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file untar.c
+ *
+ * In-process extraction of the tarballs in update pack payloads.
+ *
+ * The bytes of a payload are passed in as they are read from the update pack.  They are
+ * decompressed into a small buffer, and the tar entries in that buffer are written straight to
+ * the file system, so the payload is handled in a single pass without a pipe to, or the start of,
+ * a separate tar process.
+ *
+ * Supported entries are regular files, directories, symbolic links and hard links, with GNU long
+ * names and POSIX (pax) path names.  Other entries (devices, FIFOs, etc.) are skipped.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "fileDescriptor.h"
+#include "untar.h"
+
+#include <bzlib.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a tar block.  Headers are one block, and entry data is padded to a whole block.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TAR_BLOCK_SIZE 512
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffer that compressed bytes are decompressed into.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DECOMPRESS_BUFFER_BYTES 32768
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest GNU long name or pax header accepted.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_META_DATA_BYTES 65536
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Offsets and sizes of the fields of a tar header that are used.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HDR_NAME        0
+#define HDR_NAME_SIZE   100
+#define HDR_MODE        100
+#define HDR_MODE_SIZE   8
+#define HDR_SIZE        124
+#define HDR_SIZE_SIZE   12
+#define HDR_CHKSUM      148
+#define HDR_CHKSUM_SIZE 8
+#define HDR_TYPE        156
+#define HDR_LINK        157
+#define HDR_LINK_SIZE   100
+#define HDR_MAGIC       257
+#define HDR_PREFIX      345
+#define HDR_PREFIX_SIZE 155
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * How the tarball is compressed.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    CODEC_UNKNOWN,      ///< Not enough bytes yet to tell.
+    CODEC_NONE,         ///< Not compressed.
+    CODEC_BZIP2         ///< Compressed with bzip2.
+}
+Codec_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * What the next bytes of the tarball are.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    STATE_HEADER,       ///< A header block.
+    STATE_FILE_DATA,    ///< The contents of a regular file.
+    STATE_META_DATA,    ///< A GNU long name or pax header, which applies to the next entry.
+    STATE_SKIP,         ///< Data of an entry that isn't extracted, or padding.
+    STATE_END           ///< Past the end of the archive.  Ignored.
+}
+State_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A directory whose permissions are set when the extraction is finished, because they would
+ * prevent its contents from being extracted.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t link;         ///< Link in the extraction's list of directories.
+    mode_t mode;                ///< Permissions of the directory.
+    char path[PATH_MAX];        ///< Path of the directory.
+}
+DeferredDir_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A tarball extraction.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct untar_Extraction
+{
+    char dirPath[PATH_MAX];             ///< Directory to extract into.
+
+    Codec_t codec;                      ///< How the tarball is compressed.
+    uint8_t magic[3];                   ///< First bytes of the tarball, to detect the codec.
+    size_t magicBytes;                  ///< Number of bytes in magic.
+    bz_stream bzStream;                 ///< bzip2 decompressor.
+    bool bzActive;                      ///< true if bzStream is initialized.
+    bool bzStreamEnded;                 ///< true if a bzip2 stream ended and another may follow.
+    uint8_t outBuf[DECOMPRESS_BUFFER_BYTES]; ///< Decompressed bytes.
+
+    State_t state;                      ///< What the next bytes of the tarball are.
+    uint8_t block[TAR_BLOCK_SIZE];          ///< Header block being received.
+    size_t blockBytes;                  ///< Number of bytes in block.
+    unsigned int zeroBlocks;            ///< Number of zero blocks in a row (two end the archive).
+    uint64_t dataRemaining;             ///< Bytes of the current entry's data left to receive.
+    size_t padRemaining;                ///< Bytes of padding after the current entry's data.
+
+    int fd;                             ///< File being extracted (-1 if none).
+    mode_t fileMode;                    ///< Permissions of the file being extracted.
+
+    char metaType;                      ///< Type of the metadata entry being received.
+    char* metaPtr;                      ///< Metadata being received (NULL if none).
+    size_t metaBytes;                   ///< Number of bytes in metaPtr.
+
+    char longName[PATH_MAX];            ///< Name for the next entry, if not empty.
+    char longLink[PATH_MAX];            ///< Link target for the next entry, if not empty.
+    char path[PATH_MAX];                ///< Path of the current entry in the file system.
+
+    le_sls_List_t deferredDirList;      ///< Directories to set the permissions of at the end.
+}
+Extraction_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pools for extractions and deferred directories.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ExtractionPool;
+static le_mem_PoolRef_t DeferredDirPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse an octal number field, or a GNU base-256 number field, of a tar header.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if the field isn't a number.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseNumber
+(
+    const uint8_t* fieldPtr,    ///< [IN] The field.
+    size_t fieldSize,           ///< [IN] Size of the field.
+    uint64_t* valuePtr          ///< [OUT] The number.
+)
+{
+    uint64_t value = 0;
+    size_t i = 0;
+
+    // Base-256, for sizes too large for octal.  Negative numbers are not valid sizes or modes.
+    if (fieldPtr[0] & 0x80)
+    {
+        if ((fieldPtr[0] & 0x40) || (fieldSize > 9 && fieldPtr[1] != 0))
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        value = fieldPtr[0] & 0x3F;
+        for (i = 1; i < fieldSize; i++)
+        {
+            if (value > (UINT64_MAX >> 8))
+            {
+                return LE_FORMAT_ERROR;
+            }
+            value = (value << 8) | fieldPtr[i];
+        }
+
+        *valuePtr = value;
+        return LE_OK;
+    }
+
+    while ((i < fieldSize) && (fieldPtr[i] == ' '))
+    {
+        i++;
+    }
+
+    for (; (i < fieldSize) && (fieldPtr[i] != ' ') && (fieldPtr[i] != '\0'); i++)
+    {
+        if ((fieldPtr[i] < '0') || (fieldPtr[i] > '7') || (value > (UINT64_MAX >> 3)))
+        {
+            return LE_FORMAT_ERROR;
+        }
+        value = (value << 3) | (fieldPtr[i] - '0');
+    }
+
+    *valuePtr = value;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the checksum of a tar header.
+ *
+ * @return true if the checksum is correct.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsChecksumValid
+(
+    const uint8_t* blockPtr     ///< [IN] The header block.
+)
+{
+    uint64_t expected;
+    unsigned long sum = 0;
+    long signedSum = 0;
+    size_t i;
+
+    if (ParseNumber(blockPtr + HDR_CHKSUM, HDR_CHKSUM_SIZE, &expected) != LE_OK)
+    {
+        return false;
+    }
+
+    // The checksum is computed with the checksum field filled with spaces.  Some old versions of
+    // tar summed signed chars, so accept that too.
+    for (i = 0; i < TAR_BLOCK_SIZE; i++)
+    {
+        uint8_t byte = ((i >= HDR_CHKSUM) && (i < HDR_CHKSUM + HDR_CHKSUM_SIZE)) ? ' ' : blockPtr[i];
+
+        sum += byte;
+        signedSum += (signed char)byte;
+    }
+
+    return (expected == sum) || ((long)expected == signedSum);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a string field of a tar header, which may not be null-terminated.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CopyField
+(
+    char* destPtr,              ///< [OUT] Buffer for the string (at least fieldSize + 1 bytes).
+    const uint8_t* fieldPtr,    ///< [IN] The field.
+    size_t fieldSize            ///< [IN] Size of the field.
+)
+{
+    size_t len = strnlen((const char*)fieldPtr, fieldSize);
+
+    memcpy(destPtr, fieldPtr, len);
+    destPtr[len] = '\0';
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the path in the file system of an entry of the tarball.  Leading slashes are removed, so
+ * that entries are always inside the extraction directory.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if the name is too long or contains "..".
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetEntryPath
+(
+    Extraction_t* extPtr,       ///< [IN] The extraction.
+    const char* namePtr,        ///< [IN] Name of the entry in the tarball.
+    char* pathPtr               ///< [OUT] Path of the entry (PATH_MAX bytes).
+)
+{
+    const char* componentPtr = namePtr;
+
+    while (*namePtr == '/')
+    {
+        namePtr++;
+    }
+
+    // Don't allow entries to escape the extraction directory.
+    while ((componentPtr = strstr(componentPtr, "..")) != NULL)
+    {
+        if (((componentPtr == namePtr) || (componentPtr[-1] == '/')) &&
+            ((componentPtr[2] == '\0') || (componentPtr[2] == '/')))
+        {
+            LE_ERROR("Entry '%s' is outside of the extraction directory.", namePtr);
+            return LE_FORMAT_ERROR;
+        }
+        componentPtr += 2;
+    }
+
+    if (snprintf(pathPtr, PATH_MAX, "%s/%s", extPtr->dirPath, namePtr) >= PATH_MAX)
+    {
+        LE_ERROR("Entry name '%s' is too long.", namePtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    // Remove trailing slashes, which directory names have.
+    size_t len = strlen(pathPtr);
+    while ((len > 1) && (pathPtr[len - 1] == '/'))
+    {
+        pathPtr[--len] = '\0';
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that none of the parent directories of an entry, inside the extraction directory, is a
+ * symbolic link.  Otherwise a symbolic link entry could make later entries land outside of the
+ * extraction directory.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if a parent directory is a symbolic link.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CheckParentDirs
+(
+    Extraction_t* extPtr,       ///< [IN] The extraction.
+    const char* pathPtr         ///< [IN] Path of the entry.
+)
+{
+    char dirPath[PATH_MAX];
+    char* slashPtr;
+    struct stat st;
+
+    LE_ASSERT(le_utf8_Copy(dirPath, pathPtr, sizeof(dirPath), NULL) == LE_OK);
+
+    for (slashPtr = strchr(dirPath + strlen(extPtr->dirPath) + 1, '/');
+         slashPtr != NULL;
+         slashPtr = strchr(slashPtr + 1, '/'))
+    {
+        *slashPtr = '\0';
+
+        if (lstat(dirPath, &st) != 0)
+        {
+            // Anything below a missing directory will be created by the extraction.
+            return LE_OK;
+        }
+        if (S_ISLNK(st.st_mode))
+        {
+            LE_ERROR("Entry '%s' is under symlink '%s'.", pathPtr, dirPath);
+            return LE_FORMAT_ERROR;
+        }
+
+        *slashPtr = '/';
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove whatever is at a path, unless it is a directory, so that an entry can be created there.
+ * Missing parent directories are created.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if the path is under a symbolic link, LE_FAULT
+ *         otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t PrepareEntryPath
+(
+    Extraction_t* extPtr,       ///< [IN] The extraction.
+    const char* pathPtr         ///< [IN] Path of the entry.
+)
+{
+    struct stat st;
+    le_result_t result = CheckParentDirs(extPtr, pathPtr);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    if (lstat(pathPtr, &st) == 0)
+    {
+        if (!S_ISDIR(st.st_mode) && (unlink(pathPtr) != 0))
+        {
+            LE_ERROR("Failed to remove '%s' (%m).", pathPtr);
+            return LE_FAULT;
+        }
+        return LE_OK;
+    }
+
+    // Tarballs normally have directories before their contents, but that isn't required.
+    char dirPath[PATH_MAX];
+    LE_ASSERT(le_utf8_Copy(dirPath, pathPtr, sizeof(dirPath), NULL) == LE_OK);
+    char* slashPtr = strrchr(dirPath, '/');
+
+    if ((slashPtr != NULL) && (slashPtr != dirPath))
+    {
+        *slashPtr = '\0';
+
+        if (le_dir_MakePath(dirPath, S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH) != LE_OK)
+        {
+            LE_ERROR("Failed to create directory '%s'.", dirPath);
+            return LE_FAULT;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a directory entry.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if the entry is invalid, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MakeDir
+(
+    Extraction_t* extPtr,       ///< [IN] The extraction.
+    mode_t mode                 ///< [IN] Permissions of the directory.
+)
+{
+    struct stat st;
+
+    le_result_t result = PrepareEntryPath(extPtr, extPtr->path);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    if ((lstat(extPtr->path, &st) != 0) && (mkdir(extPtr->path, S_IRWXU) != 0))
+    {
+        LE_ERROR("Failed to create directory '%s' (%m).", extPtr->path);
+        return LE_FAULT;
+    }
+
+    // If the directory's permissions would stop its contents from being extracted, set them
+    // when the extraction is finished.
+    if ((mode & (S_IWUSR | S_IXUSR)) != (S_IWUSR | S_IXUSR))
+    {
+        DeferredDir_t* dirPtr = le_mem_ForceAlloc(DeferredDirPool);
+
+        dirPtr->link = LE_SLS_LINK_INIT;
+        dirPtr->mode = mode;
+        LE_ASSERT(le_utf8_Copy(dirPtr->path, extPtr->path, sizeof(dirPtr->path), NULL) == LE_OK);
+
+        // Stack them, so that subdirectories are done before their parents.
+        le_sls_Stack(&extPtr->deferredDirList, &dirPtr->link);
+        return LE_OK;
+    }
+
+    if (chmod(extPtr->path, mode) != 0)
+    {
+        LE_ERROR("Failed to set permissions of '%s' (%m).", extPtr->path);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a regular file entry and open it for writing its contents.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if the entry is invalid, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenFile
+(
+    Extraction_t* extPtr,       ///< [IN] The extraction.
+    mode_t mode                 ///< [IN] Permissions of the file.
+)
+{
+    le_result_t result = PrepareEntryPath(extPtr, extPtr->path);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    extPtr->fd = open(extPtr->path, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC,
+                      S_IRUSR | S_IWUSR);
+    if (extPtr->fd == -1)
+    {
+        LE_ERROR("Failed to create file '%s' (%m).", extPtr->path);
+        return LE_FAULT;
+    }
+
+    extPtr->fileMode = mode;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the permissions of the file being extracted and close it.
+ *
+ * @return LE_OK if successful, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CloseFile
+(
+    Extraction_t* extPtr        ///< [IN] The extraction.
+)
+{
+    le_result_t result = LE_OK;
+
+    // Set the permissions explicitly, as the umask applies when the file is created.
+    if (fchmod(extPtr->fd, extPtr->fileMode) != 0)
+    {
+        LE_ERROR("Failed to set permissions of '%s' (%m).", extPtr->path);
+        result = LE_FAULT;
+    }
+
+    fd_Close(extPtr->fd);
+    extPtr->fd = -1;
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a symbolic link or hard link entry.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if the entry is invalid, LE_FAULT otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MakeLink
+(
+    Extraction_t* extPtr,       ///< [IN] The extraction.
+    bool isHardLink,            ///< [IN] true for a hard link, false for a symbolic link.
+    const char* targetPtr       ///< [IN] Target of the link, as found in the tarball.
+)
+{
+    le_result_t result = PrepareEntryPath(extPtr, extPtr->path);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    if (isHardLink)
+    {
+        // Hard link targets are other entries of the tarball.
+        char targetPath[PATH_MAX];
+
+        result = GetEntryPath(extPtr, targetPtr, targetPath);
+        if (result == LE_OK)
+        {
+            result = CheckParentDirs(extPtr, targetPath);
+        }
+        if (result != LE_OK)
+        {
+            return result;
+        }
+
+        if (link(targetPath, extPtr->path) != 0)
+        {
+            LE_ERROR("Failed to link '%s' to '%s' (%m).", extPtr->path, targetPath);
+            return LE_FAULT;
+        }
+    }
+    else if (symlink(targetPtr, extPtr->path) != 0)
+    {
+        LE_ERROR("Failed to create symlink '%s' (%m).", extPtr->path);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply a received GNU long name or pax header to the next entry.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if it is malformed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ApplyMetaData
+(
+    Extraction_t* extPtr        ///< [IN] The extraction.
+)
+{
+    char* dataPtr = extPtr->metaPtr;
+    size_t size = extPtr->metaBytes;
+
+    if ((extPtr->metaType == 'L') || (extPtr->metaType == 'K'))
+    {
+        char* destPtr = (extPtr->metaType == 'L') ? extPtr->longName : extPtr->longLink;
+        size_t len = strnlen(dataPtr, size);
+
+        if (len >= PATH_MAX)
+        {
+            return LE_FORMAT_ERROR;
+        }
+        memcpy(destPtr, dataPtr, len);
+        destPtr[len] = '\0';
+        return LE_OK;
+    }
+
+    // A pax header is a series of "<length> <key>=<value>\n" records.  Only the path and link
+    // path are needed.
+    while (size > 0)
+    {
+        char* endPtr;
+        unsigned long recordLen = strtoul(dataPtr, &endPtr, 10);
+
+        if ((endPtr == dataPtr) || (*endPtr != ' ') || (recordLen > size) ||
+            (recordLen <= (size_t)(endPtr - dataPtr) + 1) || (dataPtr[recordLen - 1] != '\n'))
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        char* keyPtr = endPtr + 1;
+        char* valuePtr = memchr(keyPtr, '=', dataPtr + recordLen - 1 - keyPtr);
+
+        if (valuePtr != NULL)
+        {
+            size_t keyLen = valuePtr - keyPtr;
+            size_t valueLen = dataPtr + recordLen - 1 - (valuePtr + 1);
+            char* destPtr = NULL;
+
+            valuePtr++;
+
+            if ((keyLen == 4) && (strncmp(keyPtr, "path", 4) == 0))
+            {
+                destPtr = extPtr->longName;
+            }
+            else if ((keyLen == 8) && (strncmp(keyPtr, "linkpath", 8) == 0))
+            {
+                destPtr = extPtr->longLink;
+            }
+
+            if (destPtr != NULL)
+            {
+                if (valueLen >= PATH_MAX)
+                {
+                    return LE_FORMAT_ERROR;
+                }
+                memcpy(destPtr, valuePtr, valueLen);
+                destPtr[valueLen] = '\0';
+            }
+        }
+
+        dataPtr += recordLen;
+        size -= recordLen;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle a complete header block.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if the header is invalid, LE_FAULT if the entry
+ *         couldn't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t HandleHeader
+(
+    Extraction_t* extPtr        ///< [IN] The extraction.
+)
+{
+    const uint8_t* blockPtr = extPtr->block;
+    uint64_t size;
+    uint64_t mode;
+    size_t i;
+
+    // Two zero blocks mark the end of the archive.
+    i = 0;
+    while ((i < TAR_BLOCK_SIZE) && (blockPtr[i] == 0))
+    {
+        i++;
+    }
+    if (i == TAR_BLOCK_SIZE)
+    {
+        extPtr->zeroBlocks++;
+        if (extPtr->zeroBlocks == 2)
+        {
+            extPtr->state = STATE_END;
+        }
+        return LE_OK;
+    }
+    extPtr->zeroBlocks = 0;
+
+    if (!IsChecksumValid(blockPtr))
+    {
+        LE_ERROR("Bad tar header checksum.");
+        return LE_FORMAT_ERROR;
+    }
+
+    if ((ParseNumber(blockPtr + HDR_SIZE, HDR_SIZE_SIZE, &size) != LE_OK) ||
+        (ParseNumber(blockPtr + HDR_MODE, HDR_MODE_SIZE, &mode) != LE_OK))
+    {
+        LE_ERROR("Bad tar header.");
+        return LE_FORMAT_ERROR;
+    }
+
+    char type = blockPtr[HDR_TYPE];
+
+    extPtr->dataRemaining = size;
+    extPtr->padRemaining = (TAR_BLOCK_SIZE - (size % TAR_BLOCK_SIZE)) % TAR_BLOCK_SIZE;
+
+    // Metadata for the next entry.
+    if ((type == 'L') || (type == 'K') || (type == 'x'))
+    {
+        if (size > MAX_META_DATA_BYTES)
+        {
+            LE_ERROR("Tar extended header too large (%" PRIu64 " bytes).", size);
+            return LE_FORMAT_ERROR;
+        }
+
+        extPtr->metaType = type;
+        extPtr->metaPtr = malloc(size + 1);
+        LE_ASSERT(extPtr->metaPtr != NULL);
+        extPtr->metaBytes = 0;
+        extPtr->state = STATE_META_DATA;
+
+        return LE_OK;
+    }
+
+    // Get the entry's name and link target, unless they were given by metadata entries.
+    char name[PATH_MAX];
+    char linkTarget[PATH_MAX];
+
+    if (extPtr->longName[0] != '\0')
+    {
+        LE_ASSERT(le_utf8_Copy(name, extPtr->longName, sizeof(name), NULL) == LE_OK);
+    }
+    else
+    {
+        char prefix[HDR_PREFIX_SIZE + 1] = "";
+
+        // The prefix field only exists in POSIX headers (GNU headers have other fields there).
+        if (memcmp(blockPtr + HDR_MAGIC, "ustar\0", 6) == 0)
+        {
+            CopyField(prefix, blockPtr + HDR_PREFIX, HDR_PREFIX_SIZE);
+        }
+
+        char shortName[HDR_NAME_SIZE + 1];
+
+        CopyField(shortName, blockPtr + HDR_NAME, HDR_NAME_SIZE);
+
+        if (prefix[0] != '\0')
+        {
+            snprintf(name, sizeof(name), "%s/%s", prefix, shortName);
+        }
+        else
+        {
+            LE_ASSERT(le_utf8_Copy(name, shortName, sizeof(name), NULL) == LE_OK);
+        }
+    }
+
+    if (extPtr->longLink[0] != '\0')
+    {
+        LE_ASSERT(le_utf8_Copy(linkTarget, extPtr->longLink, sizeof(linkTarget), NULL) == LE_OK);
+    }
+    else
+    {
+        CopyField(linkTarget, blockPtr + HDR_LINK, HDR_LINK_SIZE);
+    }
+
+    extPtr->longName[0] = '\0';
+    extPtr->longLink[0] = '\0';
+
+    le_result_t result = GetEntryPath(extPtr, name, extPtr->path);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    // Anything that isn't extracted is skipped, including any data it has.
+    extPtr->state = STATE_SKIP;
+
+    // Don't restore setuid/setgid bits, as "tar o" doesn't restore the owner either.
+    mode &= (S_IRWXU | S_IRWXG | S_IRWXO | S_ISVTX);
+
+    switch (type)
+    {
+        case '0':
+        case '\0':
+        case '7':
+            result = OpenFile(extPtr, mode);
+            if ((result == LE_OK) && (size > 0))
+            {
+                extPtr->state = STATE_FILE_DATA;
+            }
+            else if (result == LE_OK)
+            {
+                result = CloseFile(extPtr);
+            }
+            break;
+
+        case '5':
+            result = MakeDir(extPtr, mode);
+            break;
+
+        case '1':
+        case '2':
+            result = MakeLink(extPtr, (type == '1'), linkTarget);
+            break;
+
+        case 'g':
+            // Global pax header.  Nothing in it is needed.
+            break;
+
+        default:
+            LE_WARN("Skipping tar entry '%s' of unsupported type '%c'.", name, type);
+            break;
+    }
+
+    // Entries without data are complete already.
+    if ((extPtr->state == STATE_SKIP) && (size == 0))
+    {
+        extPtr->state = STATE_HEADER;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extract decompressed bytes of the tarball.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if the tarball is invalid, LE_FAULT if an entry
+ *         couldn't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ExtractBytes
+(
+    Extraction_t* extPtr,       ///< [IN] The extraction.
+    const uint8_t* bytesPtr,    ///< [IN] Decompressed bytes.
+    size_t numBytes             ///< [IN] Number of bytes.
+)
+{
+    while (numBytes > 0)
+    {
+        size_t count;
+        le_result_t result = LE_OK;
+
+        switch (extPtr->state)
+        {
+            case STATE_HEADER:
+
+                count = TAR_BLOCK_SIZE - extPtr->blockBytes;
+                if (count > numBytes)
+                {
+                    count = numBytes;
+                }
+                memcpy(extPtr->block + extPtr->blockBytes, bytesPtr, count);
+                extPtr->blockBytes += count;
+
+                if (extPtr->blockBytes == TAR_BLOCK_SIZE)
+                {
+                    extPtr->blockBytes = 0;
+                    result = HandleHeader(extPtr);
+                }
+                break;
+
+            case STATE_FILE_DATA:
+            case STATE_META_DATA:
+            case STATE_SKIP:
+
+                // Data first, then padding.
+                if (extPtr->dataRemaining > 0)
+                {
+                    count = (extPtr->dataRemaining < numBytes) ? extPtr->dataRemaining : numBytes;
+
+                    if (extPtr->state == STATE_FILE_DATA)
+                    {
+                        if (fd_WriteSize(extPtr->fd, (void*)bytesPtr, count) != (ssize_t)count)
+                        {
+                            LE_ERROR("Failed to write to '%s' (%m).", extPtr->path);
+                            return LE_FAULT;
+                        }
+                    }
+                    else if (extPtr->state == STATE_META_DATA)
+                    {
+                        memcpy(extPtr->metaPtr + extPtr->metaBytes, bytesPtr, count);
+                        extPtr->metaBytes += count;
+                    }
+
+                    extPtr->dataRemaining -= count;
+                }
+                else
+                {
+                    count = (extPtr->padRemaining < numBytes) ? extPtr->padRemaining : numBytes;
+                    extPtr->padRemaining -= count;
+                }
+
+                // At the end of the data, finish the entry.
+                if (extPtr->dataRemaining == 0)
+                {
+                    if (extPtr->state == STATE_FILE_DATA)
+                    {
+                        result = CloseFile(extPtr);
+                        extPtr->state = STATE_SKIP;
+                    }
+                    else if (extPtr->state == STATE_META_DATA)
+                    {
+                        extPtr->metaPtr[extPtr->metaBytes] = '\0';
+                        result = ApplyMetaData(extPtr);
+                        free(extPtr->metaPtr);
+                        extPtr->metaPtr = NULL;
+                        extPtr->state = STATE_SKIP;
+
+                        if (result != LE_OK)
+                        {
+                            LE_ERROR("Malformed tar extended header.");
+                        }
+                    }
+
+                    if (extPtr->padRemaining == 0)
+                    {
+                        extPtr->state = STATE_HEADER;
+                    }
+                }
+                break;
+
+            case STATE_END:
+
+                // Anything after the end of the archive (e.g., padding to a record) is ignored.
+                return LE_OK;
+
+            default:
+                LE_FATAL("Unexpected state %d.", extPtr->state);
+        }
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+
+        bytesPtr += count;
+        numBytes -= count;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decompress bzip2-compressed bytes of the tarball and extract them.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if the bytes are invalid, LE_FAULT if an entry
+ *         couldn't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DecompressBzip2
+(
+    Extraction_t* extPtr,       ///< [IN] The extraction.
+    const uint8_t* bytesPtr,    ///< [IN] Compressed bytes.
+    size_t numBytes             ///< [IN] Number of bytes.
+)
+{
+    bz_stream* streamPtr = &extPtr->bzStream;
+    bool outputFull = false;
+
+    streamPtr->next_in = (char*)bytesPtr;
+    streamPtr->avail_in = numBytes;
+
+    while (((streamPtr->avail_in > 0) || (outputFull && !extPtr->bzStreamEnded)) &&
+           (extPtr->state != STATE_END))
+    {
+        // bzip2 files can be several streams one after the other (e.g., from pbzip2).
+        if (extPtr->bzStreamEnded)
+        {
+            BZ2_bzDecompressEnd(streamPtr);
+            LE_ASSERT(BZ2_bzDecompressInit(streamPtr, 0, 0) == BZ_OK);
+            extPtr->bzStreamEnded = false;
+        }
+
+        streamPtr->next_out = (char*)extPtr->outBuf;
+        streamPtr->avail_out = sizeof(extPtr->outBuf);
+
+        int bzResult = BZ2_bzDecompress(streamPtr);
+
+        if ((bzResult != BZ_OK) && (bzResult != BZ_STREAM_END))
+        {
+            LE_ERROR("bzip2 decompression failed (%d).", bzResult);
+            return LE_FORMAT_ERROR;
+        }
+
+        extPtr->bzStreamEnded = (bzResult == BZ_STREAM_END);
+        outputFull = (streamPtr->avail_out == 0);
+
+        le_result_t result = ExtractBytes(extPtr,
+                                          extPtr->outBuf,
+                                          sizeof(extPtr->outBuf) - streamPtr->avail_out);
+        if (result != LE_OK)
+        {
+            return result;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extract bytes of the tarball, which are compressed with the codec that has been detected.
+ *
+ * @return LE_OK if successful, LE_FORMAT_ERROR if the bytes are invalid, LE_FAULT if an entry
+ *         couldn't be created.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Decode
+(
+    Extraction_t* extPtr,       ///< [IN] The extraction.
+    const uint8_t* bytesPtr,    ///< [IN] Bytes of the tarball.
+    size_t numBytes             ///< [IN] Number of bytes.
+)
+{
+    switch (extPtr->codec)
+    {
+        case CODEC_NONE:
+            return ExtractBytes(extPtr, bytesPtr, numBytes);
+
+        case CODEC_BZIP2:
+            return DecompressBzip2(extPtr, bytesPtr, numBytes);
+
+        default:
+            LE_FATAL("Unexpected codec %d.", extPtr->codec);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the module.  Must be called before any other function of the module.
+ */
+//--------------------------------------------------------------------------------------------------
+void untar_Init
+(
+    void
+)
+{
+    ExtractionPool = le_mem_CreatePool("untar", sizeof(Extraction_t));
+    DeferredDirPool = le_mem_CreatePool("untarDirs", sizeof(DeferredDir_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start extracting a tarball into a directory.  The tarball can be compressed with bzip2 or not
+ * compressed at all, which is detected from its first bytes.
+ *
+ * Like "tar xjmop", permissions are restored from the tarball, but not owners or modification
+ * times.
+ *
+ * @return Reference to the extraction.
+ */
+//--------------------------------------------------------------------------------------------------
+untar_Ref_t untar_Create
+(
+    const char* dirPath     ///< Path to the directory to extract into (must exist).
+)
+{
+    Extraction_t* extPtr = le_mem_ForceAlloc(ExtractionPool);
+
+    memset(extPtr, 0, sizeof(*extPtr));
+
+    LE_ASSERT(le_utf8_Copy(extPtr->dirPath, dirPath, sizeof(extPtr->dirPath), NULL) == LE_OK);
+    extPtr->codec = CODEC_UNKNOWN;
+    extPtr->state = STATE_HEADER;
+    extPtr->fd = -1;
+    extPtr->deferredDirList = LE_SLS_LIST_INIT;
+
+    return extPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extract the next bytes of the tarball.  Entries are created in the file system as soon as their
+ * bytes arrive.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_FORMAT_ERROR if the bytes are not a valid tarball.
+ *  - LE_FAULT if an entry couldn't be created in the file system.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t untar_Write
+(
+    untar_Ref_t ref,        ///< The extraction.
+    const uint8_t* bytesPtr,///< Next bytes of the tarball.
+    size_t numBytes         ///< Number of bytes.
+)
+{
+    Extraction_t* extPtr = ref;
+
+    if (extPtr->codec == CODEC_UNKNOWN)
+    {
+        // Collect the first bytes, to detect the codec from them.
+        while ((extPtr->magicBytes < sizeof(extPtr->magic)) && (numBytes > 0))
+        {
+            extPtr->magic[extPtr->magicBytes++] = *bytesPtr++;
+            numBytes--;
+        }
+
+        if (extPtr->magicBytes < sizeof(extPtr->magic))
+        {
+            return LE_OK;
+        }
+
+        if (memcmp(extPtr->magic, "BZh", sizeof(extPtr->magic)) == 0)
+        {
+            LE_ASSERT(BZ2_bzDecompressInit(&extPtr->bzStream, 0, 0) == BZ_OK);
+            extPtr->bzActive = true;
+            extPtr->codec = CODEC_BZIP2;
+        }
+        else
+        {
+            extPtr->codec = CODEC_NONE;
+        }
+
+        le_result_t result = Decode(extPtr, extPtr->magic, sizeof(extPtr->magic));
+        if (result != LE_OK)
+        {
+            return result;
+        }
+    }
+
+    return Decode(extPtr, bytesPtr, numBytes);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish the extraction, after all the bytes of the tarball have been written.  Checks that the
+ * tarball was complete, and sets the permissions of directories that couldn't be set while their
+ * contents were being extracted.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_FORMAT_ERROR if the tarball ended early.
+ *  - LE_FAULT if the permissions of a directory couldn't be set.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t untar_Finish
+(
+    untar_Ref_t ref         ///< The extraction.
+)
+{
+    Extraction_t* extPtr = ref;
+    le_result_t result = LE_OK;
+
+    // Not all versions of tar write the two zero blocks at the end, so the tarball is complete
+    // as long as it didn't end in the middle of an entry.
+    if ((extPtr->codec == CODEC_UNKNOWN) ||
+        ((extPtr->state != STATE_END) &&
+         ((extPtr->state != STATE_HEADER) || (extPtr->blockBytes != 0))))
+    {
+        LE_ERROR("Tarball ended unexpectedly.");
+        return LE_FORMAT_ERROR;
+    }
+
+    if ((extPtr->codec == CODEC_BZIP2) && (extPtr->state != STATE_END) && !extPtr->bzStreamEnded)
+    {
+        LE_ERROR("bzip2 stream ended unexpectedly.");
+        return LE_FORMAT_ERROR;
+    }
+
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&extPtr->deferredDirList)) != NULL)
+    {
+        DeferredDir_t* dirPtr = CONTAINER_OF(linkPtr, DeferredDir_t, link);
+
+        if (chmod(dirPtr->path, dirPtr->mode) != 0)
+        {
+            LE_ERROR("Failed to set permissions of '%s' (%m).", dirPtr->path);
+            result = LE_FAULT;
+        }
+
+        le_mem_Release(dirPtr);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an extraction, whether it is finished or not.  Entries already extracted are left in the
+ * file system.
+ */
+//--------------------------------------------------------------------------------------------------
+void untar_Delete
+(
+    untar_Ref_t ref         ///< The extraction.
+)
+{
+    Extraction_t* extPtr = ref;
+    le_sls_Link_t* linkPtr;
+
+    if (extPtr->fd != -1)
+    {
+        fd_Close(extPtr->fd);
+    }
+
+    if (extPtr->bzActive)
+    {
+        BZ2_bzDecompressEnd(&extPtr->bzStream);
+    }
+
+    free(extPtr->metaPtr);
+
+    while ((linkPtr = le_sls_Pop(&extPtr->deferredDirList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, DeferredDir_t, link));
+    }
+
+    le_mem_Release(extPtr);
+}
@@ -0,0 +1,101 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file untar.h
+ *
+ * Functions exported by the Update Daemon's "untar" module, which extracts the tarballs found in
+ * update pack payloads without running another process.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_UPDATE_DAEMON_UNTAR_H_INCLUDE_GUARD
+#define LEGATO_UPDATE_DAEMON_UNTAR_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a tarball extraction in progress.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct untar_Extraction* untar_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the module.  Must be called before any other function of the module.
+ */
+//--------------------------------------------------------------------------------------------------
+void untar_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start extracting a tarball into a directory.  The tarball can be compressed with bzip2 or not
+ * compressed at all, which is detected from its first bytes.
+ *
+ * Like "tar xjmop", permissions are restored from the tarball, but not owners or modification
+ * times.
+ *
+ * @return Reference to the extraction.
+ */
+//--------------------------------------------------------------------------------------------------
+untar_Ref_t untar_Create
+(
+    const char* dirPath     ///< Path to the directory to extract into (must exist).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extract the next bytes of the tarball.  Entries are created in the file system as soon as their
+ * bytes arrive.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_FORMAT_ERROR if the bytes are not a valid tarball.
+ *  - LE_FAULT if an entry couldn't be created in the file system.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t untar_Write
+(
+    untar_Ref_t ref,        ///< The extraction.
+    const uint8_t* bytesPtr,///< Next bytes of the tarball.
+    size_t numBytes         ///< Number of bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish the extraction, after all the bytes of the tarball have been written.  Checks that the
+ * tarball was complete, and sets the permissions of directories that couldn't be set while their
+ * contents were being extracted.
+ *
+ * @return
+ *  - LE_OK if successful.
+ *  - LE_FORMAT_ERROR if the tarball ended early.
+ *  - LE_FAULT if the permissions of a directory couldn't be set.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t untar_Finish
+(
+    untar_Ref_t ref         ///< The extraction.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an extraction, whether it is finished or not.  Entries already extracted are left in the
+ * file system.
+ */
+//--------------------------------------------------------------------------------------------------
+void untar_Delete
+(
+    untar_Ref_t ref         ///< The extraction.
+);
+
+
+#endif // LEGATO_UPDATE_DAEMON_UNTAR_H_INCLUDE_GUARD
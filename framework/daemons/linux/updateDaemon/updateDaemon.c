@@ -41,6 +41,7 @@
 #include "user.h"
 #include "pipeline.h"
 #include "updateUnpack.h"
+#include "untar.h"
 #include "instStat.h"
 #include "app.h"
 #include "system.h"
@@ -1305,6 +1306,12 @@ static void CleanupAppConfigTrees
                         < sizeof(obsoleteCfgTree));
             LE_DEBUG("Deleting tree '%s'", obsoleteCfgTree);
             DeleteFile(obsoleteCfgTree);
+
+            // Also delete the journal of changes made since the tree file was written, if any.
+            LE_ASSERT (snprintf(obsoleteCfgTree, sizeof(obsoleteCfgTree), "%s/%s.journal",
+                                configDirPath, obsoleteCfgTreeList[i])
+                        < sizeof(obsoleteCfgTree));
+            DeleteFile(obsoleteCfgTree);
         }
         i++;
     }
@@ -2131,6 +2138,9 @@ COMPONENT_INIT
     // Make sure that we can report app install events.
     instStat_Init();
 
+    // Prepare to extract update pack payloads.
+    untar_Init();
+
     updateCtrl_Initialize();
 
     // Register session close handler for the le_update service.
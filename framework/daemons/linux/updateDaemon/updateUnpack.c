@@ -15,26 +15,29 @@
 #include "interfaces.h"
 #include "limit.h"
 #include "updateUnpack.h"
-#include "pipeline.h"
 #include "fileDescriptor.h"
 #include "system.h"
 #include "app.h"
+#include "untar.h"
 
 
 /// An MD5 hash string is 32 characters long, plus a null terminator.
 #define MD5_STRING_BYTES 33
 
+/// Number of payload bytes read from the input stream at a time.
+#define PAYLOAD_READ_BYTES 32768
+
 /// File descriptor to read the update pack from.
 static int InputFd = -1;
 
 /// Reference to the FD Monitor for the input stream (NULL if not unpacking).
 static le_fdMonitor_Ref_t InputFdMonitor = NULL;
 
-/// Reference to an unpack pipeline (NULL if not unpacking).
-static pipeline_Ref_t Pipeline = NULL;
+/// Reference to the extraction of the payload's tarball (NULL if not unpacking).
+static untar_Ref_t Extraction = NULL;
 
-/// File descriptor connected to the input of a pipeline (-1 if not unpacking)
-static int PipelineFd = -1;
+/// Buffer that payload bytes are read into.
+static uint8_t PayloadBuffer[PAYLOAD_READ_BYTES];
 
 /// Function to be called to report progress.
 static updateUnpack_ProgressHandler_t ProgressFunc = NULL;
@@ -54,7 +57,7 @@ static char Md5[MD5_STRING_BYTES]; ///< The system's MD5 hash.
 /// # of bytes of payload following the JSON.
 static size_t PayloadSize;
 
-/// # of bytes of payload that have been copied to the unpack pipeline.
+/// # of bytes of payload that have been read from the input stream.
 static size_t PayloadBytesCopied;
 
 /// Percentage complete on current task.
@@ -161,23 +164,18 @@ static void Reset
 
     DeleteFdMonitor();
 
-    // Close the pipes.
+    // Close the input pipe.
     if (InputFd != -1)
     {
         fd_Close(InputFd);
         InputFd = -1;
     }
-    if (PipelineFd != -1)
-    {
-        fd_Close(PipelineFd);
-        PipelineFd = -1;
-    }
 
-    // Delete the pipeline.
-    if (Pipeline != NULL)
+    // Abandon the extraction.
+    if (Extraction != NULL)
     {
-        pipeline_Delete(Pipeline);
-        Pipeline = NULL;
+        untar_Delete(Extraction);
+        Extraction = NULL;
     }
 }
 
@@ -361,34 +359,27 @@ static void StartParsing
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Completion callback for "tar xj" operation.
+ * Called when all the payload bytes have been extracted.
  */
 //--------------------------------------------------------------------------------------------------
 static void UntarDone
 (
-    pipeline_Ref_t pipeline,
-    int status
+    void
 )
 //--------------------------------------------------------------------------------------------------
 {
-    pipeline_Delete(Pipeline);
-    Pipeline = NULL;
+    le_result_t result = untar_Finish(Extraction);
 
-    if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
-    {
-        if (WIFEXITED(status))
-        {
-            LE_ERROR("Payload unpack pipeline failed with exit code: %d", WEXITSTATUS(status));
-        }
-        else if (WIFSIGNALED(status))
-        {
-            LE_ERROR("Payload unpack pipeline killed by signal: %d", WTERMSIG(status));
-        }
-        else
-        {
-            LE_ERROR("Payload unpack pipeline died for unknown reason (status: %d)", status);
-        }
+    untar_Delete(Extraction);
+    Extraction = NULL;
 
+    if (result == LE_FORMAT_ERROR)
+    {
+        HandleFormatError();
+        return;
+    }
+    if (result != LE_OK)
+    {
         HandleInternalError();
         return;
     }
@@ -463,33 +454,31 @@ static void SkipForwardDone
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Copy bytes from the input fd to the pipeline's input fd until the input fd's read buffer is
- * empty or we have copied all the payload bytes.
+ * Read payload bytes from the input fd and extract them until the input fd's read buffer is
+ * empty or we have extracted all the payload bytes.
  */
 //--------------------------------------------------------------------------------------------------
-static void CopyBytesToPipeline
+static void ExtractPayloadBytes
 (
     void
 )
 //--------------------------------------------------------------------------------------------------
 {
-    char buffer[1024];
-
-    // Keep copying as much as we can until we've copied all the payload.
+    // Keep extracting as much as we can until we've extracted all the payload.
     while (PayloadBytesCopied < PayloadSize)
     {
         // Compute the number of bytes to read.
         size_t bytesToRead = PayloadSize - PayloadBytesCopied;
-        if (bytesToRead > sizeof(buffer))
+        if (bytesToRead > sizeof(PayloadBuffer))
         {
-            bytesToRead = sizeof(buffer);
+            bytesToRead = sizeof(PayloadBuffer);
         }
 
         // Read the bytes, retrying if interrupted by a signal.
         ssize_t readResult;
         do
         {
-            readResult = read(InputFd, buffer, bytesToRead);
+            readResult = read(InputFd, PayloadBuffer, bytesToRead);
         }
         while ((readResult == -1) && (errno == EINTR));
 
@@ -506,7 +495,8 @@ static void CopyBytesToPipeline
             }
 
             LE_ERROR("Failed to read from input stream (%m).");
-            goto error;
+            HandleInternalError();
+            return;
         }
 
         // Handle end of file.
@@ -515,31 +505,25 @@ static void CopyBytesToPipeline
             LE_ERROR("Unexpected early end of input after %zu bytes of %zu.",
                      PayloadBytesCopied,
                      PayloadSize);
-            goto error;
+            HandleInternalError();
+            return;
         }
 
-        // Write the bytes that we read.
-        ssize_t bytesWritten = 0;
-        ssize_t writeResult;
-        do
+        // Extract the bytes that we read.
+        le_result_t result = untar_Write(Extraction, PayloadBuffer, readResult);
+        if (result == LE_FORMAT_ERROR)
         {
-            writeResult = write(PipelineFd, buffer + bytesWritten, readResult - bytesWritten);
-
-            // If some bytes were written, remember how many bytes, so we don't try to write the
-            // same bytes again if we have more to write.
-            if (writeResult > 0)
-            {
-                bytesWritten += writeResult;
-            }
+            LE_ERROR("Bad payload tarball after %zu bytes of %zu.",
+                     PayloadBytesCopied,
+                     PayloadSize);
+            HandleFormatError();
+            return;
         }
-        while (   ((writeResult == -1) && (errno == EINTR)) // Retry if interrupted by a signal
-               || ((writeResult != -1) && (bytesWritten < readResult))  ); // Continue if not done
-
-        // Check for errors.
-        if (writeResult == -1)
+        if (result != LE_OK)
         {
-            LE_ERROR("Failed to write to output stream (%m)");
-            goto error;
+            LE_ERROR("Failed to unpack payload.");
+            HandleInternalError();
+            return;
         }
 
         // Update the static progress variables and report progress to the client.
@@ -548,22 +532,15 @@ static void CopyBytesToPipeline
         ReportProgress();
     }
 
-    // If we have copied all the payload bytes to the pipeline's input, then we can stop
-    // monitoring the input fd now, close the pipeline input write pipe, and wait for the pipeline
-    // completion callback (UntarDone()).
+    // If we have extracted all the payload bytes, then we can stop monitoring the input fd now
+    // and finish the extraction.
     LE_INFO("Payload copied: %zu/%zu", PayloadBytesCopied, PayloadSize);
     LE_ASSERT(PayloadBytesCopied <= PayloadSize);
     if (PayloadBytesCopied == PayloadSize)
     {
         DeleteFdMonitor();
-        fd_Close(PipelineFd);
-        PipelineFd = -1;
+        UntarDone();
     }
-    return;
-
-error:
-
-    HandleInternalError();
 }
 
 
@@ -579,23 +556,21 @@ static void DiscardPayloadBytes
 )
 //--------------------------------------------------------------------------------------------------
 {
-    char buffer[1024];
-
     // Keep reading as much as we can until we've read all the payload.
     while (PayloadBytesCopied < PayloadSize)
     {
         // Compute the number of bytes to read.
         size_t bytesToRead = PayloadSize - PayloadBytesCopied;
-        if (bytesToRead > sizeof(buffer))
+        if (bytesToRead > sizeof(PayloadBuffer))
         {
-            bytesToRead = sizeof(buffer);
+            bytesToRead = sizeof(PayloadBuffer);
         }
 
         // Read the bytes, retrying if interrupted by a signal.
         ssize_t readResult;
         do
         {
-            readResult = read(InputFd, buffer, bytesToRead);
+            readResult = read(InputFd, PayloadBuffer, bytesToRead);
         }
         while ((readResult == -1) && (errno == EINTR));
 
@@ -635,7 +610,7 @@ static void DiscardPayloadBytes
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Event handler for the input fd when copying bytes to a pipeline.
+ * Event handler for the input fd when unpacking or skipping a payload.
  */
 //--------------------------------------------------------------------------------------------------
 static void InputFdEventHandler
@@ -649,7 +624,7 @@ static void InputFdEventHandler
     {
         if (State == STATE_UNPACKING_PAYLOAD)
         {
-            CopyBytesToPipeline();
+            ExtractPayloadBytes();
         }
         else if (State == STATE_SKIPPING_PAYLOAD)
         {
@@ -668,31 +643,6 @@ static void InputFdEventHandler
 }
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Function that runs in the unpack pipeline's "tar" process.
- **/
-//--------------------------------------------------------------------------------------------------
-static int Untar
-(
-    void* param
-)
-//--------------------------------------------------------------------------------------------------
-{
-    const char* unpackDir = param;
-
-    // Close all open file descriptors except for stdin, stdout, and stderr.
-    // This ensures that we don't keep copies of things like the pipeline input write pipe open.
-    fd_CloseAllNonStd();
-
-    // Try bsdtar first.  If that fails, fallback to tar.
-    execl("/usr/bin/bsdtar", "bsdtar", "xjmop", "-f", "-", "-C", unpackDir, (char*)NULL);
-    execl("/bin/tar", "tar", "xjop", "-C", unpackDir, (char*)NULL);
-
-    LE_FATAL("Failed to exec tar (%m)");
-}
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Start unpacking a tarball.
@@ -708,11 +658,8 @@ static void StartUntar
 
     PayloadBytesCopied = 0;
 
-    // Create a pipeline: PipelineFd -> tar
-    Pipeline = pipeline_Create();
-    PipelineFd = pipeline_CreateInputPipe(Pipeline);
-    pipeline_Append(Pipeline, Untar, (void*)dirPath);
-    pipeline_Start(Pipeline, UntarDone);
+    // The payload is extracted in this process as it is read, without a separate tar process.
+    Extraction = untar_Create(dirPath);
 
     fd_SetNonBlocking(InputFd);
 
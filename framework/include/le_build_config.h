@@ -19,6 +19,16 @@
  * switches to use malloc/free per-block.  This way, tools like valgrind can be used on a Legato
  * executable.
  *
+ * @section bld_cfg_mem_checks_disable LE_MEM_CHECKS_DISABLE
+ *
+ * When @c LE_MEM_CHECKS_DISABLE is defined, memory pool blocks are no longer surrounded by guard
+ * bands, and the guard bands are no longer verified on every allocation and release.  This saves
+ * memory and CPU time in production builds, at the cost of no longer detecting buffer overruns.
+ * Individual pools can still be checked by calling le_mem_EnableChecks() on them.
+ *
+ * Instead of editing this file, the framework can also be built with @c DISABLE_MEM_CHECKS=1 on the
+ * make command line.
+ *
  * @section bld_cfg_disable_SMACK LE_SMACK_DISABLE
  *
  * Legato provides the ability to disable the SMACK API. We don’t recommend disabling SMACK:
@@ -82,6 +92,11 @@
 
 
 
+// Uncomment this define to leave the guard bands out of memory pool blocks.
+//#define LE_MEM_CHECKS_DISABLE
+
+
+
 // Uncomment this define to disable the "2nd SEGV handler" protection in ShowStackSignalHandler().
 //#define LE_SEGV_HANDLER_DISABLE
 
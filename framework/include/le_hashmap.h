@@ -15,13 +15,22 @@
  * type of key that you intend to store. It's unwise to mix types in a single table because
  * implementation of the table has no way to detect this behaviour.
  *
- * Choose the initial size should carefully as the index size remains fixed. The best
- * choice for the initial size is a prime number slightly larger than the
- * maximum expected capacity. If a too small size is chosen, there will be an
- * increase in collisions that degrade performance over time.
+ * The initial size is a hint: a map sized for the maximum expected capacity never has to
+ * grow, but a map that outgrows its initial size grows automatically, so that lookups stay fast.
+ * The entries are moved into the bigger table a few at a time, by each of the following calls to
+ * le_hashmap_Put(), so that no single call has to move all of them.
  *
  * All hashmaps have names for diagnostic purposes.
  *
+ * @subsection c_hashmap_openAddressing Open addressing
+ *
+ * A map created with le_hashmap_CreateOpenAddressed() stores its keys, values and hashes in
+ * a single array, rather than allocating an entry for each key from a memory pool and linking the
+ * entries of each bucket into a list.  A lookup only has to look at a few neighbouring slots, found
+ * by scanning an array of one-byte tags for the slots, which is much kinder to the processor's
+ * caches.  It is usually the faster choice for large maps, and uses less memory per entry.
+ * The API and the behaviour of the map are otherwise the same.
+ *
  * @section c_hashmap_insert Adding key-value pairs
  *
  * Key-value pairs are added using le_hashmap_Put(). For example:
@@ -114,6 +123,13 @@
  * will be iterated over.  It's very possible that the newly added item is added in
  * an earlier location than the iterator is curently pointed at.
  *
+ * A map does not move its entries into a bigger table while its iterator is on one of them, so
+ * the other entries are neither skipped nor seen twice.  The move resumes once the iterator has
+ * gone past either end of the map, or has been reset by le_hashmap_GetIterator().  An iteration
+ * that is abandoned part way through therefore holds up the growth of the map until the next one,
+ * or until the map has outgrown the held up table, at which point the entries are all moved at once
+ * and the iterator is invalidated, as if it were past the end of the map.
+ *
  * When removing items during an iteration you also have to keep in mind that the
  * iterator's current item may be the one removed.  If this is the case,
  * le_hashmap_GetKey, and le_hashmap_GetValue will return NULL until either,
@@ -241,7 +257,7 @@ typedef bool (*le_hashmap_ForEachHandler_t)
  * Create a HashMap.
  *
  * If you create a hashmap with a smaller capacity than you actually use, then
- * the map will continue to work, but performance will degrade the more you put in the map.
+ * the map will grow as you put more in it.
  *
  * @return  Returns a reference to the map.
  *
@@ -256,6 +272,24 @@ le_hashmap_Ref_t le_hashmap_Create
     le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] Equality function
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a HashMap that stores its entries using open addressing (see
+ * @ref c_hashmap_openAddressing).
+ *
+ * @return  Returns a reference to the map.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_hashmap_Ref_t le_hashmap_CreateOpenAddressed
+(
+    const char*                nameStr,          ///< [in] Name of the HashMap
+    size_t                     capacity,         ///< [in] Size of the hashmap
+    le_hashmap_HashFunc_t      hashFunc,         ///< [in] Hash function
+    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] Equality function
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add a key-value pair to a HashMap. If the key already exists in the map, the previous value
@@ -24,7 +24,15 @@
  *
  * Parsing stops automatically when the end of the document is reached or an error is encountered.
  *
- * le_json_Cleanup() must be called to release memory resources allocated by the parser.
+ * The document is read from the file descriptor a block at a time, but nothing after the end of
+ * the document is taken from the file descriptor, so whatever follows the document can be read
+ * from it afterwards.  Files are sought back over the bytes that weren't needed, and pipes and
+ * sockets are peeked at.  Other types of file descriptor are read one byte at a time.
+ *
+ * A JSON document that is already in memory can be parsed using le_json_ParseBuffer() instead.
+ * It parses the whole document and cleans up the parsing session before it returns.
+ *
+ * le_json_Cleanup() must be called to release memory resources allocated by le_json_Parse().
  *
  * If the document starts with a '{', then it will finish with the matching '}'.
  *
@@ -222,6 +230,27 @@ le_json_ParsingSessionRef_t le_json_Parse
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a JSON document held in memory.  Unlike le_json_Parse(), the whole document is parsed (and
+ * all the handlers called) before this function returns, and the parsing session is cleaned up
+ * when it returns.  Handlers can still stop parsing early by calling le_json_Cleanup().
+ *
+ * @return
+ *  - LE_OK if the end of the document was reached.
+ *  - LE_FAULT if an error was reported to the error handler, or a handler stopped parsing early.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_json_ParseBuffer
+(
+    const void* bufferPtr,  ///< The JSON document.
+    size_t bufferSize,      ///< Size of the JSON document, in bytes.
+    le_json_EventHandler_t  eventHandler,   ///< Function to call when normal parsing events happen.
+    le_json_ErrorHandler_t  errorHandler,   ///< Function to call when errors happen.
+    void* opaquePtr   ///< Opaque pointer to be fetched by handlers using le_json_GetOpaquePtr().
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Stops parsing and cleans up memory allocated by the parser.
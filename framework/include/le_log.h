@@ -281,6 +281,24 @@ $ export LE_LOG_LEVEL=DEBUG
  * @verbatim
 $ export LE_LOG_TRACE=framework/fdMonitor:framework/logControl
 @endverbatim
+ *
+ * @subsubsection c_log_control_env_async LE_LOG_ASYNC
+ *
+ * @c LE_LOG_ASYNC can be set to @c 1 to make the process log asynchronously.  Logging a message
+ * then only captures the message's arguments into a ring buffer, and a background thread does the
+ * formatting and writing out.  This keeps logging from stalling threads with real-time
+ * constraints.  Messages are not reordered, but if the ring buffer fills up, debug, info and trace
+ * messages are dropped (the number dropped is logged later), and warnings and errors are written
+ * out synchronously.  Critical and emergency messages are always written out synchronously, after
+ * everything logged before them.
+ *
+ * For example,
+ * @verbatim
+$ export LE_LOG_ASYNC=1
+@endverbatim
+ *
+ * @note Messages that are still in the ring buffer are lost if the process is killed by a signal
+ *       or calls _exit().
  *
  * @subsection c_log_control_functions Programmatic Log Control
  *
@@ -267,6 +267,18 @@
  * pools are disabled and instead malloc and free are directly used.  Thus enabling the use of tools
  * like Valgrind.
  *
+ * By default, every block is also surrounded by guard bands that are checked for corruption each
+ * time the block is allocated or released.  Production builds can leave these out by defining
+ * @c LE_MEM_CHECKS_DISABLE when building the framework (see @ref c_le_build_cfg).  Pools that should
+ * still be checked in such builds can opt back in by calling @c le_mem_EnableChecks() right after
+ * they are created, before any objects are added to them:
+ *
+ * @code
+ * le_mem_PoolRef_t myPool = le_mem_CreatePool("MyPool", sizeof(MyObject_t));
+ * le_mem_EnableChecks(myPool);
+ * le_mem_ExpandPool(myPool, MY_POOL_SIZE);
+ * @endcode
+ *
  * @section mem_threading Multi-Threading
  *
  * All functions in this API are <b> thread-safe, but not async-safe </b>.  The objects
@@ -444,7 +456,8 @@ typedef struct
     size_t      maxNumBlocksUsed;   ///< Maximum number of allocated blocks at any one time.
     size_t      numOverflows;       ///< Number of times le_mem_ForceAlloc() had to expand the pool.
     uint64_t    numAllocs;          ///< Number of times an object has been allocated from this pool.
-    size_t      numFree;            ///< Number of free objects currently available in this pool.
+    size_t      numFree;            ///< Number of free objects currently available in this pool,
+                                    ///  including those cached by threads.
 }
 le_mem_PoolStats_t;
 
@@ -665,6 +678,25 @@ void le_mem_SetNumObjsToForce
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables guard band checking on a pool's objects, even if the framework was built with
+ * @c LE_MEM_CHECKS_DISABLE.
+ *
+ * @return
+ *      Nothing.
+ *
+ * @note
+ *      Must be called before any objects are added to the pool.  Sub-pools use the same setting
+ *      as their super-pool.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mem_EnableChecks
+(
+    le_mem_PoolRef_t    pool        ///< [IN] Pool to enable the checks for.
+);
+
+
 #ifndef LE_MEM_TRACE
     //----------------------------------------------------------------------------------------------
     /**
@@ -679,6 +679,12 @@
  * From this, they obtain a protocol reference that they provide to sessions when they create
  * them.
  *
+ * Messages created using le_msg_CreateMsg() have the largest size.  A sender that knows that
+ * a message (and, for a request, its response) needs less can use le_msg_CreateSizedMsg()
+ * instead.  Only the requested size is sent, and the message is allocated from a pool of
+ * messages of about that size, as is its copy on the receiving side.  Code generated from
+ * @c .api files does this for every call.
+ *
  * @section c_messagingSecurity Security
  *
  * Security is provided in the form of authentication and access control.
@@ -762,6 +768,25 @@
  * @warning DO NOT SEND DIRECTORY FILE DESCRIPTORS.  They can be exploited and used to break out of
  * chroot() jails.
  *
+ * @section c_messagingSharedMem Shared Memory Transport
+ *
+ * By default, every message is sent through the session's socket, which costs a pair of system
+ * calls and a trip through the kernel for each message.  Services that carry a high rate of
+ * messages can call le_msg_EnableServiceSharedMem() before advertising the service:
+ *
+ * @code
+ *     serviceRef = le_msg_CreateService(protocolRef, "myService");
+ *     le_msg_EnableServiceSharedMem(serviceRef);
+ *     le_msg_AdvertiseService(serviceRef);
+ * @endcode
+ *
+ * Each client that opens a session after that is offered a pair of message rings in shared
+ * memory.  If the client accepts, messages are passed through the rings and the socket is only
+ * used to wake up a side that has run out of messages to process (and to carry messages that
+ * have file descriptors attached).  Clients built against older versions of the framework
+ * just keep using the socket, as do protocols whose maximum message size is too big for the
+ * rings.  Nothing else changes for the client or the server.
+ *
  * @section c_messagingFutureEnhancements Future Enhancements
  *
  * As an optimization to reduce the number of copies in cases where the sender of a message
@@ -1263,6 +1288,26 @@ le_msg_MessageRef_t le_msg_CreateMsg
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a message with a payload smaller than the protocol's maximum, to be sent over a given
+ * session.
+ *
+ * @return  Message reference.
+ *
+ * @note
+ * - Function never returns on failure, there's no need to check the return code.
+ * - If the message is a request, the server's response has to fit in the same payload size.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_MessageRef_t le_msg_CreateSizedMsg
+(
+    le_msg_SessionRef_t sessionRef, ///< [in] Reference to the session.
+    size_t payloadSize              ///< [in] Size of the payload, in bytes.  Must be no more than
+                                    ///       the protocol's maximum message size.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Adds to the reference count on a message object.
@@ -1323,6 +1368,10 @@ void* le_msg_GetPayloadPtr
 /**
  * Gets the size, in bytes, of the message payload memory buffer.
  *
+ * This is the protocol's maximum message size, unless the message was created using
+ * le_msg_CreateSizedMsg() or was received from a sender that did so, in which case it is the size
+ * that the sender asked for.
+ *
  * @return The size, in bytes.
  */
 //--------------------------------------------------------------------------------------------------
@@ -1585,6 +1634,22 @@ void* le_msg_GetServiceContextPtr
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Offers clients that open sessions with a given service from now on a shared memory transport,
+ * instead of passing every message through the session's socket.
+ *
+ * See @ref c_messagingSharedMem.
+ *
+ * @note    Server-only function.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_EnableServiceSharedMem
+(
+    le_msg_ServiceRef_t serviceRef  ///< [in] Reference to the service.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Makes a given service available for clients to find.
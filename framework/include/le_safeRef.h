@@ -54,7 +54,10 @@
  * A <b> Reference Map </b> object can be used to create Safe References and keep track of the
  * mappings from Safe References to pointers.  At start-up, a Reference Map is
  * created by calling @c le_ref_CreateMap().  It takes a single argument, the maximum number
- * of mappings expected to track of at any time.
+ * of mappings expected to track of at any time.  The map grows if more are created than that.
+ *
+ * Looking up a Safe Reference takes the same time however many mappings the map holds.  A deleted
+ * Safe Reference stays invalid even after the map reuses its storage for a new one.
  *
  * @section c_safeRef_multithreading Multithreading
  *
@@ -265,7 +268,7 @@ void le_ref_DeleteRef
  * per map, and calling this function resets the iterator position to the start of the map.  The
  * iterator is not ready for data access until le_ref_NextNode() has been called at least once.
  *
- * @return  Returns A reference to a hashmap iterator which is ready for le_hashmap_NextNode() to be
+ * @return  Returns A reference to an iterator which is ready for le_ref_NextNode() to be
  *          called on it.
  */
 //--------------------------------------------------------------------------------------------------
@@ -293,7 +296,7 @@ le_result_t le_ref_NextNode
 //--------------------------------------------------------------------------------------------------
 /**
  * Retrieves a pointer to the safe ref iterator is currently pointing at.  If the iterator has just
- * been initialized and le_hashmap_NextNode() has not been called, or if the iterator has been
+ * been initialized and le_ref_NextNode() has not been called, or if the iterator has been
  * invalidated then this will return NULL.
  *
  * @return  A pointer to the current key, or NULL if the iterator has been invalidated or is not ready.
@@ -76,6 +76,11 @@
  *
  * See @ref c_eventLoop for details on running the event loop of a thread.
  *
+ * Each thread uses a single system timer for all of its timers.  A thread that runs many timers
+ * that don't need to expire at a precise time can call @ref le_timer_SetWakeupSlack to allow
+ * their expiry to be delayed by up to a given amount.  Timers that then expire within that
+ * amount of each other are handled by a single wakeup of the thread.
+ *
  * @section le_timer_suspend Suspend Support
  *
  * The timer runs even when system is suspended. <br>
@@ -389,5 +394,19 @@ bool le_timer_IsRunning
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the wakeup slack for the calling thread's timers.
+ *
+ * The expiry of the calling thread's timers may be delayed by up to this amount, so that timers
+ * that expire close together are all handled by a single wakeup.  The default is no slack.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_timer_SetWakeupSlack
+(
+    le_clk_Time_t slack          ///< [IN] Maximum delay of a timer expiry.
+);
+
+
 #endif // LEGATO_TIMER_INCLUDE_GUARD
 
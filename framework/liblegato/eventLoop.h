@@ -51,14 +51,19 @@ event_LoopState_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    le_sls_List_t       eventQueue;         ///< The thread's event queue.
+    le_sls_Link_t*      incomingHeadPtr;    ///< Reports queued to the thread but not yet taken
+                                            ///< by it, newest first.  Pushed to by any thread
+                                            ///< without locking; only taken by this thread.
+    le_sls_List_t       eventQueue;         ///< Reports taken from the incoming stack, in the
+                                            ///< order they were queued.  Only accessed by the
+                                            ///< thread itself.
     le_dls_List_t       handlerList;        ///< List of handlers registered with this thread.
     le_dls_List_t       fdMonitorList;      ///< List of FD Monitors created by this thread.
     int                 epollFd;            ///< epoll(7) file descriptor.
     int                 eventQueueFd;       ///< eventfd(2) file descriptor for the Event Queue.
     void*               contextPtr;         ///< Context pointer from last Handler called.
     event_LoopState_t   state;              ///< Current state of the event loop.
-    uint64_t            liveEventCount;     ///< Number of events ready for dequeing.  Ensures
+    size_t              liveEventCount;     ///< Number of events ready for dequeing.  Ensures
                                             ///< balance between queued events and monitored fds
                                             ///< in le_event_ServiceLoop().
 }
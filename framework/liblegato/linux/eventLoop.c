@@ -65,20 +65,22 @@
  * Included in the set of file descriptors that are being monitored by epoll is an eventfd
  * (see 'man eventfd') monitored in "level-triggered" mode.
  *
- * Whenever an Event Report is added to the Event Queue for a thread, the number 1 is written to
- * that thread's eventfd.  When Event Reports are popped off a thread's Event Queue, that thread's
- * eventfd is read to decrement it.  As long as the eventfd's value is greater than 0, epoll_wait()
- * will return immediately, reporting that there is something to read from that fd.
+ * Event Reports are queued to a thread by pushing them onto that thread's incoming stack, which
+ * any thread can do without taking a lock (compare-and-swap on the head pointer).  Whenever an
+ * Event Report is pushed onto an empty stack, the number 1 is written to that thread's eventfd.
+ * Reports pushed while the stack is not empty don't write to the eventfd, because the thread has
+ * already been woken up and will take them together with the others.  As long as the eventfd's
+ * value is greater than 0, epoll_wait() will return immediately, reporting that there is
+ * something to read from that fd.
  *
  * The Event Loop is an infinite loop that calls epoll_wait() and then responds to any fd events
- * that epoll_wait() reports.  If epoll_wait() reports an event on the eventfd, then an Event Report
- * is popped off the Event Queue and processed.  If epoll_wait() reports an event on any other fd,
+ * that epoll_wait() reports.  If epoll_wait() reports an event on any fd other than the eventfd,
  * FD Event Reports are created and pushed onto Event Queues according to what handlers are
- * registered for those events.  All pending Event Reports are processed until the Event Queue is
- * empty before returning to epoll_wait().  (NOTE: This choice was made to save system call
- * overhead in times of heavy load.  Unfortunately, it also means that if event handlers always add
- * new events to the queue, then epoll_wait() will never be called and therefore fd events will
- * never be detected.)
+ * registered for those events.  The eventfd is then read to reset it to zero, and all Event
+ * Reports on the incoming stack are taken off it in one atomic swap and moved onto the thread's
+ * private Event Queue in the order they were pushed.  Those Event Reports are processed before
+ * returning to epoll_wait().  Event Reports queued by the handlers themselves wait for the next
+ * pass, so handlers that always queue new events can't starve fd events.
  *
  * ----
  *
@@ -86,7 +88,9 @@
  *
  * Everything can be shared between multiple threads, and therefore must be protected from
  * multithreaded race conditions.  A Mutex is provided for that purpose, and it can be locked
- * and unlocked using the functions Lock() and Unlock().
+ * and unlocked using the functions Lock() and Unlock().  The exception is the Event Queues:
+ * the incoming stacks are lock-free, and each thread's private Event Queue is only ever accessed
+ * by that thread.
  *
  * ----
  *
@@ -337,12 +341,12 @@ static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;   // POSIX "Fast" mute
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Guards against thread cancellation and locks the mutex.
+ * Guards against thread cancellation.
  *
  * @return Old state of cancelability.
  **/
 //--------------------------------------------------------------------------------------------------
-static int Lock
+static int DisableCancel
 (
     void
 )
@@ -354,6 +358,43 @@ static int Lock
 
     LE_FATAL_IF(err != 0, "pthread_setcancelstate() failed (%s)", strerror(err));
 
+    return oldState;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases the thread cancellation guard created by DisableCancel().
+ **/
+//--------------------------------------------------------------------------------------------------
+static void RestoreCancel
+(
+    int restoreTo   ///< Old state of cancellability to be restored.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int junk;
+
+    int err = pthread_setcancelstate(restoreTo, &junk);
+    LE_FATAL_IF(err != 0, "pthread_setcancelstate() failed (%s)", strerror(err));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Guards against thread cancellation and locks the mutex.
+ *
+ * @return Old state of cancelability.
+ **/
+//--------------------------------------------------------------------------------------------------
+static int Lock
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int oldState = DisableCancel();
+
     LE_ASSERT(pthread_mutex_lock(&Mutex) == 0);
 
     return oldState;
@@ -371,12 +412,9 @@ static void Unlock
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int junk;
-
     LE_ASSERT(pthread_mutex_unlock(&Mutex) == 0);
 
-    int err = pthread_setcancelstate(restoreTo, &junk);
-    LE_FATAL_IF(err != 0, "pthread_setcancelstate() failed (%s)", strerror(err));
+    RestoreCancel(restoreTo);
 }
 
 
@@ -486,9 +524,10 @@ static void DeleteHandler
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write to a thread's Event File Descriptor.  This increments it by one.
+ * Write to a thread's Event File Descriptor.  This increments it by one, which wakes up the
+ * thread.
  *
- * This must be done exactly once for each Event Report pushed onto the thread's Event Queue.
+ * This must be done whenever an Event Report is pushed onto an empty Event Queue.
  */
 //--------------------------------------------------------------------------------------------------
 static void WriteEventFd
@@ -525,13 +564,11 @@ static void WriteEventFd
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read a thread's Event File Descriptor.  This fetches the value of the Event FD (which is
- * the number of event reports on the Event Queue) and resets the Event FD value to zero.
- *
- * @return The number of Event Reports on the thread's Event Queue.
+ * Read a thread's Event File Descriptor.  This resets the Event FD value to zero, so that epoll
+ * stops reporting it until another wake-up is written.  Doesn't block.
  */
 //--------------------------------------------------------------------------------------------------
-static uint64_t ReadEventFd
+static void ReadEventFd
 (
     event_PerThreadRec_t* perThreadRecPtr
 )
@@ -543,9 +580,9 @@ static uint64_t ReadEventFd
     for (;;)
     {
         readSize = read(perThreadRecPtr->eventQueueFd, &readBuff, sizeof(readBuff));
-        if (readSize == sizeof(readBuff))
+        if ((readSize == sizeof(readBuff)) || ((readSize == -1) && (errno == EAGAIN)))
         {
-            return readBuff;
+            return;
         }
         else
         {
@@ -562,6 +599,91 @@ static uint64_t ReadEventFd
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push an Event Report onto a thread's incoming Event Report stack, and wake up the thread if
+ * the stack was empty.  Reports pushed while the stack is not empty are picked up by the same
+ * wake-up, so a burst of reports costs a single eventfd write.
+ *
+ * Can be called by any thread, with or without the Mutex held.
+ *
+ * @warning Assumes the calling thread is protected from cancellation, so that the thread isn't
+ *          left with reports that it will never be woken up for.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PushEventReport
+(
+    event_PerThreadRec_t*   perThreadRecPtr,    ///< [in] Pointer to the thread's event data record.
+    Report_t*               reportObjPtr        ///< [in] The report to push.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sls_Link_t* oldHeadPtr = __atomic_load_n(&perThreadRecPtr->incomingHeadPtr,
+                                                __ATOMIC_RELAXED);
+
+    do
+    {
+        reportObjPtr->link.nextPtr = oldHeadPtr;
+    }
+    while (!__atomic_compare_exchange_n(&perThreadRecPtr->incomingHeadPtr,
+                                        &oldHeadPtr,
+                                        &reportObjPtr->link,
+                                        true,
+                                        __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED));
+
+    if (oldHeadPtr == NULL)
+    {
+        WriteEventFd(perThreadRecPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take all the Event Reports pushed onto the calling thread's incoming stack so far, and append
+ * them to its Event Queue in the order in which they were pushed.
+ *
+ * @note The Event FD must be read before this is called, so that a report that is pushed after
+ *       the reports are taken will wake the thread up again.
+ *
+ * @return The number of Event Reports taken.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t TakeEventReports
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sls_Link_t* linkPtr = __atomic_exchange_n(&perThreadRecPtr->incomingHeadPtr,
+                                                 NULL,
+                                                 __ATOMIC_ACQUIRE);
+    le_sls_Link_t* reversedPtr = NULL;
+    le_sls_Link_t* nextPtr;
+    size_t numReports = 0;
+
+    // The stack is newest first, so reverse it.
+    while (linkPtr != NULL)
+    {
+        nextPtr = linkPtr->nextPtr;
+        linkPtr->nextPtr = reversedPtr;
+        reversedPtr = linkPtr;
+        linkPtr = nextPtr;
+        numReports++;
+    }
+
+    while (reversedPtr != NULL)
+    {
+        nextPtr = reversedPtr->nextPtr;
+        le_sls_Queue(&perThreadRecPtr->eventQueue, reversedPtr);
+        reversedPtr = nextPtr;
+    }
+
+    return numReports;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Process one event report from the calling thread's Event Queue.
@@ -576,14 +698,12 @@ static void ProcessOneEventReport
     le_sls_Link_t* linkPtr;
     Report_t* reportObjPtr;
     Handler_t* handlerPtr;
+    int oldState;
 
-    int oldState = Lock();
-
-    // Pop an Event Report off the head of the Event Queue (inside a critical section).
+    // Pop an Event Report off the head of the Event Queue.  Only this thread accesses its
+    // Event Queue, so no locking is needed.
     linkPtr = le_sls_Pop(&perThreadRecPtr->eventQueue);
 
-    Unlock(oldState);
-
     if (linkPtr == NULL)
     {
         return;
@@ -674,9 +794,9 @@ static void ProcessEventReports
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Read the eventfd to fetch the number of Reports on the Event Queue and reset the count
-    // to zero.
-    uint64_t numReports = ReadEventFd(perThreadRecPtr);
+    // Reset the eventfd, then take the Reports that have been queued so far.
+    ReadEventFd(perThreadRecPtr);
+    size_t numReports = TakeEventReports(perThreadRecPtr);
 
     // Process only those event reports that are already on the queue.  Anything reported by the
     // event handlers will have to wait until next time ProcessEventReports() is called.
@@ -718,7 +838,7 @@ static void PubSubHandlerFunc
  * Queue a function onto a specific thread's Event Queue (could belong to the calling thread or
  * could belong to some other thread).
  *
- * @warning Assumes the mutex is locked and the thread is protected from cancellation.
+ * @warning Assumes the thread is protected from cancellation.
  */
 //--------------------------------------------------------------------------------------------------
 static void QueueFunction
@@ -740,11 +860,8 @@ static void QueueFunction
     reportPtr->param1Ptr = param1Ptr;
     reportPtr->param2Ptr = param2Ptr;
 
-    // Queue it to the Event Queue.
-    le_sls_Queue(&perThreadRecPtr->eventQueue, &reportPtr->baseClass.link);
-
-    // Write to the eventfd to notify the Event Loop that there is something on the queue.
-    WriteEventFd(perThreadRecPtr);
+    // Queue it to the Event Queue, waking up the Event Loop if necessary.
+    PushEventReport(perThreadRecPtr, &reportPtr->baseClass);
 }
 
 
@@ -838,7 +955,9 @@ void event_InitThread
     event_PerThreadRec_t* recPtr = thread_GetEventRecPtr();
 
     // Initialize the various thread-specific lists and queues.
+    recPtr->incomingHeadPtr = NULL;
     recPtr->eventQueue = LE_SLS_LIST_INIT;
+    recPtr->liveEventCount = 0;
     recPtr->handlerList = LE_DLS_LIST_INIT;
     recPtr->fdMonitorList = LE_DLS_LIST_INIT;
 
@@ -848,8 +967,9 @@ void event_InitThread
     LE_FATAL_IF(recPtr->epollFd < 0, "epoll_create1(0) failed with errno %d (%m).", errno);
 
     // Open an eventfd for this thread.  This will be uses to signal to the epoll fd that there
-    // are Event Reports on the Event Queue.
-    recPtr->eventQueueFd = eventfd(0, 0);
+    // are Event Reports on the Event Queue.  It is only ever read when epoll has reported it
+    // readable or when checking for reports, so it must not block.
+    recPtr->eventQueueFd = eventfd(0, EFD_NONBLOCK);
     LE_FATAL_IF(recPtr->eventQueueFd < 0, "eventfd() failed with errno %d (%m).", errno);
 
     // Add the eventfd to the list of file descriptors to wait for using epoll_wait().
@@ -946,6 +1066,7 @@ void event_DestructThread
     fdMon_DestructThread(perThreadRecPtr);
 
     // Discard everything on the Event Queue.
+    TakeEventReports(perThreadRecPtr);
     while (NULL != (singleLinkPtr = le_sls_Pop(&perThreadRecPtr->eventQueue)))
     {
         Report_t* reportPtr = CONTAINER_OF(singleLinkPtr, Report_t, link);
@@ -1214,18 +1335,18 @@ void le_event_Report
 
         TRACE("  ...to handler '%s'.", handlerPtr->name);
 
-        // Queue a report to the handler's thread's Event Queue.
+        // Queue a report to the handler's thread's Event Queue.  Only the part of the payload
+        // that isn't copied from the caller needs to be cleared.
         PubSubEventReport_t* reportObjPtr = le_mem_ForceAlloc(eventPtr->reportPoolRef);
-        reportObjPtr->baseClass.link = LE_SLS_LINK_INIT;
         reportObjPtr->baseClass.type = LE_EVENT_REPORT_PLAIN;
         reportObjPtr->handlerRef = handlerPtr->safeRef;
-        memset(reportObjPtr->payload, 0, eventPtr->payloadSize);
         memcpy(reportObjPtr->payload, payloadPtr, payloadSize);
-        le_sls_Queue(&perThreadRecPtr->eventQueue, &reportObjPtr->baseClass.link);
+        memset((uint8_t*)reportObjPtr->payload + payloadSize,
+               0,
+               eventPtr->payloadSize - payloadSize);
 
-        // Increment the eventfd for the handler's thread's Event Queue.
-        // This will wake up the thread and tell it that it has something on its Event Queue.
-        WriteEventFd(perThreadRecPtr);
+        // This wakes up the handler's thread, unless it already has reports waiting.
+        PushEventReport(perThreadRecPtr, &reportObjPtr->baseClass);
 
         linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
     }
@@ -1277,16 +1398,13 @@ void le_event_ReportWithRefCounting
 
         // Queue a report to the handler's thread's Event Queue.
         PubSubEventReport_t* reportObjPtr = le_mem_ForceAlloc(eventPtr->reportPoolRef);
-        reportObjPtr->baseClass.link = LE_SLS_LINK_INIT;
         reportObjPtr->baseClass.type = LE_EVENT_REPORT_COUNTED_REF;
         reportObjPtr->handlerRef = handlerPtr->safeRef;
         reportObjPtr->payload[0] = objectPtr;
         le_mem_AddRef(objectPtr);
-        le_sls_Queue(&perThreadRecPtr->eventQueue, &reportObjPtr->baseClass.link);
 
-        // Increment the eventfd for the handler's thread's Event Queue.
-        // This will wake up the thread and tell it that it has something on its Event Queue.
-        WriteEventFd(perThreadRecPtr);
+        // This wakes up the handler's thread, unless it already has reports waiting.
+        PushEventReport(perThreadRecPtr, &reportObjPtr->baseClass);
 
         linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
     }
@@ -1366,11 +1484,11 @@ void le_event_QueueFunction
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int oldState = Lock();
+    int oldState = DisableCancel();
 
     QueueFunction(thread_GetEventRecPtr(), func, param1Ptr, param2Ptr);
 
-    Unlock(oldState);
+    RestoreCancel(oldState);
 }
 
 
@@ -1389,11 +1507,11 @@ void le_event_QueueFunctionToThread
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int oldState = Lock();
+    int oldState = DisableCancel();
 
     QueueFunction(thread_GetOtherEventRecPtr(thread), func, param1Ptr, param2Ptr);
 
-    Unlock(oldState);
+    RestoreCancel(oldState);
 }
 
 
@@ -1532,8 +1650,9 @@ le_result_t le_event_ServiceLoop
     struct epoll_event epollEventList[MAX_EPOLL_EVENTS];
 
     // If there are still live events remaining in the queue, process a single event, then return
-    if (perThreadRecPtr->liveEventCount--)
+    if (perThreadRecPtr->liveEventCount > 0)
     {
+        perThreadRecPtr->liveEventCount--;
         ProcessOneEventReport(perThreadRecPtr); // This function assumes the mutex is NOT locked.
 
         return LE_OK;
@@ -1600,12 +1719,14 @@ le_result_t le_event_ServiceLoop
     }
 
     // Read the eventfd to reset it to zero so epoll stops telling us about it until more
-    // are added.
-    perThreadRecPtr->liveEventCount = ReadEventFd(perThreadRecPtr);
+    // are added, then take the reports that have been queued so far.
+    ReadEventFd(perThreadRecPtr);
+    perThreadRecPtr->liveEventCount = TakeEventReports(perThreadRecPtr);
 
-    // If events were read, process the top event
-    if (perThreadRecPtr->liveEventCount--)
+    // If events were taken, process the top event
+    if (perThreadRecPtr->liveEventCount > 0)
     {
+        perThreadRecPtr->liveEventCount--;
         ProcessOneEventReport(perThreadRecPtr);
 
         return LE_OK;
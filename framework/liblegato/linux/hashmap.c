@@ -79,7 +79,7 @@ static inline size_t HashKey(Hashmap_t* map, const void* key) {
 static Entry_t* CreateEntry
 (
     const void* newKeyPtr,
-    int newHash,
+    size_t newHash,
     const void* newValuePtr,
     le_mem_PoolRef_t poolRef
 )
@@ -124,9 +124,9 @@ static inline size_t CalculateIndex(size_t bucketCount, size_t hash) {
 static inline bool EqualKeys
 (
     const void* keyAPtr,
-    int hashA,
+    size_t hashA,
     const void* keyBPtr,
-    int hashB,
+    size_t hashB,
     le_hashmap_EqualsFunc_t equalsFuncPtr
 )
 {
@@ -140,6 +140,861 @@ static inline bool EqualKeys
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum load of a chained map.  The map grows when it holds more entries than 3/4 of its bucket
+ * count.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHAINED_MAX_LOAD(bucketCount)   ((bucketCount) * 3 / 4)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum load of an open-addressed map.  The map grows when more than 7/8 of its slots hold
+ * either an entry or the marker left behind by a removed entry.
+ */
+//--------------------------------------------------------------------------------------------------
+#define OPEN_MAX_LOAD(slotCount)        ((slotCount) * 7 / 8)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of buckets (or slots) of the old table that are moved into the new table each time an
+ * entry is put into a map that is being rehashed.  This spreads the cost of growing the map over
+ * many calls, and is large enough that the old table is always empty before the new one needs to
+ * grow in its turn.
+ */
+//--------------------------------------------------------------------------------------------------
+#define REHASH_STEP                     4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Control byte values of the slots of an open-addressed map.  The control byte of a slot that
+ * holds an entry has its top bit clear, and holds the low 7 bits of the entry's hash.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CTRL_EMPTY                      0x80
+#define CTRL_DELETED                    0xFE
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Control bytes are probed a group at a time, by loading a group into a 64-bit word.  The first
+ * GROUP_WIDTH control bytes of a table are repeated after its end, so that a group can be loaded
+ * starting at any slot.  Tables are never smaller than a group.
+ */
+//--------------------------------------------------------------------------------------------------
+#define GROUP_WIDTH                     8
+#define GROUP_LSBS                      UINT64_C(0x0101010101010101)
+#define GROUP_MSBS                      UINT64_C(0x8080808080808080)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate the buckets of a chained map, all empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AllocBuckets
+(
+    size_t bucketCount,
+    le_dls_List_t** bucketsPtrPtr,
+    size_t** chainLengthPtrPtr
+)
+{
+    // It is ok to use malloc here as tables are only ever replaced by bigger ones.
+    le_dls_List_t* bucketsPtr = malloc(bucketCount * sizeof(le_dls_List_t));
+    LE_ASSERT(bucketsPtr);
+    size_t* chainLengthPtr = malloc(bucketCount * sizeof(size_t));
+    LE_ASSERT(chainLengthPtr);
+
+    size_t i;
+    for (i = 0; i < bucketCount; i++)
+    {
+        bucketsPtr[i] = LE_DLS_LIST_INIT;
+        chainLengthPtr[i] = 0;
+    }
+
+    *bucketsPtrPtr = bucketsPtr;
+    *chainLengthPtrPtr = chainLengthPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate the slots of an open-addressed map, all empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AllocSlots
+(
+    size_t slotCount,
+    uint8_t** ctrlPtrPtr,
+    Slot_t** slotsPtrPtr
+)
+{
+    uint8_t* ctrlPtr = malloc(slotCount + GROUP_WIDTH);
+    LE_ASSERT(ctrlPtr);
+    Slot_t* slotsPtr = malloc(slotCount * sizeof(Slot_t));
+    LE_ASSERT(slotsPtr);
+
+    memset(ctrlPtr, CTRL_EMPTY, slotCount + GROUP_WIDTH);
+
+    *ctrlPtrPtr = ctrlPtr;
+    *slotsPtrPtr = slotsPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the total number of buckets (or slots) of a map.  While a map is being rehashed, those of
+ * the old table come first, followed by those of the new one.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t TotalBucketCount
+(
+    const Hashmap_t* mapPtr
+)
+{
+    return mapPtr->oldBucketCount + mapPtr->bucketCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a bucket of a chained map, given its position in the map (see TotalBucketCount()).
+ */
+//--------------------------------------------------------------------------------------------------
+static inline le_dls_List_t* GetBucket
+(
+    const Hashmap_t* mapPtr,
+    size_t index
+)
+{
+    if (index < mapPtr->oldBucketCount)
+    {
+        return &(mapPtr->oldBucketsPtr[index]);
+    }
+    return &(mapPtr->bucketsPtr[index - mapPtr->oldBucketCount]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the chain length counter of a bucket of a chained map, given the bucket's position.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t* GetChainLength
+(
+    const Hashmap_t* mapPtr,
+    size_t index
+)
+{
+    if (index < mapPtr->oldBucketCount)
+    {
+        return &(mapPtr->oldChainLengthPtr[index]);
+    }
+    return &(mapPtr->chainLengthPtr[index - mapPtr->oldBucketCount]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Work out which bucket of a chained map holds (or would hold) the entries with a given hash.
+ * While the map is being rehashed, this is the bucket of the old table unless that bucket has
+ * already been moved to the new table.
+ *
+ * @return The position of the bucket in the map.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t LocateBucket
+(
+    const Hashmap_t* mapPtr,
+    size_t hash
+)
+{
+    if (mapPtr->oldBucketCount != 0)
+    {
+        size_t index = CalculateIndex(mapPtr->oldBucketCount, hash);
+        if (index >= mapPtr->rehashIndex)
+        {
+            return index;
+        }
+    }
+    return mapPtr->oldBucketCount + CalculateIndex(mapPtr->bucketCount, hash);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the slot of an open-addressed map where the probe for a hash starts.  The low 7 bits of the
+ * hash are kept in the control byte, so the slot is chosen using the bits above those.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t HomeSlot
+(
+    size_t slotCount,
+    size_t hash
+)
+{
+    return CalculateIndex(slotCount, hash >> 7);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the control byte for a slot holding an entry with a given hash.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint8_t HashTag
+(
+    size_t hash
+)
+{
+    return hash & 0x7F;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the control byte of a slot, and its copy after the end of the table if it has one.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void SetCtrl
+(
+    uint8_t* ctrlPtr,
+    size_t slotCount,
+    size_t index,
+    uint8_t ctrl
+)
+{
+    ctrlPtr[index] = ctrl;
+    if (index < GROUP_WIDTH)
+    {
+        ctrlPtr[slotCount + index] = ctrl;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load a group of control bytes, with the first one in the low byte of the result.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t LoadGroup
+(
+    const uint8_t* ctrlPtr
+)
+{
+    uint64_t group = 0;
+    int i;
+    for (i = 0; i < GROUP_WIDTH; i++)
+    {
+        group |= (uint64_t)ctrlPtr[i] << (i * 8);
+    }
+    return group;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the control bytes of a group that hold a given hash tag.
+ *
+ * @return A mask with the top bit set of each matching byte.  This may also have bits set for
+ *         slots that hold entries with other tags; these are rare, and are weeded out by comparing
+ *         the hashes of the entries.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t MatchTag
+(
+    uint64_t group,
+    uint8_t tag
+)
+{
+    uint64_t x = group ^ (GROUP_LSBS * tag);
+    return (x - GROUP_LSBS) & ~x & GROUP_MSBS;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the control bytes of a group that mark an empty slot.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t MatchEmpty
+(
+    uint64_t group
+)
+{
+    return group & ~(group << 6) & GROUP_MSBS;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the control bytes of a group that mark an empty slot or the slot of a removed entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t MatchFree
+(
+    uint64_t group
+)
+{
+    return group & ~(group << 7) & GROUP_MSBS;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the offset within its group of the first slot set in a match mask.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t FirstMatch
+(
+    uint64_t matches
+)
+{
+    return __builtin_ctzll(matches) / 8;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Search one table of an open-addressed map for an entry.
+ *
+ * @return The entry's slot, or NULL if it is not in the table.
+ */
+//--------------------------------------------------------------------------------------------------
+static Slot_t* FindSlot
+(
+    const Hashmap_t* mapPtr,
+    const uint8_t* ctrlPtr,
+    Slot_t* slotsPtr,
+    size_t slotCount,
+    const void* keyPtr,
+    size_t hash
+)
+{
+    uint8_t tag = HashTag(hash);
+    size_t index = HomeSlot(slotCount, hash);
+    size_t probed;
+
+    for (probed = 0; probed < slotCount; probed += GROUP_WIDTH)
+    {
+        uint64_t group = LoadGroup(&ctrlPtr[index]);
+        uint64_t matches;
+
+        for (matches = MatchTag(group, tag); matches != 0; matches &= matches - 1)
+        {
+            Slot_t* slotPtr = &slotsPtr[CalculateIndex(slotCount, index + FirstMatch(matches))];
+            if (EqualKeys(slotPtr->keyPtr, slotPtr->hash, keyPtr, hash, mapPtr->equalsFuncPtr))
+            {
+                return slotPtr;
+            }
+        }
+
+        // An empty slot ends the probe, as the entry would have been put there.
+        if (MatchEmpty(group) != 0)
+        {
+            break;
+        }
+        index = CalculateIndex(slotCount, index + GROUP_WIDTH);
+    }
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Search an open-addressed map for an entry.  While the map is being rehashed, entries that have
+ * not been moved yet are still found in the old table.
+ *
+ * @return The entry's slot, or NULL if it is not in the map.
+ */
+//--------------------------------------------------------------------------------------------------
+static Slot_t* LookupSlot
+(
+    const Hashmap_t* mapPtr,
+    const void* keyPtr,
+    size_t hash
+)
+{
+    Slot_t* slotPtr = FindSlot(mapPtr, mapPtr->ctrlPtr, mapPtr->slotsPtr, mapPtr->bucketCount,
+                               keyPtr, hash);
+
+    if ((slotPtr == NULL) && (mapPtr->oldBucketCount != 0))
+    {
+        slotPtr = FindSlot(mapPtr, mapPtr->oldCtrlPtr, mapPtr->oldSlotsPtr, mapPtr->oldBucketCount,
+                           keyPtr, hash);
+    }
+    return slotPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store an entry in the first free slot of its probe sequence in the current table of an
+ * open-addressed map.  The entry must not already be in the map, and the table must not be full.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InsertSlot
+(
+    Hashmap_t* mapPtr,
+    const void* keyPtr,
+    size_t hash,
+    const void* valuePtr
+)
+{
+    size_t slotCount = mapPtr->bucketCount;
+    size_t index = HomeSlot(slotCount, hash);
+    uint64_t matches;
+
+    while ((matches = MatchFree(LoadGroup(&mapPtr->ctrlPtr[index]))) == 0)
+    {
+        index = CalculateIndex(slotCount, index + GROUP_WIDTH);
+    }
+    index = CalculateIndex(slotCount, index + FirstMatch(matches));
+
+    if (mapPtr->ctrlPtr[index] == CTRL_EMPTY)
+    {
+        mapPtr->usedCount++;
+    }
+    SetCtrl(mapPtr->ctrlPtr, slotCount, index, HashTag(hash));
+
+    Slot_t* slotPtr = &mapPtr->slotsPtr[index];
+    slotPtr->hash = hash;
+    slotPtr->keyPtr = keyPtr;
+    slotPtr->valuePtr = valuePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a slot of an open-addressed map, given its position in the map (see TotalBucketCount()).
+ *
+ * @return The slot, or NULL if it does not hold an entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline Slot_t* GetFullSlot
+(
+    const Hashmap_t* mapPtr,
+    size_t index
+)
+{
+    if (index < mapPtr->oldBucketCount)
+    {
+        return (mapPtr->oldCtrlPtr[index] & CTRL_EMPTY) ? NULL : &mapPtr->oldSlotsPtr[index];
+    }
+    index -= mapPtr->oldBucketCount;
+    return (mapPtr->ctrlPtr[index] & CTRL_EMPTY) ? NULL : &mapPtr->slotsPtr[index];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the position in an open-addressed map (see TotalBucketCount()) of one of its slots.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t SlotPosition
+(
+    const Hashmap_t* mapPtr,
+    const Slot_t* slotPtr
+)
+{
+    if ((slotPtr >= mapPtr->slotsPtr) && (slotPtr < mapPtr->slotsPtr + mapPtr->bucketCount))
+    {
+        return mapPtr->oldBucketCount + (slotPtr - mapPtr->slotsPtr);
+    }
+    return slotPtr - mapPtr->oldSlotsPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mark the slot of an entry of an open-addressed map as free.  The slot can't simply be made
+ * empty, as that would end the probe for any entry that was stored beyond it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClearSlot
+(
+    Hashmap_t* mapPtr,
+    Slot_t* slotPtr
+)
+{
+    size_t index = SlotPosition(mapPtr, slotPtr);
+
+    if (index < mapPtr->oldBucketCount)
+    {
+        SetCtrl(mapPtr->oldCtrlPtr, mapPtr->oldBucketCount, index, CTRL_DELETED);
+    }
+    else
+    {
+        index -= mapPtr->oldBucketCount;
+        SetCtrl(mapPtr->ctrlPtr, mapPtr->bucketCount, index, CTRL_DELETED);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if the map's iterator is on one of the map's entries, rather than before its start or
+ * past its end.  The entries of a map are not moved while this is the case, so that they are
+ * neither skipped nor seen twice by the iterator.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsIteratorOnEntry
+(
+    const Hashmap_t* mapPtr
+)
+{
+    int32_t index = mapPtr->iteratorPtr->currentIndex;
+
+    return (index >= 0) && ((size_t)index < TotalBucketCount(mapPtr));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Keep the map's iterator past the end of the map after its tables have changed, if that is where
+ * it was.  The iterator no longer remembers the last entry, as it may have been moved.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdatePastEndIterator
+(
+    Hashmap_t* mapPtr,
+    bool wasPastEnd
+)
+{
+    if (wasPastEnd)
+    {
+        HashmapIt_t* iteratorPtr = mapPtr->iteratorPtr;
+
+        iteratorPtr->currentIndex = TotalBucketCount(mapPtr);
+        iteratorPtr->currentListPtr = NULL;
+        iteratorPtr->currentLinkPtr = NULL;
+        iteratorPtr->currentEntryPtr = NULL;
+        iteratorPtr->currentSlotPtr = NULL;
+        iteratorPtr->isValueValid = false;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Free the old table of a map once all of its entries have been moved to the new one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FreeOldTable
+(
+    Hashmap_t* mapPtr
+)
+{
+    free(mapPtr->oldBucketsPtr);
+    free(mapPtr->oldChainLengthPtr);
+    free(mapPtr->oldCtrlPtr);
+    free(mapPtr->oldSlotsPtr);
+
+    mapPtr->oldBucketsPtr = NULL;
+    mapPtr->oldChainLengthPtr = NULL;
+    mapPtr->oldCtrlPtr = NULL;
+    mapPtr->oldSlotsPtr = NULL;
+    mapPtr->oldBucketCount = 0;
+    mapPtr->rehashIndex = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the entries of some of the buckets (or slots) of a map's old table into its new table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MoveBuckets
+(
+    Hashmap_t* mapPtr,
+    size_t count
+)
+{
+    bool wasPastEnd = (mapPtr->iteratorPtr->currentIndex != -1) && !IsIteratorOnEntry(mapPtr);
+    size_t end = mapPtr->rehashIndex + count;
+
+    if (end > mapPtr->oldBucketCount)
+    {
+        end = mapPtr->oldBucketCount;
+    }
+
+    for (; mapPtr->rehashIndex < end; mapPtr->rehashIndex++)
+    {
+        size_t oldIndex = mapPtr->rehashIndex;
+
+        if (mapPtr->isOpenAddressed)
+        {
+            if (!(mapPtr->oldCtrlPtr[oldIndex] & CTRL_EMPTY))
+            {
+                Slot_t* slotPtr = &mapPtr->oldSlotsPtr[oldIndex];
+                InsertSlot(mapPtr, slotPtr->keyPtr, slotPtr->hash, slotPtr->valuePtr);
+
+                // Leave a marker behind, so probes still get past this slot to any entries
+                // beyond it that have not been moved yet.
+                SetCtrl(mapPtr->oldCtrlPtr, mapPtr->oldBucketCount, oldIndex, CTRL_DELETED);
+            }
+        }
+        else
+        {
+            le_dls_List_t* oldListPtr = &(mapPtr->oldBucketsPtr[oldIndex]);
+            le_dls_Link_t* theLinkPtr;
+
+            while ((theLinkPtr = le_dls_Pop(oldListPtr)) != NULL)
+            {
+                Entry_t* entryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
+                size_t index = CalculateIndex(mapPtr->bucketCount, entryPtr->hash);
+
+                le_dls_Queue(&(mapPtr->bucketsPtr[index]), theLinkPtr);
+                mapPtr->chainLengthPtr[index]++;
+            }
+            mapPtr->oldChainLengthPtr[oldIndex] = 0;
+        }
+    }
+
+    if (mapPtr->rehashIndex == mapPtr->oldBucketCount)
+    {
+        FreeOldTable(mapPtr);
+
+        HASHMAP_TRACE(
+            mapPtr,
+            "Hashmap %s: Rehash to %zu buckets complete",
+            mapPtr->nameStr,
+            mapPtr->bucketCount
+        );
+    }
+
+    UpdatePastEndIterator(mapPtr, wasPastEnd);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take the next step of a map's rehash, if one is in progress.  Nothing is moved while the
+ * iterator is on an entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void RehashStep
+(
+    Hashmap_t* mapPtr
+)
+{
+    if ((mapPtr->oldBucketCount != 0) && !IsIteratorOnEntry(mapPtr))
+    {
+        MoveBuckets(mapPtr, REHASH_STEP);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start rehashing a map into a new table.  The current table becomes the old table, whose entries
+ * are moved over a few at a time by later calls to RehashStep().  Entries keep their positions in
+ * the map until then (see TotalBucketCount()), so this is safe even while the iterator is in use.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartRehash
+(
+    Hashmap_t* mapPtr,
+    size_t newBucketCount
+)
+{
+    bool wasPastEnd = (mapPtr->iteratorPtr->currentIndex != -1) && !IsIteratorOnEntry(mapPtr);
+
+    HASHMAP_TRACE(
+        mapPtr,
+        "Hashmap %s: Rehashing from %zu to %zu buckets, map size %zu",
+        mapPtr->nameStr,
+        mapPtr->bucketCount,
+        newBucketCount,
+        mapPtr->size
+    );
+
+    mapPtr->oldBucketCount = mapPtr->bucketCount;
+    mapPtr->rehashIndex = 0;
+    mapPtr->bucketCount = newBucketCount;
+
+    if (mapPtr->isOpenAddressed)
+    {
+        mapPtr->oldCtrlPtr = mapPtr->ctrlPtr;
+        mapPtr->oldSlotsPtr = mapPtr->slotsPtr;
+        AllocSlots(newBucketCount, &mapPtr->ctrlPtr, &mapPtr->slotsPtr);
+        mapPtr->usedCount = 0;
+    }
+    else
+    {
+        mapPtr->oldBucketsPtr = mapPtr->bucketsPtr;
+        mapPtr->oldChainLengthPtr = mapPtr->chainLengthPtr;
+        AllocBuckets(newBucketCount, &mapPtr->bucketsPtr, &mapPtr->chainLengthPtr);
+
+        // Grow the entry pool in bigger steps too.
+        le_mem_SetNumObjsToForce(mapPtr->entryPoolRef, newBucketCount / 8);
+    }
+
+    UpdatePastEndIterator(mapPtr, wasPastEnd);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move all the remaining entries of a chained map's old table into its new table at once.  This is
+ * only needed if a rehash can't finish because the iterator is on an entry, and the map outgrows
+ * the new table in the meantime.  The iterator is invalidated.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FinishRehash
+(
+    Hashmap_t* mapPtr
+)
+{
+    if (IsIteratorOnEntry(mapPtr))
+    {
+        LE_WARN("Hashmap %s: Rehash held up too long by iterator; iterator invalidated",
+                mapPtr->nameStr);
+        UpdatePastEndIterator(mapPtr, true);
+    }
+
+    MoveBuckets(mapPtr, mapPtr->oldBucketCount);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start rehashing a chained map into a bigger table, if it has too many entries for its current
+ * table.  This is put off while a rehash is already in progress.
+ *
+ * A rehash held up by the iterator, e.g. one left on an entry and never used again, is finished at
+ * once when the map has outgrown even the table after the new one, rather than letting the chains
+ * grow without bound.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void GrowChainedIfNeeded
+(
+    Hashmap_t* mapPtr
+)
+{
+    if ((mapPtr->oldBucketCount != 0) &&
+        (mapPtr->size > CHAINED_MAX_LOAD(mapPtr->bucketCount * 2)))
+    {
+        FinishRehash(mapPtr);
+    }
+
+    if ((mapPtr->oldBucketCount == 0) && (mapPtr->size > CHAINED_MAX_LOAD(mapPtr->bucketCount)))
+    {
+        // The new table is usually twice the size, but a map that was held up by its iterator for
+        // a while may have to catch up by more than that.
+        size_t newBucketCount = mapPtr->bucketCount * 2;
+        while (mapPtr->size > CHAINED_MAX_LOAD(newBucketCount))
+        {
+            newBucketCount *= 2;
+        }
+        StartRehash(mapPtr, newBucketCount);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move all the entries of an open-addressed map, from both of its tables, into a new table at
+ * once.  This is only needed if a rehash can't finish because the iterator is on an entry, and
+ * the new table fills up in the meantime.  The iterator is invalidated.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RebuildSlots
+(
+    Hashmap_t* mapPtr,
+    size_t newSlotCount
+)
+{
+    bool wasIteratorStarted = (mapPtr->iteratorPtr->currentIndex != -1);
+    uint8_t* ctrlPtr = mapPtr->ctrlPtr;
+    Slot_t* slotsPtr = mapPtr->slotsPtr;
+    size_t slotCount = mapPtr->bucketCount;
+    size_t i;
+
+    if (IsIteratorOnEntry(mapPtr))
+    {
+        LE_WARN("Hashmap %s: Table full while iterating; iterator invalidated", mapPtr->nameStr);
+    }
+
+    AllocSlots(newSlotCount, &mapPtr->ctrlPtr, &mapPtr->slotsPtr);
+    mapPtr->bucketCount = newSlotCount;
+    mapPtr->usedCount = 0;
+
+    for (i = mapPtr->rehashIndex; i < mapPtr->oldBucketCount; i++)
+    {
+        if (!(mapPtr->oldCtrlPtr[i] & CTRL_EMPTY))
+        {
+            Slot_t* slotPtr = &mapPtr->oldSlotsPtr[i];
+            InsertSlot(mapPtr, slotPtr->keyPtr, slotPtr->hash, slotPtr->valuePtr);
+        }
+    }
+    for (i = 0; i < slotCount; i++)
+    {
+        if (!(ctrlPtr[i] & CTRL_EMPTY))
+        {
+            InsertSlot(mapPtr, slotsPtr[i].keyPtr, slotsPtr[i].hash, slotsPtr[i].valuePtr);
+        }
+    }
+
+    free(ctrlPtr);
+    free(slotsPtr);
+    FreeOldTable(mapPtr);
+
+    UpdatePastEndIterator(mapPtr, wasIteratorStarted);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make sure there is room for one more entry in the current table of an open-addressed map.
+ *
+ * If the table is too full, it is rehashed into a new one.  The new table is twice the size,
+ * unless most of the used slots only hold the markers of removed entries, in which case rehashing
+ * into a table of the same size gets rid of the markers.
+ *
+ * If a rehash is already in progress but is held up because the iterator is on an entry, the new
+ * table is allowed to fill up further.  Only if it gets completely full are all the entries moved
+ * into a bigger table at once.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MakeRoomForSlot
+(
+    Hashmap_t* mapPtr
+)
+{
+    if (mapPtr->usedCount < OPEN_MAX_LOAD(mapPtr->bucketCount))
+    {
+        return;
+    }
+
+    if (mapPtr->oldBucketCount != 0)
+    {
+        if (mapPtr->usedCount + 1 >= mapPtr->bucketCount)
+        {
+            RebuildSlots(mapPtr, mapPtr->bucketCount * 2);
+        }
+        return;
+    }
+
+    size_t newBucketCount = mapPtr->bucketCount;
+    if (mapPtr->size >= OPEN_MAX_LOAD(mapPtr->bucketCount) / 2)
+    {
+        newBucketCount *= 2;
+    }
+    StartRehash(mapPtr, newBucketCount);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a map and fill in the parts that don't depend on how it stores its entries.
+ *
+ * @return  Returns a pointer to the map.
+ */
+//--------------------------------------------------------------------------------------------------
+static Hashmap_t* CreateMap
+(
+    const char*                nameStr,          ///< [in] Name of the HashMap
+    le_hashmap_HashFunc_t      hashFunc,         ///< [in] The hash function
+    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] The equality function
+)
+{
+    LE_ASSERT(hashFunc);
+    LE_ASSERT(equalsFunc);
+
+    // It is ok to use malloc here as we will not be destroying the map
+    le_hashmap_Ref_t mapRef = calloc(1, sizeof(Hashmap_t));
+    LE_ASSERT(mapRef);
+
+    mapRef->traceRef = NULL;
+
+    mapRef->iteratorPtr = malloc(sizeof(HashmapIt_t));
+    LE_ASSERT(mapRef->iteratorPtr);
+
+    mapRef->size = 0;
+
+    mapRef->hashFuncPtr = hashFunc;
+    mapRef->equalsFuncPtr = equalsFunc;
+    mapRef->nameStr = nameStr;
+
+    memset(mapRef->iteratorPtr, 0, sizeof(HashmapIt_t));
+    mapRef->iteratorPtr->theMapPtr = mapRef;
+    mapRef->iteratorPtr->currentIndex = -1;
+    mapRef->iteratorPtr->isValueValid = true;
+
+    return mapRef;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create a HashMap
@@ -157,14 +1012,7 @@ le_hashmap_Ref_t le_hashmap_Create
     le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] The equality function
 )
 {
-    LE_ASSERT(hashFunc);
-    LE_ASSERT(equalsFunc);
-
-    // It is ok to use malloc here as we will not be destroying the map
-    le_hashmap_Ref_t mapRef = malloc(sizeof(Hashmap_t));
-    LE_ASSERT(mapRef);
-
-    mapRef->traceRef = NULL;
+    le_hashmap_Ref_t mapRef = CreateMap(nameStr, hashFunc, equalsFunc);
 
     /**
      * 0.75 load factor. We have more buckets than expected keys as we want
@@ -193,31 +1041,90 @@ le_hashmap_Ref_t le_hashmap_Create
                                                                mapRef->bucketCount / 2);
     le_mem_SetNumObjsToForce(mapRef->entryPoolRef, mapRef->bucketCount / 8);
 
-    mapRef->bucketsPtr = malloc(mapRef->bucketCount * sizeof(le_dls_List_t));
-    LE_ASSERT(mapRef->bucketsPtr);
-    mapRef->chainLengthPtr = malloc(mapRef->bucketCount * sizeof(size_t));
-    LE_ASSERT(mapRef->chainLengthPtr);
-    mapRef->iteratorPtr = malloc(sizeof(HashmapIt_t));
-    LE_ASSERT(mapRef->iteratorPtr);
+    AllocBuckets(mapRef->bucketCount, &mapRef->bucketsPtr, &mapRef->chainLengthPtr);
+
+    return mapRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a HashMap that uses open addressing.
+ *
+ * @return  Returns a reference to the map.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_hashmap_Ref_t le_hashmap_CreateOpenAddressed
+(
+    const char*                nameStr,          ///< [in] Name of the HashMap
+    size_t                     capacity,         ///< [in] Expected capacity of the map
+    le_hashmap_HashFunc_t      hashFunc,         ///< [in] The hash function
+    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] The equality function
+)
+{
+    le_hashmap_Ref_t mapRef = CreateMap(nameStr, hashFunc, equalsFunc);
+
+    mapRef->isOpenAddressed = true;
+
+    // Enough slots to hold the expected number of entries without going over the maximum load.
+    // There must be at least a whole group of slots, and the slot count must be a power of 2.
+    mapRef->bucketCount = GROUP_WIDTH;
+    while (OPEN_MAX_LOAD(mapRef->bucketCount) <= capacity) {
+        mapRef->bucketCount <<= 1;
+    }
+
+    AllocSlots(mapRef->bucketCount, &mapRef->ctrlPtr, &mapRef->slotsPtr);
+
+    return mapRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a key-value pair to an open-addressed map.
+ *
+ * @return  Returns NULL for a new entry or a pointer to the old value if it is replaced.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* OpenPut
+(
+    Hashmap_t* mapPtr,
+    const void* keyPtr,
+    size_t hash,
+    const void* valuePtr
+)
+{
+    Slot_t* slotPtr = LookupSlot(mapPtr, keyPtr, hash);
 
-    uint32_t i = 0;
-    for (i=0; i<mapRef->bucketCount; i++)
+    if (slotPtr != NULL)
     {
-        mapRef->bucketsPtr[i] = LE_DLS_LIST_INIT;
-        mapRef->chainLengthPtr[i] = 0;
+        const void* oldValue = slotPtr->valuePtr;
+        slotPtr->valuePtr = valuePtr;
+
+        HASHMAP_TRACE(
+            mapPtr,
+            "Hashmap %s: Replaced entry in slot. Total map size now %zu",
+            mapPtr->nameStr,
+            mapPtr->size
+        );
+
+        return (void *)oldValue;
     }
 
-    mapRef->size = 0;
+    RehashStep(mapPtr);
+    MakeRoomForSlot(mapPtr);
 
-    mapRef->hashFuncPtr = hashFunc;
-    mapRef->equalsFuncPtr = equalsFunc;
-    mapRef->nameStr = nameStr;
+    InsertSlot(mapPtr, keyPtr, hash, valuePtr);
+    mapPtr->size++;
 
-    memset(mapRef->iteratorPtr, 0, sizeof(HashmapIt_t));
-    mapRef->iteratorPtr->theMapPtr = mapRef;
-    mapRef->iteratorPtr->isValueValid = true;
+    HASHMAP_TRACE(
+        mapPtr,
+        "Hashmap %s: Added entry to slot. Map size now %zu",
+        mapPtr->nameStr,
+        mapPtr->size
+    );
 
-    return mapRef;
+    return NULL;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -238,7 +1145,15 @@ void* le_hashmap_Put
 )
 {
     size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+
+    if (mapRef->isOpenAddressed)
+    {
+        return OpenPut(mapRef, keyPtr, hash, valuePtr);
+    }
+
+    RehashStep(mapRef);
+
+    size_t index = LocateBucket(mapRef, hash);
 
     HASHMAP_TRACE(
         mapRef,
@@ -248,7 +1163,7 @@ void* le_hashmap_Put
         (int)hash
     );
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+    le_dls_List_t* listHeadPtr = GetBucket(mapRef, index);
 
     if (le_dls_NumLinks(listHeadPtr) == 0)
     {
@@ -265,7 +1180,9 @@ void* le_hashmap_Put
             mapRef->size
         );
 
-        mapRef->chainLengthPtr[index]++;
+        (*GetChainLength(mapRef, index))++;
+
+        GrowChainedIfNeeded(mapRef);
 
         return NULL;
     }
@@ -312,16 +1229,18 @@ void* le_hashmap_Put
                     mapRef->size
                 );
 
-                mapRef->chainLengthPtr[index]++;
+                (*GetChainLength(mapRef, index))++;
 
                 HASHMAP_TRACE(
                     mapRef,
                     "Hashmap %s: Bucket now contains %zu entries (%zu)",
                     mapRef->nameStr,
                     le_dls_NumLinks(listHeadPtr),
-                    mapRef->chainLengthPtr[index]
+                    *GetChainLength(mapRef, index)
                 );
 
+                GrowChainedIfNeeded(mapRef);
+
                 return NULL;
             }
 
@@ -347,7 +1266,14 @@ void* le_hashmap_Get
 )
 {
     size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+
+    if (mapRef->isOpenAddressed)
+    {
+        Slot_t* slotPtr = LookupSlot(mapRef, keyPtr, hash);
+        return (slotPtr == NULL) ? NULL : (void*)(slotPtr->valuePtr);
+    }
+
+    size_t index = LocateBucket(mapRef, hash);
     HASHMAP_TRACE(
         mapRef,
         "Hashmap %s: Generated index of %zu for hash %zu",
@@ -356,7 +1282,7 @@ void* le_hashmap_Get
         hash
     );
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+    le_dls_List_t* listHeadPtr = GetBucket(mapRef, index);
     HASHMAP_TRACE(
         mapRef,
         "Hashmap %s: Looked up list contains %zu links",
@@ -409,7 +1335,14 @@ void* le_hashmap_GetStoredKey
 )
 {
     size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+
+    if (mapRef->isOpenAddressed)
+    {
+        Slot_t* slotPtr = LookupSlot(mapRef, keyPtr, hash);
+        return (slotPtr == NULL) ? NULL : (void*)(slotPtr->keyPtr);
+    }
+
+    size_t index = LocateBucket(mapRef, hash);
     HASHMAP_TRACE(
         mapRef,
         "Hashmap %s: Generated index of %zu for hash %zu",
@@ -418,7 +1351,7 @@ void* le_hashmap_GetStoredKey
         hash
     );
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+    le_dls_List_t* listHeadPtr = GetBucket(mapRef, index);
     HASHMAP_TRACE(
         mapRef,
         "Hashmap %s: Looked up list contains %zu links",
@@ -455,6 +1388,51 @@ void* le_hashmap_GetStoredKey
     return NULL;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a value from an open-addressed map.  Nothing is moved, so the iterator stays where it is,
+ * but if it is on the entry being removed its value is invalidated.
+ *
+ * @return  Returns a pointer to the value or NULL if the key is not found.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* OpenRemove
+(
+    Hashmap_t* mapPtr,
+    const void* keyPtr,
+    size_t hash
+)
+{
+    Slot_t* slotPtr = LookupSlot(mapPtr, keyPtr, hash);
+
+    if (slotPtr == NULL)
+    {
+        HASHMAP_TRACE(
+            mapPtr,
+            "Hashmap %s: Key not found",
+            mapPtr->nameStr
+        );
+        return NULL;
+    }
+
+    if (mapPtr->iteratorPtr->currentSlotPtr == slotPtr)
+    {
+        mapPtr->iteratorPtr->isValueValid = false;
+    }
+
+    void* value = (void*)(slotPtr->valuePtr);
+    ClearSlot(mapPtr, slotPtr);
+    mapPtr->size--;
+
+    HASHMAP_TRACE(
+        mapPtr,
+        "Hashmap %s: Removing key from map",
+        mapPtr->nameStr
+    );
+
+    return value;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Remove a value from a HashMap.
@@ -473,18 +1451,24 @@ void* le_hashmap_Remove
    const void* keyPtr       ///< [in] Pointer to the key to be removed
 )
 {
-    int hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+    size_t hash = HashKey(mapRef, keyPtr);
+
+    if (mapRef->isOpenAddressed)
+    {
+        return OpenRemove(mapRef, keyPtr, hash);
+    }
+
+    size_t index = LocateBucket(mapRef, hash);
 
     HASHMAP_TRACE(
         mapRef,
-        "Hashmap %s: Generated index of %zu for hash %u",
+        "Hashmap %s: Generated index of %zu for hash %zu",
         mapRef->nameStr,
         index,
         hash
     );
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+    le_dls_List_t* listHeadPtr = GetBucket(mapRef, index);
     le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
 
     while (theLinkPtr != NULL) {
@@ -506,7 +1490,7 @@ void* le_hashmap_Remove
             le_dls_Remove(listHeadPtr, theLinkPtr);
             le_mem_Release( currentEntryPtr );
             mapRef->size--;
-            mapRef->chainLengthPtr[index]--;
+            (*GetChainLength(mapRef, index))--;
 
             HASHMAP_TRACE(
                 mapRef,
@@ -577,18 +1561,24 @@ bool le_hashmap_ContainsKey
     const void* keyPtr        ///< [in] Pointer to the key to be searched for
 )
 {
-    int hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+    size_t hash = HashKey(mapRef, keyPtr);
+
+    if (mapRef->isOpenAddressed)
+    {
+        return (LookupSlot(mapRef, keyPtr, hash) != NULL);
+    }
+
+    size_t index = LocateBucket(mapRef, hash);
 
     HASHMAP_TRACE(
         mapRef,
-        "Hashmap %s: Generated index of %zu for hash %u",
+        "Hashmap %s: Generated index of %zu for hash %zu",
         mapRef->nameStr,
         index,
         hash
     );
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+    le_dls_List_t* listHeadPtr = GetBucket(mapRef, index);
     le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
 
     while (theLinkPtr != NULL) {
@@ -640,22 +1630,34 @@ void le_hashmap_RemoveAll
     mapRef->iteratorPtr->currentListPtr = NULL;
     mapRef->iteratorPtr->currentLinkPtr = NULL;
     mapRef->iteratorPtr->currentEntryPtr = NULL;
+    mapRef->iteratorPtr->currentSlotPtr = NULL;
 
-    uint32_t i;
-    for (i = 0; i < mapRef->bucketCount; i++) {
-        le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[i]);
-        le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+    if (mapRef->isOpenAddressed)
+    {
+        memset(mapRef->ctrlPtr, CTRL_EMPTY, mapRef->bucketCount + GROUP_WIDTH);
+        mapRef->usedCount = 0;
+    }
+    else
+    {
+        size_t i;
+        for (i = 0; i < TotalBucketCount(mapRef); i++) {
+            le_dls_List_t* listHeadPtr = GetBucket(mapRef, i);
+            le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
 
-        while (theLinkPtr != NULL) {
-            Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-            le_dls_Link_t* linkPtrToRemove = theLinkPtr;
-            theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
-            le_dls_Remove(listHeadPtr, linkPtrToRemove);
-            le_mem_Release( currentEntryPtr );
+            while (theLinkPtr != NULL) {
+                Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
+                le_dls_Link_t* linkPtrToRemove = theLinkPtr;
+                theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+                le_dls_Remove(listHeadPtr, linkPtrToRemove);
+                le_mem_Release( currentEntryPtr );
+            }
+            *listHeadPtr = LE_DLS_LIST_INIT;
+            *GetChainLength(mapRef, i) = 0;
         }
-        mapRef->bucketsPtr[i] = LE_DLS_LIST_INIT;
-        mapRef->chainLengthPtr[i] = 0;
     }
+
+    // Any rehash in progress is over, as there is nothing left to move.
+    FreeOldTable(mapRef);
     mapRef->size=0;
 
     HASHMAP_TRACE(
@@ -682,9 +1684,27 @@ bool le_hashmap_ForEach
     void* context                            ///< [in] Pointer to a context to be supplied to the callback
 )
 {
-    uint32_t i;
-    for (i = 0; i < mapRef->bucketCount; i++) {
-        le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[i]);
+    size_t i;
+
+    if (mapRef->isOpenAddressed)
+    {
+        for (i = 0; i < TotalBucketCount(mapRef); i++) {
+            Slot_t* slotPtr = GetFullSlot(mapRef, i);
+
+            if ((slotPtr != NULL) && !forEachFn(slotPtr->keyPtr, slotPtr->valuePtr, context)) {
+                // Check to see if this is the last element, and return false if not.
+                for (i++; i < TotalBucketCount(mapRef); i++)
+                {
+                    if (GetFullSlot(mapRef, i) != NULL) { return false; }
+                }
+                return true;   // Despite stopping early, all elements have been examined.
+            }
+        }
+        return true;
+    }
+
+    for (i = 0; i < TotalBucketCount(mapRef); i++) {
+        le_dls_List_t* listHeadPtr = GetBucket(mapRef, i);
         le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
 
         while (theLinkPtr != NULL) {
@@ -692,10 +1712,10 @@ bool le_hashmap_ForEach
             if (!forEachFn(currentEntryPtr->keyPtr, currentEntryPtr->valuePtr, context)) {
                 // Check to see if this is the last element, and return false if not.
                 if (le_dls_PeekNext(listHeadPtr, theLinkPtr) != NULL) { return false; }
-                uint32_t j;
-                for (j = i; j < mapRef->bucketCount; ++j)
+                size_t j;
+                for (j = i; j < TotalBucketCount(mapRef); ++j)
                 {
-                    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[j]);
+                    le_dls_List_t* listHeadPtr = GetBucket(mapRef, j);
                     if (le_dls_Peek(listHeadPtr)) { return false; }
                 }
                 return true;   // Despite stopping early, all elements have been examined.
@@ -733,6 +1753,73 @@ le_hashmap_It_Ref_t le_hashmap_GetIterator
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves the iterator of an open-addressed map to the next slot that holds an entry.
+ *
+ * @return  Returns LE_OK unless you go past the end of the map, then returns LE_NOT_FOUND
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenNextNode
+(
+    HashmapIt_t* iteratorPtr
+)
+{
+    Hashmap_t* mapPtr = iteratorPtr->theMapPtr;
+
+    for (
+           iteratorPtr->currentIndex = iteratorPtr->currentIndex + 1;
+           iteratorPtr->currentIndex < TotalBucketCount(mapPtr);
+           iteratorPtr->currentIndex++ )
+    {
+        Slot_t* slotPtr = GetFullSlot(mapPtr, iteratorPtr->currentIndex);
+
+        if (NULL != slotPtr)
+        {
+            iteratorPtr->currentSlotPtr = slotPtr;
+            return LE_OK;
+        }
+    }
+
+    iteratorPtr->currentIndex = TotalBucketCount(mapPtr);
+    iteratorPtr->currentSlotPtr = NULL;
+    iteratorPtr->isValueValid = false;
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves the iterator of an open-addressed map to the previous slot that holds an entry.
+ *
+ * @return  Returns LE_OK unless you go past the beginning of the map, then returns LE_NOT_FOUND.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenPrevNode
+(
+    HashmapIt_t* iteratorPtr
+)
+{
+    Hashmap_t* mapPtr = iteratorPtr->theMapPtr;
+
+    for (
+           iteratorPtr->currentIndex = iteratorPtr->currentIndex - 1;
+           iteratorPtr->currentIndex >= 0;
+           iteratorPtr->currentIndex-- )
+    {
+        Slot_t* slotPtr = GetFullSlot(mapPtr, iteratorPtr->currentIndex);
+
+        if (NULL != slotPtr)
+        {
+            iteratorPtr->currentSlotPtr = slotPtr;
+            return LE_OK;
+        }
+    }
+
+    iteratorPtr->currentSlotPtr = NULL;
+    iteratorPtr->isValueValid = false;
+    return LE_NOT_FOUND;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Moves the iterator to the next key/value pair in the map. Order is dependent
@@ -756,10 +1843,15 @@ le_result_t le_hashmap_NextNode
         return LE_NOT_FOUND;
     }
 
+    if (iteratorRef->theMapPtr->isOpenAddressed)
+    {
+        return OpenNextNode(iteratorRef);
+    }
+
     le_dls_Link_t* theLinkPtr = NULL;
 
-    // -1 indicates the iterator is new
-    if (iteratorRef->currentIndex != -1) {
+    // -1 indicates the iterator is new, and there is no current entry after a rehash has moved it
+    if ((iteratorRef->currentIndex != -1) && (iteratorRef->currentLinkPtr != NULL)) {
         // Check if the current entry is at the end of a list
         theLinkPtr = le_dls_PeekNext(iteratorRef->currentListPtr, iteratorRef->currentLinkPtr);
     }
@@ -769,10 +1861,10 @@ le_result_t le_hashmap_NextNode
         // Find the next list head
         for (
                iteratorRef->currentIndex = iteratorRef->currentIndex + 1;
-               iteratorRef->currentIndex < iteratorRef->theMapPtr->bucketCount;
+               iteratorRef->currentIndex < TotalBucketCount(iteratorRef->theMapPtr);
                iteratorRef->currentIndex++ )
         {
-            le_dls_List_t* listHeadPtr = &(iteratorRef->theMapPtr->bucketsPtr[iteratorRef->currentIndex]);
+            le_dls_List_t* listHeadPtr = GetBucket(iteratorRef->theMapPtr, iteratorRef->currentIndex);
             theLinkPtr = le_dls_Peek(listHeadPtr);
 
             if (NULL != theLinkPtr)
@@ -840,8 +1932,27 @@ le_result_t le_hashmap_PrevNode
         return LE_NOT_FOUND;
     }
 
-    le_dls_Link_t* theLinkPtr = le_dls_PeekPrev(iteratorRef->currentListPtr,
-                                                iteratorRef->currentLinkPtr);
+    // If the iterator has gone more than one step past the end, go back to the end first.
+    if (iteratorRef->currentIndex > (int32_t)TotalBucketCount(iteratorRef->theMapPtr))
+    {
+        iteratorRef->currentIndex = TotalBucketCount(iteratorRef->theMapPtr);
+    }
+
+    if (iteratorRef->theMapPtr->isOpenAddressed)
+    {
+        return OpenPrevNode(iteratorRef);
+    }
+
+    le_dls_Link_t* theLinkPtr = NULL;
+
+    // Past the end of the map, the previous entry is the last one in the map rather than the one
+    // before the entry the iterator was last on.  There is no current entry either if a rehash
+    // has moved it.
+    if ((iteratorRef->currentIndex < (int32_t)TotalBucketCount(iteratorRef->theMapPtr)) &&
+        (iteratorRef->currentLinkPtr != NULL))
+    {
+        theLinkPtr = le_dls_PeekPrev(iteratorRef->currentListPtr, iteratorRef->currentLinkPtr);
+    }
 
     if (NULL == theLinkPtr)
     {
@@ -851,7 +1962,7 @@ le_result_t le_hashmap_PrevNode
                iteratorRef->currentIndex >= 0;
                iteratorRef->currentIndex-- )
         {
-            le_dls_List_t* listHeadPtr = &(iteratorRef->theMapPtr->bucketsPtr[iteratorRef->currentIndex]);
+            le_dls_List_t* listHeadPtr = GetBucket(iteratorRef->theMapPtr, iteratorRef->currentIndex);
             theLinkPtr = le_dls_PeekTail(listHeadPtr);
 
             if (NULL != theLinkPtr)
@@ -907,6 +2018,10 @@ const void* le_hashmap_GetKey
 {
     if (!iteratorRef->isValueValid || (iteratorRef->currentIndex == -1)) return NULL;
 
+    if (iteratorRef->theMapPtr->isOpenAddressed)
+    {
+        return iteratorRef->currentSlotPtr->keyPtr;
+    }
     return iteratorRef->currentEntryPtr->keyPtr;
 }
 
@@ -926,6 +2041,10 @@ void* le_hashmap_GetValue
     if (!iteratorRef->isValueValid || (iteratorRef->currentIndex == -1)) return NULL;
 
     // Need to cast away the const
+    if (iteratorRef->theMapPtr->isOpenAddressed)
+    {
+        return (void*)iteratorRef->currentSlotPtr->valuePtr;
+    }
     return (void*)iteratorRef->currentEntryPtr->valuePtr;
 }
 
@@ -962,21 +2081,40 @@ le_result_t le_hashmap_GetFirstNode
         return LE_BAD_PARAMETER;
     }
 
-    // Find the first list head
+    // Find the first list head (or the first slot in use)
     size_t index = 0;
     for (
            ;
-           index < mapRef->bucketCount;
+           index < TotalBucketCount(mapRef);
            index++ )
     {
-        le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+        if (mapRef->isOpenAddressed)
+        {
+            Slot_t* slotPtr = GetFullSlot(mapRef, index);
+
+            if (NULL != slotPtr)
+            {
+                *firstKeyPtr = (void *)slotPtr->keyPtr;
+                if (NULL != firstValuePtr)
+                {
+                    *firstValuePtr = (void *)slotPtr->valuePtr;
+                }
+                break;
+            }
+            continue;
+        }
+
+        le_dls_List_t* listHeadPtr = GetBucket(mapRef, index);
         le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
 
         if (NULL != theLinkPtr)
         {
             Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
             *firstKeyPtr = (void *)currentEntryPtr->keyPtr;
-            *firstValuePtr = (void *)currentEntryPtr->valuePtr;
+            if (NULL != firstValuePtr)
+            {
+                *firstValuePtr = (void *)currentEntryPtr->valuePtr;
+            }
             break;
         }
     }
@@ -1017,7 +2155,40 @@ le_result_t le_hashmap_GetNodeAfter
 
     // Find the node pointed to by the key
     size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+
+    if (mapRef->isOpenAddressed)
+    {
+        Slot_t* slotPtr = LookupSlot(mapRef, keyPtr, hash);
+        if (NULL == slotPtr)
+        {
+            // The original key was never found
+            return LE_BAD_PARAMETER;
+        }
+
+        // Now find the next slot in use, if there is one
+        size_t index;
+        for (
+               index = SlotPosition(mapRef, slotPtr) + 1;
+               index < TotalBucketCount(mapRef);
+               index++ )
+        {
+            slotPtr = GetFullSlot(mapRef, index);
+
+            if (NULL != slotPtr)
+            {
+                *nextKeyPtr = (void *)slotPtr->keyPtr;
+                if (NULL != nextValuePtr)
+                {
+                    *nextValuePtr = (void *)slotPtr->valuePtr;
+                }
+                return LE_OK;
+            }
+        }
+        // We are off the end of the map
+        return LE_NOT_FOUND;
+    }
+
+    size_t index = LocateBucket(mapRef, hash);
     HASHMAP_TRACE(
         mapRef,
         "Hashmap %s: Generated index of %zu for hash %zu",
@@ -1026,7 +2197,7 @@ le_result_t le_hashmap_GetNodeAfter
         hash
     );
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+    le_dls_List_t* listHeadPtr = GetBucket(mapRef, index);
     HASHMAP_TRACE(
         mapRef,
         "Hashmap %s: Looked up list contains %zu links",
@@ -1057,10 +2228,10 @@ le_result_t le_hashmap_GetNodeAfter
                 // Find the next list head
                 for (
                        index++;
-                       index < mapRef->bucketCount;
+                       index < TotalBucketCount(mapRef);
                        index++ )
                 {
-                    listHeadPtr = &(mapRef->bucketsPtr[index]);
+                    listHeadPtr = GetBucket(mapRef, index);
                     theLinkPtr = le_dls_Peek(listHeadPtr);
 
                     if (NULL != theLinkPtr)
@@ -1112,9 +2283,29 @@ size_t le_hashmap_CountCollisions
 )
 {
     size_t i, collCount = 0;
-    for (i = 0; i < mapRef->bucketCount; i++) {
-        if (mapRef->chainLengthPtr[i] > 1) {
-            collCount += mapRef->chainLengthPtr[i] - 1;
+
+    if (mapRef->isOpenAddressed)
+    {
+        // Count the entries that are not in the slot where their probe starts.
+        for (i = 0; i < TotalBucketCount(mapRef); i++) {
+            Slot_t* slotPtr = GetFullSlot(mapRef, i);
+            if (slotPtr != NULL) {
+                size_t homeIndex = (i < mapRef->oldBucketCount) ?
+                                   HomeSlot(mapRef->oldBucketCount, slotPtr->hash) :
+                                   mapRef->oldBucketCount + HomeSlot(mapRef->bucketCount,
+                                                                     slotPtr->hash);
+                if (homeIndex != i) {
+                    collCount++;
+                }
+            }
+        }
+        return collCount;
+    }
+
+    for (i = 0; i < TotalBucketCount(mapRef); i++) {
+        size_t chainLength = *GetChainLength(mapRef, i);
+        if (chainLength > 1) {
+            collCount += chainLength - 1;
         }
     }
     return collCount;
@@ -20,6 +20,17 @@ struct Entry {
     le_dls_Link_t entryListLink;
 };
 
+/**
+ * A slot in the table of an open-addressed map.  The slots of a table are stored in one array,
+ * next to an array of control bytes that says which of them hold an entry.
+ */
+typedef struct Slot {
+    size_t hash;
+    const void* keyPtr;
+    const void* valuePtr;
+}
+Slot_t;
+
 /**
  * A hashmap iterator
  */
@@ -29,6 +40,7 @@ typedef struct le_hashmap_It {
     le_dls_List_t* currentListPtr;
     le_dls_Link_t* currentLinkPtr;
     Entry_t* currentEntryPtr;
+    Slot_t* currentSlotPtr;
     bool isValueValid;
 }
 HashmapIt_t;
@@ -44,6 +56,16 @@ typedef struct le_hashmap {
     le_mem_PoolRef_t entryPoolRef;
     le_dls_List_t* bucketsPtr;
     size_t* chainLengthPtr;
+    uint8_t* ctrlPtr;                   ///< Control bytes (open-addressed maps only).
+    Slot_t* slotsPtr;                   ///< Slots (open-addressed maps only).
+    size_t usedCount;                   ///< Slots that hold an entry or a removed entry's marker.
+    size_t oldBucketCount;              ///< Size of the table being rehashed, or 0 if none.
+    le_dls_List_t* oldBucketsPtr;
+    size_t* oldChainLengthPtr;
+    uint8_t* oldCtrlPtr;
+    Slot_t* oldSlotsPtr;
+    size_t rehashIndex;                 ///< Next bucket or slot of the old table to be moved.
+    bool isOpenAddressed;
     const char* nameStr;
     HashmapIt_t* iteratorPtr;
     le_log_TraceRef_t traceRef;
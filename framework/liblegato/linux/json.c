@@ -7,12 +7,17 @@
 //--------------------------------------------------------------------------------------------------
 
 #include "legato.h"
+#include "fileDescriptor.h"
+#include <sys/socket.h>
 
 
 /// Maximum number of bytes allowed in a string value, object member name, or number's text
 /// including the null terminator.
 #define MAX_STRING_BYTES 1024
 
+/// Maximum number of bytes read from the file descriptor at a time.
+#define READ_BUFFER_BYTES 4096
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -39,6 +44,27 @@ typedef enum
 Expected_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ways of reading the JSON document.
+ *
+ * The parser reads a block of the document at a time, but must not take anything past the end
+ * of the document from the file descriptor, because the caller may go on to read something else
+ * from it (e.g., an update pack's payload follows its JSON header).  So, how a block is read
+ * depends on how the bytes that weren't parsed can be given back.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    READ_MODE_SEEK,         ///< Read a block, and seek back over the bytes that weren't parsed.
+    READ_MODE_PEEK_SOCKET,  ///< Peek at a block with recv(), and read only the bytes parsed.
+    READ_MODE_PEEK_PIPE,    ///< Peek at a block with tee(), and read only the bytes parsed.
+    READ_MODE_BYTE,         ///< Read one byte at a time.
+    READ_MODE_MEMORY,       ///< The whole document is in memory.
+}
+ReadMode_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Each instance of the parser needs one of these to keep track of its state.
@@ -54,11 +80,23 @@ typedef struct le_json_ParsingSession
     size_t numBytes;                ///< # of bytes of content in the buffer.
     double number;                  ///< Value of last number parsed.
 
+    bool isEscaped;                 ///< true if the last string character was a backslash.
+
     int fd;                         ///< File descriptor to read the JSON document from.
     le_fdMonitor_Ref_t fdMonitor;   ///< File Descriptor Monitor used to monitor the fd.
-    size_t bytesRead;               ///< # of bytes read from the file descriptor.
+    size_t bytesRead;               ///< # of bytes of the document parsed so far.
     size_t line;                    ///< Line number of the JSON document (starts at 1).
 
+    bool isDocEnded;                ///< true once the end of the document has been reached.
+    bool isCleanedUp;               ///< true once the client has called le_json_Cleanup().
+
+    ReadMode_t readMode;            ///< How the document is read.
+    int peekPipe[2];                ///< Pipe used to peek at a pipe with tee(), or -1s.
+    const char* dataPtr;            ///< Block of the document being parsed.
+    size_t dataSize;                ///< # of bytes in the block being parsed.
+    size_t dataPos;                 ///< # of bytes of the block that have been parsed.
+    char readBuffer[READ_BUFFER_BYTES]; ///< Buffer that blocks are read from the fd into.
+
     le_json_ErrorHandler_t errorHandler; ///< Function to call when errors happen.
     void* opaquePtr;                ///< Client's opaque pointer passed to le_json_Parse().
 
@@ -116,6 +154,64 @@ static inline bool NotStopped
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finishes with the block of the document being parsed, taking the bytes that have been parsed
+ * from the file descriptor and leaving the rest there.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseData
+(
+    Parser_t* parserPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t parsedBytes = parserPtr->dataPos;
+    size_t unparsedBytes = parserPtr->dataSize - parserPtr->dataPos;
+
+    switch (parserPtr->readMode)
+    {
+        case READ_MODE_SEEK:
+        case READ_MODE_BYTE:
+
+            if ((unparsedBytes > 0) && (lseek(parserPtr->fd, -(off_t)unparsedBytes, SEEK_CUR) == -1))
+            {
+                LE_WARN("Failed to seek back over %zu unparsed bytes (%m).", unparsedBytes);
+            }
+            break;
+
+        case READ_MODE_PEEK_SOCKET:
+        case READ_MODE_PEEK_PIPE:
+
+            // The bytes that were peeked at are still in the fd, so read the ones that were parsed.
+            // They have been parsed already, so they can go over the block in the read buffer.
+            while (parsedBytes > 0)
+            {
+                ssize_t bytesRead = read(parserPtr->fd, parserPtr->readBuffer, parsedBytes);
+
+                if (bytesRead > 0)
+                {
+                    parsedBytes -= bytesRead;
+                }
+                else if ((bytesRead == 0) || (errno != EINTR))
+                {
+                    LE_WARN("Failed to take %zu parsed bytes from the stream (%m).", parsedBytes);
+                    break;
+                }
+            }
+            break;
+
+        case READ_MODE_MEMORY:
+
+            // Nothing to give back.
+            return;
+    }
+
+    parserPtr->dataSize = 0;
+    parserPtr->dataPos = 0;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Stops parsing.  (Stopping a stopped parser is okay.)
@@ -130,8 +226,16 @@ static void StopParsing
     if (NotStopped(parserPtr))
     {
         parserPtr->next = EXPECT_NOTHING;
-        le_fdMonitor_Delete(parserPtr->fdMonitor);
-        parserPtr->fdMonitor = NULL;
+
+        // Leave the fd just past the last byte parsed, before any handler gets a chance to read
+        // from it.
+        ReleaseData(parserPtr);
+
+        if (parserPtr->fdMonitor != NULL)
+        {
+            le_fdMonitor_Delete(parserPtr->fdMonitor);
+            parserPtr->fdMonitor = NULL;
+        }
     }
 }
 
@@ -159,6 +263,12 @@ static void ParserDestructor
         le_mem_Release(CONTAINER_OF(linkPtr, Context_t, link));
     }
 
+    if (parserPtr->peekPipe[0] != -1)
+    {
+        fd_Close(parserPtr->peekPipe[0]);
+        fd_Close(parserPtr->peekPipe[1]);
+    }
+
     le_thread_RemoveDestructor(parserPtr->threadDestructor);
 }
 
@@ -361,8 +471,9 @@ static void PushContext
     le_sls_Stack(&parserPtr->contextStack, &contextPtr->link);
 
     // Clear the value buffer.
-    memset(parserPtr->buffer, 0, sizeof(parserPtr->buffer));
+    parserPtr->buffer[0] = '\0';
     parserPtr->numBytes = 0;
+    parserPtr->isEscaped = false;
 }
 
 
@@ -394,6 +505,7 @@ static void PopContext
                 // We've finished parsing the whole document.
                 // Automatically stop parsing and report the document end to the client.
                 StopParsing(parserPtr);
+                parserPtr->isDocEnded = true;
                 Report(parserPtr, LE_JSON_DOC_END);
                 break;
 
@@ -452,6 +564,7 @@ static void AddToBuffer
     {
         parserPtr->buffer[parserPtr->numBytes] = c;
         parserPtr->numBytes++;
+        parserPtr->buffer[parserPtr->numBytes] = '\0';
     }
 }
 
@@ -609,37 +722,50 @@ static void ParseString
 )
 //--------------------------------------------------------------------------------------------------
 {
+    // Escape sequences are passed on as they are, backslash included.  The character after a
+    // backslash never ends the string.
+    if (parserPtr->isEscaped)
+    {
+        parserPtr->isEscaped = false;
+        AddToBuffer(parserPtr, c);
+    }
+    else if (c == '\\')
+    {
+        parserPtr->isEscaped = true;
+        AddToBuffer(parserPtr, c);
+    }
     // See if this is a string terminating '"' character.
-    if (c == '"')
+    else if (c == '"')
     {
-        // It's not string terminating if it is escaped.
-        if ((parserPtr->bytesRead == 0) || (parserPtr->buffer[parserPtr->bytesRead - 1] != '\\'))
+        // Make we have a valid UTF-8 string.
+        if (!le_utf8_IsFormatCorrect(parserPtr->buffer))
         {
-            // Make we have a valid UTF-8 string.
-            if (!le_utf8_IsFormatCorrect(parserPtr->buffer))
+            Error(parserPtr, LE_JSON_SYNTAX_ERROR, "String is not valid UTF-8.");
+        }
+        else
+        {
+            // Handling of the end of the string depends on the context.
+            le_json_ContextType_t contextType = GetContext(parserPtr)->type;
+
+            if (contextType == LE_JSON_CONTEXT_STRING)
             {
-                Error(parserPtr, LE_JSON_SYNTAX_ERROR, "String is not valid UTF-8.");
+                Report(parserPtr, LE_JSON_STRING);
+                PopContext(parserPtr);
             }
-            else
+            else if (contextType == LE_JSON_CONTEXT_MEMBER)
             {
-                // Handling of the end of the string depends on the context.
-                le_json_ContextType_t contextType = GetContext(parserPtr)->type;
+                Report(parserPtr, LE_JSON_OBJECT_MEMBER);
 
-                if (contextType == LE_JSON_CONTEXT_STRING)
-                {
-                    Report(parserPtr, LE_JSON_STRING);
-                    PopContext(parserPtr);
-                }
-                else if (contextType == LE_JSON_CONTEXT_MEMBER)
+                // Don't resume parsing if the client handler has stopped it.
+                if (NotStopped(parserPtr))
                 {
-                    Report(parserPtr, LE_JSON_OBJECT_MEMBER);
                     parserPtr->next = EXPECT_COLON;
                 }
-                else
-                {
-                    LE_FATAL("Unexpected context '%s' for string termination.",
-                             le_json_GetContextName(contextType));
-                }
+            }
+            else
+            {
+                LE_FATAL("Unexpected context '%s' for string termination.",
+                         le_json_GetContextName(contextType));
             }
         }
     }
@@ -851,6 +977,242 @@ static void ProcessChar
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether any byte of a 64-bit word is zero.
+ *
+ * @return Non-zero if there is a zero byte in the word.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t HasZeroByte
+(
+    uint64_t word
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether any byte of a 64-bit word is a given byte value.
+ *
+ * @return Non-zero if the byte value is in the word.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t HasByte
+(
+    uint64_t word,
+    char c
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return HasZeroByte(word ^ (0x0101010101010101ULL * (uint8_t)c));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counts the characters at the start of a block of string content that need no special handling,
+ * which is all of them up to the first '"', backslash or newline.  Eight bytes are checked at a
+ * time until one of those is found.
+ *
+ * @return The number of ordinary characters.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t CountOrdinaryChars
+(
+    const char* bytesPtr,
+    size_t numBytes
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i = 0;
+
+    for (; (i + sizeof(uint64_t)) <= numBytes; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, bytesPtr + i, sizeof(word));
+
+        if (HasByte(word, '"') || HasByte(word, '\\') || HasByte(word, '\n'))
+        {
+            break;
+        }
+    }
+
+    for (; i < numBytes; i++)
+    {
+        char c = bytesPtr[i];
+
+        if ((c == '"') || (c == '\\') || (c == '\n'))
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copies a run of ordinary string characters from the block being parsed into the parser's string
+ * buffer in one go.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CopyOrdinaryChars
+(
+    Parser_t* parserPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t count = CountOrdinaryChars(parserPtr->dataPtr + parserPtr->dataPos,
+                                      parserPtr->dataSize - parserPtr->dataPos);
+
+    if (count > 0)
+    {
+        if (parserPtr->numBytes + count > (sizeof(parserPtr->buffer) - 1))
+        {
+            Error(parserPtr, LE_JSON_READ_ERROR, "Content item too long to fit in internal buffer.");
+            return;
+        }
+
+        memcpy(parserPtr->buffer + parserPtr->numBytes, parserPtr->dataPtr + parserPtr->dataPos, count);
+        parserPtr->numBytes += count;
+        parserPtr->buffer[parserPtr->numBytes] = '\0';
+        parserPtr->dataPos += count;
+        parserPtr->bytesRead += count;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parses the block of the document that has been read, until it has all been parsed or parsing
+ * stops.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ParseData
+(
+    Parser_t* parserPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    while (NotStopped(parserPtr) && (parserPtr->dataPos < parserPtr->dataSize))
+    {
+        // Most of a string is usually ordinary characters, which can be copied as a block.
+        if ((parserPtr->next == EXPECT_STRING) && !parserPtr->isEscaped)
+        {
+            CopyOrdinaryChars(parserPtr);
+
+            if (!NotStopped(parserPtr) || (parserPtr->dataPos == parserPtr->dataSize))
+            {
+                break;
+            }
+        }
+
+        // The byte is counted as parsed before it is processed, so that if it is the end of the
+        // document, the fd is left just past it when the client is told.
+        char c = parserPtr->dataPtr[parserPtr->dataPos];
+        parserPtr->dataPos++;
+        parserPtr->bytesRead++;
+        if (c == '\n')
+        {
+            parserPtr->line++;
+        }
+        ProcessChar(parserPtr, c);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Peeks at the data waiting in a pipe, by duplicating it into the parser's own pipe with tee() and
+ * reading it from there.
+ *
+ * @return The number of bytes peeked at, 0 at end-of-file, or -1 on error (see errno).
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t PeekPipe
+(
+    Parser_t* parserPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ssize_t count = tee(parserPtr->fd, parserPtr->peekPipe[1], READ_BUFFER_BYTES, SPLICE_F_NONBLOCK);
+
+    if (count <= 0)
+    {
+        return count;
+    }
+
+    ssize_t bytesPeeked = 0;
+    while (bytesPeeked < count)
+    {
+        ssize_t bytesRead = read(parserPtr->peekPipe[0],
+                                 parserPtr->readBuffer + bytesPeeked,
+                                 count - bytesPeeked);
+        if (bytesRead > 0)
+        {
+            bytesPeeked += bytesRead;
+        }
+        else if ((bytesRead == 0) || (errno != EINTR))
+        {
+            LE_FATAL("Failed to read back from peek pipe (%m).");
+        }
+    }
+
+    return count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the next block of the document from the file descriptor into the read buffer, without
+ * taking it from the fd if the fd can't be sought back over.
+ *
+ * @return The number of bytes read, 0 at end-of-file, or -1 on error (see errno).
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t ReadBlock
+(
+    Parser_t* parserPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ssize_t bytesRead;
+
+    do
+    {
+        switch (parserPtr->readMode)
+        {
+            case READ_MODE_SEEK:
+                bytesRead = read(parserPtr->fd, parserPtr->readBuffer, READ_BUFFER_BYTES);
+                break;
+
+            case READ_MODE_PEEK_SOCKET:
+                bytesRead = recv(parserPtr->fd,
+                                 parserPtr->readBuffer,
+                                 READ_BUFFER_BYTES,
+                                 MSG_PEEK | MSG_DONTWAIT);
+                break;
+
+            case READ_MODE_PEEK_PIPE:
+                bytesRead = PeekPipe(parserPtr);
+                break;
+
+            default:
+                bytesRead = read(parserPtr->fd, parserPtr->readBuffer, 1);
+                break;
+        }
+    }
+    while ((bytesRead == -1) && (errno == EINTR));
+
+    return bytesRead;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Read data from the JSON document file descriptor and process it.
@@ -858,20 +1220,13 @@ static void ProcessChar
 //--------------------------------------------------------------------------------------------------
 static void ReadData
 (
-    Parser_t* parserPtr,
-    int fd
+    Parser_t* parserPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
     while (NotStopped(parserPtr))
     {
-        char c;
-        ssize_t bytesRead;
-        do
-        {
-            bytesRead = read(fd, &c, 1);
-        }
-        while ((bytesRead == -1) && (errno == EINTR));
+        ssize_t bytesRead = ReadBlock(parserPtr);
 
         if (bytesRead == 0) // End of file?
         {
@@ -914,12 +1269,14 @@ static void ReadData
         }
         else
         {
-            parserPtr->bytesRead++;
-            if (c == '\n')
-            {
-                parserPtr->line++;
-            }
-            ProcessChar(parserPtr, c);
+            parserPtr->dataPtr = parserPtr->readBuffer;
+            parserPtr->dataSize = bytesRead;
+            parserPtr->dataPos = 0;
+
+            ParseData(parserPtr);
+
+            // If parsing stopped part way through the block, this has been done already.
+            ReleaseData(parserPtr);
         }
     }
 }
@@ -945,7 +1302,7 @@ static void FdEventHandler
 
     if (events & POLLIN)    // Data available to read?
     {
-        ReadData(parserPtr, fd);
+        ReadData(parserPtr);
     }
 
     // Error or hang-up?
@@ -975,32 +1332,88 @@ static void FdEventHandler
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Parse a JSON document received via a file descriptor.
+ * Works out how a JSON document can be read from a file descriptor.
  *
- * @return Reference to the JSON parsing session started by this function call.
+ * @return The read mode.
  */
 //--------------------------------------------------------------------------------------------------
-le_json_ParsingSessionRef_t le_json_Parse
+static ReadMode_t GetReadMode
 (
-    int fd, ///< File descriptor to read the JSON document from.
+    Parser_t* parserPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct stat fdStat;
+
+    if (fstat(parserPtr->fd, &fdStat) != 0)
+    {
+        // Let the first read report the problem.
+        return READ_MODE_BYTE;
+    }
+
+    if (S_ISSOCK(fdStat.st_mode))
+    {
+        return READ_MODE_PEEK_SOCKET;
+    }
+
+    if (S_ISFIFO(fdStat.st_mode))
+    {
+        if (pipe2(parserPtr->peekPipe, O_CLOEXEC | O_NONBLOCK) == 0)
+        {
+            return READ_MODE_PEEK_PIPE;
+        }
+
+        LE_WARN("Failed to create peek pipe (%m).  Reading one byte at a time.");
+        parserPtr->peekPipe[0] = -1;
+        parserPtr->peekPipe[1] = -1;
+        return READ_MODE_BYTE;
+    }
+
+    if (S_ISREG(fdStat.st_mode) && (lseek(parserPtr->fd, 0, SEEK_CUR) != -1))
+    {
+        return READ_MODE_SEEK;
+    }
+
+    return READ_MODE_BYTE;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a Parser and pushes its top-level context.
+ *
+ * @return Pointer to the Parser object.
+ */
+//--------------------------------------------------------------------------------------------------
+static Parser_t* CreateParser
+(
+    int fd, ///< File descriptor to read the JSON document from, or -1.
     le_json_EventHandler_t  eventHandler,   ///< Function to call when normal parsing events happen.
     le_json_ErrorHandler_t  errorHandler,   ///< Function to call when errors happen.
     void* opaquePtr   ///< Opaque pointer to be fetched by handlers using le_json_GetOpaquePtr().
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Create a Parser.
     Parser_t* parserPtr = le_mem_ForceAlloc(ParserPool);
 
     parserPtr->next = EXPECT_OBJECT_OR_ARRAY;
     parserPtr->numBytes = 0;
 
     parserPtr->fd = fd;
-    parserPtr->fdMonitor = le_fdMonitor_Create("le_json", fd, FdEventHandler, POLLIN);
-    le_fdMonitor_SetContextPtr(parserPtr->fdMonitor, parserPtr);
+    parserPtr->fdMonitor = NULL;
     parserPtr->bytesRead = 0;
     parserPtr->line = 1;
 
+    parserPtr->isDocEnded = false;
+    parserPtr->isCleanedUp = false;
+
+    parserPtr->readMode = READ_MODE_MEMORY;
+    parserPtr->peekPipe[0] = -1;
+    parserPtr->peekPipe[1] = -1;
+    parserPtr->dataPtr = NULL;
+    parserPtr->dataSize = 0;
+    parserPtr->dataPos = 0;
+
     parserPtr->errorHandler = errorHandler;
     parserPtr->opaquePtr = opaquePtr;
 
@@ -1016,6 +1429,83 @@ le_json_ParsingSessionRef_t le_json_Parse
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a JSON document received via a file descriptor.
+ *
+ * @return Reference to the JSON parsing session started by this function call.
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_ParsingSessionRef_t le_json_Parse
+(
+    int fd, ///< File descriptor to read the JSON document from.
+    le_json_EventHandler_t  eventHandler,   ///< Function to call when normal parsing events happen.
+    le_json_ErrorHandler_t  errorHandler,   ///< Function to call when errors happen.
+    void* opaquePtr   ///< Opaque pointer to be fetched by handlers using le_json_GetOpaquePtr().
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Parser_t* parserPtr = CreateParser(fd, eventHandler, errorHandler, opaquePtr);
+
+    parserPtr->readMode = GetReadMode(parserPtr);
+
+    parserPtr->fdMonitor = le_fdMonitor_Create("le_json", fd, FdEventHandler, POLLIN);
+    le_fdMonitor_SetContextPtr(parserPtr->fdMonitor, parserPtr);
+
+    return parserPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a JSON document held in memory.  Unlike le_json_Parse(), the whole document is parsed (and
+ * all the handlers called) before this function returns, and the parsing session is cleaned up
+ * when it returns.  Handlers can still stop parsing early by calling le_json_Cleanup().
+ *
+ * @return
+ *  - LE_OK if the end of the document was reached.
+ *  - LE_FAULT if an error was reported to the error handler, or a handler stopped parsing early.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_json_ParseBuffer
+(
+    const void* bufferPtr,  ///< The JSON document.
+    size_t bufferSize,      ///< Size of the JSON document, in bytes.
+    le_json_EventHandler_t  eventHandler,   ///< Function to call when normal parsing events happen.
+    le_json_ErrorHandler_t  errorHandler,   ///< Function to call when errors happen.
+    void* opaquePtr   ///< Opaque pointer to be fetched by handlers using le_json_GetOpaquePtr().
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Parser_t* parserPtr = CreateParser(-1, eventHandler, errorHandler, opaquePtr);
+
+    parserPtr->dataPtr = bufferPtr;
+    parserPtr->dataSize = bufferSize;
+
+    // Keep the Parser object until we are done with it, even if a handler calls le_json_Cleanup().
+    le_mem_AddRef(parserPtr);
+
+    ParseData(parserPtr);
+
+    if (NotStopped(parserPtr))
+    {
+        // The document has been truncated.
+        Error(parserPtr, LE_JSON_READ_ERROR, "Unexpected end of buffer.");
+    }
+
+    le_result_t result = (parserPtr->isDocEnded ? LE_OK : LE_FAULT);
+
+    if (!parserPtr->isCleanedUp)
+    {
+        le_json_Cleanup(parserPtr);
+    }
+
+    le_mem_Release(parserPtr);
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Stops parsing and cleans up memory allocated by the parser.
@@ -1032,6 +1522,7 @@ void le_json_Cleanup
     StopParsing(session);
 
     // Release the client's reference to the parser object.
+    session->isCleanedUp = true;
     le_mem_Release(session);
 }
 
@@ -4,6 +4,38 @@
  * Configuration of log messages is also handled by this module.  Writing traces to the log and
  * enabling traces by keyword is also handled here.
  *
+ * @section log_async Asynchronous Logging
+ *
+ * Normally, messages are formatted and written out (to syslog, or to stderr on a PC) in the
+ * thread that logs them.  That can take long enough to upset threads that have real-time
+ * constraints, especially when a chatty trace keyword is enabled.  If the LE_LOG_ASYNC
+ * environment variable is set to 1, the process logs asynchronously instead:
+ *
+ * - The logging thread only captures the message's context (level, file, function, line,
+ *   thread name and time), the format string and the binary values of the arguments, and queues
+ *   that as a record on a lock-free ring (multiple producers, single consumer).  The file and
+ *   function names, the format string and the strings passed for @c %s are all copied into the
+ *   record, because they may not outlive the call (the Java binding, for one, frees them as soon
+ *   as it returns).  File and function names longer than ASYNC_NAME_BYTES are truncated.
+ * - A drain thread, started when the first record is queued, takes records off the ring,
+ *   formats them and writes them out.  When the ring is empty, it first dozes for DRAIN_DOZE_MS,
+ *   during which the producers only wake it up if the ring is filling up, and then goes to sleep
+ *   until the next record is queued.  So a thread that logs steadily doesn't pay for a system
+ *   call to wake up the drain thread on every message.
+ * - Formats that can't be captured (positional arguments, @c %n, wide characters, or arguments
+ *   too big for a record) are formatted by the logging thread and queued as text.
+ *
+ * Messages are never reordered, but a full ring has to be dealt with:
+ *
+ * - Debug, info and trace messages are dropped and counted.  The drain thread reports how many
+ *   were dropped before the next message it writes.
+ * - Warnings and errors are written synchronously, after the ring has been flushed.
+ * - Critical and emergency messages are always written synchronously, after the ring has been
+ *   flushed, because they are usually followed by the death of the process.
+ *
+ * Records still on the ring when the process exits normally are flushed by an atexit()
+ * handler.  The child of a fork() logs synchronously, and discards the parent's records.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -21,6 +53,49 @@
 #define MAX_MSG_SIZE            256
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of records in the asynchronous logging ring.  Must be a power of two.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ASYNC_RING_SLOTS        256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffers holding the file and function names in an asynchronous logging record.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ASYNC_NAME_BYTES        64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a single conversion specification (e.g., "%-08.3lx") in a format string.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SPEC_SIZE           32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * How long a critical or emergency message waits for the drain thread to get out of the way
+ * before it gives up on flushing the ring and is written out anyway.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FLUSH_TIMEOUT_SECS      1
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * How long the drain thread waits for more records to be queued, after emptying the ring, before
+ * it goes to sleep.  This is the most that a message can be delayed by when the drain thread isn't
+ * asleep.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DRAIN_DOZE_MS           10
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Log severity strings.
@@ -150,6 +225,146 @@ static le_log_TraceRef_t TraceRef;
 static pthread_mutex_t Mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Types of argument that can be captured for asynchronous logging.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    ARG_NONE,           ///< The conversion doesn't take an argument (%% or %m).
+    ARG_INT,
+    ARG_LONG,
+    ARG_LLONG,
+    ARG_INTMAX,
+    ARG_SIZE,
+    ARG_PTRDIFF,
+    ARG_DOUBLE,
+    ARG_LDOUBLE,
+    ARG_PTR,
+    ARG_STR,
+    ARG_UNSUPPORTED     ///< The message can't be captured and must be formatted by the caller.
+}
+ArgType_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A conversion specification parsed out of a format string.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    ArgType_t type;             ///< Type of the argument that the conversion consumes.
+    int numStars;               ///< Number of '*' (int arguments that precede the value).
+    bool hasStarPrecision;      ///< true if the precision is given by the last '*'.
+    int precision;              ///< Precision given in the format, or -1 if none (or '*').
+    size_t len;                 ///< Length of the specification, including the '%'.
+}
+FormatSpec_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A message queued on the asynchronous logging ring.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t sequence;                          ///< Ring slot sequence number (see QueueRecord).
+    le_log_Level_t level;                       ///< Severity level, or -1 for a trace.
+    bool isFormatted;                           ///< true = data holds text, false = arguments.
+    int savedErrno;                             ///< errno when the message was logged (for %m).
+    unsigned int lineNumber;                    ///< Line number in the source file.
+    time_t time;                                ///< When the message was logged.
+    const char* levelPtr;                       ///< Severity string or trace keyword.
+    const char* compNamePtr;                    ///< Component name.
+    char baseFileName[ASYNC_NAME_BYTES];        ///< Source file name, without the path.
+    char functionName[ASYNC_NAME_BYTES];        ///< Function name.
+    char threadName[LIMIT_MAX_THREAD_NAME_BYTES];   ///< Name of the thread that logged it.
+    uint8_t data[MAX_MSG_SIZE];                 ///< Format string followed by the captured
+                                                ///  arguments, or the formatted text.
+}
+AsyncRecord_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true if messages are to be queued for the drain thread instead of written out by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AsyncEnabled = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The asynchronous logging ring.  This lives in .bss and is only initialized when the drain thread
+ * is started, so it doesn't cost any memory in processes that don't log asynchronously.
+ */
+//--------------------------------------------------------------------------------------------------
+static AsyncRecord_t AsyncRing[ASYNC_RING_SLOTS];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position of the next record to be queued (shared by all the producers) and of the next record
+ * to be drained (only touched by whoever holds the DrainMutex).  Kept on separate cache lines.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t EnqueuePos __attribute__((aligned(64)));
+static uint32_t DequeuePos __attribute__((aligned(64)));
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of messages dropped because the ring was full, and the number that the drain thread
+ * has reported so far.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t DroppedCount __attribute__((aligned(64)));
+static uint32_t ReportedDropCount;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Serializes the consumers of the ring (the drain thread, and callers that flush it before
+ * writing a message synchronously).
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t DrainMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * States of the drain thread, as seen by the producers.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    DRAIN_AWAKE,        ///< Draining the ring.  Doesn't need waking up.
+    DRAIN_DOZING,       ///< Waiting for DRAIN_DOZE_MS.  Only needs waking up if the ring is filling.
+    DRAIN_ASLEEP        ///< Waiting for the semaphore.  Must be woken up when a record is queued.
+}
+DrainState_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Semaphore that the drain thread waits on when the ring is empty, and its state.
+ */
+//--------------------------------------------------------------------------------------------------
+static sem_t DrainSem;
+static DrainState_t DrainState = DRAIN_AWAKE;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true once the drain thread has been started.  Protected by the DrainMutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool DrainThreadStarted = false;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Lock the mutex.
@@ -525,6 +740,33 @@ static void ReadTraceKeywordsFromEnv
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables asynchronous logging if the LE_LOG_ASYNC environment variable is set to 1.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ReadAsyncFromEnv
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* envStrPtr = getenv("LE_LOG_ASYNC");
+
+    if (envStrPtr != NULL)
+    {
+        if (strcmp(envStrPtr, "1") == 0)
+        {
+            AsyncEnabled = true;
+        }
+        else if (strcmp(envStrPtr, "0") != 0)
+        {
+            LE_ERROR("LE_LOG_ASYNC environment variable has invalid value '%s'.", envStrPtr);
+        }
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Parses a command packet, received from the Log Control Daemon, to get the component name,
@@ -739,93 +981,1186 @@ static void RegisterWithLogControlDaemon
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Initialize the logging system.
+ * Converts the legato log levels to the syslog priority levels.
+ *
+ * @return
+ *      Syslog priority level.
  */
 //--------------------------------------------------------------------------------------------------
-void log_Init
+#ifdef LEGATO_EMBEDDED
+
+static int ConvertToSyslogLevel
 (
-    void
+    le_log_Level_t legatoLevel
 )
 {
-    // NOTE: This is called when there is only one thread running, so no need to lock the mutex.
-
-    // Load the default log level filter and output destination settings from the environment.
-    ReadLevelFromEnv();
-
-    // Create the keyword memory pool.
-    KeywordMemPool = le_mem_CreatePool("TraceKeys", sizeof(KeywordObj_t));
-    le_mem_ExpandPool(KeywordMemPool, 10);   /// @todo Make this configurable.
+    switch (legatoLevel)
+    {
+        case LE_LOG_DEBUG:
+            return LOG_DEBUG;
 
-    // Create the session memory pool.
-    SessionMemPool = le_mem_CreatePool("LogSession", sizeof(LogSession_t));
-    le_mem_ExpandPool(SessionMemPool, 10);  /// @todo Make this configurable.
+        case LE_LOG_INFO:
+            return LOG_INFO;
 
-    // Register the framework as a component.
-    LE_LOG_SESSION = log_RegComponent(STRINGIZE(LE_COMPONENT_NAME), &LE_LOG_LEVEL_FILTER_PTR);
+        case LE_LOG_WARN:
+            return LOG_WARNING;
 
-    // Load the default list of enabled trace keywords from the environment.
-    ReadTraceKeywordsFromEnv();
+        case LE_LOG_ERR:
+            return LOG_ERR;
 
-    // Get a reference to the trace keyword that is used to control tracing in this module.
-    TraceRef = le_log_GetTraceRef("logControl");
+        case LE_LOG_CRIT:
+            return LOG_CRIT;
 
-    // Set the syslog format.
-    openlog("Legato", 0, LOG_USER);
+        default:
+            return LOG_EMERG;
+    }
 }
+#endif
+
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Re-Initialize the logging system.
+ * Writes a complete log message out to the log (syslog, or stderr on a PC).
  */
 //--------------------------------------------------------------------------------------------------
-void log_ReInit
+static void WriteMsg
 (
-    void
+    le_log_Level_t level,               // The severity level, or -1 for a trace.
+    const char* levelPtr,               // The severity string or trace keyword.
+    const char* compNamePtr,            // The component name.
+    const char* threadNamePtr,          // The name of the thread that logged the message.
+    const char* baseFileNamePtr,        // The name of the source file, without the path.
+    const char* functionNamePtr,        // The name of the function that logged the message.
+    unsigned int lineNumber,            // The line number in the source file.
+    time_t now,                         // When the message was logged.
+    const char* msgPtr                  // The user message.
 )
 {
-    closelog();
-    openlog("Legato", 0, LOG_USER);
+    // Get the process name.
+    const char* procNamePtr = le_arg_GetProgramName();
+    if (procNamePtr == NULL)
+    {
+        procNamePtr = "n/a";
+    }
+
+    // If running on an embedded target, write the message out to the log.
+#ifdef LEGATO_EMBEDDED
+
+    syslog(ConvertToSyslogLevel(level), "%s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
+           levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr, baseFileNamePtr,
+           functionNamePtr, lineNumber, msgPtr);
+
+    // If running on a PC, write the message to standard error with a timestamp added.
+#else
+
+    char timeStamp[26] = "";
+    char* timeStampPtr = timeStamp;
+
+    if ( (now != ((time_t)-1)) && (ctime_r(&now, timeStamp) != NULL) )
+    {
+        // Tue Jan 14 18:01:56 2014
+        // 0123456789012345678901234
+        timeStampPtr = timeStamp + 4; // Skip day of week.
+        timeStamp[19] = '\0';  // Exclude the year.
+    }
+
+    fprintf(stderr, "%s : %s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
+            timeStampPtr, levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr,
+            baseFileNamePtr, functionNamePtr, lineNumber, msgPtr);
+
+#endif
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Connects to the Log Control Daemon.  This must not be done until after the Messaging system
- * is initialized, but should be done as soon as possible.  Anything that gets logged before
- * this is called may get logged with settings that don't match what has been set using the
- * log control tool.
+ * Parses the conversion specification that starts at a given '%' in a format string.
+ *
+ * @return Pointer to the first character after the specification.  The specification's type is
+ *         ARG_UNSUPPORTED if it can't be captured for asynchronous logging.
  */
 //--------------------------------------------------------------------------------------------------
-void log_ConnectToControlDaemon
+static const char* ParseSpec
 (
-    void
+    const char* specStartPtr,           // Points to the '%'.
+    FormatSpec_t* specPtr               // [OUT] The parsed specification.
 )
 {
-    // NOTE: This is called when there is only one thread running, so no need to lock the mutex.
+    enum { LEN_NONE, LEN_HH, LEN_H, LEN_L, LEN_LL, LEN_J, LEN_Z, LEN_T, LEN_BIG_L } length;
+    const char* charPtr = specStartPtr + 1;
 
-    // Attempt to open an IPC session with the Log Control Daemon.
+    specPtr->type = ARG_UNSUPPORTED;
+    specPtr->numStars = 0;
+    specPtr->hasStarPrecision = false;
+    specPtr->precision = -1;
 
-    le_msg_ProtocolRef_t protocolRef;
-    protocolRef = le_msg_GetProtocolRef(LOG_CONTROL_PROTOCOL_ID, LOG_MAX_CMD_PACKET_BYTES);
-    IpcSessionRef = le_msg_CreateSession(protocolRef, LOG_CLIENT_SERVICE_NAME);
+    if (*charPtr == '%')
+    {
+        specPtr->type = ARG_NONE;
+        specPtr->len = 2;
+        return charPtr + 1;
+    }
 
-    // Note: the process's main thread will always run the log command message receive handler.
-    le_msg_SetSessionRecvHandler(IpcSessionRef, ProcessLogCmd, NULL);
+    // Positional arguments ("%2$d") can't be captured in order.
+    const char* digitPtr = charPtr;
+    while (isdigit((unsigned char)*digitPtr))
+    {
+        digitPtr++;
+    }
+    if (*digitPtr == '$')
+    {
+        specPtr->len = 0;
+        return digitPtr;
+    }
 
-    le_result_t result = le_msg_TryOpenSessionSync(IpcSessionRef);
-    if (result != LE_OK)
+    // Flags.
+    while ((*charPtr != '\0') && (strchr("-+ #0'I", *charPtr) != NULL))
     {
-        // If the Log Control Daemon isn't running, we just log a debug message and keep running
-        // anyway. This allows the use of liblegato for programs that need to start when the
-        // Log Control Daemon isn't running or isn't accessible.  For example, it allows tools
-        // like the "config" tool or "sdir" tool to still provide useful output to their user
-        // when they are run while the Legato framework is stopped.
+        charPtr++;
+    }
 
-        LE_DEBUG("Could not connect to log control daemon.");
+    // Field width.
+    if (*charPtr == '*')
+    {
+        specPtr->numStars++;
+        charPtr++;
+    }
+    else
+    {
+        while (isdigit((unsigned char)*charPtr))
+        {
+            charPtr++;
+        }
+    }
 
-        le_msg_DeleteSession(IpcSessionRef);
-        IpcSessionRef = NULL;
+    // Precision.
+    if (*charPtr == '.')
+    {
+        charPtr++;
 
-        switch (result)
+        if (*charPtr == '*')
+        {
+            specPtr->numStars++;
+            specPtr->hasStarPrecision = true;
+            charPtr++;
+        }
+        else
+        {
+            specPtr->precision = 0;
+            while (isdigit((unsigned char)*charPtr))
+            {
+                specPtr->precision = (specPtr->precision * 10) + (*charPtr - '0');
+                charPtr++;
+            }
+        }
+    }
+
+    // Length modifier.
+    switch (*charPtr)
+    {
+        case 'h':
+            charPtr++;
+            length = LEN_H;
+            if (*charPtr == 'h')
+            {
+                charPtr++;
+                length = LEN_HH;
+            }
+            break;
+
+        case 'l':
+            charPtr++;
+            length = LEN_L;
+            if (*charPtr == 'l')
+            {
+                charPtr++;
+                length = LEN_LL;
+            }
+            break;
+
+        case 'q':
+            charPtr++;
+            length = LEN_LL;
+            break;
+
+        case 'j':
+            charPtr++;
+            length = LEN_J;
+            break;
+
+        case 'z':
+        case 'Z':
+            charPtr++;
+            length = LEN_Z;
+            break;
+
+        case 't':
+            charPtr++;
+            length = LEN_T;
+            break;
+
+        case 'L':
+            charPtr++;
+            length = LEN_BIG_L;
+            break;
+
+        default:
+            length = LEN_NONE;
+            break;
+    }
+
+    // Conversion.
+    char conversion = *charPtr;
+    if (conversion == '\0')
+    {
+        specPtr->len = 0;
+        return charPtr;
+    }
+    charPtr++;
+
+    switch (conversion)
+    {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            switch (length)
+            {
+                case LEN_NONE:
+                case LEN_HH:
+                case LEN_H:
+                    specPtr->type = ARG_INT;
+                    break;
+                case LEN_L:
+                    specPtr->type = ARG_LONG;
+                    break;
+                case LEN_LL:
+                    specPtr->type = ARG_LLONG;
+                    break;
+                case LEN_J:
+                    specPtr->type = ARG_INTMAX;
+                    break;
+                case LEN_Z:
+                    specPtr->type = ARG_SIZE;
+                    break;
+                case LEN_T:
+                    specPtr->type = ARG_PTRDIFF;
+                    break;
+                case LEN_BIG_L:
+                    break;
+            }
+            break;
+
+        case 'c':
+            if (length == LEN_NONE)
+            {
+                specPtr->type = ARG_INT;
+            }
+            break;
+
+        case 's':
+            if (length == LEN_NONE)
+            {
+                specPtr->type = ARG_STR;
+            }
+            break;
+
+        case 'p':
+            if (length == LEN_NONE)
+            {
+                specPtr->type = ARG_PTR;
+            }
+            break;
+
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            if ((length == LEN_NONE) || (length == LEN_L))
+            {
+                specPtr->type = ARG_DOUBLE;
+            }
+            else if (length == LEN_BIG_L)
+            {
+                specPtr->type = ARG_LDOUBLE;
+            }
+            break;
+
+        case 'm':
+            if (length == LEN_NONE)
+            {
+                specPtr->type = ARG_NONE;
+            }
+            break;
+
+        default:
+            // Includes %n, which must never be deferred.
+            break;
+    }
+
+    specPtr->len = charPtr - specStartPtr;
+    if (specPtr->len >= MAX_SPEC_SIZE)
+    {
+        specPtr->type = ARG_UNSUPPORTED;
+    }
+
+    return charPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Appends a value to a record's captured arguments.
+ *
+ * @return true if successful, false if the record is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool PutArg
+(
+    AsyncRecord_t* recPtr,
+    size_t* offsetPtr,                  // [IN/OUT] Where to put the value in the record's data.
+    const void* valuePtr,
+    size_t size
+)
+{
+    if (size > (sizeof(recPtr->data) - *offsetPtr))
+    {
+        return false;
+    }
+
+    memcpy(recPtr->data + *offsetPtr, valuePtr, size);
+    *offsetPtr += size;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Captures the arguments of a message into a record, according to its format string.
+ *
+ * @return true if successful, false if the message must be formatted by the caller instead.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CaptureArgs
+(
+    AsyncRecord_t* recPtr,
+    const char* formatPtr,
+    va_list* varParamsPtr
+)
+{
+    size_t offset = 0;
+    const char* charPtr = formatPtr;
+
+    // The format string may not outlive the call either.
+    if (!PutArg(recPtr, &offset, formatPtr, strlen(formatPtr) + 1))
+    {
+        return false;
+    }
+
+#define PUT_ARG(type)                                                       \
+    do {                                                                    \
+        type value = va_arg(*varParamsPtr, type);                           \
+        if (!PutArg(recPtr, &offset, &value, sizeof(value))) return false;  \
+    } while (0)
+
+    while ((charPtr = strchr(charPtr, '%')) != NULL)
+    {
+        FormatSpec_t spec;
+        int i;
+
+        charPtr = ParseSpec(charPtr, &spec);
+
+        // The precision given by '*' limits how much of a string is read.
+        for (i = 0; i < spec.numStars; i++)
+        {
+            int star = va_arg(*varParamsPtr, int);
+            if (!PutArg(recPtr, &offset, &star, sizeof(star)))
+            {
+                return false;
+            }
+            if (spec.hasStarPrecision && (i == spec.numStars - 1))
+            {
+                spec.precision = (star < 0) ? -1 : star;
+            }
+        }
+
+        switch (spec.type)
+        {
+            case ARG_NONE:
+                break;
+
+            case ARG_INT:
+                PUT_ARG(int);
+                break;
+
+            case ARG_LONG:
+                PUT_ARG(long);
+                break;
+
+            case ARG_LLONG:
+                PUT_ARG(long long);
+                break;
+
+            case ARG_INTMAX:
+                PUT_ARG(intmax_t);
+                break;
+
+            case ARG_SIZE:
+                PUT_ARG(size_t);
+                break;
+
+            case ARG_PTRDIFF:
+                PUT_ARG(ptrdiff_t);
+                break;
+
+            case ARG_DOUBLE:
+                PUT_ARG(double);
+                break;
+
+            case ARG_LDOUBLE:
+                PUT_ARG(long double);
+                break;
+
+            case ARG_PTR:
+                PUT_ARG(void*);
+                break;
+
+            case ARG_STR:
+            {
+                // Strings are copied, with a length prefix (UINT16_MAX for NULL).
+                const char* strPtr = va_arg(*varParamsPtr, const char*);
+                uint16_t len = UINT16_MAX;
+
+                if (strPtr != NULL)
+                {
+                    size_t strLen = (spec.precision >= 0) ? strnlen(strPtr, spec.precision)
+                                                          : strlen(strPtr);
+                    if (strLen >= sizeof(recPtr->data))
+                    {
+                        return false;
+                    }
+                    len = strLen;
+                }
+
+                if (!PutArg(recPtr, &offset, &len, sizeof(len)))
+                {
+                    return false;
+                }
+
+                if (strPtr != NULL)
+                {
+                    if (!PutArg(recPtr, &offset, strPtr, len) || !PutArg(recPtr, &offset, "", 1))
+                    {
+                        return false;
+                    }
+                }
+                break;
+            }
+
+            case ARG_UNSUPPORTED:
+                return false;
+        }
+    }
+
+#undef PUT_ARG
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Formats a message from the arguments captured in a record.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatRecord
+(
+    const AsyncRecord_t* recPtr,
+    char* msgPtr,                       // [OUT] Buffer to put the message into.
+    size_t msgSize                      // Size of the buffer.
+)
+{
+    const char* charPtr = (const char*)recPtr->data;
+    size_t offset = strlen(charPtr) + 1;
+    size_t used = 0;
+
+    while (used < msgSize - 1)
+    {
+        // Copy the literal text up to the next conversion specification.
+        const char* specStartPtr = strchr(charPtr, '%');
+        size_t literalLen = (specStartPtr != NULL) ? (size_t)(specStartPtr - charPtr)
+                                                   : strlen(charPtr);
+        if (literalLen > msgSize - 1 - used)
+        {
+            literalLen = msgSize - 1 - used;
+        }
+        memcpy(msgPtr + used, charPtr, literalLen);
+        used += literalLen;
+
+        if ((specStartPtr == NULL) || (used >= msgSize - 1))
+        {
+            break;
+        }
+
+        // Format the conversion on its own, with the value captured for it.
+        FormatSpec_t spec;
+        char specStr[MAX_SPEC_SIZE];
+        int stars[2] = { 0, 0 };
+        int i;
+        int n = 0;
+
+        charPtr = ParseSpec(specStartPtr, &spec);
+        memcpy(specStr, specStartPtr, spec.len);
+        specStr[spec.len] = '\0';
+
+        for (i = 0; i < spec.numStars; i++)
+        {
+            memcpy(&stars[i], recPtr->data + offset, sizeof(int));
+            offset += sizeof(int);
+        }
+
+        char* outPtr = msgPtr + used;
+        size_t outSize = msgSize - used;
+
+#define FORMAT_ARG(value)                                                               \
+        do {                                                                            \
+            switch (spec.numStars)                                                      \
+            {                                                                           \
+                case 0: n = snprintf(outPtr, outSize, specStr, value); break;           \
+                case 1: n = snprintf(outPtr, outSize, specStr, stars[0], value); break; \
+                default:                                                                \
+                    n = snprintf(outPtr, outSize, specStr, stars[0], stars[1], value);  \
+                    break;                                                              \
+            }                                                                           \
+        } while (0)
+
+#define GET_AND_FORMAT_ARG(type)                                    \
+        do {                                                        \
+            type value;                                             \
+            memcpy(&value, recPtr->data + offset, sizeof(value));   \
+            offset += sizeof(value);                                \
+            FORMAT_ARG(value);                                      \
+        } while (0)
+
+        switch (spec.type)
+        {
+            case ARG_NONE:
+                // %m needs errno as it was when the message was logged.
+                errno = recPtr->savedErrno;
+                FORMAT_ARG(0);
+                break;
+
+            case ARG_INT:
+                GET_AND_FORMAT_ARG(int);
+                break;
+
+            case ARG_LONG:
+                GET_AND_FORMAT_ARG(long);
+                break;
+
+            case ARG_LLONG:
+                GET_AND_FORMAT_ARG(long long);
+                break;
+
+            case ARG_INTMAX:
+                GET_AND_FORMAT_ARG(intmax_t);
+                break;
+
+            case ARG_SIZE:
+                GET_AND_FORMAT_ARG(size_t);
+                break;
+
+            case ARG_PTRDIFF:
+                GET_AND_FORMAT_ARG(ptrdiff_t);
+                break;
+
+            case ARG_DOUBLE:
+                GET_AND_FORMAT_ARG(double);
+                break;
+
+            case ARG_LDOUBLE:
+                GET_AND_FORMAT_ARG(long double);
+                break;
+
+            case ARG_PTR:
+                GET_AND_FORMAT_ARG(void*);
+                break;
+
+            case ARG_STR:
+            {
+                uint16_t len;
+                const char* strPtr = NULL;
+
+                memcpy(&len, recPtr->data + offset, sizeof(len));
+                offset += sizeof(len);
+
+                if (len != UINT16_MAX)
+                {
+                    strPtr = (const char*)(recPtr->data + offset);
+                    offset += len + 1;
+                }
+
+                FORMAT_ARG(strPtr);
+                break;
+            }
+
+            case ARG_UNSUPPORTED:
+                // Can't happen, because the record wouldn't have been captured.
+                break;
+        }
+
+#undef GET_AND_FORMAT_ARG
+#undef FORMAT_ARG
+
+        if (n < 0)
+        {
+            break;
+        }
+        used += ((size_t)n < outSize) ? (size_t)n : (outSize - 1);
+    }
+
+    msgPtr[used] = '\0';
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empties the ring and resets the dropped message counts.
+ *
+ * @warning Must only be called when nothing else can be using the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetRing
+(
+    void
+)
+{
+    uint32_t i;
+
+    for (i = 0; i < ASYNC_RING_SLOTS; i++)
+    {
+        AsyncRing[i].sequence = i;
+    }
+
+    EnqueuePos = 0;
+    DequeuePos = 0;
+    DroppedCount = 0;
+    ReportedDropCount = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes out a record that has been taken off the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteRecord
+(
+    const AsyncRecord_t* recPtr
+)
+{
+    char msg[MAX_MSG_SIZE];
+    const char* msgPtr = (const char*)recPtr->data;
+
+    if (!recPtr->isFormatted)
+    {
+        FormatRecord(recPtr, msg, sizeof(msg));
+        msgPtr = msg;
+    }
+
+    WriteMsg(recPtr->level, recPtr->levelPtr, recPtr->compNamePtr, recPtr->threadName,
+             recPtr->baseFileName, recPtr->functionName, recPtr->lineNumber, recPtr->time,
+             msgPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes out a message reporting the number of messages that have been dropped since the last
+ * report, if any.
+ *
+ * @warning Assumes that the DrainMutex is held by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportDrops
+(
+    void
+)
+{
+    uint32_t droppedCount = __atomic_load_n(&DroppedCount, __ATOMIC_RELAXED);
+
+    if (droppedCount != ReportedDropCount)
+    {
+        char msg[MAX_MSG_SIZE];
+
+        snprintf(msg, sizeof(msg), "%" PRIu32 " log messages dropped (%" PRIu32 " in total).",
+                 droppedCount - ReportedDropCount, droppedCount);
+        ReportedDropCount = droppedCount;
+
+        WriteMsg(LE_LOG_WARN, SeverityStr[LE_LOG_WARN], STRINGIZE(LE_COMPONENT_NAME), "LogDrain",
+                 le_path_GetBasenamePtr(__FILE__, "/"), __func__, __LINE__, time(NULL), msg);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes the next record off the ring and writes it out.
+ *
+ * @return true if a record was written, false if the ring was empty.
+ *
+ * @warning Assumes that the DrainMutex is held by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool DrainOne
+(
+    void
+)
+{
+    AsyncRecord_t* recPtr = &AsyncRing[DequeuePos & (ASYNC_RING_SLOTS - 1)];
+
+    // The producer sets the slot's sequence number to one past its position once it has
+    // finished writing the record.
+    if (__atomic_load_n(&recPtr->sequence, __ATOMIC_ACQUIRE) != DequeuePos + 1)
+    {
+        return false;
+    }
+
+    ReportDrops();
+    WriteRecord(recPtr);
+
+    // Hand the slot back to the producers for use on their next lap around the ring.
+    __atomic_store_n(&recPtr->sequence, DequeuePos + ASYNC_RING_SLOTS, __ATOMIC_RELEASE);
+    __atomic_store_n(&DequeuePos, DequeuePos + 1, __ATOMIC_RELAXED);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes out everything on the ring, so that a message can be written synchronously without
+ * getting ahead of the ones that were logged before it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushRing
+(
+    bool isUrgent                       // true = don't wait forever for the drain thread (the
+                                        // caller may be about to kill the process, or even be
+                                        // running in a signal handler).
+)
+{
+    // The ring is empty (and maybe not initialized) until the drain thread is started.
+    if (!__atomic_load_n(&DrainThreadStarted, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    if (isUrgent)
+    {
+        struct timespec deadline;
+
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += FLUSH_TIMEOUT_SECS;
+
+        if (pthread_mutex_timedlock(&DrainMutex, &deadline) != 0)
+        {
+            return;
+        }
+    }
+    else
+    {
+        LE_ASSERT(pthread_mutex_lock(&DrainMutex) == 0);
+    }
+
+    while (DrainOne())
+    {
+    }
+    ReportDrops();
+
+    pthread_mutex_unlock(&DrainMutex);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flushes the ring when the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushRingAtExit
+(
+    void
+)
+{
+    FlushRing(true);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the drain thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* DrainThreadMain
+(
+    void* contextPtr
+)
+{
+    bool hasDozed = false;
+
+    for (;;)
+    {
+        LE_ASSERT(pthread_mutex_lock(&DrainMutex) == 0);
+
+        bool drained = DrainOne();
+
+        if (!drained)
+        {
+            // Tell the producers that we are going to doze (or sleep), then check again, in case a
+            // record was published before they could see the new state.  If a producer wakes us
+            // up anyway, that just causes one extra pass through this loop.
+            __atomic_store_n(&DrainState, hasDozed ? DRAIN_ASLEEP : DRAIN_DOZING, __ATOMIC_SEQ_CST);
+
+            const AsyncRecord_t* recPtr = &AsyncRing[DequeuePos & (ASYNC_RING_SLOTS - 1)];
+            if (__atomic_load_n(&recPtr->sequence, __ATOMIC_SEQ_CST) == DequeuePos + 1)
+            {
+                __atomic_store_n(&DrainState, DRAIN_AWAKE, __ATOMIC_RELAXED);
+                drained = true;
+            }
+        }
+
+        // Release the mutex between records so that callers flushing the ring don't have to wait
+        // for the whole ring to be written out.
+        pthread_mutex_unlock(&DrainMutex);
+
+        if (drained)
+        {
+            hasDozed = false;
+        }
+        else if (!hasDozed)
+        {
+            struct timespec deadline;
+
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += DRAIN_DOZE_MS * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L)
+            {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+
+            while ((sem_timedwait(&DrainSem, &deadline) != 0) && (errno == EINTR))
+            {
+            }
+
+            hasDozed = true;
+            __atomic_store_n(&DrainState, DRAIN_AWAKE, __ATOMIC_RELAXED);
+        }
+        else
+        {
+            while ((sem_wait(&DrainSem) != 0) && (errno == EINTR))
+            {
+            }
+
+            hasDozed = false;
+            __atomic_store_n(&DrainState, DRAIN_AWAKE, __ATOMIC_RELAXED);
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts the drain thread, if it isn't running already.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartDrainThread
+(
+    void
+)
+{
+    LE_ASSERT(pthread_mutex_lock(&DrainMutex) == 0);
+
+    if (!DrainThreadStarted)
+    {
+        pthread_t thread;
+        pthread_attr_t attr;
+        sigset_t allSignals;
+        sigset_t oldSignals;
+
+        // The drain thread must not receive signals, because the Legato signal event handling
+        // relies on them staying blocked until they are read from a signalfd.
+        sigfillset(&allSignals);
+        pthread_sigmask(SIG_SETMASK, &allSignals, &oldSignals);
+
+        // Nothing uses the ring until the drain thread is started.
+        ResetRing();
+
+        LE_ASSERT(pthread_attr_init(&attr) == 0);
+        LE_ASSERT(pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) == 0);
+        int result = pthread_create(&thread, &attr, DrainThreadMain, NULL);
+        pthread_attr_destroy(&attr);
+
+        pthread_sigmask(SIG_SETMASK, &oldSignals, NULL);
+
+        if (result == 0)
+        {
+            pthread_setname_np(thread, "LogDrain");
+            atexit(FlushRingAtExit);
+            __atomic_store_n(&DrainThreadStarted, true, __ATOMIC_RELEASE);
+        }
+        else
+        {
+            // Can't log about this, so just fall back to synchronous logging.
+            AsyncEnabled = false;
+        }
+    }
+
+    pthread_mutex_unlock(&DrainMutex);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queues a message on the ring for the drain thread.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NO_MEMORY if the ring is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t QueueRecord
+(
+    le_log_Level_t level,
+    const char* levelPtr,
+    const char* compNamePtr,
+    const char* baseFileNamePtr,
+    const char* functionNamePtr,
+    unsigned int lineNumber,
+    int savedErrno,
+    const char* formatPtr,
+    va_list* varParamsPtr
+)
+{
+    if (!__atomic_load_n(&DrainThreadStarted, __ATOMIC_ACQUIRE))
+    {
+        StartDrainThread();
+
+        if (!__atomic_load_n(&DrainThreadStarted, __ATOMIC_ACQUIRE))
+        {
+            return LE_NOT_POSSIBLE;
+        }
+    }
+
+    // Claim a slot.  A slot is free for position pos when its sequence number is pos, and holds
+    // a record for the consumer when its sequence number is pos + 1.
+    uint32_t pos = __atomic_load_n(&EnqueuePos, __ATOMIC_RELAXED);
+    AsyncRecord_t* recPtr;
+
+    for (;;)
+    {
+        recPtr = &AsyncRing[pos & (ASYNC_RING_SLOTS - 1)];
+        int32_t diff = (int32_t)(__atomic_load_n(&recPtr->sequence, __ATOMIC_ACQUIRE) - pos);
+
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n(&EnqueuePos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return LE_NO_MEMORY;
+        }
+        else
+        {
+            pos = __atomic_load_n(&EnqueuePos, __ATOMIC_RELAXED);
+        }
+    }
+
+    recPtr->level = level;
+    recPtr->levelPtr = levelPtr;
+    recPtr->compNamePtr = compNamePtr;
+    le_utf8_Copy(recPtr->baseFileName, baseFileNamePtr, sizeof(recPtr->baseFileName), NULL);
+    le_utf8_Copy(recPtr->functionName,
+                 (functionNamePtr != NULL) ? functionNamePtr : "(null)",
+                 sizeof(recPtr->functionName),
+                 NULL);
+    recPtr->lineNumber = lineNumber;
+    recPtr->savedErrno = savedErrno;
+    recPtr->time = time(NULL);
+    le_utf8_Copy(recPtr->threadName, le_thread_GetMyName(), sizeof(recPtr->threadName), NULL);
+
+    va_list varParams;
+    va_copy(varParams, *varParamsPtr);
+    recPtr->isFormatted = !CaptureArgs(recPtr, formatPtr, &varParams);
+    va_end(varParams);
+
+    if (recPtr->isFormatted)
+    {
+        errno = savedErrno;
+        vsnprintf((char*)recPtr->data, sizeof(recPtr->data), formatPtr, *varParamsPtr);
+    }
+
+    // Publish the record, then wake up the drain thread if it went to sleep, or if it is dozing
+    // and the ring is getting full.
+    __atomic_store_n(&recPtr->sequence, pos + 1, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    DrainState_t state = __atomic_load_n(&DrainState, __ATOMIC_RELAXED);
+
+    if (state == DRAIN_ASLEEP)
+    {
+        if (__atomic_exchange_n(&DrainState, DRAIN_AWAKE, __ATOMIC_RELAXED) == DRAIN_ASLEEP)
+        {
+            sem_post(&DrainSem);
+        }
+    }
+    else if ( (state == DRAIN_DOZING)
+           && ((pos + 1 - __atomic_load_n(&DequeuePos, __ATOMIC_RELAXED)) >= ASYNC_RING_SLOTS / 2)
+           && __atomic_compare_exchange_n(&DrainState, &state, DRAIN_AWAKE, false,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED) )
+    {
+        sem_post(&DrainSem);
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called in the child process after a fork().  The drain thread doesn't exist in the child, and
+ * the records on the ring belong to the parent, so the child logs synchronously.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AfterForkInChild
+(
+    void
+)
+{
+    AsyncEnabled = false;
+    DrainThreadStarted = false;
+    DrainState = DRAIN_AWAKE;
+
+    pthread_mutex_init(&DrainMutex, NULL);
+    sem_destroy(&DrainSem);
+    sem_init(&DrainSem, 0, 0);
+
+    // The ring is reset if the child starts its own drain thread.
+    DroppedCount = 0;
+    ReportedDropCount = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the logging system.
+ */
+//--------------------------------------------------------------------------------------------------
+void log_Init
+(
+    void
+)
+{
+    // NOTE: This is called when there is only one thread running, so no need to lock the mutex.
+
+    // Load the default log level filter and output destination settings from the environment.
+    ReadLevelFromEnv();
+
+    // Create the keyword memory pool.
+    KeywordMemPool = le_mem_CreatePool("TraceKeys", sizeof(KeywordObj_t));
+    le_mem_ExpandPool(KeywordMemPool, 10);   /// @todo Make this configurable.
+
+    // Create the session memory pool.
+    SessionMemPool = le_mem_CreatePool("LogSession", sizeof(LogSession_t));
+    le_mem_ExpandPool(SessionMemPool, 10);  /// @todo Make this configurable.
+
+    // Register the framework as a component.
+    LE_LOG_SESSION = log_RegComponent(STRINGIZE(LE_COMPONENT_NAME), &LE_LOG_LEVEL_FILTER_PTR);
+
+    // Load the default list of enabled trace keywords from the environment.
+    ReadTraceKeywordsFromEnv();
+
+    // Get a reference to the trace keyword that is used to control tracing in this module.
+    TraceRef = le_log_GetTraceRef("logControl");
+
+    // Set the syslog format.
+    openlog("Legato", 0, LOG_USER);
+
+    // Prepare for asynchronous logging, in case it gets used.  The ring itself is initialized when
+    // the drain thread is started.
+    LE_ASSERT(sem_init(&DrainSem, 0, 0) == 0);
+    LE_ASSERT(pthread_atfork(NULL, NULL, AfterForkInChild) == 0);
+
+    // Switch to asynchronous logging, if requested by the environment.
+    ReadAsyncFromEnv();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Re-Initialize the logging system.
+ */
+//--------------------------------------------------------------------------------------------------
+void log_ReInit
+(
+    void
+)
+{
+    closelog();
+    openlog("Legato", 0, LOG_USER);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connects to the Log Control Daemon.  This must not be done until after the Messaging system
+ * is initialized, but should be done as soon as possible.  Anything that gets logged before
+ * this is called may get logged with settings that don't match what has been set using the
+ * log control tool.
+ */
+//--------------------------------------------------------------------------------------------------
+void log_ConnectToControlDaemon
+(
+    void
+)
+{
+    // NOTE: This is called when there is only one thread running, so no need to lock the mutex.
+
+    // Attempt to open an IPC session with the Log Control Daemon.
+
+    le_msg_ProtocolRef_t protocolRef;
+    protocolRef = le_msg_GetProtocolRef(LOG_CONTROL_PROTOCOL_ID, LOG_MAX_CMD_PACKET_BYTES);
+    IpcSessionRef = le_msg_CreateSession(protocolRef, LOG_CLIENT_SERVICE_NAME);
+
+    // Note: the process's main thread will always run the log command message receive handler.
+    le_msg_SetSessionRecvHandler(IpcSessionRef, ProcessLogCmd, NULL);
+
+    le_result_t result = le_msg_TryOpenSessionSync(IpcSessionRef);
+    if (result != LE_OK)
+    {
+        // If the Log Control Daemon isn't running, we just log a debug message and keep running
+        // anyway. This allows the use of liblegato for programs that need to start when the
+        // Log Control Daemon isn't running or isn't accessible.  For example, it allows tools
+        // like the "config" tool or "sdir" tool to still provide useful output to their user
+        // when they are run while the Legato framework is stopped.
+
+        LE_DEBUG("Could not connect to log control daemon.");
+
+        le_msg_DeleteSession(IpcSessionRef);
+        IpcSessionRef = NULL;
+
+        switch (result)
         {
             case LE_UNAVAILABLE:
                 LE_DEBUG("Service not offered by Log Control Daemon."
@@ -978,45 +2313,6 @@ const char* log_SeverityLevelToStr
 }
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Converts the legato log levels to the syslog priority levels.
- *
- * @return
- *      Syslog priority level.
- */
-//--------------------------------------------------------------------------------------------------
-#ifdef LEGATO_EMBEDDED
-
-static int ConvertToSyslogLevel
-(
-    le_log_Level_t legatoLevel
-)
-{
-    switch (legatoLevel)
-    {
-        case LE_LOG_DEBUG:
-            return LOG_DEBUG;
-
-        case LE_LOG_INFO:
-            return LOG_INFO;
-
-        case LE_LOG_WARN:
-            return LOG_WARNING;
-
-        case LE_LOG_ERR:
-            return LOG_ERR;
-
-        case LE_LOG_CRIT:
-            return LOG_CRIT;
-
-        default:
-            return LOG_EMERG;
-    }
-}
-#endif
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Builds the log message and sends it to the logging system.
@@ -1077,22 +2373,36 @@ void _le_log_Send
     // Get the file name.
     char* baseFileNamePtr = le_path_GetBasenamePtr((char*)filenamePtr, "/");
 
-    // Get the thread name.
-    const char* threadNamePtr = le_thread_GetMyName();
+    va_list varParams;
+    va_start(varParams, formatPtr);
 
-    // Get the process name.
-    const char* procNamePtr = le_arg_GetProgramName();
-    if (procNamePtr == NULL)
+    if (__atomic_load_n(&AsyncEnabled, __ATOMIC_RELAXED))
     {
-        procNamePtr = "n/a";
+        if ((level == LE_LOG_CRIT) || (level == LE_LOG_EMERG))
+        {
+            FlushRing(true);
+        }
+        else if (QueueRecord(level, levelPtr, compNamePtr, baseFileNamePtr, functionNamePtr,
+                             lineNumber, savedErrno, formatPtr, &varParams) == LE_OK)
+        {
+            va_end(varParams);
+            return;
+        }
+        else if ((level == LE_LOG_WARN) || (level == LE_LOG_ERR))
+        {
+            FlushRing(false);
+        }
+        else if (__atomic_load_n(&DrainThreadStarted, __ATOMIC_RELAXED))
+        {
+            __atomic_add_fetch(&DroppedCount, 1, __ATOMIC_RELAXED);
+            va_end(varParams);
+            return;
+        }
     }
 
     // Get the user message.
     char msg[MAX_MSG_SIZE] = "";
 
-    va_list varParams;
-    va_start(varParams, formatPtr);
-
     // Reset the errno to ensure that we report the proper errno value.
     errno = savedErrno;
 
@@ -1102,33 +2412,8 @@ void _le_log_Send
 
     va_end(varParams);
 
-    // If running on an embedded target, write the message out to the log.
-#ifdef LEGATO_EMBEDDED
-
-    syslog(ConvertToSyslogLevel(level), "%s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
-           levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr, baseFileNamePtr,
-           functionNamePtr, lineNumber, msg);
-
-    // If running on a PC, write the message to standard error with a timestamp added.
-#else
-
-    time_t now;
-    char timeStamp[26] = "";
-    char* timeStampPtr = timeStamp;
-
-    if ( (time(&now) != ((time_t)-1)) && (ctime_r(&now, timeStamp) != NULL) )
-    {
-        // Tue Jan 14 18:01:56 2014
-        // 0123456789012345678901234
-        timeStampPtr = timeStamp + 4; // Skip day of week.
-        timeStamp[19] = '\0';  // Exclude the year.
-    }
-
-    fprintf(stderr, "%s : %s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
-            timeStampPtr, levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr,
-            baseFileNamePtr, functionNamePtr, lineNumber, msg);
-
-#endif
+    WriteMsg(level, levelPtr, compNamePtr, le_thread_GetMyName(), baseFileNamePtr,
+             functionNamePtr, lineNumber, time(NULL), msg);
 }
 
 
@@ -1351,6 +2636,12 @@ void log_LogGenericMsg
     const char* msgPtr          ///< [IN] Message.
 )
 {
+    // Don't get ahead of messages that are still waiting to be written out.
+    if (__atomic_load_n(&AsyncEnabled, __ATOMIC_RELAXED))
+    {
+        FlushRing(false);
+    }
+
     // Write the message out to the log.
 #ifdef LEGATO_EMBEDDED
 
@@ -1379,3 +2670,39 @@ void log_LogGenericMsg
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Switches the calling process between synchronous and asynchronous logging (see @ref log_async).
+ * Messages that are still waiting to be written out are flushed when switching to synchronous
+ * logging.
+ */
+//--------------------------------------------------------------------------------------------------
+void log_SetAsync
+(
+    bool isAsync                ///< [IN] true = asynchronous, false = synchronous.
+)
+{
+    __atomic_store_n(&AsyncEnabled, isAsync, __ATOMIC_RELAXED);
+
+    if (!isAsync)
+    {
+        FlushRing(false);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of messages that the calling process has dropped because asynchronous logging
+ * couldn't keep up.
+ *
+ * @return The number of messages dropped since the process started.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t log_GetDroppedCount
+(
+    void
+)
+{
+    return __atomic_load_n(&DroppedCount, __ATOMIC_RELAXED);
+}
@@ -33,11 +33,42 @@
  * GUARD BANDS
  * ===========
  *
- * A debugging feature can be enabled at compile-time by defining the macro "USE_GUARD_BAND".
- * This inserts chunks of memory into each memory block both before and after the user object
- * part.  These chunks of memory, called "guard bands", are filled with a special pattern that
- * is unlikely to occur in normal data.  Whenever a block is allocated or released, the
- * guard bands are checked for corruption and any corruption is reported.
+ * By default, chunks of memory are inserted into each memory block both before the block header
+ * and after the user object part.  These chunks of memory, called "guard bands", are filled with a
+ * special pattern that is unlikely to occur in normal data.  Whenever a block is allocated or
+ * released, the guard bands are checked for corruption and any corruption is reported.
+ *
+ * If the framework is built with LE_MEM_CHECKS_DISABLE defined (see le_build_config.h), the guard
+ * bands are left out of every pool's blocks except those of pools that opt back in using
+ * le_mem_EnableChecks().  Because the leading guard band sits in front of the block header, the
+ * header is always found right in front of the user object, whether or not the pool has guard
+ * bands.
+ *
+ * THREAD CACHES
+ * =============
+ *
+ * To keep threads from serializing on the module's mutex, each thread keeps a small cache of free
+ * blocks for the last few pools it has used.  Allocations are served from the calling thread's
+ * cache and releases are pushed back onto it without taking the mutex.  Blocks are moved between a
+ * thread's cache and its pool's shared free list in batches, with the mutex held.  If a pool's
+ * shared free list runs dry, the cached blocks of all threads are pulled back into it before the
+ * allocation is allowed to fail (or the pool to grow), so caching never changes how many objects
+ * can be allocated from a pool.
+ *
+ * The cached blocks form a lock-free stack that is only pushed and popped by its owner thread.
+ * Other threads only ever take the whole stack at once (with the mutex held), so the stack can't
+ * suffer from the ABA problem.  The owner also pops by taking the whole stack and putting back the
+ * rest, so it never reads the link of a block that another thread may have reclaimed.  Sub-pools
+ * are never cached, because deleting a sub-pool requires all of its blocks to be on its own free
+ * list.
+ *
+ * Cached blocks are not in use, so they are counted as free in the pool statistics (and by the
+ * Inspect tool), but they are not on the pool's shared free list.  Any code that walks or moves
+ * the blocks of a pool's free list must first pull the cached blocks back with
+ * ReclaimCachedBlocks().
+ *
+ * Pool statistics and block reference counts are updated atomically so that they don't need the
+ * mutex either.
  *
  * Copyright (C) Sierra Wireless Inc.
  *
@@ -46,18 +77,11 @@
 #include "mem.h"
 #include "limit.h"
 
-#define USE_GUARD_BAND
-#define FILL_DELETED_AND_CHECK_ALLOCATED
-
 #define NUM_GUARD_BAND_WORDS 8
 #define GUARD_WORD ((uint32_t)0xDEADBEEF)
 #define GUARD_BAND_SIZE (sizeof(GUARD_WORD) * NUM_GUARD_BAND_WORDS)
 
 
-/// The maximum total pool name size, including the component prefix, which is a component
-/// name plus a '.' separator ("myComp.myPool") and the null terminator.
-#define MAX_POOL_NAME_BYTES (LIMIT_MAX_COMPONENT_NAME_LEN + 1 + LIMIT_MAX_MEM_POOL_NAME_BYTES)
-
 /// The default number of Sub Pool objects in the Sub Pools Pool.
 /// @todo Make this configurable.
 #define DEFAULT_SUB_POOLS_POOL_SIZE     8
@@ -71,6 +95,31 @@
 #define DEFAULT_NUM_BLOCKS_TO_FORCE     1
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The number of pools for which a thread can cache free blocks at the same time.
+ */
+//--------------------------------------------------------------------------------------------------
+#define THREAD_CACHE_NUM_SLOTS          8
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The number of free blocks a thread can cache for a pool before returning some of them to the
+ * pool's shared free list.
+ */
+//--------------------------------------------------------------------------------------------------
+#define THREAD_CACHE_MAX_BLOCKS         32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The number of blocks moved at a time between a pool's shared free list and a thread's cache.
+ */
+//--------------------------------------------------------------------------------------------------
+#define THREAD_CACHE_BATCH_SIZE         16
+
+
 #ifdef LE_MEM_TRACE
     #undef le_mem_TryAlloc
     #undef le_mem_AssertAlloc
@@ -103,12 +152,43 @@ typedef struct
     size_t refCount;            ///< The number of external references to this memory block's
                                 ///     user object. (0 = free)
 
-    uint8_t  data[];            ///< This block's data content (Has a guard band at the
-                                ///     start and end if USE_GUARD_BAND is defined).
+    uint8_t  data[];            ///< This block's data content (Followed by a guard band if
+                                ///     the pool's checks are enabled).
 }
 MemBlock_t;
 
 
+#ifndef LE_MEM_VALGRIND
+//--------------------------------------------------------------------------------------------------
+/**
+ * A thread's cache of free blocks for one memory pool.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t link;         ///< Link in the pool's list of thread caches (protected by Mutex).
+    MemPool_t* poolPtr;         ///< The pool the cached blocks belong to (NULL if slot unused).
+    le_sls_Link_t* headPtr;     ///< Top of the stack of cached blocks.  Only accessed atomically.
+    size_t numBlocks;           ///< Number of blocks pushed since the cache was last emptied.
+                                ///  Only accessed by the owner thread.
+}
+ThreadCacheSlot_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A thread's block caches.  Stored in thread-local storage.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    ThreadCacheSlot_t slot[THREAD_CACHE_NUM_SLOTS]; ///< Caches for the most recently used pools.
+    size_t nextVictim;                              ///< Index of the next slot to re-assign.
+}
+ThreadCache_t;
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Local list of all memory pools created with le_mem_CreatePool and le_mem_CreateSubPool
@@ -143,6 +223,25 @@ static le_mem_PoolRef_t SubPoolsPool;
 static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;
 
 
+#ifndef LE_MEM_VALGRIND
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key used to store a pointer to each thread's ThreadCache_t in thread-local storage.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_key_t ThreadCacheKey;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true once the thread cache key has been created by mem_Init().  Until then, all allocations
+ * go directly to the pools' shared free lists.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ThreadCacheEnabled = false;
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Exposing the memory pool list; mainly for the Inspect tool.
@@ -199,87 +298,509 @@ static inline void Unlock
 }
 
 
-#ifdef USE_GUARD_BAND
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the guard bands around a memory block, if its pool has checks enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitGuardBands
+(
+    MemBlock_t* blockHeaderPtr  // Pointer to the per-block overhead area of the memory block.
+)
+{
+    if (!blockHeaderPtr->poolPtr->checksEnabled)
+    {
+        return;
+    }
+
+    int i;
+
+    // There's a guard band in front of the block header.
+    uint32_t* guardBandWordPtr = (uint32_t*)(((uint8_t*)blockHeaderPtr) - GUARD_BAND_SIZE);
+    for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
+    {
+        *guardBandWordPtr = GUARD_WORD;
+    }
+
+    // There's another guard band at the end of the data section.
+    guardBandWordPtr = (uint32_t*)(   ((uint8_t*)blockHeaderPtr)
+                                    + blockHeaderPtr->poolPtr->blockSize
+                                    - (GUARD_BAND_SIZE * 2) );
+    for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
+    {
+        *guardBandWordPtr = GUARD_WORD;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the integrity of the guard bands around a memory block, if its pool has checks enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckGuardBands
+(
+    MemBlock_t* blockHeaderPtr  // Pointer to the per-block overhead area of the memory block.
+)
+{
+    if (!blockHeaderPtr->poolPtr->checksEnabled)
+    {
+        return;
+    }
+
+    int i;
+
+    // There's a guard band in front of the block header.
+    uint32_t* guardBandWordPtr = (uint32_t*)(((uint8_t*)blockHeaderPtr) - GUARD_BAND_SIZE);
+    for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
+    {
+        if (*guardBandWordPtr != GUARD_WORD)
+        {
+            LE_EMERG("Memory corruption detected at address %p before object allocated"
+                                                                            " from pool '%s'.",
+                     guardBandWordPtr,
+                     blockHeaderPtr->poolPtr->name);
+            LE_FATAL("Guard band value should have been %d, but was found to be %d.",
+                     GUARD_WORD,
+                     *guardBandWordPtr);
+        }
+    }
+
+    // There's another guard band at the end of the data section.
+    guardBandWordPtr = (uint32_t*)(   ((uint8_t*)blockHeaderPtr)
+                                    + blockHeaderPtr->poolPtr->blockSize
+                                    - (GUARD_BAND_SIZE * 2) );
+    for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
+    {
+        if (*guardBandWordPtr != GUARD_WORD)
+        {
+            LE_EMERG("Memory corruption detected at address %p at end of object allocated"
+                                                                            " from pool '%s'.",
+                     guardBandWordPtr,
+                     blockHeaderPtr->poolPtr->name);
+            LE_FATAL("Guard band value should have been %d, but was found to be %d.",
+                     GUARD_WORD,
+                     *guardBandWordPtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Raises a pool's high-water mark of blocks in use, if necessary.
+ *
+ * @note
+ *      Can be called with or without the mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void UpdateMaxBlocksUsed
+(
+    MemPool_t* poolPtr,             ///< [IN] The pool.
+    size_t numInUse                 ///< [IN] The number of blocks now in use.
+)
+{
+    size_t maxUsed = __atomic_load_n(&(poolPtr->maxNumBlocksUsed), __ATOMIC_RELAXED);
+
+    while (   (numInUse > maxUsed)
+           && !__atomic_compare_exchange_n(&(poolPtr->maxNumBlocksUsed),
+                                           &maxUsed,
+                                           numInUse,
+                                           true,
+                                           __ATOMIC_RELAXED,
+                                           __ATOMIC_RELAXED))
+    {
+        // maxUsed has been refreshed by the failed exchange; try again.
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Updates a pool's statistics for a newly allocated block.
+ *
+ * @note
+ *      Can be called with or without the mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void CountAllocation
+(
+    MemPool_t* poolPtr              ///< [IN] The pool the block was allocated from.
+)
+{
+    __atomic_add_fetch(&(poolPtr->numAllocations), 1, __ATOMIC_RELAXED);
+
+    UpdateMaxBlocksUsed(poolPtr,
+                        __atomic_add_fetch(&(poolPtr->numBlocksInUse), 1, __ATOMIC_RELAXED));
+}
+
+
+#ifndef LE_MEM_VALGRIND
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Pushes a free block onto a thread cache.
+     *
+     * @note
+     *      Must only be called by the thread that owns the cache.
+     */
+    //----------------------------------------------------------------------------------------------
+    static inline void CachePush
+    (
+        ThreadCacheSlot_t* slotPtr, ///< [IN] The cache.
+        le_sls_Link_t* linkPtr      ///< [IN] The link of the free block.
+    )
+    {
+        le_sls_Link_t* headPtr = __atomic_load_n(&(slotPtr->headPtr), __ATOMIC_RELAXED);
+
+        do
+        {
+            linkPtr->nextPtr = headPtr;
+        }
+        while (!__atomic_compare_exchange_n(&(slotPtr->headPtr),
+                                            &headPtr,
+                                            linkPtr,
+                                            true,
+                                            __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED));
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Pops a free block off a thread cache.
+     *
+     * @return
+     *      The link of the free block, or NULL if the cache is empty.
+     *
+     * @note
+     *      Must only be called by the thread that owns the cache.  The whole stack is taken before
+     *      the top block's link is read, because another thread may reclaim the cached blocks (and
+     *      reuse them) at any time.  Since the owner is the only thread that pushes, the head stays
+     *      NULL until the rest of the stack is put back.  Meanwhile, other threads see an empty
+     *      cache.
+     */
+    //----------------------------------------------------------------------------------------------
+    static inline le_sls_Link_t* CachePop
+    (
+        ThreadCacheSlot_t* slotPtr  ///< [IN] The cache.
+    )
+    {
+        le_sls_Link_t* headPtr = __atomic_exchange_n(&(slotPtr->headPtr), NULL, __ATOMIC_ACQUIRE);
+
+        if (headPtr != NULL)
+        {
+            __atomic_store_n(&(slotPtr->headPtr), headPtr->nextPtr, __ATOMIC_RELEASE);
+        }
+
+        return headPtr;
+    }
+
 
     //----------------------------------------------------------------------------------------------
     /**
-     * Initializes the guard bands in a memory block's data payload section.
+     * Moves all the blocks in a thread cache back onto its pool's shared free list.
+     *
+     * @note
+     *      Assumes that the mutex is locked.  Can be called by any thread.
      */
     //----------------------------------------------------------------------------------------------
-    static void InitGuardBands
+    static void DrainCacheSlot
     (
-        MemBlock_t* blockHeaderPtr  // Pointer to the per-block overhead area of the memory block.
+        ThreadCacheSlot_t* slotPtr  ///< [IN] The cache.
     )
     {
-        int i;
+        le_sls_Link_t* linkPtr = __atomic_exchange_n(&(slotPtr->headPtr), NULL, __ATOMIC_ACQUIRE);
 
-        // There's a guard band at the start of the data section.
-        uint32_t* guardBandWordPtr = (uint32_t*)(blockHeaderPtr->data);
-        for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
+        while (linkPtr != NULL)
         {
-            *guardBandWordPtr = GUARD_WORD;
+            le_sls_Link_t* nextPtr = linkPtr->nextPtr;
+
+            le_sls_Stack(&(slotPtr->poolPtr->freeList), linkPtr);
+
+            linkPtr = nextPtr;
         }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Moves the blocks cached by all threads for a given pool back onto its shared free list.
+     *
+     * @note
+     *      Assumes that the mutex is locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void ReclaimCachedBlocks
+    (
+        le_mem_PoolRef_t    pool    ///< [IN] The pool.
+    )
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&(pool->threadCacheList));
+
+        while (linkPtr != NULL)
+        {
+            DrainCacheSlot(CONTAINER_OF(linkPtr, ThreadCacheSlot_t, link));
+
+            linkPtr = le_dls_PeekNext(&(pool->threadCacheList), linkPtr);
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Empties a thread cache and detaches it from its pool.
+     *
+     * @note
+     *      Assumes that the mutex is locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void DetachCacheSlot
+    (
+        ThreadCacheSlot_t* slotPtr  ///< [IN] The cache.
+    )
+    {
+        if (slotPtr->poolPtr != NULL)
+        {
+            DrainCacheSlot(slotPtr);
+            le_dls_Remove(&(slotPtr->poolPtr->threadCacheList), &(slotPtr->link));
+
+            slotPtr->poolPtr = NULL;
+            slotPtr->numBlocks = 0;
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Thread-local storage destructor that returns an exiting thread's cached blocks to their
+     * pools.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void ThreadCacheDestructor
+    (
+        void* cachePtr  ///< [IN] The thread's ThreadCache_t.
+    )
+    {
+        ThreadCache_t* threadCachePtr = cachePtr;
+        size_t i;
+
+        Lock();
 
-        // There's another guard band at the end of the data section.
-        guardBandWordPtr = (uint32_t*)(   ((uint8_t*)blockHeaderPtr)
-                                        + blockHeaderPtr->poolPtr->blockSize
-                                        - GUARD_BAND_SIZE );
-        for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
+        for (i = 0; i < THREAD_CACHE_NUM_SLOTS; i++)
         {
-            *guardBandWordPtr = GUARD_WORD;
+            DetachCacheSlot(&(threadCachePtr->slot[i]));
         }
+
+        Unlock();
+
+        free(threadCachePtr);
     }
 
+
     //----------------------------------------------------------------------------------------------
     /**
-     * Checks the integrity of the guard bands in a memory block's data payload section.
+     * Gets the calling thread's cache for a given pool, assigning one if necessary.
+     *
+     * @return
+     *      Pointer to the cache, or NULL if blocks from this pool must not be cached.
+     *
+     * @note
+     *      Called without the mutex locked.
      */
     //----------------------------------------------------------------------------------------------
-    static void CheckGuardBands
+    static ThreadCacheSlot_t* GetCacheSlot
     (
-        MemBlock_t* blockHeaderPtr  // Pointer to the per-block overhead area of the memory block.
+        le_mem_PoolRef_t    pool    ///< [IN] The pool.
     )
     {
-        int i;
+        if ((!ThreadCacheEnabled) || (pool->superPoolPtr != NULL))
+        {
+            return NULL;
+        }
+
+        ThreadCache_t* threadCachePtr = pthread_getspecific(ThreadCacheKey);
 
-        // There's a guard band at the start of the data section.
-        uint32_t* guardBandWordPtr = (uint32_t*)(blockHeaderPtr->data);
-        for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
+        if (threadCachePtr == NULL)
         {
-            if (*guardBandWordPtr != GUARD_WORD)
+            threadCachePtr = calloc(1, sizeof(ThreadCache_t));
+            LE_ASSERT(threadCachePtr);
+            LE_ASSERT(pthread_setspecific(ThreadCacheKey, threadCachePtr) == 0);
+        }
+
+        size_t i;
+
+        for (i = 0; i < THREAD_CACHE_NUM_SLOTS; i++)
+        {
+            if (threadCachePtr->slot[i].poolPtr == pool)
             {
-                LE_EMERG("Memory corruption detected at address %p before object allocated"
-                                                                                " from pool '%s'.",
-                         guardBandWordPtr,
-                         blockHeaderPtr->poolPtr->name);
-                LE_FATAL("Guard band value should have been %d, but was found to be %d.",
-                         GUARD_WORD,
-                         *guardBandWordPtr);
+                return &(threadCachePtr->slot[i]);
             }
         }
 
-        // There's another guard band at the end of the data section.
-        guardBandWordPtr = (uint32_t*)(   ((uint8_t*)blockHeaderPtr)
-                                        + blockHeaderPtr->poolPtr->blockSize
-                                        - GUARD_BAND_SIZE);
-        for (i = 0; i < NUM_GUARD_BAND_WORDS; i++, guardBandWordPtr++)
+        // Not found.  Take over the next slot in round-robin order (unused slots come first).
+        ThreadCacheSlot_t* slotPtr = &(threadCachePtr->slot[threadCachePtr->nextVictim]);
+        threadCachePtr->nextVictim = (threadCachePtr->nextVictim + 1) % THREAD_CACHE_NUM_SLOTS;
+
+        Lock();
+
+        DetachCacheSlot(slotPtr);
+
+        slotPtr->poolPtr = pool;
+        slotPtr->link = LE_DLS_LINK_INIT;
+        le_dls_Queue(&(pool->threadCacheList), &(slotPtr->link));
+
+        Unlock();
+
+        return slotPtr;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Gets a free block for a thread cache that has run dry, and refills the cache with a batch of
+     * blocks from the pool's shared free list.  If the shared free list is empty, the blocks cached
+     * by other threads are reclaimed first.
+     *
+     * @return
+     *      The link of the free block, or NULL if the pool has no free blocks.
+     *
+     * @note
+     *      Called without the mutex locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static le_sls_Link_t* RefillCacheSlot
+    (
+        ThreadCacheSlot_t* slotPtr  ///< [IN] The calling thread's cache.
+    )
+    {
+        MemPool_t* poolPtr = slotPtr->poolPtr;
+        size_t i;
+
+        slotPtr->numBlocks = 0;
+
+        Lock();
+
+        le_sls_Link_t* blockLinkPtr = le_sls_Pop(&(poolPtr->freeList));
+
+        if (blockLinkPtr == NULL)
+        {
+            ReclaimCachedBlocks(poolPtr);
+
+            blockLinkPtr = le_sls_Pop(&(poolPtr->freeList));
+        }
+
+        for (i = 1; (blockLinkPtr != NULL) && (i < THREAD_CACHE_BATCH_SIZE); i++)
         {
-            if (*guardBandWordPtr != GUARD_WORD)
+            le_sls_Link_t* linkPtr = le_sls_Pop(&(poolPtr->freeList));
+
+            if (linkPtr == NULL)
             {
-                LE_EMERG("Memory corruption detected at address %p at end of object allocated"
-                                                                                " from pool '%s'.",
-                         guardBandWordPtr,
-                         blockHeaderPtr->poolPtr->name);
-                LE_FATAL("Guard band value should have been %d, but was found to be %d.",
-                         GUARD_WORD,
-                         *guardBandWordPtr);
+                break;
             }
+
+            CachePush(slotPtr, linkPtr);
+            slotPtr->numBlocks++;
         }
+
+        Unlock();
+
+        return blockLinkPtr;
     }
 
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Puts a free block into a thread cache, returning a batch of blocks to the pool's shared free
+     * list if the cache is full.
+     *
+     * @note
+     *      Called without the mutex locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void FreeToCacheSlot
+    (
+        ThreadCacheSlot_t* slotPtr, ///< [IN] The calling thread's cache.
+        le_sls_Link_t* linkPtr      ///< [IN] The link of the free block.
+    )
+    {
+        CachePush(slotPtr, linkPtr);
+
+        if (++(slotPtr->numBlocks) > THREAD_CACHE_MAX_BLOCKS)
+        {
+            le_sls_List_t batch = LE_SLS_LIST_INIT;
+            size_t i;
+
+            for (i = 0; i < THREAD_CACHE_BATCH_SIZE; i++)
+            {
+                linkPtr = CachePop(slotPtr);
+
+                if (linkPtr == NULL)
+                {
+                    // Another thread reclaimed our blocks.
+                    slotPtr->numBlocks = 0;
+                    break;
+                }
+
+                le_sls_Stack(&batch, linkPtr);
+                slotPtr->numBlocks--;
+            }
+
+            Lock();
+
+            while ((linkPtr = le_sls_Pop(&batch)) != NULL)
+            {
+                le_sls_Stack(&(slotPtr->poolPtr->freeList), linkPtr);
+            }
+
+            Unlock();
+        }
+    }
 #endif
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the size of the guard band in front of each block header in a given pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t LeadingGuardBandSize
+(
+    MemPool_t* poolPtr              ///< [IN] The pool.
+)
+{
+    return (poolPtr->checksEnabled ? GUARD_BAND_SIZE : 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Computes the total size of a pool's blocks, including all overhead.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t ComputeBlockSize
+(
+    MemPool_t* poolPtr              ///< [IN] The pool.
+)
+{
+    size_t blockSize = sizeof(MemBlock_t) + poolPtr->userDataSize;
+
+    if (poolPtr->checksEnabled)
+    {
+        // Add guard bands around the header and user data in every block.
+        blockSize += (GUARD_BAND_SIZE * 2);
+    }
+
+    // Round up the block size to the nearest multiple of the processor word size.
+    size_t remainder = blockSize % sizeof(void*);
+    if (remainder != 0)
+    {
+        blockSize += (sizeof(void*) - remainder);
+    }
+
+    return blockSize;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initializes a memory pool.
@@ -303,31 +824,20 @@ static void InitPool
         LE_DEBUG("Memory pool name '%s.%s' is truncated to '%s'", componentName, name, pool->name);
     }
 
-    // Compute the total block size.
-    size_t blockSize = sizeof(MemBlock_t) + objSize;
-
-    #ifdef USE_GUARD_BAND
-    {
-        // Add guard bands around the user data in every block.
-        blockSize += (GUARD_BAND_SIZE * 2);
-    }
-    #endif
-
-    // Round up the block size to the nearest multiple of the processor word size.
-    size_t remainder = blockSize % sizeof(void*);
-    if (remainder != 0)
-    {
-        blockSize += (sizeof(void*) - remainder);
-    }
-
     pool->poolLink = LE_DLS_LINK_INIT;
 
     #ifndef LE_MEM_VALGRIND
         pool->freeList = LE_SLS_LIST_INIT;
+        pool->threadCacheList = LE_DLS_LIST_INIT;
     #endif
 
     pool->userDataSize = objSize;
-    pool->blockSize = blockSize;
+    #ifdef LE_MEM_CHECKS_DISABLE
+        pool->checksEnabled = false;
+    #else
+        pool->checksEnabled = true;
+    #endif
+    pool->blockSize = ComputeBlockSize(pool);
     pool->destructor = NULL;
     pool->superPoolPtr = NULL;
     pool->numAllocations = 0;
@@ -421,9 +931,7 @@ static void InitBlock
     newBlockPtr->refCount = 0;
     newBlockPtr->poolPtr = pool;
 
-    #ifdef USE_GUARD_BAND
-        InitGuardBands(newBlockPtr);
-    #endif
+    InitGuardBands(newBlockPtr);
 }
 
 
@@ -450,14 +958,17 @@ static void InitBlock
         size_t mallocSize = numBlocks * blockSize;
 
         // Allocate the chunk.
-        MemBlock_t* newBlockPtr = malloc(mallocSize);
+        uint8_t* chunkPtr = malloc(mallocSize);
+
+        LE_ASSERT(chunkPtr);
 
-        LE_ASSERT(newBlockPtr);
+        // The block header follows the leading guard band, if there is one.
+        chunkPtr += LeadingGuardBandSize(pool);
 
         for (i = 0; i < numBlocks; i++)
         {
-            InitBlock(pool, newBlockPtr);
-            newBlockPtr = (MemBlock_t*)(((uint8_t*)newBlockPtr) + blockSize);
+            InitBlock(pool, (MemBlock_t*)chunkPtr);
+            chunkPtr += blockSize;
         }
 
         // Update the pool.
@@ -516,6 +1027,12 @@ void mem_Init
     // Create a memory for all sub-pools.
     SubPoolsPool = le_mem_CreatePool("SubPools", sizeof(MemPool_t));
     le_mem_ExpandPool(SubPoolsPool, DEFAULT_SUB_POOLS_POOL_SIZE);
+
+    #ifndef LE_MEM_VALGRIND
+        // Create the key used to find each thread's block caches.
+        LE_ASSERT(pthread_key_create(&ThreadCacheKey, ThreadCacheDestructor) == 0);
+        ThreadCacheEnabled = true;
+    #endif
 }
 
 
@@ -530,20 +1047,10 @@ void mem_Init
         void*   objPtr  ///< [IN] Pointer to the object we're finding a pool for.
     )
     {
-        MemBlock_t* blockPtr;
-
         // Get the block from the object pointer.
-        #ifdef USE_GUARD_BAND
-            uint8_t* dataPtr = objPtr;
-            dataPtr -= GUARD_BAND_SIZE;
-            blockPtr = CONTAINER_OF(dataPtr, MemBlock_t, data);
-        #else
-            blockPtr = CONTAINER_OF(objPtr, MemBlock_t, data);
-        #endif
-
-        #ifdef USE_GUARD_BAND
-            CheckGuardBands(blockPtr);
-        #endif
+        MemBlock_t* blockPtr = CONTAINER_OF(objPtr, MemBlock_t, data);
+
+        CheckGuardBands(blockPtr);
 
         return blockPtr->poolPtr;
     }
@@ -677,7 +1184,9 @@ le_mem_PoolRef_t le_mem_ExpandPool
         if (pool->superPoolPtr)
         {
             // This is a sub-pool so the memory blocks to create must come from the super-pool.
-            // Check that there are enough blocks in the superpool.
+            // Check that there are enough blocks in the superpool, counting those cached by
+            // threads.
+            ReclaimCachedBlocks(pool->superPoolPtr);
             ssize_t numBlocksToAdd = numObjects - le_sls_NumLinks(&(pool->superPoolPtr->freeList));
 
             if (numBlocksToAdd > 0)
@@ -693,12 +1202,11 @@ le_mem_PoolRef_t le_mem_ExpandPool
             pool->totalBlocks = pool->totalBlocks + numObjects;
 
             // Update the super-pool's block use counts.
-            pool->superPoolPtr->numBlocksInUse += numObjects;
+            size_t numInUse = __atomic_add_fetch(&(pool->superPoolPtr->numBlocksInUse),
+                                                 numObjects,
+                                                 __ATOMIC_RELAXED);
 
-            if (pool->superPoolPtr->numBlocksInUse > pool->superPoolPtr->maxNumBlocksUsed)
-            {
-                pool->superPoolPtr->maxNumBlocksUsed = pool->superPoolPtr->numBlocksInUse;
-            }
+            UpdateMaxBlocksUsed(pool->superPoolPtr, numInUse);
         }
         else
         {
@@ -732,11 +1240,34 @@ void* le_mem_TryAlloc
     MemBlock_t* blockPtr = NULL;
     void* userPtr = NULL;
 
-    Lock();
-
     #ifndef LE_MEM_VALGRIND
-        // Pop a link off the pool.
-        le_sls_Link_t* blockLinkPtr = le_sls_Pop(&(pool->freeList));
+        le_sls_Link_t* blockLinkPtr;
+        ThreadCacheSlot_t* slotPtr = GetCacheSlot(pool);
+
+        if (slotPtr != NULL)
+        {
+            // Take a block from this thread's cache, refilling it from the pool if it's empty.
+            blockLinkPtr = CachePop(slotPtr);
+
+            if (blockLinkPtr != NULL)
+            {
+                if (slotPtr->numBlocks > 0)
+                {
+                    slotPtr->numBlocks--;
+                }
+            }
+            else
+            {
+                blockLinkPtr = RefillCacheSlot(slotPtr);
+            }
+        }
+        else
+        {
+            // Pop a link off the pool.
+            Lock();
+            blockLinkPtr = le_sls_Pop(&(pool->freeList));
+            Unlock();
+        }
 
         if (blockLinkPtr != NULL)
         {
@@ -744,10 +1275,11 @@ void* le_mem_TryAlloc
             blockPtr = CONTAINER_OF(blockLinkPtr, MemBlock_t, link);
         }
     #else
-        blockPtr = malloc(pool->blockSize);
+        uint8_t* mallocPtr = malloc(pool->blockSize);
 
-        if (blockPtr != NULL)
+        if (mallocPtr != NULL)
         {
+            blockPtr = (MemBlock_t*)(mallocPtr + LeadingGuardBandSize(pool));
             InitBlock(pool, blockPtr);
         }
     #endif
@@ -755,27 +1287,15 @@ void* le_mem_TryAlloc
     if (blockPtr != NULL)
     {
         // Update the pool and the block.
-        pool->numAllocations++;
-        pool->numBlocksInUse++;
-
-        if (pool->numBlocksInUse > pool->maxNumBlocksUsed)
-        {
-            pool->maxNumBlocksUsed = pool->numBlocksInUse;
-        }
+        CountAllocation(pool);
 
         blockPtr->refCount = 1;
 
         // Return the user object in the block.
-        #ifdef USE_GUARD_BAND
-            CheckGuardBands(blockPtr);
-            userPtr = blockPtr->data + GUARD_BAND_SIZE;
-        #else
-            userPtr = blockPtr->data;
-        #endif
+        CheckGuardBands(blockPtr);
+        userPtr = blockPtr->data;
     }
 
-    Unlock();
-
     return userPtr;
 }
 
@@ -876,6 +1396,40 @@ void le_mem_SetNumObjsToForce
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables the guard band checks on a pool's blocks, even if the framework was built with
+ * LE_MEM_CHECKS_DISABLE.  Must be called before any blocks are added to the pool.
+ *
+ * @return
+ *      Nothing.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_mem_EnableChecks
+(
+    le_mem_PoolRef_t    pool        ///< [IN] The pool.
+)
+{
+    LE_ASSERT(pool != NULL);
+
+    Lock();
+
+    if (!pool->checksEnabled)
+    {
+        LE_FATAL_IF(   (pool->totalBlocks != 0)
+                    || (pool->numBlocksInUse != 0)
+                    || (pool->superPoolPtr != NULL),
+                    "Checks can't be enabled on pool '%s' after it has blocks.",
+                    pool->name);
+
+        pool->checksEnabled = true;
+        pool->blockSize = ComputeBlockSize(pool);
+    }
+
+    Unlock();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Releases an object.  If the object's reference count has reached zero, it will be destructed
@@ -896,60 +1450,53 @@ void le_mem_Release
     void*   objPtr  ///< [IN] Pointer to the object to be released.
 )
 {
-    MemBlock_t* blockPtr;
-
     // Get the block from the object pointer.
-    #ifdef USE_GUARD_BAND
-        uint8_t* dataPtr = objPtr;
-        dataPtr -= GUARD_BAND_SIZE;
-        blockPtr = CONTAINER_OF(dataPtr, MemBlock_t, data);
-    #else
-        blockPtr = CONTAINER_OF(objPtr, MemBlock_t, data);
-    #endif
+    MemBlock_t* blockPtr = CONTAINER_OF(objPtr, MemBlock_t, data);
 
-    #ifdef USE_GUARD_BAND
-        CheckGuardBands(blockPtr);
-    #endif
+    CheckGuardBands(blockPtr);
 
-    Lock();
+    size_t oldRefCount = __atomic_fetch_sub(&(blockPtr->refCount), 1, __ATOMIC_ACQ_REL);
 
-    switch (blockPtr->refCount)
+    switch (oldRefCount)
     {
         case 1:
         {
             MemPool_t* poolPtr = blockPtr->poolPtr;
 
             // The reference count has reached zero.
-            blockPtr->refCount = 0;
-
             // Call the destructor, if there is one.
-            if (poolPtr->destructor)
+            // Note that the mutex is not locked here, because it is not a recursive mutex and
+            // therefore would deadlock if the destructor releases other objects.
+            le_mem_Destructor_t destructor = poolPtr->destructor;
+            if (destructor)
             {
-                // Make sure that the destructor is not called with the mutex locked, because
-                // it is not a recursive mutex and therefore will deadlock if locked again by
-                // the same thread.  Also, fetch the destructor function address before unlocking
-                // the mutex so that we don't touch the pool object while the mutex is unlocked.
-                le_mem_Destructor_t destructor = poolPtr->destructor;
-                Unlock();
                 destructor(objPtr);
-
-                // Re-lock the mutex now so that it is safe to access the pool object again.
-                Lock();
             }
 
+            __atomic_sub_fetch(&(poolPtr->numBlocksInUse), 1, __ATOMIC_RELAXED);
+
             #ifndef LE_MEM_VALGRIND
                 // Release the memory back into the pool.
                 // Note that we don't do this before calling the destructor because the destructor
                 // still needs to access it, but after it goes back on the free list, it could get
                 // reallocated by another thread (or even the destructor itself) and have its
                 // contents clobbered.
-                le_sls_Stack(&(poolPtr->freeList), &(blockPtr->link));
+                ThreadCacheSlot_t* slotPtr = GetCacheSlot(poolPtr);
+
+                if (slotPtr != NULL)
+                {
+                    FreeToCacheSlot(slotPtr, &(blockPtr->link));
+                }
+                else
+                {
+                    Lock();
+                    le_sls_Stack(&(poolPtr->freeList), &(blockPtr->link));
+                    Unlock();
+                }
             #else
-                free(blockPtr);
+                free(((uint8_t*)blockPtr) - LeadingGuardBandSize(poolPtr));
             #endif
 
-            poolPtr->numBlocksInUse--;
-
             break;
         }
 
@@ -960,10 +1507,8 @@ void le_mem_Release
                      blockPtr->poolPtr->name);
 
         default:
-            blockPtr->refCount--;
+            break;
     }
-
-    Unlock();
 }
 
 
@@ -982,22 +1527,11 @@ void le_mem_AddRef
     void*   objPtr  ///< [IN] Pointer to the object.
 )
 {
-    #ifdef USE_GUARD_BAND
-        objPtr = (((uint8_t*)objPtr) - GUARD_BAND_SIZE);
-    #endif
     MemBlock_t* memBlockPtr = CONTAINER_OF(objPtr, MemBlock_t, data);
 
-    #ifdef USE_GUARD_BAND
-        CheckGuardBands(memBlockPtr);
-    #endif
-
-    Lock();
-
-    LE_ASSERT(memBlockPtr->refCount != 0);
-
-    memBlockPtr->refCount++;
+    CheckGuardBands(memBlockPtr);
 
-    Unlock();
+    LE_ASSERT(__atomic_fetch_add(&(memBlockPtr->refCount), 1, __ATOMIC_RELAXED) != 0);
 }
 
 
@@ -1043,11 +1577,13 @@ void le_mem_GetStats
 
     Lock();
 
-    statsPtr->numAllocs = pool->numAllocations;
+    size_t numBlocksInUse = __atomic_load_n(&(pool->numBlocksInUse), __ATOMIC_RELAXED);
+
+    statsPtr->numAllocs = __atomic_load_n(&(pool->numAllocations), __ATOMIC_RELAXED);
     statsPtr->numOverflows = pool->numOverflows;
-    statsPtr->numFree = pool->totalBlocks - pool->numBlocksInUse;
-    statsPtr->numBlocksInUse = pool->numBlocksInUse;
-    statsPtr->maxNumBlocksUsed = pool->maxNumBlocksUsed;
+    statsPtr->numFree = pool->totalBlocks - numBlocksInUse;
+    statsPtr->numBlocksInUse = numBlocksInUse;
+    statsPtr->maxNumBlocksUsed = __atomic_load_n(&(pool->maxNumBlocksUsed), __ATOMIC_RELAXED);
 
     Unlock();
 }
@@ -1069,7 +1605,7 @@ void le_mem_ResetStats
     LE_ASSERT(pool != NULL);
 
     Lock();
-    pool->numAllocations = 0;
+    __atomic_store_n(&(pool->numAllocations), 0, __ATOMIC_RELAXED);
     pool->numOverflows = 0;
     Unlock();
 }
@@ -1224,8 +1760,9 @@ le_mem_PoolRef_t _le_mem_FindPool
 
     // Construct the component-scoped pool name.
     // Note: Don't check for truncation because if it is truncated, it will be consistent with
-    //       the truncation that would have occurred in InitPool().
-    char fullName[MAX_POOL_NAME_BYTES];
+    //       the truncation that would have occurred in InitPool(), as long as the buffer is the
+    //       same size as the pool's name.
+    char fullName[LIMIT_MAX_MEM_POOL_NAME_BYTES];
     (void)snprintf(fullName, sizeof(fullName), "%s.%s", componentName, name);
 
     Lock();
@@ -1284,9 +1821,11 @@ le_mem_PoolRef_t _le_mem_CreateSubPool
     // Get a sub-pool from the pool of sub-pools.
     le_mem_PoolRef_t subPool = le_mem_ForceAlloc(SubPoolsPool);
 
-    // Initialize the pool.
+    // Initialize the pool.  Its blocks come from the super-pool, so they have the same layout.
     InitPool(subPool, componentName, name, superPool->userDataSize);
     subPool->superPoolPtr = superPool;
+    subPool->checksEnabled = superPool->checksEnabled;
+    subPool->blockSize = superPool->blockSize;
 
     Lock();
 
@@ -1344,7 +1883,7 @@ void le_mem_DeleteSubPool
     MoveBlocks(superPool, subPool, numBlocks);
 
     // Update the superPool's block use count.
-    superPool->numBlocksInUse -= numBlocks;
+    __atomic_sub_fetch(&(superPool->numBlocksInUse), numBlocks, __ATOMIC_RELAXED);
 
     // Remove the sub-pool from the list of sub-pools.
     PoolListChangeCount++;
@@ -27,9 +27,11 @@ typedef struct le_mem_Pool
                                         ///  if we are not a sub-pool.
     #ifndef LE_MEM_VALGRIND
         le_sls_List_t freeList;         ///< List of free memory blocks.
+        le_dls_List_t threadCacheList;  ///< List of thread caches holding free blocks of this pool.
     #endif
 
     size_t userDataSize;                ///< Size of the object requested by the client in bytes.
+    bool checksEnabled;                 ///< true if the blocks are surrounded by guard bands.
     size_t blockSize;                   ///< Number of bytes in a block, including all overhead.
     uint64_t numAllocations;            ///< Total number of times an object has been allocated
                                         ///  from this pool.
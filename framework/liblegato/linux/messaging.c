@@ -85,6 +85,11 @@
  * side.  For all other types of messages, this is set to 0 (NULL) to indicate that it does
  * not belong to a request-response transaction.
  *
+ * A server can also offer its clients a shared memory transport, made up of a pair of message
+ * rings in a memfd that is passed to the client when the session opens.  Sessions that use it
+ * only send small wake-up tokens and messages carrying file descriptors through the socket.
+ * See @ref messagingSharedMem.c for details.
+ *
  * See also @ref serviceDirectoryProtocol.
  *
  * @warning The code in this subsystem @b must be thread safe and re-entrant.
@@ -98,6 +103,7 @@
 #include "messagingProtocol.h"
 #include "messagingSession.h"
 #include "messagingInterface.h"
+#include "messagingSharedMem.h"
 
 // =======================================
 //  PROTECTED (INTER-MODULE) FUNCTIONS
@@ -118,5 +124,6 @@ void msg_Init
     msgProto_Init();
     msgMessage_Init();
     msgInterface_Init();
+    msgShm_Init();
     msgSession_Init();
 }
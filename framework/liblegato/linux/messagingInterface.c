@@ -239,6 +239,8 @@ static msgInterface_Service_t* CreateService
     // Initialize the open handlers dls
     servicePtr->openListPtr = LE_DLS_LIST_INIT;
 
+    servicePtr->sharedMemEnabled = false;
+
     ServiceObjMapChangeCount++;
     le_hashmap_Put(ServiceMapRef, &servicePtr->interface.id, servicePtr);
 
@@ -1253,6 +1255,24 @@ void le_msg_SetServiceRecvHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Offers clients that open sessions with a given service from now on a shared memory transport,
+ * instead of passing every message through the session's socket.
+ *
+ * @note    This is a server-only function.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_EnableServiceSharedMem
+(
+    le_msg_ServiceRef_t serviceRef  ///< [in] Reference to the service.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    serviceRef->sharedMemEnabled = true;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Associates an opaque context value (void pointer) with a given service that can be retrieved
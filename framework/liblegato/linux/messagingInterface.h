@@ -94,6 +94,9 @@ typedef struct le_msg_Service
 
     le_dls_List_t                   closeListPtr; ///< open List: list of close session handlers
                                                   ///  called when a session is opened
+
+    bool                            sharedMemEnabled; ///< true = offer clients a shared memory
+                                                      ///  transport when they open a session.
 }
 msgInterface_Service_t;
 
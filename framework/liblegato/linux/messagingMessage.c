@@ -67,6 +67,103 @@ static void MessageDestructor
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a message with a given payload size for a given session.  The payload is not
+ * initialized.
+ *
+ * @return  The message reference.  Never returns on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static Message_t* AllocMessage
+(
+    le_msg_SessionRef_t sessionRef, ///< [in] Reference to the session.
+    size_t payloadSize              ///< [in] Size of the payload, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Get a reference to the Session's Protocol and ask the Protocol to allocate a Message
+    // object from the right one of its Message Pools.
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetSessionProtocol(sessionRef);
+    Message_t* msgPtr = msgProto_AllocMessage(protocolRef, payloadSize);
+
+    // Initialize the Message object's data members.
+    msgPtr->link = LE_DLS_LINK_INIT;
+    msgPtr->sessionRef = sessionRef;
+    le_mem_AddRef(sessionRef);  // Message object holds a reference to the Session object.
+
+    msgInterface_Type_t interfaceType = msgSession_GetInterfaceType(sessionRef);
+    switch (interfaceType)
+    {
+        case LE_MSG_INTERFACE_CLIENT:
+            msgPtr->clientServer.client.completionCallback = NULL;
+            msgPtr->clientServer.client.contextPtr = NULL;
+            break;
+
+        case LE_MSG_INTERFACE_SERVER:
+            msgPtr->clientServer.server.responseFd = -1;
+            break;
+
+        default:
+            LE_FATAL("Unhandled interface type (%d).", interfaceType);
+    }
+
+    msgPtr->fd = -1;
+    msgPtr->payloadSize = payloadSize;
+    msgPtr->txnId = 0;
+
+    return msgPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Releases a message that was allocated for receiving into, but which turned out not to be needed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DiscardMessage
+(
+    Message_t* msgPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Whatever was received into it must not be taken for a request waiting for a response.
+    msgPtr->txnId = 0;
+
+    le_mem_Release(msgPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Puts the file descriptor (if any) that is to be sent with a message into the message's fd field,
+ * ready for sending.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrepareFdForSend
+(
+    Message_t*  msgPtr      ///< The Message to be sent.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // If this is a response message,
+    if (le_msg_NeedsResponse(msgPtr))
+    {
+        // If there was an fd that was received from the client but not fetched from the message
+        // generate a warning and close that fd.
+        if (msgPtr->fd >= 0)
+        {
+            LE_WARN("File descriptor not retrieved from message received from client.");
+            fd_Close(msgPtr->fd);
+        }
+
+        // Move the responseFd to the normal fd position in the message object.
+        msgPtr->fd = msgPtr->clientServer.server.responseFd;
+        msgPtr->clientServer.server.responseFd = -1;
+    }
+}
+
+
 // =======================================
 //  PROTECTED (INTER-MODULE) FUNCTIONS
 // =======================================
@@ -96,27 +193,29 @@ void msgMessage_Init
 //--------------------------------------------------------------------------------------------------
 le_mem_PoolRef_t msgMessage_CreatePool
 (
-    const char* name,       ///< [in] Name of the pool.
-    size_t largestMsgSize   ///< [in] Size of the largest message payload, in bytes.
+    const char* name,       ///< [in] Name of the protocol.
+    size_t payloadSize      ///< [in] Size of the message payloads in the pool, in bytes.
 )
 //--------------------------------------------------------------------------------------------------
 {
     char poolName[LIMIT_MAX_MEM_POOL_NAME_BYTES];
-    size_t bytesCopied;
+    int prefixLen;
     le_result_t result;
 
-    le_utf8_Copy(poolName, "msgs-", sizeof(poolName), &bytesCopied);
-    result = le_utf8_Copy(poolName + bytesCopied, name, sizeof(poolName) - bytesCopied, NULL);
+    prefixLen = snprintf(poolName, sizeof(poolName), "msgs%zu-", payloadSize);
+    LE_ASSERT((prefixLen > 0) && (prefixLen < (int)sizeof(poolName)));
+    result = le_utf8_Copy(poolName + prefixLen, name, sizeof(poolName) - prefixLen, NULL);
     if (result != LE_OK)
     {
         LE_DEBUG("Pool name truncated to '%s' for protocol '%s'.", poolName, name);
     }
 
-    le_mem_PoolRef_t poolRef = le_mem_CreatePool(poolName, sizeof(Message_t) + largestMsgSize);
+    le_mem_PoolRef_t poolRef = le_mem_CreatePool(poolName, sizeof(Message_t) + payloadSize);
 
     le_mem_SetDestructor(poolRef, MessageDestructor);
 
-    le_mem_ExpandPool(poolRef, 10); /// @todo Make this configurable.
+    // A protocol has a pool for each size class, most of which will only ever hold a few messages,
+    // so the pools start empty and grow as they are used.
 
     return poolRef;
 }
@@ -142,27 +241,13 @@ le_result_t msgMessage_Send
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // If this is a response message,
-    if (le_msg_NeedsResponse(msgPtr))
-    {
-        // If there was an fd that was received from the client but not fetched from the message
-        // generate a warning and close that fd.
-        if (msgPtr->fd >= 0)
-        {
-            LE_WARN("File descriptor not retrieved from message received from client.");
-            fd_Close(msgPtr->fd);
-        }
-
-        // Move the responseFd to the normal fd position in the message object.
-        msgPtr->fd = msgPtr->clientServer.server.responseFd;
-        msgPtr->clientServer.server.responseFd = -1;
-    }
+    PrepareFdForSend(msgPtr);
 
     // The first bytes come from our transaction ID and the rest (if any)
     // from our Message object's payload section, which comes right after the transaction ID.
     return unixSocket_SendMsg(  socketFd,
                                 &msgPtr->txnId,
-                                sizeof(msgPtr->txnId) + le_msg_GetMaxPayloadSize(msgPtr),
+                                sizeof(msgPtr->txnId) + msgPtr->payloadSize,
                                 msgPtr->fd,
                                 false   ); // Don't send process credentials.
 }
@@ -170,7 +255,7 @@ le_result_t msgMessage_Send
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Receive a single message from a connected socket.
+ * Receive a single message (or shared memory transport token) from a connected socket.
  *
  * @return
  * - LE_OK if successful.
@@ -181,25 +266,155 @@ le_result_t msgMessage_Send
 //--------------------------------------------------------------------------------------------------
 le_result_t msgMessage_Receive
 (
-    int                 socketFd,   ///< [IN] The socket's file descriptor.
-    le_msg_MessageRef_t msgRef      ///< [IN] Message object to store the received message in.
+    int                  socketFd,  ///< [IN] The socket's file descriptor.
+    le_msg_SessionRef_t  sessionRef,///< [IN] Session that the message is received on.
+    le_msg_MessageRef_t* msgRefPtr, ///< [OUT] Message object holding the received message, or
+                                    ///        NULL if no message was received.
+    int*                 tokenPtr   ///< [OUT] Shared memory transport token that was received
+                                    ///        instead of a message, or -1 if a message was received.
 )
 //--------------------------------------------------------------------------------------------------
 {
+    size_t maxPayloadSize = le_msg_GetProtocolMaxMsgSize(le_msg_GetSessionProtocol(sessionRef));
+    size_t msgSize;
+
+    *msgRefPtr = NULL;
+    *tokenPtr = -1;
+
+    // Get the size of the message first, so that it is received straight into a message of the
+    // smallest class that holds it.  Requests are no exception: clients size them to also hold
+    // their response.  A message too big for the protocol is received into a message of the
+    // maximum size, and is rejected by unixSocket_ReceiveMsg().
+    le_result_t result = unixSocket_PeekMsgSize(socketFd, &msgSize);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    size_t payloadSize = 0;
+    if (msgSize > sizeof(((Message_t*)NULL)->txnId))
+    {
+        payloadSize = msgSize - sizeof(((Message_t*)NULL)->txnId);
+    }
+    if (payloadSize > maxPayloadSize)
+    {
+        payloadSize = maxPayloadSize;
+    }
+
+    Message_t* msgPtr = AllocMessage(sessionRef, payloadSize);
+
     // Receive the first bytes into our transaction ID and the rest (if any)
     // into our Message object's payload section.
-    size_t byteCount = sizeof(msgRef->txnId) + le_msg_GetMaxPayloadSize(msgRef);
-    le_result_t result = unixSocket_ReceiveMsg( socketFd,
-                                                &msgRef->txnId,
-                                                &byteCount,
-                                                &msgRef->fd,
-                                                NULL    );  // Don't receive credentials.
-    if (msgSession_GetInterfaceType(msgRef->sessionRef) == LE_MSG_INTERFACE_SERVER)
+    size_t byteCount = sizeof(msgPtr->txnId) + msgPtr->payloadSize;
+    result = unixSocket_ReceiveMsg( socketFd,
+                                    &msgPtr->txnId,
+                                    &byteCount,
+                                    &msgPtr->fd,
+                                    NULL    );  // Don't receive credentials.
+    if (result != LE_OK)
+    {
+        DiscardMessage(msgPtr);
+        return result;
+    }
+
+    // Tokens are the only one-byte messages (even an empty payload has a transaction ID).
+    if (byteCount == 1)
+    {
+        *tokenPtr = *(uint8_t*)&msgPtr->txnId;
+        DiscardMessage(msgPtr);
+        return LE_OK;
+    }
+
+    if (byteCount < sizeof(msgPtr->txnId))
     {
-        msgRef->clientServer.server.responseFd = -1;
+        LE_ERROR("Received a message of only %zu bytes.", byteCount);
+        DiscardMessage(msgPtr);
+        return LE_COMM_ERROR;
     }
 
-    return result;
+    msgPtr->payloadSize = byteCount - sizeof(msgPtr->txnId);
+
+    *msgRefPtr = msgPtr;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a message that is ready for sending has a file descriptor to go with it.
+ *
+ * @return true if it has.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgMessage_HasFd
+(
+    le_msg_MessageRef_t msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (le_msg_NeedsResponse(msgRef))
+    {
+        return (msgRef->clientServer.server.responseFd >= 0);
+    }
+
+    return (msgRef->fd >= 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a message into a shared memory record, in the same format as msgMessage_Send() uses.
+ *
+ * @warning The message must not have a file descriptor to go with it (see msgMessage_HasFd()).
+ */
+//--------------------------------------------------------------------------------------------------
+size_t msgMessage_Store
+(
+    le_msg_MessageRef_t msgRef,     ///< [IN] The Message to be sent.
+    void*               recordPtr   ///< [OUT] Where to copy the message to.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t recordSize = sizeof(msgRef->txnId) + msgRef->payloadSize;
+
+    PrepareFdForSend(msgRef);
+
+    memcpy(recordPtr, &msgRef->txnId, recordSize);
+
+    return recordSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a message from a shared memory record that was filled in using msgMessage_Store().
+ *
+ * @return The message, or NULL if the record is not a valid message for the session's protocol.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_MessageRef_t msgMessage_Load
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Session that the message is received on.
+    const void*         recordPtr,  ///< [IN] Where to copy the message from.
+    size_t              recordSize  ///< [IN] Size of the record, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (   (recordSize < sizeof(((Message_t*)NULL)->txnId))
+        || (recordSize > msgMessage_GetRecordSize(le_msg_GetSessionProtocol(sessionRef))) )
+    {
+        LE_ERROR("Shared memory record size %zu is invalid.", recordSize);
+        return NULL;
+    }
+
+    // As in msgMessage_Receive(), the message comes from the smallest class that holds it.
+    Message_t* msgPtr = AllocMessage(sessionRef,
+                                     recordSize - sizeof(((Message_t*)NULL)->txnId));
+
+    memcpy(&msgPtr->txnId, recordPtr, recordSize);
+
+    return msgPtr;
 }
 
 
@@ -245,35 +460,34 @@ le_msg_MessageRef_t le_msg_CreateMsg
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Get a reference to the Session's Protocol and ask the Protocol to allocate a Message
-    // object from its Message Pool.
-    le_msg_ProtocolRef_t protocolRef = le_msg_GetSessionProtocol(sessionRef);
-    Message_t* msgPtr = msgProto_AllocMessage(protocolRef);
-
-    // Initialize the Message object's data members.
-    msgPtr->link = LE_DLS_LINK_INIT;
-    msgPtr->sessionRef = sessionRef;
-    le_mem_AddRef(sessionRef);  // Message object holds a reference to the Session object.
-
-    msgInterface_Type_t interfaceType = msgSession_GetInterfaceType(sessionRef);
-    switch (interfaceType)
-    {
-        case LE_MSG_INTERFACE_CLIENT:
-            msgPtr->clientServer.client.completionCallback = NULL;
-            msgPtr->clientServer.client.contextPtr = NULL;
-            break;
+    return le_msg_CreateSizedMsg(sessionRef,
+                                 le_msg_GetProtocolMaxMsgSize(le_msg_GetSessionProtocol(sessionRef)));
+}
 
-        case LE_MSG_INTERFACE_SERVER:
-            msgPtr->clientServer.server.responseFd = -1;
-            break;
 
-        default:
-            LE_FATAL("Unhandled interface type (%d).", interfaceType);
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a message with a payload smaller than the protocol's maximum, to be sent over a given
+ * session.
+ *
+ * @return  The message reference.
+ *
+ * @note
+ * - This function never returns on failure, so no need to check the return code.
+ * - If the message is a request, the server's response has to fit in the same payload size.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_MessageRef_t le_msg_CreateSizedMsg
+(
+    le_msg_SessionRef_t sessionRef, ///< [in] Reference to the session.
+    size_t payloadSize              ///< [in] Size of the payload, in bytes.  Must be no more than
+                                    ///       the protocol's maximum message size.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Message_t* msgPtr = AllocMessage(sessionRef, payloadSize);
 
-    msgPtr->fd = -1;
-    msgPtr->txnId = 0;
-    memset(msgPtr->payload, 0, le_msg_GetProtocolMaxMsgSize(protocolRef));
+    memset(msgPtr->payload, 0, payloadSize);
 
     return msgPtr;
 }
@@ -368,7 +582,7 @@ size_t le_msg_GetMaxPayloadSize
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return le_msg_GetProtocolMaxMsgSize(le_msg_GetSessionProtocol(msgRef->sessionRef));
+    return msgRef->payloadSize;
 }
 
 
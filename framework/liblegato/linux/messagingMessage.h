@@ -41,6 +41,8 @@ typedef struct le_msg_Message
     clientServer;
 
     int                         fd;         ///< File descriptor to send or received (-1 = no fd)
+    size_t                      payloadSize;///< Size of the payload that is sent or was received.
+                                            ///  (The buffer can be bigger.)
     void*                       txnId;      ///< Safe reference value used as a transaction ID.
     void*                       payload[0]; ///< Variable-length payload buffer appears at the end.
 }
@@ -68,8 +70,8 @@ void msgMessage_Init
 //--------------------------------------------------------------------------------------------------
 le_mem_PoolRef_t msgMessage_CreatePool
 (
-    const char* name,       ///< [in] Name of the pool.
-    size_t largestMsgSize   ///< [in] Size of the largest message payload, in bytes.
+    const char* name,       ///< [in] Name of the protocol.
+    size_t payloadSize      ///< [in] Size of the message payloads in the pool, in bytes.
 );
 
 
@@ -92,7 +94,7 @@ le_result_t msgMessage_Send
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Receive a single message from a connected socket.
+ * Receive a single message (or shared memory transport token) from a connected socket.
  *
  * @return
  * - LE_OK if successful.
@@ -103,11 +105,77 @@ le_result_t msgMessage_Send
 //--------------------------------------------------------------------------------------------------
 le_result_t msgMessage_Receive
 (
-    int                 socketFd,   ///< [IN] The socket's file descriptor.
-    le_msg_MessageRef_t msgRef      ///< [IN] Message object to store the received message in.
+    int                  socketFd,  ///< [IN] The socket's file descriptor.
+    le_msg_SessionRef_t  sessionRef,///< [IN] Session that the message is received on.
+    le_msg_MessageRef_t* msgRefPtr, ///< [OUT] Message object holding the received message, or
+                                    ///        NULL if no message was received.
+    int*                 tokenPtr   ///< [OUT] Shared memory transport token that was received
+                                    ///        instead of a message, or -1 if a message was received.
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a message that is ready for sending has a file descriptor to go with it.
+ *
+ * @return true if it has.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgMessage_HasFd
+(
+    le_msg_MessageRef_t msgRef
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a message into a shared memory record, in the same format as msgMessage_Send() uses.
+ *
+ * @return The size of the record, in bytes.
+ *
+ * @warning The message must not have a file descriptor to go with it (see msgMessage_HasFd()).
+ */
+//--------------------------------------------------------------------------------------------------
+size_t msgMessage_Store
+(
+    le_msg_MessageRef_t msgRef,     ///< [IN] The Message to be sent.
+    void*               recordPtr   ///< [OUT] Where to copy the message to.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a message from a shared memory record that was filled in using msgMessage_Store().
+ *
+ * @return The message, or NULL if the record is not a valid message for the session's protocol.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_MessageRef_t msgMessage_Load
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Session that the message is received on.
+    const void*         recordPtr,  ///< [IN] Where to copy the message from.
+    size_t              recordSize  ///< [IN] Size of the record, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the size of the largest message as it is sent (transaction ID and maximum payload) for a
+ * given protocol.
+ *
+ * @return The size, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t msgMessage_GetRecordSize
+(
+    le_msg_ProtocolRef_t protocolRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return sizeof(((Message_t*)NULL)->txnId) + le_msg_GetProtocolMaxMsgSize(protocolRef);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets a pointer to the queue link inside a Message object.
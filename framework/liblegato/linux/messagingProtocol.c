@@ -115,7 +115,25 @@ static msgProtocol_Protocol_t* CreateProtocol
         LE_CRIT("Protocol identifier truncated from '%s' to '%s'.", protocolId, protocolPtr->id);
     }
 
-    protocolPtr->messagePoolRef = msgMessage_CreatePool(protocolId, largestMsgSize);
+    // Messages are allocated from the smallest class that fits them, so that a protocol with a
+    // few big messages doesn't make all of its messages big.
+    size_t classSize = MSGPROTO_MIN_CLASS_BYTES;
+    protocolPtr->classCount = 0;
+    while ((classSize < largestMsgSize) && (protocolPtr->classCount < (MSGPROTO_MAX_CLASSES - 1)))
+    {
+        protocolPtr->classPayloadSize[protocolPtr->classCount] = classSize;
+        protocolPtr->classCount++;
+        classSize *= 2;
+    }
+    protocolPtr->classPayloadSize[protocolPtr->classCount] = largestMsgSize;
+    protocolPtr->classCount++;
+
+    size_t i;
+    for (i = 0; i < protocolPtr->classCount; i++)
+    {
+        protocolPtr->messagePoolRef[i] = msgMessage_CreatePool(protocolId,
+                                                               protocolPtr->classPayloadSize[i]);
+    }
 
     LOCK
 
@@ -127,6 +145,37 @@ static msgProtocol_Protocol_t* CreateProtocol
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the smallest class of Message objects in a protocol that can hold a given payload size.
+ *
+ * @return The index of the class.  Never returns if the payload is too big for the protocol.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t FindClass
+(
+    le_msg_ProtocolRef_t protocolRef,
+    size_t payloadSize      ///< [in] Size of the message payload, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i;
+
+    for (i = 0; i < protocolRef->classCount; i++)
+    {
+        if (payloadSize <= protocolRef->classPayloadSize[i])
+        {
+            return i;
+        }
+    }
+
+    LE_FATAL("Message payload size %zu is bigger than the maximum (%zu) for protocol '%s'.",
+             payloadSize,
+             protocolRef->maxPayloadSize,
+             protocolRef->id);
+}
+
+
 // =======================================
 //  PROTECTED (INTER-MODULE) FUNCTIONS
 // =======================================
@@ -150,19 +199,20 @@ void msgProto_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Allocate a Message object from a given Protocol's Message Pool.
+ * Allocate a Message object from the smallest of a given Protocol's Message Pools that can hold a
+ * given payload size.
  *
  * @return A pointer to the (uninitialized) Message object memory.
  */
 //--------------------------------------------------------------------------------------------------
 le_msg_MessageRef_t msgProto_AllocMessage
 (
-    le_msg_ProtocolRef_t protocolRef
+    le_msg_ProtocolRef_t protocolRef,
+    size_t payloadSize      ///< [in] Size of the message payload, in bytes.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Allocate a Message object from this Protocol's Message Pool.
-    return le_mem_ForceAlloc(protocolRef->messagePoolRef);
+    return le_mem_ForceAlloc(protocolRef->messagePoolRef[FindClass(protocolRef, payloadSize)]);
 }
 
 
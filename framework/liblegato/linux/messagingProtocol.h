@@ -10,6 +10,23 @@
 
 #include "limit.h"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Payload size of the smallest class of Message objects.  Each class is twice the size of the one
+ * before it, except for the largest, which is the protocol's maximum payload size.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSGPROTO_MIN_CLASS_BYTES    64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of size classes of Message objects in a protocol.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSGPROTO_MAX_CLASSES        16
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Represents a messaging protocol.
@@ -20,7 +37,10 @@ typedef struct le_msg_Protocol
     le_sls_Link_t link;                     ///< Used to link this into the Protocol List.
     char id[LIMIT_MAX_PROTOCOL_ID_BYTES];   ///< Unique identifier for the protocol.
     size_t maxPayloadSize;                  ///< Max payload size (in bytes) in this protocol.
-    le_mem_PoolRef_t messagePoolRef;        ///< Pool of Message objects.
+    size_t classCount;                      ///< Number of size classes of Message objects.
+    size_t classPayloadSize[MSGPROTO_MAX_CLASSES];  ///< Payload size of each class, smallest first.
+    le_mem_PoolRef_t messagePoolRef[MSGPROTO_MAX_CLASSES];  ///< Pool of Message objects of each
+                                                            ///  size class.
 }
 msgProtocol_Protocol_t;
 
@@ -39,14 +59,16 @@ void msgProto_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Allocate a Message object from a given Protocol's Message Pool.
+ * Allocate a Message object from the smallest of a given Protocol's Message Pools that can hold a
+ * given payload size.
  *
  * @return A pointer to the (uninitialized) Message object memory.
  */
 //--------------------------------------------------------------------------------------------------
 le_msg_MessageRef_t msgProto_AllocMessage
 (
-    le_msg_ProtocolRef_t protocolRef
+    le_msg_ProtocolRef_t protocolRef,
+    size_t payloadSize      ///< [in] Size of the message payload, in bytes.
 );
 
 
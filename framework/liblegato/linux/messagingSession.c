@@ -16,6 +16,7 @@
 #include "messagingSession.h"
 #include "messagingProtocol.h"
 #include "messagingMessage.h"
+#include "messagingSharedMem.h"
 #include "fileDescriptor.h"
 
 
@@ -87,6 +88,7 @@ static size_t* SessionObjListChangeCountRef = &SessionObjListChangeCount;
 // =======================================
 
 static void AttemptOpen(msgSession_Session_t* sessionPtr);
+static void SendFromTransmitQueue(msgSession_Session_t* sessionPtr);
 
 
 //--------------------------------------------------------------------------------------------------
@@ -413,6 +415,27 @@ static void PurgeReceiveQueue
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all messages from the queue of messages waiting for their shared memory markers and
+ * deletes them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PurgeFdMsgQueue
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr;
+
+    while (NULL != (linkPtr = le_dls_Pop(&sessionPtr->fdMsgQueue)))
+    {
+        le_msg_ReleaseMsg(msgMessage_GetMessageContainingLink(linkPtr));
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a Session object.
@@ -448,6 +471,9 @@ static msgSession_Session_t* CreateSession
     sessionPtr->closeHandler = NULL;
     sessionPtr->closeContextPtr = NULL;
 
+    sessionPtr->shmPtr = NULL;
+    sessionPtr->fdMsgQueue = LE_DLS_LIST_INIT;
+
     sessionPtr->interfaceRef = interfaceRef;
 
     SessionObjListChangeCount++;
@@ -497,6 +523,13 @@ static void CloseSession
     }
     PurgeTransmitQueue(sessionPtr);
     PurgeReceiveQueue(sessionPtr);
+    PurgeFdMsgQueue(sessionPtr);
+
+    if (sessionPtr->shmPtr != NULL)
+    {
+        msgShm_Delete(sessionPtr->shmPtr);
+        sessionPtr->shmPtr = NULL;
+    }
 }
 
 
@@ -613,6 +646,75 @@ static inline void DisableWriteabilityNotification
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gives up on a session whose shared memory transport has gone wrong (the far side has corrupted
+ * the shared memory or broken the token protocol).
+ *
+ * The socket is shut down, so that the FD Monitor reports a hang-up and the session gets closed
+ * in the usual way.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AbortSharedMem
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ERROR("Shared memory transport failed for session with (%s:%s). Closing session.",
+             le_msg_GetInterfaceName(sessionPtr->interfaceRef),
+             le_msg_GetProtocolIdStr(le_msg_GetSessionProtocol(sessionPtr)));
+
+    if (sessionPtr->shmPtr != NULL)
+    {
+        sessionPtr->shmPtr->txEnabled = false;
+        sessionPtr->shmPtr->rxEnabled = false;
+    }
+
+    shutdown(sessionPtr->socketFd, SHUT_RDWR);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps the shared memory offered by the server and tells the server that we will use it.
+ *
+ * If anything goes wrong, the session just carries on using only the socket.
+ *
+ * @note    This is used only on the client side.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AttachSharedMem
+(
+    msgSession_Session_t* sessionPtr,
+    int shmFd   ///< [IN] Shared memory file descriptor received from the server.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgShm_Transport_t* shmPtr;
+
+    shmPtr = msgShm_Attach(shmFd, msgMessage_GetRecordSize(le_msg_GetSessionProtocol(sessionPtr)));
+    if (shmPtr == NULL)
+    {
+        return;
+    }
+
+    // If this fails, the socket is broken and the session will fail to open anyway.
+    if (msgShm_SendToken(sessionPtr->socketFd, MSGSHM_TOKEN_ATTACH) != LE_OK)
+    {
+        msgShm_Delete(shmPtr);
+        return;
+    }
+
+    TRACE("Using shared memory for session with (%s:%s).",
+          le_msg_GetInterfaceName(sessionPtr->interfaceRef),
+          le_msg_GetProtocolIdStr(le_msg_GetSessionProtocol(sessionPtr)));
+
+    shmPtr->txEnabled = true;
+    sessionPtr->shmPtr = shmPtr;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Performs a retry on a failed attempt to open a session.
@@ -656,13 +758,19 @@ static le_result_t ReceiveSessionOpenResponse
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // We expect to receive a very small message (one le_result_t).
+    // We expect to receive a very small message (one le_result_t), possibly with a shared memory
+    // file descriptor attached to it.
     le_result_t serverResponse;
     size_t  bytesReceived = sizeof(serverResponse);
+    int shmFd;
 
     // Receive the message.
     le_result_t result;
-    result = unixSocket_ReceiveDataMsg(sessionPtr->socketFd, &serverResponse, &bytesReceived);
+    result = unixSocket_ReceiveMsg(sessionPtr->socketFd,
+                                   &serverResponse,
+                                   &bytesReceived,
+                                   &shmFd,
+                                   NULL);   // Don't receive credentials.
 
     if (result == LE_OK)
     {
@@ -672,6 +780,13 @@ static le_result_t ReceiveSessionOpenResponse
             TRACE("Session opened on interface (%s:%s)",
                   le_msg_GetInterfaceName(interfaceRef),
                   le_msg_GetProtocolIdStr(le_msg_GetSessionProtocol(sessionPtr)));
+
+            // If the server offered shared memory, take it.
+            if (shmFd >= 0)
+            {
+                AttachSharedMem(sessionPtr, shmFd);
+                shmFd = -1;
+            }
         }
         else if ((serverResponse == LE_UNAVAILABLE) || (serverResponse == LE_NOT_PERMITTED))
         {
@@ -683,6 +798,11 @@ static le_result_t ReceiveSessionOpenResponse
                      serverResponse,
                      LE_RESULT_TXT(serverResponse));
         }
+
+        if (shmFd >= 0)
+        {
+            fd_Close(shmFd);
+        }
     }
     // If the server died just as it was about to send an OK message, then we'll get LE_CLOSED.
     // Otherwise, it's a fatal error because nothing else should be possible.
@@ -697,7 +817,9 @@ static le_result_t ReceiveSessionOpenResponse
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Sends an LE_OK session open response to the client.
+ * Sends an LE_OK session open response to the client, offering it shared memory if available.
+ *
+ * Clients that don't support shared memory just discard the file descriptor.
  *
  * @return  LE_OK if successful, LE_COMM_ERROR if failed.
  *
@@ -706,30 +828,26 @@ static le_result_t ReceiveSessionOpenResponse
 //--------------------------------------------------------------------------------------------------
 static le_result_t SendSessionOpenResponse
 (
-    int socketFd    ///< [IN] Connected socket to send through.
+    int socketFd,   ///< [IN] Connected socket to send through.
+    int shmFd       ///< [IN] Shared memory file descriptor to offer to the client (-1 if none).
 )
 //--------------------------------------------------------------------------------------------------
 {
-    const le_result_t response = LE_OK;
-    ssize_t bytesSent;
-
-    do
-    {
-        bytesSent = send(socketFd, &response, sizeof(response), MSG_EOR);
-    }
-    while ((bytesSent == -1) && (errno == EINTR));
+    le_result_t response = LE_OK;
 
-    if (bytesSent < 0)
+    le_result_t result = unixSocket_SendMsg(socketFd,
+                                            &response,
+                                            sizeof(response),
+                                            shmFd,
+                                            false); // Don't send credentials.
+    if (result != LE_OK)
     {
         // Failed to send!
-        LE_ERROR("send() failed. Errno = %d (%m).", errno);
+        LE_ERROR("Failed to send session open response (%s).", LE_RESULT_TXT(result));
         return LE_COMM_ERROR;
     }
-    else
-    {
-        LE_ASSERT(bytesSent == sizeof(response));
-        return LE_OK;
-    }
+
+    return LE_OK;
 }
 
 
@@ -902,33 +1020,233 @@ static void ClientSocketError
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Receive messages from the socket and put them on the Receive Queue.
+ * Acts on a shared memory transport token received through a session's socket.
+ *
+ * @return  LE_OK if successful, LE_COMM_ERROR if the session has to be given up on.
  */
 //--------------------------------------------------------------------------------------------------
-static void ReceiveMessages
+static le_result_t HandleToken
+(
+    msgSession_Session_t* sessionPtr,
+    int token
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgShm_Transport_t* shmPtr = sessionPtr->shmPtr;
+    msgInterface_Type_t interfaceType = sessionPtr->interfaceRef->interfaceType;
+
+    if (shmPtr == NULL)
+    {
+        // Fall through to the error below.
+    }
+    else if (   (token == MSGSHM_TOKEN_ATTACH)
+             && (interfaceType == LE_MSG_INTERFACE_SERVER)
+             && !shmPtr->rxEnabled )
+    {
+        // The client will send through shared memory from now on.  Tell it that we will too.
+        shmPtr->rxEnabled = true;
+        if (msgShm_SendToken(sessionPtr->socketFd, MSGSHM_TOKEN_SWITCH) != LE_OK)
+        {
+            return LE_COMM_ERROR;
+        }
+        shmPtr->txEnabled = true;
+
+        // Anything waiting on the Transmit Queue can go through shared memory now.
+        shmPtr->txResume = true;
+
+        TRACE("Using shared memory for session with client of (%s:%s).",
+              le_msg_GetInterfaceName(sessionPtr->interfaceRef),
+              le_msg_GetProtocolIdStr(le_msg_GetSessionProtocol(sessionPtr)));
+        return LE_OK;
+    }
+    else if (   (token == MSGSHM_TOKEN_SWITCH)
+             && (interfaceType == LE_MSG_INTERFACE_CLIENT)
+             && !shmPtr->rxEnabled )
+    {
+        shmPtr->rxEnabled = true;
+        return LE_OK;
+    }
+    else if ((token == MSGSHM_TOKEN_WAKEUP) && shmPtr->rxEnabled)
+    {
+        // Nothing to do.  The receive ring is always read after the socket.
+        return LE_OK;
+    }
+    else if ((token == MSGSHM_TOKEN_SPACE) && shmPtr->txEnabled)
+    {
+        shmPtr->txResume = true;
+        return LE_OK;
+    }
+
+    LE_ERROR("Unexpected shared memory token 0x%02x.", token);
+    AbortSharedMem(sessionPtr);
+
+    return LE_COMM_ERROR;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive one message or token from a session's socket.  Messages are put on the Receive Queue,
+ * or, if they have been sent through the socket in place of the shared memory, on the queue of
+ * messages waiting for their markers.
+ *
+ * @return
+ * - LE_OK if a message or token was received.
+ * - LE_WOULD_BLOCK if there was nothing to receive and the socket is set non-blocking.
+ * - LE_CLOSED if the connection has closed.
+ * - LE_COMM_ERROR if an error was encountered.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReceiveFromSocket
 (
     msgSession_Session_t* sessionPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    for (;;)
+    int token;
+    le_msg_MessageRef_t msgRef;
+
+    // Receive a Message object from the socket.
+    le_result_t result = msgMessage_Receive(sessionPtr->socketFd, sessionPtr, &msgRef, &token);
+
+    if (result != LE_OK)
     {
-        // Create a Message object.
-        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionPtr);
+        return result;
+    }
 
-        // Receive from the socket into the Message object.
-        le_result_t result = msgMessage_Receive(sessionPtr->socketFd, msgRef);
+    if (token >= 0)
+    {
+        return HandleToken(sessionPtr, token);
+    }
 
-        if (result == LE_OK)
+    if ((sessionPtr->shmPtr != NULL) && sessionPtr->shmPtr->rxEnabled)
+    {
+        le_dls_Queue(&sessionPtr->fdMsgQueue, msgMessage_GetQueueLinkPtr(msgRef));
+    }
+    else
+    {
+        PushReceiveQueue(sessionPtr, msgRef);
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive all the messages waiting in a session's shared memory and put them on the Receive Queue.
+ *
+ * When this returns LE_OK, the far side has been asked to send a WAKEUP token when it next sends
+ * something through shared memory.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_WOULD_BLOCK if a message that was sent through the socket can't be received yet.
+ * - LE_CLOSED if the connection has closed.
+ * - LE_COMM_ERROR if an error was encountered.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReceiveFromSharedMem
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgShm_Transport_t* shmPtr = sessionPtr->shmPtr;
+
+    while ((shmPtr != NULL) && shmPtr->rxEnabled)
+    {
+        msgShm_RecordType_t type;
+        const void* recordPtr;
+        size_t recordSize;
+        le_msg_MessageRef_t msgRef;
+
+        le_result_t result = msgShm_Peek(shmPtr, &type, &recordPtr, &recordSize);
+
+        if (result == LE_WOULD_BLOCK)
+        {
+            if (!msgShm_PrepareToWait(shmPtr))
+            {
+                return LE_OK;
+            }
+            continue;
+        }
+        else if (result != LE_OK)
+        {
+            AbortSharedMem(sessionPtr);
+            return LE_COMM_ERROR;
+        }
+
+        if (type == MSGSHM_RECORD_MESSAGE)
         {
-            // Received something.  Push it onto the Receive Queue for later processing.
-            PushReceiveQueue(sessionPtr, msgRef);
+            msgRef = msgMessage_Load(sessionPtr, recordPtr, recordSize);
+            if (msgRef == NULL)
+            {
+                AbortSharedMem(sessionPtr);
+                return LE_COMM_ERROR;
+            }
         }
         else
         {
-            // Nothing left to receive from the socket.  We are done.
-            le_msg_ReleaseMsg(msgRef);
-            break;
+            le_dls_Link_t* linkPtr = le_dls_Pop(&sessionPtr->fdMsgQueue);
+
+            if (linkPtr == NULL)
+            {
+                // The message that goes here was sent through the socket before its marker was
+                // published, so it is already in the socket, behind whatever we haven't received
+                // yet.
+                result = ReceiveFromSocket(sessionPtr);
+                if (result != LE_OK)
+                {
+                    return result;
+                }
+                continue;
+            }
+
+            msgRef = msgMessage_GetMessageContainingLink(linkPtr);
+        }
+
+        PushReceiveQueue(sessionPtr, msgRef);
+
+        if (msgShm_Consume(shmPtr)
+            && (msgShm_SendToken(sessionPtr->socketFd, MSGSHM_TOKEN_SPACE) != LE_OK))
+        {
+            return LE_COMM_ERROR;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive messages from the socket and the shared memory (if any) and put them on the Receive
+ * Queue.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReceiveMessages
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Receive until there is nothing left in the socket.  Errors are reported by the FD Monitor.
+    while (ReceiveFromSocket(sessionPtr) == LE_OK)
+    {
+    }
+
+    msgShm_Transport_t* shmPtr = sessionPtr->shmPtr;
+
+    if (shmPtr != NULL)
+    {
+        ReceiveFromSharedMem(sessionPtr);
+
+        // If a token asked for it, try again to send what is waiting on the Transmit Queue.
+        if (shmPtr->txResume)
+        {
+            shmPtr->txResume = false;
+            SendFromTransmitQueue(sessionPtr);
         }
     }
 }
@@ -982,8 +1300,70 @@ static void ServerSocketError
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Send messages from a session's Transmit Queue until either the socket becomes full or there
- * are no more messages waiting on the queue.
+ * Send a message through a session's shared memory.  If the message carries a file descriptor,
+ * the message goes through the socket and a marker goes through the shared memory in its place.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_WOULD_BLOCK if the shared memory is full.  A SPACE token will arrive when it isn't.
+ * - LE_NO_MEMORY if the socket is full.
+ * - LE_COMM_ERROR if an error was encountered.
+ * - LE_FAULT if sending through the socket failed for some other reason.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendToSharedMem
+(
+    msgSession_Session_t*   sessionPtr,
+    le_msg_MessageRef_t     msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgShm_Transport_t* shmPtr = sessionPtr->shmPtr;
+    msgShm_RecordType_t type = MSGSHM_RECORD_MESSAGE;
+    void* recordPtr;
+    size_t recordSize = 0;
+
+    // Reserve the slot first, so that there is always room for the marker once the message has
+    // gone through the socket.
+    le_result_t result = msgShm_Reserve(shmPtr, &recordPtr);
+
+    if (result == LE_FAULT)
+    {
+        AbortSharedMem(sessionPtr);
+        return LE_COMM_ERROR;
+    }
+    else if (result != LE_OK)
+    {
+        return result;
+    }
+
+    if (msgMessage_HasFd(msgRef))
+    {
+        result = msgMessage_Send(sessionPtr->socketFd, msgRef);
+        if (result != LE_OK)
+        {
+            return result;
+        }
+        type = MSGSHM_RECORD_MARKER;
+    }
+    else
+    {
+        recordSize = msgMessage_Store(msgRef, recordPtr);
+    }
+
+    if (msgShm_Publish(shmPtr, type, recordSize))
+    {
+        return msgShm_SendToken(sessionPtr->socketFd, MSGSHM_TOKEN_WAKEUP);
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send messages from a session's Transmit Queue until either the socket (or shared memory) becomes
+ * full or there are no more messages waiting on the queue.
  */
 //--------------------------------------------------------------------------------------------------
 static void SendFromTransmitQueue
@@ -1004,7 +1384,16 @@ static void SendFromTransmitQueue
             break;
         }
 
-        le_result_t result = msgMessage_Send(sessionPtr->socketFd, msgRef);
+        le_result_t result;
+
+        if ((sessionPtr->shmPtr != NULL) && sessionPtr->shmPtr->txEnabled)
+        {
+            result = SendToSharedMem(sessionPtr, msgRef);
+        }
+        else
+        {
+            result = msgMessage_Send(sessionPtr->socketFd, msgRef);
+        }
 
         switch (result)
         {
@@ -1053,6 +1442,14 @@ static void SendFromTransmitQueue
 
                 return;
 
+            case LE_WOULD_BLOCK:
+                // Have to wait for the far side to make room in the shared memory.  It will send
+                // a SPACE token when it does, so there's no need to watch for writeability.
+                UnPopTransmitQueue(sessionPtr, msgRef);
+                DisableWriteabilityNotification(sessionPtr);
+
+                return;
+
             case LE_COMM_ERROR:
                 // In this case, we expect a handler function to be called by the FD Monitor,
                 // so we don't need to handle this case here.  However, we must stop
@@ -1501,6 +1898,184 @@ static void TriggerDeferredProcessing
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Do a synchronous request-response transaction on a session that only uses its socket.
+ *
+ * @return  The response message, or NULL if the session failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_MessageRef_t DoSyncRequestResponseSocket
+(
+    msgSession_Session_t*   sessionPtr,
+    le_msg_MessageRef_t     msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_MessageRef_t rxMsgRef;
+
+    // Send the Request Message.
+    msgMessage_Send(sessionPtr->socketFd, msgRef);
+
+    // While we have not yet received the response we are waiting for, keep
+    // receiving messages.  Any that we receive that don't match the transaction ID
+    // that we are waiting for should be queued for later handling using a queued
+    // function call.
+    for (;;)
+    {
+        int token;
+
+        le_result_t result = msgMessage_Receive(sessionPtr->socketFd, sessionPtr, &rxMsgRef, &token);
+
+        if (result != LE_OK)
+        {
+            // The socket experienced an error or the connection was closed.
+            // No message was received.
+            break;
+        }
+
+        if (token >= 0)
+        {
+            // Shared memory tokens have no business on a session that only uses its socket.
+            LE_WARN("Ignoring unexpected shared memory token %d.", token);
+            continue;
+        }
+
+        if (msgMessage_GetTxnId(rxMsgRef) == msgMessage_GetTxnId(msgRef))
+        {
+            // Got the synchronous response we were waiting for.
+            break;
+        }
+
+        // Got some other message that we weren't waiting for.
+
+        // If the Receive Queue is empty, queue up a function call on the Event Queue so that
+        // the Event Loop will kick start processing of the Receive Queue later.
+        // (If there's already something on the Receive Queue, then we've already done that.)
+        if (le_dls_IsEmpty(&sessionPtr->receiveQueue))
+        {
+            TriggerDeferredProcessing(sessionPtr);
+        }
+
+        // Queue the received message to the Receive Queue for later processing.
+        PushReceiveQueue(sessionPtr, rxMsgRef);
+    }
+
+    return rxMsgRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the response to a given request message from a session's Receive Queue, if it is there.
+ *
+ * @return  The response message, or NULL if not found.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_MessageRef_t TakeResponse
+(
+    msgSession_Session_t*   sessionPtr,
+    le_msg_MessageRef_t     requestMsgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&sessionPtr->receiveQueue);
+
+    while (linkPtr != NULL)
+    {
+        le_msg_MessageRef_t msgRef = msgMessage_GetMessageContainingLink(linkPtr);
+
+        if (msgMessage_GetTxnId(msgRef) == msgMessage_GetTxnId(requestMsgRef))
+        {
+            le_dls_Remove(&sessionPtr->receiveQueue, linkPtr);
+            return msgRef;
+        }
+
+        linkPtr = le_dls_PeekNext(&sessionPtr->receiveQueue, linkPtr);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Do a synchronous request-response transaction on a session that has a shared memory transport.
+ *
+ * Works like msgSession_DoSyncRequestResponse(), except that messages can come from the shared
+ * memory as well as the socket, so everything received is put on the Receive Queue and the
+ * response is then picked out of it.
+ *
+ * @return  The response message, or NULL if the session failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_MessageRef_t DoSyncRequestResponseSharedMem
+(
+    msgSession_Session_t*   sessionPtr,
+    le_msg_MessageRef_t     msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgShm_Transport_t* shmPtr = sessionPtr->shmPtr;
+    le_msg_MessageRef_t rxMsgRef = NULL;
+    bool receiveQueueWasEmpty = le_dls_IsEmpty(&sessionPtr->receiveQueue);
+    le_result_t result;
+
+    // Send the Request Message.  If the shared memory is full, keep receiving from the socket
+    // until a SPACE token arrives.
+    for (;;)
+    {
+        if (shmPtr->txEnabled)
+        {
+            result = SendToSharedMem(sessionPtr, msgRef);
+        }
+        else
+        {
+            result = msgMessage_Send(sessionPtr->socketFd, msgRef);
+        }
+
+        if (result != LE_WOULD_BLOCK)
+        {
+            break;
+        }
+
+        result = ReceiveFromSocket(sessionPtr);
+        if (result != LE_OK)
+        {
+            break;
+        }
+    }
+
+    // Receive until the response turns up.  When there is nothing left in the shared memory,
+    // block on the socket until a WAKEUP token (or a message) arrives.
+    while (result == LE_OK)
+    {
+        result = ReceiveFromSharedMem(sessionPtr);
+
+        rxMsgRef = TakeResponse(sessionPtr, msgRef);
+        if (rxMsgRef != NULL)
+        {
+            break;
+        }
+
+        if (result == LE_OK)
+        {
+            result = ReceiveFromSocket(sessionPtr);
+        }
+    }
+
+    // If other messages were received, queue up a function call on the Event Queue so that
+    // the Event Loop will kick start processing of the Receive Queue later.
+    // (If there was already something on the Receive Queue, then that has already been done.)
+    if (receiveQueueWasEmpty && !le_dls_IsEmpty(&sessionPtr->receiveQueue))
+    {
+        TriggerDeferredProcessing(sessionPtr);
+    }
+
+    return rxMsgRef;
+}
+
+
 // =======================================
 //  PROTECTED (INTER-MODULE) FUNCTIONS
 // =======================================
@@ -1670,46 +2245,13 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
     // Put the socket into blocking mode.
     fd_SetBlocking(sessionRef->socketFd);
 
-    // Send the Request Message.
-    msgMessage_Send(sessionRef->socketFd, msgRef);
-
-    // While we have not yet received the response we are waiting for, keep
-    // receiving messages.  Any that we receive that don't match the transaction ID
-    // that we are waiting for should be queued for later handling using a queued
-    // function call.
-    for (;;)
+    if (sessionRef->shmPtr != NULL)
     {
-        rxMsgRef = le_msg_CreateMsg(sessionRef);
-
-        le_result_t result = msgMessage_Receive(sessionRef->socketFd, rxMsgRef);
-
-        if (result != LE_OK)
-        {
-            // The socket experienced an error or the connection was closed.
-            // No message was received.
-            le_msg_ReleaseMsg(rxMsgRef);
-            rxMsgRef = NULL;
-            break;
-        }
-
-        if (msgMessage_GetTxnId(rxMsgRef) == msgMessage_GetTxnId(msgRef))
-        {
-            // Got the synchronous response we were waiting for.
-            break;
-        }
-
-        // Got some other message that we weren't waiting for.
-
-        // If the Receive Queue is empty, queue up a function call on the Event Queue so that
-        // the Event Loop will kick start processing of the Receive Queue later.
-        // (If there's already something on the Receive Queue, then we've already done that.)
-        if (le_dls_IsEmpty(&sessionRef->receiveQueue))
-        {
-            TriggerDeferredProcessing(sessionRef);
-        }
-
-        // Queue the received message to the Receive Queue for later processing.
-        PushReceiveQueue(sessionRef, rxMsgRef);
+        rxMsgRef = DoSyncRequestResponseSharedMem(sessionRef, msgRef);
+    }
+    else
+    {
+        rxMsgRef = DoSyncRequestResponseSocket(sessionRef, msgRef);
     }
 
     // Invalidate the ID for this transaction.
@@ -1721,6 +2263,14 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
     // Put the socket back into non-blocking mode.
     fd_SetNonBlocking(sessionRef->socketFd);
 
+    // If a SPACE token arrived while we were waiting, try again to send what is waiting on the
+    // Transmit Queue.
+    if ((sessionRef->shmPtr != NULL) && sessionRef->shmPtr->txResume)
+    {
+        sessionRef->shmPtr->txResume = false;
+        SendFromTransmitQueue(sessionRef);
+    }
+
     return rxMsgRef;
 }
 
@@ -1793,10 +2343,32 @@ le_msg_SessionRef_t msgSession_CreateServerSideSession
 )
 //--------------------------------------------------------------------------------------------------
 {
+    msgShm_Transport_t* shmPtr = NULL;
+    int shmFd = -1;
+
+    // If the service allows it, set up shared memory to offer to the client.
+    if (serviceRef->sharedMemEnabled)
+    {
+        shmPtr = msgShm_Create(msgMessage_GetRecordSize(serviceRef->interface.id.protocolRef),
+                               &shmFd);
+    }
+
     // Send a Hello message (LE_OK) to the client.
-    if (SendSessionOpenResponse(fd) != LE_OK)
+    le_result_t result = SendSessionOpenResponse(fd, shmFd);
+
+    // The client has its own copy of the shared memory fd now (if it wants it).
+    if (shmFd >= 0)
+    {
+        fd_Close(shmFd);
+    }
+
+    if (result != LE_OK)
     {
         // Something went wrong.  Abort.
+        if (shmPtr != NULL)
+        {
+            msgShm_Delete(shmPtr);
+        }
         fd_Close(fd);
         return NULL;
     }
@@ -1811,6 +2383,9 @@ le_msg_SessionRef_t msgSession_CreateServerSideSession
     // Record the client connection file descriptor.
     sessionPtr->socketFd = fd;
 
+    // The shared memory is only used once the client has attached to it.
+    sessionPtr->shmPtr = shmPtr;
+
     // Start monitoring the server-side session connection socket for events.
     StartSocketMonitoring(sessionPtr, ServerSocketEventHandler);
 
@@ -11,6 +11,7 @@
 #define LE_MESSAGING_SESSION_H_INCLUDE_GUARD
 
 #include "messagingInterface.h"
+#include "messagingSharedMem.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -61,6 +62,13 @@ typedef struct le_msg_Session
     void*                           openContextPtr; ///< Open handler's context pointer.
     le_msg_SessionEventHandler_t    closeHandler;   ///< Close handler function.
     void*                           closeContextPtr;///< Close handler's context pointer.
+
+    msgShm_Transport_t*             shmPtr;         ///< Shared memory transport (NULL if only the
+                                                    ///  socket is used).
+
+    le_dls_List_t                   fdMsgQueue;     ///< Queue of messages carrying fds that were
+                                                    ///  received through the socket and are
+                                                    ///  waiting for their marker in shared memory.
 }
 msgSession_Session_t;
 
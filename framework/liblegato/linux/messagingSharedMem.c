@@ -0,0 +1,743 @@
+/** @file messagingSharedMem.c
+ *
+ * The Shared Memory Transport module of the @ref c_messaging implementation.
+ *
+ * See @ref messaging.c for an overview of the @ref c_messaging implementation.
+ *
+ * Servers that enable it (using le_msg_EnableServiceSharedMem()) offer each new client a memfd
+ * by attaching it to the "hello" message that opens the session.  Clients that don't know about
+ * shared memory just discard the fd and keep using the socket.  Clients that do know about it map
+ * the memory, check that the layout is what they expect and send an ATTACH token to the server,
+ * after which they send their messages through the client-to-server ring.  When the server sees
+ * the ATTACH token, it starts reading the client-to-server ring, sends a SWITCH token back and
+ * starts sending its own messages through the server-to-client ring.  Because each side only
+ * switches after sending its token, and each side only starts reading the ring when it sees the
+ * other's token, messages sent through the socket before the switch are never overtaken by
+ * messages sent through the ring after it.
+ *
+ * Each ring is a single-producer, single-consumer queue of fixed-size slots, each of which is big
+ * enough to hold a message's transaction ID and the protocol's maximum payload.  The slot header
+ * says how much of the slot the message actually uses.  The head index is
+ * only ever written by the sender and the tail index only by the receiver.
+ *
+ * After the switch, the socket carries only:
+ * - WAKEUP tokens, sent by the sender when it publishes a record while the receiver has said
+ *   (using the readerWaiting flag) that it is about to go back to waiting on its socket,
+ * - SPACE tokens, sent by the receiver when it frees a slot while the sender has said (using
+ *   the writerWaiting flag) that it found the ring full,
+ * - messages carrying a file descriptor, which can't go through shared memory.  To keep them in
+ *   order with the others, a MARKER record is put in the ring after the message has been sent
+ *   through the socket, and the receiver holds such messages back until it reaches their marker.
+ *
+ * So, a steady stream of messages only costs a system call when the receiver runs out of work
+ * and has to sleep, and each message is copied once on each side instead of through the kernel.
+ *
+ * Because the far side can write anything it likes into the shared memory, all indexes and record
+ * types read from it are checked before use.  The memfd is sealed against shrinking so that
+ * neither side can make the other fault by truncating it.
+ *
+ * @warning The code in this file @b must be thread safe and re-entrant.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#ifndef MFD_CLOEXEC
+#include <linux/memfd.h>
+#endif
+#include "unixSocket.h"
+#include "messagingSharedMem.h"
+#include "fileDescriptor.h"
+
+
+// =======================================
+//  PRIVATE DATA
+// =======================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Shared memory transport is only available if the system has memfd_create() and file sealing.
+ */
+//--------------------------------------------------------------------------------------------------
+#if defined(SYS_memfd_create) && defined(F_ADD_SEALS)
+#define SHARED_MEM_SUPPORTED 1
+#else
+#define SHARED_MEM_SUPPORTED 0
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Identifies a shared memory region laid out by this version of this module.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SHARED_MEM_MAGIC    0x4c45534d  // "LESM"
+#define SHARED_MEM_VERSION  2
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a cache line.  The indexes written by each side are kept on separate cache lines, and
+ * slots are multiples of this size.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CACHE_LINE_BYTES    64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Limits on the size of each ring.  Protocols whose messages are too big for MIN_SLOTS to fit in
+ * MAX_RING_BYTES don't get offered shared memory.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SLOTS           16
+#define MIN_SLOTS           2
+#define MAX_RING_BYTES      (256 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Indexes of the two rings.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RING_CLIENT_TO_SERVER   0
+#define RING_SERVER_TO_CLIENT   1
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header at the start of every slot.  The record follows it.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t    type;       ///< msgShm_RecordType_t.
+    uint32_t    size;       ///< Size of the record, in bytes.  Also keeps the record 8-byte aligned.
+}
+SlotHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Control block of one ring.
+ */
+//--------------------------------------------------------------------------------------------------
+struct msgShm_Ring
+{
+    uint32_t    head __attribute__((aligned(CACHE_LINE_BYTES)));   ///< Next slot to be published.
+    uint32_t    writerWaiting;  ///< 1 = sender found the ring full and wants a SPACE token.
+
+    uint32_t    tail __attribute__((aligned(CACHE_LINE_BYTES)));   ///< Next slot to be consumed.
+    uint32_t    readerWaiting;  ///< 1 = receiver is about to wait for a WAKEUP token.
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Layout of the start of the shared memory.  The slots of the client-to-server ring start on the
+ * page after this, followed by the slots of the server-to-client ring.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t        magic;          ///< SHARED_MEM_MAGIC.
+    uint32_t        version;        ///< SHARED_MEM_VERSION.
+    uint32_t        recordSize;     ///< Size of a transaction ID plus maximum payload.
+    uint32_t        slotSize;       ///< Size of each slot, in bytes.
+    uint32_t        slotCount;      ///< Number of slots in each ring.
+    msgShm_Ring_t   ring[2];        ///< Indexed by RING_CLIENT_TO_SERVER or RING_SERVER_TO_CLIENT.
+}
+ControlBlock_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Transport objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t TransportPoolRef;
+
+
+// =======================================
+//  PRIVATE FUNCTIONS
+// =======================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Works out the layout of the shared memory for a given record size.
+ *
+ * @return LE_OK if successful, LE_OVERFLOW if records of that size are too big.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ComputeLayout
+(
+    size_t      recordSize,     ///< [IN] Size of a transaction ID plus maximum payload.
+    size_t*     slotSizePtr,    ///< [OUT] Size of each slot.
+    uint32_t*   slotCountPtr,   ///< [OUT] Number of slots in each ring.
+    size_t*     ctrlSizePtr,    ///< [OUT] Size of the control block, rounded up to a page.
+    size_t*     mapSizePtr      ///< [OUT] Total size of the shared memory.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t slotSize = sizeof(SlotHeader_t) + recordSize;
+    uint32_t slotCount = MAX_SLOTS;
+
+    slotSize = (slotSize + CACHE_LINE_BYTES - 1) & ~((size_t)CACHE_LINE_BYTES - 1);
+
+    while ((slotCount > MIN_SLOTS) && ((slotCount * slotSize) > MAX_RING_BYTES))
+    {
+        slotCount /= 2;
+    }
+
+    if ((slotCount * slotSize) > MAX_RING_BYTES)
+    {
+        return LE_OVERFLOW;
+    }
+
+    *slotSizePtr = slotSize;
+    *slotCountPtr = slotCount;
+    *ctrlSizePtr = (sizeof(ControlBlock_t) + pageSize - 1) & ~(pageSize - 1);
+    *mapSizePtr = *ctrlSizePtr + (2 * slotCount * slotSize);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a Transport object for a mapped shared memory region.
+ *
+ * @return Pointer to the new object.
+ */
+//--------------------------------------------------------------------------------------------------
+static msgShm_Transport_t* CreateTransport
+(
+    void*       basePtr,    ///< [IN] Start of the mapping.
+    size_t      mapSize,    ///< [IN] Size of the mapping.
+    size_t      ctrlSize,   ///< [IN] Size of the control block, rounded up to a page.
+    size_t      slotSize,   ///< [IN] Size of each slot.
+    uint32_t    slotCount,  ///< [IN] Number of slots in each ring.
+    int         txRing      ///< [IN] Index of the ring that this side writes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ControlBlock_t* ctrlPtr = basePtr;
+    uint8_t* slotsPtr[2];
+    int rxRing = (txRing == RING_CLIENT_TO_SERVER) ? RING_SERVER_TO_CLIENT : RING_CLIENT_TO_SERVER;
+
+    slotsPtr[RING_CLIENT_TO_SERVER] = (uint8_t*)basePtr + ctrlSize;
+    slotsPtr[RING_SERVER_TO_CLIENT] = slotsPtr[RING_CLIENT_TO_SERVER] + (slotCount * slotSize);
+
+    msgShm_Transport_t* shmPtr = le_mem_ForceAlloc(TransportPoolRef);
+
+    shmPtr->basePtr = basePtr;
+    shmPtr->mapSize = mapSize;
+    shmPtr->slotSize = slotSize;
+    shmPtr->slotCount = slotCount;
+
+    shmPtr->txRingPtr = &ctrlPtr->ring[txRing];
+    shmPtr->txSlotsPtr = slotsPtr[txRing];
+    shmPtr->txHead = __atomic_load_n(&shmPtr->txRingPtr->head, __ATOMIC_ACQUIRE);
+
+    shmPtr->rxRingPtr = &ctrlPtr->ring[rxRing];
+    shmPtr->rxSlotsPtr = slotsPtr[rxRing];
+    shmPtr->rxTail = __atomic_load_n(&shmPtr->rxRingPtr->tail, __ATOMIC_ACQUIRE);
+
+    shmPtr->txEnabled = false;
+    shmPtr->rxEnabled = false;
+    shmPtr->txResume = false;
+
+    return shmPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates an anonymous, sealable memory file.
+ *
+ * @return The file descriptor, or -1 on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CreateMemFd
+(
+    const char* name
+)
+//--------------------------------------------------------------------------------------------------
+{
+#if SHARED_MEM_SUPPORTED
+    return syscall(SYS_memfd_create, name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Seals a memory file so that its size can't be changed anymore.
+ *
+ * @return true if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool Seal
+(
+    int fd
+)
+//--------------------------------------------------------------------------------------------------
+{
+#if SHARED_MEM_SUPPORTED
+    return (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == 0);
+#else
+    return false;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks that a memory file has been sealed against shrinking.
+ *
+ * @return true if it has.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSealed
+(
+    int fd
+)
+//--------------------------------------------------------------------------------------------------
+{
+#if SHARED_MEM_SUPPORTED
+    int seals = fcntl(fd, F_GET_SEALS);
+
+    return ((seals >= 0) && ((seals & F_SEAL_SHRINK) != 0));
+#else
+    return false;
+#endif
+}
+
+
+// =======================================
+//  PROTECTED (INTER-MODULE) FUNCTIONS
+// =======================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes this module.  This must be called only once at start-up, before any other functions
+ * in this module are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgShm_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    TransportPoolRef = le_mem_CreatePool("MsgShmTransport", sizeof(msgShm_Transport_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates the shared memory for a new server-side session.
+ *
+ * @return A pointer to the transport, or NULL if shared memory can't be used for messages of this
+ *         size (or at all on this system).
+ */
+//--------------------------------------------------------------------------------------------------
+msgShm_Transport_t* msgShm_Create
+(
+    size_t  recordSize, ///< [IN] Size of a message's transaction ID plus its maximum payload.
+    int*    fdPtr       ///< [OUT] File descriptor of the shared memory, to be sent to the client.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t slotSize;
+    uint32_t slotCount;
+    size_t ctrlSize;
+    size_t mapSize;
+
+    if (ComputeLayout(recordSize, &slotSize, &slotCount, &ctrlSize, &mapSize) != LE_OK)
+    {
+        LE_DEBUG("Messages of %zu bytes are too big for shared memory.", recordSize);
+        return NULL;
+    }
+
+    int fd = CreateMemFd("le_msg");
+    if (fd < 0)
+    {
+        LE_DEBUG("Can't create shared memory (%m).");
+        return NULL;
+    }
+
+    if (ftruncate(fd, mapSize) != 0)
+    {
+        LE_ERROR("Failed to size shared memory to %zu bytes (%m).", mapSize);
+        fd_Close(fd);
+        return NULL;
+    }
+
+    if (!Seal(fd))
+    {
+        LE_ERROR("Failed to seal shared memory (%m).");
+        fd_Close(fd);
+        return NULL;
+    }
+
+    void* basePtr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (basePtr == MAP_FAILED)
+    {
+        LE_ERROR("Failed to map %zu bytes of shared memory (%m).", mapSize);
+        fd_Close(fd);
+        return NULL;
+    }
+
+    // The file starts out zeroed, so the indexes and flags are already 0.  Both sides start out
+    // as waiting so that the first record published in each direction comes with a WAKEUP token.
+    ControlBlock_t* ctrlPtr = basePtr;
+    ctrlPtr->magic = SHARED_MEM_MAGIC;
+    ctrlPtr->version = SHARED_MEM_VERSION;
+    ctrlPtr->recordSize = recordSize;
+    ctrlPtr->slotSize = slotSize;
+    ctrlPtr->slotCount = slotCount;
+    ctrlPtr->ring[RING_CLIENT_TO_SERVER].readerWaiting = 1;
+    ctrlPtr->ring[RING_SERVER_TO_CLIENT].readerWaiting = 1;
+
+    *fdPtr = fd;
+
+    return CreateTransport(basePtr, mapSize, ctrlSize, slotSize, slotCount, RING_SERVER_TO_CLIENT);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps the shared memory offered by a server into a client-side session.
+ *
+ * @return A pointer to the transport, or NULL if the shared memory is not usable.
+ *
+ * @note Closes the file descriptor in all cases.
+ */
+//--------------------------------------------------------------------------------------------------
+msgShm_Transport_t* msgShm_Attach
+(
+    int     fd,         ///< [IN] File descriptor received from the server.
+    size_t  recordSize  ///< [IN] Size of a message's transaction ID plus its maximum payload.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgShm_Transport_t* shmPtr = NULL;
+    size_t slotSize;
+    uint32_t slotCount;
+    size_t ctrlSize;
+    size_t mapSize;
+    struct stat fileInfo;
+
+    if (ComputeLayout(recordSize, &slotSize, &slotCount, &ctrlSize, &mapSize) != LE_OK)
+    {
+        LE_WARN("Server offered shared memory for messages that are too big.");
+    }
+    // Without this seal, the server could truncate the file and make us fault.
+    else if (!IsSealed(fd))
+    {
+        LE_WARN("Server offered shared memory that is not sealed.");
+    }
+    else if ((fstat(fd, &fileInfo) != 0) || (fileInfo.st_size != (off_t)mapSize))
+    {
+        LE_WARN("Server offered shared memory of the wrong size.");
+    }
+    else
+    {
+        void* basePtr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (basePtr == MAP_FAILED)
+        {
+            LE_ERROR("Failed to map %zu bytes of shared memory (%m).", mapSize);
+        }
+        else
+        {
+            const ControlBlock_t* ctrlPtr = basePtr;
+
+            if (   (ctrlPtr->magic != SHARED_MEM_MAGIC)
+                || (ctrlPtr->version != SHARED_MEM_VERSION)
+                || (ctrlPtr->recordSize != recordSize)
+                || (ctrlPtr->slotSize != slotSize)
+                || (ctrlPtr->slotCount != slotCount) )
+            {
+                LE_WARN("Server offered shared memory with an unknown layout.");
+                munmap(basePtr, mapSize);
+            }
+            else
+            {
+                shmPtr = CreateTransport(basePtr,
+                                         mapSize,
+                                         ctrlSize,
+                                         slotSize,
+                                         slotCount,
+                                         RING_CLIENT_TO_SERVER);
+            }
+        }
+    }
+
+    fd_Close(fd);
+
+    return shmPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmaps the shared memory and deletes a transport.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgShm_Delete
+(
+    msgShm_Transport_t* shmPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    munmap(shmPtr->basePtr, shmPtr->mapSize);
+
+    le_mem_Release(shmPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the next free slot in the transmit ring.  The record must be published using
+ * msgShm_Publish() before the far side can see it.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_WOULD_BLOCK if the ring is full.  A SPACE token will arrive when it is no longer full.
+ * - LE_FAULT if the far side has corrupted the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgShm_Reserve
+(
+    msgShm_Transport_t* shmPtr,
+    void**              recordPtrPtr    ///< [OUT] Where the record is to be written.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgShm_Ring_t* ringPtr = shmPtr->txRingPtr;
+    uint32_t used = shmPtr->txHead - __atomic_load_n(&ringPtr->tail, __ATOMIC_ACQUIRE);
+
+    if (used == shmPtr->slotCount)
+    {
+        // Ask for a SPACE token, then look again in case the receiver freed a slot before it
+        // could see the request.  If it did, the SPACE token that may still come is harmless.
+        __atomic_store_n(&ringPtr->writerWaiting, 1, __ATOMIC_SEQ_CST);
+        used = shmPtr->txHead - __atomic_load_n(&ringPtr->tail, __ATOMIC_SEQ_CST);
+
+        if (used == shmPtr->slotCount)
+        {
+            return LE_WOULD_BLOCK;
+        }
+    }
+
+    if (used > shmPtr->slotCount)
+    {
+        LE_ERROR("Shared memory ring tail is corrupt (head %u, tail %u).",
+                 shmPtr->txHead,
+                 shmPtr->txHead - used);
+        return LE_FAULT;
+    }
+
+    uint8_t* slotPtr = shmPtr->txSlotsPtr
+                     + ((shmPtr->txHead & (shmPtr->slotCount - 1)) * shmPtr->slotSize);
+
+    *recordPtrPtr = slotPtr + sizeof(SlotHeader_t);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Publishes the record that was last reserved using msgShm_Reserve().
+ *
+ * @return true if the far side is waiting and must be sent a WAKEUP token.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgShm_Publish
+(
+    msgShm_Transport_t* shmPtr,
+    msgShm_RecordType_t type,
+    size_t              size        ///< Size of the record, in bytes (0 for a MARKER).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgShm_Ring_t* ringPtr = shmPtr->txRingPtr;
+    SlotHeader_t* slotPtr = (SlotHeader_t*)(shmPtr->txSlotsPtr
+                            + ((shmPtr->txHead & (shmPtr->slotCount - 1)) * shmPtr->slotSize));
+
+    slotPtr->type = type;
+    slotPtr->size = size;
+
+    shmPtr->txHead++;
+    __atomic_store_n(&ringPtr->head, shmPtr->txHead, __ATOMIC_RELEASE);
+
+    // The new head must be visible before we look at the flag, or else the receiver could set the
+    // flag, see the old head and go to sleep without us sending it a token.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return (   (__atomic_load_n(&ringPtr->readerWaiting, __ATOMIC_RELAXED) != 0)
+            && (__atomic_exchange_n(&ringPtr->readerWaiting, 0, __ATOMIC_SEQ_CST) != 0) );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks at the oldest record in the receive ring, without removing it.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_WOULD_BLOCK if the ring is empty.
+ * - LE_FAULT if the far side has corrupted the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgShm_Peek
+(
+    msgShm_Transport_t*     shmPtr,
+    msgShm_RecordType_t*    typePtr,        ///< [OUT] Type of record.
+    const void**            recordPtrPtr,   ///< [OUT] The record.
+    size_t*                 sizePtr         ///< [OUT] Size of the record, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint32_t available = __atomic_load_n(&shmPtr->rxRingPtr->head, __ATOMIC_ACQUIRE)
+                       - shmPtr->rxTail;
+
+    if (available == 0)
+    {
+        return LE_WOULD_BLOCK;
+    }
+
+    if (available > shmPtr->slotCount)
+    {
+        LE_ERROR("Shared memory ring head is corrupt (head %u, tail %u).",
+                 shmPtr->rxTail + available,
+                 shmPtr->rxTail);
+        return LE_FAULT;
+    }
+
+    const SlotHeader_t* slotPtr = (const SlotHeader_t*)(shmPtr->rxSlotsPtr
+                                + ((shmPtr->rxTail & (shmPtr->slotCount - 1)) * shmPtr->slotSize));
+    uint32_t type = __atomic_load_n(&slotPtr->type, __ATOMIC_RELAXED);
+    uint32_t size = __atomic_load_n(&slotPtr->size, __ATOMIC_RELAXED);
+
+    if ((type != MSGSHM_RECORD_MESSAGE) && (type != MSGSHM_RECORD_MARKER))
+    {
+        LE_ERROR("Shared memory record type %u is invalid.", type);
+        return LE_FAULT;
+    }
+
+    if (size > (shmPtr->slotSize - sizeof(SlotHeader_t)))
+    {
+        LE_ERROR("Shared memory record size %u is too big for its slot.", size);
+        return LE_FAULT;
+    }
+
+    *typePtr = type;
+    *recordPtrPtr = slotPtr + 1;
+    *sizePtr = size;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the oldest record from the receive ring.
+ *
+ * @return true if the far side is waiting for space and must be sent a SPACE token.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgShm_Consume
+(
+    msgShm_Transport_t* shmPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgShm_Ring_t* ringPtr = shmPtr->rxRingPtr;
+
+    shmPtr->rxTail++;
+    __atomic_store_n(&ringPtr->tail, shmPtr->rxTail, __ATOMIC_RELEASE);
+
+    // Same reasoning as in msgShm_Publish(), with the roles reversed.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return (   (__atomic_load_n(&ringPtr->writerWaiting, __ATOMIC_RELAXED) != 0)
+            && (__atomic_exchange_n(&ringPtr->writerWaiting, 0, __ATOMIC_SEQ_CST) != 0) );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tells the far side that this side is about to wait for a WAKEUP token before reading the
+ * receive ring again.
+ *
+ * @return true if the ring is not empty after all, in which case the caller must keep reading.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgShm_PrepareToWait
+(
+    msgShm_Transport_t* shmPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgShm_Ring_t* ringPtr = shmPtr->rxRingPtr;
+
+    __atomic_store_n(&ringPtr->readerWaiting, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&ringPtr->head, __ATOMIC_SEQ_CST) == shmPtr->rxTail)
+    {
+        return false;
+    }
+
+    // Something was published before the sender could see the flag.  Take the flag back so that
+    // it doesn't send a token for it (if it already has, the token will just be ignored).
+    __atomic_store_n(&ringPtr->readerWaiting, 0, __ATOMIC_RELAXED);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a token through a session's socket, waiting for buffer space if the socket is full.
+ *
+ * Tokens must never be dropped, or the far side could wait forever.  The socket only fills up if
+ * many messages carrying file descriptors are in flight, so the wait is expected to be rare and
+ * short.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_COMM_ERROR if the socket is broken.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgShm_SendToken
+(
+    int             socketFd,
+    msgShm_Token_t  token
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint8_t tokenByte = token;
+    le_result_t result;
+
+    while ((result = unixSocket_SendDataMsg(socketFd, &tokenByte, 1)) == LE_NO_MEMORY)
+    {
+        struct pollfd pollInfo = { .fd = socketFd, .events = POLLOUT };
+
+        if ((poll(&pollInfo, 1, -1) < 0) && (errno != EINTR))
+        {
+            LE_ERROR("poll() failed with errno %d (%m).", errno);
+            return LE_COMM_ERROR;
+        }
+    }
+
+    return (result == LE_OK) ? LE_OK : LE_COMM_ERROR;
+}
@@ -0,0 +1,232 @@
+/** @file messagingSharedMem.h
+ *
+ * Inter-module definitions exported by the Shared Memory Transport module of the
+ * @ref c_messaging implementation.
+ *
+ * See @ref messagingSharedMem.c for a description of how the transport works.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LE_MESSAGING_SHARED_MEM_H_INCLUDE_GUARD
+#define LE_MESSAGING_SHARED_MEM_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Types of record that can be found in a shared memory ring.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    MSGSHM_RECORD_MESSAGE = 1,  ///< A whole message (transaction ID followed by the payload).
+    MSGSHM_RECORD_MARKER  = 2,  ///< Place holder for a message that was sent through the socket
+                                ///  instead, because it carries a file descriptor.
+}
+msgShm_RecordType_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * One-byte tokens that are sent through the session's socket to drive the shared memory transport.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    MSGSHM_TOKEN_ATTACH = 'A',  ///< Client to server: the client has mapped the shared memory and
+                                ///  will send through it from now on.
+    MSGSHM_TOKEN_SWITCH = 'S',  ///< Server to client: the server will send through the shared
+                                ///  memory from now on.
+    MSGSHM_TOKEN_WAKEUP = 'W',  ///< The ring that the receiver was waiting on is no longer empty.
+    MSGSHM_TOKEN_SPACE  = 'F',  ///< The ring that the sender was waiting on is no longer full.
+}
+msgShm_Token_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Control block of one direction of the transport, as it appears in the shared memory.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct msgShm_Ring msgShm_Ring_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * One side's view of a shared memory transport between a client and a server.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct msgShm_Transport
+{
+    void*           basePtr;        ///< Start of the shared memory mapping.
+    size_t          mapSize;        ///< Size of the shared memory mapping, in bytes.
+    size_t          slotSize;       ///< Size of each slot in the rings, in bytes.
+    uint32_t        slotCount;      ///< Number of slots in each ring.
+
+    msgShm_Ring_t*  txRingPtr;      ///< Ring that this side writes records into.
+    uint8_t*        txSlotsPtr;     ///< First slot of the transmit ring.
+    uint32_t        txHead;         ///< Private copy of the transmit ring's head index.
+
+    msgShm_Ring_t*  rxRingPtr;      ///< Ring that this side reads records from.
+    uint8_t*        rxSlotsPtr;     ///< First slot of the receive ring.
+    uint32_t        rxTail;         ///< Private copy of the receive ring's tail index.
+
+    bool            txEnabled;      ///< true = messages are sent through the transmit ring.
+    bool            rxEnabled;      ///< true = the far side sends messages through the receive
+                                    ///  ring (only messages carrying fds use the socket).
+    bool            txResume;       ///< true = a token was received that calls for another attempt
+                                    ///  to send what is waiting on the Transmit Queue.
+}
+msgShm_Transport_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes this module.  This must be called only once at start-up, before any other functions
+ * in this module are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgShm_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates the shared memory for a new server-side session.
+ *
+ * @return A pointer to the transport, or NULL if shared memory can't be used for messages of this
+ *         size (or at all on this system).
+ */
+//--------------------------------------------------------------------------------------------------
+msgShm_Transport_t* msgShm_Create
+(
+    size_t  recordSize, ///< [IN] Size of a message's transaction ID plus its maximum payload.
+    int*    fdPtr       ///< [OUT] File descriptor of the shared memory, to be sent to the client.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps the shared memory offered by a server into a client-side session.
+ *
+ * @return A pointer to the transport, or NULL if the shared memory is not usable.
+ *
+ * @note Closes the file descriptor in all cases.
+ */
+//--------------------------------------------------------------------------------------------------
+msgShm_Transport_t* msgShm_Attach
+(
+    int     fd,         ///< [IN] File descriptor received from the server.
+    size_t  recordSize  ///< [IN] Size of a message's transaction ID plus its maximum payload.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmaps the shared memory and deletes a transport.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgShm_Delete
+(
+    msgShm_Transport_t* shmPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the next free slot in the transmit ring.  The record must be published using
+ * msgShm_Publish() before the far side can see it.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_WOULD_BLOCK if the ring is full.  A SPACE token will arrive when it is no longer full.
+ * - LE_FAULT if the far side has corrupted the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgShm_Reserve
+(
+    msgShm_Transport_t* shmPtr,
+    void**              recordPtrPtr    ///< [OUT] Where the record is to be written.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Publishes the record that was last reserved using msgShm_Reserve().
+ *
+ * @return true if the far side is waiting and must be sent a WAKEUP token.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgShm_Publish
+(
+    msgShm_Transport_t* shmPtr,
+    msgShm_RecordType_t type,
+    size_t              size        ///< Size of the record, in bytes (0 for a MARKER).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks at the oldest record in the receive ring, without removing it.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_WOULD_BLOCK if the ring is empty.
+ * - LE_FAULT if the far side has corrupted the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgShm_Peek
+(
+    msgShm_Transport_t*     shmPtr,
+    msgShm_RecordType_t*    typePtr,        ///< [OUT] Type of record.
+    const void**            recordPtrPtr,   ///< [OUT] The record.
+    size_t*                 sizePtr         ///< [OUT] Size of the record, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes the oldest record from the receive ring.
+ *
+ * @return true if the far side is waiting for space and must be sent a SPACE token.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgShm_Consume
+(
+    msgShm_Transport_t* shmPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tells the far side that this side is about to wait for a WAKEUP token before reading the
+ * receive ring again.
+ *
+ * @return true if the ring is not empty after all, in which case the caller must keep reading.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgShm_PrepareToWait
+(
+    msgShm_Transport_t* shmPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a token through a session's socket, waiting for buffer space if the socket is full.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_COMM_ERROR if the socket is broken.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgShm_SendToken
+(
+    int             socketFd,
+    msgShm_Token_t  token
+);
+
+
+#endif // LE_MESSAGING_SHARED_MEM_H_INCLUDE_GUARD
@@ -29,17 +29,90 @@
 /// Name used for diagnostics.
 static const char ModuleName[] = "ref";
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * A Safe Reference holds the index of a slot in its map's slot array, the generation of that slot
+ * when the reference was created, and the index class that says how many bits the index takes,
+ * above the low-order bit (which is always set):
+ *
+ * @verbatim
+   | generation | slot index | index class | 1 |
+   @endverbatim
+ *
+ * A slot's generation changes every time a reference to it is deleted, so a stale reference to a
+ * slot that has since been reused doesn't match it.  Generation 0 is never used, so small integer
+ * values are never valid Safe References either.
+ *
+ * Safe References are passed through IPC messages as 32-bit values, so they must fit in 32 bits
+ * on every platform.  A small map gives most of those bits to the generation.  Each time a map's
+ * slot array outgrows its index class, its new references move to the next class, which trades
+ * two generation bits for two more index bits.  References created before that keep their class,
+ * so they stay valid.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CLASS_BITS          3
+#define MAX_INDEX_CLASS     ((1 << CLASS_BITS) - 1)
+#define MIN_INDEX_BITS      13
+#define INDEX_SHIFT         (CLASS_BITS + 1)
+
+/// Number of bits taken by the slot index in a Safe Reference of a given index class.
+#define INDEX_BITS(class)       (MIN_INDEX_BITS + (2 * (class)))
+
+/// Number of bits left for the generation in a Safe Reference of a given index class.
+#define GENERATION_BITS(class)  (32 - INDEX_SHIFT - INDEX_BITS(class))
+
+/// Maximum number of Safe References that can be kept in a Reference Map at one time, which is
+/// more than can fit in memory on a 32-bit target.
+#define MAX_SLOTS           (((size_t)1) << INDEX_BITS(MAX_INDEX_CLASS))
+
+/// Value of a slot's nextFree field, or a map's free list head or tail, meaning "no slot".
+#define NO_SLOT             (UINT32_MAX - 1)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A slot in a Reference Map's slot array, which holds the pointer that a Safe Reference maps to.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    void*       ptr;            ///< The pointer the slot's Safe Reference maps to.
+    uint32_t    ref;            ///< The slot's Safe Reference if it is in use (which is odd),
+                                ///  else the generation of its next one times two (which is even).
+    uint32_t    nextFree;       ///< Next slot in the free list, or NO_SLOT.
+}
+Slot_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference Map iterator.  The iterator walks the slot array in order.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_ref_Iter
+{
+    struct le_ref_Map*  mapPtr;         ///< The map being iterated over.
+    ssize_t             currentIndex;   ///< Slot the iterator is on, or -1 if not started yet.
+}
+Iter_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reference Map object, which stores mappings from Safe References to pointers.
- * The actual mapping is held in a hashmap.
+ * The actual mappings are held in an array of slots, which is doubled in size whenever there are
+ * no free slots left.  Free slots are kept in a first-in first-out list, so that a slot that has
+ * just been freed is the last to be reused, which keeps stale references detectable for as long
+ * as possible after the slot's generation wraps around.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct le_ref_Map
 {
-    uint32_t             nextRefNum;     ///< The next Safe Reference value to be assigned.
+    Slot_t*         slotsPtr;           ///< Array of slots.
+    size_t          slotCount;          ///< Number of slots in the array.
+    uint32_t        freeHead;           ///< First slot in the free list, or NO_SLOT.
+    uint32_t        freeTail;           ///< Last slot in the free list, or NO_SLOT.
+    uint16_t        firstGeneration;    ///< Generation given to new slots.
+    uint8_t         indexClass;         ///< Index class given to new Safe References.
 
-    le_hashmap_Ref_t    referenceMap;    ///< HashMap of Mapping objects.
+    Iter_t          iterator;           ///< The map's iterator.
 
     char          name[MAX_NAME_BYTES]; ///< The name of the map (for diagnostics).
 }
@@ -53,44 +126,193 @@ Map_t;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t MapPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of Reference Maps created so far, used to start each map's generations at a different
+ * value.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t MapCount;
+
 // =============================================
 //  PRIVATE FUNCTIONS
 // =============================================
 
 //--------------------------------------------------------------------------------------------------
 /**
- * SafeRef hashing function.
- *
- * @return  Returns the SafeRef itself as it can used as a hash
- *
+ * Get the mask of the generation bits kept in a Safe Reference of a given index class.
  */
 //--------------------------------------------------------------------------------------------------
+static inline uint32_t GenerationMask
+(
+    uint32_t indexClass
+)
+{
+    return (((uint32_t)1) << GENERATION_BITS(indexClass)) - 1;
+}
 
-size_t hashSafeRef
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make the Safe Reference for a slot in its current generation.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t MakeRef
 (
-    const void* safeRefPtr    ///< [in] Safe Ref to be hashed
+    uint32_t index,
+    uint32_t generation,
+    uint32_t indexClass
 )
 {
-    // Return the key value itself.
-    return (size_t) safeRefPtr;
+    return   ((generation & GenerationMask(indexClass)) << (INDEX_SHIFT + INDEX_BITS(indexClass)))
+           | (index << INDEX_SHIFT)
+           | (indexClass << 1)
+           | 1;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * SafeRef equality function.
- *
- * @return  Returns true if the integers are equal, false otherwise
+ * Check whether a slot is in use.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsInUse
+(
+    const Slot_t* slotPtr
+)
+{
+    return (slotPtr->ref & 1) != 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the slot that a Safe Reference refers to.
  *
+ * @return A pointer to the slot, or NULL if the Safe Reference is invalid or stale.
  */
 //--------------------------------------------------------------------------------------------------
+static inline Slot_t* FindSlot
+(
+    Map_t*  mapPtr,
+    void*   safeRef
+)
+{
+    uintptr_t ref = (uintptr_t)safeRef;
+
+    if ((ref & 1) == 0)
+    {
+        return NULL;
+    }
+
+    uint32_t indexClass = (ref >> 1) & MAX_INDEX_CLASS;
+    size_t index = (ref >> INDEX_SHIFT) & ((((uintptr_t)1) << INDEX_BITS(indexClass)) - 1);
+
+    if (index >= mapPtr->slotCount)
+    {
+        return NULL;
+    }
 
-bool equalsSafeRef
+    Slot_t* slotPtr = &mapPtr->slotsPtr[index];
+
+    // This also fails if the slot is free, as the reference is odd.
+    if ((uintptr_t)slotPtr->ref != ref)
+    {
+        return NULL;
+    }
+
+    return slotPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a slot to the end of a map's free list.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FreeSlot
+(
+    Map_t*      mapPtr,
+    uint32_t    index
+)
+{
+    mapPtr->slotsPtr[index].nextFree = NO_SLOT;
+
+    if (mapPtr->freeTail == NO_SLOT)
+    {
+        mapPtr->freeHead = index;
+    }
+    else
+    {
+        mapPtr->slotsPtr[mapPtr->freeTail].nextFree = index;
+    }
+
+    mapPtr->freeTail = index;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Grow a map's slot array, and add the new slots to its free list.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GrowSlots
+(
+    Map_t*  mapPtr,
+    size_t  newSlotCount
+)
+{
+    if (newSlotCount > MAX_SLOTS)
+    {
+        newSlotCount = MAX_SLOTS;
+    }
+
+    if (newSlotCount <= mapPtr->slotCount)
+    {
+        // Like running out of memory, as the slot array already takes gigabytes.
+        LE_FATAL("Too many Safe References in Map '%s' (%zu).", mapPtr->name, mapPtr->slotCount);
+    }
+
+    // It is ok to use realloc here as maps are never deleted, and slots are only found by index.
+    Slot_t* slotsPtr = realloc(mapPtr->slotsPtr, newSlotCount * sizeof(Slot_t));
+    LE_ASSERT(slotsPtr != NULL);
+
+    mapPtr->slotsPtr = slotsPtr;
+
+    size_t index;
+    for (index = mapPtr->slotCount; index < newSlotCount; index++)
+    {
+        slotsPtr[index].ptr = NULL;
+        slotsPtr[index].ref = (uint32_t)mapPtr->firstGeneration << 1;
+        FreeSlot(mapPtr, index);
+    }
+
+    mapPtr->slotCount = newSlotCount;
+
+    // New references need enough index bits for every slot.
+    while ((newSlotCount - 1) >> INDEX_BITS(mapPtr->indexClass) != 0)
+    {
+        mapPtr->indexClass++;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the slot that an iterator is on.
+ *
+ * @return A pointer to the slot, or NULL if the iterator isn't on a slot that is in use.
+ */
+//--------------------------------------------------------------------------------------------------
+static Slot_t* GetIteratorSlot
 (
-    const void* firstSafeRef,    ///< [in] First SafeRef for comparing.
-    const void* secondSafeRef    ///< [in] Second SafeRef for comparing.
+    Iter_t* iteratorPtr
 )
 {
-    return firstSafeRef == secondSafeRef;
+    Map_t* mapPtr = iteratorPtr->mapPtr;
+
+    if (   (iteratorPtr->currentIndex < 0)
+        || (iteratorPtr->currentIndex >= (ssize_t)mapPtr->slotCount)
+        || !IsInUse(&mapPtr->slotsPtr[iteratorPtr->currentIndex]) )
+    {
+        return NULL;
+    }
+
+    return &mapPtr->slotsPtr[iteratorPtr->currentIndex];
 }
 
 // =============================================
@@ -149,15 +371,19 @@ le_ref_MapRef_t le_ref_CreateMap
         LE_WARN("Map name '%s%s' truncated to '%s'.", ModuleName, name, mapPtr->name);
     }
 
-    /// @todo Make this a random number so that using a reference from another Map is unlikely to
-    ///       get by undetected.
-    mapPtr->nextRefNum = 0x10000001; // Use only odd numbers.
+    // Start each map's generations at a different value, so that using a reference from another
+    // Map is unlikely to get by undetected.
+    mapPtr->firstGeneration = (uint16_t)(MapCount++ * 0x9E3779B1u);
 
-    mapPtr->referenceMap = le_hashmap_Create(mapPtr->name,
-                                             maxRefs,
-                                             hashSafeRef,
-                                             equalsSafeRef
-                                            );
+    mapPtr->slotsPtr = NULL;
+    mapPtr->slotCount = 0;
+    mapPtr->freeHead = NO_SLOT;
+    mapPtr->freeTail = NO_SLOT;
+    mapPtr->indexClass = 0;
+    mapPtr->iterator.mapPtr = mapPtr;
+    mapPtr->iterator.currentIndex = -1;
+
+    GrowSlots(mapPtr, (maxRefs > 0) ? maxRefs : 1);
 
     return mapPtr;
 }
@@ -178,13 +404,31 @@ void* le_ref_CreateRef
 )
 //--------------------------------------------------------------------------------------------------
 {
-    ssize_t thisRef = mapRef->nextRefNum;
+    if (mapRef->freeHead == NO_SLOT)
+    {
+        GrowSlots(mapRef, mapRef->slotCount * 2);
+    }
+
+    uint32_t index = mapRef->freeHead;
+    Slot_t* slotPtr = &mapRef->slotsPtr[index];
+
+    mapRef->freeHead = slotPtr->nextFree;
+    if (mapRef->freeHead == NO_SLOT)
+    {
+        mapRef->freeTail = NO_SLOT;
+    }
 
-    le_hashmap_Put(mapRef->referenceMap, (const void*)(thisRef), ptr);
+    // Skip the generations that would look like 0 in the reference.
+    uint32_t generation = (slotPtr->ref >> 1) & GenerationMask(mapRef->indexClass);
+    if (generation == 0)
+    {
+        generation = 1;
+    }
 
-    mapRef->nextRefNum += 2; // Increment the reference number for next time, keeping it odd.
+    slotPtr->ptr = ptr;
+    slotPtr->ref = MakeRef(index, generation, mapRef->indexClass);
 
-    return (void *)thisRef;
+    return (void*)(uintptr_t)slotPtr->ref;
 }
 
 
@@ -204,7 +448,9 @@ void* le_ref_Lookup
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return le_hashmap_Get(mapRef->referenceMap, safeRef);
+    Slot_t* slotPtr = FindSlot(mapRef, safeRef);
+
+    return (slotPtr == NULL) ? NULL : slotPtr->ptr;
 }
 
 
@@ -220,10 +466,21 @@ void le_ref_DeleteRef
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (le_hashmap_Remove(mapRef->referenceMap, safeRef) == NULL)
+    Slot_t* slotPtr = FindSlot(mapRef, safeRef);
+
+    if (slotPtr == NULL)
     {
         LE_ERROR("Deleting non-existent Safe Reference %p from Map '%s'.", safeRef, mapRef->name);
+        return;
     }
+
+    // Moving the slot on to its next generation invalidates the reference.
+    uint32_t indexClass = (slotPtr->ref >> 1) & MAX_INDEX_CLASS;
+    uint32_t generation = slotPtr->ref >> (INDEX_SHIFT + INDEX_BITS(indexClass));
+
+    slotPtr->ptr = NULL;
+    slotPtr->ref = (generation + 1) << 1;
+    FreeSlot(mapRef, slotPtr - mapRef->slotsPtr);
 }
 
 
@@ -234,7 +491,7 @@ void le_ref_DeleteRef
  * per map, and calling this function resets the iterator position to the start of the map.  The
  * iterator is not ready for data access until le_ref_NextNode() has been called at least once.
  *
- * @return  Returns A reference to a hashmap iterator which is ready for le_hashmap_NextNode() to be
+ * @return  Returns A reference to an iterator which is ready for le_ref_NextNode() to be
  *          called on it.
  */
 //--------------------------------------------------------------------------------------------------
@@ -243,7 +500,9 @@ le_ref_IterRef_t le_ref_GetIterator
     le_ref_MapRef_t mapRef ///< [in] Reference to the map.
 )
 {
-    return (le_ref_IterRef_t)le_hashmap_GetIterator(mapRef->referenceMap);
+    mapRef->iterator.currentIndex = -1;
+
+    return &mapRef->iterator;
 }
 
 
@@ -261,14 +520,27 @@ le_result_t le_ref_NextNode
     le_ref_IterRef_t iteratorRef ///< [IN] Reference to the iterator.
 )
 {
-    return le_hashmap_NextNode((le_hashmap_It_Ref_t)iteratorRef);
+    Map_t* mapPtr = iteratorRef->mapPtr;
+    ssize_t index;
+
+    for (index = iteratorRef->currentIndex + 1; index < (ssize_t)mapPtr->slotCount; index++)
+    {
+        if (IsInUse(&mapPtr->slotsPtr[index]))
+        {
+            iteratorRef->currentIndex = index;
+            return LE_OK;
+        }
+    }
+
+    iteratorRef->currentIndex = mapPtr->slotCount;
+    return LE_NOT_FOUND;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Retrieves a pointer to the safe ref iterator is currently pointing at.  If the iterator has just
- * been initialized and le_hashmap_NextNode() has not been called, or if the iterator has been
+ * been initialized and le_ref_NextNode() has not been called, or if the iterator has been
  * invalidated then this will return NULL.
  *
  * @return  A pointer to the current key, or NULL if the iterator has been invalidated or is not ready.
@@ -280,7 +552,14 @@ const void* le_ref_GetSafeRef
     le_ref_IterRef_t iteratorRef ///< [IN] Reference to the iterator.
 )
 {
-    return le_hashmap_GetKey((le_hashmap_It_Ref_t)iteratorRef);
+    Slot_t* slotPtr = GetIteratorSlot(iteratorRef);
+
+    if (slotPtr == NULL)
+    {
+        return NULL;
+    }
+
+    return (void*)(uintptr_t)slotPtr->ref;
 }
 
 
@@ -299,5 +578,7 @@ void* le_ref_GetValue
     le_ref_IterRef_t iteratorRef ///< [IN] Reference to the iterator.
 )
 {
-    return le_hashmap_GetValue((le_hashmap_It_Ref_t)iteratorRef);
+    Slot_t* slotPtr = GetIteratorSlot(iteratorRef);
+
+    return (slotPtr == NULL) ? NULL : slotPtr->ptr;
 }
@@ -85,6 +85,15 @@ static size_t* ThreadObjListChangeCountRef = &ThreadObjListChangeCount;
 static pthread_key_t ThreadLocalDataKey;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * true once ThreadLocalDataKey has been created.  Until then, the key value may belong to another
+ * module (e.g., the Memory Pool module's thread cache key), so it must not be looked up.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ThreadLocalDataKeyCreated = false;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * A memory pool of thread objects.
@@ -559,6 +568,7 @@ void thread_Init
 
     // Create the thread-local data key to be used to store a pointer to each thread object.
     LE_ASSERT(pthread_key_create(&ThreadLocalDataKey, NULL) == 0);
+    ThreadLocalDataKeyCreated = true;
 
     // Create a Thread Object for the main thread (the thread running this function).
     thread_Obj_t* threadPtr = CreateThread("main", NULL, NULL);
@@ -1065,6 +1075,9 @@ const char* le_thread_GetMyName
     void
 )
 {
+    // This can be called by the logging functions before thread_Init() has run.
+    if (!ThreadLocalDataKeyCreated) return "unknown";
+
     thread_Obj_t* threadPtr = pthread_getspecific(ThreadLocalDataKey);
 
     if (NULL == threadPtr) return "unknown";
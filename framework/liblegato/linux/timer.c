@@ -21,6 +21,7 @@
 #define DEFAULT_POOL_INITIAL_SIZE 1
 #define DEFAULT_REFMAP_NAME "Default Timer SafeRefs"
 #define DEFAULT_REFMAP_MAXSIZE 23
+#define DEFAULT_HEAP_INITIAL_SIZE 16
 
 
 //--------------------------------------------------------------------------------------------------
@@ -123,108 +124,182 @@ static Timer_t* CreateTimer
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the timer record to the given list, sorted according to the timer value
+ * Check whether one timer is due to expire before another.  Timers with the same expiry time
+ * expire in the order they were started.
+ *
+ * @return
+ *      true if timer A expires before timer B.
  */
 //--------------------------------------------------------------------------------------------------
-static void AddToTimerList
+static inline bool ExpiresBefore
 (
-    le_dls_List_t* listPtr,               ///< [IN] The list to add to.
-    Timer_t* newTimerPtr                  ///< [IN] The timer to add
+    Timer_t* timerAPtr,                 ///< [IN] Timer A
+    Timer_t* timerBPtr                  ///< [IN] Timer B
 )
 {
-    Timer_t* timerPtr;
-    le_dls_Link_t* linkPtr;
-
-    if ( newTimerPtr->isActive )
+    if ( le_clk_Equal(timerAPtr->expiryTime, timerBPtr->expiryTime) )
     {
-        LE_ERROR("Timer '%s' is already active", newTimerPtr->name);
-        return;
+        return (timerAPtr->startSeqNum < timerBPtr->startSeqNum);
     }
 
-    // Get the start of the list
-    linkPtr = le_dls_Peek(listPtr);
+    return le_clk_GreaterThan(timerBPtr->expiryTime, timerAPtr->expiryTime);
+}
 
-    // Find the timer whose expiry time is greater than the new timer.
-    while ( linkPtr != NULL )
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Put a timer at a given position in the thread's timer heap.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void SetHeapEntry
+(
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread's timer record.
+    size_t index,                       ///< [IN] The position in the heap.
+    Timer_t* timerPtr                   ///< [IN] The timer.
+)
+{
+    threadRecPtr->heapArrayPtr[index] = timerPtr;
+    timerPtr->heapIndex = index;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the timer at a given position in the heap up towards the root until its parent expires
+ * before it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SiftUp
+(
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread's timer record.
+    size_t index                        ///< [IN] The position of the timer to move.
+)
+{
+    Timer_t* timerPtr = threadRecPtr->heapArrayPtr[index];
+
+    while (index > 0)
     {
-        timerPtr = CONTAINER_OF(linkPtr, Timer_t, link);
+        size_t parentIndex = (index - 1) / 2;
+        Timer_t* parentPtr = threadRecPtr->heapArrayPtr[parentIndex];
 
-        if ( le_clk_GreaterThan(timerPtr->expiryTime, newTimerPtr->expiryTime) )
+        if ( !ExpiresBefore(timerPtr, parentPtr) )
+        {
             break;
+        }
 
-        linkPtr = le_dls_PeekNext(listPtr, linkPtr);
+        SetHeapEntry(threadRecPtr, index, parentPtr);
+        index = parentIndex;
     }
 
-    TimerListChangeCount++;
-    if (linkPtr == NULL)
-    {
-        // The list is either empty, or the new timer has the largest expiry time.
-        // In either case, add the new timer to the end of the list.
-        le_dls_Queue(listPtr, &newTimerPtr->link);
-    }
-    else
+    SetHeapEntry(threadRecPtr, index, timerPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the timer at a given position in the heap down towards the leaves until it expires before
+ * both of its children.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SiftDown
+(
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread's timer record.
+    size_t index                        ///< [IN] The position of the timer to move.
+)
+{
+    Timer_t* timerPtr = threadRecPtr->heapArrayPtr[index];
+
+    for (;;)
     {
-        // Found a timer with larger expiry time; insert the new timer before it.
-        le_dls_AddBefore(listPtr, linkPtr, &newTimerPtr->link);
+        size_t childIndex = (2 * index) + 1;
+
+        if (childIndex >= threadRecPtr->heapSize)
+        {
+            break;
+        }
+
+        // Pick the child that expires first.
+        if ( ((childIndex + 1) < threadRecPtr->heapSize) &&
+             ExpiresBefore(threadRecPtr->heapArrayPtr[childIndex + 1],
+                           threadRecPtr->heapArrayPtr[childIndex]) )
+        {
+            childIndex++;
+        }
+
+        if ( !ExpiresBefore(threadRecPtr->heapArrayPtr[childIndex], timerPtr) )
+        {
+            break;
+        }
+
+        SetHeapEntry(threadRecPtr, index, threadRecPtr->heapArrayPtr[childIndex]);
+        index = childIndex;
     }
 
-    // The new timer is now on the active list
-    newTimerPtr->isActive = true;
+    SetHeapEntry(threadRecPtr, index, timerPtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Peek at the first timer from the given timer list
- *
- * @return:
- *      - pointer to the first timer on the list
- *      - NULL if the list is empty
+ * Add the timer record to the given thread's active timers, ordered according to the timer value
  */
 //--------------------------------------------------------------------------------------------------
-static Timer_t* PeekFromTimerList
+static void AddToTimerList
 (
-    le_dls_List_t* listPtr              ///< [IN] The list to look at.
+    timer_ThreadRec_t* threadRecPtr,      ///< [IN] The thread's timer record.
+    Timer_t* newTimerPtr                  ///< [IN] The timer to add
 )
 {
-    le_dls_Link_t* linkPtr;
+    if ( newTimerPtr->isActive )
+    {
+        LE_ERROR("Timer '%s' is already active", newTimerPtr->name);
+        return;
+    }
 
-    linkPtr = le_dls_Peek(listPtr);
-    if (linkPtr != NULL)
+    // Grow the heap if it is full.
+    if (threadRecPtr->heapSize == threadRecPtr->heapCapacity)
     {
-        return ( CONTAINER_OF(linkPtr, Timer_t, link) );
+        size_t newCapacity = (threadRecPtr->heapCapacity == 0) ? DEFAULT_HEAP_INITIAL_SIZE
+                                                               : (threadRecPtr->heapCapacity * 2);
+        Timer_t** newArrayPtr = realloc(threadRecPtr->heapArrayPtr,
+                                        newCapacity * sizeof(Timer_t*));
+        LE_ASSERT(newArrayPtr != NULL);
+
+        threadRecPtr->heapArrayPtr = newArrayPtr;
+        threadRecPtr->heapCapacity = newCapacity;
     }
-    return NULL;
+
+    TimerListChangeCount++;
+
+    newTimerPtr->startSeqNum = threadRecPtr->nextStartSeqNum++;
+    SetHeapEntry(threadRecPtr, threadRecPtr->heapSize, newTimerPtr);
+    threadRecPtr->heapSize++;
+    SiftUp(threadRecPtr, newTimerPtr->heapIndex);
+
+    le_dls_Queue(&threadRecPtr->activeTimerList, &newTimerPtr->link);
+
+    // The new timer is now on the active list
+    newTimerPtr->isActive = true;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Pop the first timer from the given timer list
+ * Peek at the first timer to expire from the given thread's active timers
  *
  * @return:
- *      - pointer to the first timer on the list
- *      - NULL if the list is empty
+ *      - pointer to the first timer to expire
+ *      - NULL if there are no active timers
  */
 //--------------------------------------------------------------------------------------------------
-static Timer_t* PopFromTimerList
+static Timer_t* PeekFromTimerList
 (
-    le_dls_List_t* listPtr              ///< [IN] The list to look at.
+    timer_ThreadRec_t* threadRecPtr     ///< [IN] The thread's timer record.
 )
 {
-    le_dls_Link_t* linkPtr;
-    Timer_t* timerPtr;
-
-    linkPtr = le_dls_Pop(listPtr);
-    if (linkPtr != NULL)
+    if (threadRecPtr->heapSize > 0)
     {
-        TimerListChangeCount++;
-        timerPtr = CONTAINER_OF(linkPtr, Timer_t, link);
-
-        // The timer is no longer on the active list
-        timerPtr->isActive = false;
-
-        return timerPtr;
+        return threadRecPtr->heapArrayPtr[0];
     }
     return NULL;
 }
@@ -232,16 +307,16 @@ static Timer_t* PopFromTimerList
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Remove the timer from the given timer list
+ * Remove the timer from the given thread's active timers
  *
  * @return
  *      - LE_OK on success
- *      - LE_FAULT if the timer was not in the list
+ *      - LE_FAULT if the timer was not active
  */
 //--------------------------------------------------------------------------------------------------
 static le_result_t RemoveFromTimerList
 (
-    le_dls_List_t* listPtr,             ///< [IN] The list to look at.
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread's timer record.
     Timer_t* timerPtr                   ///< [IN] The timer to remove
 )
 {
@@ -253,12 +328,58 @@ static le_result_t RemoveFromTimerList
     // Remove the timer from the active list
     timerPtr->isActive = false;
     TimerListChangeCount++;
-    le_dls_Remove(listPtr, &timerPtr->link);
+    le_dls_Remove(&threadRecPtr->activeTimerList, &timerPtr->link);
+
+    // Fill the hole in the heap with the last timer, then restore the heap order.
+    size_t index = timerPtr->heapIndex;
+
+    threadRecPtr->heapSize--;
+
+    if (index < threadRecPtr->heapSize)
+    {
+        Timer_t* lastTimerPtr = threadRecPtr->heapArrayPtr[threadRecPtr->heapSize];
+
+        SetHeapEntry(threadRecPtr, index, lastTimerPtr);
+
+        if ( (index > 0) &&
+             ExpiresBefore(lastTimerPtr, threadRecPtr->heapArrayPtr[(index - 1) / 2]) )
+        {
+            SiftUp(threadRecPtr, index);
+        }
+        else
+        {
+            SiftDown(threadRecPtr, index);
+        }
+    }
 
     return LE_OK;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pop the first timer to expire from the given thread's active timers
+ *
+ * @return:
+ *      - pointer to the first timer to expire
+ *      - NULL if there are no active timers
+ */
+//--------------------------------------------------------------------------------------------------
+static Timer_t* PopFromTimerList
+(
+    timer_ThreadRec_t* threadRecPtr     ///< [IN] The thread's timer record.
+)
+{
+    Timer_t* timerPtr = PeekFromTimerList(threadRecPtr);
+
+    if (timerPtr != NULL)
+    {
+        RemoveFromTimerList(threadRecPtr, timerPtr);
+    }
+    return timerPtr;
+}
+
+
 #if 0
 //--------------------------------------------------------------------------------------------------
 /**
@@ -314,11 +435,13 @@ static void RestartTimerFD
     timer_ThreadRec_t* threadRecPtr = thread_GetTimerRecPtr();
     struct itimerspec timerInterval;
 
-    // Set the timer to expire at the expiry time of the given timer
+    // Set the timer to expire at the expiry time of the given timer, plus the thread's wakeup
+    // slack.  Any other timer due by then will be handled by the same wakeup.
     // There is a small possibility that the time set now will be slightly in the past
     // at this point but it will just cause the timerfd to expire immediately.
-    timerInterval.it_value.tv_sec = timerPtr->expiryTime.sec;
-    timerInterval.it_value.tv_nsec = timerPtr->expiryTime.usec * 1000;
+    le_clk_Time_t wakeupTime = le_clk_Add(timerPtr->expiryTime, threadRecPtr->wakeupSlack);
+    timerInterval.it_value.tv_sec = wakeupTime.sec;
+    timerInterval.it_value.tv_nsec = wakeupTime.usec * 1000;
 
     // The timerFD does not repeat
     timerInterval.it_interval.tv_sec = 0;
@@ -404,7 +527,7 @@ static void ProcessExpiredTimer
         expiredTimer->expiryTime = le_clk_Add(expiredTimer->expiryTime, expiredTimer->interval);
 
         // Add the timer back to the timer list
-        AddToTimerList(&threadRecPtr->activeTimerList, expiredTimer);
+        AddToTimerList(threadRecPtr, expiredTimer);
         //PrintTimerList(&threadRecPtr->activeTimerList);
     }
 
@@ -457,7 +580,7 @@ static void TimerFdHandler
     LE_ERROR_IF(expiry != 1,  "On TimerFD read, unexpected expiry=%u", (unsigned int)expiry);
 
     // Pop off the first timer from the active list, and make sure it is the expected timer.
-    firstTimerPtr = PopFromTimerList(&threadRecPtr->activeTimerList);
+    firstTimerPtr = PopFromTimerList(threadRecPtr);
     LE_ASSERT( NULL != firstTimerPtr);
 
     LE_ASSERT( threadRecPtr->firstTimerPtr == firstTimerPtr );
@@ -472,16 +595,16 @@ static void TimerFdHandler
 
     // Check if there are any other timers that have since expired, pop them off the
     // list and process them.
-    firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+    firstTimerPtr = PeekFromTimerList(threadRecPtr);
     while ( firstTimerPtr != NULL &&
             le_clk_GreaterThan(le_clk_GetRelativeTime(), firstTimerPtr->expiryTime) )
     {
         // Pop off the timer and process it
-        firstTimerPtr = PopFromTimerList(&threadRecPtr->activeTimerList);
+        firstTimerPtr = PopFromTimerList(threadRecPtr);
         ProcessExpiredTimer(firstTimerPtr);
 
         // Try the next timer on the list
-        firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+        firstTimerPtr = PeekFromTimerList(threadRecPtr);
     }
 
     // While processing expired timers in the above loop, it is possible that a timer was started,
@@ -597,6 +720,11 @@ void timer_InitThread
 
     recPtr->timerFD = -1;
     recPtr->activeTimerList = LE_DLS_LIST_INIT;
+    recPtr->heapArrayPtr = NULL;
+    recPtr->heapSize = 0;
+    recPtr->heapCapacity = 0;
+    recPtr->nextStartSeqNum = 0;
+    recPtr->wakeupSlack = (le_clk_Time_t){0, 0};
     recPtr->firstTimerPtr = NULL;
 }
 
@@ -650,6 +778,11 @@ void timer_DestructThread
 
         le_mem_Release(timerPtr);
     }
+
+    free(threadRecPtr->heapArrayPtr);
+    threadRecPtr->heapArrayPtr = NULL;
+    threadRecPtr->heapSize = 0;
+    threadRecPtr->heapCapacity = 0;
 }
 
 // =============================================
@@ -992,12 +1125,12 @@ le_result_t le_timer_Start
     // Add the timer to the timer list. This is the only place we reset the expiry count.
     timerPtr->expiryCount = 0;
     timerPtr->expiryTime = le_clk_Add(le_clk_GetRelativeTime(), timerPtr->interval);
-    AddToTimerList(&threadRecPtr->activeTimerList, timerPtr);
+    AddToTimerList(threadRecPtr, timerPtr);
     //PrintTimerList(&threadRecPtr->activeTimerList);
 
     // Get the first timer from the active list. This is needed to determine whether the timerFD
     // needs to be restarted, in case the new timer was put at the beginning of the list.
-    firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+    firstTimerPtr = PeekFromTimerList(threadRecPtr);
     LE_FATAL_IF(NULL == firstTimerPtr, "Invalid firstTimerPtr reference %p.", firstTimerPtr);
     // If the timerFD is not running, or it is running a timer that is no longer at the beginning
     // of the active list, then (re)start the timerFD.
@@ -1043,7 +1176,7 @@ le_result_t le_timer_Stop
 
     timer_ThreadRec_t* threadRecPtr = thread_GetTimerRecPtr();
 
-    result = RemoveFromTimerList(&threadRecPtr->activeTimerList, timerPtr);
+    result = RemoveFromTimerList(threadRecPtr, timerPtr);
     if (result == LE_OK)
     {
         // If the timer was at the start of the active list, then restart the timerFD using the next
@@ -1053,7 +1186,7 @@ le_result_t le_timer_Stop
             TRACE("Stopping the first active timer");
             threadRecPtr->firstTimerPtr = NULL;
 
-            firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+            firstTimerPtr = PeekFromTimerList(threadRecPtr);
             if (firstTimerPtr != NULL)
             {
                 RestartTimerFD(firstTimerPtr);
@@ -1116,3 +1249,23 @@ bool le_timer_IsRunning
     return timerPtr->isActive;
 }
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the wakeup slack for the calling thread's timers.
+ *
+ * The expiry of the calling thread's timers may be delayed by up to this amount, so that timers
+ * that expire close together are all handled by a single wakeup.  The default is no slack.
+ *
+ * @note
+ *      Takes effect the next time the thread's system timer is re-armed.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_timer_SetWakeupSlack
+(
+    le_clk_Time_t slack          ///< [IN] Maximum delay of a timer expiry.
+)
+{
+    thread_GetTimerRecPtr()->wakeupSlack = slack;
+}
+
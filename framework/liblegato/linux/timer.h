@@ -30,6 +30,8 @@ typedef struct
     le_dls_Link_t link;                      ///< For adding to the timer list
     bool isActive;                           ///< Is the timer active/running?
     le_clk_Time_t expiryTime;                ///< Time at which the timer should expire
+    uint64_t startSeqNum;                    ///< Orders timers with the same expiry time
+    size_t heapIndex;                        ///< Position in the thread's timer heap, if active
     uint32_t expiryCount;                    ///< Number of times the counter has expired
     le_timer_Ref_t safeRef;                  ///< For the API user to refer to this timer by
 }
@@ -51,10 +53,18 @@ typedef struct
 {
     int timerFD;                        ///< System timer used by the thread.
     le_dls_List_t activeTimerList;      ///< Linked list of running legato timers for this thread
+                                        ///  (unordered; used for inspection only).
+    Timer_t** heapArrayPtr;             ///< Binary min-heap of the running timers, ordered by
+                                        ///  expiry time.
+    size_t heapSize;                    ///< Number of timers in the heap.
+    size_t heapCapacity;                ///< Number of timers the heap array can hold.
+    uint64_t nextStartSeqNum;           ///< Sequence number given to the next timer started.
+    le_clk_Time_t wakeupSlack;          ///< How late the timerFD may expire, to let timers that
+                                        ///  expire close together share one wakeup.
     Timer_t* firstTimerPtr;             ///< Pointer to the timer on the active list that is
                                         ///  associated with the currently running timerFD,
                                         ///  or NULL if there are no timers on the active list.
-                                        ///  This is normally the first timer on the list.
+                                        ///  This is normally the first timer in the heap.
 
 }
 timer_ThreadRec_t;
@@ -726,6 +726,58 @@ le_result_t unixSocket_ReceiveDataMsg
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the size of the next message waiting on a connected Unix domain datagram or
+ * sequenced-packet socket, without receiving it.
+ *
+ * @return
+ * - LE_OK if successful (the size is 0 if the connection closed).
+ * - LE_WOULD_BLOCK if the socket is set non-blocking and there is nothing to be received.
+ * - LE_CLOSED if the connection closed.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_PeekMsgSize
+(
+    int localSocketFd,      ///< [IN] fd of local socket that will be used to receive the message.
+    size_t* msgSizePtr      ///< [OUT] Ptr to where the size of the message, in bytes, will be put.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ssize_t msgSize;
+
+    // MSG_TRUNC makes recv() return the real size of the message, even though nothing is copied.
+    do
+    {
+        msgSize = recv(localSocketFd, NULL, 0, MSG_PEEK | MSG_TRUNC);
+    }
+    while ((msgSize < 0) && (errno == EINTR));
+
+    if (msgSize < 0)
+    {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+        {
+            return LE_WOULD_BLOCK;
+        }
+        else if (errno == ECONNRESET)
+        {
+            return LE_CLOSED;
+        }
+        else
+        {
+            LE_ERROR("recv() failed with errno %d (%m).", errno);
+            return LE_FAULT;
+        }
+    }
+
+    *msgSizePtr = msgSize;
+
+    return LE_OK;
+}
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetches the socket error state code (SO_ERROR).
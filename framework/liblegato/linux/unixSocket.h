@@ -518,6 +518,25 @@ le_result_t unixSocket_ReceiveDataMsg
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the size of the next message waiting on a connected Unix domain datagram or
+ * sequenced-packet socket, without receiving it.
+ *
+ * @return
+ * - LE_OK if successful (the size is 0 if the connection closed).
+ * - LE_WOULD_BLOCK if the socket is set non-blocking and there is nothing to be received.
+ * - LE_CLOSED if the connection closed.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_PeekMsgSize
+(
+    int localSocketFd,      ///< [IN] fd of local socket that will be used to receive the message.
+    size_t* msgSizePtr      ///< [OUT] Ptr to where the size of the message, in bytes, will be put.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetches the socket error state code (SO_ERROR).
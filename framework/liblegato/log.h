@@ -164,4 +164,32 @@ void log_LogGenericMsg
     const char* msgPtr          ///< [IN] Message.
 );
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Switches the calling process between synchronous and asynchronous logging.  Messages that are
+ * still waiting to be written out are flushed when switching to synchronous logging.
+ *
+ * @note Asynchronous logging is normally enabled using the LE_LOG_ASYNC environment variable.
+ */
+//--------------------------------------------------------------------------------------------------
+void log_SetAsync
+(
+    bool isAsync                ///< [IN] true = asynchronous, false = synchronous.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of messages that the calling process has dropped because asynchronous logging
+ * couldn't keep up.
+ *
+ * @return The number of messages dropped since the process started.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t log_GetDroppedCount
+(
+    void
+);
+
 #endif // LOG_INCLUDE_GUARD
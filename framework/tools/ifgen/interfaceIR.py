@@ -162,6 +162,12 @@ class HandlerType(Type):
         if any([isinstance(parameter.apiType, HandlerType) for parameter in self.parameters]):
             raise Exception("Handlers cannot have handler parameters")
 
+    def getMessageSize(self):
+        """
+        Get size of the largest possible message to this handler.  See Interface.getMessageSize().
+        """
+        return 8 + sum([parameter.GetMaxSize() for parameter in self.parameters])
+
     def __str__(self):
         return "Handler %s(%s)" \
             % (self.name,
@@ -322,6 +328,16 @@ class Function(object):
 
         self.comment = ""
 
+    def getMessageSize(self):
+        """
+        Get size of the largest possible message to or from this function, or to its handler (which
+        is sent with the same message ID).  See Interface.getMessageSize().
+        """
+        return max([8 + sum([self.returnType.size if self.returnType else 0] +
+                            [parameter.GetMaxSize() for parameter in self.parameters])] +
+                   [parameter.apiType.getMessageSize() for parameter in self.parameters
+                    if isinstance(parameter.apiType, HandlerType)])
+
     def __str__(self):
         if self.returnType == None:
             return "FUNCTION %s(%s)" \
@@ -528,12 +544,10 @@ class Interface(object):
         bytes for required output parameters, and a variable number of bytes to pack
         the return value (if the function has one), and all input and output parameters.
         """
-        return 8 + max([1] +
-                       [sum([function.returnType.size if function.returnType else 0] +
-                            [parameter.GetMaxSize() for parameter in function.parameters])
-                        for function in self.functions.values()] +
-                       [sum([parameter.GetMaxSize() for parameter in handler.parameters])
-                        for handler in self.types.values() if isinstance(handler, HandlerType)])
+        return max([9] +
+                   [function.getMessageSize() for function in self.functions.values()] +
+                   [handler.getMessageSize()
+                    for handler in self.types.values() if isinstance(handler, HandlerType)])
 
     def __str__(self):
         resultStr  = "=== Interface ===\n"
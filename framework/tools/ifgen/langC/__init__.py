@@ -12,6 +12,11 @@ def AddLangArgumentGroup(parser):
                         action='store_true',
                         default=False,
                         help='generate asynchronous-style server functions')
+    parser.add_argument('--batch',
+                        dest="batch",
+                        action='store_true',
+                        default=False,
+                        help='generate client functions for queueing calls in batches')
 
 # Custom filters needed for C templates
 Filters = { 'FormatHeaderComment': codeGenHelpers.FormatHeaderComment,
@@ -27,7 +32,8 @@ Filters = { 'FormatHeaderComment': codeGenHelpers.FormatHeaderComment,
             'CAPIParameters':      codeGenHelpers.IterCAPIParameters }
 
 
-Tests = { 'SizeParameter':         codeGenHelpers.IsSizeParameter }
+Tests = { 'SizeParameter':         codeGenHelpers.IsSizeParameter,
+          'BatchableFunction':     codeGenHelpers.IsBatchableFunction }
 
 Globals = { 'Labeler':             codeGenHelpers.Labeler }
 
@@ -197,6 +197,19 @@ def GetUnpackFunction(apiType):
 def IsSizeParameter(parameter):
     return isinstance(parameter, SizeParameter)
 
+def IsBatchableFunction(function):
+    """
+    Can calls to a function be queued in a batch?  Not if the call registers or removes a handler,
+    or passes a file descriptor, as only one can be sent with a message.
+    """
+    if isinstance(function, interfaceIR.EventFunction):
+        return False
+
+    return not any([isinstance(parameter.apiType, interfaceIR.HandlerType) or
+                    (isinstance(parameter.apiType, interfaceIR.BasicType) and
+                     parameter.apiType.name == 'file')
+                    for parameter in function.parameters])
+
 #---------------------------------------------------------------------------------------------------
 # Global functions
 #---------------------------------------------------------------------------------------------------
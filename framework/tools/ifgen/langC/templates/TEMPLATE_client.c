@@ -8,6 +8,28 @@
  #  Copyright (C) Sierra Wireless Inc.
  #}
 {%- import 'pack.templ' as pack -%}
+{%- macro CheckInputs(function) %}
+    // Range check values, if appropriate
+    {%- for parameter in function.parameters if parameter is InParameter %}
+    {%- if parameter is StringParameter %}
+    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
+    {
+        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
+    }
+    {%- elif parameter is ArrayParameter %}
+    if ( (NULL == {{parameter|FormatParameterName}}) &&
+         (0 != {{parameter|GetParameterCount}}) )
+    {
+        LE_FATAL("If {{parameter|FormatParameterName}} is NULL "
+                 "{{parameter|GetParameterCount}} must be zero");
+    }
+    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
+    {
+        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
+    }
+    {%- endif %}
+    {%- endfor %}
+{%- endmacro -%}
 /*
  * ====================== WARNING ======================
  *
@@ -65,6 +87,14 @@ typedef struct
     int                 clientCount;    ///< Number of clients sharing this thread
     {{apiName}}_DisconnectHandler_t disconnectHandler; ///< Disconnect handler for this thread
     void*               contextPtr;     ///< Context for disconnect handler
+    {%- if args.batch %}
+    bool                batchOpen;      ///< true = calls are being queued in a batch
+    le_msg_MessageRef_t batchMsgRef;    ///< Message holding the queued calls, or NULL if none
+    uint8_t*            batchBufPtr;    ///< Where to pack the next call in the batch message
+    size_t              batchBufSize;   ///< Room left for calls in the batch and in its response
+    uint32_t            batchCallCount; ///< Number of calls in the batch message
+    le_sls_List_t       batchCallList;  ///< Calls waiting for their results (_BatchCall_t)
+    {%- endif %}
 }
 _ClientThreadData_t;
 
@@ -75,6 +105,53 @@ _ClientThreadData_t;
  */
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t _ClientThreadDataPool;
+{%- if args.batch %}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Batched Call Objects
+ *
+ * This object is used for each call queued in a batch.  It holds the caller's pointers for the
+ * results of the call until the response to the batch is received.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t link;                 ///< Link in the thread's list of queued calls
+    uint32_t      id;                   ///< Message ID of the function called
+    union
+    {
+        void* unused;                   ///< For functions without results
+        {%- for function in functions if function is BatchableFunction %}
+        {%- if function.returnType or any(function.parameters, "OutParameter") %}
+        struct
+        {
+            {%- if function.returnType %}
+            {{function.returnType|FormatType}}* _resultPtr;
+            {%- endif %}
+            {%- for parameter in function|CAPIParameters
+                if parameter is OutParameter
+                   or (parameter is SizeParameter and parameter.relatedParameter is OutParameter) %}
+            {{parameter|FormatParameter}};
+            {%- endfor %}
+        }
+        {{function.name}};
+        {%- endif %}
+        {%- endfor %}
+    }
+    results;                            ///< Where to store the results of the call
+}
+_BatchCall_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for batched call objects
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t _BatchCallPool;
+{%- endif %}
 
 
 //--------------------------------------------------------------------------------------------------
@@ -220,6 +297,9 @@ static le_result_t InitClientForThread
     _ClientThreadData_t* clientThreadPtr = le_mem_ForceAlloc(_ClientThreadDataPool);
     memset(clientThreadPtr, 0, sizeof(_ClientThreadData_t));
     clientThreadPtr->sessionRef = sessionRef;
+    {%- if args.batch %}
+    clientThreadPtr->batchCallList = LE_SLS_LIST_INIT;
+    {%- endif %}
     if (pthread_setspecific(_ThreadDataKey, clientThreadPtr) != 0)
     {
         LE_FATAL("pthread_setspecific() failed!");
@@ -283,6 +363,11 @@ static void InitCommonData(void)
     // Allocate the client thread pool
     _ClientThreadDataPool = le_mem_CreatePool("{{apiName}}_ClientThreadData",
                                               {#- #} sizeof(_ClientThreadData_t));
+    {%- if args.batch %}
+
+    // Allocate the batched call pool
+    _BatchCallPool = le_mem_CreatePool("{{apiName}}_BatchCall", sizeof(_BatchCall_t));
+    {%- endif %}
 
     // Create the thread-local data key to be used to store a pointer to each thread object.
     LE_ASSERT(pthread_key_create(&_ThreadDataKey, NULL) == 0);
@@ -471,7 +556,229 @@ void {{apiName}}_SetServerDisconnectHandler
     }
 }
 
+{% if args.batch %}//--------------------------------------------------------------------------------------------------
+/**
+ * Send the calls queued in a thread's batch, if any, and store their results.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendBatch
+(
+    _ClientThreadData_t* clientThreadPtr
+)
+{
+    {%- with error_unpack_label=Labeler("error_unpack") %}
+    le_msg_MessageRef_t _msgRef;
+    le_msg_MessageRef_t _responseMsgRef;
+    _Message_t* _msgPtr;
+    uint8_t* _msgBufPtr;
+    size_t _msgBufSize;
+    le_sls_Link_t* _linkPtr;
+
+    if ((clientThreadPtr == NULL) || (clientThreadPtr->batchMsgRef == NULL))
+    {
+        return;
+    }
+
+    _msgRef = clientThreadPtr->batchMsgRef;
+    clientThreadPtr->batchMsgRef = NULL;
+
+    // Fill in the number of calls at the start of the message.
+    _msgPtr = le_msg_GetPayloadPtr(_msgRef);
+    _msgBufPtr = _msgPtr->buffer;
+    _msgBufSize = _GetMsgBufSize(_msgRef);
+    LE_ASSERT(le_pack_PackUint32(&_msgBufPtr, &_msgBufSize, clientThreadPtr->batchCallCount));
+
+    // Send the batch to the server and get the response.
+    LE_DEBUG("Sending batch of %" PRIu32 " calls to server and waiting for response : "
+             "%ti bytes sent",
+             clientThreadPtr->batchCallCount,
+             clientThreadPtr->batchBufPtr-_msgPtr->buffer);
+    clientThreadPtr->batchCallCount = 0;
+    _responseMsgRef = le_msg_RequestSyncResponse(_msgRef);
+    // It is a serious error if we don't get a valid response from the server.  Call disconnect
+    // handler (if one is defined) to allow cleanup
+    if (_responseMsgRef == NULL)
+    {
+        SessionCloseHandler(clientThreadPtr->sessionRef, clientThreadPtr);
+    }
+
+    // Store the results of each call, in the order the calls were queued.
+    _msgPtr = le_msg_GetPayloadPtr(_responseMsgRef);
+    _msgBufPtr = _msgPtr->buffer;
+    _msgBufSize = _GetMsgBufSize(_responseMsgRef);
+
+    while ((_linkPtr = le_sls_Pop(&clientThreadPtr->batchCallList)) != NULL)
+    {
+        _BatchCall_t* _callPtr = CONTAINER_OF(_linkPtr, _BatchCall_t, link);
+
+        switch (_callPtr->id)
+        {
+            {%- for function in functions if function is BatchableFunction %}
+            {%- if function.returnType or any(function.parameters, "OutParameter") %}
+            case _MSGID_{{apiName}}_{{function.name}} :
+            {
+                {%- for parameter in function|CAPIParameters
+                    if parameter is OutParameter
+                       or (parameter is SizeParameter
+                           and parameter.relatedParameter is OutParameter) %}
+                {{parameter|FormatParameter}} =
+                    {#- #} _callPtr->results.{{function.name}}.{{parameter|FormatParameterName}};
+                {%- endfor %}
+                {%- if function.returnType %}
+                {{function.returnType|FormatType}} _result;
+
+                if (!{{function.returnType|UnpackFunction}}( &_msgBufPtr, &_msgBufSize, &_result ))
+                {
+                    goto {{error_unpack_label}};
+                }
+                if (_callPtr->results.{{function.name}}._resultPtr != NULL)
+                {
+                    *_callPtr->results.{{function.name}}._resultPtr = _result;
+                }
+                {%- endif %}
+                {%- call pack.UnpackOutputs(function.parameters) %}
+                    goto {{error_unpack_label}};
+                {%- endcall %}
+                break;
+            }
+            {%- endif %}
+            {%- endfor %}
+
+            default:
+                // No results
+                break;
+        }
+
+        le_mem_Release(_callPtr);
+    }
+
+    // Release the message object, now that all results have been copied.
+    le_msg_ReleaseMsg(_responseMsgRef);
+
+    return;
+    {%- if error_unpack_label.IsUsed() %}
+
+error_unpack:
+    LE_FATAL("Unexpected response from server.");
+    {%- endif %}
+    {%- endwith %}
+}
+
+
 //--------------------------------------------------------------------------------------------------
+/**
+ * Add a call to the current thread's batch.  If the batch has no room left for the call, the calls
+ * already in it are sent first.
+ *
+ * @return
+ *  - The object for the call, or
+ *  - NULL if the call is too large to share a message with other calls.
+ */
+//--------------------------------------------------------------------------------------------------
+static _BatchCall_t* ReserveBatchCall
+(
+    _ClientThreadData_t* clientThreadPtr,
+    uint32_t id,            ///< [IN] Message ID of the function called
+    size_t size,            ///< [IN] Most room the call may take in the request or the response
+    uint8_t** bufPtrPtr,    ///< [OUT] Where to pack the inputs of the call
+    size_t* bufSizePtr      ///< [OUT] Room for the inputs of the call
+)
+{
+    _BatchCall_t* callPtr;
+
+    // The start of the message holds the number of calls.
+    if (size > (_MAX_MSG_SIZE - sizeof(uint32_t)))
+    {
+        return NULL;
+    }
+
+    if ((clientThreadPtr->batchMsgRef != NULL) && (clientThreadPtr->batchBufSize < size))
+    {
+        SendBatch(clientThreadPtr);
+    }
+
+    if (clientThreadPtr->batchMsgRef == NULL)
+    {
+        _Message_t* msgPtr;
+
+        clientThreadPtr->batchMsgRef = le_msg_CreateMsg(clientThreadPtr->sessionRef);
+        msgPtr = le_msg_GetPayloadPtr(clientThreadPtr->batchMsgRef);
+        msgPtr->id = _MSGID_BATCH;
+        clientThreadPtr->batchBufPtr = msgPtr->buffer + sizeof(uint32_t);
+        clientThreadPtr->batchBufSize = _GetMsgBufSize(clientThreadPtr->batchMsgRef) -
+                                        sizeof(uint32_t);
+    }
+
+    // Take room for the most the call could use.  This is also enough for the results of the call,
+    // which the server writes to the response in the same order.
+    LE_ASSERT(le_pack_PackUint32(&clientThreadPtr->batchBufPtr, &clientThreadPtr->batchBufSize,
+                                 id));
+    *bufPtrPtr = clientThreadPtr->batchBufPtr;
+    *bufSizePtr = size - sizeof(uint32_t);
+    clientThreadPtr->batchBufSize -= *bufSizePtr;
+    clientThreadPtr->batchCallCount++;
+
+    callPtr = le_mem_ForceAlloc(_BatchCallPool);
+    callPtr->link = LE_SLS_LINK_INIT;
+    callPtr->id = id;
+    le_sls_Queue(&clientThreadPtr->batchCallList, &callPtr->link);
+
+    return callPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a batch of calls for the current thread.
+ *
+ * Until {{apiName}}_EndBatch() is called, the Queue functions of this API add calls to the batch,
+ * which are sent to the server together.  Calling any other function of this API sends the calls
+ * already queued first.
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_StartBatch
+(
+    void
+)
+{
+    _ClientThreadData_t* clientThreadPtr = GetClientThreadDataPtr();
+
+    LE_FATAL_IF(clientThreadPtr == NULL,
+                "{{apiName}}_ConnectService() not called for current thread");
+    LE_FATAL_IF(clientThreadPtr->batchOpen, "Batch already started for current thread");
+
+    clientThreadPtr->batchOpen = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the current thread's batch of calls.
+ *
+ * Sends the calls queued in the batch, if any, and waits for their results.  When this returns,
+ * the results of all the calls have been stored.
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_EndBatch
+(
+    void
+)
+{
+    _ClientThreadData_t* clientThreadPtr = GetClientThreadDataPtr();
+
+    LE_FATAL_IF((clientThreadPtr == NULL) || !clientThreadPtr->batchOpen,
+                "{{apiName}}_StartBatch() not called for current thread");
+
+    SendBatch(clientThreadPtr);
+    clientThreadPtr->batchOpen = false;
+}
+
+
+{% endif %}//--------------------------------------------------------------------------------------------------
 /**
  *
  * Disconnect the current client thread from the service providing this API.
@@ -501,6 +808,11 @@ void {{apiName}}_DisconnectService
         // This is the last client for this thread, so close the session.
         if ( clientThreadPtr->clientCount == 1 )
         {
+            {%- if args.batch %}
+            // Don't lose any calls that are still queued.
+            SendBatch(clientThreadPtr);
+
+            {%- endif %}
             le_msg_DeleteSession( clientThreadPtr->sessionRef );
 
             // Need to delete the thread specific data, since it is no longer valid.  If a new
@@ -546,7 +858,7 @@ static void _Handle_{{apiName}}_{{function.name}}
     le_msg_MessageRef_t _msgRef = _reportPtr;
     _Message_t* _msgPtr = le_msg_GetPayloadPtr(_msgRef);
     uint8_t* _msgBufPtr = _msgPtr->buffer;
-    size_t _msgBufSize = _MAX_MSG_SIZE;
+    size_t _msgBufSize = _GetMsgBufSize(_msgRef);
 
     // The clientContextPtr always exists and is always first. It is a safe reference to the client
     // data object, but we already get the pointer to the client data object through the _dataPtr
@@ -637,35 +949,20 @@ error_unpack:
 
     {{function.returnType|FormatType}} _result;
     {%- endif %}
+{{ CheckInputs(function) }}
+    {%- if args.batch %}
 
-    // Range check values, if appropriate
-    {%- for parameter in function.parameters if parameter is InParameter %}
-    {%- if parameter is StringParameter %}
-    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
-    {
-        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
-    }
-    {%- elif parameter is ArrayParameter %}
-    if ( (NULL == {{parameter|FormatParameterName}}) &&
-         (0 != {{parameter|GetParameterCount}}) )
-    {
-        LE_FATAL("If {{parameter|FormatParameterName}} is NULL "
-                 "{{parameter|GetParameterCount}} must be zero");
-    }
-    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
-    {
-        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
-    }
+    // Make any calls queued in a batch first, so that calls are made in order.
+    SendBatch(GetClientThreadDataPtr());
     {%- endif %}
-    {%- endfor %}
 
 
     // Create a new message object and get the message buffer
-    _msgRef = le_msg_CreateMsg(GetCurrentSessionRef());
+    _msgRef = le_msg_CreateSizedMsg(GetCurrentSessionRef(), _MSGSIZE_{{apiName}}_{{function.name}});
     _msgPtr = le_msg_GetPayloadPtr(_msgRef);
     _msgPtr->id = _MSGID_{{apiName}}_{{function.name}};
     _msgBufPtr = _msgPtr->buffer;
-    _msgBufSize = _MAX_MSG_SIZE;
+    _msgBufSize = _GetMsgBufSize(_msgRef);
 
     // Pack a list of outputs requested by the client.
     {%- if any(function.parameters, "OutParameter") %}
@@ -710,7 +1007,7 @@ error_unpack:
     // Process the result and/or output parameters, if there are any.
     _msgPtr = le_msg_GetPayloadPtr(_responseMsgRef);
     _msgBufPtr = _msgPtr->buffer;
-    _msgBufSize = _MAX_MSG_SIZE;
+    _msgBufSize = _GetMsgBufSize(_responseMsgRef);
     {%- if function.returnType %}
 
     // Unpack the result first
@@ -759,6 +1056,94 @@ error_unpack:
     {%- endif %}
     {%- endwith %}
 }
+{%- if args.batch and function is BatchableFunction %}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a call to {{apiName}}_{{function.name}}() in the current thread's batch.
+ *
+ * See {{apiName}}_StartBatch().  Inputs are copied when the call is queued.  Outputs
+ {%- if function.returnType %} and the result{% endif %} are
+ * stored when the batch is sent, so the pointers to them must stay valid until then.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_Queue{{function.name}}
+(
+    {%- for parameter in function|CAPIParameters %}
+    {{parameter|FormatParameter}}{% if not loop.last or function.returnType %},{% endif %}
+        ///< [{{parameter.direction|FormatDirection}}]
+             {{-parameter.comments|join("\n///<")|indent(8)}}
+    {%- endfor %}
+    {%- if function.returnType %}
+    {{function.returnType|FormatType}}* _resultPtr
+        ///< [OUT] Result of the call (may be NULL).
+    {%- elif not function.parameters %}
+    void
+    {%- endif %}
+)
+{
+    _ClientThreadData_t* _clientThreadPtr = GetClientThreadDataPtr();
+    __attribute__((unused)) _BatchCall_t* _callPtr;
+
+    // Will not be used if no data is sent to the server.
+    __attribute__((unused)) uint8_t* _msgBufPtr;
+    __attribute__((unused)) size_t _msgBufSize;
+{{ CheckInputs(function) }}
+
+    LE_FATAL_IF((_clientThreadPtr == NULL) || !_clientThreadPtr->batchOpen,
+                "{{apiName}}_StartBatch() not called for current thread");
+
+    _callPtr = ReserveBatchCall(_clientThreadPtr,
+                                _MSGID_{{apiName}}_{{function.name}},
+                                _MSGSIZE_{{apiName}}_{{function.name}} - offsetof(_Message_t, buffer),
+                                &_msgBufPtr,
+                                &_msgBufSize);
+    if (_callPtr == NULL)
+    {
+        // Too large to share a message with other calls, so make the call on its own.
+        {% if function.returnType -%}
+        {{function.returnType|FormatType}} _result = {% endif -%}
+        {{apiName}}_{{function.name}}(
+            {%- for parameter in function|CAPIParameters %}
+            {{- parameter|FormatParameterName}}{% if not loop.last %}, {% endif %}
+            {%- endfor %});
+        {%- if function.returnType %}
+        if (_resultPtr != NULL)
+        {
+            *_resultPtr = _result;
+        }
+        {%- endif %}
+        return;
+    }
+
+    // Pack a list of outputs requested by the client.
+    {%- if any(function.parameters, "OutParameter") %}
+    uint32_t _requiredOutputs = 0;
+    {%- for output in function.parameters if output is OutParameter %}
+    _requiredOutputs |= ((!!({{output|FormatParameterName}})) << {{loop.index0}});
+    {%- endfor %}
+    LE_ASSERT(le_pack_PackUint32(&_msgBufPtr, &_msgBufSize, _requiredOutputs));
+    {%- endif %}
+
+    // Pack the input parameters
+    {{- pack.PackInputs(function.parameters) }}
+    _clientThreadPtr->batchBufPtr = _msgBufPtr;
+    {%- if function.returnType or any(function.parameters, "OutParameter") %}
+
+    // Keep the pointers for the results until the batch is sent.
+    {%- if function.returnType %}
+    _callPtr->results.{{function.name}}._resultPtr = _resultPtr;
+    {%- endif %}
+    {%- for parameter in function|CAPIParameters
+        if parameter is OutParameter
+           or (parameter is SizeParameter and parameter.relatedParameter is OutParameter) %}
+    _callPtr->results.{{function.name}}.{{parameter|FormatParameterName}} =
+        {#- #} {{parameter|FormatParameterName}};
+    {%- endfor %}
+    {%- endif %}
+}
+{%- endif %}
 {%- endfor %}
 
 
@@ -771,7 +1156,7 @@ static void ClientIndicationRecvHandler
     // Get the message payload
     _Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
     uint8_t* _msgBufPtr = msgPtr->buffer;
-    size_t _msgBufSize = _MAX_MSG_SIZE;
+    size_t _msgBufSize = _GetMsgBufSize(msgRef);
 
     // Have to partially unpack the received message in order to know which thread
     // the queued function should actually go to.
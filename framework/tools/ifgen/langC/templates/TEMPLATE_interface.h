@@ -98,4 +98,66 @@ void {{apiName}}_DisconnectService
 (
     void
 );
+{%- if args.batch %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a batch of calls for the current thread.
+ *
+ * Until {{apiName}}_EndBatch() is called, the Queue functions of this API add calls to the batch,
+ * which are sent to the server together.  Calling any other function of this API sends the calls
+ * already queued first.
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_StartBatch
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the current thread's batch of calls.
+ *
+ * Sends the calls queued in the batch, if any, and waits for their results.  When this returns,
+ * the results of all the calls have been stored.
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_EndBatch
+(
+    void
+);
+{%- endif %}
+{%- endblock %}
+{% block FunctionDeclaration %}
+{{- super() }}
+{%- if args.batch and function is BatchableFunction %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a call to {{apiName}}_{{function.name}}() in the current thread's batch.
+ *
+ * See {{apiName}}_StartBatch().  Inputs are copied when the call is queued.  Outputs
+ {%- if function.returnType %} and the result{% endif %} are
+ * stored when the batch is sent, so the pointers to them must stay valid until then.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_Queue{{function.name}}
+(
+    {%- for parameter in function|CAPIParameters %}
+    {{parameter|FormatParameter}}{% if not loop.last or function.returnType %},{% endif %}
+        ///< [{{parameter.direction|FormatDirection}}]
+             {{-parameter.comments|join("\n///<")|indent(8)}}
+    {%- endfor %}
+    {%- if function.returnType %}
+    {{function.returnType|FormatType}}* _resultPtr
+        ///< [OUT] Result of the call (may be NULL).
+    {%- elif not function.parameters %}
+    void
+    {%- endif %}
+);
+{%- endif %}
 {%- endblock %}
@@ -46,5 +46,33 @@ _Message_t;
 #define _MSGID_{{apiName}}_{{function.name}} {{loop.index0}}
 {%- endfor %}
 
+// A batch of calls: a call count, then the ID and inputs of each call.  The response holds the
+// results of each call, in the same order.
+#define _MSGID_BATCH {{functions|length}}
+
+// Payload size of the largest message to or from each function.  Messages are created at these
+// sizes rather than the size of the largest message in the API.
+{%- for function in functions %}
+#define _MSGSIZE_{{apiName}}_{{function.name}} (offsetof(_Message_t, buffer) + {{function.getMessageSize()}})
+{%- endfor %}
+
+
+// Get the size of the buffer of a message, which is less than _MAX_MSG_SIZE if the message was
+// created for a particular function.
+static inline size_t _GetMsgBufSize
+(
+    le_msg_MessageRef_t msgRef
+)
+{
+    size_t payloadSize = le_msg_GetMaxPayloadSize(msgRef);
+
+    if (payloadSize < offsetof(_Message_t, buffer))
+    {
+        return 0;
+    }
+
+    return payloadSize - offsetof(_Message_t, buffer);
+}
+
 
 #endif // {{apiName|upper}}_MESSAGES_H_INCLUDE_GUARD
@@ -360,11 +360,12 @@ static void AsyncResponse_{{apiName}}_{{function.name}}
     __attribute__((unused)) size_t _msgBufSize;
 
     // Create a new message object and get the message buffer
-    _msgRef = le_msg_CreateMsg(serverDataPtr->clientSessionRef);
+    _msgRef = le_msg_CreateSizedMsg(serverDataPtr->clientSessionRef,
+                                    _MSGSIZE_{{apiName}}_{{function.name}});
     _msgPtr = le_msg_GetPayloadPtr(_msgRef);
     _msgPtr->id = _MSGID_{{apiName}}_{{function.name}};
     _msgBufPtr = _msgPtr->buffer;
-    _msgBufSize = _MAX_MSG_SIZE;
+    _msgBufSize = _GetMsgBufSize(_msgRef);
 
     // Always pack the client context pointer first
     LE_ASSERT(le_pack_PackReference( &_msgBufPtr, &_msgBufSize, serverDataPtr->contextPtr ))
@@ -412,7 +413,7 @@ void {{apiName}}_{{function.name}}Respond
     le_msg_MessageRef_t _msgRef = _cmdRef->msgRef;
     _Message_t* _msgPtr = le_msg_GetPayloadPtr(_msgRef);
     __attribute__((unused)) uint8_t* _msgBufPtr = _msgPtr->buffer;
-    __attribute__((unused)) size_t _msgBufSize = _MAX_MSG_SIZE;
+    __attribute__((unused)) size_t _msgBufSize = _GetMsgBufSize(_msgRef);
 
     // Ensure the passed in msgRef is for the correct message
     LE_ASSERT(_msgPtr->id == _MSGID_{{apiName}}_{{function.name}});
@@ -467,7 +468,13 @@ static void Handle_{{apiName}}_{{function.name}}
     // Get the message buffer pointer
     __attribute__((unused)) uint8_t* _msgBufPtr =
         ((_Message_t*)le_msg_GetPayloadPtr(_msgRef))->buffer;
-    __attribute__((unused)) size_t _msgBufSize = _MAX_MSG_SIZE;
+    __attribute__((unused)) size_t _msgBufSize = _GetMsgBufSize(_msgRef);
+
+    // The client must have left room for the response.
+    if (le_msg_GetMaxPayloadSize(_msgRef) < _MSGSIZE_{{apiName}}_{{function.name}})
+    {
+        goto {{error_unpack_label}};
+    }
 
     // Unpack which outputs are needed.
     _serverCmdPtr->requiredOutputs = 0;
@@ -505,20 +512,21 @@ error_unpack:
     {%- endwith %}
 }
 {%- else %}
-static void Handle_{{apiName}}_{{function.name}}
+// Unpacks the inputs of a call from a request buffer, makes the call, and packs its results into
+// a response buffer, which may be the same as the request buffer.  Both buffer pointers and sizes
+// are moved past the data used.  Kills the client and returns false if the inputs are invalid.
+static bool Call_{{apiName}}_{{function.name}}
 (
-    le_msg_MessageRef_t _msgRef
-
+    le_msg_MessageRef_t _msgRef,
+    uint8_t** _reqBufPtrPtr,
+    size_t* _reqBufSizePtr,
+    uint8_t** _rspBufPtrPtr,
+    size_t* _rspBufSizePtr
 )
 {
     {%- with error_unpack_label=Labeler("error_unpack") %}
-    // Get the message buffer pointer
-    __attribute__((unused)) uint8_t* _msgBufPtr =
-        ((_Message_t*)le_msg_GetPayloadPtr(_msgRef))->buffer;
-    __attribute__((unused)) size_t _msgBufSize = _MAX_MSG_SIZE;
-
-    // Needed if we are returning a result or output values
-    uint8_t* _msgBufStartPtr = _msgBufPtr;
+    __attribute__((unused)) uint8_t* _msgBufPtr = *_reqBufPtrPtr;
+    __attribute__((unused)) size_t _msgBufSize = *_reqBufSizePtr;
 
     // Unpack which outputs are needed
     {%- if any(function.parameters, "OutParameter") %}
@@ -550,7 +558,7 @@ static void Handle_{{apiName}}_{{function.name}}
     {
         _UNLOCK
         LE_KILL_CLIENT("Invalid reference");
-        return;
+        return false;
     }
     le_ref_DeleteRef(_HandlerRefMap, {{function.parameters[0]|FormatParameterName}});
     _UNLOCK
@@ -561,6 +569,8 @@ static void Handle_{{apiName}}_{{function.name}}
         goto {{error_unpack_label}};
     {%- endcall %}
     {%- endif %}
+    *_reqBufPtrPtr = _msgBufPtr;
+    *_reqBufSizePtr = _msgBufSize;
     {#- Now create handler parameters, if there are any.  Should be zero or one #}
     {%- for handler in function.parameters if handler.apiType is HandlerType %}
 
@@ -637,9 +647,9 @@ static void Handle_{{apiName}}_{{function.name}}
     }
     {%- endif %}
 
-    // Re-use the message buffer for the response
-    _msgBufPtr = _msgBufStartPtr;
-    _msgBufSize = _MAX_MSG_SIZE;
+    // Pack the results into the response buffer
+    _msgBufPtr = *_rspBufPtrPtr;
+    _msgBufSize = *_rspBufSizePtr;
     {%- if function.returnType %}
 
     // Pack the result first
@@ -648,25 +658,139 @@ static void Handle_{{apiName}}_{{function.name}}
 
     // Pack any "out" parameters
     {{- pack.PackOutputs(function.parameters) }}
+    *_rspBufPtrPtr = _msgBufPtr;
+    *_rspBufSizePtr = _msgBufSize;
 
-    // Return the response
-    LE_DEBUG("Sending response to client session %p : %ti bytes sent",
-             le_msg_GetSession(_msgRef),
-             _msgBufPtr-_msgBufStartPtr);
-    le_msg_Respond(_msgRef);
-
-    return;
+    return true;
     {%- if error_unpack_label.IsUsed() %}
 
 error_unpack:
     LE_KILL_CLIENT("Error unpacking message");
+
+    return false;
     {%- endif %}
     {%- endwith %}
 }
+
+
+static void Handle_{{apiName}}_{{function.name}}
+(
+    le_msg_MessageRef_t _msgRef
+
+)
+{
+    // Get the message buffer pointer.  The response is written over the request.
+    uint8_t* _msgBufStartPtr = ((_Message_t*)le_msg_GetPayloadPtr(_msgRef))->buffer;
+    uint8_t* _reqBufPtr = _msgBufStartPtr;
+    size_t _reqBufSize = _GetMsgBufSize(_msgRef);
+    uint8_t* _rspBufPtr = _msgBufStartPtr;
+    size_t _rspBufSize = _reqBufSize;
+
+    // The client must have left room for the response.
+    if (le_msg_GetMaxPayloadSize(_msgRef) < _MSGSIZE_{{apiName}}_{{function.name}})
+    {
+        LE_KILL_CLIENT("Error unpacking message");
+        return;
+    }
+
+    if (Call_{{apiName}}_{{function.name}}(_msgRef, &_reqBufPtr, &_reqBufSize,
+        {#- #} &_rspBufPtr, &_rspBufSize))
+    {
+        // Return the response
+        LE_DEBUG("Sending response to client session %p : %ti bytes sent",
+                 le_msg_GetSession(_msgRef),
+                 _rspBufPtr-_msgBufStartPtr);
+        le_msg_Respond(_msgRef);
+    }
+}
 {%- endif %}
 {%- endfor %}
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle a batch of calls, in order, and send back all their results in one response.
+ */
+//--------------------------------------------------------------------------------------------------
+static void HandleBatch
+(
+    le_msg_MessageRef_t _msgRef
+)
+{
+    {%- if args.async %}
+    // Asynchronous servers respond to each call separately, so they can't take part in batches.
+    LE_KILL_CLIENT("Batched calls are not supported by this server");
+    {%- else %}
+    _Message_t* _msgPtr = le_msg_GetPayloadPtr(_msgRef);
+    size_t _bufSize = _GetMsgBufSize(_msgRef);
+    uint32_t _callCount;
+    uint32_t _callId;
+
+    // Results may take more room than the inputs of their call, so the requests are copied out of
+    // the message before the results are written to it.  The copy is held in a message from the
+    // session's pool, sized to the requests.
+    le_msg_MessageRef_t _reqMsgRef = le_msg_CreateSizedMsg(le_msg_GetSession(_msgRef), _bufSize);
+    uint8_t* _reqBufPtr = le_msg_GetPayloadPtr(_reqMsgRef);
+    size_t _reqBufSize = _bufSize;
+    uint8_t* _rspBufPtr = _msgPtr->buffer;
+    size_t _rspBufSize = _bufSize;
+
+    memcpy(_reqBufPtr, _msgPtr->buffer, _bufSize);
+
+    if (!le_pack_UnpackUint32(&_reqBufPtr, &_reqBufSize, &_callCount))
+    {
+        goto error_unpack;
+    }
+
+    while (_callCount-- > 0)
+    {
+        if (!le_pack_UnpackUint32(&_reqBufPtr, &_reqBufSize, &_callId))
+        {
+            goto error_unpack;
+        }
+
+        switch (_callId)
+        {
+            {%- for function in functions if function is BatchableFunction %}
+            case _MSGID_{{apiName}}_{{function.name}} :
+                // The client must have left room for the results.
+                if (_rspBufSize < (_MSGSIZE_{{apiName}}_{{function.name}} -
+                                   offsetof(_Message_t, buffer)))
+                {
+                    goto error_unpack;
+                }
+                if (!Call_{{apiName}}_{{function.name}}(_msgRef, &_reqBufPtr, &_reqBufSize,
+                    {#- #} &_rspBufPtr, &_rspBufSize))
+                {
+                    // The client has already been killed.
+                    le_msg_ReleaseMsg(_reqMsgRef);
+                    return;
+                }
+                break;
+            {%- endfor %}
+
+            default:
+                goto error_unpack;
+        }
+    }
+
+    le_msg_ReleaseMsg(_reqMsgRef);
+
+    LE_DEBUG("Sending batch response to client session %p : %ti bytes sent",
+             le_msg_GetSession(_msgRef),
+             _rspBufPtr-_msgPtr->buffer);
+    le_msg_Respond(_msgRef);
+
+    return;
+
+error_unpack:
+    le_msg_ReleaseMsg(_reqMsgRef);
+
+    LE_KILL_CLIENT("Error unpacking batch");
+    {%- endif %}
+}
+
+
 static void ServerMsgRecvHandler
 (
     le_msg_MessageRef_t msgRef,
@@ -688,6 +812,7 @@ static void ServerMsgRecvHandler
         case _MSGID_{{apiName}}_{{function.name}} : Handle_{{apiName}}_{{function.name}}(msgRef);
             {#- #} break;
         {%- endfor %}
+        case _MSGID_BATCH : HandleBatch(msgRef); break;
 
         default: LE_ERROR("Unknowm msg id = %i", msgPtr->id);
     }
@@ -1033,6 +1033,10 @@ void ComponentBuildScriptGenerator_t::GenerateCBuildStatement
     }
     if (!generatedFiles.empty())
     {
+        if (ifPtr->batch)
+        {
+            ifgenFlags += " --batch";
+        }
         ifgenFlags += " --name-prefix " + ifPtr->internalName;
         script << "build" << generatedFiles <<
                   ": GenInterfaceCode " << ifPtr->apiFilePtr->path << " |";
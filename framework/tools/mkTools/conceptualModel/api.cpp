@@ -320,7 +320,8 @@ ApiClientInterface_t::ApiClientInterface_t
 //--------------------------------------------------------------------------------------------------
 :   ApiRef_t(aPtr, cPtr, iName),
     manualStart(false),
-    optional(false)
+    optional(false),
+    batch(false)
 //--------------------------------------------------------------------------------------------------
 {
 }
@@ -338,7 +339,10 @@ void ApiClientInterface_t::GetInterfaceFiles
 const
 //--------------------------------------------------------------------------------------------------
 {
-    std::string codeGenDir = path::Combine(apiFilePtr->codeGenDir, "client/");
+    // Batching adds functions to the generated code, so it can't share files with the client-side
+    // interfaces that don't use it.
+    std::string codeGenDir = path::Combine(apiFilePtr->codeGenDir,
+                                           batch ? "client-batch/" : "client/");
 
     cFiles.interfaceFile = codeGenDir + internalName + "_interface.h";
     cFiles.internalHFile = codeGenDir + internalName + "_messages.h";
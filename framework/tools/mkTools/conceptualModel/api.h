@@ -141,6 +141,7 @@ struct ApiClientInterface_t : public ApiRef_t
 {
     bool manualStart;   ///< true = generated main() should not call the ConnectService() function.
     bool optional;      ///< true = okay to not be bound.
+    bool batch;         ///< true = generate functions for queueing calls in batches.
 
     ApiClientInterface_t(ApiFile_t* aPtr, Component_t* cPtr, const std::string& iName);
 
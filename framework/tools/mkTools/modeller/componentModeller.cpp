@@ -525,6 +525,7 @@ static void GetRequiredApi
     bool typesOnly = false;
     bool manualStart = false;
     bool optional = false;
+    bool batch = false;
     for (auto contentPtr : contentList)
     {
         if (contentPtr->type == parseTree::Token_t::CLIENT_IPC_OPTION)
@@ -542,6 +543,10 @@ static void GetRequiredApi
                 manualStart = true; // [optional] implies [manual-start].
                 optional = true;
             }
+            else if (contentPtr->text == "[batch]")
+            {
+                batch = true;
+            }
         }
     }
     if (typesOnly && manualStart)
@@ -549,6 +554,11 @@ static void GetRequiredApi
         itemPtr->ThrowException(LE_I18N("Can't use [types-only] with [manual-start] or [optional]"
                                   " for the same interface."));
     }
+    if (typesOnly && batch)
+    {
+        itemPtr->ThrowException(LE_I18N("Can't use [types-only] with [batch]"
+                                  " for the same interface."));
+    }
 
     // Get a pointer to the .api file object.
     auto apiFilePtr = GetApiFilePtr(apiFilePath, buildParams.interfaceDirs, contentList[0]);
@@ -572,6 +582,7 @@ static void GetRequiredApi
 
         ifPtr->manualStart = manualStart;
         ifPtr->optional = optional;
+        ifPtr->batch = batch;
 
         componentPtr->clientApis.push_back(ifPtr);
     }
@@ -1601,7 +1601,8 @@ void Lexer_t::PullClientIpcOption
     // Check that it's one of the valid client-side options.
     if (   (tokenPtr->text != "[manual-start]")
            && (tokenPtr->text != "[types-only]")
-           && (tokenPtr->text != "[optional]") )
+           && (tokenPtr->text != "[optional]")
+           && (tokenPtr->text != "[batch]") )
     {
         ThrowException(
             mk::format(LE_I18N("Invalid client-side IPC option: '%s'"), tokenPtr->text)